@@ -351,6 +351,11 @@ void optCacheStrip(Mesh& mesh)
 	meshopt_optimizeVertexCacheStrip(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
 }
 
+void optCacheParallel(Mesh& mesh)
+{
+	meshopt_optimizeVertexCacheParallel(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), &mesh.vertices[0].px, sizeof(Vertex), 65536, NULL, NULL);
+}
+
 void optOverdraw(Mesh& mesh)
 {
 	// use worst-case ACMR threshold so that overdraw optimizer can sort *all* triangles
@@ -559,23 +564,26 @@ void simplifyComplete(const Mesh& mesh)
 
 	lods[0] = mesh.indices;
 
+	size_t target_index_counts[lod_count - 1];
+	float target_errors[lod_count - 1];
+
 	for (size_t i = 1; i < lod_count; ++i)
 	{
-		std::vector<unsigned int>& lod = lods[i];
-
 		float threshold = powf(0.7f, float(i));
-		size_t target_index_count = size_t(mesh.indices.size() * threshold) / 3 * 3;
-		float target_error = 1e-2f;
 
-		// we can simplify all the way from base level or from the last result
-		// simplifying from the base level sometimes produces better results, but simplifying from last level is faster
-		const std::vector<unsigned int>& source = lods[i - 1];
+		target_index_counts[i - 1] = size_t(mesh.indices.size() * threshold) / 3 * 3;
+		target_errors[i - 1] = 1e-2f;
+	}
 
-		if (source.size() < target_index_count)
-			target_index_count = source.size();
+	// all levels are generated in one progressive simplification run, which is cheaper than simplifying each level separately
+	std::vector<unsigned int> chain(mesh.indices.size() * (lod_count - 1));
+	size_t chain_counts[lod_count - 1];
+	chain.resize(meshopt_simplifyLods(&chain[0], chain_counts, NULL, &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), NULL, 0, NULL, 0, NULL, target_index_counts, target_errors, lod_count - 1, 0));
 
-		lod.resize(source.size());
-		lod.resize(meshopt_simplify(&lod[0], &source[0], source.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, target_error));
+	for (size_t i = 1, offset = 0; i < lod_count; ++i)
+	{
+		lods[i].assign(chain.begin() + offset, chain.begin() + offset + chain_counts[i - 1]);
+		offset += chain_counts[i - 1];
 	}
 
 	double middle = timestamp();
@@ -721,13 +729,14 @@ void optimize(const Mesh& mesh, const char* name, void (*optf)(Mesh& mesh))
 	assert(isMeshValid(copy));
 	assert(hashMesh(mesh) == hashMesh(copy));
 
-	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), kCacheSize, 0, 0);
-	meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetch(&copy.indices[0], copy.indices.size(), copy.vertices.size(), sizeof(Vertex));
-	meshopt_OverdrawStatistics os = meshopt_analyzeOverdraw(&copy.indices[0], copy.indices.size(), &copy.vertices[0].px, copy.vertices.size(), sizeof(Vertex));
+	meshopt_MeshStatistics ms = meshopt_analyzeMesh(&copy.indices[0], copy.indices.size(), copy.vertices.size(), sizeof(Vertex), &copy.vertices[0].px, sizeof(Vertex));
 
-	meshopt_VertexCacheStatistics vcs_nv = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 32, 32, 32);
-	meshopt_VertexCacheStatistics vcs_amd = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 14, 64, 128);
-	meshopt_VertexCacheStatistics vcs_intel = meshopt_analyzeVertexCache(&copy.indices[0], copy.indices.size(), copy.vertices.size(), 128, 0, 0);
+	const meshopt_VertexCacheStatistics& vcs = ms.vertex_cache[meshopt_CacheProfileGeneric];
+	const meshopt_VertexCacheStatistics& vcs_nv = ms.vertex_cache[meshopt_CacheProfileNVidia];
+	const meshopt_VertexCacheStatistics& vcs_amd = ms.vertex_cache[meshopt_CacheProfileAMD];
+	const meshopt_VertexCacheStatistics& vcs_intel = ms.vertex_cache[meshopt_CacheProfileIntel];
+	const meshopt_VertexFetchStatistics& vfs = ms.vertex_fetch;
+	const meshopt_OverdrawStatistics& os = ms.overdraw;
 
 	printf("%-9s: ACMR %f ATVR %f (NV %f AMD %f Intel %f) Overfetch %f Overdraw %f in %.2f msec\n", name, vcs.acmr, vcs.atvr, vcs_nv.atvr, vcs_amd.atvr, vcs_intel.atvr, vfs.overfetch, os.overdraw, (end - start) * 1000);
 }
@@ -1341,6 +1350,7 @@ void process(const char* path)
 	optimize(mesh, "Cache", optCache);
 	optimize(mesh, "CacheFifo", optCacheFifo);
 	optimize(mesh, "CacheStrp", optCacheStrip);
+	optimize(mesh, "CachePar", optCacheParallel);
 	optimize(mesh, "Overdraw", optOverdraw);
 	optimize(mesh, "Fetch", optFetch);
 	optimize(mesh, "FetchMap", optFetchRemap);
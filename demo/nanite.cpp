@@ -2,6 +2,7 @@
 // The code is not optimized, not robust, and not intended for production use.
 // It optionally supports METIS for clustering and partitioning, with an eventual goal of removing this code
 // in favor of meshopt algorithms.
+// A library version of the default (non-METIS) path is available as meshopt_buildClusterHierarchy.
 
 // For reference, see the original Nanite paper:
 // Brian Karis. Nanite: A Deep Dive. 2021
@@ -424,7 +425,7 @@ static void lockBoundary(std::vector<unsigned char>& locks, const std::vector<st
 	}
 }
 
-static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<unsigned char>* locks, size_t target_count, float* error = NULL)
+static std::vector<unsigned int> simplify(meshopt_SimplifyContext* context, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<unsigned char>* locks, size_t target_count, float* error = NULL)
 {
 	if (target_count > indices.size())
 		return indices;
@@ -433,11 +434,11 @@ static std::vector<unsigned int> simplify(const std::vector<Vertex>& vertices, c
 	unsigned int options = meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute;
 	float normal_weights[3] = {0.5f, 0.5f, 0.5f};
 	if (kUseNormals)
-		lod.resize(meshopt_simplifyWithAttributes(&lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), &vertices[0].nx, sizeof(Vertex), normal_weights, 3, locks ? &(*locks)[0] : NULL, target_count, FLT_MAX, options, error));
+		lod.resize(meshopt_simplifyWithContext(context, &lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), &vertices[0].nx, sizeof(Vertex), normal_weights, 3, locks ? &(*locks)[0] : NULL, target_count, FLT_MAX, options, error));
 	else if (locks)
-		lod.resize(meshopt_simplifyWithAttributes(&lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), NULL, 0, NULL, 0, &(*locks)[0], target_count, FLT_MAX, options, error));
+		lod.resize(meshopt_simplifyWithContext(context, &lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), NULL, 0, NULL, 0, &(*locks)[0], target_count, FLT_MAX, options, error));
 	else
-		lod.resize(meshopt_simplify(&lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), target_count, FLT_MAX, options | meshopt_SimplifyLockBorder, error));
+		lod.resize(meshopt_simplifyWithContext(context, &lod[0], &indices[0], indices.size(), &vertices[0].px, vertices.size(), sizeof(Vertex), NULL, 0, NULL, 0, NULL, target_count, FLT_MAX, options | meshopt_SimplifyLockBorder, error));
 	return lod;
 }
 
@@ -482,6 +483,10 @@ void nanite(const std::vector<Vertex>& vertices, const std::vector<unsigned int>
 	meshopt_Stream position = {&vertices[0].px, sizeof(float) * 3, sizeof(Vertex)};
 	meshopt_generateVertexRemapMulti(&remap[0], &indices[0], indices.size(), vertices.size(), &position, 1);
 
+	// simplifier context keeps scratch memory between simplification calls for individual groups
+	meshopt_SimplifyContext context;
+	meshopt_simplifyContextInit(&context);
+
 	// merge and simplify clusters until we can't merge anymore
 	while (pending.size() > 1)
 	{
@@ -538,7 +543,7 @@ void nanite(const std::vector<Vertex>& vertices, const std::vector<unsigned int>
 
 			size_t target_size = ((groups[i].size() + 1) / 2) * kClusterSize * 3;
 			float error = 0.f;
-			std::vector<unsigned int> simplified = simplify(vertices, merged, kUseLocks ? &locks : NULL, target_size, &error);
+			std::vector<unsigned int> simplified = simplify(&context, vertices, merged, kUseLocks ? &locks : NULL, target_size, &error);
 			if (simplified.size() > merged.size() * 0.85f || simplified.size() / (kClusterSize * 3) >= merged.size() / (kClusterSize * 3))
 			{
 #if TRACE
@@ -595,6 +600,8 @@ void nanite(const std::vector<Vertex>& vertices, const std::vector<unsigned int>
 		pending.insert(pending.end(), retry.begin(), retry.end());
 	}
 
+	meshopt_simplifyContextDestroy(&context);
+
 	size_t total_triangles = 0;
 	size_t lowest_triangles = 0;
 	for (size_t i = 0; i < clusters.size(); ++i)
@@ -1,6 +1,7 @@
 #include "../src/meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -213,6 +214,196 @@ static void roundtripIndexTricky()
 	assert(memcmp(decoded, kIndexBufferTricky, sizeof(kIndexBufferTricky)) == 0);
 }
 
+static void roundtripIndexLarge()
+{
+	const size_t vertex_count = 1000;
+
+	// this mixes cached vertices, sequential new vertices and free indices with long deltas to cover all decoder paths
+	std::vector<unsigned int> indices;
+
+	for (unsigned int i = 0; i < 3000; ++i)
+	{
+		unsigned int h = i * 2654435761u;
+
+		indices.push_back(i % vertex_count);
+		indices.push_back((i * 7 + 1) % vertex_count);
+		indices.push_back((h >> 16) % vertex_count);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(indices.size(), vertex_count));
+	buffer.resize(meshopt_encodeIndexBuffer(&buffer[0], buffer.size(), &indices[0], indices.size()));
+
+	std::vector<unsigned int> decoded(indices.size());
+	assert(meshopt_decodeIndexBuffer(&decoded[0], indices.size(), &buffer[0], buffer.size()) == 0);
+
+	// encoder may rotate triangles but must preserve their winding
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		unsigned int da = decoded[i + 0], db = decoded[i + 1], dc = decoded[i + 2];
+
+		assert((da == a && db == b && dc == c) || (da == b && db == c && dc == a) || (da == c && db == a && dc == b));
+	}
+
+	std::vector<unsigned short> decoded16(indices.size());
+	assert(meshopt_decodeIndexBuffer(&decoded16[0], indices.size(), &buffer[0], buffer.size()) == 0);
+
+	for (size_t i = 0; i < indices.size(); ++i)
+		assert(decoded16[i] == decoded[i]);
+}
+
+static void parallelForReverse(void* context, void (*task)(void*, size_t), void* task_context, size_t count)
+{
+	assert(context == NULL);
+
+	// run tasks in reverse order to make sure they don't depend on each other
+	for (size_t i = count; i > 0; --i)
+		task(task_context, i - 1);
+}
+
+static void decodeIndexChunked()
+{
+	std::vector<unsigned int> indices;
+
+	for (unsigned int i = 0; i < 300; ++i)
+	{
+		indices.push_back(i);
+		indices.push_back(i + 1);
+		indices.push_back((i * 7) % 301);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferChunkedBound(indices.size(), 301, 240));
+	buffer.resize(meshopt_encodeIndexBufferChunked(&buffer[0], buffer.size(), &indices[0], indices.size(), 240, NULL, NULL));
+	assert(buffer.size() > 0);
+
+	// parallel encoding must produce the same output
+	std::vector<unsigned char> pbuffer(meshopt_encodeIndexBufferChunkedBound(indices.size(), 301, 240));
+	pbuffer.resize(meshopt_encodeIndexBufferChunked(&pbuffer[0], pbuffer.size(), &indices[0], indices.size(), 240, parallelForReverse, NULL));
+	assert(pbuffer == buffer);
+
+	assert(meshopt_decodeIndexBufferChunkCount(indices.size(), &buffer[0], buffer.size()) == 4);
+
+	// decode chunks out of order to make sure they don't depend on each other
+	std::vector<unsigned int> decoded(indices.size());
+	assert(meshopt_decodeIndexBufferChunks(&decoded[0], indices.size(), 4, 2, 4, &buffer[0], buffer.size()) == 0);
+	assert(meshopt_decodeIndexBufferChunks(&decoded[0], indices.size(), 4, 0, 2, &buffer[0], buffer.size()) == 0);
+
+	// encoder may rotate triangles but must preserve their winding
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		unsigned int da = decoded[i + 0], db = decoded[i + 1], dc = decoded[i + 2];
+
+		assert((da == a && db == b && dc == c) || (da == b && db == c && dc == a) || (da == c && db == a && dc == b));
+	}
+
+	std::vector<unsigned short> decoded16(indices.size());
+	assert(meshopt_decodeIndexBufferChunks(&decoded16[0], indices.size(), 2, 0, 4, &buffer[0], buffer.size()) == 0);
+
+	for (size_t i = 0; i < indices.size(); ++i)
+		assert(decoded16[i] == decoded[i]);
+
+	// out of range chunks are rejected
+	assert(meshopt_decodeIndexBufferChunks(&decoded[0], indices.size(), 4, 0, 5, &buffer[0], buffer.size()) < 0);
+
+	// chunked data isn't compatible with regular decoder and vice versa
+	assert(meshopt_decodeIndexBuffer(&decoded[0], indices.size(), 4, &buffer[0], buffer.size()) < 0);
+	assert(meshopt_decodeIndexBufferChunkCount(sizeof(kIndexBuffer) / sizeof(kIndexBuffer[0]), kIndexDataV0, sizeof(kIndexDataV0)) == 0);
+}
+
+static void decodeIndexChunkedMemorySafe()
+{
+	const size_t index_count = sizeof(kIndexBuffer) / sizeof(kIndexBuffer[0]);
+	const size_t vertex_count = 10;
+
+	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferChunkedBound(index_count, vertex_count, 6));
+	buffer.resize(meshopt_encodeIndexBufferChunked(&buffer[0], buffer.size(), kIndexBuffer, index_count, 6, NULL, NULL));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeIndexBufferChunked(i == 0 ? NULL : &shortbuffer[0], i, kIndexBuffer, index_count, 6, parallelForReverse, NULL);
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe and that truncated or extended buffers are rejected
+	unsigned int decoded[index_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeIndexBufferChunks(decoded, index_count, 4, 0, 2, i == 0 ? NULL : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	std::vector<unsigned char> largebuffer(buffer);
+	largebuffer.push_back(0);
+
+	assert(meshopt_decodeIndexBufferChunks(decoded, index_count, 4, 0, 2, &largebuffer[0], largebuffer.size()) < 0);
+}
+
+static void encodeContext()
+{
+	meshopt_EncodeContext context;
+	meshopt_encodeContextInit(&context);
+
+	// context settings don't affect global settings and vice versa
+	meshopt_encodeIndexVersion(1);
+	context.index_version = 0;
+
+	const size_t index_count = sizeof(kIndexBuffer) / sizeof(kIndexBuffer[0]);
+
+	size_t size = meshopt_encodeIndexBufferContext(&context, kIndexBuffer, index_count, 4);
+	assert(size == sizeof(kIndexDataV0));
+	assert(memcmp(context.buffer, kIndexDataV0, size) == 0);
+
+	unsigned short indices16[index_count];
+	for (size_t i = 0; i < index_count; ++i)
+		indices16[i] = (unsigned short)(kIndexBuffer[i]);
+
+	size = meshopt_encodeIndexBufferContext(&context, indices16, index_count, 2);
+	assert(size == sizeof(kIndexDataV0));
+	assert(memcmp(context.buffer, kIndexDataV0, size) == 0);
+
+	context.index_version = 1;
+
+	const size_t sequence_count = sizeof(kIndexSequence) / sizeof(kIndexSequence[0]);
+
+	size = meshopt_encodeIndexSequenceContext(&context, kIndexSequence, sequence_count, 4);
+	assert(size == sizeof(kIndexSequenceV1));
+	assert(memcmp(context.buffer, kIndexSequenceV1, size) == 0);
+
+	// the output buffer is reused for smaller outputs and grows for larger ones
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	size = meshopt_encodeVertexBufferContext(&context, kVertexBuffer, vertex_count, sizeof(PV));
+	assert(size == sizeof(kVertexDataV0));
+	assert(memcmp(context.buffer, kVertexDataV0, size) == 0);
+
+	std::vector<PV> large(1000);
+	for (size_t i = 0; i < large.size(); ++i)
+		large[i] = kVertexBuffer[i % vertex_count];
+
+	std::vector<unsigned char> expected(meshopt_encodeVertexBufferBound(large.size(), sizeof(PV)));
+	expected.resize(meshopt_encodeVertexBuffer(&expected[0], expected.size(), &large[0], large.size(), sizeof(PV)));
+
+	size = meshopt_encodeVertexBufferContext(&context, &large[0], large.size(), sizeof(PV));
+	assert(size == expected.size());
+	assert(memcmp(context.buffer, &expected[0], size) == 0);
+
+	meshopt_encodeContextDestroy(&context);
+	assert(context.buffer == NULL);
+}
+
 static void encodeIndexEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeIndexBufferBound(0, 0));
@@ -339,6 +530,74 @@ static void decodeIndexSequenceRejectInvalidVersion()
 	assert(meshopt_decodeIndexSequence(decoded, index_count, &brokenbuffer[0], brokenbuffer.size()) < 0);
 }
 
+static void decodeIndexStream()
+{
+	const size_t index_count = sizeof(kIndexSequence) / sizeof(kIndexSequence[0]);
+
+	std::vector<unsigned char> buffer(kIndexSequenceV1, kIndexSequenceV1 + sizeof(kIndexSequenceV1));
+
+	// feed the data one byte at a time; indices must be decoded before the entire stream is available
+	unsigned int decoded[index_count];
+
+	meshopt_DecodeStream stream;
+	meshopt_decodeIndexStreamInit(&stream, index_count, 4, buffer.size());
+
+	// note: the last index is followed by a 4-byte tail, so it can be decoded once the first tail byte is received
+	for (size_t i = 0; i < buffer.size() - 1; ++i)
+	{
+		assert(meshopt_decodeIndexStream(&stream, decoded, &buffer[0], i) == 1);
+		assert(memcmp(decoded, kIndexSequence, stream.decoded * 4) == 0);
+	}
+
+	assert(stream.decoded == index_count - 1);
+
+	assert(meshopt_decodeIndexStream(&stream, decoded, &buffer[0], buffer.size()) == 0);
+	assert(stream.decoded == index_count);
+	assert(memcmp(decoded, kIndexSequence, sizeof(kIndexSequence)) == 0);
+
+	// index buffers are only decoded once all data is available
+	const size_t triangle_index_count = sizeof(kIndexBuffer) / sizeof(kIndexBuffer[0]);
+
+	std::vector<unsigned char> ibuffer(kIndexDataV0, kIndexDataV0 + sizeof(kIndexDataV0));
+
+	unsigned short decoded16[triangle_index_count];
+	meshopt_decodeIndexStreamInit(&stream, triangle_index_count, 2, ibuffer.size());
+
+	assert(meshopt_decodeIndexStream(&stream, decoded16, &ibuffer[0], ibuffer.size() - 1) == 1);
+	assert(stream.decoded == 0);
+	assert(meshopt_decodeIndexStream(&stream, decoded16, &ibuffer[0], ibuffer.size()) == 0);
+	assert(stream.decoded == triangle_index_count);
+
+	for (size_t i = 0; i < triangle_index_count; ++i)
+		assert(decoded16[i] == kIndexBuffer[i]);
+}
+
+static void decodeIndexStreamMemorySafe()
+{
+	const size_t index_count = sizeof(kIndexSequence) / sizeof(kIndexSequence[0]);
+
+	std::vector<unsigned char> buffer(kIndexSequenceV1, kIndexSequenceV1 + sizeof(kIndexSequenceV1));
+
+	// check that truncated and extended streams are rejected once the stream is declared complete
+	unsigned int decoded[index_count];
+
+	for (size_t i = 0; i <= buffer.size() + 1; ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + (i < buffer.size() ? i : buffer.size()));
+		shortbuffer.resize(i);
+
+		meshopt_DecodeStream stream;
+		meshopt_decodeIndexStreamInit(&stream, index_count, 4, i);
+
+		int result = meshopt_decodeIndexStream(&stream, decoded, i == 0 ? NULL : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+}
+
 static void encodeIndexSequenceEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeIndexSequenceBound(0, 0));
@@ -358,6 +617,17 @@ static void decodeVertexV0()
 	assert(memcmp(decoded, kVertexBuffer, sizeof(kVertexBuffer)) == 0);
 }
 
+static void encodeVertexV0()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, sizeof(PV)));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV)));
+
+	assert(buffer.size() == sizeof(kVertexDataV0));
+	assert(memcmp(&buffer[0], kVertexDataV0, sizeof(kVertexDataV0)) == 0);
+}
+
 static void encodeVertexMemorySafe()
 {
 	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
@@ -504,6 +774,26 @@ static void decodeVertexLarge()
 	assert(memcmp(decoded, data, sizeof(data)) == 0);
 }
 
+static void decodeVertexPartialGroups()
+{
+	unsigned char data[45 * 16];
+
+	// this tests group encoding for vertex counts that aren't divisible by group size, with a mix of 0/2/4/8 bit groups and sentinels
+	for (size_t i = 0; i < 45; ++i)
+		for (size_t k = 0; k < 16; ++k)
+			data[i * 16 + k] = (unsigned char)((k < 4) ? i * k : (k < 8) ? (i % 7 == 0) * 42 : (k < 12) ? i * i * k : 0);
+
+	for (size_t vertex_count = 1; vertex_count <= 45; ++vertex_count)
+	{
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, 16));
+		buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), data, vertex_count, 16));
+
+		unsigned char decoded[45 * 16];
+		assert(meshopt_decodeVertexBuffer(decoded, vertex_count, 16, &buffer[0], buffer.size()) == 0);
+		assert(memcmp(decoded, data, vertex_count * 16) == 0);
+	}
+}
+
 static void encodeVertexEmpty()
 {
 	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(0, 16));
@@ -512,6 +802,159 @@ static void encodeVertexEmpty()
 	assert(meshopt_decodeVertexBuffer(NULL, 0, 16, &buffer[0], buffer.size()) == 0);
 }
 
+static void decodeVertexChunked()
+{
+	unsigned char data[1000 * 4];
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		data[i * 4 + 0] = (unsigned char)(i * 1);
+		data[i * 4 + 1] = (unsigned char)(i * 3);
+		data[i * 4 + 2] = (unsigned char)(i / 4);
+		data[i * 4 + 3] = (unsigned char)(i * 13);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferChunkedBound(1000, 4, 300));
+	buffer.resize(meshopt_encodeVertexBufferChunked(&buffer[0], buffer.size(), data, 1000, 4, 300));
+	assert(buffer.size() > 0);
+
+	assert(meshopt_decodeVertexBufferChunkCount(1000, &buffer[0], buffer.size()) == 4);
+
+	// decode chunks out of order to make sure they don't depend on each other
+	unsigned char decoded[1000 * 4];
+	memset(decoded, 0, sizeof(decoded));
+	assert(meshopt_decodeVertexBufferChunks(decoded, 1000, 4, 2, 4, &buffer[0], buffer.size()) == 0);
+	assert(memcmp(decoded, data, 600 * 4) != 0);
+	assert(memcmp(decoded + 600 * 4, data + 600 * 4, 400 * 4) == 0);
+	assert(meshopt_decodeVertexBufferChunks(decoded, 1000, 4, 0, 2, &buffer[0], buffer.size()) == 0);
+	assert(memcmp(decoded, data, sizeof(data)) == 0);
+
+	// out of range chunks are rejected
+	assert(meshopt_decodeVertexBufferChunks(decoded, 1000, 4, 0, 5, &buffer[0], buffer.size()) < 0);
+
+	// chunked data isn't compatible with regular decoder and vice versa
+	assert(meshopt_decodeVertexBuffer(decoded, 1000, 4, &buffer[0], buffer.size()) < 0);
+	assert(meshopt_decodeVertexBufferChunkCount(sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]), kVertexDataV0, sizeof(kVertexDataV0)) == 0);
+}
+
+static void decodeVertexChunkedMemorySafe()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferChunkedBound(vertex_count, sizeof(PV), 3));
+	buffer.resize(meshopt_encodeVertexBufferChunked(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV), 3));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeVertexBufferChunked(i == 0 ? NULL : &shortbuffer[0], i, kVertexBuffer, vertex_count, sizeof(PV), 3);
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	// check that decode is memory-safe and that truncated or extended buffers are rejected
+	PV decoded[vertex_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeVertexBufferChunks(decoded, vertex_count, sizeof(PV), 0, 2, i == 0 ? NULL : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	std::vector<unsigned char> largebuffer(buffer);
+	largebuffer.push_back(0);
+
+	assert(meshopt_decodeVertexBufferChunks(decoded, vertex_count, sizeof(PV), 0, 2, &largebuffer[0], largebuffer.size()) < 0);
+}
+
+static void decodeVertexStream()
+{
+	unsigned char data[1000 * 4];
+
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		data[i * 4 + 0] = (unsigned char)(i * 1);
+		data[i * 4 + 1] = (unsigned char)(i * 3);
+		data[i * 4 + 2] = (unsigned char)(i / 4);
+		data[i * 4 + 3] = (unsigned char)(i * 13);
+	}
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferChunkedBound(1000, 4, 256));
+	buffer.resize(meshopt_encodeVertexBufferChunked(&buffer[0], buffer.size(), data, 1000, 4, 256));
+
+	// feed the data in small pieces; chunks must be decoded before the entire stream is available
+	unsigned char decoded[1000 * 4];
+	memset(decoded, 0, sizeof(decoded));
+
+	meshopt_DecodeStream stream;
+	meshopt_decodeVertexStreamInit(&stream, 1000, 4, buffer.size());
+
+	size_t partial = 0;
+
+	for (size_t i = 0; i < buffer.size(); i += 7)
+	{
+		assert(meshopt_decodeVertexStream(&stream, decoded, &buffer[0], i) == 1);
+		assert(stream.decoded % 256 == 0);
+		assert(memcmp(decoded, data, stream.decoded * 4) == 0);
+
+		partial = stream.decoded;
+	}
+
+	assert(partial == 768);
+
+	assert(meshopt_decodeVertexStream(&stream, decoded, &buffer[0], buffer.size()) == 0);
+	assert(stream.decoded == 1000);
+	assert(memcmp(decoded, data, sizeof(data)) == 0);
+
+	// regular streams are only decoded once all data is available
+	buffer.resize(meshopt_encodeVertexBufferBound(1000, 4));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), data, 1000, 4));
+
+	memset(decoded, 0, sizeof(decoded));
+	meshopt_decodeVertexStreamInit(&stream, 1000, 4, buffer.size());
+
+	assert(meshopt_decodeVertexStream(&stream, decoded, &buffer[0], buffer.size() - 1) == 1);
+	assert(stream.decoded == 0);
+	assert(meshopt_decodeVertexStream(&stream, decoded, &buffer[0], buffer.size()) == 0);
+	assert(stream.decoded == 1000);
+	assert(memcmp(decoded, data, sizeof(data)) == 0);
+}
+
+static void decodeVertexStreamMemorySafe()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferChunkedBound(vertex_count, sizeof(PV), 3));
+	buffer.resize(meshopt_encodeVertexBufferChunked(&buffer[0], buffer.size(), kVertexBuffer, vertex_count, sizeof(PV), 3));
+
+	// check that truncated streams are rejected once the stream is declared complete
+	PV decoded[vertex_count];
+
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+
+		meshopt_DecodeStream stream;
+		meshopt_decodeVertexStreamInit(&stream, vertex_count, sizeof(PV), i);
+
+		int result = meshopt_decodeVertexStream(&stream, decoded, i == 0 ? NULL : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+}
+
 static void decodeFilterOct8()
 {
 	const unsigned char data[4 * 4] = {
@@ -903,37 +1346,1244 @@ static void encodeFilterExpClamp()
 		assert(fabsf(decoded[i] - data[i]) < 1e-3f);
 }
 
-static void clusterBoundsDegenerate()
+static void decodeVertexFiltered()
 {
-	const float vbd[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-	const unsigned int ibd[] = {0, 0, 0};
-	const unsigned int ib1[] = {0, 1, 2};
+	const size_t vertex_count = 300; // more than one vertex block, with a partial last block
 
-	// all of the bounds below are degenerate as they use 0 triangles, one topology-degenerate triangle and one position-degenerate triangle respectively
-	meshopt_Bounds bounds0 = meshopt_computeClusterBounds(NULL, 0, NULL, 0, 12);
-	meshopt_Bounds boundsd = meshopt_computeClusterBounds(ibd, 3, vbd, 3, 12);
-	meshopt_Bounds bounds1 = meshopt_computeClusterBounds(ib1, 3, vbd, 3, 12);
+	std::vector<float> data(vertex_count * 4);
 
-	assert(bounds0.center[0] == 0 && bounds0.center[1] == 0 && bounds0.center[2] == 0 && bounds0.radius == 0);
-	assert(boundsd.center[0] == 0 && boundsd.center[1] == 0 && boundsd.center[2] == 0 && boundsd.radius == 0);
-	assert(bounds1.center[0] == 0 && bounds1.center[1] == 0 && bounds1.center[2] == 0 && bounds1.radius == 0);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		float a = float(i) * 0.1f, b = float(i) * 0.37f;
 
-	const float vb1[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
-	const unsigned int ib2[] = {0, 1, 2, 0, 2, 1};
+		data[i * 4 + 0] = cosf(a) * sinf(b);
+		data[i * 4 + 1] = sinf(a) * sinf(b);
+		data[i * 4 + 2] = cosf(b);
+		data[i * 4 + 3] = 0;
+	}
 
-	// these bounds have a degenerate cone since the cluster has two triangles with opposite normals
-	meshopt_Bounds bounds2 = meshopt_computeClusterBounds(ib2, 6, vb1, 3, 12);
+	const meshopt_DecodeFilter filters[] = {meshopt_DecodeFilterNone, meshopt_DecodeFilterOct, meshopt_DecodeFilterQuat, meshopt_DecodeFilterExp};
+	const size_t strides[] = {16, 8, 8, 16};
 
-	assert(bounds2.cone_apex[0] == 0 && bounds2.cone_apex[1] == 0 && bounds2.cone_apex[2] == 0);
-	assert(bounds2.cone_axis[0] == 0 && bounds2.cone_axis[1] == 0 && bounds2.cone_axis[2] == 0);
-	assert(bounds2.cone_cutoff == 1);
-	assert(bounds2.cone_axis_s8[0] == 0 && bounds2.cone_axis_s8[1] == 0 && bounds2.cone_axis_s8[2] == 0);
-	assert(bounds2.cone_cutoff_s8 == 127);
+	for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+	{
+		size_t stride = strides[f];
 
-	// however, the bounding sphere needs to be in tact (here we only check bbox for simplicity)
-	assert(bounds2.center[0] - bounds2.radius <= 0 && bounds2.center[0] + bounds2.radius >= 1);
-	assert(bounds2.center[1] - bounds2.radius <= 0 && bounds2.center[1] + bounds2.radius >= 1);
-	assert(bounds2.center[2] - bounds2.radius <= 0 && bounds2.center[2] + bounds2.radius >= 1);
+		std::vector<unsigned char> filtered(vertex_count * stride);
+
+		if (filters[f] == meshopt_DecodeFilterOct)
+			meshopt_encodeFilterOct(&filtered[0], vertex_count, stride, 12, &data[0]);
+		else if (filters[f] == meshopt_DecodeFilterQuat)
+			meshopt_encodeFilterQuat(&filtered[0], vertex_count, stride, 12, &data[0]);
+		else if (filters[f] == meshopt_DecodeFilterExp)
+			meshopt_encodeFilterExp(&filtered[0], vertex_count, stride, 15, &data[0], meshopt_EncodeExpSharedVector);
+		else
+			memcpy(&filtered[0], &data[0], vertex_count * stride);
+
+		std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, stride));
+		buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &filtered[0], vertex_count, stride));
+
+		std::vector<unsigned char> expected(vertex_count * stride);
+		assert(meshopt_decodeVertexBuffer(&expected[0], vertex_count, stride, &buffer[0], buffer.size()) == 0);
+
+		if (filters[f] == meshopt_DecodeFilterOct)
+			meshopt_decodeFilterOct(&expected[0], vertex_count, stride);
+		else if (filters[f] == meshopt_DecodeFilterQuat)
+			meshopt_decodeFilterQuat(&expected[0], vertex_count, stride);
+		else if (filters[f] == meshopt_DecodeFilterExp)
+			meshopt_decodeFilterExp(&expected[0], vertex_count, stride);
+
+		std::vector<unsigned char> decoded(vertex_count * stride);
+		assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, stride, &buffer[0], buffer.size(), filters[f]) == 0);
+		assert(decoded == expected);
+
+		// malformed input is rejected the same way as meshopt_decodeVertexBuffer does
+		assert(meshopt_decodeVertexBufferFiltered(&decoded[0], vertex_count, stride, &buffer[0], buffer.size() - 1, filters[f]) < 0);
+	}
+}
+
+static void decodeVertexStrided()
+{
+	const size_t vertex_count = 300; // more than one vertex block, with a partial last block
+	const size_t vertex_size = 8;
+	const size_t vertex_stride = 20;
+	const size_t vertex_offset = 4;
+
+	std::vector<unsigned char> data(vertex_count * vertex_size);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (unsigned char)(i * 13 + (i >> 5));
+
+	std::vector<unsigned char> buffer(meshopt_encodeVertexBufferBound(vertex_count, vertex_size));
+	buffer.resize(meshopt_encodeVertexBuffer(&buffer[0], buffer.size(), &data[0], vertex_count, vertex_size));
+
+	const meshopt_DecodeFilter filters[] = {meshopt_DecodeFilterNone, meshopt_DecodeFilterOct};
+
+	for (size_t f = 0; f < sizeof(filters) / sizeof(filters[0]); ++f)
+	{
+		std::vector<unsigned char> expected(vertex_count * vertex_size);
+		assert(meshopt_decodeVertexBufferFiltered(&expected[0], vertex_count, vertex_size, &buffer[0], buffer.size(), filters[f]) == 0);
+
+		std::vector<unsigned char> decoded(vertex_count * vertex_stride, 0xcd);
+		assert(meshopt_decodeVertexBufferStrided(&decoded[vertex_offset], vertex_count, vertex_size, vertex_stride, &buffer[0], buffer.size(), filters[f]) == 0);
+
+		// only vertex_size bytes of each vertex are written; the rest of the interleaved buffer is preserved
+		for (size_t i = 0; i < vertex_count * vertex_stride; ++i)
+		{
+			size_t offset = i % vertex_stride;
+
+			if (offset >= vertex_offset && offset < vertex_offset + vertex_size)
+				assert(decoded[i] == expected[(i / vertex_stride) * vertex_size + offset - vertex_offset]);
+			else
+				assert(decoded[i] == 0xcd);
+		}
+
+		assert(meshopt_decodeVertexBufferStrided(&decoded[vertex_offset], vertex_count, vertex_size, vertex_stride, &buffer[0], buffer.size() - 1, filters[f]) < 0);
+	}
+}
+
+static void decodeBatch()
+{
+	const size_t vertex_count = sizeof(kVertexBuffer) / sizeof(kVertexBuffer[0]);
+
+	std::vector<unsigned char> octdata(vertex_count * 4);
+	for (size_t i = 0; i < octdata.size(); ++i)
+		octdata[i] = (unsigned char)(i * 37);
+
+	std::vector<unsigned char> octbuffer(meshopt_encodeVertexBufferBound(vertex_count, 4));
+	octbuffer.resize(meshopt_encodeVertexBuffer(&octbuffer[0], octbuffer.size(), &octdata[0], vertex_count, 4));
+
+	std::vector<unsigned char> octexpected = octdata;
+	meshopt_decodeFilterOct(&octexpected[0], vertex_count, 4);
+
+	PV vb[vertex_count];
+	unsigned int ib[sizeof(kIndexBufferTricky) / sizeof(kIndexBufferTricky[0])];
+	unsigned short is[sizeof(kIndexSequence) / sizeof(kIndexSequence[0])];
+	std::vector<unsigned char> oct(vertex_count * 4);
+	PV bad[vertex_count];
+
+	meshopt_DecodeItem items[] = {
+	    {vb, vertex_count, sizeof(PV), kVertexDataV0, sizeof(kVertexDataV0), meshopt_DecodeModeAttributes, meshopt_DecodeFilterNone, -100},
+	    {ib, sizeof(ib) / sizeof(ib[0]), 4, kIndexDataV1, sizeof(kIndexDataV1), meshopt_DecodeModeTriangles, meshopt_DecodeFilterNone, -100},
+	    {is, sizeof(is) / sizeof(is[0]), 2, kIndexSequenceV1, sizeof(kIndexSequenceV1), meshopt_DecodeModeIndices, meshopt_DecodeFilterNone, -100},
+	    {&oct[0], vertex_count, 4, &octbuffer[0], octbuffer.size(), meshopt_DecodeModeAttributes, meshopt_DecodeFilterOct, -100},
+	    {bad, vertex_count, sizeof(PV), kVertexDataV0, sizeof(kVertexDataV0) - 1, meshopt_DecodeModeAttributes, meshopt_DecodeFilterNone, -100},
+	};
+
+	const size_t item_count = sizeof(items) / sizeof(items[0]);
+
+	for (int parallel = 0; parallel < 2; ++parallel)
+	{
+		memset(vb, 0, sizeof(vb));
+		memset(ib, 0, sizeof(ib));
+		memset(is, 0, sizeof(is));
+
+		// the batch result is the error code of the first failing item, regardless of the order the items were decoded in
+		int result = meshopt_decodeBatch(items, item_count, parallel ? parallelForReverse : NULL, NULL);
+
+		for (size_t i = 0; i < item_count - 1; ++i)
+			assert(items[i].result == 0);
+
+		assert(items[item_count - 1].result < 0);
+		assert(result == items[item_count - 1].result);
+
+		assert(memcmp(vb, kVertexBuffer, sizeof(vb)) == 0);
+		assert(memcmp(ib, kIndexBufferTricky, sizeof(ib)) == 0);
+		assert(oct == octexpected);
+
+		for (size_t i = 0; i < sizeof(is) / sizeof(is[0]); ++i)
+			assert(is[i] == kIndexSequence[i]);
+	}
+
+	assert(meshopt_decodeBatch(items, item_count - 1, parallelForReverse, NULL) == 0);
+	assert(meshopt_decodeBatch(NULL, 0, parallelForReverse, NULL) == 0);
+}
+
+static void clusterBoundsDegenerate()
+{
+	const float vbd[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	const unsigned int ibd[] = {0, 0, 0};
+	const unsigned int ib1[] = {0, 1, 2};
+
+	// all of the bounds below are degenerate as they use 0 triangles, one topology-degenerate triangle and one position-degenerate triangle respectively
+	meshopt_Bounds bounds0 = meshopt_computeClusterBounds(NULL, 0, NULL, 0, 12);
+	meshopt_Bounds boundsd = meshopt_computeClusterBounds(ibd, 3, vbd, 3, 12);
+	meshopt_Bounds bounds1 = meshopt_computeClusterBounds(ib1, 3, vbd, 3, 12);
+
+	assert(bounds0.center[0] == 0 && bounds0.center[1] == 0 && bounds0.center[2] == 0 && bounds0.radius == 0);
+	assert(boundsd.center[0] == 0 && boundsd.center[1] == 0 && boundsd.center[2] == 0 && boundsd.radius == 0);
+	assert(bounds1.center[0] == 0 && bounds1.center[1] == 0 && bounds1.center[2] == 0 && bounds1.radius == 0);
+
+	const float vb1[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+	const unsigned int ib2[] = {0, 1, 2, 0, 2, 1};
+
+	// these bounds have a degenerate cone since the cluster has two triangles with opposite normals
+	meshopt_Bounds bounds2 = meshopt_computeClusterBounds(ib2, 6, vb1, 3, 12);
+
+	assert(bounds2.cone_apex[0] == 0 && bounds2.cone_apex[1] == 0 && bounds2.cone_apex[2] == 0);
+	assert(bounds2.cone_axis[0] == 0 && bounds2.cone_axis[1] == 0 && bounds2.cone_axis[2] == 0);
+	assert(bounds2.cone_cutoff == 1);
+	assert(bounds2.cone_axis_s8[0] == 0 && bounds2.cone_axis_s8[1] == 0 && bounds2.cone_axis_s8[2] == 0);
+	assert(bounds2.cone_cutoff_s8 == 127);
+
+	// however, the bounding sphere needs to be in tact (here we only check bbox for simplicity)
+	assert(bounds2.center[0] - bounds2.radius <= 0 && bounds2.center[0] + bounds2.radius >= 1);
+	assert(bounds2.center[1] - bounds2.radius <= 0 && bounds2.center[1] + bounds2.radius >= 1);
+	assert(bounds2.center[2] - bounds2.radius <= 0 && bounds2.center[2] + bounds2.radius >= 1);
+}
+
+static void meshletsParallel()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t max_vertices = 64, max_triangles = 64, region_size = 256;
+
+	size_t max_meshlets = meshopt_buildMeshletsParallelBound(ib.size(), max_vertices, max_triangles, region_size);
+	assert(max_meshlets >= meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles));
+
+	std::vector<meshopt_Meshlet> serial(max_meshlets), parallel(max_meshlets);
+	std::vector<unsigned int> serial_vertices(max_meshlets * max_vertices), parallel_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> serial_triangles(max_meshlets * max_triangles * 3), parallel_triangles(max_meshlets * max_triangles * 3);
+
+	size_t serial_count = meshopt_buildMeshletsParallel(&serial[0], &serial_vertices[0], &serial_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f, region_size, NULL, NULL);
+	size_t parallel_count = meshopt_buildMeshletsParallel(&parallel[0], &parallel_vertices[0], &parallel_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f, region_size, parallelForReverse, NULL);
+
+	assert(serial_count > 0 && serial_count <= max_meshlets);
+
+	// regions are independent so the result doesn't depend on execution order
+	assert(serial_count == parallel_count);
+	assert(memcmp(&serial[0], &parallel[0], serial_count * sizeof(meshopt_Meshlet)) == 0);
+	assert(memcmp(&serial_vertices[0], &parallel_vertices[0], serial_vertices.size() * sizeof(unsigned int)) == 0);
+	assert(memcmp(&serial_triangles[0], &parallel_triangles[0], serial_triangles.size()) == 0);
+
+	// meshlets must be packed consecutively and cover every input triangle exactly once
+	std::vector<char> covered(ib.size() / 3);
+	size_t vertex_offset = 0, triangle_offset = 0;
+
+	for (size_t i = 0; i < serial_count; ++i)
+	{
+		const meshopt_Meshlet& m = serial[i];
+
+		assert(m.vertex_offset == vertex_offset && m.triangle_offset == triangle_offset);
+		assert(m.vertex_count <= max_vertices && m.triangle_count <= max_triangles);
+
+		vertex_offset += m.vertex_count;
+		triangle_offset += (m.triangle_count * 3 + 3) & ~3;
+
+		for (size_t j = 0; j < m.triangle_count; ++j)
+		{
+			unsigned int a = serial_vertices[m.vertex_offset + serial_triangles[m.triangle_offset + j * 3 + 0]];
+			unsigned int b = serial_vertices[m.vertex_offset + serial_triangles[m.triangle_offset + j * 3 + 1]];
+			unsigned int c = serial_vertices[m.vertex_offset + serial_triangles[m.triangle_offset + j * 3 + 2]];
+
+			bool found = false;
+			for (size_t k = 0; k < ib.size() && !found; k += 3)
+				for (int r = 0; r < 3 && !found; ++r)
+					if (!covered[k / 3] && ib[k + r] == a && ib[k + (r + 1) % 3] == b && ib[k + (r + 2) % 3] == c)
+					{
+						covered[k / 3] = 1;
+						found = true;
+					}
+
+			assert(found);
+		}
+	}
+
+	for (size_t i = 0; i < covered.size(); ++i)
+		assert(covered[i]);
+
+	// a single region produces the same result as meshopt_buildMeshlets
+	std::vector<meshopt_Meshlet> single(max_meshlets), reference(max_meshlets);
+	std::vector<unsigned int> single_vertices(max_meshlets * max_vertices), reference_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> single_triangles(max_meshlets * max_triangles * 3), reference_triangles(max_meshlets * max_triangles * 3);
+
+	size_t single_count = meshopt_buildMeshletsParallel(&single[0], &single_vertices[0], &single_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f, ib.size() / 3, parallelForReverse, NULL);
+	size_t reference_count = meshopt_buildMeshlets(&reference[0], &reference_vertices[0], &reference_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f);
+
+	assert(single_count == reference_count);
+	assert(memcmp(&single[0], &reference[0], single_count * sizeof(meshopt_Meshlet)) == 0);
+	assert(memcmp(&single_vertices[0], &reference_vertices[0], single_vertices.size() * sizeof(unsigned int)) == 0);
+	assert(memcmp(&single_triangles[0], &reference_triangles[0], single_triangles.size()) == 0);
+}
+
+static void meshletBoundsBatch()
+{
+	const int N = 130;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t max_vertices = 64, max_triangles = 64;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f));
+	assert(meshlets.size() > 256); // need more than one task
+
+	std::vector<float> spheres(meshlets.size() * 4), apexes(meshlets.size() * 3);
+	std::vector<signed char> cones(meshlets.size() * 4);
+
+	meshopt_computeMeshletBoundsBatch(&spheres[0], &cones[0], &apexes[0], &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], N * N, 12, parallelForReverse, NULL);
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+		meshopt_Bounds bounds = meshopt_computeMeshletBounds(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset], m.triangle_count, &vb[0], N * N, 12);
+
+		assert(memcmp(&spheres[i * 4], bounds.center, 3 * sizeof(float)) == 0 && spheres[i * 4 + 3] == bounds.radius);
+		assert(memcmp(&cones[i * 4], bounds.cone_axis_s8, 3) == 0 && cones[i * 4 + 3] == bounds.cone_cutoff_s8);
+		assert(memcmp(&apexes[i * 3], bounds.cone_apex, 3 * sizeof(float)) == 0);
+	}
+
+	// sphere-only computation skips cone fitting but should produce the same spheres
+	std::vector<float> spheres_only(meshlets.size() * 4);
+	meshopt_computeMeshletBoundsBatch(&spheres_only[0], NULL, NULL, &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], N * N, 12, NULL, NULL);
+
+	assert(spheres == spheres_only);
+
+	// empty input is valid
+	meshopt_computeMeshletBoundsBatch(NULL, NULL, NULL, NULL, 0, NULL, NULL, &vb[0], N * N, 12, parallelForReverse, NULL);
+}
+
+static void validateMeshletBVH(const std::vector<meshopt_MeshletBVHNode>& nodes, const std::vector<float>& spheres, size_t meshlet_count, size_t branching)
+{
+	std::vector<unsigned int> parents(nodes.size(), ~0u);
+	std::vector<char> covered(meshlet_count);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		const meshopt_MeshletBVHNode& node = nodes[i];
+
+		assert((node.child_count == 0) != (node.meshlet_count == 0));
+		assert(node.child_count <= branching && node.meshlet_count <= branching);
+
+		for (size_t j = 0; j < node.child_count; ++j)
+		{
+			size_t c = node.offset + j;
+			assert(c > i && c < nodes.size());
+			assert(parents[c] == ~0u);
+			parents[c] = unsigned(i);
+
+			const meshopt_MeshletBVHNode& child = nodes[c];
+
+			float dx = child.center[0] - node.center[0], dy = child.center[1] - node.center[1], dz = child.center[2] - node.center[2];
+			assert(sqrtf(dx * dx + dy * dy + dz * dz) + child.radius <= node.radius * 1.0001f + 1e-5f);
+
+			for (int k = 0; k < 3; ++k)
+				assert(child.aabb_min[k] >= node.aabb_min[k] && child.aabb_max[k] <= node.aabb_max[k]);
+		}
+
+		for (size_t j = 0; j < node.meshlet_count; ++j)
+		{
+			size_t m = node.offset + j;
+			assert(m < meshlet_count && !covered[m]);
+			covered[m] = 1;
+
+			const float* sphere = &spheres[m * 4];
+
+			float dx = sphere[0] - node.center[0], dy = sphere[1] - node.center[1], dz = sphere[2] - node.center[2];
+			assert(sqrtf(dx * dx + dy * dy + dz * dz) + sphere[3] <= node.radius * 1.0001f + 1e-5f);
+
+			for (int k = 0; k < 3; ++k)
+				assert(sphere[k] - sphere[3] >= node.aabb_min[k] && sphere[k] + sphere[3] <= node.aabb_max[k]);
+		}
+	}
+
+	for (size_t i = 1; i < nodes.size(); ++i)
+		assert(parents[i] != ~0u);
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+		assert(covered[i]);
+}
+
+static void meshletBVH()
+{
+	const int N = 130;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t max_vertices = 64, max_triangles = 64;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.f));
+
+	std::vector<float> spheres(meshlets.size() * 4);
+	meshopt_computeMeshletBoundsBatch(&spheres[0], NULL, NULL, &meshlets[0], meshlets.size(), &meshlet_vertices[0], &meshlet_triangles[0], &vb[0], N * N, 12, NULL, NULL);
+
+	for (size_t branching = 2; branching <= 8; branching *= 2)
+	{
+		std::vector<meshopt_MeshletBVHNode> nodes(meshlets.size() * 2);
+		std::vector<unsigned int> remap(meshlets.size());
+
+		nodes.resize(meshopt_buildMeshletBVH(&nodes[0], &remap[0], &spheres[0], meshlets.size(), branching));
+		assert(nodes.size() > 1 && nodes.size() < meshlets.size() * 2);
+
+		// spheres are reordered the same way meshlets would be
+		std::vector<float> sorted(spheres.size());
+		meshopt_remapVertexBuffer(&sorted[0], &spheres[0], meshlets.size(), sizeof(float) * 4, &remap[0]);
+
+		validateMeshletBVH(nodes, sorted, meshlets.size(), branching);
+	}
+
+	// coincident meshlets can't be separated spatially but still need to respect the branching factor
+	std::vector<float> same(100 * 4, 1.f);
+	std::vector<meshopt_MeshletBVHNode> nodes(100 * 2);
+	std::vector<unsigned int> remap(100);
+
+	nodes.resize(meshopt_buildMeshletBVH(&nodes[0], &remap[0], &same[0], 100, 4));
+	validateMeshletBVH(nodes, same, 100, 4);
+
+	// single meshlet forms a leaf root
+	assert(meshopt_buildMeshletBVH(&nodes[0], &remap[0], &same[0], 1, 4) == 1);
+	assert(nodes[0].meshlet_count == 1 && nodes[0].offset == 0 && remap[0] == 0);
+	assert(nodes[0].radius == 1.f && nodes[0].aabb_min[0] == 0.f && nodes[0].aabb_max[0] == 2.f);
+
+	assert(meshopt_buildMeshletBVH(NULL, NULL, NULL, 0, 4) == 0);
+}
+
+static void spatialSortParallel()
+{
+	// points in a tiny cluster all get the same 30-bit key because of the far away outlier; 63-bit keys should still order them
+	const size_t cluster = 1000;
+
+	std::vector<float> vb;
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < cluster; ++i)
+		for (int k = 0; k < 3; ++k)
+		{
+			seed = seed * 1664525 + 1013904223;
+			vb.push_back(float(seed >> 8) / float(1 << 24) * 1e-4f);
+		}
+
+	vb.push_back(1.f), vb.push_back(1.f), vb.push_back(1.f);
+
+	std::vector<unsigned int> remap(cluster + 1), remap_wide(cluster + 1);
+	meshopt_spatialSortRemap(&remap[0], &vb[0], cluster + 1, 12);
+	meshopt_spatialSortRemapParallel(&remap_wide[0], &vb[0], cluster + 1, 12, NULL, NULL);
+
+	for (size_t i = 0; i < cluster; ++i)
+		assert(remap[i] == i);
+
+	assert(remap_wide[cluster] == cluster);
+
+	std::vector<float> sorted(vb.size());
+	meshopt_remapVertexBuffer(&sorted[0], &vb[0], cluster, 12, &remap_wide[0]);
+
+	float path = 0, path_sorted = 0;
+
+	for (size_t i = 1; i < cluster; ++i)
+	{
+		float d = 0, ds = 0;
+		for (int k = 0; k < 3; ++k)
+		{
+			d += (vb[i * 3 + k] - vb[i * 3 - 3 + k]) * (vb[i * 3 + k] - vb[i * 3 - 3 + k]);
+			ds += (sorted[i * 3 + k] - sorted[i * 3 - 3 + k]) * (sorted[i * 3 + k] - sorted[i * 3 - 3 + k]);
+		}
+
+		path += sqrtf(d);
+		path_sorted += sqrtf(ds);
+	}
+
+	assert(path_sorted * 4 < path);
+
+	// large inputs are split into multiple chunks; the result must be a permutation and must not depend on task order
+	const size_t count = 150000;
+
+	std::vector<float> large(count * 4);
+	for (size_t i = 0; i < large.size(); ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		large[i] = float(seed >> 8) / float(1 << 24) * 100.f;
+	}
+
+	std::vector<unsigned int> serial(count), parallel(count);
+	meshopt_spatialSortRemapParallel(&serial[0], &large[0], count, 16, NULL, NULL);
+	meshopt_spatialSortRemapParallel(&parallel[0], &large[0], count, 16, parallelForReverse, NULL);
+
+	assert(serial == parallel);
+
+	std::vector<char> used(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		assert(serial[i] < count && !used[serial[i]]);
+		used[serial[i]] = 1;
+	}
+
+	meshopt_spatialSortRemapParallel(NULL, NULL, 0, 12, parallelForReverse, NULL);
+}
+
+static unsigned long long canonicalTriangle(unsigned int a, unsigned int b, unsigned int c)
+{
+	while (a > b || a > c)
+	{
+		unsigned int t = a;
+		a = b, b = c, c = t;
+	}
+
+	return (unsigned long long)a << 42 | (unsigned long long)b << 21 | c;
+}
+
+static int compareTriangles(const void* lhs, const void* rhs)
+{
+	unsigned long long l = *static_cast<const unsigned long long*>(lhs);
+	unsigned long long r = *static_cast<const unsigned long long*>(rhs);
+
+	return l < r ? -1 : l > r;
+}
+
+static void optimizeVertexCacheParallel()
+{
+	const int N = 120;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(0.f);
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			unsigned int i0 = y * N + x, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+			ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+			ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+		}
+
+	// shuffle triangles so that the input order has poor locality
+	unsigned int seed = 42;
+	for (size_t i = ib.size() / 3 - 1; i > 0; --i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		size_t j = (seed >> 8) % (i + 1);
+		for (int k = 0; k < 3; ++k)
+			std::swap(ib[i * 3 + k], ib[j * 3 + k]);
+	}
+
+	const size_t chunk_size = 4096;
+
+	std::vector<unsigned int> serial(ib.size()), parallel(ib.size()), full(ib.size());
+	meshopt_optimizeVertexCacheParallel(&serial[0], &ib[0], ib.size(), N * N, &vb[0], 12, chunk_size, NULL, NULL);
+	meshopt_optimizeVertexCacheParallel(&parallel[0], &ib[0], ib.size(), N * N, &vb[0], 12, chunk_size, parallelForReverse, NULL);
+	meshopt_optimizeVertexCache(&full[0], &ib[0], ib.size(), N * N);
+
+	assert(serial == parallel);
+
+	// the result must be a permutation of input triangles; triangles may be rotated by the optimizer so compare them in canonical form
+	std::vector<unsigned long long> input_tris(ib.size() / 3), output_tris(ib.size() / 3);
+	for (size_t i = 0; i < ib.size(); i += 3)
+	{
+		input_tris[i / 3] = canonicalTriangle(ib[i + 0], ib[i + 1], ib[i + 2]);
+		output_tris[i / 3] = canonicalTriangle(serial[i + 0], serial[i + 1], serial[i + 2]);
+	}
+
+	qsort(&input_tris[0], input_tris.size(), sizeof(unsigned long long), compareTriangles);
+	qsort(&output_tris[0], output_tris.size(), sizeof(unsigned long long), compareTriangles);
+	assert(input_tris == output_tris);
+
+	// chunking should have a small effect on transform cache efficiency
+	meshopt_VertexCacheStatistics vcs_input = meshopt_analyzeVertexCache(&ib[0], ib.size(), N * N, 16, 0, 0);
+	meshopt_VertexCacheStatistics vcs_full = meshopt_analyzeVertexCache(&full[0], full.size(), N * N, 16, 0, 0);
+	meshopt_VertexCacheStatistics vcs_chunked = meshopt_analyzeVertexCache(&serial[0], serial.size(), N * N, 16, 0, 0);
+
+	assert(vcs_chunked.acmr < vcs_input.acmr * 0.5f);
+	assert(vcs_chunked.acmr < vcs_full.acmr * 1.1f);
+
+	// a single chunk without positions matches the serial optimizer exactly
+	std::vector<unsigned int> single(ib.size());
+	meshopt_optimizeVertexCacheParallel(&single[0], &ib[0], ib.size(), N * N, NULL, 0, ib.size() / 3, parallelForReverse, NULL);
+	assert(single == full);
+
+	// in-place optimization
+	std::vector<unsigned int> inplace = ib;
+	meshopt_optimizeVertexCacheParallel(&inplace[0], &inplace[0], inplace.size(), N * N, &vb[0], 12, chunk_size, parallelForReverse, NULL);
+	assert(inplace == serial);
+
+	meshopt_optimizeVertexCacheParallel(NULL, NULL, 0, 0, NULL, 0, chunk_size, parallelForReverse, NULL);
+}
+
+static void optimizeVertexCacheWithScores()
+{
+	const int N = 30;
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			unsigned int i0 = y * N + x, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+			ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+			ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+		}
+
+	// built-in table used by meshopt_optimizeVertexCache
+	const float cache[16] = {0.779f, 0.791f, 0.789f, 0.981f, 0.843f, 0.726f, 0.847f, 0.882f, 0.867f, 0.799f, 0.642f, 0.613f, 0.600f, 0.568f, 0.372f, 0.234f};
+	const float live[8] = {0.995f, 0.713f, 0.450f, 0.404f, 0.059f, 0.005f, 0.147f, 0.006f};
+
+	std::vector<unsigned int> expected(ib.size()), result(ib.size());
+	meshopt_optimizeVertexCache(&expected[0], &ib[0], ib.size(), N * N);
+	meshopt_optimizeVertexCacheWithScores(&result[0], &ib[0], ib.size(), N * N, cache, live);
+	assert(result == expected);
+
+	// in-place optimization with 16-bit indices
+	std::vector<unsigned short> ibs(ib.begin(), ib.end());
+	meshopt_optimizeVertexCacheWithScores(&ibs[0], &ibs[0], ibs.size(), N * N, cache, live);
+	assert(std::equal(ibs.begin(), ibs.end(), expected.begin()));
+
+	// scores that ignore the cache reduce to emitting triangles by valence, which is worse for the cache
+	const float nocache[16] = {};
+	meshopt_optimizeVertexCacheWithScores(&result[0], &ib[0], ib.size(), N * N, nocache, live);
+	assert(result != expected);
+
+	meshopt_VertexCacheStatistics vcs_expected = meshopt_analyzeVertexCache(&expected[0], expected.size(), N * N, 16, 0, 0);
+	meshopt_VertexCacheStatistics vcs_result = meshopt_analyzeVertexCache(&result[0], result.size(), N * N, 16, 0, 0);
+	assert(vcs_result.acmr > vcs_expected.acmr);
+}
+
+static void triangleAdjacency()
+{
+	const int N = 150;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(0.f);
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			unsigned int i0 = y * N + x, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+			ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+			ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+		}
+
+	// degenerate triangle lists its vertex for every corner
+	ib.push_back(5), ib.push_back(5), ib.push_back(6);
+
+	meshopt_TriangleAdjacency serial, parallel;
+	meshopt_buildTriangleAdjacency(&serial, &ib[0], ib.size(), N * N, NULL, NULL);
+	meshopt_buildTriangleAdjacency(&parallel, &ib[0], ib.size(), N * N, parallelForReverse, NULL);
+
+	assert(serial.index_count == ib.size() && serial.vertex_count == N * N);
+	assert(memcmp(serial.offsets, parallel.offsets, (N * N + 1) * sizeof(unsigned int)) == 0);
+	assert(memcmp(serial.data, parallel.data, ib.size() * sizeof(unsigned int)) == 0);
+
+	// every triangle is listed for each of its corners in increasing order
+	assert(serial.offsets[0] == 0 && serial.offsets[N * N] == ib.size());
+
+	for (size_t v = 0; v < N * N; ++v)
+		for (unsigned int i = serial.offsets[v]; i < serial.offsets[v + 1]; ++i)
+		{
+			unsigned int tri = serial.data[i];
+			assert(ib[tri * 3 + 0] == v || ib[tri * 3 + 1] == v || ib[tri * 3 + 2] == v);
+			assert(i == serial.offsets[v] || serial.data[i - 1] <= tri);
+		}
+
+	// vertex 5 is used by 3 grid triangles and 2 corners of the degenerate triangle
+	assert(serial.offsets[6] - serial.offsets[5] == 5);
+
+	// functions that use adjacency produce the same results as functions that build it internally
+	std::vector<unsigned int> reference(ib.size()), result(ib.size());
+	meshopt_optimizeVertexCache(&reference[0], &ib[0], ib.size(), N * N);
+	meshopt_optimizeVertexCacheWithAdjacency(&result[0], &ib[0], ib.size(), N * N, &parallel);
+	assert(reference == result);
+
+	// adjacency is not modified so it can be reused
+	meshopt_optimizeVertexCacheWithAdjacency(&result[0], &ib[0], ib.size(), N * N, &parallel);
+	assert(reference == result);
+
+	const size_t max_vertices = 64, max_triangles = 124;
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+
+	std::vector<meshopt_Meshlet> meshlets1(max_meshlets), meshlets2(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices1(max_meshlets * max_vertices), meshlet_vertices2(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles1(max_meshlets * max_triangles * 3), meshlet_triangles2(max_meshlets * max_triangles * 3);
+
+	size_t count1 = meshopt_buildMeshlets(&meshlets1[0], &meshlet_vertices1[0], &meshlet_triangles1[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f);
+	size_t count2 = meshopt_buildMeshletsWithAdjacency(&meshlets2[0], &meshlet_vertices2[0], &meshlet_triangles2[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.25f, &serial);
+
+	assert(count1 == count2);
+	assert(memcmp(&meshlets1[0], &meshlets2[0], count1 * sizeof(meshopt_Meshlet)) == 0);
+	assert(meshlet_vertices1 == meshlet_vertices2);
+	assert(meshlet_triangles1 == meshlet_triangles2);
+
+	meshopt_destroyTriangleAdjacency(&serial);
+	meshopt_destroyTriangleAdjacency(&parallel);
+	assert(serial.offsets == NULL && serial.data == NULL);
+
+	// sparse vertex references require more radix passes; unreferenced vertices have empty ranges
+	const size_t sparse_count = 1 << 23;
+
+	std::vector<unsigned int> sparse(ib.size());
+	for (size_t i = 0; i < ib.size(); ++i)
+		sparse[i] = unsigned(ib[i] * 331 % (sparse_count - 7));
+
+	meshopt_buildTriangleAdjacency(&serial, &sparse[0], sparse.size(), sparse_count, NULL, NULL);
+	meshopt_buildTriangleAdjacency(&parallel, &sparse[0], sparse.size(), sparse_count, parallelForReverse, NULL);
+
+	assert(memcmp(serial.offsets, parallel.offsets, (sparse_count + 1) * sizeof(unsigned int)) == 0);
+	assert(memcmp(serial.data, parallel.data, sparse.size() * sizeof(unsigned int)) == 0);
+	assert(serial.offsets[sparse_count] == sparse.size() && serial.offsets[sparse_count - 1] == sparse.size());
+
+	meshopt_destroyTriangleAdjacency(&serial);
+	meshopt_destroyTriangleAdjacency(&parallel);
+
+	meshopt_buildTriangleAdjacency(&serial, NULL, 0, 0, parallelForReverse, NULL);
+	assert(serial.offsets[0] == 0);
+	meshopt_destroyTriangleAdjacency(&serial);
+}
+
+static void optimizeOverdrawParallel()
+{
+	// disjoint patches produce many hard boundaries; the mesh is large enough to split soft boundary generation into several batches
+	const int N = 100, P = 16;
+
+	std::vector<float> vb;
+	for (int p = 0; p < P; ++p)
+		for (int y = 0; y < N; ++y)
+			for (int x = 0; x < N; ++x)
+			{
+				vb.push_back(float(x + p * N));
+				vb.push_back(float(y));
+				vb.push_back(sinf(float(x) * 0.1f) * cosf(float(y + p) * 0.07f) * 10.f);
+			}
+
+	std::vector<unsigned int> ib;
+	for (int p = 0; p < P; ++p)
+		for (int y = 0; y + 1 < N; ++y)
+			for (int x = 0; x + 1 < N; ++x)
+			{
+				unsigned int i0 = p * N * N + y * N + x, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+				ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+				ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+			}
+
+	const size_t vertex_count = N * N * P;
+
+	meshopt_optimizeVertexCache(&ib[0], &ib[0], ib.size(), vertex_count);
+
+	const float thresholds[] = {1.f, 1.05f, 3.f};
+
+	for (size_t i = 0; i < sizeof(thresholds) / sizeof(thresholds[0]); ++i)
+	{
+		std::vector<unsigned int> serial(ib.size()), parallel(ib.size());
+		meshopt_optimizeOverdraw(&serial[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, thresholds[i]);
+		meshopt_optimizeOverdrawParallel(&parallel[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, thresholds[i], parallelForReverse, NULL);
+
+		assert(serial == parallel);
+
+		// in-place optimization
+		std::vector<unsigned int> inplace = ib;
+		meshopt_optimizeOverdrawParallel(&inplace[0], &inplace[0], ib.size(), &vb[0], vertex_count, 12, thresholds[i], parallelForReverse, NULL);
+
+		assert(serial == inplace);
+	}
+
+	// empty mesh
+	meshopt_optimizeOverdrawParallel(NULL, NULL, 0, &vb[0], vertex_count, 12, 1.05f, parallelForReverse, NULL);
+}
+
+struct PTV
+{
+	float px, py, pz;
+	float tx, ty;
+};
+
+static void optimizeMesh()
+{
+	// unindexed grid with shuffled corners, to make sure every stage changes the result
+	const int N = 110;
+
+	std::vector<PTV> vertices;
+
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			int corners[6][2] = {{x, y}, {x, y + 1}, {x + 1, y}, {x + 1, y}, {x, y + 1}, {x + 1, y + 1}};
+
+			for (int k = 0; k < 6; ++k)
+			{
+				PTV v = {float(corners[k][0]), float(corners[k][1]), float((corners[k][0] * corners[k][1]) % 7), float(corners[k][0] % 3), float(corners[k][1] % 5)};
+				vertices.push_back(v);
+			}
+		}
+
+	size_t vertex_count = vertices.size();
+	size_t index_count = vertex_count;
+
+	std::vector<unsigned int> indices(index_count);
+	for (size_t i = 0; i < index_count; ++i)
+		indices[(i * 7919) % index_count] = unsigned(i);
+
+	const meshopt_Stream streams[] = {
+	    {&vertices[0].px, sizeof(float) * 3, sizeof(PTV)},
+	    {&vertices[0].tx, sizeof(float) * 2, sizeof(PTV)},
+	};
+
+	for (int options = 0; options < 8; ++options)
+	{
+		// reference pipeline
+		std::vector<unsigned int> ri(index_count);
+		std::vector<PTV> rv(vertex_count);
+		size_t unique = vertex_count;
+
+		if (options & meshopt_OptimizeMeshSkipRemap)
+		{
+			ri = indices;
+			rv = vertices;
+		}
+		else
+		{
+			std::vector<unsigned int> remap(vertex_count);
+			unique = meshopt_generateVertexRemapMulti(&remap[0], &indices[0], index_count, vertex_count, streams, 2);
+			meshopt_remapIndexBuffer(&ri[0], &indices[0], index_count, &remap[0]);
+			meshopt_remapVertexBuffer(&rv[0], &vertices[0], vertex_count, sizeof(PTV), &remap[0]);
+		}
+
+		if (options & meshopt_OptimizeMeshStrip)
+			meshopt_optimizeVertexCacheStrip(&ri[0], &ri[0], index_count, unique);
+		else
+			meshopt_optimizeVertexCache(&ri[0], &ri[0], index_count, unique);
+
+		if (options & meshopt_OptimizeMeshOverdraw)
+			meshopt_optimizeOverdraw(&ri[0], &ri[0], index_count, &rv[0].px, unique, sizeof(PTV), 1.05f);
+
+		unique = meshopt_optimizeVertexFetch(&rv[0], &ri[0], index_count, &rv[0], unique, sizeof(PTV));
+
+		for (int mode = 0; mode < 3; ++mode)
+		{
+			std::vector<unsigned int> oi = mode == 2 ? indices : std::vector<unsigned int>(index_count);
+			std::vector<float> positions(vertex_count * 3), uvs(vertex_count * 2);
+
+			// mode 2 optimizes in place, using separate arrays for every stream
+			if (mode == 2)
+				for (size_t i = 0; i < vertex_count; ++i)
+				{
+					memcpy(&positions[i * 3], &vertices[i].px, sizeof(float) * 3);
+					memcpy(&uvs[i * 2], &vertices[i].tx, sizeof(float) * 2);
+				}
+
+			const meshopt_Stream inplace_streams[] = {
+			    {&positions[0], sizeof(float) * 3, sizeof(float) * 3},
+			    {&uvs[0], sizeof(float) * 2, sizeof(float) * 2},
+			};
+
+			void* destinations[] = {&positions[0], &uvs[0]};
+
+			size_t result = meshopt_optimizeMesh(&oi[0], destinations, mode == 2 ? &oi[0] : &indices[0], index_count, vertex_count, mode == 2 ? inplace_streams : streams, 2, options, 1.05f, mode == 1 ? parallelForReverse : NULL, NULL);
+			assert(result == unique);
+			assert(oi == ri);
+
+			for (size_t i = 0; i < unique; ++i)
+			{
+				assert(positions[i * 3 + 0] == rv[i].px && positions[i * 3 + 1] == rv[i].py && positions[i * 3 + 2] == rv[i].pz);
+				assert(uvs[i * 2 + 0] == rv[i].tx && uvs[i * 2 + 1] == rv[i].ty);
+			}
+		}
+	}
+}
+
+static void generateVertexRemapParallel()
+{
+	// large enough to be processed in several chunks; vertices repeat with a period that isn't aligned to chunk boundaries
+	const size_t vertex_count = 200003;
+
+	std::vector<float> vb(vertex_count * 3);
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int v = unsigned(i % 70001);
+
+		vb[i * 3 + 0] = float(v % 101);
+		vb[i * 3 + 1] = float(v / 101);
+		vb[i * 3 + 2] = float(v % 7);
+	}
+
+	// index buffer references vertices out of order and leaves some of them unreferenced
+	std::vector<unsigned int> ib;
+	unsigned int seed = 42;
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		ib.push_back((seed >> 8) % vertex_count);
+	}
+
+	ib.resize(ib.size() / 3 * 3);
+
+	std::vector<unsigned int> serial(vertex_count), parallel(vertex_count);
+
+	size_t serial_count = meshopt_generateVertexRemap(&serial[0], &ib[0], ib.size(), &vb[0], vertex_count, 12);
+	size_t parallel_count = meshopt_generateVertexRemapParallel(&parallel[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, parallelForReverse, NULL);
+
+	assert(serial_count == parallel_count);
+	assert(serial == parallel);
+
+	// unindexed
+	serial_count = meshopt_generateVertexRemap(&serial[0], NULL, vertex_count, &vb[0], vertex_count, 12);
+	parallel_count = meshopt_generateVertexRemapParallel(&parallel[0], NULL, vertex_count, &vb[0], vertex_count, 12, parallelForReverse, NULL);
+
+	assert(serial_count == 70001);
+	assert(serial_count == parallel_count);
+	assert(serial == parallel);
+
+	// multiple streams
+	meshopt_Stream streams[] = {
+	    {&vb[0], 4, 12},
+	    {&vb[2], 4, 12},
+	};
+
+	serial_count = meshopt_generateVertexRemapMulti(&serial[0], &ib[0], ib.size(), vertex_count, streams, 2);
+	parallel_count = meshopt_generateVertexRemapMultiParallel(&parallel[0], &ib[0], ib.size(), vertex_count, streams, 2, parallelForReverse, NULL);
+
+	assert(serial_count == parallel_count);
+	assert(serial == parallel);
+}
+
+static void generateVertexRemapSizes()
+{
+	const size_t sizes[] = {4, 12, 16, 20, 24, 32, 36, 48, 64, 100, 256};
+
+	for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); ++si)
+	{
+		size_t vertex_size = sizes[si];
+
+		// vertices 2k and 2k+1 are identical; each pair differs from the others in exactly one byte that moves across the vertex
+		std::vector<unsigned char> vb(vertex_size * 64);
+		for (size_t i = 0; i < 64; ++i)
+			vb[i * vertex_size + (i / 2) % vertex_size] = (unsigned char)(i / 2 / vertex_size + 1);
+
+		std::vector<unsigned int> remap(64);
+		size_t unique = meshopt_generateVertexRemap(&remap[0], NULL, 64, &vb[0], 64, vertex_size);
+
+		assert(unique == 32);
+
+		for (size_t i = 0; i < 64; ++i)
+			assert(remap[i] == i / 2);
+	}
+}
+
+static void clusterHierarchy()
+{
+	const int N = 100;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t max_vertices = 64, max_triangles = 64, group_size = 8;
+
+	size_t max_indices = ib.size() * 20 / 3;
+	size_t max_clusters = meshopt_buildClusterHierarchyBound(max_indices, max_vertices, max_triangles);
+
+	std::vector<meshopt_LODCluster> clusters(max_clusters), clusters2(max_clusters);
+	std::vector<meshopt_LODGroup> groups(max_clusters / 2), groups2(max_clusters / 2);
+	std::vector<unsigned int> indices(max_indices), indices2(max_indices);
+	size_t group_count = 0, group_count2 = 0;
+
+	size_t cluster_count = meshopt_buildClusterHierarchy(&clusters[0], max_clusters, &groups[0], &indices[0], max_indices, &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, max_vertices, max_triangles, group_size, &group_count, NULL, NULL);
+	size_t cluster_count2 = meshopt_buildClusterHierarchy(&clusters2[0], max_clusters, &groups2[0], &indices2[0], max_indices, &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, max_vertices, max_triangles, group_size, &group_count2, parallelForReverse, NULL);
+
+	// groups are independent so the result doesn't depend on execution order
+	assert(cluster_count == cluster_count2 && group_count == group_count2);
+	assert(memcmp(&clusters[0], &clusters2[0], cluster_count * sizeof(meshopt_LODCluster)) == 0);
+	assert(memcmp(&groups[0], &groups2[0], group_count * sizeof(meshopt_LODGroup)) == 0);
+	assert(memcmp(&indices[0], &indices2[0], indices.size() * sizeof(unsigned int)) == 0);
+
+	assert(cluster_count > 0 && cluster_count <= max_clusters);
+	assert(group_count > 0);
+
+	size_t index_offset = 0, original_indices = 0, root_indices = 0;
+
+	for (size_t i = 0; i < cluster_count; ++i)
+	{
+		const meshopt_LODCluster& cluster = clusters[i];
+
+		assert(cluster.index_offset == index_offset && cluster.index_count > 0 && cluster.index_count <= max_triangles * 3);
+		index_offset += cluster.index_count;
+
+		original_indices += cluster.depth == 0 ? cluster.index_count : 0;
+		root_indices += cluster.parent_group == ~0u ? cluster.index_count : 0;
+
+		if (cluster.parent_group == ~0u)
+		{
+			assert(cluster.parent.error == FLT_MAX);
+			continue;
+		}
+
+		const meshopt_LODGroup& group = groups[cluster.parent_group];
+
+		// parent bounds must contain self bounds and have a larger error
+		assert(memcmp(&cluster.parent, &group.bounds, sizeof(meshopt_LODBounds)) == 0);
+		assert(cluster.parent.error >= cluster.self.error);
+
+		float dx = cluster.self.center[0] - cluster.parent.center[0], dy = cluster.self.center[1] - cluster.parent.center[1], dz = cluster.self.center[2] - cluster.parent.center[2];
+		assert(sqrtf(dx * dx + dy * dy + dz * dz) + cluster.self.radius <= cluster.parent.radius * 1.0001f);
+
+		// clusters produced by the group come after the clusters merged into it
+		assert(group.cluster_offset > i);
+	}
+
+	assert(original_indices == ib.size());
+	assert(root_indices < ib.size() / 4);
+
+	for (size_t i = 0; i < group_count; ++i)
+		for (size_t j = 0; j < groups[i].cluster_count; ++j)
+		{
+			const meshopt_LODCluster& cluster = clusters[groups[i].cluster_offset + j];
+
+			assert(memcmp(&cluster.self, &groups[i].bounds, sizeof(meshopt_LODBounds)) == 0);
+			assert(cluster.depth > 0);
+		}
+
+	// any cut through the hierarchy must cover the grid without holes; we check that by comparing projected area
+	float thresholds[] = {0.f, 1e-3f, 1e-2f, 1e-1f, 1.f, FLT_MAX};
+
+	for (size_t t = 0; t < sizeof(thresholds) / sizeof(thresholds[0]); ++t)
+	{
+		double area = 0;
+
+		for (size_t i = 0; i < cluster_count; ++i)
+		{
+			const meshopt_LODCluster& cluster = clusters[i];
+
+			if (!(cluster.self.error <= thresholds[t] && (cluster.parent.error > thresholds[t] || cluster.parent_group == ~0u)))
+				continue;
+
+			for (size_t j = 0; j < cluster.index_count; j += 3)
+			{
+				const float* a = &vb[indices[cluster.index_offset + j + 0] * 3];
+				const float* b = &vb[indices[cluster.index_offset + j + 1] * 3];
+				const float* c = &vb[indices[cluster.index_offset + j + 2] * 3];
+
+				area += ((b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0])) * 0.5;
+			}
+		}
+
+		assert(fabs(area - double((N - 1) * (N - 1))) < 1e-3);
+	}
+
+	// limited output space results in a truncated hierarchy that is still valid
+	size_t small_clusters = meshopt_buildClusterHierarchyBound(ib.size() * 3 / 2, max_vertices, max_triangles);
+	size_t group_count3 = 0;
+	size_t cluster_count3 = meshopt_buildClusterHierarchy(&clusters2[0], small_clusters, &groups2[0], &indices2[0], ib.size() * 3 / 2, &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, max_vertices, max_triangles, group_size, &group_count3, NULL, NULL);
+
+	assert(cluster_count3 <= small_clusters && group_count3 < group_count);
+	assert(clusters2[cluster_count3 - 1].index_offset + clusters2[cluster_count3 - 1].index_count <= ib.size() * 3 / 2);
+}
+
+static void encodeMeshlet()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(0.f);
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t max_vertices = 64, max_triangles = 124;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(ib.size(), max_vertices, max_triangles);
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+
+	meshlets.resize(meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], ib.size(), &vb[0], N * N, 12, max_vertices, max_triangles, 0.f));
+
+	size_t raw_size = 0, encoded_size = 0;
+
+	for (size_t i = 0; i < meshlets.size(); ++i)
+	{
+		const meshopt_Meshlet& m = meshlets[i];
+
+		// odd meshlets have rotated triangles to exercise references that are out of order
+		if (i % 2 == 0)
+			meshopt_optimizeMeshlet(&meshlet_vertices[m.vertex_offset], &meshlet_triangles[m.triangle_offset], m.triangle_count, m.vertex_count);
+		else
+			for (size_t j = 0; j < m.triangle_count; ++j)
+			{
+				unsigned char* tri = &meshlet_triangles[m.triangle_offset + j * 3];
+				unsigned char t = tri[0];
+				tri[0] = tri[1], tri[1] = tri[2], tri[2] = t;
+			}
+
+		std::vector<unsigned char> buffer(meshopt_encodeMeshletBound(m.vertex_count, m.triangle_count));
+		buffer.resize(meshopt_encodeMeshlet(&buffer[0], buffer.size(), &meshlet_vertices[m.vertex_offset], m.vertex_count, &meshlet_triangles[m.triangle_offset], m.triangle_count));
+		assert(!buffer.empty());
+
+		raw_size += m.vertex_count * 4 + m.triangle_count * 3;
+		encoded_size += buffer.size();
+
+		std::vector<unsigned int> vertices(m.vertex_count);
+		std::vector<unsigned char> triangles(m.triangle_count * 3);
+
+		assert(meshopt_decodeMeshlet(&vertices[0], m.vertex_count, &triangles[0], m.triangle_count, &buffer[0], buffer.size()) == 0);
+		assert(memcmp(&vertices[0], &meshlet_vertices[m.vertex_offset], m.vertex_count * sizeof(unsigned int)) == 0);
+		assert(memcmp(&triangles[0], &meshlet_triangles[m.triangle_offset], m.triangle_count * 3) == 0);
+	}
+
+	assert(encoded_size < raw_size * 3 / 4);
+
+	// large and negative vertex deltas need to roundtrip as well
+	const unsigned int vertices[] = {0xffffffff, 0, 0x12345678, 0x1234, 5, 0x7fffffff, 0x80000000};
+	const unsigned char triangles[] = {0, 1, 2, 3, 4, 5, 6, 0, 3, 6, 5, 4};
+
+	unsigned char buffer[64];
+	size_t size = meshopt_encodeMeshlet(buffer, sizeof(buffer), vertices, 7, triangles, 4);
+	assert(size > 0 && size <= meshopt_encodeMeshletBound(7, 4));
+
+	unsigned int decoded_vertices[7];
+	unsigned char decoded_triangles[12];
+	assert(meshopt_decodeMeshlet(decoded_vertices, 7, decoded_triangles, 4, buffer, size) == 0);
+	assert(memcmp(decoded_vertices, vertices, sizeof(vertices)) == 0);
+	assert(memcmp(decoded_triangles, triangles, sizeof(triangles)) == 0);
+}
+
+static void encodeMeshletMemorySafe()
+{
+	unsigned int vertices[40];
+	unsigned char triangles[90];
+
+	for (int i = 0; i < 40; ++i)
+		vertices[i] = i * 1000;
+
+	for (int i = 0; i < 90; ++i)
+		triangles[i] = (unsigned char)((i * 7) % 40);
+
+	std::vector<unsigned char> buffer(meshopt_encodeMeshletBound(40, 30));
+	buffer.resize(meshopt_encodeMeshlet(&buffer[0], buffer.size(), vertices, 40, triangles, 30));
+
+	// check that encode is memory-safe; note that we reallocate the buffer for each try to make sure ASAN can verify buffer access
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(i);
+		size_t result = meshopt_encodeMeshlet(i == 0 ? NULL : &shortbuffer[0], i, vertices, 40, triangles, 30);
+
+		if (i == buffer.size())
+			assert(result == buffer.size());
+		else
+			assert(result == 0);
+	}
+
+	unsigned int decoded_vertices[40];
+	unsigned char decoded_triangles[90];
+
+	// check that decode is memory-safe
+	for (size_t i = 0; i <= buffer.size(); ++i)
+	{
+		std::vector<unsigned char> shortbuffer(buffer.begin(), buffer.begin() + i);
+		int result = meshopt_decodeMeshlet(decoded_vertices, 40, decoded_triangles, 30, i == 0 ? NULL : &shortbuffer[0], i);
+
+		if (i == buffer.size())
+			assert(result == 0);
+		else
+			assert(result < 0);
+	}
+
+	// check that decoder doesn't accept extra bytes, malformed headers or invalid versions
+	std::vector<unsigned char> brokenbuffer(buffer);
+	brokenbuffer.push_back(0);
+	assert(meshopt_decodeMeshlet(decoded_vertices, 40, decoded_triangles, 30, &brokenbuffer[0], brokenbuffer.size()) < 0);
+
+	brokenbuffer = buffer;
+	brokenbuffer[0] = 0;
+	assert(meshopt_decodeMeshlet(decoded_vertices, 40, decoded_triangles, 30, &brokenbuffer[0], brokenbuffer.size()) < 0);
+
+	brokenbuffer[0] = buffer[0] | 0x0f;
+	assert(meshopt_decodeMeshlet(decoded_vertices, 40, decoded_triangles, 30, &brokenbuffer[0], brokenbuffer.size()) < 0);
 }
 
 static size_t allocCount;
@@ -979,13 +2629,240 @@ static void customAllocator()
 	meshopt_optimizeVertexFetch(vb, ibs, 3, vb, 3, 12);
 	assert(allocCount == 6 && freeCount == 6);
 
+	// meshopt_simplifyWithContext allocates nothing once scratch memory is reserved
+	meshopt_SimplifyContext context;
+	meshopt_simplifyContextInit(&context);
+	meshopt_simplifyContextReserve(&context, meshopt_simplifyScratchSize(3, 3, 0, meshopt_SimplifySparse | meshopt_SimplifyPrune));
+	assert(allocCount == 7 && freeCount == 6);
+
+	meshopt_simplifyWithContext(&context, ib, ib, 3, vb, 3, 12, NULL, 0, NULL, 0, NULL, 3, 1.f, 0, NULL);
+	meshopt_simplifyWithContext(&context, ib, ib, 3, vb, 3, 12, NULL, 0, NULL, 0, NULL, 0, 1.f, meshopt_SimplifySparse | meshopt_SimplifyPrune, NULL);
+	assert(allocCount == 7 && freeCount == 6);
+
+	meshopt_simplifyContextDestroy(&context);
+	assert(allocCount == 7 && freeCount == 7);
+
 	meshopt_setAllocator(operator new, operator delete);
 
 	// customAlloc & customFree should not get called anymore
 	meshopt_optimizeVertexFetch(vb, ib, 3, vb, 3, 12);
-	assert(allocCount == 6 && freeCount == 6);
+	assert(allocCount == 7 && freeCount == 7);
+
+	allocCount = freeCount = 0;
+}
+
+static size_t threadAllocCount;
+static size_t threadFreeCount;
+
+static void* threadAlloc(size_t size)
+{
+	threadAllocCount++;
+
+	return malloc(size);
+}
+
+static void threadFree(void* ptr)
+{
+	threadFreeCount++;
+
+	free(ptr);
+}
+
+static void threadAllocator()
+{
+	meshopt_setAllocator(customAlloc, customFree);
+	meshopt_setThreadAllocator(threadAlloc, threadFree);
+
+	float vb[] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+	unsigned int ib[] = {0, 1, 2};
+	unsigned short ibs[] = {0, 1, 2};
+
+	// thread callbacks take precedence over global callbacks, including for index adapters in templated wrappers
+	meshopt_optimizeVertexFetch(vb, ib, 3, vb, 3, 12);
+	meshopt_optimizeVertexCache(ibs, ibs, 3, 3);
+	assert(threadAllocCount > 0 && threadAllocCount == threadFreeCount);
+	assert(allocCount == 0 && freeCount == 0);
+
+	// objects that persist across calls are released with the same callbacks
+	meshopt_TriangleAdjacency adjacency;
+	meshopt_buildTriangleAdjacency(&adjacency, ib, 3, 3, NULL, NULL);
+	assert(threadAllocCount == threadFreeCount + 2);
+
+	meshopt_destroyTriangleAdjacency(&adjacency);
+	assert(threadAllocCount == threadFreeCount);
+
+	size_t count = threadAllocCount;
+
+	// resetting thread callbacks falls back to global callbacks
+	meshopt_setThreadAllocator(NULL, NULL);
+
+	meshopt_optimizeVertexFetch(vb, ib, 3, vb, 3, 12);
+	assert(threadAllocCount == count);
+	assert(allocCount > 0 && allocCount == freeCount);
+
+	meshopt_setAllocator(operator new, operator delete);
+
+	allocCount = freeCount = 0;
+	threadAllocCount = threadFreeCount = 0;
+}
+
+struct EventStats
+{
+	int begin, end, counter, allocate;
+	int depth;
+	bool unbalanced;
+};
+
+static void countEvent(void* context, const meshopt_Event* event)
+{
+	EventStats& stats = *static_cast<EventStats*>(context);
+
+	assert(event->function || event->type == meshopt_EventAllocate);
+
+	switch (event->type)
+	{
+	case meshopt_EventBegin:
+		stats.begin++;
+		stats.depth++;
+		break;
+	case meshopt_EventEnd:
+		stats.end++;
+		stats.unbalanced |= --stats.depth < 0;
+		break;
+	case meshopt_EventCounter:
+		assert(event->name);
+		stats.counter++;
+		stats.unbalanced |= stats.depth == 0;
+		break;
+	case meshopt_EventAllocate:
+		assert(event->value > 0);
+		stats.allocate++;
+		break;
+	}
+}
+
+static void instrumentation()
+{
+	const int N = 10;
+
+	std::vector<float> vb;
+	for (int y = 0; y <= N; ++y)
+		for (int x = 0; x <= N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(float((x * y) % 3));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			unsigned int v = y * (N + 1) + x;
+			unsigned int quad[] = {v, v + 1, v + N + 1, v + N + 1, v + 1, v + N + 2};
+			ib.insert(ib.end(), quad, quad + 6);
+		}
+
+	EventStats stats = {};
+	meshopt_setEventCallback(countEvent, &stats);
+
+	std::vector<unsigned int> lod(ib.size());
+	meshopt_simplify(&lod[0], &ib[0], ib.size(), &vb[0], vb.size() / 3, 12, ib.size() / 4, 1e-2f);
+
+	std::vector<unsigned char> vbuf(meshopt_encodeVertexBufferBound(vb.size() / 3, 12));
+	meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &vb[0], vb.size() / 3, 12);
+
+	meshopt_setEventCallback(NULL, NULL);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	// every call reports nested begin/end pairs with counters in between
+	assert(stats.begin >= 2 && stats.begin == stats.end);
+	assert(stats.counter > 0 && stats.allocate > 0);
+	assert(stats.depth == 0 && !stats.unbalanced);
+#else
+	assert(stats.begin == 0 && stats.end == 0 && stats.counter == 0 && stats.allocate == 0);
+#endif
+
+	// no events are reported after the callback is reset
+	int begin = stats.begin;
+	meshopt_encodeVertexBuffer(&vbuf[0], vbuf.size(), &vb[0], vb.size() / 3, 12);
+	assert(stats.begin == begin);
+}
+
+static void scratchMemory()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(float((x * y) % 3));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			unsigned int i0 = y * N + x, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+			ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+			ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+		}
+
+	size_t index_count = ib.size(), vertex_count = N * N;
+
+	size_t scratch_size = meshopt_optimizeVertexCacheScratchSize(index_count, vertex_count);
+	scratch_size = std::max(scratch_size, meshopt_generateVertexRemapScratchSize(vertex_count));
+	scratch_size = std::max(scratch_size, meshopt_buildMeshletsScratchSize(index_count, vertex_count));
+	scratch_size = std::max(scratch_size, meshopt_simplifyScratchSize(index_count, vertex_count, 0, 0));
+
+	void* scratch = malloc(scratch_size);
+
+	// reference results use regular allocations
+	std::vector<unsigned int> cache(index_count), remap(vertex_count), simplified(index_count);
+	meshopt_optimizeVertexCache(&cache[0], &ib[0], index_count, vertex_count);
+	size_t unique = meshopt_generateVertexRemap(&remap[0], &ib[0], index_count, &vb[0], vertex_count, 12);
+	size_t simplified_count = meshopt_simplify(&simplified[0], &ib[0], index_count, &vb[0], vertex_count, 12, index_count / 4, 1e-2f, 0, NULL);
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(index_count, 64, 124);
+	std::vector<meshopt_Meshlet> meshlets(max_meshlets), meshlets2(max_meshlets);
+	std::vector<unsigned int> meshlet_vertices(max_meshlets * 64), meshlet_vertices2(max_meshlets * 64);
+	std::vector<unsigned char> meshlet_triangles(max_meshlets * 124 * 3), meshlet_triangles2(max_meshlets * 124 * 3);
+	size_t meshlet_count = meshopt_buildMeshlets(&meshlets[0], &meshlet_vertices[0], &meshlet_triangles[0], &ib[0], index_count, &vb[0], vertex_count, 12, 64, 124, 0.25f);
+
+	meshopt_setAllocator(customAlloc, customFree);
+
+	// all functions produce identical results without allocations when scratch memory is large enough
+	std::vector<unsigned int> cache2 = ib;
+	meshopt_optimizeVertexCacheWithScratch(&cache2[0], &cache2[0], index_count, vertex_count, scratch, scratch_size);
+	assert(cache == cache2);
+
+	std::vector<unsigned int> remap2(vertex_count);
+	assert(meshopt_generateVertexRemapWithScratch(&remap2[0], &ib[0], index_count, &vb[0], vertex_count, 12, scratch, scratch_size) == unique);
+	assert(remap == remap2);
+
+	std::vector<unsigned int> simplified2(index_count);
+	assert(meshopt_simplifyWithScratch(scratch, scratch_size, &simplified2[0], &ib[0], index_count, &vb[0], vertex_count, 12, NULL, 0, NULL, 0, NULL, index_count / 4, 1e-2f, 0, NULL) == simplified_count);
+	assert(simplified == simplified2);
+
+	assert(meshopt_buildMeshletsWithScratch(&meshlets2[0], &meshlet_vertices2[0], &meshlet_triangles2[0], &ib[0], index_count, &vb[0], vertex_count, 12, 64, 124, 0.25f, scratch, scratch_size) == meshlet_count);
+	assert(memcmp(&meshlets[0], &meshlets2[0], meshlet_count * sizeof(meshopt_Meshlet)) == 0);
+	assert(meshlet_vertices == meshlet_vertices2);
+
+	assert(allocCount == 0 && freeCount == 0);
+
+	// insufficient scratch memory falls back to the allocator
+	meshopt_optimizeVertexCacheWithScratch(&cache2[0], &ib[0], index_count, vertex_count, scratch, 64);
+	assert(cache == cache2);
+	assert(allocCount > 0 && allocCount == freeCount);
+
+	meshopt_setAllocator(operator new, operator delete);
 
 	allocCount = freeCount = 0;
+
+	free(scratch);
 }
 
 static void emptyMesh()
@@ -995,6 +2872,130 @@ static void emptyMesh()
 	meshopt_optimizeOverdraw(NULL, NULL, 0, NULL, 0, 12, 1.f);
 }
 
+static void analyzeOverdraw()
+{
+	// two triangles forming a quad that covers the unit square, and a smaller quad in front of it
+	const float vb[] = {
+	    0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0,
+	    0.25f, 0.25f, 0.5f, 0.75f, 0.25f, 0.5f, 0.25f, 0.75f, 0.5f, 0.75f, 0.75f, 0.5f};
+	const unsigned int ib[] = {0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7};
+
+	// side views see the quads edge-on so only the view along z has coverage
+	meshopt_OverdrawStatistics os = meshopt_analyzeOverdrawParallel(ib, 6, vb, 4, 12, 100, 3, NULL, NULL);
+	assert(os.pixels_covered == 100 * 100 && os.pixels_shaded == 100 * 100);
+
+	meshopt_OverdrawStatistics od = meshopt_analyzeOverdraw(ib, 12, vb, 8, 12);
+	assert(od.pixels_covered == 256 * 256 && od.overdraw > 1.f);
+
+	meshopt_OverdrawStatistics odp = meshopt_analyzeOverdrawParallel(ib, 12, vb, 8, 12, 256, 3, parallelForReverse, NULL);
+	assert(odp.pixels_covered == od.pixels_covered && odp.pixels_shaded == od.pixels_shaded);
+
+	// results don't depend on the task split, including for resolutions that don't divide into bands evenly
+	for (size_t views = 3; views <= 9; views += 3)
+	{
+		meshopt_OverdrawStatistics os1 = meshopt_analyzeOverdrawParallel(ib, 12, vb, 8, 12, 301, views, NULL, NULL);
+		meshopt_OverdrawStatistics os2 = meshopt_analyzeOverdrawParallel(ib, 12, vb, 8, 12, 301, views, parallelForReverse, NULL);
+
+		assert(os1.pixels_covered > 0);
+		assert(os1.pixels_covered == os2.pixels_covered && os1.pixels_shaded == os2.pixels_shaded);
+	}
+
+	os = meshopt_analyzeOverdrawParallel(ib, 0, vb, 8, 12, 64, 5, parallelForReverse, NULL);
+	assert(os.pixels_covered == 0 && os.pixels_shaded == 0 && os.overdraw == 0.f);
+
+	// the same sloped plane tessellated twice: depth of overlapping triangles is nearly equal, so depth tests are sensitive to how interpolation is set up
+	std::vector<float> pvb;
+	std::vector<unsigned int> pib;
+
+	for (int N = 17; N <= 23; N += 6)
+	{
+		unsigned int base = unsigned(pvb.size() / 3);
+
+		for (int y = 0; y <= N; ++y)
+			for (int x = 0; x <= N; ++x)
+			{
+				float px = float(x) / N, py = float(y) / N;
+				pvb.push_back(px), pvb.push_back(py), pvb.push_back(0.3f * px + 0.7f * py);
+			}
+
+		for (int y = 0; y < N; ++y)
+			for (int x = 0; x < N; ++x)
+			{
+				unsigned int i0 = base + y * (N + 1) + x, i1 = i0 + 1, i2 = i0 + N + 1, i3 = i2 + 1;
+				pib.push_back(i0), pib.push_back(i1), pib.push_back(i2);
+				pib.push_back(i2), pib.push_back(i1), pib.push_back(i3);
+			}
+	}
+
+	for (size_t resolution = 218; resolution <= 232; resolution += 14)
+	{
+		meshopt_OverdrawStatistics os1 = meshopt_analyzeOverdrawParallel(&pib[0], pib.size(), &pvb[0], pvb.size() / 3, 12, resolution, 6, NULL, NULL);
+		meshopt_OverdrawStatistics os2 = meshopt_analyzeOverdrawParallel(&pib[0], pib.size(), &pvb[0], pvb.size() / 3, 12, resolution, 6, parallelForReverse, NULL);
+
+		assert(os1.pixels_covered > 0);
+		assert(os1.pixels_covered == os2.pixels_covered && os1.pixels_shaded == os2.pixels_shaded);
+	}
+}
+
+static void analyzeMesh()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x) / N);
+			vb.push_back(float(y) / N);
+			vb.push_back(float((x * y) % 5) / N);
+		}
+
+	// shuffled triangles to make sure all cache models see misses
+	std::vector<unsigned int> ib;
+	for (int y = 0; y + 1 < N; ++y)
+		for (int x = 0; x + 1 < N; ++x)
+		{
+			int xs = (x * 17) % (N - 1), ys = (y * 7) % (N - 1);
+			unsigned int i0 = ys * N + xs, i1 = i0 + 1, i2 = i0 + N, i3 = i2 + 1;
+			ib.push_back(i0), ib.push_back(i2), ib.push_back(i1);
+			ib.push_back(i1), ib.push_back(i2), ib.push_back(i3);
+		}
+
+	// unreferenced vertex at the end doesn't affect the unique vertex count
+	vb.push_back(0), vb.push_back(0), vb.push_back(0);
+	size_t vertex_count = N * N + 1;
+
+	const unsigned int profiles[meshopt_CacheProfile_Count][3] = {{16, 0, 0}, {32, 32, 32}, {14, 64, 128}, {128, 0, 0}};
+
+	for (size_t vertex_size = 12; vertex_size <= 100; vertex_size += 44)
+	{
+		meshopt_MeshStatistics ms = meshopt_analyzeMesh(&ib[0], ib.size(), vertex_count, vertex_size, vertex_size == 12 ? &vb[0] : NULL, 12);
+
+		for (int k = 0; k < meshopt_CacheProfile_Count; ++k)
+		{
+			meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&ib[0], ib.size(), vertex_count, profiles[k][0], profiles[k][1], profiles[k][2]);
+
+			assert(ms.vertex_cache[k].vertices_transformed == vcs.vertices_transformed);
+			assert(ms.vertex_cache[k].warps_executed == vcs.warps_executed);
+			assert(ms.vertex_cache[k].acmr == vcs.acmr && ms.vertex_cache[k].atvr == vcs.atvr);
+		}
+
+		meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetch(&ib[0], ib.size(), vertex_count, vertex_size);
+		assert(ms.vertex_fetch.bytes_fetched == vfs.bytes_fetched && ms.vertex_fetch.overfetch == vfs.overfetch);
+
+		if (vertex_size == 12)
+		{
+			meshopt_OverdrawStatistics os = meshopt_analyzeOverdraw(&ib[0], ib.size(), &vb[0], vertex_count, 12);
+			assert(os.pixels_covered > 0 && ms.overdraw.pixels_covered == os.pixels_covered && ms.overdraw.pixels_shaded == os.pixels_shaded);
+		}
+		else
+			assert(ms.overdraw.pixels_covered == 0 && ms.overdraw.overdraw == 0.f);
+	}
+
+	meshopt_MeshStatistics empty = meshopt_analyzeMesh(&ib[0], 0, vertex_count, 16, NULL, 0);
+	assert(empty.vertex_cache[meshopt_CacheProfileGeneric].acmr == 0.f && empty.vertex_fetch.overfetch == 0.f);
+}
+
 static void simplify()
 {
 	// 0
@@ -1041,42 +3042,157 @@ static void simplifyStuck()
 	unsigned int ib2[] = {0, 1, 3, 3, 1, 4, 1, 2, 4}; // ok
 	unsigned int ib3[] = {0, 1, 3, 1, 3, 4, 1, 2, 4}; // flipped
 
-	assert(meshopt_simplify(ib2, ib2, 9, vb2, 5, 12, 6, 1e-3f) == 6);
-	assert(meshopt_simplify(ib3, ib3, 9, vb2, 5, 12, 6, 1e-3f) == 9);
+	assert(meshopt_simplify(ib2, ib2, 9, vb2, 5, 12, 6, 1e-3f) == 6);
+	assert(meshopt_simplify(ib3, ib3, 9, vb2, 5, 12, 6, 1e-3f) == 9);
+
+	// 4-vertex quad with a locked corner can't be simplified due to border error-induced restriction
+	float vb4[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
+	unsigned int ib4[] = {0, 1, 3, 0, 3, 2};
+
+	assert(meshopt_simplify(ib4, ib4, 6, vb4, 4, 12, 3, 1e-3f) == 6);
+
+	// 4-vertex quad with a locked corner can't be simplified due to border error-induced restriction
+	float vb5[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1, 0};
+	unsigned int ib5[] = {0, 1, 4, 0, 3, 2};
+
+	assert(meshopt_simplify(ib5, ib5, 6, vb5, 5, 12, 3, 1e-3f) == 6);
+}
+
+static void simplifySloppyStuck()
+{
+	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	const unsigned int ib[] = {0, 1, 2, 0, 1, 2};
+
+	unsigned int* target = NULL;
+
+	// simplifying down to 0 triangles results in 0 immediately
+	assert(meshopt_simplifySloppy(target, ib, 3, vb, 3, 12, 0, 0.f) == 0);
+
+	// simplifying down to 2 triangles given that all triangles are degenerate results in 0 as well
+	assert(meshopt_simplifySloppy(target, ib, 6, vb, 3, 12, 6, 0.f) == 0);
+}
+
+static void simplifyPointsStuck()
+{
+	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+	// simplifying down to 0 points results in 0 immediately
+	assert(meshopt_simplifyPoints(NULL, vb, 3, 12, NULL, 0, 0, 0) == 0);
+}
+
+static float pointCoverage(const float* vb, size_t vertex_count, const unsigned int* points, size_t point_count)
+{
+	float result = 0.f;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		float best = 1e30f;
+
+		for (size_t j = 0; j < point_count; ++j)
+		{
+			const float* v = &vb[i * 3];
+			const float* p = &vb[points[j] * 3];
+			float d = (v[0] - p[0]) * (v[0] - p[0]) + (v[1] - p[1]) * (v[1] - p[1]) + (v[2] - p[2]) * (v[2] - p[2]);
+
+			best = best < d ? best : d;
+		}
+
+		result = result < best ? best : result;
+	}
+
+	return sqrtf(result);
+}
+
+static void simplifyPointsStream()
+{
+	const size_t kSize = 80;
+	const size_t vertex_count = kSize * kSize;
+
+	// jittered grid on a curved surface with a color gradient
+	std::vector<float> vb(vertex_count * 3);
+	std::vector<float> cb(vertex_count * 3);
+
+	unsigned int seed = 42;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		float jx = float(seed >> 8) / float(1 << 24);
+		seed = seed * 1664525 + 1013904223;
+		float jy = float(seed >> 8) / float(1 << 24);
+
+		float x = (float(i % kSize) + jx) / float(kSize);
+		float y = (float(i / kSize) + jy) / float(kSize);
+
+		vb[i * 3 + 0] = x;
+		vb[i * 3 + 1] = y;
+		vb[i * 3 + 2] = x * y * 0.5f;
+
+		cb[i * 3 + 0] = x;
+		cb[i * 3 + 1] = y;
+		cb[i * 3 + 2] = 0.5f;
+	}
+
+	const float bmin[3] = {0, 0, 0};
+	const float bmax[3] = {1, 1, 1};
+
+	const size_t target = 500;
+
+	std::vector<unsigned int> expected(target);
+	size_t expected_count = meshopt_simplifyPoints(&expected[0], &vb[0], vertex_count, 12, &cb[0], 12, 1.f, target);
+
+	// two streams process interleaved batches, as if they were running on separate threads
+	meshopt_PointStream streams[2];
+	meshopt_simplifyPointsStreamInit(&streams[0], bmin, bmax, 1.f, target);
+	meshopt_simplifyPointsStreamInit(&streams[1], bmin, bmax, 1.f, target);
+
+	const size_t kBatch = 1000;
+
+	for (size_t i = 0; i < vertex_count; i += kBatch)
+	{
+		size_t count = vertex_count - i < kBatch ? vertex_count - i : kBatch;
+
+		meshopt_simplifyPointsStreamAdd(&streams[(i / kBatch) % 2], unsigned(i), &vb[i * 3], count, 12, &cb[i * 3], 12);
+	}
 
-	// 4-vertex quad with a locked corner can't be simplified due to border error-induced restriction
-	float vb4[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
-	unsigned int ib4[] = {0, 1, 3, 0, 3, 2};
+	meshopt_simplifyPointsStreamMerge(&streams[0], &streams[1]);
 
-	assert(meshopt_simplify(ib4, ib4, 6, vb4, 4, 12, 3, 1e-3f) == 6);
+	std::vector<unsigned int> points(target);
+	size_t point_count = meshopt_simplifyPointsStreamFinish(&streams[0], &points[0]);
 
-	// 4-vertex quad with a locked corner can't be simplified due to border error-induced restriction
-	float vb5[] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1, 1, 0};
-	unsigned int ib5[] = {0, 1, 4, 0, 3, 2};
+	assert(point_count <= target && point_count >= target / 2);
 
-	assert(meshopt_simplify(ib5, ib5, 6, vb5, 5, 12, 3, 1e-3f) == 6);
-}
+	std::vector<unsigned char> used(vertex_count);
 
-static void simplifySloppyStuck()
-{
-	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
-	const unsigned int ib[] = {0, 1, 2, 0, 1, 2};
+	for (size_t i = 0; i < point_count; ++i)
+	{
+		assert(points[i] < vertex_count);
+		assert(!used[points[i]]);
+		used[points[i]] = 1;
+	}
 
-	unsigned int* target = NULL;
+	// streaming result should cover the cloud about as well as the regular simplifier
+	float expected_coverage = pointCoverage(&vb[0], vertex_count, &expected[0], expected_count);
+	float coverage = pointCoverage(&vb[0], vertex_count, &points[0], point_count);
 
-	// simplifying down to 0 triangles results in 0 immediately
-	assert(meshopt_simplifySloppy(target, ib, 3, vb, 3, 12, 0, 0.f) == 0);
+	assert(coverage < expected_coverage * 1.25f);
 
-	// simplifying down to 2 triangles given that all triangles are degenerate results in 0 as well
-	assert(meshopt_simplifySloppy(target, ib, 6, vb, 3, 12, 6, 0.f) == 0);
-}
+	// finishing the stream is repeatable, and small streams keep all points
+	std::vector<unsigned int> points2(target);
+	assert(meshopt_simplifyPointsStreamFinish(&streams[0], &points2[0]) == point_count);
+	assert(points == points2);
 
-static void simplifyPointsStuck()
-{
-	const float vb[] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+	meshopt_simplifyPointsStreamDestroy(&streams[1]);
+	meshopt_simplifyPointsStreamInit(&streams[1], bmin, bmax, 1.f, target);
+	meshopt_simplifyPointsStreamAdd(&streams[1], 100, &vb[0], 10, 12, NULL, 0);
 
-	// simplifying down to 0 points results in 0 immediately
-	assert(meshopt_simplifyPoints(NULL, vb, 3, 12, NULL, 0, 0, 0) == 0);
+	assert(meshopt_simplifyPointsStreamFinish(&streams[1], &points[0]) == 10);
+
+	for (size_t i = 0; i < 10; ++i)
+		assert(points[i] == 100 + i);
+
+	meshopt_simplifyPointsStreamDestroy(&streams[0]);
+	meshopt_simplifyPointsStreamDestroy(&streams[1]);
 }
 
 static void simplifyFlip()
@@ -1741,6 +3857,532 @@ static void simplifyPruneCleanup()
 	assert(memcmp(ib, expected, sizeof(expected)) == 0);
 }
 
+static void simplifyLods()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.5f) * cosf(y * 0.4f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	const size_t lod_count = 3;
+	size_t target_index_counts[lod_count] = {ib.size() / 2 / 3 * 3, ib.size() / 4 / 3 * 3, ib.size() / 8 / 3 * 3};
+	float target_errors[lod_count] = {1e-2f, 1e-1f, 1.f};
+
+	std::vector<unsigned int> lods(ib.size() * lod_count);
+	size_t lod_index_counts[lod_count];
+	float lod_errors[lod_count];
+
+	size_t total = meshopt_simplifyLods(&lods[0], lod_index_counts, lod_errors, &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, NULL, target_index_counts, target_errors, lod_count, 0);
+	assert(total == lod_index_counts[0] + lod_index_counts[1] + lod_index_counts[2]);
+
+	// first level matches a regular simplification call
+	std::vector<unsigned int> lod0(ib.size());
+	float error0 = 0.f;
+	lod0.resize(meshopt_simplify(&lod0[0], &ib[0], ib.size(), &vb[0], N * N, 12, target_index_counts[0], target_errors[0], 0, &error0));
+
+	assert(lod_index_counts[0] == lod0.size());
+	assert(lod_errors[0] == error0);
+	assert(memcmp(&lods[0], &lod0[0], lod0.size() * sizeof(unsigned int)) == 0);
+
+	// subsequent levels are progressively coarser
+	for (size_t i = 1; i < lod_count; ++i)
+	{
+		assert(lod_index_counts[i] < lod_index_counts[i - 1]);
+		assert(lod_index_counts[i] >= target_index_counts[i]);
+		assert(lod_errors[i] >= lod_errors[i - 1]);
+	}
+
+	for (size_t i = 0; i < total; ++i)
+		assert(lods[i] < N * N);
+}
+
+static void simplifyContext()
+{
+	const int N = 20;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.5f) * cosf(y * 0.4f));
+			vb.push_back(float(x) / N);
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	float attr_weight = 0.5f;
+	unsigned int options[] = {0, meshopt_SimplifySparse, meshopt_SimplifyLockBorder | meshopt_SimplifyPrune};
+
+	meshopt_SimplifyContext context;
+	meshopt_simplifyContextInit(&context);
+
+	for (size_t i = 0; i < sizeof(options) / sizeof(options[0]); ++i)
+		for (size_t attr = 0; attr < 2; ++attr)
+		{
+			std::vector<unsigned int> expected(ib.size()), result(ib.size());
+			float expected_error = 0.f, result_error = 0.f;
+
+			expected.resize(meshopt_simplifyWithAttributes(&expected[0], &ib[0], ib.size(), &vb[0], N * N, 16, &vb[3], 16, &attr_weight, attr, NULL, ib.size() / 4, 1e-1f, options[i], &expected_error));
+			result.resize(meshopt_simplifyWithContext(&context, &result[0], &ib[0], ib.size(), &vb[0], N * N, 16, &vb[3], 16, &attr_weight, attr, NULL, ib.size() / 4, 1e-1f, options[i], &result_error));
+
+			assert(result == expected);
+			assert(result_error == expected_error);
+
+			// context memory is grown to the worst case size for the mesh
+			assert(context.scratch_size >= meshopt_simplifyScratchSize(ib.size(), N * N, attr, options[i]));
+		}
+
+	meshopt_simplifyContextDestroy(&context);
+	assert(context.scratch == NULL && context.scratch_size == 0);
+}
+
+static void simplifyTiled()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	size_t target = ib.size() / 10 / 3 * 3;
+
+	std::vector<unsigned int> serial(ib.size()), parallel(ib.size());
+	float serial_error = 0.f, parallel_error = 0.f;
+
+	size_t serial_count = meshopt_simplifyTiled(&serial[0], &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, NULL, target, 1e-2f, 0, 256, &serial_error, NULL, NULL);
+	size_t parallel_count = meshopt_simplifyTiled(&parallel[0], &ib[0], ib.size(), &vb[0], N * N, 12, NULL, 0, NULL, 0, NULL, target, 1e-2f, 0, 256, &parallel_error, parallelForReverse, NULL);
+
+	assert(serial_count <= target * 2 && serial_error <= 1e-2f);
+
+	// tiles are independent so the result doesn't depend on execution order
+	assert(serial_count == parallel_count && serial_error == parallel_error);
+	assert(memcmp(&serial[0], &parallel[0], serial_count * sizeof(unsigned int)) == 0);
+
+	// borders between tiles must stay connected: every edge that doesn't have an opposite edge must be on the grid boundary
+	for (size_t i = 0; i < serial_count; i += 3)
+		for (int e = 0; e < 3; ++e)
+		{
+			unsigned int a = serial[i + e], b = serial[i + (e + 1) % 3];
+
+			bool found = false;
+			for (size_t j = 0; j < serial_count && !found; j += 3)
+				for (int f = 0; f < 3; ++f)
+					found |= serial[j + f] == b && serial[j + (f + 1) % 3] == a;
+
+			int ax = int(a % N), ay = int(a / N), bx = int(b % N), by = int(b / N);
+			assert(found || (ax == bx && (ax == 0 || ax == N - 1)) || (ay == by && (ay == 0 || ay == N - 1)));
+		}
+}
+
+static void simplifyCompact()
+{
+	const int N = 40;
+
+	// grid with a seam in the middle to exercise wedges and edge loops
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N + 1; ++x)
+		{
+			int px = x <= N / 2 ? x : x - 1;
+
+			vb.push_back(float(px));
+			vb.push_back(float(y));
+			vb.push_back(sinf(px * 0.3f) * cosf(y * 0.2f));
+			vb.push_back(x <= N / 2 ? 0.f : 1.f);
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			int vx = x < N / 2 ? x : x + 1;
+			unsigned int v00 = y * (N + 1) + vx, v10 = v00 + 1, v01 = v00 + N + 1, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	size_t vertex_count = N * (N + 1);
+
+	// unreferenced vertices inside the mesh bounds don't affect the result, but force the simplifier to use 32-bit internal indices
+	std::vector<float> vbl = vb;
+	for (size_t i = 0; i < 70000; ++i)
+	{
+		vbl.push_back(0.5f + float(i % 1000) * 0.01f);
+		vbl.push_back(0.5f + float(i / 1000) * 0.01f);
+		vbl.push_back(0.f);
+		vbl.push_back(0.f);
+	}
+
+	size_t target = ib.size() / 10 / 3 * 3;
+	const float attr_weight = 0.5f;
+
+	const unsigned int options[] = {0, meshopt_SimplifyLockBorder, meshopt_SimplifyPriorityQueue};
+
+	for (size_t k = 0; k < sizeof(options) / sizeof(options[0]); ++k)
+	{
+		std::vector<unsigned int> compact(ib.size()), wide(ib.size());
+		float compact_error = 0.f, wide_error = 0.f;
+
+		size_t compact_count = meshopt_simplifyWithAttributes(&compact[0], &ib[0], ib.size(), &vb[0], vertex_count, 16, &vb[3], 16, &attr_weight, 1, NULL, target, 1e-2f, options[k], &compact_error);
+		size_t wide_count = meshopt_simplifyWithAttributes(&wide[0], &ib[0], ib.size(), &vbl[0], vbl.size() / 4, 16, &vbl[3], 16, &attr_weight, 1, NULL, target, 1e-2f, options[k], &wide_error);
+
+		assert(compact_count < ib.size());
+		assert(compact_count == wide_count && compact_error == wide_error);
+		assert(memcmp(&compact[0], &wide[0], compact_count * sizeof(unsigned int)) == 0);
+
+		// sparse simplification of a large vertex buffer uses 16-bit internal indices as well
+		size_t sparse_count = meshopt_simplifyWithAttributes(&wide[0], &ib[0], ib.size(), &vbl[0], vbl.size() / 4, 16, &vbl[3], 16, &attr_weight, 1, NULL, target, 1e-2f, options[k] | meshopt_SimplifySparse, &wide_error);
+
+		assert(sparse_count == compact_count);
+		assert(memcmp(&compact[0], &wide[0], compact_count * sizeof(unsigned int)) == 0);
+	}
+}
+
+static double gStatsClock = 0;
+
+static double statsTimer()
+{
+	// deterministic clock that advances by one unit on each call
+	return gStatsClock += 1;
+}
+
+static void simplifyStats()
+{
+	const int N = 40;
+
+	std::vector<float> vb;
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			vb.push_back(float(x));
+			vb.push_back(float(y));
+			vb.push_back(sinf(x * 0.3f) * cosf(y * 0.2f));
+		}
+
+	std::vector<unsigned int> ib;
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	// small detached triangle that can be pruned
+	vb.push_back(10), vb.push_back(10), vb.push_back(0.5f);
+	vb.push_back(10.01f), vb.push_back(10), vb.push_back(0.5f);
+	vb.push_back(10), vb.push_back(10.01f), vb.push_back(0.5f);
+	ib.push_back(N * N), ib.push_back(N * N + 1), ib.push_back(N * N + 2);
+
+	size_t vertex_count = vb.size() / 3;
+	size_t target = ib.size() / 10 / 3 * 3;
+
+	const unsigned int options[] = {0, meshopt_SimplifyPrune, meshopt_SimplifyPriorityQueue, meshopt_SimplifyPriorityQueue | meshopt_SimplifyPrune};
+
+	for (size_t k = 0; k < sizeof(options) / sizeof(options[0]); ++k)
+	{
+		std::vector<unsigned int> expected(ib.size()), result(ib.size());
+		float expected_error = 0.f, error = 0.f;
+
+		size_t expected_count = meshopt_simplify(&expected[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, target, 1e-2f, options[k], &expected_error);
+
+		meshopt_SimplifyStats stats = {};
+		stats.timer = statsTimer;
+		stats.passes = 42; // overwritten
+
+		gStatsClock = 0;
+		size_t count = meshopt_simplifyWithStats(&stats, &result[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, NULL, 0, NULL, 0, NULL, target, 1e-2f, options[k], &error);
+
+		// statistics don't affect the result
+		assert(count == expected_count && error == expected_error);
+		assert(memcmp(&result[0], &expected[0], count * sizeof(unsigned int)) == 0);
+
+		assert(stats.timer == statsTimer);
+		assert(stats.passes > 0 && stats.passes < 42);
+		assert(stats.candidates >= stats.collapses + stats.rejected_flip);
+		assert(stats.collapses > 0 && stats.collapses * 2 + stats.pruned_triangles >= (ib.size() - count) / 3);
+
+		// with meshopt_SimplifyPrune, the detached triangle is pruned as a separate component, unless it was collapsed before that
+		assert((options[k] & meshopt_SimplifyPrune) ? stats.pruned_components == 1 && stats.pruned_triangles <= 1 : stats.pruned_components == 0);
+
+		// every timer call after the first one contributes to exactly one phase
+		double total = stats.time_adjacency + stats.time_quadrics + stats.time_rank + stats.time_sort + stats.time_collapse;
+		assert(stats.time_adjacency > 0 && stats.time_quadrics > 0 && stats.time_rank > 0 && stats.time_sort > 0 && stats.time_collapse > 0);
+		assert(total <= gStatsClock);
+	}
+
+	// simplification that stops at the error limit reports candidates above the limit
+	std::vector<unsigned int> result(ib.size());
+
+	meshopt_SimplifyStats stats = {};
+	size_t count = meshopt_simplifyWithStats(&stats, &result[0], &ib[0], ib.size(), &vb[0], vertex_count, 12, NULL, 0, NULL, 0, NULL, 0, 1e-3f, 0, NULL);
+
+	assert(count > 0);
+	assert(stats.candidates_over_error > 0);
+
+	// without a timer, phase times are not measured
+	assert(stats.timer == NULL && stats.time_rank == 0);
+}
+
+static void simplifyPriorityQueue()
+{
+	const int N = 40;
+
+	// grid with a wavy surface and a UV seam along x = N/2
+	std::vector<float> vb;
+	std::vector<unsigned int> grid(N * N);
+
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			float px = float(x), py = float(y), pz = sinf(x * 0.3f) * cosf(y * 0.2f);
+
+			grid[y * N + x] = unsigned(vb.size() / 5);
+			vb.push_back(px), vb.push_back(py), vb.push_back(pz);
+			vb.push_back(px / N), vb.push_back(py / N);
+		}
+
+	std::vector<unsigned int> seam(N);
+
+	for (int y = 0; y < N; ++y)
+	{
+		seam[y] = unsigned(vb.size() / 5);
+		vb.push_back(float(N / 2)), vb.push_back(float(y)), vb.push_back(vb[grid[y * N + N / 2] * 5 + 2]);
+		vb.push_back(1.f), vb.push_back(float(y) / N);
+	}
+
+	std::vector<unsigned int> ib;
+
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = (x == N / 2) ? seam[y] : grid[y * N + x];
+			unsigned int v01 = (x == N / 2) ? seam[y + 1] : grid[(y + 1) * N + x];
+			unsigned int v10 = grid[y * N + x + 1];
+			unsigned int v11 = grid[(y + 1) * N + x + 1];
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	size_t vertex_count = vb.size() / 5;
+	float attr_weights[2] = {0.5f, 0.5f};
+
+	for (int attr = 0; attr < 2; ++attr)
+		for (int lock = 0; lock < 2; ++lock)
+		{
+			size_t attribute_count = attr ? 2 : 0;
+			unsigned int options = meshopt_SimplifyPriorityQueue | (lock ? meshopt_SimplifyLockBorder : 0);
+
+			std::vector<unsigned int> result(ib.size());
+			float error = 0.f;
+
+			size_t target = ib.size() / 10 / 3 * 3;
+			size_t count = meshopt_simplifyWithAttributes(&result[0], &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, target, 1e-1f, options, &error);
+
+			assert(count > 0 && count <= (lock ? ib.size() / 2 : target));
+			assert(error > 0.f && error <= 1e-1f);
+
+			for (size_t i = 0; i < count; ++i)
+				assert(result[i] < vertex_count);
+		}
+
+	// levels continue from each other, so each level must be smaller than the previous one
+	size_t targets[3] = {ib.size() / 2 / 3 * 3, ib.size() / 8 / 3 * 3, ib.size() / 32 / 3 * 3};
+	float errors[3] = {1.f, 1.f, 1.f};
+
+	std::vector<unsigned int> lods(ib.size() * 3);
+	size_t lod_counts[3];
+	float lod_errors[3];
+
+	meshopt_simplifyLods(&lods[0], lod_counts, lod_errors, &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), NULL, 0, NULL, 0, NULL, targets, errors, 3, meshopt_SimplifyPriorityQueue);
+
+	for (int i = 0; i < 3; ++i)
+	{
+		assert(lod_counts[i] <= targets[i]);
+		assert(i == 0 || (lod_counts[i] < lod_counts[i - 1] && lod_errors[i] >= lod_errors[i - 1]));
+	}
+}
+
+static void parallelForForward(void* context, void (*task)(void*, size_t), void* task_context, size_t count)
+{
+	assert(context == NULL);
+
+	for (size_t i = 0; i < count; ++i)
+		task(task_context, i);
+}
+
+static void simplifyParallel()
+{
+	const int N = 80;
+
+	// grid with a wavy surface and a UV seam along x = N/2
+	std::vector<float> vb;
+	std::vector<unsigned int> grid(N * N);
+
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			float px = float(x), py = float(y), pz = sinf(x * 0.3f) * cosf(y * 0.2f);
+
+			grid[y * N + x] = unsigned(vb.size() / 5);
+			vb.push_back(px), vb.push_back(py), vb.push_back(pz);
+			vb.push_back(px / N), vb.push_back(py / N);
+		}
+
+	std::vector<unsigned int> seam(N);
+
+	for (int y = 0; y < N; ++y)
+	{
+		seam[y] = unsigned(vb.size() / 5);
+		vb.push_back(float(N / 2)), vb.push_back(float(y)), vb.push_back(vb[grid[y * N + N / 2] * 5 + 2]);
+		vb.push_back(1.f), vb.push_back(float(y) / N);
+	}
+
+	std::vector<unsigned int> ib;
+
+	for (int y = 0; y < N - 1; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = (x == N / 2) ? seam[y] : grid[y * N + x];
+			unsigned int v01 = (x == N / 2) ? seam[y + 1] : grid[(y + 1) * N + x];
+			unsigned int v10 = grid[y * N + x + 1];
+			unsigned int v11 = grid[(y + 1) * N + x + 1];
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	size_t vertex_count = vb.size() / 5;
+	float attr_weights[2] = {0.5f, 0.5f};
+
+	for (int attr = 0; attr < 2; ++attr)
+	{
+		size_t attribute_count = attr ? 2 : 0;
+
+		std::vector<unsigned int> forward(ib.size()), reverse(ib.size());
+		float forward_error = 0.f, reverse_error = 0.f;
+
+		size_t forward_count = meshopt_simplifyParallel(&forward[0], &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, ib.size() / 10, 1e-1f, 0, &forward_error, parallelForForward, NULL);
+		size_t reverse_count = meshopt_simplifyParallel(&reverse[0], &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, ib.size() / 10, 1e-1f, 0, &reverse_error, parallelForReverse, NULL);
+
+		// results must not depend on task execution order
+		assert(forward_count > 0 && forward_count < ib.size());
+		assert(forward_count == reverse_count);
+		assert(forward_error == reverse_error);
+		assert(memcmp(&forward[0], &reverse[0], forward_count * sizeof(unsigned int)) == 0);
+	}
+}
+
+static void simplifyOptionCombinations()
+{
+	const int N = 30;
+
+	// wavy grid; only the bottom half is simplified, which makes meshopt_SimplifySparse take its sparse path
+	std::vector<float> vb;
+
+	for (int y = 0; y < N; ++y)
+		for (int x = 0; x < N; ++x)
+		{
+			float px = float(x), py = float(y), pz = sinf(x * 0.3f) * cosf(y * 0.2f);
+
+			vb.push_back(px), vb.push_back(py), vb.push_back(pz);
+			vb.push_back(px / N), vb.push_back(py / N);
+		}
+
+	std::vector<unsigned int> ib;
+
+	for (int y = 0; y < N / 2; ++y)
+		for (int x = 0; x < N - 1; ++x)
+		{
+			unsigned int v00 = y * N + x, v10 = v00 + 1, v01 = v00 + N, v11 = v01 + 1;
+
+			ib.push_back(v00), ib.push_back(v10), ib.push_back(v01);
+			ib.push_back(v01), ib.push_back(v10), ib.push_back(v11);
+		}
+
+	size_t vertex_count = vb.size() / 5;
+	float attr_weights[2] = {0.5f, 0.5f};
+
+	size_t targets[2] = {ib.size() / 4 / 3 * 3, ib.size() / 16 / 3 * 3};
+	float errors[2] = {1e-1f, 1e-1f};
+
+	// every combination of options must be valid for all entry points
+	for (unsigned int options = 0; options < 32; ++options)
+		for (int attr = 0; attr < 2; ++attr)
+		{
+			size_t attribute_count = attr ? 2 : 0;
+
+			std::vector<unsigned int> result(ib.size());
+			float error = 0.f;
+
+			size_t count = meshopt_simplifyWithAttributes(&result[0], &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, targets[0], 1e-1f, options, &error);
+			assert(count <= ib.size());
+
+			for (size_t i = 0; i < count; ++i)
+				assert(result[i] < vertex_count);
+
+			count = meshopt_simplifyParallel(&result[0], &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, targets[0], 1e-1f, options, &error, parallelForForward, NULL);
+			assert(count <= ib.size());
+
+			for (size_t i = 0; i < count; ++i)
+				assert(result[i] < vertex_count);
+
+			std::vector<unsigned int> lods(ib.size() * 2);
+			size_t lod_counts[2];
+			float lod_errors[2];
+
+			size_t total = meshopt_simplifyLods(&lods[0], lod_counts, lod_errors, &ib[0], ib.size(), &vb[0], vertex_count, 5 * sizeof(float), &vb[3], 5 * sizeof(float), attr_weights, attribute_count, NULL, targets, errors, 2, options);
+			assert(total == lod_counts[0] + lod_counts[1]);
+
+			for (size_t i = 0; i < total; ++i)
+				assert(lods[i] < vertex_count);
+		}
+}
+
 static void adjacency()
 {
 	// 0 1/4
@@ -1855,6 +4497,126 @@ static void quantizeFloat()
 	assert(nanf != nanf);
 }
 
+static void quantizeArrays()
+{
+	volatile float zero = 0.f; // avoids div-by-zero warnings
+
+	// special values and a spread of regular values, including out of range inputs, ties and denormals
+	std::vector<float> values;
+	values.push_back(0.f);
+	values.push_back(-0.f);
+	values.push_back(1.f / zero);
+	values.push_back(-1.f / zero);
+	values.push_back(zero / zero);
+	values.push_back(0.5f / 255.f);
+	values.push_back(1e-40f);
+	values.push_back(65519.f);
+	values.push_back(65520.f);
+
+	for (unsigned int i = 0; i < 20000; ++i)
+	{
+		unsigned int ui = i * 214013u + 2531011u;
+		ui ^= ui << 13;
+		ui ^= ui >> 17;
+
+		float f;
+		memcpy(&f, &ui, 4);
+		values.push_back(f);
+		values.push_back(float(int(ui % 4001) - 2000) / 1000.f);
+	}
+
+	// 3-component vectors with 16-byte stride exercise gathering, and packed vectors exercise the direct path
+	const size_t components = 3;
+	size_t count = values.size() / 4;
+
+	std::vector<float> data(count * 4);
+	for (size_t i = 0; i < count; ++i)
+		for (size_t k = 0; k < 4; ++k)
+			data[i * 4 + k] = values[i * 4 + k];
+
+	for (int strided = 0; strided < 2; ++strided)
+	{
+		size_t stride = strided ? 16 : 12;
+		size_t vectors = strided ? count : (count * 4) / components;
+
+		std::vector<float> packed(vectors * components);
+		for (size_t i = 0; i < vectors; ++i)
+			for (size_t k = 0; k < components; ++k)
+				packed[i * components + k] = data[strided ? i * 4 + k : i * components + k];
+
+		size_t total = vectors * components;
+
+		for (int N = 1; N <= 16; ++N)
+		{
+			std::vector<unsigned short> u16(total);
+			meshopt_quantizeUnormArray(&u16[0], &data[0], vectors, components, stride, N);
+
+			for (size_t i = 0; i < total; ++i)
+				assert(u16[i] == (unsigned short)meshopt_quantizeUnorm(packed[i], N));
+
+			if (N >= 2)
+			{
+				std::vector<short> s16(total);
+				meshopt_quantizeSnormArray(&s16[0], &data[0], vectors, components, stride, N);
+
+				for (size_t i = 0; i < total; ++i)
+					assert(s16[i] == (short)meshopt_quantizeSnorm(packed[i], N));
+			}
+
+			if (N <= 8)
+			{
+				std::vector<unsigned char> u8(total);
+				meshopt_quantizeUnormArray(&u8[0], &data[0], vectors, components, stride, N);
+
+				for (size_t i = 0; i < total; ++i)
+					assert(u8[i] == (unsigned char)meshopt_quantizeUnorm(packed[i], N));
+			}
+
+			if (N >= 2 && N <= 8)
+			{
+				std::vector<signed char> s8(total);
+				meshopt_quantizeSnormArray(&s8[0], &data[0], vectors, components, stride, N);
+
+				for (size_t i = 0; i < total; ++i)
+					assert(s8[i] == (signed char)meshopt_quantizeSnorm(packed[i], N));
+			}
+		}
+
+		for (int N = 0; N <= 23; ++N)
+		{
+			std::vector<float> f32(total);
+			meshopt_quantizeFloatArray(&f32[0], &data[0], vectors, components, stride, N);
+
+			for (size_t i = 0; i < total; ++i)
+			{
+				float r = meshopt_quantizeFloat(packed[i], N);
+				assert(memcmp(&f32[i], &r, 4) == 0);
+			}
+		}
+
+		std::vector<unsigned short> f16(total);
+		meshopt_quantizeHalfArray(&f16[0], &data[0], vectors, components, stride);
+
+		for (size_t i = 0; i < total; ++i)
+			assert(f16[i] == meshopt_quantizeHalf(packed[i]));
+	}
+
+	// dequantization is checked for all half values, using 3-component vectors with 8-byte stride
+	std::vector<unsigned short> halfs(65536 / 4 * 4);
+	for (size_t i = 0; i < halfs.size(); ++i)
+		halfs[i] = (unsigned short)i;
+
+	std::vector<float> dequantized(65536 / 4 * 3);
+	meshopt_dequantizeHalfArray(&dequantized[0], &halfs[0], 65536 / 4, 3, 8);
+
+	for (size_t i = 0; i < 65536 / 4; ++i)
+		for (size_t k = 0; k < 3; ++k)
+		{
+			float r = meshopt_dequantizeHalf(halfs[i * 4 + k]);
+			assert(memcmp(&dequantized[i * 3 + k], &r, 4) == 0);
+		}
+}
+
 static void quantizeHalf()
 {
 	volatile float zero = 0.f; // avoids div-by-zero warnings
@@ -1944,7 +4706,11 @@ void runTests()
 	decodeIndexRejectInvalidVersion();
 	decodeIndexMalformedVByte();
 	roundtripIndexTricky();
+	roundtripIndexLarge();
 	encodeIndexEmpty();
+	decodeIndexChunked();
+	decodeIndexChunkedMemorySafe();
+	encodeContext();
 
 	decodeIndexSequence();
 	decodeIndexSequence16();
@@ -1954,8 +4720,11 @@ void runTests()
 	decodeIndexSequenceRejectMalformedHeaders();
 	decodeIndexSequenceRejectInvalidVersion();
 	encodeIndexSequenceEmpty();
+	decodeIndexStream();
+	decodeIndexStreamMemorySafe();
 
 	decodeVertexV0();
+	encodeVertexV0();
 	encodeVertexMemorySafe();
 	decodeVertexMemorySafe();
 	decodeVertexRejectExtraBytes();
@@ -1963,7 +4732,12 @@ void runTests()
 	decodeVertexBitGroups();
 	decodeVertexBitGroupSentinels();
 	decodeVertexLarge();
+	decodeVertexPartialGroups();
 	encodeVertexEmpty();
+	decodeVertexChunked();
+	decodeVertexChunkedMemorySafe();
+	decodeVertexStream();
+	decodeVertexStreamMemorySafe();
 
 	decodeFilterOct8();
 	decodeFilterOct12();
@@ -1977,12 +4751,34 @@ void runTests()
 	encodeFilterExpZero();
 	encodeFilterExpAlias();
 	encodeFilterExpClamp();
+	decodeVertexFiltered();
+	decodeVertexStrided();
+	decodeBatch();
 
 	clusterBoundsDegenerate();
+	meshletsParallel();
+	meshletBoundsBatch();
+	meshletBVH();
+	spatialSortParallel();
+	optimizeVertexCacheParallel();
+	optimizeVertexCacheWithScores();
+	triangleAdjacency();
+	optimizeOverdrawParallel();
+	optimizeMesh();
+	generateVertexRemapParallel();
+	generateVertexRemapSizes();
+	clusterHierarchy();
+	encodeMeshlet();
+	encodeMeshletMemorySafe();
 
 	customAllocator();
+	threadAllocator();
+	instrumentation();
+	scratchMemory();
 
 	emptyMesh();
+	analyzeOverdraw();
+	analyzeMesh();
 
 	simplify();
 	simplifyStuck();
@@ -2004,12 +4800,22 @@ void runTests()
 	simplifyDebug();
 	simplifyPrune();
 	simplifyPruneCleanup();
+	simplifyParallel();
+	simplifyLods();
+	simplifyContext();
+	simplifyTiled();
+	simplifyPriorityQueue();
+	simplifyOptionCombinations();
+	simplifyPointsStream();
+	simplifyCompact();
+	simplifyStats();
 
 	adjacency();
 	tessellation();
 	provoking();
 
 	quantizeFloat();
+	quantizeArrays();
 	quantizeHalf();
 	dequantizeHalf();
 }
@@ -137,6 +137,8 @@ static void resampleKeyframes(std::vector<Attr>& data, const std::vector<float>&
 {
 	size_t cursor = 0;
 
+	data.reserve(frames * components);
+
 	for (int i = 0; i < frames; ++i)
 	{
 		float time = mint + float(i) / freq;
@@ -160,72 +162,204 @@ static void resampleKeyframes(std::vector<Attr>& data, const std::vector<float>&
 			float inv_range = (range == 0.f) ? 0.f : 1.f / (next_time - cursor_time);
 			float t = std::max(0.f, std::min(1.f, (time - cursor_time) * inv_range));
 
-			for (size_t j = 0; j < components; ++j)
+			// interpolation type is uniform across the track, so we dispatch once per keyframe to keep the component loops tight
+			switch (interpolation)
 			{
-				switch (interpolation)
-				{
-				case cgltf_interpolation_type_linear:
-				{
-					const Attr& v0 = output[(cursor + 0) * components + j];
-					const Attr& v1 = output[(cursor + 1) * components + j];
-					data.push_back(interpolateLinear(v0, v1, t, type));
-				}
-				break;
+			case cgltf_interpolation_type_linear:
+			{
+				const Attr* v0 = &output[(cursor + 0) * components];
+				const Attr* v1 = &output[(cursor + 1) * components];
 
-				case cgltf_interpolation_type_step:
-				{
-					const Attr& v = output[cursor * components + j];
-					data.push_back(v);
-				}
-				break;
+				for (size_t j = 0; j < components; ++j)
+					data.push_back(interpolateLinear(v0[j], v1[j], t, type));
+			}
+			break;
 
-				case cgltf_interpolation_type_cubic_spline:
-				{
-					const Attr& v0 = output[(cursor * 3 + 1) * components + j];
-					const Attr& b0 = output[(cursor * 3 + 2) * components + j];
-					const Attr& a1 = output[(cursor * 3 + 3) * components + j];
-					const Attr& v1 = output[(cursor * 3 + 4) * components + j];
-					data.push_back(interpolateHermite(v0, b0, v1, a1, t, range, type));
-				}
-				break;
+			case cgltf_interpolation_type_step:
+			{
+				const Attr* v = &output[cursor * components];
+
+				data.insert(data.end(), v, v + components);
+			}
+			break;
+
+			case cgltf_interpolation_type_cubic_spline:
+			{
+				const Attr* v0 = &output[(cursor * 3 + 1) * components];
+				const Attr* b0 = &output[(cursor * 3 + 2) * components];
+				const Attr* a1 = &output[(cursor * 3 + 3) * components];
+				const Attr* v1 = &output[(cursor * 3 + 4) * components];
+
+				for (size_t j = 0; j < components; ++j)
+					data.push_back(interpolateHermite(v0[j], b0[j], v1[j], a1[j], t, range, type));
+			}
+			break;
 
-				default:
-					assert(!"Unknown interpolation type");
-				}
+			default:
+				assert(!"Unknown interpolation type");
 			}
 		}
 		else
 		{
 			size_t offset = (interpolation == cgltf_interpolation_type_cubic_spline) ? cursor * 3 + 1 : cursor;
 
-			for (size_t j = 0; j < components; ++j)
-			{
-				const Attr& v = output[offset * components + j];
-				data.push_back(v);
-			}
+			const Attr* v = &output[offset * components];
+
+			data.insert(data.end(), v, v + components);
 		}
 	}
 }
 
 static float getMaxDelta(const std::vector<Attr>& data, cgltf_animation_path_type type, int frames, const Attr* value, size_t components)
 {
-	assert(data.size() == frames * components);
+	assert(data.size() >= frames * components);
+
+	const Attr* keys = &data[0];
 
 	float result = 0;
 
-	for (int i = 0; i < frames; ++i)
+	// this is equivalent to computing getDelta for every keyframe, but the path dispatch is hoisted out of the loops so that they can be vectorized
+	switch (type)
 	{
-		for (size_t j = 0; j < components; ++j)
+	case cgltf_animation_path_type_translation:
+		for (int i = 0; i < frames; ++i)
 		{
-			float delta = getDelta(value[j], data[i * components + j], type);
+			const Attr& l = value[0];
+			const Attr& r = keys[i];
+
+			float delta = std::max(std::max(fabsf(l.f[0] - r.f[0]), fabsf(l.f[1] - r.f[1])), fabsf(l.f[2] - r.f[2]));
 
 			result = (result < delta) ? delta : result;
 		}
+		break;
+
+	case cgltf_animation_path_type_rotation:
+	{
+		// acosf is monotonic, so the largest angle corresponds to the smallest dot product and we only need to compute it once
+		float mindot = 1.f;
+
+		for (int i = 0; i < frames; ++i)
+		{
+			const Attr& l = value[0];
+			const Attr& r = keys[i];
+
+			float dot = fabsf(l.f[0] * r.f[0] + l.f[1] * r.f[1] + l.f[2] * r.f[2] + l.f[3] * r.f[3]);
+
+			mindot = (dot < mindot) ? dot : mindot;
+		}
+
+		result = 2 * acosf(mindot);
+	}
+	break;
+
+	case cgltf_animation_path_type_scale:
+		for (int i = 0; i < frames; ++i)
+		{
+			const Attr& l = value[0];
+			const Attr& r = keys[i];
+
+			float delta = std::max(std::max(fabsf(l.f[0] / r.f[0] - 1), fabsf(l.f[1] / r.f[1] - 1)), fabsf(l.f[2] / r.f[2] - 1));
+
+			result = (result < delta) ? delta : result;
+		}
+		break;
+
+	case cgltf_animation_path_type_weights:
+		for (int i = 0; i < frames; ++i)
+		{
+			for (size_t j = 0; j < components; ++j)
+			{
+				float delta = fabsf(value[j].f[0] - keys[i * components + j].f[0]);
+
+				result = (result < delta) ? delta : result;
+			}
+		}
+		break;
+
+	default:
+		assert(!"Unknown animation path");
 	}
 
 	return result;
 }
 
+static bool isInterpolable(const std::vector<Attr>& data, size_t components, int first, int last, cgltf_animation_path_type type, float tolerance)
+{
+	// runtimes are free to slerp along either arc, so we only remove keyframes between quaternions in the same hemisphere
+	if (type == cgltf_animation_path_type_rotation)
+	{
+		const Attr& l = data[first];
+		const Attr& r = data[last];
+
+		if (l.f[0] * r.f[0] + l.f[1] * r.f[1] + l.f[2] * r.f[2] + l.f[3] * r.f[3] < 0.f)
+			return false;
+	}
+
+	float range = float(last - first);
+
+	for (int i = first + 1; i < last; ++i)
+	{
+		float t = float(i - first) / range;
+
+		for (size_t j = 0; j < components; ++j)
+		{
+			Attr v = interpolateLinear(data[first * components + j], data[last * components + j], t, type);
+
+			if (getDelta(v, data[i * components + j], type) > tolerance)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static void reduceKeyframes(Track& track, const Animation& animation, float tolerance, const Settings& settings)
+{
+	// step tracks can't reconstruct removed keyframes by interpolation
+	if (track.interpolation == cgltf_interpolation_type_step || animation.frames <= 2)
+		return;
+
+	// to keep the cost linear in the number of frames, segments between consecutive keyframes are limited in length
+	const int kMaxSegment = 32;
+
+	size_t components = track.components;
+	int frames = animation.frames;
+
+	std::vector<int> keys;
+	keys.push_back(0);
+
+	for (int i = 2; i < frames; ++i)
+	{
+		// extend the segment that starts at the last kept keyframe until the frames inside can't be reconstructed within tolerance
+		if (i - keys.back() > kMaxSegment || !isInterpolable(track.data, components, keys.back(), i, track.path, tolerance))
+			keys.push_back(i - 1);
+	}
+
+	keys.push_back(frames - 1);
+
+	// reduced tracks need a separate time stream and lose the regular sampling that makes keyframe data compress well, so small reductions aren't worth it
+	if (keys.size() > size_t(frames / 2))
+		return;
+
+	// this matches the time values that writeAnimation uses for resampled tracks
+	float period = 1.f / float(settings.anim_freq);
+
+	std::vector<Attr> result;
+	result.reserve(keys.size() * components);
+
+	track.time.resize(keys.size());
+
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		track.time[i] = animation.start + float(keys[i]) * period;
+
+		const Attr* v = &track.data[keys[i] * components];
+		result.insert(result.end(), v, v + components);
+	}
+
+	track.data.swap(result);
+}
+
 static void getBaseTransform(Attr* result, size_t components, cgltf_animation_path_type type, cgltf_node* node)
 {
 	switch (type)
@@ -274,7 +408,7 @@ static float getWorldScale(cgltf_node* node)
 	return powf(fabsf(det), 1.f / 3.f);
 }
 
-void processAnimation(Animation& animation, const Settings& settings)
+void prepareAnimation(Animation& animation, const Settings& settings)
 {
 	float mint = FLT_MAX, maxt = 0;
 
@@ -296,41 +430,43 @@ void processAnimation(Animation& animation, const Settings& settings)
 
 	animation.start = mint;
 	animation.frames = frames;
+}
 
-	std::vector<Attr> base;
-
-	for (size_t i = 0; i < animation.tracks.size(); ++i)
-	{
-		Track& track = animation.tracks[i];
+void processAnimationTrack(Track& track, const Animation& animation, const Settings& settings)
+{
+	int frames = animation.frames;
 
-		std::vector<Attr> result;
-		resampleKeyframes(result, track.time, track.data, track.path, track.interpolation, track.components, frames, mint, settings.anim_freq);
+	std::vector<Attr> result;
+	resampleKeyframes(result, track.time, track.data, track.path, track.interpolation, track.components, frames, animation.start, settings.anim_freq);
 
-		track.time.clear();
-		track.data.swap(result);
+	track.time.clear();
+	track.data.swap(result);
 
-		float tolerance = getDeltaTolerance(track.path);
+	float tolerance = getDeltaTolerance(track.path);
 
-		// translation tracks use world space tolerance; in the future, we should compute all errors as linear using hierarchy
-		if (track.node && track.node->parent && track.path == cgltf_animation_path_type_translation)
-		{
-			float scale = getWorldScale(track.node->parent);
-			tolerance /= scale == 0.f ? 1.f : scale;
-		}
+	// translation tracks use world space tolerance; in the future, we should compute all errors as linear using hierarchy
+	if (track.node && track.node->parent && track.path == cgltf_animation_path_type_translation)
+	{
+		float scale = getWorldScale(track.node->parent);
+		tolerance /= scale == 0.f ? 1.f : scale;
+	}
 
-		float deviation = getMaxDelta(track.data, track.path, frames, &track.data[0], track.components);
+	float deviation = getMaxDelta(track.data, track.path, frames, &track.data[0], track.components);
 
-		if (deviation <= tolerance)
-		{
-			// track is constant (equal to first keyframe), we only need the first keyframe
-			track.constant = true;
-			track.data.resize(track.components);
+	if (deviation <= tolerance)
+	{
+		// track is constant (equal to first keyframe), we only need the first keyframe
+		track.constant = true;
+		track.data.resize(track.components);
 
-			// track.dummy is true iff track redundantly sets up the value to be equal to default node transform
-			base.resize(track.components);
-			getBaseTransform(&base[0], track.components, track.path, track.node);
+		// track.dummy is true iff track redundantly sets up the value to be equal to default node transform
+		std::vector<Attr> base(track.components);
+		getBaseTransform(&base[0], track.components, track.path, track.node);
 
-			track.dummy = getMaxDelta(track.data, track.path, 1, &base[0], track.components) <= tolerance;
-		}
+		track.dummy = getMaxDelta(track.data, track.path, 1, &base[0], track.components) <= tolerance;
+	}
+	else if (settings.anim_reduce)
+	{
+		reduceKeyframes(track, animation, tolerance, settings);
 	}
 }
@@ -158,7 +158,7 @@ void encodeImages(std::string* encoded, const cgltf_data* data, const std::vecto
 		// image is ready to encode in parallel
 	}
 
-	uint32_t num_threads = settings.texture_jobs == 0 ? std::thread::hardware_concurrency() : settings.texture_jobs;
+	uint32_t num_threads = settings.texture_jobs <= 0 ? std::thread::hardware_concurrency() : settings.texture_jobs;
 
 	basisu::basis_parallel_compress(num_threads, params, results);
 
@@ -0,0 +1,293 @@
+// This file is part of gltfpack; see gltfpack.h for version/license details
+#include "gltfpack.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef __wasi__
+#include <mutex>
+#include <thread>
+#endif
+
+struct BatchJob
+{
+	size_t index;
+
+	std::string input;
+	std::string output;
+
+	int result;
+	double time;
+};
+
+struct BatchContext
+{
+	FILE* manifest;
+	size_t next;
+
+	const Settings* settings;
+	bool verbose;
+
+	std::vector<BatchJob> jobs;
+
+#ifndef __wasi__
+	std::mutex lock;
+#endif
+};
+
+static double getTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool readLine(FILE* file, std::string& line)
+{
+	line.clear();
+
+	int ch = fgetc(file);
+	if (ch == EOF)
+		return false;
+
+	while (ch != EOF && ch != '\n')
+	{
+		line += char(ch);
+		ch = fgetc(file);
+	}
+
+	return true;
+}
+
+static bool parseManifestLine(const std::string& line, std::string& input, std::string& output)
+{
+	std::string text = line;
+
+	while (!text.empty() && isspace((unsigned char)text[text.size() - 1]))
+		text.erase(text.size() - 1);
+
+	size_t start = 0;
+	while (start < text.size() && isspace((unsigned char)text[start]))
+		start++;
+
+	if (start == text.size() || text[start] == '#')
+		return false;
+
+	// paths are separated by a tab, which allows spaces in paths; without tabs, the last space is used as a separator
+	size_t split = text.find('\t', start);
+	if (split == std::string::npos)
+		split = text.find_last_of(' ');
+
+	if (split == std::string::npos || split < start)
+	{
+		input = text.substr(start);
+		output.clear();
+		return true;
+	}
+
+	size_t next = split;
+	while (next < text.size() && isspace((unsigned char)text[next]))
+		next++;
+
+	input = text.substr(start, split - start);
+	output = text.substr(next);
+
+	return true;
+}
+
+static bool fetchJob(BatchContext& context, BatchJob& job)
+{
+#ifndef __wasi__
+	std::lock_guard<std::mutex> lock(context.lock);
+#endif
+
+	// manifest is read incrementally so that jobs can be streamed through stdin by a long-running producer
+	std::string line;
+
+	while (readLine(context.manifest, line))
+	{
+		if (parseManifestLine(line, job.input, job.output))
+		{
+			job.index = context.next++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void finishJob(BatchContext& context, const BatchJob& job)
+{
+#ifndef __wasi__
+	std::lock_guard<std::mutex> lock(context.lock);
+#endif
+
+	context.jobs.push_back(job);
+
+	if (context.verbose)
+		printf("%s -> %s: %s (%.1f ms)\n", job.input.c_str(), job.output.c_str(), job.result == 0 ? "ok" : "error", job.time * 1000);
+	else if (job.result != 0)
+		fprintf(stderr, "Error processing %s (code %d)\n", job.input.c_str(), job.result);
+
+	// flush after every job so that a driver process can track progress
+	fflush(stdout);
+}
+
+static void runJobs(BatchContext* context)
+{
+	BatchJob job = {};
+
+	while (fetchJob(*context, job))
+	{
+		double start = getTime();
+
+		if (job.output.empty())
+		{
+			fprintf(stderr, "Error processing %s: missing output path\n", job.input.c_str());
+			job.result = 1;
+		}
+		else
+		{
+			job.result = gltfpack(job.input.c_str(), job.output.c_str(), NULL, *context->settings);
+		}
+
+		job.time = getTime() - start;
+
+		finishJob(*context, job);
+	}
+}
+
+static void appendString(std::string& s, const std::string& v)
+{
+	s += '"';
+
+	for (size_t i = 0; i < v.size(); ++i)
+	{
+		char ch = v[i];
+
+		if (ch == '"' || ch == '\\')
+			s += '\\';
+
+		if ((unsigned char)ch < 32)
+			s += ' ';
+		else
+			s += ch;
+	}
+
+	s += '"';
+}
+
+static bool compareJobs(const BatchJob& lhs, const BatchJob& rhs)
+{
+	return lhs.index < rhs.index;
+}
+
+static bool printBatchReport(const char* path, const std::vector<BatchJob>& jobs, int threads, double time)
+{
+	size_t failed = 0;
+	double job_time = 0;
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		failed += jobs[i].result != 0;
+		job_time += jobs[i].time;
+	}
+
+	FILE* out = fopen(path, "wb");
+	if (!out)
+		return false;
+
+	fprintf(out, "{\n");
+	fprintf(out, "\t\"generator\": \"gltfpack %s\",\n", getVersion().c_str());
+	fprintf(out, "\t\"batch\": {\n");
+	fprintf(out, "\t\t\"jobCount\": %d,\n", int(jobs.size()));
+	fprintf(out, "\t\t\"failedCount\": %d,\n", int(failed));
+	fprintf(out, "\t\t\"threadCount\": %d,\n", threads);
+	fprintf(out, "\t\t\"time\": %.3f,\n", time);
+	fprintf(out, "\t\t\"jobTime\": %.3f\n", job_time);
+	fprintf(out, "\t},\n");
+	fprintf(out, "\t\"jobs\": [\n");
+
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		const BatchJob& job = jobs[i];
+
+		std::string input, output;
+		appendString(input, job.input);
+		appendString(output, job.output);
+
+		fprintf(out, "\t\t{\"input\": %s, \"output\": %s, \"result\": %d, \"time\": %.3f}%s\n",
+		    input.c_str(), output.c_str(), job.result, job.time, i + 1 < jobs.size() ? "," : "");
+	}
+
+	fprintf(out, "\t]\n");
+	fprintf(out, "}\n");
+
+	int rc = fclose(out);
+	return rc == 0;
+}
+
+int gltfpackBatch(const char* manifest, const char* report, Settings settings)
+{
+	bool use_stdin = strcmp(manifest, "-") == 0;
+
+	FILE* file = use_stdin ? stdin : fopen(manifest, "r");
+	if (!file)
+	{
+		fprintf(stderr, "Error loading %s\n", manifest);
+		return 2;
+	}
+
+	// the batch runs -j jobs concurrently, and every job is processed on a single thread; this shares the cores between files instead of within them, which is much more efficient for small files
+	int threads = getJobCount(settings.jobs, size_t(-1));
+
+	Settings job_settings = settings;
+	job_settings.jobs = 1;
+
+	// interleaved per-job statistics are unreadable, so concurrent jobs only report completion
+	job_settings.verbose = threads > 1 ? 0 : settings.verbose;
+
+	BatchContext context;
+	context.manifest = file;
+	context.next = 0;
+	context.settings = &job_settings;
+	context.verbose = settings.verbose > 0;
+
+	double start = getTime();
+
+#ifndef __wasi__
+	// worker threads persist for the entire batch, so allocator caches stay warm across jobs
+	std::vector<std::thread> workers;
+
+	for (int i = 1; i < threads; ++i)
+		workers.push_back(std::thread(runJobs, &context));
+
+	runJobs(&context);
+
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+#else
+	runJobs(&context);
+#endif
+
+	double time = getTime() - start;
+
+	if (!use_stdin)
+		fclose(file);
+
+	std::sort(context.jobs.begin(), context.jobs.end(), compareJobs);
+
+	size_t failed = 0;
+	for (size_t i = 0; i < context.jobs.size(); ++i)
+		failed += context.jobs[i].result != 0;
+
+	if (settings.verbose)
+		printf("batch: %d jobs (%d failed) in %.1f ms using %d threads\n", int(context.jobs.size()), int(failed), time * 1000, threads);
+
+	if (report && !printBatchReport(report, context.jobs, threads, time))
+		fprintf(stderr, "Warning: cannot save report to %s\n", report);
+
+	return failed ? 5 : 0;
+}
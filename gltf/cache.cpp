@@ -0,0 +1,202 @@
+// This file is part of gltfpack; see gltfpack.h for version/license details
+#include "gltfpack.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/meshoptimizer.h"
+
+// bump this when the cache file layout or the behavior of processMesh changes
+static const uint32_t kCacheMagic = 0x4d504c47; // GLPM
+static const uint32_t kCacheVersion = 1;
+
+struct CacheStream
+{
+	int32_t type;
+	int32_t index;
+	int32_t target;
+	uint32_t count;
+};
+
+struct CacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t library;
+	uint32_t type;
+
+	uint64_t key[2];
+
+	uint32_t streams;
+	uint32_t indices;
+};
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size)
+{
+	// FNV-1a; the inputs here are small so this doesn't need to be fast
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= static_cast<const unsigned char*>(data)[i];
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+void getMeshCacheKey(Mesh& mesh, const Settings& settings, uint64_t key[2])
+{
+	// geometry_hash may already be used for duplicate detection, so we compute the hash of the current geometry without changing it
+	uint64_t geometry_hash[2] = {mesh.geometry_hash[0], mesh.geometry_hash[1]};
+
+	hashMesh(mesh);
+
+	key[0] = mesh.geometry_hash[0];
+	key[1] = mesh.geometry_hash[1];
+
+	mesh.geometry_hash[0] = geometry_hash[0];
+	mesh.geometry_hash[1] = geometry_hash[1];
+
+	// note: this must include all settings that processMesh depends on
+	float params[] = {
+	    settings.simplify_ratio,
+	    settings.simplify_error,
+	    settings.simplify_attributes ? 1.f : 0.f,
+	    settings.simplify_aggressive ? 1.f : 0.f,
+	    settings.simplify_lock_borders ? 1.f : 0.f,
+	    settings.quantize && !settings.nrm_float ? 1.f : 0.f,
+	    settings.compressmore ? 1.f : 0.f,
+	};
+
+	uint64_t hash = 14695981039346656037ull;
+	hash = hashBytes(hash, params, sizeof(params));
+	hash = hashBytes(hash, &kCacheVersion, sizeof(kCacheVersion));
+
+	key[1] ^= hash;
+}
+
+static std::string getCachePath(const char* cache_path, const uint64_t key[2])
+{
+	char name[40];
+	snprintf(name, sizeof(name), "%016llx%016llx.bin", (unsigned long long)key[0], (unsigned long long)key[1]);
+
+	std::string result = cache_path;
+	if (!result.empty() && result[result.size() - 1] != '/' && result[result.size() - 1] != '\\')
+		result += '/';
+	result += name;
+
+	return result;
+}
+
+bool readMeshCache(Mesh& mesh, const char* cache_path, const uint64_t key[2])
+{
+	std::string path = getCachePath(cache_path, key);
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file)
+		return false;
+
+	CacheHeader header = {};
+	bool ok = fread(&header, sizeof(header), 1, file) == 1;
+
+	ok = ok && header.magic == kCacheMagic && header.version == kCacheVersion && header.library == MESHOPTIMIZER_VERSION;
+	ok = ok && header.key[0] == key[0] && header.key[1] == key[1];
+	ok = ok && header.type == uint32_t(mesh.type) && header.streams == mesh.streams.size();
+
+	std::vector<CacheStream> streams(ok ? header.streams : 0);
+	ok = ok && (streams.empty() || fread(streams.data(), sizeof(CacheStream), streams.size(), file) == streams.size());
+
+	// processMesh never adds, removes or reorders streams, so stream metadata must match the source mesh exactly
+	for (size_t i = 0; ok && i < streams.size(); ++i)
+	{
+		const Stream& stream = mesh.streams[i];
+
+		ok = streams[i].type == int32_t(stream.type) && streams[i].index == stream.index && streams[i].target == stream.target;
+		ok = ok && streams[i].count == streams[0].count;
+	}
+
+	// the mesh is only modified once the entire file has been validated
+	std::vector<std::vector<Attr> > data(ok ? streams.size() : 0);
+	std::vector<unsigned int> indices(ok ? header.indices : 0);
+
+	for (size_t i = 0; ok && i < data.size(); ++i)
+	{
+		data[i].resize(streams[i].count);
+		ok = data[i].empty() || fread(data[i].data(), sizeof(Attr), data[i].size(), file) == data[i].size();
+	}
+
+	ok = ok && (indices.empty() || fread(indices.data(), sizeof(unsigned int), indices.size(), file) == indices.size());
+
+	fclose(file);
+
+	if (!ok)
+		return false;
+
+	for (size_t i = 0; i < data.size(); ++i)
+		mesh.streams[i].data.swap(data[i]);
+
+	mesh.indices.swap(indices);
+
+	return true;
+}
+
+bool writeMeshCache(const Mesh& mesh, const char* cache_path, const uint64_t key[2], int worker)
+{
+	std::string path = getCachePath(cache_path, key);
+
+	// the file is written under a unique name and renamed afterwards, so that concurrent writers (threads or processes sharing the cache) never observe partial files
+	std::string temp_path = path + "." + getFileName(getTempPrefix().c_str()) + "-" + std::to_string(worker);
+
+	FILE* file = fopen(temp_path.c_str(), "wb");
+	if (!file)
+		return false;
+
+	CacheHeader header = {};
+	header.magic = kCacheMagic;
+	header.version = kCacheVersion;
+	header.library = MESHOPTIMIZER_VERSION;
+	header.type = uint32_t(mesh.type);
+	header.key[0] = key[0];
+	header.key[1] = key[1];
+	header.streams = uint32_t(mesh.streams.size());
+	header.indices = uint32_t(mesh.indices.size());
+
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+	{
+		const Stream& stream = mesh.streams[i];
+
+		CacheStream cs = {int32_t(stream.type), int32_t(stream.index), int32_t(stream.target), uint32_t(stream.data.size())};
+		ok = ok && fwrite(&cs, sizeof(cs), 1, file) == 1;
+	}
+
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+	{
+		const Stream& stream = mesh.streams[i];
+
+		ok = ok && (stream.data.empty() || fwrite(stream.data.data(), sizeof(Attr), stream.data.size(), file) == stream.data.size());
+	}
+
+	ok = ok && (mesh.indices.empty() || fwrite(mesh.indices.data(), sizeof(unsigned int), mesh.indices.size(), file) == mesh.indices.size());
+
+	ok = (fclose(file) == 0) && ok;
+
+	if (ok && rename(temp_path.c_str(), path.c_str()) == 0)
+		return true;
+
+	removeFile(temp_path.c_str());
+
+	// rename may fail on Windows if the same entry was written concurrently; the existing file is equally valid
+	if (ok)
+	{
+		FILE* existing = fopen(path.c_str(), "rb");
+		if (existing)
+		{
+			fclose(existing);
+			return true;
+		}
+	}
+
+	return false;
+}
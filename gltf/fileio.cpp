@@ -6,25 +6,50 @@
 #include <string.h>
 
 #ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
 #include <process.h>
+#include <windows.h>
 #else
 #include <unistd.h>
 #endif
 
+#if !defined(_WIN32) && !defined(__wasi__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <mutex>
+#include <unordered_map>
+#endif
+
+#ifndef __wasi__
+#include <atomic>
+#endif
+
 std::string getTempPrefix()
 {
+	// every call returns a new prefix so that concurrent jobs in the same process (see gltfpackBatch) don't overwrite each other's files
+#ifndef __wasi__
+	static std::atomic<unsigned int> counter(0);
+#else
+	static unsigned int counter = 0;
+#endif
+
+	std::string suffix = "-" + std::to_string(counter++);
+
 #if defined(_WIN32)
 	const char* temp_dir = getenv("TEMP");
 	std::string path = temp_dir ? temp_dir : ".";
 	path += "\\gltfpack-temp";
 	path += std::to_string(_getpid());
-	return path;
+	return path + suffix;
 #elif defined(__wasi__)
-	return "gltfpack-temp";
+	return "gltfpack-temp" + suffix;
 #else
 	std::string path = "/tmp/gltfpack-temp";
 	path += std::to_string(getpid());
-	return path;
+	return path + suffix;
 #endif
 }
 
@@ -113,3 +138,189 @@ void removeFile(const char* path)
 {
 	remove(path);
 }
+
+bool renameFile(const char* from, const char* to)
+{
+#if defined(_WIN32)
+	// rename fails on Windows if the target exists
+	return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(from, to) == 0;
+#endif
+}
+
+// empty files can't be mapped, but they are valid inputs (e.g. empty buffers) so they are returned as a zero-length placeholder
+static char gEmptyMapping[1];
+
+#if !defined(_WIN32) && !defined(__wasi__)
+// munmap needs the mapping size, but callers (e.g. cgltf release callbacks) only keep the pointer
+static std::mutex gMappingLock;
+static std::unordered_map<void*, size_t> gMappings;
+#endif
+
+void* mapFile(const char* path, size_t& size)
+{
+#if defined(_WIN32)
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	LARGE_INTEGER length = {};
+	if (!GetFileSizeEx(file, &length) || (size && size_t(length.QuadPart) < size))
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+
+	if (length.QuadPart == 0)
+	{
+		CloseHandle(file);
+		size = 0;
+		return gEmptyMapping;
+	}
+
+	size_t map_size = size ? size : size_t(length.QuadPart);
+
+	// mappings are copy-on-write so that the contents can be patched in place without affecting the file
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	void* result = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, map_size) : NULL;
+
+	if (mapping)
+		CloseHandle(mapping);
+	CloseHandle(file);
+
+	if (result)
+		size = map_size;
+
+	return result;
+#elif defined(__wasi__)
+	// no mmap support; read the file into memory instead
+	FILE* file = fopen(path, "rb");
+	if (!file)
+		return NULL;
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	if (length < 0 || (size && size_t(length) < size))
+	{
+		fclose(file);
+		return NULL;
+	}
+
+	if (length == 0)
+	{
+		fclose(file);
+		size = 0;
+		return gEmptyMapping;
+	}
+
+	size_t map_size = size ? size : size_t(length);
+
+	void* result = malloc(map_size);
+	size_t read = result ? fread(result, 1, map_size, file) : 0;
+	fclose(file);
+
+	if (result && read != map_size)
+	{
+		free(result);
+		return NULL;
+	}
+
+	if (result)
+		size = map_size;
+
+	return result;
+#else
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size && size_t(st.st_size) < size))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	if (st.st_size == 0)
+	{
+		close(fd);
+		size = 0;
+		return gEmptyMapping;
+	}
+
+	size_t map_size = size ? size : size_t(st.st_size);
+
+	// mappings are copy-on-write so that the contents can be patched in place without affecting the file
+	void* result = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (result == MAP_FAILED)
+		return NULL;
+
+	std::lock_guard<std::mutex> lock(gMappingLock);
+	gMappings[result] = map_size;
+
+	size = map_size;
+	return result;
+#endif
+}
+
+void unmapFile(void* data)
+{
+	if (!data || data == gEmptyMapping)
+		return;
+
+#if defined(_WIN32)
+	UnmapViewOfFile(data);
+#elif defined(__wasi__)
+	free(data);
+#else
+	size_t size = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(gMappingLock);
+		std::unordered_map<void*, size_t>::iterator it = gMappings.find(data);
+		assert(it != gMappings.end());
+
+		size = it->second;
+		gMappings.erase(it);
+	}
+
+	munmap(data, size);
+#endif
+}
+
+void writeBinary(BinaryOutput& output, const void* data, size_t size)
+{
+	if (output.file && size && fwrite(data, 1, size, output.file) != size)
+		output.error = true;
+
+	output.size += size;
+}
+
+void alignBinary(BinaryOutput& output, size_t alignment)
+{
+	static const char zero[16] = {};
+	assert(alignment <= sizeof(zero));
+
+	size_t padding = (alignment - output.size % alignment) % alignment;
+	writeBinary(output, zero, padding);
+}
+
+bool copyFile(FILE* output, FILE* input)
+{
+	char buffer[65536];
+
+	for (;;)
+	{
+		size_t read = fread(buffer, 1, sizeof(buffer), input);
+		if (read && fwrite(buffer, 1, read, output) != read)
+			return false;
+
+		if (read < sizeof(buffer))
+			return ferror(input) == 0;
+	}
+}
@@ -14,6 +14,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef WITH_BASISU
+#include <thread>
+#endif
+
 #include "../src/meshoptimizer.h"
 
 std::string getVersion()
@@ -23,56 +27,101 @@ std::string getVersion()
 	return result;
 }
 
-static void finalizeBufferViews(std::string& json, std::vector<BufferView>& views, std::string& bin, std::string* fallback, size_t& fallback_size)
+struct CompressContext
+{
+	std::vector<BufferView>* views;
+	std::vector<std::string>* results;
+	std::vector<meshopt_EncodeContext>* encoders;
+};
+
+static void compressBufferViewJob(void* context, size_t index, int worker)
 {
+	CompressContext& cc = *static_cast<CompressContext*>(context);
+	const BufferView& view = (*cc.views)[index];
+
+	// each worker reuses the scratch memory of its own encoder context
+	meshopt_EncodeContext& encoder = (*cc.encoders)[worker];
+	std::string& result = (*cc.results)[index];
+
+	size_t count = view.data.size() / view.stride;
+
+	switch (view.compression)
+	{
+	case BufferView::Compression_None:
+		break;
+	case BufferView::Compression_Attribute:
+		compressVertexStream(encoder, result, view.data, count, view.stride);
+		break;
+	case BufferView::Compression_Index:
+		compressIndexStream(encoder, result, view.data, count, view.stride);
+		break;
+	case BufferView::Compression_IndexSequence:
+		compressIndexSequence(encoder, result, view.data, count, view.stride);
+		break;
+	default:
+		assert(!"Unknown compression type");
+	}
+}
+
+static void finalizeBufferViews(std::string& json, std::vector<BufferView>& views, BinaryOutput& bin, BinaryOutput& fallback, const Settings& settings)
+{
+	// views are compressed independently into separate buffers and concatenated in order afterwards, so the output doesn't depend on the number of jobs
+	std::vector<std::string> compressed(views.size());
+
+	// the contexts reuse scratch memory for all buffer views; versions are fixed to keep the output compatible with EXT_meshopt_compression
+	std::vector<meshopt_EncodeContext> encoders(getJobCount(settings.jobs, views.size()));
+
+	for (size_t i = 0; i < encoders.size(); ++i)
+	{
+		meshopt_encodeContextInit(&encoders[i]);
+		encoders[i].vertex_version = 0;
+		encoders[i].index_version = 1;
+	}
+
+	CompressContext cc = {&views, &compressed, &encoders};
+	parallelFor(views.size(), settings.jobs, compressBufferViewJob, &cc);
+
+	for (size_t i = 0; i < encoders.size(); ++i)
+		meshopt_encodeContextDestroy(&encoders[i]);
+
 	for (size_t i = 0; i < views.size(); ++i)
 	{
 		BufferView& view = views[i];
 
-		size_t bin_offset = bin.size();
-		size_t fallback_offset = fallback_size;
+		size_t bin_offset = bin.size;
+		size_t fallback_offset = fallback.size;
 
 		size_t count = view.data.size() / view.stride;
 
 		if (view.compression == BufferView::Compression_None)
 		{
-			bin += view.data;
+			writeBinary(bin, view.data.data(), view.data.size());
 		}
 		else
 		{
-			switch (view.compression)
-			{
-			case BufferView::Compression_Attribute:
-				compressVertexStream(bin, view.data, count, view.stride);
-				break;
-			case BufferView::Compression_Index:
-				compressIndexStream(bin, view.data, count, view.stride);
-				break;
-			case BufferView::Compression_IndexSequence:
-				compressIndexSequence(bin, view.data, count, view.stride);
-				break;
-			default:
-				assert(!"Unknown compression type");
-			}
+			writeBinary(bin, compressed[i].data(), compressed[i].size());
 
-			if (fallback)
-				*fallback += view.data;
-			fallback_size += view.data.size();
+			// release compressed data early to reduce peak memory consumption
+			std::string().swap(compressed[i]);
+
+			writeBinary(fallback, view.data.data(), view.data.size());
 		}
 
 		size_t raw_offset = (view.compression != BufferView::Compression_None) ? fallback_offset : bin_offset;
 
 		comma(json);
-		writeBufferView(json, view.kind, view.filter, count, view.stride, raw_offset, view.data.size(), view.compression, bin_offset, bin.size() - bin_offset);
+		writeBufferView(json, view.kind, view.filter, count, view.stride, raw_offset, view.data.size(), view.compression, bin_offset, bin.size - bin_offset);
 
 		// record written bytes for statistics
-		view.bytes = bin.size() - bin_offset;
+		view.bytes = bin.size - bin_offset;
+		view.raw_bytes = view.data.size();
+
+		// the data has been streamed to the output, so it's no longer needed
+		std::string().swap(view.data);
 
 		// align each bufferView by 4 bytes
-		bin.resize((bin.size() + 3) & ~3);
-		if (fallback)
-			fallback->resize((fallback->size() + 3) & ~3);
-		fallback_size = (fallback_size + 3) & ~3;
+		alignBinary(bin, 4);
+		alignBinary(fallback, 4);
 	}
 }
 
@@ -152,12 +201,12 @@ static void printAttributeStats(const std::vector<BufferView>& views, BufferView
 		default:;
 		}
 
-		size_t count = view.data.size() / view.stride;
+		size_t count = view.raw_bytes / view.stride;
 
 		printf("stats: %s %s: compressed %d bytes (%.1f bits), raw %d bytes (%d bits)\n",
 		    name, variant,
 		    int(view.bytes), double(view.bytes) / double(count) * 8,
-		    int(view.data.size()), int(view.stride * 8));
+		    int(view.raw_bytes), int(view.stride * 8));
 	}
 }
 
@@ -177,7 +226,7 @@ static void printImageStats(const std::vector<BufferView>& views, TextureKind ki
 			continue;
 
 		count += 1;
-		bytes += view.data.size();
+		bytes += view.raw_bytes;
 	}
 
 	if (count)
@@ -341,7 +390,59 @@ struct hash<std::pair<uint64_t, uint64_t> >
 };
 } // namespace std
 
-static void process(cgltf_data* data, const char* input_path, const char* output_path, const char* report_path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const Settings& settings, std::string& json, std::string& bin, std::string& fallback, size_t& fallback_size)
+struct ProcessContext
+{
+	std::vector<Mesh>* meshes;
+	std::vector<Animation>* animations;
+	std::vector<std::pair<size_t, size_t> >* tracks;
+	const Settings* settings;
+
+	std::vector<unsigned char>* cache_hits;
+	std::vector<unsigned char>* cache_failures;
+};
+
+static void processAnimationJob(void* context, size_t index, int worker)
+{
+	ProcessContext& pc = *static_cast<ProcessContext*>(context);
+	(void)worker;
+
+	const std::pair<size_t, size_t>& track = (*pc.tracks)[index];
+	Animation& animation = (*pc.animations)[track.first];
+
+	processAnimationTrack(animation.tracks[track.second], animation, *pc.settings);
+}
+
+static void processMeshJob(void* context, size_t index, int worker)
+{
+	ProcessContext& pc = *static_cast<ProcessContext*>(context);
+	Mesh& mesh = (*pc.meshes)[index];
+	const Settings& settings = *pc.settings;
+
+	if (settings.mesh_cache && !mesh.streams.empty())
+	{
+		uint64_t key[2];
+		getMeshCacheKey(mesh, settings, key);
+
+		if (readMeshCache(mesh, settings.mesh_cache, key))
+		{
+			(*pc.cache_hits)[index] = 1;
+		}
+		else
+		{
+			processMesh(mesh, settings);
+			(*pc.cache_failures)[index] = !writeMeshCache(mesh, settings.mesh_cache, key, worker);
+		}
+	}
+	else
+	{
+		processMesh(mesh, settings);
+	}
+
+	if (mesh.geometry_duplicate)
+		hashMesh(mesh);
+}
+
+static void process(cgltf_data* data, const char* input_path, const char* output_path, const char* report_path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const Settings& settings, std::string& json, BinaryOutput& bin, BinaryOutput& fallback)
 {
 	if (settings.verbose)
 	{
@@ -350,8 +451,21 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 		printMeshStats(meshes, "input");
 	}
 
+	// meshes and animations are processed independently and in place, so the output doesn't depend on the number of jobs
+	std::vector<std::pair<size_t, size_t> > tracks;
+	std::vector<unsigned char> cache_hits, cache_failures;
+	ProcessContext pc = {&meshes, &animations, &tracks, &settings, &cache_hits, &cache_failures};
+
+	// tracks are processed as individual jobs, since files often have few animations with many tracks each
 	for (size_t i = 0; i < animations.size(); ++i)
-		processAnimation(animations[i], settings);
+	{
+		prepareAnimation(animations[i], settings);
+
+		for (size_t j = 0; j < animations[i].tracks.size(); ++j)
+			tracks.push_back(std::make_pair(i, j));
+	}
+
+	parallelFor(tracks.size(), settings.jobs, processAnimationJob, &pc);
 
 	std::vector<NodeInfo> nodes(data->nodes_count);
 
@@ -376,6 +490,33 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 
 	optimizeMaterials(data, input_path, images);
 
+	std::vector<std::string> encoded_images;
+
+	int mesh_jobs = settings.jobs;
+
+#ifdef WITH_BASISU
+	// the set of images and their encoding parameters is final at this point, so textures are encoded in the background while meshes are processed
+	// this only reads cgltf data and image info, neither of which is modified until the encoded images are consumed below
+	std::thread encode_thread;
+	Settings texture_settings = settings;
+
+	if (data->images_count && settings.texture_ktx2)
+	{
+		encoded_images.resize(data->images_count);
+
+		// when texture encoding shares the -j budget, it's split between textures and meshes for the duration of the overlap
+		if (settings.texture_jobs < 0)
+		{
+			int budget = getJobCount(settings.jobs, size_t(-1));
+
+			texture_settings.texture_jobs = (budget + 1) / 2;
+			mesh_jobs = budget - texture_settings.texture_jobs > 1 ? budget - texture_settings.texture_jobs : 1;
+		}
+
+		encode_thread = std::thread(encodeImages, encoded_images.data(), data, std::cref(images), input_path, std::cref(texture_settings));
+	}
+#endif
+
 	// streams need to be filtered before mesh merging (or processing) to make sure we can merge meshes with redundant streams
 	for (size_t i = 0; i < meshes.size(); ++i)
 	{
@@ -427,13 +568,27 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	}
 #endif
 
-	for (size_t i = 0; i < meshes.size(); ++i)
+	cache_hits.resize(meshes.size());
+	cache_failures.resize(meshes.size());
+	parallelFor(meshes.size(), mesh_jobs, processMeshJob, &pc);
+
+	if (settings.mesh_cache)
 	{
-		Mesh& mesh = meshes[i];
-		processMesh(mesh, settings);
+		size_t failures = 0;
+		for (size_t i = 0; i < cache_failures.size(); ++i)
+			failures += cache_failures[i];
+
+		if (failures)
+			fprintf(stderr, "Warning: cannot write %d mesh primitives to cache %s; make sure the directory exists and is writable\n", int(failures), settings.mesh_cache);
+	}
+
+	if (settings.mesh_cache && settings.verbose)
+	{
+		size_t hits = 0;
+		for (size_t i = 0; i < cache_hits.size(); ++i)
+			hits += cache_hits[i];
 
-		if (mesh.geometry_duplicate)
-			hashMesh(mesh);
+		printf("cache: %d of %d mesh primitives loaded from %s\n", int(hits), int(meshes.size()), settings.mesh_cache);
 	}
 
 #ifndef NDEBUG
@@ -499,15 +654,9 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 		append(json_samplers, "}");
 	}
 
-	std::vector<std::string> encoded_images;
-
 #ifdef WITH_BASISU
-	if (data->images_count && settings.texture_ktx2)
-	{
-		encoded_images.resize(data->images_count);
-
-		encodeImages(encoded_images.data(), data, images, input_path, settings);
-	}
+	if (encode_thread.joinable())
+		encode_thread.join();
 #endif
 
 	for (size_t i = 0; i < data->images_count; ++i)
@@ -872,7 +1021,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	writeExtensions(json, extensions, sizeof(extensions) / sizeof(extensions[0]));
 
 	std::string json_views;
-	finalizeBufferViews(json_views, views, bin, settings.fallback ? &fallback : NULL, fallback_size);
+	finalizeBufferViews(json_views, views, bin, fallback, settings);
 
 	writeArray(json, "bufferViews", json_views);
 	writeArray(json, "accessors", json_accessors);
@@ -913,7 +1062,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 	if (settings.verbose)
 	{
 		printMeshStats(meshes, "output");
-		printSceneStats(views, meshes, node_offset, mesh_offset, material_offset, json.size(), bin.size());
+		printSceneStats(views, meshes, node_offset, mesh_offset, material_offset, json.size(), bin.size);
 	}
 
 	if (settings.verbose > 1)
@@ -931,7 +1080,7 @@ static void process(cgltf_data* data, const char* input_path, const char* output
 
 	if (report_path)
 	{
-		if (!printReport(report_path, views, meshes, node_offset, mesh_offset, texture_offset, material_offset, animations.size(), json.size(), bin.size()))
+		if (!printReport(report_path, views, meshes, node_offset, mesh_offset, texture_offset, material_offset, animations.size(), json.size(), bin.size))
 		{
 			fprintf(stderr, "Warning: cannot save report to %s\n", report_path);
 		}
@@ -1069,9 +1218,60 @@ int gltfpack(const char* input, const char* output, const char* report, Settings
 		}
 	}
 
-	std::string json, bin, fallback;
-	size_t fallback_size = 0;
-	process(data, input, output, report, meshes, animations, settings, json, bin, fallback, fallback_size);
+	if (output && oext != ".gltf" && oext != ".glb")
+	{
+		cgltf_free(data);
+
+		fprintf(stderr, "Error saving %s: unknown extension (expected .gltf or .glb)\n", output);
+		return 4;
+	}
+
+	std::string binpath, fbpath, bintemp, fbtemp;
+
+	if (output)
+	{
+		binpath = output;
+		binpath.replace(binpath.size() - oext.size(), oext.size(), ".bin");
+
+		fbpath = output;
+		fbpath.replace(fbpath.size() - oext.size(), oext.size(), ".fallback.bin");
+
+		// binary data is written to temporary files that are renamed once the input is released, since input buffers are memory mapped and may share paths with the output
+		// for .glb, the JSON chunk needs to precede the binary chunk so the temporary file is copied into the output instead
+		bintemp = binpath + ".tmp";
+		fbtemp = fbpath + ".tmp";
+	}
+
+	// buffer views are streamed to disk as they are finalized so that the binary data is never fully resident in memory
+	BinaryOutput bin = {}, fallback = {};
+
+	if (output)
+	{
+		bin.file = fopen(bintemp.c_str(), oext == ".gltf" ? "wb" : "w+b");
+		fallback.file = settings.fallback ? fopen(fbtemp.c_str(), "wb") : NULL;
+
+		if (!bin.file || (!fallback.file && settings.fallback))
+		{
+			fprintf(stderr, "Error saving %s\n", output);
+
+			if (bin.file)
+			{
+				fclose(bin.file);
+				removeFile(bintemp.c_str());
+			}
+			if (fallback.file)
+			{
+				fclose(fallback.file);
+				removeFile(fbtemp.c_str());
+			}
+
+			cgltf_free(data);
+			return 4;
+		}
+	}
+
+	std::string json;
+	process(data, input, output, report, meshes, animations, settings, json, bin, fallback);
 
 	cgltf_free(data);
 
@@ -1080,24 +1280,27 @@ int gltfpack(const char* input, const char* output, const char* report, Settings
 		return 0;
 	}
 
+	int rc = 0;
+
 	if (oext == ".gltf")
 	{
-		std::string binpath = output;
-		binpath.replace(binpath.size() - 5, 5, ".bin");
-
-		std::string fbpath = output;
-		fbpath.replace(fbpath.size() - 5, 5, ".fallback.bin");
-
 		FILE* outjson = fopen(output, "wb");
-		FILE* outbin = fopen(binpath.c_str(), "wb");
-		FILE* outfb = settings.fallback ? fopen(fbpath.c_str(), "wb") : NULL;
-		if (!outjson || !outbin || (!outfb && settings.fallback))
+		if (!outjson)
 		{
 			fprintf(stderr, "Error saving %s\n", output);
+
+			fclose(bin.file);
+			removeFile(bintemp.c_str());
+			if (fallback.file)
+			{
+				fclose(fallback.file);
+				removeFile(fbtemp.c_str());
+			}
+
 			return 4;
 		}
 
-		std::string bufferspec = getBufferSpec(getBaseName(binpath.c_str()), bin.size(), settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback_size, settings.compress);
+		std::string bufferspec = getBufferSpec(getBaseName(binpath.c_str()), bin.size, settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size, settings.compress);
 
 		fprintf(outjson, "{");
 		fwrite(bufferspec.c_str(), bufferspec.size(), 1, outjson);
@@ -1105,37 +1308,33 @@ int gltfpack(const char* input, const char* output, const char* report, Settings
 		fwrite(json.c_str(), json.size(), 1, outjson);
 		fprintf(outjson, "}");
 
-		fwrite(bin.c_str(), bin.size(), 1, outbin);
-
-		if (settings.fallback)
-			fwrite(fallback.c_str(), fallback.size(), 1, outfb);
-
-		int rc = 0;
 		rc |= fclose(outjson);
-		rc |= fclose(outbin);
-		if (outfb)
-			rc |= fclose(outfb);
+		rc |= fclose(bin.file);
 
-		if (rc)
-		{
-			fprintf(stderr, "Error saving %s\n", output);
-			return 4;
-		}
+		if (!renameFile(bintemp.c_str(), binpath.c_str()))
+			rc |= 1;
 	}
-	else if (oext == ".glb")
+	else
 	{
-		std::string fbpath = output;
-		fbpath.replace(fbpath.size() - 4, 4, ".fallback.bin");
+		assert(oext == ".glb");
 
 		FILE* out = fopen(output, "wb");
-		FILE* outfb = settings.fallback ? fopen(fbpath.c_str(), "wb") : NULL;
-		if (!out || (!outfb && settings.fallback))
+		if (!out)
 		{
 			fprintf(stderr, "Error saving %s\n", output);
+
+			fclose(bin.file);
+			removeFile(bintemp.c_str());
+			if (fallback.file)
+			{
+				fclose(fallback.file);
+				removeFile(fbtemp.c_str());
+			}
+
 			return 4;
 		}
 
-		std::string bufferspec = getBufferSpec(NULL, bin.size(), settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback_size, settings.compress);
+		std::string bufferspec = getBufferSpec(NULL, bin.size, settings.fallback ? getBaseName(fbpath.c_str()) : NULL, fallback.size, settings.compress);
 
 		json.insert(0, "{" + bufferspec + ",");
 		json.push_back('}');
@@ -1143,38 +1342,46 @@ int gltfpack(const char* input, const char* output, const char* report, Settings
 		while (json.size() % 4)
 			json.push_back(' ');
 
-		while (bin.size() % 4)
-			bin.push_back('\0');
+		alignBinary(bin, 4);
 
 		writeU32(out, 0x46546C67);
 		writeU32(out, 2);
-		writeU32(out, uint32_t(12 + 8 + json.size() + 8 + bin.size()));
+		writeU32(out, uint32_t(12 + 8 + json.size() + 8 + bin.size));
 
 		writeU32(out, uint32_t(json.size()));
 		writeU32(out, 0x4E4F534A);
 		fwrite(json.c_str(), json.size(), 1, out);
 
-		writeU32(out, uint32_t(bin.size()));
+		writeU32(out, uint32_t(bin.size));
 		writeU32(out, 0x004E4942);
-		fwrite(bin.c_str(), bin.size(), 1, out);
 
-		if (settings.fallback)
-			fwrite(fallback.c_str(), fallback.size(), 1, outfb);
+		// copy the binary chunk from the temporary file
+		rc |= fflush(bin.file);
+		rewind(bin.file);
+
+		if (!copyFile(out, bin.file))
+			rc |= 1;
 
-		int rc = 0;
 		rc |= fclose(out);
-		if (outfb)
-			rc |= fclose(outfb);
+		rc |= fclose(bin.file);
 
-		if (rc)
-		{
-			fprintf(stderr, "Error saving %s\n", output);
-			return 4;
-		}
+		removeFile(bintemp.c_str());
 	}
-	else
+
+	if (fallback.file)
 	{
-		fprintf(stderr, "Error saving %s: unknown extension (expected .gltf or .glb)\n", output);
+		rc |= fclose(fallback.file);
+
+		if (!renameFile(fbtemp.c_str(), fbpath.c_str()))
+			rc |= 1;
+	}
+
+	if (rc || bin.error || fallback.error)
+	{
+		fprintf(stderr, "Error saving %s\n", output);
+
+		removeFile(bintemp.c_str());
+		removeFile(fbtemp.c_str());
 		return 4;
 	}
 
@@ -1196,6 +1403,7 @@ Settings defaults()
 	settings.mesh_dedup = true;
 	settings.simplify_ratio = 1.f;
 	settings.simplify_error = 1e-2f;
+	settings.jobs = 1;
 
 	for (int kind = 0; kind < TextureKind__Count; ++kind)
 	{
@@ -1252,14 +1460,14 @@ int main(int argc, char** argv)
 	setlocale(LC_ALL, "C"); // disable locale specific convention for number parsing/printing
 #endif
 
-	meshopt_encodeVertexVersion(0);
-	meshopt_encodeIndexVersion(1);
-
 	Settings settings = defaults();
 
 	const char* input = NULL;
 	const char* output = NULL;
 	const char* report = NULL;
+	const char* batch = NULL;
+	bool jobs = false;
+	bool texture_jobs = false;
 	bool help = false;
 	bool test = false;
 	bool require_ktx2 = false;
@@ -1328,6 +1536,10 @@ int main(int argc, char** argv)
 		{
 			settings.anim_const = true;
 		}
+		else if (strcmp(arg, "-ad") == 0)
+		{
+			settings.anim_reduce = true;
+		}
 		else if (strcmp(arg, "-kn") == 0)
 		{
 			settings.keep_nodes = true;
@@ -1471,6 +1683,16 @@ int main(int argc, char** argv)
 		else if (strcmp(arg, "-tj") == 0 && i + 1 < argc && isdigit(argv[i + 1][0]))
 		{
 			settings.texture_jobs = clamp(atoi(argv[++i]), 0, 128);
+			texture_jobs = true;
+		}
+		else if (strcmp(arg, "-j") == 0 && i + 1 < argc && isdigit(argv[i + 1][0]))
+		{
+			settings.jobs = clamp(atoi(argv[++i]), 0, 128);
+			jobs = true;
+		}
+		else if (strcmp(arg, "-mc") == 0 && i + 1 < argc && !settings.mesh_cache)
+		{
+			settings.mesh_cache = argv[++i];
 		}
 		else if (strcmp(arg, "-noq") == 0)
 		{
@@ -1489,6 +1711,10 @@ int main(int argc, char** argv)
 		{
 			report = argv[++i];
 		}
+		else if (strcmp(arg, "-b") == 0 && i + 1 < argc && !batch)
+		{
+			batch = argv[++i];
+		}
 		else if (strcmp(arg, "-c") == 0)
 		{
 			settings.compress = true;
@@ -1555,10 +1781,11 @@ int main(int argc, char** argv)
 		return 0;
 	}
 
-	if (!input || !output || help)
+	if ((!batch && (!input || !output)) || (batch && (input || output)) || help)
 	{
 		fprintf(stderr, "gltfpack %s\n", getVersion().c_str());
 		fprintf(stderr, "Usage: gltfpack [options] -i input -o output\n");
+		fprintf(stderr, "       gltfpack [options] -b manifest\n");
 
 		if (help)
 		{
@@ -1574,7 +1801,7 @@ int main(int argc, char** argv)
 			fprintf(stderr, "\t-tl N: limit texture dimensions to N pixels (default: 0 = no limit)\n");
 			fprintf(stderr, "\t-tp: resize textures to nearest power of 2 to conform to WebGL1 restrictions\n");
 			fprintf(stderr, "\t-tfy: flip textures along Y axis during BasisU supercompression\n");
-			fprintf(stderr, "\t-tj N: use N threads when compressing textures\n");
+			fprintf(stderr, "\t-tj N: use N threads when compressing textures (default: share -j threads with mesh processing if specified, otherwise all cores)\n");
 			fprintf(stderr, "\t-tr: keep referring to original texture paths instead of copying/embedding images\n");
 			fprintf(stderr, "\tTexture classes:\n");
 			fprintf(stderr, "\t-tc C: use ETC1S when encoding textures of class C\n");
@@ -1608,6 +1835,7 @@ int main(int argc, char** argv)
 			fprintf(stderr, "\t-as N: use N-bit quantization for scale (default: 16; N should be between 1 and 24)\n");
 			fprintf(stderr, "\t-af N: resample animations at N Hz (default: 30)\n");
 			fprintf(stderr, "\t-ac: keep constant animation tracks even if they don't modify the node transform\n");
+			fprintf(stderr, "\t-ad: drop animation keyframes that can be reconstructed by interpolating neighboring keyframes\n");
 			fprintf(stderr, "\nScene:\n");
 			fprintf(stderr, "\t-kn: keep named nodes and meshes attached to named nodes so that named nodes can be transformed externally\n");
 			fprintf(stderr, "\t-km: keep named materials and disable named material merging\n");
@@ -1617,8 +1845,11 @@ int main(int argc, char** argv)
 			fprintf(stderr, "\nMiscellaneous:\n");
 			fprintf(stderr, "\t-cf: produce compressed gltf/glb files with fallback for loaders that don't support compression\n");
 			fprintf(stderr, "\t-noq: disable quantization; produces much larger glTF files with no extensions\n");
+			fprintf(stderr, "\t-j N: use N threads when processing meshes and animations (default: 1; 0 = use all cores)\n");
+			fprintf(stderr, "\t-mc dir: cache processed meshes in dir and reuse them when neither geometry nor processing settings change\n");
 			fprintf(stderr, "\t-v: verbose output (print version when used without other options)\n");
 			fprintf(stderr, "\t-r file: output a JSON report to file\n");
+			fprintf(stderr, "\t-b file: process all input/output pairs listed in file (one per line, - reads from stdin) using -j threads; -r outputs a timing report\n");
 			fprintf(stderr, "\t-h: display this help and exit\n");
 		}
 		else
@@ -1664,6 +1895,13 @@ int main(int argc, char** argv)
 		fprintf(stderr, "Warning: option -kn disables mesh merge (-mm) and mesh instancing (-mi) optimizations\n");
 	}
 
+	// texture encoding overlaps with mesh processing, so by default both share the -j thread budget; process() splits it between them
+	if (jobs && !texture_jobs)
+		settings.texture_jobs = -1;
+
+	if (batch)
+		return gltfpackBatch(batch, report, settings);
+
 	return gltfpack(input, output, report, settings);
 }
 #endif
@@ -1700,9 +1938,9 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* buffer, size_t size)
 	if (error)
 		return -1;
 
-	std::string json, bin, fallback;
-	size_t fallback_size = 0;
-	process(data, NULL, NULL, NULL, meshes, animations, settings, json, bin, fallback, fallback_size);
+	std::string json;
+	BinaryOutput bin = {}, fallback = {};
+	process(data, NULL, NULL, NULL, meshes, animations, settings, json, bin, fallback);
 
 	cgltf_free(data);
 
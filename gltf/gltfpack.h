@@ -18,10 +18,13 @@
 #include "../extern/cgltf.h"
 
 #include <assert.h>
+#include <stdio.h>
 
 #include <string>
 #include <vector>
 
+struct meshopt_EncodeContext;
+
 struct Attr
 {
 	float f[4];
@@ -79,7 +82,7 @@ struct Track
 
 	cgltf_interpolation_type interpolation;
 
-	std::vector<float> time; // empty for resampled or constant animations
+	std::vector<float> time; // empty for resampled or constant animations, unless keyframes were reduced
 	std::vector<Attr> data;
 };
 
@@ -128,6 +131,7 @@ struct Settings
 
 	int anim_freq;
 	bool anim_const;
+	bool anim_reduce;
 
 	bool keep_nodes;
 	bool keep_materials;
@@ -159,7 +163,7 @@ struct Settings
 	TextureMode texture_mode[TextureKind__Count];
 	int texture_quality[TextureKind__Count];
 
-	int texture_jobs;
+	int texture_jobs; // 0 = all cores, -1 = share jobs with mesh processing
 
 	bool quantize;
 
@@ -167,6 +171,10 @@ struct Settings
 	bool compressmore;
 	bool fallback;
 
+	int jobs;
+
+	const char* mesh_cache;
+
 	int verbose;
 };
 
@@ -291,8 +299,22 @@ struct BufferView
 	std::string data;
 
 	size_t bytes;
+	size_t raw_bytes;
+};
+
+// sequential binary output; file may be NULL, in which case only the size is tracked
+struct BinaryOutput
+{
+	FILE* file;
+	size_t size;
+	bool error;
 };
 
+std::string getVersion();
+
+int gltfpack(const char* input, const char* output, const char* report, Settings settings);
+int gltfpackBatch(const char* manifest, const char* report, Settings settings);
+
 std::string getTempPrefix();
 
 std::string getFullPath(const char* path, const char* base_path);
@@ -302,15 +324,31 @@ std::string getExtension(const char* path);
 bool readFile(const char* path, std::string& data);
 bool writeFile(const char* path, const std::string& data);
 void removeFile(const char* path);
+bool renameFile(const char* from, const char* to);
+
+void* mapFile(const char* path, size_t& size);
+void unmapFile(void* data);
+
+void writeBinary(BinaryOutput& output, const void* data, size_t size);
+void alignBinary(BinaryOutput& output, size_t alignment);
+bool copyFile(FILE* output, FILE* input);
 
 cgltf_data* parseObj(const char* path, std::vector<Mesh>& meshes, const char** error);
 cgltf_data* parseGltf(const char* path, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const char** error);
 
 cgltf_data* parseGlb(const void* buffer, size_t size, std::vector<Mesh>& meshes, std::vector<Animation>& animations, const char** error);
 
-void processAnimation(Animation& animation, const Settings& settings);
+int getJobCount(int jobs, size_t count);
+void parallelFor(size_t count, int jobs, void (*callback)(void* context, size_t index, int worker), void* context);
+
+void prepareAnimation(Animation& animation, const Settings& settings);
+void processAnimationTrack(Track& track, const Animation& animation, const Settings& settings);
 void processMesh(Mesh& mesh, const Settings& settings);
 
+void getMeshCacheKey(Mesh& mesh, const Settings& settings, uint64_t key[2]);
+bool readMeshCache(Mesh& mesh, const char* cache_path, const uint64_t key[2]);
+bool writeMeshCache(const Mesh& mesh, const char* cache_path, const uint64_t key[2], int worker);
+
 void debugSimplify(const Mesh& mesh, Mesh& kinds, Mesh& loops, float ratio, float error, bool attributes, bool quantize_tbn);
 void debugMeshlets(const Mesh& mesh, Mesh& meshlets, int max_vertices);
 
@@ -360,9 +398,9 @@ StreamFormat writeIndexStream(std::string& bin, const std::vector<unsigned int>&
 StreamFormat writeTimeStream(std::string& bin, const std::vector<float>& data);
 StreamFormat writeKeyframeStream(std::string& bin, cgltf_animation_path_type type, const std::vector<Attr>& data, const Settings& settings);
 
-void compressVertexStream(std::string& bin, const std::string& data, size_t count, size_t stride);
-void compressIndexStream(std::string& bin, const std::string& data, size_t count, size_t stride);
-void compressIndexSequence(std::string& bin, const std::string& data, size_t count, size_t stride);
+void compressVertexStream(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride);
+void compressIndexStream(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride);
+void compressIndexSequence(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride);
 
 size_t getBufferView(std::vector<BufferView>& views, BufferView::Kind kind, StreamFormat::Filter filter, BufferView::Compression compression, size_t stride, int variant = 0);
 
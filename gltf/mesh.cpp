@@ -830,24 +830,26 @@ static void optimizeMesh(Mesh& mesh, bool compressmore)
 
 	size_t vertex_count = mesh.streams[0].data.size();
 
-	if (compressmore)
-		meshopt_optimizeVertexCacheStrip(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), vertex_count);
-	else
-		meshopt_optimizeVertexCache(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), vertex_count);
-
-	std::vector<unsigned int> remap(vertex_count);
-	size_t unique_vertices = meshopt_optimizeVertexFetchRemap(&remap[0], &mesh.indices[0], mesh.indices.size(), vertex_count);
-	assert(unique_vertices <= vertex_count);
-
-	meshopt_remapIndexBuffer(&mesh.indices[0], &mesh.indices[0], mesh.indices.size(), &remap[0]);
+	// vertices are already deduplicated by reindexMesh, so the pipeline only needs to reorder them
+	std::vector<meshopt_Stream> streams(mesh.streams.size());
+	std::vector<void*> destinations(mesh.streams.size());
 
 	for (size_t i = 0; i < mesh.streams.size(); ++i)
 	{
 		assert(mesh.streams[i].data.size() == vertex_count);
 
-		meshopt_remapVertexBuffer(&mesh.streams[i].data[0], &mesh.streams[i].data[0], vertex_count, sizeof(Attr), &remap[0]);
-		mesh.streams[i].data.resize(unique_vertices);
+		meshopt_Stream stream = {&mesh.streams[i].data[0], sizeof(Attr), sizeof(Attr)};
+		streams[i] = stream;
+		destinations[i] = &mesh.streams[i].data[0];
 	}
+
+	unsigned int options = meshopt_OptimizeMeshSkipRemap | (compressmore ? meshopt_OptimizeMeshStrip : 0);
+
+	size_t unique_vertices = meshopt_optimizeMesh(&mesh.indices[0], &destinations[0], &mesh.indices[0], mesh.indices.size(), vertex_count, &streams[0], streams.size(), options, 0.f, NULL, NULL);
+	assert(unique_vertices <= vertex_count);
+
+	for (size_t i = 0; i < mesh.streams.size(); ++i)
+		mesh.streams[i].data.resize(unique_vertices);
 }
 
 struct BoneInfluence
@@ -0,0 +1,61 @@
+// This file is part of gltfpack; see gltfpack.h for version/license details
+#include "gltfpack.h"
+
+#ifndef __wasi__
+#include <atomic>
+#include <thread>
+#endif
+
+int getJobCount(int jobs, size_t count)
+{
+#ifdef __wasi__
+	(void)jobs;
+	(void)count;
+	return 1;
+#else
+	unsigned int result = jobs == 0 ? std::thread::hardware_concurrency() : unsigned(jobs);
+
+	if (result > count)
+		result = unsigned(count);
+
+	return result < 1 ? 1 : int(result);
+#endif
+}
+
+void parallelFor(size_t count, int jobs, void (*callback)(void* context, size_t index, int worker), void* context)
+{
+	int thread_count = getJobCount(jobs, count);
+
+	if (thread_count <= 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+			callback(context, i, 0);
+
+		return;
+	}
+
+#ifndef __wasi__
+	// items are picked up dynamically since their cost varies wildly (e.g. meshes of different sizes); since every item only writes to its own output, results don't depend on the schedule
+	// worker indices are in [0, getJobCount(jobs, count)) and can be used to index per-thread scratch state
+	std::atomic<size_t> next(0);
+
+	struct Worker
+	{
+		static void run(std::atomic<size_t>* next, size_t count, void (*callback)(void*, size_t, int), void* context, int worker)
+		{
+			for (size_t i = (*next)++; i < count; i = (*next)++)
+				callback(context, i, worker);
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < thread_count; ++i)
+		threads.push_back(std::thread(Worker::run, &next, count, callback, context, i));
+
+	Worker::run(&next, count, callback, context, 0);
+
+	for (size_t i = 0; i < threads.size(); ++i)
+		threads[i].join();
+#endif
+}
@@ -459,12 +459,43 @@ static bool needsDummyBuffers(cgltf_data* data)
 	return false;
 }
 
+static cgltf_result readFileMapped(const cgltf_memory_options* memory_options, const cgltf_file_options* file_options, const char* path, cgltf_size* size, void** data)
+{
+	(void)memory_options;
+	(void)file_options;
+
+	size_t length = size ? *size : 0;
+	void* result = mapFile(path, length);
+
+	if (!result)
+		return cgltf_result_io_error;
+
+	if (size)
+		*size = length;
+	if (data)
+		*data = result;
+
+	return cgltf_result_success;
+}
+
+static void releaseFileMapped(const cgltf_memory_options* memory_options, const cgltf_file_options* file_options, void* data)
+{
+	(void)memory_options;
+	(void)file_options;
+
+	unmapFile(data);
+}
+
 static void freeFile(cgltf_data* data)
 {
 	data->json = NULL;
 	data->bin = NULL;
 
-	free(data->file_data);
+	if (data->file.release)
+		data->file.release(&data->memory, &data->file, data->file_data);
+	else
+		free(data->file_data);
+
 	data->file_data = NULL;
 }
 
@@ -502,12 +533,15 @@ static bool freeUnusedBuffers(cgltf_data* data)
 
 		if (!used[i] && buffer.data)
 		{
-			if (buffer.data != data->bin)
-				free(buffer.data);
-			else
+			if (buffer.data == data->bin)
 				free_bin = true;
+			else if (buffer.data_free_method == cgltf_data_free_method_file_release && data->file.release)
+				data->file.release(&data->memory, &data->file, buffer.data);
+			else if (buffer.data_free_method != cgltf_data_free_method_none)
+				free(buffer.data);
 
 			buffer.data = NULL;
+			buffer.data_free_method = cgltf_data_free_method_none;
 		}
 	}
 
@@ -618,7 +652,11 @@ cgltf_data* parseGltf(const char* path, std::vector<Mesh>& meshes, std::vector<A
 {
 	cgltf_data* data = NULL;
 
+	// input files and external buffers are memory mapped, so their contents are paged in on demand and can be dropped by the OS under memory pressure
 	cgltf_options options = {};
+	options.file.read = readFileMapped;
+	options.file.release = releaseFileMapped;
+
 	cgltf_result result = cgltf_parse_file(&options, path, &data);
 
 	if (result == cgltf_result_success && !data->bin)
@@ -746,45 +746,32 @@ StreamFormat writeKeyframeStream(std::string& bin, cgltf_animation_path_type typ
 	}
 }
 
-void compressVertexStream(std::string& bin, const std::string& data, size_t count, size_t stride)
+void compressVertexStream(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride)
 {
 	assert(data.size() == count * stride);
 
-	std::vector<unsigned char> compressed(meshopt_encodeVertexBufferBound(count, stride));
-	size_t size = meshopt_encodeVertexBuffer(&compressed[0], compressed.size(), data.c_str(), count, stride);
+	size_t size = meshopt_encodeVertexBufferContext(&context, data.c_str(), count, stride);
 
-	bin.append(reinterpret_cast<const char*>(&compressed[0]), size);
+	bin.append(reinterpret_cast<const char*>(context.buffer), size);
 }
 
-void compressIndexStream(std::string& bin, const std::string& data, size_t count, size_t stride)
+void compressIndexStream(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride)
 {
 	assert(stride == 2 || stride == 4);
 	assert(data.size() == count * stride);
 	assert(count % 3 == 0);
 
-	std::vector<unsigned char> compressed(meshopt_encodeIndexBufferBound(count, count));
-	size_t size = 0;
+	size_t size = meshopt_encodeIndexBufferContext(&context, data.c_str(), count, stride);
 
-	if (stride == 2)
-		size = meshopt_encodeIndexBuffer(&compressed[0], compressed.size(), reinterpret_cast<const uint16_t*>(data.c_str()), count);
-	else
-		size = meshopt_encodeIndexBuffer(&compressed[0], compressed.size(), reinterpret_cast<const uint32_t*>(data.c_str()), count);
-
-	bin.append(reinterpret_cast<const char*>(&compressed[0]), size);
+	bin.append(reinterpret_cast<const char*>(context.buffer), size);
 }
 
-void compressIndexSequence(std::string& bin, const std::string& data, size_t count, size_t stride)
+void compressIndexSequence(meshopt_EncodeContext& context, std::string& bin, const std::string& data, size_t count, size_t stride)
 {
 	assert(stride == 2 || stride == 4);
 	assert(data.size() == count * stride);
 
-	std::vector<unsigned char> compressed(meshopt_encodeIndexSequenceBound(count, count));
-	size_t size = 0;
-
-	if (stride == 2)
-		size = meshopt_encodeIndexSequence(&compressed[0], compressed.size(), reinterpret_cast<const uint16_t*>(data.c_str()), count);
-	else
-		size = meshopt_encodeIndexSequence(&compressed[0], compressed.size(), reinterpret_cast<const uint32_t*>(data.c_str()), count);
+	size_t size = meshopt_encodeIndexSequenceContext(&context, data.c_str(), count, stride);
 
-	bin.append(reinterpret_cast<const char*>(&compressed[0]), size);
+	bin.append(reinterpret_cast<const char*>(context.buffer), size);
 }
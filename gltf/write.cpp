@@ -1043,13 +1043,8 @@ void writeMeshGeometry(std::string& json, std::vector<BufferView>& views, std::s
 	}
 }
 
-static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, float mint, int frames, float period, const Settings& settings)
+static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, const std::vector<float>& time, const Settings& settings)
 {
-	std::vector<float> time(frames);
-
-	for (int j = 0; j < frames; ++j)
-		time[j] = mint + float(j) * period;
-
 	std::string scratch;
 	StreamFormat format = writeTimeStream(scratch, time);
 	BufferView::Compression compression = settings.compress ? BufferView::Compression_Attribute : BufferView::Compression_None;
@@ -1059,13 +1054,23 @@ static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& js
 	views[view].data += scratch;
 
 	comma(json_accessors);
-	writeAccessor(json_accessors, view, offset, cgltf_type_scalar, format.component_type, format.normalized, frames, &time.front(), &time.back(), 1);
+	writeAccessor(json_accessors, view, offset, cgltf_type_scalar, format.component_type, format.normalized, time.size(), &time.front(), &time.back(), 1);
 
 	size_t time_accr = accr_offset++;
 
 	return time_accr;
 }
 
+static size_t writeAnimationTime(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, float mint, int frames, float period, const Settings& settings)
+{
+	std::vector<float> time(frames);
+
+	for (int j = 0; j < frames; ++j)
+		time[j] = mint + float(j) * period;
+
+	return writeAnimationTime(views, json_accessors, accr_offset, time, settings);
+}
+
 size_t writeJointBindMatrices(std::vector<BufferView>& views, std::string& json_accessors, size_t& accr_offset, const cgltf_skin& skin, const QuantizationPosition& qp, const Settings& settings)
 {
 	std::string scratch;
@@ -1362,19 +1367,23 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 
 	bool needs_time = false;
 	bool needs_pose = false;
+	bool has_keys = false;
 
 	for (size_t j = 0; j < tracks.size(); ++j)
 	{
 		const Track& track = *tracks[j];
 
-		assert(track.time.empty());
-		assert(track.data.size() == track.components * (track.constant ? 1 : animation.frames));
+		// tracks with reduced keyframes keep the time of every keyframe; other tracks are constant or sampled at every frame
+		assert(track.time.empty() || !track.constant);
+		assert(track.data.size() == track.components * (track.constant ? 1 : track.time.empty() ? animation.frames : track.time.size()));
 
-		needs_time = needs_time || !track.constant;
+		needs_time = needs_time || (!track.constant && track.time.empty());
 		needs_pose = needs_pose || track.constant;
+		has_keys = has_keys || !track.time.empty();
 	}
 
-	bool needs_range = needs_pose && !needs_time && animation.frames > 1;
+	// reduced tracks always keep the last keyframe, so they establish the animation length on their own
+	bool needs_range = needs_pose && !needs_time && !has_keys && animation.frames > 1;
 
 	needs_pose = needs_pose && !(needs_range && tracks.size() == 1);
 
@@ -1390,6 +1399,9 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 	std::string json_samplers;
 	std::string json_channels;
 
+	// reduced tracks often end up with identical keyframe times, for example when several joints move linearly; these share the time accessor
+	std::vector<std::pair<const std::vector<float>*, size_t> > keys_accr;
+
 	size_t track_offset = 0;
 
 	for (size_t j = 0; j < tracks.size(); ++j)
@@ -1408,6 +1420,20 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 			scratch += scratch;
 		}
 
+		size_t input_accr = range ? range_accr : (track.constant ? pose_accr : time_accr);
+
+		if (!track.time.empty())
+		{
+			size_t k = 0;
+			while (k < keys_accr.size() && *keys_accr[k].first != track.time)
+				++k;
+
+			if (k == keys_accr.size())
+				keys_accr.push_back(std::make_pair(&track.time, writeAnimationTime(views, json_accessors, accr_offset, track.time, settings)));
+
+			input_accr = keys_accr[k].second;
+		}
+
 		BufferView::Compression compression = settings.compress && track.path != cgltf_animation_path_type_weights ? BufferView::Compression_Attribute : BufferView::Compression_None;
 
 		size_t view = getBufferView(views, BufferView::Kind_Keyframe, format.filter, compression, format.stride, track.path);
@@ -1421,7 +1447,7 @@ void writeAnimation(std::string& json, std::vector<BufferView>& views, std::stri
 
 		comma(json_samplers);
 		append(json_samplers, "{\"input\":");
-		append(json_samplers, range ? range_accr : (track.constant ? pose_accr : time_accr));
+		append(json_samplers, input_accr);
 		append(json_samplers, ",\"output\":");
 		append(json_samplers, data_accr);
 		if (track.interpolation == cgltf_interpolation_type_step)
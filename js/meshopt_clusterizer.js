@@ -217,31 +217,150 @@ var MeshoptClusterizer = (function () {
 		return result;
 	}
 
+	function buildMeshletsArgs(indices, vertex_positions, vertex_positions_stride, max_vertices, max_triangles, cone_weight) {
+		assert(indices.length % 3 == 0);
+		assert(vertex_positions instanceof Float32Array);
+		assert(vertex_positions.length % vertex_positions_stride == 0);
+		assert(vertex_positions_stride >= 3);
+		assert(max_vertices <= 255 || max_vertices > 0);
+		assert(max_triangles <= 512);
+		assert(max_triangles % 4 == 0);
+
+		cone_weight = cone_weight || 0.0;
+
+		var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
+
+		return [
+			indices32,
+			vertex_positions,
+			vertex_positions.length / vertex_positions_stride,
+			vertex_positions_stride * 4,
+			max_vertices,
+			max_triangles,
+			cone_weight,
+		];
+	}
+
+	var workers = [];
+	var requestId = 0;
+
+	function createWorker(url) {
+		var worker = {
+			object: new Worker(url),
+			pending: 0,
+			requests: {},
+		};
+
+		worker.object.onmessage = function (event) {
+			var data = event.data;
+
+			worker.pending -= 1;
+			worker.requests[data.id][data.action](data.value);
+			delete worker.requests[data.id];
+		};
+
+		return worker;
+	}
+
+	function initWorkers(count) {
+		var source =
+			'var instance; self.ready = WebAssembly.instantiate(new Uint8Array([' +
+			new Uint8Array(unpack(wasm)) +
+			']), {})' +
+			'.then(function(result) { instance = result.instance; instance.exports.__wasm_call_ctors(); });' +
+			'self.onmessage = ' +
+			workerProcess.name +
+			';' +
+			'var MESHLET_SIZE = ' +
+			MESHLET_SIZE +
+			';' +
+			bytes.toString() +
+			buildMeshlets.toString() +
+			transferList.toString() +
+			workerProcess.toString();
+
+		var blob = new Blob([source], { type: 'text/javascript' });
+		var url = URL.createObjectURL(blob);
+
+		for (var i = workers.length; i < count; ++i) {
+			workers[i] = createWorker(url);
+		}
+
+		for (var i = count; i < workers.length; ++i) {
+			workers[i].object.postMessage({});
+		}
+
+		workers.length = count;
+
+		URL.revokeObjectURL(url);
+	}
+
+	function transferList(value) {
+		// results only contain freshly allocated arrays, so their buffers can be transferred back instead of copied
+		var result = [];
+		for (var key in value) {
+			if (ArrayBuffer.isView(value[key])) {
+				result.push(value[key].buffer);
+			}
+		}
+		return result;
+	}
+
+	function workerProcess(event) {
+		var data = event.data;
+		if (!data.id) {
+			return self.close();
+		}
+		self.ready.then(function () {
+			try {
+				var args = data.fun ? [instance.exports[data.fun]].concat(data.args) : data.args;
+				var result = self[data.name].apply(null, args);
+				self.postMessage({ id: data.id, action: 'resolve', value: result }, transferList(result));
+			} catch (error) {
+				self.postMessage({ id: data.id, action: 'reject', value: error });
+			}
+		});
+	}
+
+	var functions = {
+		buildMeshlets: buildMeshlets,
+	};
+
+	function runAsync(name, fun, args) {
+		if (workers.length == 0) {
+			return ready.then(function () {
+				return functions[name].apply(null, fun ? [instance.exports[fun]].concat(args) : args);
+			});
+		}
+
+		// each call runs on the least loaded worker; inputs are copied to the worker unless they are views into shared memory, and are always copied into Wasm memory
+		var worker = workers[0];
+		for (var i = 1; i < workers.length; ++i) {
+			if (workers[i].pending < worker.pending) {
+				worker = workers[i];
+			}
+		}
+
+		return new Promise(function (resolve, reject) {
+			var id = ++requestId;
+
+			worker.pending += 1;
+			worker.requests[id] = { resolve: resolve, reject: reject };
+			worker.object.postMessage({ id: id, name: name, fun: fun, args: args });
+		});
+	}
+
 	return {
 		ready: ready,
 		supported: true,
 		buildMeshlets: function (indices, vertex_positions, vertex_positions_stride, max_vertices, max_triangles, cone_weight) {
-			assert(indices.length % 3 == 0);
-			assert(vertex_positions instanceof Float32Array);
-			assert(vertex_positions.length % vertex_positions_stride == 0);
-			assert(vertex_positions_stride >= 3);
-			assert(max_vertices <= 255 || max_vertices > 0);
-			assert(max_triangles <= 512);
-			assert(max_triangles % 4 == 0);
-
-			cone_weight = cone_weight || 0.0;
-
-			var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
-
-			return buildMeshlets(
-				indices32,
-				vertex_positions,
-				vertex_positions.length / vertex_positions_stride,
-				vertex_positions_stride * 4,
-				max_vertices,
-				max_triangles,
-				cone_weight
-			);
+			return buildMeshlets.apply(null, buildMeshletsArgs(indices, vertex_positions, vertex_positions_stride, max_vertices, max_triangles, cone_weight));
+		},
+		useWorkers: function (count) {
+			initWorkers(count);
+		},
+		buildMeshletsAsync: function (indices, vertex_positions, vertex_positions_stride, max_vertices, max_triangles, cone_weight) {
+			return runAsync('buildMeshlets', null, buildMeshletsArgs(indices, vertex_positions, vertex_positions_stride, max_vertices, max_triangles, cone_weight));
 		},
 		computeClusterBounds: function (indices, vertex_positions, vertex_positions_stride) {
 			assert(indices.length % 3 == 0);
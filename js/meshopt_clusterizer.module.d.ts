@@ -39,6 +39,15 @@ export const MeshoptClusterizer: {
 		max_triangles: number,
 		cone_weight?: number
 	) => MeshletBuffers;
+	useWorkers: (count: number) => void;
+	buildMeshletsAsync: (
+		indices: Uint32Array,
+		vertex_positions: Float32Array,
+		vertex_positions_stride: number,
+		max_vertices: number,
+		max_triangles: number,
+		cone_weight?: number
+	) => Promise<MeshletBuffers>;
 	computeClusterBounds: (indices: Uint32Array, vertex_positions: Float32Array, vertex_positions_stride: number) => Bounds;
 	computeMeshletBounds: (buffers: MeshletBuffers, vertex_positions: Float32Array, vertex_positions_stride: number) => Bounds[];
 	extractMeshlet: (buffers: MeshletBuffers, index: number) => Meshlet;
@@ -62,6 +62,19 @@ const tests = {
 		}
 	},
 
+	buildMeshletsAsync: function () {
+		const maxVertices = 4;
+		const expected = clusterizer.buildMeshlets(cubeWithNormals.indices, cubeWithNormals.vertices, cubeWithNormals.vertexStride, maxVertices, 512);
+
+		clusterizer
+			.buildMeshletsAsync(cubeWithNormals.indices, cubeWithNormals.vertices, cubeWithNormals.vertexStride, maxVertices, 512)
+			.then(function (buffers) {
+				assert.equal(buffers.meshletCount, expected.meshletCount);
+				assert.deepStrictEqual(buffers.meshlets, expected.meshlets);
+				assert.deepStrictEqual(buffers.vertices, expected.vertices);
+			});
+	},
+
 	computeClusterBounds: function () {
 		for (let i = 0; i < 6; ++i) {
 			const indexOffset = i * 6;
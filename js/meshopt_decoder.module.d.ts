@@ -9,7 +9,12 @@ export const MeshoptDecoder: {
 	decodeIndexSequence: (target: Uint8Array, count: number, size: number, source: Uint8Array) => void;
 
 	decodeGltfBuffer: (target: Uint8Array, count: number, size: number, source: Uint8Array, mode: string, filter?: string) => void;
+	decodeGltfBuffers: (buffers: { target: Uint8Array; count: number; size: number; source: Uint8Array; mode: string; filter?: string }[]) => void;
 
 	useWorkers: (count: number) => void;
 	decodeGltfBufferAsync: (count: number, size: number, source: Uint8Array, mode: string, filter?: string) => Promise<Uint8Array>;
+	decodeGltfBuffersAsync: (buffers: { count: number; size: number; source: Uint8Array; mode: string; filter?: string }[]) => Promise<Uint8Array[]>;
+
+	decodeGltfBufferShared: (target: Uint8Array, count: number, size: number, source: Uint8Array, mode: string, filter?: string) => Promise<void>;
+	decodeGltfBuffersShared: (buffers: { target: Uint8Array; count: number; size: number; source: Uint8Array; mode: string; filter?: string }[]) => Promise<void>;
 };
@@ -63,6 +63,35 @@ var MeshoptDecoder = (function () {
 		}
 	}
 
+	function decodeBatch(instance, items) {
+		var sbrk = instance.exports.sbrk;
+		var tsize = 0;
+		var ssize = 0;
+		for (var i = 0; i < items.length; ++i) {
+			tsize = Math.max(tsize, ((items[i].count + 3) & ~3) * items[i].size);
+			ssize = Math.max(ssize, items[i].source.length);
+		}
+		// all items share the same scratch space to avoid growing memory for every item
+		var tp = sbrk(tsize);
+		var sp = sbrk(ssize);
+		var heap = new Uint8Array(instance.exports.memory.buffer);
+		var res = 0;
+		for (var i = 0; i < items.length && res == 0; ++i) {
+			var item = items[i];
+			var filter = instance.exports[item.filter];
+			heap.set(item.source, sp);
+			res = instance.exports[item.mode](tp, item.count, item.size, sp, item.source.length);
+			if (res == 0 && filter) {
+				filter(tp, (item.count + 3) & ~3, item.size);
+			}
+			item.target.set(heap.subarray(tp, tp + item.count * item.size));
+		}
+		sbrk(tp - sbrk(0));
+		if (res != 0) {
+			throw new Error('Malformed buffer data: ' + res);
+		}
+	}
+
 	var filters = {
 		NONE: '',
 		OCTAHEDRAL: 'meshopt_decodeFilterOct',
@@ -76,6 +105,85 @@ var MeshoptDecoder = (function () {
 		INDICES: 'meshopt_decodeIndexSequence',
 	};
 
+	function isShared(view) {
+		return typeof SharedArrayBuffer !== 'undefined' && view.buffer instanceof SharedArrayBuffer;
+	}
+
+	function readU32(data, offset) {
+		return (data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) | (data[offset + 3] << 24)) >>> 0;
+	}
+
+	function sharedItems(buffers) {
+		var items = [];
+
+		for (var i = 0; i < buffers.length; ++i) {
+			var buffer = buffers[i];
+			var source = buffer.source;
+
+			// chunked vertex buffers (see meshopt_encodeVertexBufferChunked) consist of independent vertex streams, which are decoded as separate items
+			if (buffer.mode == 'ATTRIBUTES' && source.length > 0 && (source[0] & 0xf0) == 0xb0) {
+				var chunk = source.length >= 5 ? readU32(source, 1) : 0;
+				var chunks = chunk ? Math.ceil(buffer.count / chunk) : 0;
+				var table = 5 + chunks * 4;
+
+				if ((source[0] & 0x0f) != 0 || chunk == 0 || source.length < table) {
+					throw new Error('Malformed buffer data: -1');
+				}
+
+				var begin = 0;
+
+				for (var j = 0; j < chunks; ++j) {
+					var end = readU32(source, 5 + j * 4);
+					if (end < begin || table + end > source.length) {
+						throw new Error('Malformed buffer data: -2');
+					}
+
+					var offset = j * chunk;
+					var count = Math.min(chunk, buffer.count - offset);
+
+					items.push({
+						target: buffer.target.subarray(offset * buffer.size, (offset + count) * buffer.size),
+						count: count,
+						size: buffer.size,
+						source: source.subarray(table + begin, table + end),
+						mode: decoders.ATTRIBUTES,
+						filter: filters[buffer.filter],
+					});
+
+					begin = end;
+				}
+
+				if (table + begin != source.length) {
+					throw new Error('Malformed buffer data: -3');
+				}
+			} else {
+				items.push({
+					target: buffer.target.subarray(0, buffer.count * buffer.size),
+					count: buffer.count,
+					size: buffer.size,
+					source: source,
+					mode: decoders[buffer.mode],
+					filter: filters[buffer.filter],
+				});
+			}
+		}
+
+		return items;
+	}
+
+	function batchItems(buffers) {
+		return buffers.map(function (buffer) {
+			return {
+				target: buffer.target,
+				count: buffer.count,
+				size: buffer.size,
+				source: buffer.source,
+				mode: decoders[buffer.mode],
+				filter: filters[buffer.filter],
+			};
+		});
+	}
+
 	var workers = [];
 	var requestId = 0;
 
@@ -106,7 +214,7 @@ var MeshoptDecoder = (function () {
 			'self.onmessage = ' +
 			workerProcess.name +
 			';' +
-			decode.toString() +
+			decodeBatch.toString() +
 			workerProcess.toString();
 
 		var blob = new Blob([source], { type: 'text/javascript' });
@@ -125,22 +233,103 @@ var MeshoptDecoder = (function () {
 		URL.revokeObjectURL(url);
 	}
 
-	function decodeWorker(count, size, source, mode, filter) {
-		var worker = workers[0];
+	function decodeWorker(worker, items) {
+		return new Promise(function (resolve, reject) {
+			var count = 0;
+			var messages = [];
+			var transfer = [];
+
+			for (var i = 0; i < items.length; ++i) {
+				var item = items[i];
 
-		for (var i = 1; i < workers.length; ++i) {
-			if (workers[i].pending < worker.pending) {
-				worker = workers[i];
+				// views into shared memory are visible to the worker directly; other sources are copied so that the copy can be transferred
+				var data = isShared(item.source) ? item.source : new Uint8Array(item.source);
+
+				count += item.count;
+				messages.push({ count: item.count, size: item.size, source: data, target: item.target, mode: item.mode, filter: item.filter });
+
+				if (data !== item.source) {
+					transfer.push(data.buffer);
+				}
 			}
-		}
 
-		return new Promise(function (resolve, reject) {
-			var data = new Uint8Array(source);
 			var id = ++requestId;
 
 			worker.pending += count;
 			worker.requests[id] = { resolve: resolve, reject: reject };
-			worker.object.postMessage({ id: id, count: count, size: size, source: data, mode: mode, filter: filter }, [data.buffer]);
+			worker.object.postMessage({ id: id, count: count, items: messages }, transfer);
+		});
+	}
+
+	function decodeWorkerBatch(items) {
+		// assign largest items first, each to the least loaded worker, to balance the work across workers
+		var order = items.map(function (item, index) {
+			return index;
+		});
+
+		order.sort(function (a, b) {
+			return items[b].source.length - items[a].source.length;
+		});
+
+		var pending = workers.map(function (worker) {
+			return worker.pending;
+		});
+		var batches = workers.map(function () {
+			return [];
+		});
+
+		for (var i = 0; i < order.length; ++i) {
+			var best = 0;
+
+			for (var j = 1; j < workers.length; ++j) {
+				if (pending[j] < pending[best]) {
+					best = j;
+				}
+			}
+
+			pending[best] += items[order[i]].count;
+			batches[best].push(order[i]);
+		}
+
+		var results = new Array(items.length);
+
+		return Promise.all(
+			batches.map(function (batch, index) {
+				if (batch.length == 0) {
+					return;
+				}
+
+				var subset = batch.map(function (item) {
+					return items[item];
+				});
+
+				return decodeWorker(workers[index], subset).then(function (targets) {
+					for (var i = 0; i < batch.length; ++i) {
+						results[batch[i]] = targets[i];
+					}
+				});
+			})
+		).then(function () {
+			return results;
+		});
+	}
+
+	function decodeShared(buffers) {
+		return ready.then(function () {
+			var items = sharedItems(buffers);
+
+			if (workers.length > 0) {
+				for (var i = 0; i < items.length; ++i) {
+					if (!isShared(items[i].target)) {
+						throw new Error('Target must be a view into SharedArrayBuffer when using workers');
+					}
+				}
+
+				// chunks of the same buffer may be assigned to different workers; each worker writes its own range of the shared target
+				return decodeWorkerBatch(items).then(function () {});
+			}
+
+			decodeBatch(instance, items);
 		});
 	}
 
@@ -151,9 +340,21 @@ var MeshoptDecoder = (function () {
 		}
 		self.ready.then(function (instance) {
 			try {
-				var target = new Uint8Array(data.count * data.size);
-				decode(instance, instance.exports[data.mode], target, data.count, data.size, data.source, instance.exports[data.filter]);
-				self.postMessage({ id: data.id, count: data.count, action: 'resolve', value: target }, [target.buffer]);
+				var targets = [];
+				var transfer = [];
+				for (var i = 0; i < data.items.length; ++i) {
+					var item = data.items[i];
+					// shared targets are decoded in place and don't need to be sent back
+					if (item.target) {
+						targets.push(null);
+					} else {
+						item.target = new Uint8Array(item.count * item.size);
+						targets.push(item.target);
+						transfer.push(item.target.buffer);
+					}
+				}
+				decodeBatch(instance, data.items);
+				self.postMessage({ id: data.id, count: data.count, action: 'resolve', value: targets }, transfer);
 			} catch (error) {
 				self.postMessage({ id: data.id, count: data.count, action: 'reject', value: error });
 			}
@@ -178,9 +379,16 @@ var MeshoptDecoder = (function () {
 		decodeGltfBuffer: function (target, count, size, source, mode, filter) {
 			decode(instance, instance.exports[decoders[mode]], target, count, size, source, instance.exports[filters[filter]]);
 		},
+		decodeGltfBuffers: function (buffers) {
+			decodeBatch(instance, batchItems(buffers));
+		},
 		decodeGltfBufferAsync: function (count, size, source, mode, filter) {
 			if (workers.length > 0) {
-				return decodeWorker(count, size, source, decoders[mode], filters[filter]);
+				var items = [{ count: count, size: size, source: source, mode: decoders[mode], filter: filters[filter] }];
+
+				return decodeWorkerBatch(items).then(function (targets) {
+					return targets[0];
+				});
 			}
 
 			return ready.then(function () {
@@ -189,6 +397,29 @@ var MeshoptDecoder = (function () {
 				return target;
 			});
 		},
+		decodeGltfBuffersAsync: function (buffers) {
+			var items = batchItems(buffers);
+
+			if (workers.length > 0) {
+				return decodeWorkerBatch(items);
+			}
+
+			return ready.then(function () {
+				for (var i = 0; i < items.length; ++i) {
+					items[i].target = new Uint8Array(items[i].count * items[i].size);
+				}
+				decodeBatch(instance, items);
+				return items.map(function (item) {
+					return item.target;
+				});
+			});
+		},
+		decodeGltfBufferShared: function (target, count, size, source, mode, filter) {
+			return decodeShared([{ target: target, count: count, size: size, source: source, mode: mode, filter: filter }]);
+		},
+		decodeGltfBuffersShared: function (buffers) {
+			return decodeShared(buffers);
+		},
 	};
 })();
 
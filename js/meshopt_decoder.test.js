@@ -238,6 +238,103 @@ var tests = {
 			assert.deepStrictEqual(result, expected);
 		});
 	},
+
+	decodeGltfBuffers: function () {
+		var encoded = new Uint8Array([
+			0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00,
+			0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		]);
+
+		var expected = new Uint8Array([
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 44, 1, 44, 1, 0, 0, 0,
+			0, 244, 1, 244, 1,
+		]);
+
+		var encodedIndices = new Uint8Array([
+			0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98,
+			0x01, 0x69, 0x00, 0x00,
+		]);
+
+		var expectedIndices = new Uint16Array([0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9]);
+
+		var result = new Uint8Array(expected.length);
+		var resultIndices = new Uint16Array(expectedIndices.length);
+
+		decoder.decodeGltfBuffers([
+			{ target: result, count: 4, size: 12, source: encoded, mode: 'ATTRIBUTES' },
+			{ target: new Uint8Array(resultIndices.buffer), count: 12, size: 2, source: encodedIndices, mode: 'TRIANGLES' },
+		]);
+
+		assert.deepStrictEqual(result, expected);
+		assert.deepStrictEqual(resultIndices, expectedIndices);
+	},
+
+	decodeGltfBuffersAsync: function () {
+		var encoded = new Uint8Array([
+			0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00,
+			0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		]);
+
+		var expected = new Uint8Array([
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 44, 1, 44, 1, 0, 0, 0,
+			0, 244, 1, 244, 1,
+		]);
+
+		var encodedIndices = new Uint8Array([
+			0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98,
+			0x01, 0x69, 0x00, 0x00,
+		]);
+
+		var expectedIndices = new Uint16Array([0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9]);
+
+		decoder
+			.decodeGltfBuffersAsync([
+				{ count: 4, size: 12, source: encoded, mode: 'ATTRIBUTES' },
+				{ count: 12, size: 2, source: encodedIndices, mode: 'TRIANGLES' },
+			])
+			.then(function (results) {
+				assert.deepStrictEqual(results[0], expected);
+				assert.deepStrictEqual(new Uint16Array(results[1].buffer), expectedIndices);
+			});
+	},
+
+	decodeGltfBufferShared: function () {
+		var encoded = new Uint8Array([
+			0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00,
+			0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		]);
+
+		var expected = new Uint8Array([
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 0, 0, 0, 0, 44, 1, 0, 0, 0, 0, 0, 0, 244, 1, 44, 1, 44, 1, 0, 0, 0,
+			0, 244, 1, 244, 1,
+		]);
+
+		// chunked vertex buffer with two chunks of 4 vertices each
+		var header = new Uint8Array(13);
+		var view = new DataView(header.buffer);
+		header[0] = 0xb0;
+		view.setUint32(1, 4, true);
+		view.setUint32(5, encoded.length, true);
+		view.setUint32(9, encoded.length * 2, true);
+
+		var source = new Uint8Array(new SharedArrayBuffer(header.length + encoded.length * 2));
+		source.set(header, 0);
+		source.set(encoded, header.length);
+		source.set(encoded, header.length + encoded.length);
+
+		var target = new Uint8Array(new SharedArrayBuffer(expected.length * 2));
+
+		decoder.decodeGltfBufferShared(target, 8, 12, source, /* mode= */ 'ATTRIBUTES').then(function () {
+			assert.deepStrictEqual(target.slice(0, expected.length), expected);
+			assert.deepStrictEqual(target.slice(expected.length), expected);
+		});
+	},
 };
 
 decoder.ready.then(() => {
@@ -201,6 +201,210 @@ var MeshoptSimplifier = (function () {
 		_InternalDebug: 1 << 30, // internal, don't use!
 	};
 
+	function simplifyArgs(indices, vertex_positions, vertex_positions_stride, target_index_count, target_error, flags, experimental) {
+		assert(
+			indices instanceof Uint32Array || indices instanceof Int32Array || indices instanceof Uint16Array || indices instanceof Int16Array
+		);
+		assert(indices.length % 3 == 0);
+		assert(vertex_positions instanceof Float32Array);
+		assert(vertex_positions.length % vertex_positions_stride == 0);
+		assert(vertex_positions_stride >= 3);
+		assert(target_index_count >= 0 && target_index_count <= indices.length);
+		assert(target_index_count % 3 == 0);
+		assert(target_error >= 0);
+
+		var options = 0;
+		for (var i = 0; i < (flags ? flags.length : 0); ++i) {
+			assert(flags[i] in simplifyOptions);
+			assert(experimental || flags[i] != 'Prune'); // set useExperimentalFeatures to use experimental flags like Prune
+			options |= simplifyOptions[flags[i]];
+		}
+
+		var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
+		return [
+			indices32,
+			indices.length,
+			vertex_positions,
+			vertex_positions.length / vertex_positions_stride,
+			vertex_positions_stride * 4,
+			target_index_count,
+			target_error,
+			options,
+		];
+	}
+
+	function simplifyAttrArgs(
+		indices,
+		vertex_positions,
+		vertex_positions_stride,
+		vertex_attributes,
+		vertex_attributes_stride,
+		attribute_weights,
+		vertex_lock,
+		target_index_count,
+		target_error,
+		flags,
+		experimental
+	) {
+		assert(experimental); // set useExperimentalFeatures to use this; note that this function is experimental and may change interface in a way that will require revising calling code
+		assert(
+			indices instanceof Uint32Array || indices instanceof Int32Array || indices instanceof Uint16Array || indices instanceof Int16Array
+		);
+		assert(indices.length % 3 == 0);
+		assert(vertex_positions instanceof Float32Array);
+		assert(vertex_positions.length % vertex_positions_stride == 0);
+		assert(vertex_positions_stride >= 3);
+		assert(vertex_attributes instanceof Float32Array);
+		assert(vertex_attributes.length % vertex_attributes_stride == 0);
+		assert(vertex_attributes_stride >= 0);
+		assert(vertex_lock == null || vertex_lock instanceof Uint8Array);
+		assert(vertex_lock == null || vertex_lock.length == vertex_positions.length / vertex_positions_stride);
+		assert(target_index_count >= 0 && target_index_count <= indices.length);
+		assert(target_index_count % 3 == 0);
+		assert(target_error >= 0);
+		assert(Array.isArray(attribute_weights));
+		assert(vertex_attributes_stride >= attribute_weights.length);
+		assert(attribute_weights.length <= 32);
+		for (var i = 0; i < attribute_weights.length; ++i) {
+			assert(attribute_weights[i] >= 0);
+		}
+
+		var options = 0;
+		for (var i = 0; i < (flags ? flags.length : 0); ++i) {
+			assert(flags[i] in simplifyOptions);
+			options |= simplifyOptions[flags[i]];
+		}
+
+		var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
+		return [
+			indices32,
+			indices.length,
+			vertex_positions,
+			vertex_positions.length / vertex_positions_stride,
+			vertex_positions_stride * 4,
+			vertex_attributes,
+			vertex_attributes_stride * 4,
+			new Float32Array(attribute_weights),
+			vertex_lock ? new Uint8Array(vertex_lock) : null,
+			target_index_count,
+			target_error,
+			options,
+		];
+	}
+
+	function simplifyResult(indices, result) {
+		result[0] = indices instanceof Uint32Array ? result[0] : new indices.constructor(result[0]);
+		return result;
+	}
+
+	var workers = [];
+	var requestId = 0;
+
+	function createWorker(url) {
+		var worker = {
+			object: new Worker(url),
+			pending: 0,
+			requests: {},
+		};
+
+		worker.object.onmessage = function (event) {
+			var data = event.data;
+
+			worker.pending -= 1;
+			worker.requests[data.id][data.action](data.value);
+			delete worker.requests[data.id];
+		};
+
+		return worker;
+	}
+
+	function initWorkers(count) {
+		var source =
+			'var instance; self.ready = WebAssembly.instantiate(new Uint8Array([' +
+			new Uint8Array(unpack(wasm)) +
+			']), {})' +
+			'.then(function(result) { instance = result.instance; instance.exports.__wasm_call_ctors(); });' +
+			'self.onmessage = ' +
+			workerProcess.name +
+			';' +
+			bytes.toString() +
+			simplify.toString() +
+			simplifyAttr.toString() +
+			transferList.toString() +
+			workerProcess.toString();
+
+		var blob = new Blob([source], { type: 'text/javascript' });
+		var url = URL.createObjectURL(blob);
+
+		for (var i = workers.length; i < count; ++i) {
+			workers[i] = createWorker(url);
+		}
+
+		for (var i = count; i < workers.length; ++i) {
+			workers[i].object.postMessage({});
+		}
+
+		workers.length = count;
+
+		URL.revokeObjectURL(url);
+	}
+
+	function transferList(value) {
+		// results only contain freshly allocated arrays, so their buffers can be transferred back instead of copied
+		var result = [];
+		for (var key in value) {
+			if (ArrayBuffer.isView(value[key])) {
+				result.push(value[key].buffer);
+			}
+		}
+		return result;
+	}
+
+	function workerProcess(event) {
+		var data = event.data;
+		if (!data.id) {
+			return self.close();
+		}
+		self.ready.then(function () {
+			try {
+				var args = data.fun ? [instance.exports[data.fun]].concat(data.args) : data.args;
+				var result = self[data.name].apply(null, args);
+				self.postMessage({ id: data.id, action: 'resolve', value: result }, transferList(result));
+			} catch (error) {
+				self.postMessage({ id: data.id, action: 'reject', value: error });
+			}
+		});
+	}
+
+	var functions = {
+		simplify: simplify,
+		simplifyAttr: simplifyAttr,
+	};
+
+	function runAsync(name, fun, args) {
+		if (workers.length == 0) {
+			return ready.then(function () {
+				return functions[name].apply(null, fun ? [instance.exports[fun]].concat(args) : args);
+			});
+		}
+
+		// each call runs on the least loaded worker; inputs are copied to the worker unless they are views into shared memory, and are always copied into Wasm memory
+		var worker = workers[0];
+		for (var i = 1; i < workers.length; ++i) {
+			if (workers[i].pending < worker.pending) {
+				worker = workers[i];
+			}
+		}
+
+		return new Promise(function (resolve, reject) {
+			var id = ++requestId;
+
+			worker.pending += 1;
+			worker.requests[id] = { resolve: resolve, reject: reject };
+			worker.object.postMessage({ id: id, name: name, fun: fun, args: args });
+		});
+	}
+
 	return {
 		ready: ready,
 		supported: true,
@@ -220,42 +424,50 @@ var MeshoptSimplifier = (function () {
 		},
 
 		simplify: function (indices, vertex_positions, vertex_positions_stride, target_index_count, target_error, flags) {
-			assert(
-				indices instanceof Uint32Array || indices instanceof Int32Array || indices instanceof Uint16Array || indices instanceof Int16Array
-			);
-			assert(indices.length % 3 == 0);
-			assert(vertex_positions instanceof Float32Array);
-			assert(vertex_positions.length % vertex_positions_stride == 0);
-			assert(vertex_positions_stride >= 3);
-			assert(target_index_count >= 0 && target_index_count <= indices.length);
-			assert(target_index_count % 3 == 0);
-			assert(target_error >= 0);
-
-			var options = 0;
-			for (var i = 0; i < (flags ? flags.length : 0); ++i) {
-				assert(flags[i] in simplifyOptions);
-				assert(this.useExperimentalFeatures || flags[i] != 'Prune'); // set useExperimentalFeatures to use experimental flags like Prune
-				options |= simplifyOptions[flags[i]];
-			}
+			var args = simplifyArgs(indices, vertex_positions, vertex_positions_stride, target_index_count, target_error, flags, this.useExperimentalFeatures);
+			return simplifyResult(indices, simplify.apply(null, [instance.exports.meshopt_simplify].concat(args)));
+		},
 
-			var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
-			var result = simplify(
-				instance.exports.meshopt_simplify,
-				indices32,
-				indices.length,
+		simplifyWithAttributes: function (
+			indices,
+			vertex_positions,
+			vertex_positions_stride,
+			vertex_attributes,
+			vertex_attributes_stride,
+			attribute_weights,
+			vertex_lock,
+			target_index_count,
+			target_error,
+			flags
+		) {
+			var args = simplifyAttrArgs(
+				indices,
 				vertex_positions,
-				vertex_positions.length / vertex_positions_stride,
-				vertex_positions_stride * 4,
+				vertex_positions_stride,
+				vertex_attributes,
+				vertex_attributes_stride,
+				attribute_weights,
+				vertex_lock,
 				target_index_count,
 				target_error,
-				options
+				flags,
+				this.useExperimentalFeatures
 			);
-			result[0] = indices instanceof Uint32Array ? result[0] : new indices.constructor(result[0]);
+			return simplifyResult(indices, simplifyAttr.apply(null, [instance.exports.meshopt_simplifyWithAttributes].concat(args)));
+		},
 
-			return result;
+		useWorkers: function (count) {
+			initWorkers(count);
 		},
 
-		simplifyWithAttributes: function (
+		simplifyAsync: function (indices, vertex_positions, vertex_positions_stride, target_index_count, target_error, flags) {
+			var args = simplifyArgs(indices, vertex_positions, vertex_positions_stride, target_index_count, target_error, flags, this.useExperimentalFeatures);
+			return runAsync('simplify', 'meshopt_simplify', args).then(function (result) {
+				return simplifyResult(indices, result);
+			});
+		},
+
+		simplifyWithAttributesAsync: function (
 			indices,
 			vertex_positions,
 			vertex_positions_stride,
@@ -267,54 +479,22 @@ var MeshoptSimplifier = (function () {
 			target_error,
 			flags
 		) {
-			assert(this.useExperimentalFeatures); // set useExperimentalFeatures to use this; note that this function is experimental and may change interface in a way that will require revising calling code
-			assert(
-				indices instanceof Uint32Array || indices instanceof Int32Array || indices instanceof Uint16Array || indices instanceof Int16Array
-			);
-			assert(indices.length % 3 == 0);
-			assert(vertex_positions instanceof Float32Array);
-			assert(vertex_positions.length % vertex_positions_stride == 0);
-			assert(vertex_positions_stride >= 3);
-			assert(vertex_attributes instanceof Float32Array);
-			assert(vertex_attributes.length % vertex_attributes_stride == 0);
-			assert(vertex_attributes_stride >= 0);
-			assert(vertex_lock == null || vertex_lock instanceof Uint8Array);
-			assert(vertex_lock == null || vertex_lock.length == vertex_positions.length / vertex_positions_stride);
-			assert(target_index_count >= 0 && target_index_count <= indices.length);
-			assert(target_index_count % 3 == 0);
-			assert(target_error >= 0);
-			assert(Array.isArray(attribute_weights));
-			assert(vertex_attributes_stride >= attribute_weights.length);
-			assert(attribute_weights.length <= 32);
-			for (var i = 0; i < attribute_weights.length; ++i) {
-				assert(attribute_weights[i] >= 0);
-			}
-
-			var options = 0;
-			for (var i = 0; i < (flags ? flags.length : 0); ++i) {
-				assert(flags[i] in simplifyOptions);
-				options |= simplifyOptions[flags[i]];
-			}
-
-			var indices32 = indices.BYTES_PER_ELEMENT == 4 ? indices : new Uint32Array(indices);
-			var result = simplifyAttr(
-				instance.exports.meshopt_simplifyWithAttributes,
-				indices32,
-				indices.length,
+			var args = simplifyAttrArgs(
+				indices,
 				vertex_positions,
-				vertex_positions.length / vertex_positions_stride,
-				vertex_positions_stride * 4,
+				vertex_positions_stride,
 				vertex_attributes,
-				vertex_attributes_stride * 4,
-				new Float32Array(attribute_weights),
-				vertex_lock ? new Uint8Array(vertex_lock) : null,
+				vertex_attributes_stride,
+				attribute_weights,
+				vertex_lock,
 				target_index_count,
 				target_error,
-				options
+				flags,
+				this.useExperimentalFeatures
 			);
-			result[0] = indices instanceof Uint32Array ? result[0] : new indices.constructor(result[0]);
-
-			return result;
+			return runAsync('simplifyAttr', 'meshopt_simplifyWithAttributes', args).then(function (result) {
+				return simplifyResult(indices, result);
+			});
 		},
 
 		getScale: function (vertex_positions, vertex_positions_stride) {
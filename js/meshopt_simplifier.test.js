@@ -40,6 +40,19 @@ var tests = {
 		assert.equal(res[1], 0); // error
 	},
 
+	simplifyAsync: function () {
+		var indices = new Uint32Array([0, 2, 1, 1, 2, 3, 3, 2, 4, 2, 5, 4]);
+
+		var positions = new Float32Array([0, 4, 0, 0, 1, 0, 2, 2, 0, 0, 0, 0, 1, 0, 0, 4, 0, 0]);
+
+		var expected = new Uint32Array([0, 5, 3]);
+
+		simplifier.simplifyAsync(indices, positions, 3, /* target indices */ 3, /* target error */ 0.01).then(function (res) {
+			assert.deepEqual(res[0], expected);
+			assert.equal(res[1], 0); // error
+		});
+	},
+
 	simplify16: function () {
 		// 0
 		// 1 2
@@ -0,0 +1,222 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace meshopt
+{
+
+const size_t kAdjacencyChunkSize = 65536;
+
+const int kAdjacencyBits = 11;
+const size_t kAdjacencyBuckets = 1 << kAdjacencyBits;
+
+struct AdjacencyTask
+{
+	const unsigned int* indices;
+	size_t index_count;
+	size_t vertex_count;
+
+	// corners (index buffer positions) sorted by vertex; ids[pass & 1] is the input of each pass
+	unsigned int* ids[2];
+	unsigned int* hist;
+	int pass;
+
+	const unsigned int* sorted;
+	unsigned int* offsets;
+	unsigned int* data;
+};
+
+static void adjacencyHistogramTask(void* context, size_t chunk)
+{
+	AdjacencyTask& t = *static_cast<AdjacencyTask*>(context);
+
+	size_t begin = chunk * kAdjacencyChunkSize;
+	size_t end = begin + kAdjacencyChunkSize < t.index_count ? begin + kAdjacencyChunkSize : t.index_count;
+
+	// first pass sorts corners in index buffer order, so the ids are implicit
+	const unsigned int* ids = t.pass == 0 ? NULL : t.ids[t.pass & 1];
+	unsigned int* hist = &t.hist[chunk * kAdjacencyBuckets];
+	int bitoff = t.pass * kAdjacencyBits;
+
+	memset(hist, 0, kAdjacencyBuckets * sizeof(unsigned int));
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int id = ids ? ids[i] : unsigned(i);
+
+		hist[(t.indices[id] >> bitoff) & (kAdjacencyBuckets - 1)]++;
+	}
+}
+
+static void adjacencyScatterTask(void* context, size_t chunk)
+{
+	AdjacencyTask& t = *static_cast<AdjacencyTask*>(context);
+
+	size_t begin = chunk * kAdjacencyChunkSize;
+	size_t end = begin + kAdjacencyChunkSize < t.index_count ? begin + kAdjacencyChunkSize : t.index_count;
+
+	const unsigned int* ids = t.pass == 0 ? NULL : t.ids[t.pass & 1];
+	unsigned int* ids_out = t.ids[(t.pass & 1) ^ 1];
+	unsigned int* offsets = &t.hist[chunk * kAdjacencyBuckets];
+	int bitoff = t.pass * kAdjacencyBits;
+
+	// scattering each chunk in order into a disjoint output range keeps the sort stable regardless of task scheduling
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int id = ids ? ids[i] : unsigned(i);
+
+		ids_out[offsets[(t.indices[id] >> bitoff) & (kAdjacencyBuckets - 1)]++] = id;
+	}
+}
+
+static void adjacencyOffsetsTask(void* context, size_t chunk)
+{
+	AdjacencyTask& t = *static_cast<AdjacencyTask*>(context);
+
+	size_t begin = chunk * kAdjacencyChunkSize;
+	size_t end = begin + kAdjacencyChunkSize < t.index_count ? begin + kAdjacencyChunkSize : t.index_count;
+
+	// each position that starts a new vertex run writes offsets for that vertex and all preceding vertices without triangles
+	unsigned int last = begin == 0 ? 0 : t.indices[t.sorted[begin - 1]] + 1;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int corner = t.sorted[i];
+		unsigned int vertex = t.indices[corner];
+
+		for (unsigned int v = last; v <= vertex; ++v)
+			t.offsets[v] = unsigned(i);
+
+		last = vertex + 1;
+		t.data[i] = corner / 3;
+	}
+}
+
+static void runAdjacencyTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), AdjacencyTask* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
+} // namespace meshopt
+
+void meshopt_buildTriangleAdjacency(meshopt_TriangleAdjacency* adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_buildTriangleAdjacency");
+
+	assert(index_count % 3 == 0);
+
+	adjacency->offsets = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate((vertex_count + 1) * sizeof(unsigned int)));
+	adjacency->data = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate(index_count * sizeof(unsigned int)));
+	adjacency->index_count = index_count;
+	adjacency->vertex_count = vertex_count;
+
+	unsigned int* offsets = adjacency->offsets;
+	unsigned int* data = adjacency->data;
+
+	size_t chunk_count = (index_count + kAdjacencyChunkSize - 1) / kAdjacencyChunkSize;
+
+	if (!parallel_for || chunk_count <= 1)
+	{
+		// counting sort; offsets[v + 1] accumulates the number of triangles for vertex v
+		memset(offsets, 0, (vertex_count + 1) * sizeof(unsigned int));
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			assert(indices[i] < vertex_count);
+
+			offsets[indices[i] + 1]++;
+		}
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			offsets[i + 1] += offsets[i];
+
+		assert(offsets[vertex_count] == index_count);
+
+		// scatter triangles using offsets[v] as a write cursor; after this, offsets[v] is the end of the range for vertex v
+		for (size_t i = 0; i < index_count; ++i)
+			data[offsets[indices[i]]++] = unsigned(i / 3);
+
+		for (size_t i = vertex_count; i > 0; --i)
+			offsets[i] = offsets[i - 1];
+
+		offsets[0] = 0;
+		return;
+	}
+
+#ifndef NDEBUG
+	for (size_t i = 0; i < index_count; ++i)
+		assert(indices[i] < vertex_count);
+#endif
+
+	// the number of radix passes depends on the number of bits required to represent vertex indices
+	int bits = 1;
+	while (bits < 32 && (vertex_count - 1) >> bits)
+		bits++;
+
+	int passes = (bits + kAdjacencyBits - 1) / kAdjacencyBits;
+
+	meshopt_Allocator allocator;
+
+	AdjacencyTask task = {};
+	task.indices = indices;
+	task.index_count = index_count;
+	task.vertex_count = vertex_count;
+	task.hist = allocator.allocate<unsigned int>(chunk_count * kAdjacencyBuckets);
+
+	// data doubles as a scratch buffer for sorted corners; it is chosen so that the final pass writes the other buffer
+	task.ids[passes & 1] = allocator.allocate<unsigned int>(index_count);
+	task.ids[(passes & 1) ^ 1] = data;
+
+	for (int pass = 0; pass < passes; ++pass)
+	{
+		task.pass = pass;
+		runAdjacencyTasks(parallel_for, context, adjacencyHistogramTask, &task, chunk_count);
+
+		// convert per-chunk histograms to output offsets; buckets are laid out in key order, and chunks are laid out in order within each bucket
+		unsigned int sum = 0;
+
+		for (size_t b = 0; b < kAdjacencyBuckets; ++b)
+			for (size_t i = 0; i < chunk_count; ++i)
+			{
+				unsigned int h = task.hist[i * kAdjacencyBuckets + b];
+				task.hist[i * kAdjacencyBuckets + b] = sum;
+				sum += h;
+			}
+
+		assert(sum == index_count);
+
+		runAdjacencyTasks(parallel_for, context, adjacencyScatterTask, &task, chunk_count);
+	}
+
+	task.sorted = task.ids[passes & 1];
+	task.offsets = offsets;
+	task.data = data;
+
+	runAdjacencyTasks(parallel_for, context, adjacencyOffsetsTask, &task, chunk_count);
+
+	// vertices after the last referenced vertex have empty ranges
+	for (size_t v = indices[task.sorted[index_count - 1]] + 1; v <= vertex_count; ++v)
+		offsets[v] = unsigned(index_count);
+}
+
+void meshopt_destroyTriangleAdjacency(meshopt_TriangleAdjacency* adjacency)
+{
+	if (adjacency->offsets)
+		meshopt_Allocator::Storage::deallocate(adjacency->offsets);
+
+	if (adjacency->data)
+		meshopt_Allocator::Storage::deallocate(adjacency->data);
+
+	adjacency->offsets = NULL;
+	adjacency->data = NULL;
+	adjacency->index_count = 0;
+	adjacency->vertex_count = 0;
+}
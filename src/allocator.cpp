@@ -3,6 +3,20 @@
 
 void meshopt_setAllocator(void* (MESHOPTIMIZER_ALLOC_CALLCONV* allocate)(size_t), void (MESHOPTIMIZER_ALLOC_CALLCONV* deallocate)(void*))
 {
-	meshopt_Allocator::Storage::allocate = allocate;
-	meshopt_Allocator::Storage::deallocate = deallocate;
+	meshopt_Allocator::Storage::global_allocate = allocate;
+	meshopt_Allocator::Storage::global_deallocate = deallocate;
+}
+
+void meshopt_setThreadAllocator(void* (MESHOPTIMIZER_ALLOC_CALLCONV* allocate)(size_t), void (MESHOPTIMIZER_ALLOC_CALLCONV* deallocate)(void*))
+{
+	assert((allocate == NULL) == (deallocate == NULL));
+
+	meshopt_Allocator::Storage::thread_allocate = allocate;
+	meshopt_Allocator::Storage::thread_deallocate = deallocate;
+}
+
+void meshopt_setEventCallback(meshopt_EventCallback callback, void* context)
+{
+	meshopt_Instrument::Storage::callback = callback;
+	meshopt_Instrument::Storage::context = context;
 }
@@ -13,16 +13,10 @@
 namespace meshopt
 {
 
-// This must be <= 255 since index 0xff is used internally to indice a vertex that doesn't belong to a meshlet
-const size_t kMeshletMaxVertices = 255;
-
-// A reasonable limit is around 2*max_vertices or less
-const size_t kMeshletMaxTriangles = 512;
-
 struct TriangleAdjacency2
 {
 	unsigned int* counts;
-	unsigned int* offsets;
+	const unsigned int* offsets;
 	unsigned int* data;
 };
 
@@ -32,7 +26,8 @@ static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned
 
 	// allocate arrays
 	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
-	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* offsets = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = offsets;
 	adjacency.data = allocator.allocate<unsigned int>(index_count);
 
 	// fill triangle counts
@@ -50,7 +45,7 @@ static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned
 
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		adjacency.offsets[i] = offset;
+		offsets[i] = offset;
 		offset += adjacency.counts[i];
 	}
 
@@ -61,20 +56,35 @@ static void buildTriangleAdjacency(TriangleAdjacency2& adjacency, const unsigned
 	{
 		unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
 
-		adjacency.data[adjacency.offsets[a]++] = unsigned(i);
-		adjacency.data[adjacency.offsets[b]++] = unsigned(i);
-		adjacency.data[adjacency.offsets[c]++] = unsigned(i);
+		adjacency.data[offsets[a]++] = unsigned(i);
+		adjacency.data[offsets[b]++] = unsigned(i);
+		adjacency.data[offsets[c]++] = unsigned(i);
 	}
 
 	// fix offsets that have been disturbed by the previous pass
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		assert(adjacency.offsets[i] >= adjacency.counts[i]);
+		assert(offsets[i] >= adjacency.counts[i]);
 
-		adjacency.offsets[i] -= adjacency.counts[i];
+		offsets[i] -= adjacency.counts[i];
 	}
 }
 
+static void copyTriangleAdjacency(TriangleAdjacency2& adjacency, const meshopt_TriangleAdjacency& source, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+{
+	assert(source.index_count == index_count && source.vertex_count == vertex_count);
+
+	// offsets are shared with the source; counts and data are modified by the caller as triangles are emitted
+	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = source.offsets;
+	adjacency.data = allocator.allocate<unsigned int>(index_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		adjacency.counts[i] = source.offsets[i + 1] - source.offsets[i];
+
+	memcpy(adjacency.data, source.data, index_count * sizeof(unsigned int));
+}
+
 static void computeBoundingSphere(float result[4], const float points[][3], size_t count)
 {
 	assert(count > 0);
@@ -511,48 +521,395 @@ static void kdtreeNearest(KDNode* nodes, unsigned int root, const float* points,
 	}
 }
 
-} // namespace meshopt
+struct MeshletRegionTask
+{
+	const unsigned int* indices;
+	size_t triangle_count;
+	size_t region_size;
 
-size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_positions_stride;
+
+	size_t max_vertices;
+	size_t max_triangles;
+	float cone_weight;
+
+	meshopt_Meshlet* meshlets;
+	unsigned int* meshlet_vertices;
+	unsigned char* meshlet_triangles;
+	size_t region_meshlets;
+
+	size_t* region_counts;
+};
+
+static void buildMeshletRegionTask(void* context, size_t region)
 {
-	using namespace meshopt;
+	const MeshletRegionTask& t = *static_cast<MeshletRegionTask*>(context);
 
-	assert(index_count % 3 == 0);
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
-	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+	size_t begin = region * t.region_size;
+	size_t end = begin + t.region_size < t.triangle_count ? begin + t.region_size : t.triangle_count;
+	size_t index_count = (end - begin) * 3;
 
-	(void)kMeshletMaxVertices;
-	(void)kMeshletMaxTriangles;
+	meshopt_Allocator allocator;
 
-	// meshlet construction is limited by max vertices and max triangles per meshlet
-	// the worst case is that the input is an unindexed stream since this equally stresses both limits
-	// note that we assume that in the worst case, we leave 2 vertices unpacked in each meshlet - if we have space for 3 we can pack any triangle
-	size_t max_vertices_conservative = max_vertices - 2;
-	size_t meshlet_limit_vertices = (index_count + max_vertices_conservative - 1) / max_vertices_conservative;
-	size_t meshlet_limit_triangles = (index_count / 3 + max_triangles - 1) / max_triangles;
+	// each region is clusterized as a separate mesh with a compact vertex buffer so that per-vertex state is proportional to region size
+	unsigned int* indices = allocator.allocate<unsigned int>(index_count);
+	memcpy(indices, t.indices + begin * 3, index_count * sizeof(unsigned int));
 
-	return meshlet_limit_vertices > meshlet_limit_triangles ? meshlet_limit_vertices : meshlet_limit_triangles;
+	unsigned int* remap = allocator.allocate<unsigned int>(index_count);
+	size_t vertex_count = meshopt_buildCompactRemap(remap, indices, index_count, allocator);
+
+	float* positions = allocator.allocate<float>(vertex_count * 3);
+	size_t vertex_stride_float = t.vertex_positions_stride / sizeof(float);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		assert(remap[i] < t.vertex_count);
+		memcpy(positions + i * 3, t.vertex_positions + remap[i] * vertex_stride_float, 3 * sizeof(float));
+	}
+
+	// each region writes to its own slice of the output which is sized for the worst case
+	meshopt_Meshlet* meshlets = t.meshlets + region * t.region_meshlets;
+	unsigned int* meshlet_vertices = t.meshlet_vertices + region * t.region_meshlets * t.max_vertices;
+	unsigned char* meshlet_triangles = t.meshlet_triangles + region * t.region_meshlets * t.max_triangles * 3;
+
+	size_t count = meshopt_buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, positions, vertex_count, sizeof(float) * 3, t.max_vertices, t.max_triangles, t.cone_weight);
+	assert(count <= t.region_meshlets);
+
+	// meshlets are stored consecutively so the last meshlet determines the size of the vertex data
+	size_t meshlet_vertex_count = count ? meshlets[count - 1].vertex_offset + meshlets[count - 1].vertex_count : 0;
+
+	for (size_t i = 0; i < meshlet_vertex_count; ++i)
+		meshlet_vertices[i] = remap[meshlet_vertices[i]];
+
+	t.region_counts[region] = count;
 }
 
-size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+static meshopt_Bounds computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, bool cone)
 {
-	using namespace meshopt;
+	(void)vertex_count;
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+	// compute triangle normals and gather triangle corners
+	float normals[meshopt_kMeshletMaxTriangles][3];
+	float corners[meshopt_kMeshletMaxTriangles][3][3];
+	size_t triangles = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		const float* p0 = vertex_positions + vertex_stride_float * a;
+		const float* p1 = vertex_positions + vertex_stride_float * b;
+		const float* p2 = vertex_positions + vertex_stride_float * c;
+
+		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
 
+		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+
+		// no need to include degenerate triangles - they will be invisible anyway
+		if (area == 0.f)
+			continue;
+
+		// record triangle normals & corners for future use; normal and corner 0 define a plane equation
+		normals[triangles][0] = normalx / area;
+		normals[triangles][1] = normaly / area;
+		normals[triangles][2] = normalz / area;
+		memcpy(corners[triangles][0], p0, 3 * sizeof(float));
+		memcpy(corners[triangles][1], p1, 3 * sizeof(float));
+		memcpy(corners[triangles][2], p2, 3 * sizeof(float));
+		triangles++;
+	}
+
+	meshopt_Bounds bounds = {};
+
+	// degenerate cluster, no valid triangles => trivial reject (cone data is 0)
+	if (triangles == 0)
+		return bounds;
+
+	// compute cluster bounding sphere; we'll use the center to determine normal cone apex as well
+	float psphere[4] = {};
+	computeBoundingSphere(psphere, corners[0], triangles * 3);
+
+	float center[3] = {psphere[0], psphere[1], psphere[2]};
+
+	bounds.center[0] = center[0];
+	bounds.center[1] = center[1];
+	bounds.center[2] = center[2];
+	bounds.radius = psphere[3];
+
+	// the remaining work is only needed for cone data, which batched callers can skip
+	if (!cone)
+		return bounds;
+
+	// treating triangle normals as points, find the bounding sphere - the sphere center determines the optimal cone axis
+	float nsphere[4] = {};
+	computeBoundingSphere(nsphere, normals, triangles);
+
+	float axis[3] = {nsphere[0], nsphere[1], nsphere[2]};
+	float axislength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+	float invaxislength = axislength == 0.f ? 0.f : 1.f / axislength;
+
+	axis[0] *= invaxislength;
+	axis[1] *= invaxislength;
+	axis[2] *= invaxislength;
+
+	// compute a tight cone around all normals, mindp = cos(angle/2)
+	float mindp = 1.f;
+
+	for (size_t i = 0; i < triangles; ++i)
+	{
+		float dp = normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2];
+
+		mindp = (dp < mindp) ? dp : mindp;
+	}
+
+	// degenerate cluster, normal cone is larger than a hemisphere => trivial accept; bounds already have sphere info
+	// note that if mindp is positive but close to 0, the triangle intersection code below gets less stable
+	// we arbitrarily decide that if a normal cone is ~168 degrees wide or more, the cone isn't useful
+	if (mindp <= 0.1f)
+	{
+		bounds.cone_cutoff = 1;
+		bounds.cone_cutoff_s8 = 127;
+		return bounds;
+	}
+
+	float maxt = 0;
+
+	// we need to find the point on center-t*axis ray that lies in negative half-space of all triangles
+	for (size_t i = 0; i < triangles; ++i)
+	{
+		// dot(center-t*axis-corner, trinormal) = 0
+		// dot(center-corner, trinormal) - t * dot(axis, trinormal) = 0
+		float cx = center[0] - corners[i][0][0];
+		float cy = center[1] - corners[i][0][1];
+		float cz = center[2] - corners[i][0][2];
+
+		float dc = cx * normals[i][0] + cy * normals[i][1] + cz * normals[i][2];
+		float dn = axis[0] * normals[i][0] + axis[1] * normals[i][1] + axis[2] * normals[i][2];
+
+		// dn should be larger than mindp cutoff above
+		assert(dn > 0.f);
+		float t = dc / dn;
+
+		maxt = (t > maxt) ? t : maxt;
+	}
+
+	// cone apex should be in the negative half-space of all cluster triangles by construction
+	bounds.cone_apex[0] = center[0] - axis[0] * maxt;
+	bounds.cone_apex[1] = center[1] - axis[1] * maxt;
+	bounds.cone_apex[2] = center[2] - axis[2] * maxt;
+
+	// note: this axis is the axis of the normal cone, but our test for perspective camera effectively negates the axis
+	bounds.cone_axis[0] = axis[0];
+	bounds.cone_axis[1] = axis[1];
+	bounds.cone_axis[2] = axis[2];
+
+	// cos(a) for normal cone is mindp; we need to add 90 degrees on both sides and invert the cone
+	// which gives us -cos(a+90) = -(-sin(a)) = sin(a) = sqrt(1 - cos^2(a))
+	bounds.cone_cutoff = sqrtf(1 - mindp * mindp);
+
+	// quantize axis & cutoff to 8-bit SNORM format
+	bounds.cone_axis_s8[0] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[0], 8));
+	bounds.cone_axis_s8[1] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[1], 8));
+	bounds.cone_axis_s8[2] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[2], 8));
+
+	// for the 8-bit test to be conservative, we need to adjust the cutoff by measuring the max. error
+	float cone_axis_s8_e0 = fabsf(bounds.cone_axis_s8[0] / 127.f - bounds.cone_axis[0]);
+	float cone_axis_s8_e1 = fabsf(bounds.cone_axis_s8[1] / 127.f - bounds.cone_axis[1]);
+	float cone_axis_s8_e2 = fabsf(bounds.cone_axis_s8[2] / 127.f - bounds.cone_axis[2]);
+
+	// note that we need to round this up instead of rounding to nearest, hence +1
+	int cone_cutoff_s8 = int(127 * (bounds.cone_cutoff + cone_axis_s8_e0 + cone_axis_s8_e1 + cone_axis_s8_e2) + 1);
+
+	bounds.cone_cutoff_s8 = (cone_cutoff_s8 > 127) ? 127 : (signed char)(cone_cutoff_s8);
+
+	return bounds;
+}
+
+const size_t kBoundsMeshletsPerTask = 256;
+
+struct MeshletBoundsTask
+{
+	float* spheres;
+	signed char* cones;
+	float* apexes;
+
+	const meshopt_Meshlet* meshlets;
+	size_t meshlet_count;
+	const unsigned int* meshlet_vertices;
+	const unsigned char* meshlet_triangles;
+
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_positions_stride;
+};
+
+static void computeMeshletBoundsTask(void* context, size_t chunk)
+{
+	const MeshletBoundsTask& t = *static_cast<MeshletBoundsTask*>(context);
+
+	size_t begin = chunk * kBoundsMeshletsPerTask;
+	size_t end = begin + kBoundsMeshletsPerTask < t.meshlet_count ? begin + kBoundsMeshletsPerTask : t.meshlet_count;
+
+	bool cone = t.cones || t.apexes;
+
+	unsigned int indices[meshopt_kMeshletMaxTriangles * 3];
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const meshopt_Meshlet& meshlet = t.meshlets[i];
+		assert(meshlet.triangle_count <= meshopt_kMeshletMaxTriangles);
+
+		const unsigned int* vertices = &t.meshlet_vertices[meshlet.vertex_offset];
+		const unsigned char* triangles = &t.meshlet_triangles[meshlet.triangle_offset];
+
+		for (size_t j = 0; j < meshlet.triangle_count * 3; ++j)
+		{
+			assert(triangles[j] < meshlet.vertex_count);
+			indices[j] = vertices[triangles[j]];
+			assert(indices[j] < t.vertex_count);
+		}
+
+		meshopt_Bounds bounds = computeClusterBounds(indices, meshlet.triangle_count * 3, t.vertex_positions, t.vertex_count, t.vertex_positions_stride, cone);
+
+		if (t.spheres)
+		{
+			float* sphere = &t.spheres[i * 4];
+			sphere[0] = bounds.center[0];
+			sphere[1] = bounds.center[1];
+			sphere[2] = bounds.center[2];
+			sphere[3] = bounds.radius;
+		}
+
+		if (t.cones)
+		{
+			signed char* cone_s8 = &t.cones[i * 4];
+			cone_s8[0] = bounds.cone_axis_s8[0];
+			cone_s8[1] = bounds.cone_axis_s8[1];
+			cone_s8[2] = bounds.cone_axis_s8[2];
+			cone_s8[3] = bounds.cone_cutoff_s8;
+		}
+
+		if (t.apexes)
+			memcpy(&t.apexes[i * 3], bounds.cone_apex, 3 * sizeof(float));
+	}
+}
+
+const size_t kMeshletBVHMaxBranching = 64;
+
+struct MeshletBVHItem
+{
+	// kd-tree node that covers the item, or ~0u if the item is a raw range of points that couldn't be partitioned
+	unsigned int kdnode;
+	unsigned int begin;
+	unsigned int size;
+};
+
+static unsigned int kdtreeSizes(unsigned int* sizes, const KDNode* nodes, size_t root)
+{
+	const KDNode& node = nodes[root];
+
+	if (node.axis == 3)
+		return sizes[root] = node.children + 1;
+
+	unsigned int left = kdtreeSizes(sizes, nodes, root + 1);
+	unsigned int right = kdtreeSizes(sizes, nodes, root + 1 + node.children);
+
+	return sizes[root] = left + right;
+}
+
+static void splitMeshletBVHItem(MeshletBVHItem& left, MeshletBVHItem& right, const MeshletBVHItem& item, const KDNode* nodes, const unsigned int* sizes)
+{
+	assert(item.size > 1);
+
+	if (item.kdnode != ~0u && nodes[item.kdnode].axis != 3)
+	{
+		unsigned int lnode = item.kdnode + 1, rnode = item.kdnode + 1 + nodes[item.kdnode].children;
+
+		MeshletBVHItem l = {lnode, item.begin, sizes[lnode]};
+		MeshletBVHItem r = {rnode, item.begin + sizes[lnode], sizes[rnode]};
+		assert(l.size + r.size == item.size);
+
+		left = l;
+		right = r;
+	}
+	else
+	{
+		// kd-tree leaves with multiple points contain points that can't be separated spatially, so any split is as good as another
+		unsigned int half = item.size / 2;
+
+		MeshletBVHItem l = {~0u, item.begin, half};
+		MeshletBVHItem r = {~0u, item.begin + half, item.size - half};
+
+		left = l;
+		right = r;
+	}
+}
+
+static void computeMeshletBVHBounds(meshopt_MeshletBVHNode& result, const float* spheres, size_t count)
+{
+	float aabb_min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float aabb_max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* sphere = spheres + i * 4;
+
+		for (int k = 0; k < 3; ++k)
+		{
+			aabb_min[k] = sphere[k] - sphere[3] < aabb_min[k] ? sphere[k] - sphere[3] : aabb_min[k];
+			aabb_max[k] = sphere[k] + sphere[3] > aabb_max[k] ? sphere[k] + sphere[3] : aabb_max[k];
+		}
+	}
+
+	float center[3] = {(aabb_min[0] + aabb_max[0]) * 0.5f, (aabb_min[1] + aabb_max[1]) * 0.5f, (aabb_min[2] + aabb_max[2]) * 0.5f};
+	float radius = 0;
+
+	// the sphere around the box center that contains all input spheres is usually tight enough and is conservative by construction
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float* sphere = spheres + i * 4;
+
+		float dx = sphere[0] - center[0], dy = sphere[1] - center[1], dz = sphere[2] - center[2];
+		float extent = sqrtf(dx * dx + dy * dy + dz * dz) + sphere[3];
+
+		radius = radius < extent ? extent : radius;
+	}
+
+	memcpy(result.center, center, 3 * sizeof(float));
+	result.radius = radius;
+	memcpy(result.aabb_min, aabb_min, 3 * sizeof(float));
+	memcpy(result.aabb_max, aabb_max, 3 * sizeof(float));
+}
+
+static size_t buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, const meshopt_TriangleAdjacency* shared_adjacency, void* scratch, size_t scratch_size)
+{
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
 	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
 
 	assert(cone_weight >= 0 && cone_weight <= 1);
 
-	meshopt_Allocator allocator;
+	meshopt_Allocator allocator(scratch, scratch_size);
 
 	TriangleAdjacency2 adjacency = {};
-	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
+	if (shared_adjacency)
+		copyTriangleAdjacency(adjacency, *shared_adjacency, index_count, vertex_count, allocator);
+	else
+		buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
 
 	unsigned int* live_triangles = allocator.allocate<unsigned int>(vertex_count);
 	memcpy(live_triangles, adjacency.counts, vertex_count * sizeof(unsigned int));
@@ -673,14 +1030,80 @@ size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_ve
 	return meshlet_offset;
 }
 
+} // namespace meshopt
+
+size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	(void)meshopt_kMeshletMaxVertices;
+	(void)meshopt_kMeshletMaxTriangles;
+
+	// meshlet construction is limited by max vertices and max triangles per meshlet
+	// the worst case is that the input is an unindexed stream since this equally stresses both limits
+	// note that we assume that in the worst case, we leave 2 vertices unpacked in each meshlet - if we have space for 3 we can pack any triangle
+	size_t max_vertices_conservative = max_vertices - 2;
+	size_t meshlet_limit_vertices = (index_count + max_vertices_conservative - 1) / max_vertices_conservative;
+	size_t meshlet_limit_triangles = (index_count / 3 + max_triangles - 1) / max_triangles;
+
+	return meshlet_limit_vertices > meshlet_limit_triangles ? meshlet_limit_vertices : meshlet_limit_triangles;
+}
+
+size_t meshopt_buildMeshletsWithAdjacency(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, const meshopt_TriangleAdjacency* shared_adjacency)
+{
+	meshopt_Instrument instrument("meshopt_buildMeshletsWithAdjacency");
+
+	return meshopt::buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, shared_adjacency, NULL, 0);
+}
+
+size_t meshopt_buildMeshletsScratchSize(size_t index_count, size_t vertex_count)
+{
+	using namespace meshopt;
+
+	// this mirrors allocations in buildMeshlets; each allocation may need up to 15 bytes of alignment padding
+	size_t face_count = index_count / 3;
+	size_t result = 9 * 16;
+
+	// adjacency and live triangle counts
+	result += vertex_count * sizeof(unsigned int) * 3 + index_count * sizeof(unsigned int);
+
+	// emitted flags, triangle cones, kd-tree and used vertex flags
+	result += face_count + face_count * sizeof(Cone) + face_count * sizeof(unsigned int) + face_count * 2 * sizeof(KDNode) + vertex_count;
+
+	return result;
+}
+
+size_t meshopt_buildMeshletsWithScratch(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, void* scratch, size_t scratch_size)
+{
+	meshopt_Instrument instrument("meshopt_buildMeshletsWithScratch");
+
+	assert(size_t(scratch) % 16 == 0);
+
+	return meshopt::buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, NULL, scratch, scratch_size);
+}
+
+size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
+{
+	meshopt_Instrument instrument("meshopt_buildMeshlets");
+
+	return meshopt_buildMeshletsWithAdjacency(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, NULL);
+}
+
 size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_buildMeshletsScan");
+
 	assert(index_count % 3 == 0);
 
-	assert(max_vertices >= 3 && max_vertices <= kMeshletMaxVertices);
-	assert(max_triangles >= 1 && max_triangles <= kMeshletMaxTriangles);
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
 	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
 
 	meshopt_Allocator allocator;
@@ -712,192 +1135,298 @@ size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshle
 	return meshlet_offset;
 }
 
-meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+size_t meshopt_buildMeshletsParallelBound(size_t index_count, size_t max_vertices, size_t max_triangles, size_t region_size)
+{
+	assert(index_count % 3 == 0);
+	assert(region_size > 0);
+
+	size_t triangle_count = index_count / 3;
+
+	// each region is bounded separately since every region can end with a partially filled meshlet
+	size_t full_regions = triangle_count / region_size;
+	size_t last_region = triangle_count % region_size;
+
+	return full_regions * meshopt_buildMeshletsBound(region_size * 3, max_vertices, max_triangles) + meshopt_buildMeshletsBound(last_region * 3, max_vertices, max_triangles);
+}
+
+size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, size_t region_size, meshopt_ParallelFor parallel_for, void* context)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_buildMeshletsParallel");
+
 	assert(index_count % 3 == 0);
-	assert(index_count / 3 <= kMeshletMaxTriangles);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 
-	(void)vertex_count;
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
 
-	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	assert(cone_weight >= 0 && cone_weight <= 1);
+	assert(region_size > 0);
 
-	// compute triangle normals and gather triangle corners
-	float normals[kMeshletMaxTriangles][3];
-	float corners[kMeshletMaxTriangles][3][3];
-	size_t triangles = 0;
+	size_t triangle_count = index_count / 3;
 
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
-		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+	// a single region doesn't need partitioning, and the result is the same as meshopt_buildMeshlets
+	if (triangle_count <= region_size)
+		return meshopt_buildMeshlets(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight);
 
-		const float* p0 = vertex_positions + vertex_stride_float * a;
-		const float* p1 = vertex_positions + vertex_stride_float * b;
-		const float* p2 = vertex_positions + vertex_stride_float * c;
+	meshopt_Allocator allocator;
 
-		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
-		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+	// spatial sort makes each consecutive range of triangles spatially coherent so that regions have short borders
+	unsigned int* sorted = allocator.allocate<unsigned int>(index_count);
+	meshopt_spatialSortTriangles(sorted, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 
-		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
-		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
-		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+	size_t region_count = (triangle_count + region_size - 1) / region_size;
+	size_t* region_counts = allocator.allocate<size_t>(region_count);
 
-		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+	MeshletRegionTask task = {sorted, triangle_count, region_size, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, meshlets, meshlet_vertices, meshlet_triangles, meshopt_buildMeshletsBound(region_size * 3, max_vertices, max_triangles), region_counts};
 
-		// no need to include degenerate triangles - they will be invisible anyway
-		if (area == 0.f)
+	if (parallel_for)
+		parallel_for(context, buildMeshletRegionTask, &task, region_count);
+	else
+		for (size_t i = 0; i < region_count; ++i)
+			buildMeshletRegionTask(&task, i);
+
+	// regions are built in place; compact the results in region order
+	size_t meshlet_offset = 0;
+	size_t vertex_offset = 0;
+	size_t triangle_offset = 0;
+
+	for (size_t i = 0; i < region_count; ++i)
+	{
+		size_t count = region_counts[i];
+		if (count == 0)
 			continue;
 
-		// record triangle normals & corners for future use; normal and corner 0 define a plane equation
-		normals[triangles][0] = normalx / area;
-		normals[triangles][1] = normaly / area;
-		normals[triangles][2] = normalz / area;
-		memcpy(corners[triangles][0], p0, 3 * sizeof(float));
-		memcpy(corners[triangles][1], p1, 3 * sizeof(float));
-		memcpy(corners[triangles][2], p2, 3 * sizeof(float));
-		triangles++;
+		meshopt_Meshlet* region_meshlets = meshlets + i * task.region_meshlets;
+		const meshopt_Meshlet& last = region_meshlets[count - 1];
+
+		// triangle data of each meshlet is padded to 4 bytes so the region size is aligned as well
+		size_t region_vertices = last.vertex_offset + last.vertex_count;
+		size_t region_triangles = last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3);
+
+		memmove(meshlet_vertices + vertex_offset, meshlet_vertices + i * task.region_meshlets * max_vertices, region_vertices * sizeof(unsigned int));
+		memmove(meshlet_triangles + triangle_offset, meshlet_triangles + i * task.region_meshlets * max_triangles * 3, region_triangles);
+
+		for (size_t j = 0; j < count; ++j)
+		{
+			meshopt_Meshlet meshlet = region_meshlets[j];
+			meshlet.vertex_offset += unsigned(vertex_offset);
+			meshlet.triangle_offset += unsigned(triangle_offset);
+
+			meshlets[meshlet_offset++] = meshlet;
+		}
+
+		vertex_offset += region_vertices;
+		triangle_offset += region_triangles;
 	}
 
-	meshopt_Bounds bounds = {};
+	assert(meshlet_offset <= meshopt_buildMeshletsParallelBound(index_count, max_vertices, max_triangles, region_size));
+	return meshlet_offset;
+}
 
-	// degenerate cluster, no valid triangles => trivial reject (cone data is 0)
-	if (triangles == 0)
-		return bounds;
+meshopt_Bounds meshopt_computeClusterBounds(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
 
-	// compute cluster bounding sphere; we'll use the center to determine normal cone apex as well
-	float psphere[4] = {};
-	computeBoundingSphere(psphere, corners[0], triangles * 3);
+	meshopt_Instrument instrument("meshopt_computeClusterBounds");
 
-	float center[3] = {psphere[0], psphere[1], psphere[2]};
+	assert(index_count % 3 == 0);
+	assert(index_count / 3 <= meshopt_kMeshletMaxTriangles);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
 
-	// treating triangle normals as points, find the bounding sphere - the sphere center determines the optimal cone axis
-	float nsphere[4] = {};
-	computeBoundingSphere(nsphere, normals, triangles);
+	return computeClusterBounds(indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, true);
+}
 
-	float axis[3] = {nsphere[0], nsphere[1], nsphere[2]};
-	float axislength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
-	float invaxislength = axislength == 0.f ? 0.f : 1.f / axislength;
+meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
 
-	axis[0] *= invaxislength;
-	axis[1] *= invaxislength;
-	axis[2] *= invaxislength;
+	meshopt_Instrument instrument("meshopt_computeMeshletBounds");
 
-	// compute a tight cone around all normals, mindp = cos(angle/2)
-	float mindp = 1.f;
+	assert(triangle_count <= meshopt_kMeshletMaxTriangles);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
 
-	for (size_t i = 0; i < triangles; ++i)
+	unsigned int indices[meshopt_kMeshletMaxTriangles * 3];
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
 	{
-		float dp = normals[i][0] * axis[0] + normals[i][1] * axis[1] + normals[i][2] * axis[2];
+		unsigned int index = meshlet_vertices[meshlet_triangles[i]];
+		assert(index < vertex_count);
 
-		mindp = (dp < mindp) ? dp : mindp;
+		indices[i] = index;
 	}
 
-	// fill bounding sphere info; note that below we can return bounds without cone information for degenerate cones
-	bounds.center[0] = center[0];
-	bounds.center[1] = center[1];
-	bounds.center[2] = center[2];
-	bounds.radius = psphere[3];
+	return meshopt_computeClusterBounds(indices, triangle_count * 3, vertex_positions, vertex_count, vertex_positions_stride);
+}
 
-	// degenerate cluster, normal cone is larger than a hemisphere => trivial accept
-	// note that if mindp is positive but close to 0, the triangle intersection code below gets less stable
-	// we arbitrarily decide that if a normal cone is ~168 degrees wide or more, the cone isn't useful
-	if (mindp <= 0.1f)
-	{
-		bounds.cone_cutoff = 1;
-		bounds.cone_cutoff_s8 = 127;
-		return bounds;
-	}
+void meshopt_computeMeshletBoundsBatch(float* spheres, signed char* cones, float* apexes, const meshopt_Meshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
 
-	float maxt = 0;
+	meshopt_Instrument instrument("meshopt_computeMeshletBoundsBatch");
 
-	// we need to find the point on center-t*axis ray that lies in negative half-space of all triangles
-	for (size_t i = 0; i < triangles; ++i)
-	{
-		// dot(center-t*axis-corner, trinormal) = 0
-		// dot(center-corner, trinormal) - t * dot(axis, trinormal) = 0
-		float cx = center[0] - corners[i][0][0];
-		float cy = center[1] - corners[i][0][1];
-		float cz = center[2] - corners[i][0][2];
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
 
-		float dc = cx * normals[i][0] + cy * normals[i][1] + cz * normals[i][2];
-		float dn = axis[0] * normals[i][0] + axis[1] * normals[i][1] + axis[2] * normals[i][2];
+	MeshletBoundsTask task = {spheres, cones, apexes, meshlets, meshlet_count, meshlet_vertices, meshlet_triangles, vertex_positions, vertex_count, vertex_positions_stride};
 
-		// dn should be larger than mindp cutoff above
-		assert(dn > 0.f);
-		float t = dc / dn;
+	size_t task_count = (meshlet_count + kBoundsMeshletsPerTask - 1) / kBoundsMeshletsPerTask;
 
-		maxt = (t > maxt) ? t : maxt;
-	}
+	if (parallel_for && task_count > 1)
+		parallel_for(context, computeMeshletBoundsTask, &task, task_count);
+	else
+		for (size_t i = 0; i < task_count; ++i)
+			computeMeshletBoundsTask(&task, i);
+}
 
-	// cone apex should be in the negative half-space of all cluster triangles by construction
-	bounds.cone_apex[0] = center[0] - axis[0] * maxt;
-	bounds.cone_apex[1] = center[1] - axis[1] * maxt;
-	bounds.cone_apex[2] = center[2] - axis[2] * maxt;
+size_t meshopt_buildMeshletBVH(meshopt_MeshletBVHNode* nodes, unsigned int* meshlet_remap, const float* meshlet_spheres, size_t meshlet_count, size_t branching)
+{
+	using namespace meshopt;
 
-	// note: this axis is the axis of the normal cone, but our test for perspective camera effectively negates the axis
-	bounds.cone_axis[0] = axis[0];
-	bounds.cone_axis[1] = axis[1];
-	bounds.cone_axis[2] = axis[2];
+	meshopt_Instrument instrument("meshopt_buildMeshletBVH");
 
-	// cos(a) for normal cone is mindp; we need to add 90 degrees on both sides and invert the cone
-	// which gives us -cos(a+90) = -(-sin(a)) = sin(a) = sqrt(1 - cos^2(a))
-	bounds.cone_cutoff = sqrtf(1 - mindp * mindp);
+	assert(branching >= 2 && branching <= kMeshletBVHMaxBranching);
 
-	// quantize axis & cutoff to 8-bit SNORM format
-	bounds.cone_axis_s8[0] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[0], 8));
-	bounds.cone_axis_s8[1] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[1], 8));
-	bounds.cone_axis_s8[2] = (signed char)(meshopt_quantizeSnorm(bounds.cone_axis[2], 8));
+	if (meshlet_count == 0)
+		return 0;
 
-	// for the 8-bit test to be conservative, we need to adjust the cutoff by measuring the max. error
-	float cone_axis_s8_e0 = fabsf(bounds.cone_axis_s8[0] / 127.f - bounds.cone_axis[0]);
-	float cone_axis_s8_e1 = fabsf(bounds.cone_axis_s8[1] / 127.f - bounds.cone_axis[1]);
-	float cone_axis_s8_e2 = fabsf(bounds.cone_axis_s8[2] / 127.f - bounds.cone_axis[2]);
+	meshopt_Allocator allocator;
 
-	// note that we need to round this up instead of rounding to nearest, hence +1
-	int cone_cutoff_s8 = int(127 * (bounds.cone_cutoff + cone_axis_s8_e0 + cone_axis_s8_e1 + cone_axis_s8_e2) + 1);
+	// binary kd-tree over sphere centers determines the spatial order of meshlets; each kd-tree subtree covers a range of kdindices
+	unsigned int* kdindices = allocator.allocate<unsigned int>(meshlet_count);
 
-	bounds.cone_cutoff_s8 = (cone_cutoff_s8 > 127) ? 127 : (signed char)(cone_cutoff_s8);
+	for (size_t i = 0; i < meshlet_count; ++i)
+		kdindices[i] = unsigned(i);
 
-	return bounds;
-}
+	KDNode* kdnodes = allocator.allocate<KDNode>(meshlet_count * 2);
+	kdtreeBuild(0, kdnodes, meshlet_count * 2, meshlet_spheres, 4, kdindices, meshlet_count, /* leaf_size= */ 1);
 
-meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
-{
-	using namespace meshopt;
+	unsigned int* kdsizes = allocator.allocate<unsigned int>(meshlet_count * 2);
+	kdtreeSizes(kdsizes, kdnodes, 0);
 
-	assert(triangle_count <= kMeshletMaxTriangles);
-	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
+	// every leaf has at least one meshlet and every interior node has at least two children, so there are at most 2*meshlet_count-1 nodes
+	MeshletBVHItem* items = allocator.allocate<MeshletBVHItem>(meshlet_count * 2);
 
-	unsigned int indices[kMeshletMaxTriangles * 3];
+	MeshletBVHItem root = {0, 0, unsigned(meshlet_count)};
+	items[0] = root;
 
-	for (size_t i = 0; i < triangle_count * 3; ++i)
+	size_t node_count = 1;
+
+	// collapse the binary tree top-down; nodes are emitted in breadth-first order so that children of each node are contiguous
+	for (size_t i = 0; i < node_count; ++i)
 	{
-		unsigned int index = meshlet_vertices[meshlet_triangles[i]];
-		assert(index < vertex_count);
+		MeshletBVHItem item = items[i];
+		meshopt_MeshletBVHNode& node = nodes[i];
 
-		indices[i] = index;
+		node.offset = item.begin;
+		node.child_count = 0;
+		node.meshlet_count = 0;
+
+		if (item.size <= branching)
+		{
+			node.meshlet_count = (unsigned short)(item.size);
+			continue;
+		}
+
+		MeshletBVHItem children[kMeshletBVHMaxBranching];
+		size_t child_count = 1;
+		children[0] = item;
+
+		// split the largest child while it can't be a leaf, until we run out of children slots
+		while (child_count < branching)
+		{
+			size_t largest = 0;
+
+			for (size_t j = 1; j < child_count; ++j)
+				largest = children[j].size > children[largest].size ? j : largest;
+
+			if (children[largest].size <= branching)
+				break;
+
+			// keep the children in spatial order to make sure meshlet ranges of sibling leaves are adjacent
+			memmove(&children[largest + 2], &children[largest + 1], (child_count - largest - 1) * sizeof(MeshletBVHItem));
+			splitMeshletBVHItem(children[largest], children[largest + 1], children[largest], kdnodes, kdsizes);
+			child_count++;
+		}
+
+		assert(child_count >= 2);
+		assert(node_count + child_count <= meshlet_count * 2);
+
+		node.offset = unsigned(node_count);
+		node.child_count = (unsigned short)(child_count);
+
+		memcpy(&items[node_count], children, child_count * sizeof(MeshletBVHItem));
+		node_count += child_count;
 	}
 
-	return meshopt_computeClusterBounds(indices, triangle_count * 3, vertex_positions, vertex_count, vertex_positions_stride);
+	// reorder sphere data to match the new meshlet order so that leaf bounds can be computed from contiguous ranges
+	float* spheres = allocator.allocate<float>(meshlet_count * 4);
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+		memcpy(&spheres[i * 4], &meshlet_spheres[kdindices[i] * 4], 4 * sizeof(float));
+
+	// children are always emitted after their parent, so we can compute bounds bottom-up in reverse order
+	for (size_t i = node_count; i > 0; --i)
+	{
+		meshopt_MeshletBVHNode& node = nodes[i - 1];
+
+		if (node.meshlet_count)
+		{
+			computeMeshletBVHBounds(node, &spheres[node.offset * 4], node.meshlet_count);
+			continue;
+		}
+
+		const meshopt_MeshletBVHNode* children = &nodes[node.offset];
+
+		memcpy(node.aabb_min, children[0].aabb_min, 3 * sizeof(float));
+		memcpy(node.aabb_max, children[0].aabb_max, 3 * sizeof(float));
+
+		for (size_t j = 1; j < node.child_count; ++j)
+			for (int k = 0; k < 3; ++k)
+			{
+				node.aabb_min[k] = children[j].aabb_min[k] < node.aabb_min[k] ? children[j].aabb_min[k] : node.aabb_min[k];
+				node.aabb_max[k] = children[j].aabb_max[k] > node.aabb_max[k] ? children[j].aabb_max[k] : node.aabb_max[k];
+			}
+
+		for (int k = 0; k < 3; ++k)
+			node.center[k] = (node.aabb_min[k] + node.aabb_max[k]) * 0.5f;
+
+		node.radius = 0;
+
+		for (size_t j = 0; j < node.child_count; ++j)
+		{
+			float dx = children[j].center[0] - node.center[0], dy = children[j].center[1] - node.center[1], dz = children[j].center[2] - node.center[2];
+			float extent = sqrtf(dx * dx + dy * dy + dz * dz) + children[j].radius;
+
+			node.radius = node.radius < extent ? extent : node.radius;
+		}
+	}
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+		meshlet_remap[kdindices[i]] = unsigned(i);
+
+	return node_count;
 }
 
 void meshopt_optimizeMeshlet(unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t triangle_count, size_t vertex_count)
 {
 	using namespace meshopt;
 
-	assert(triangle_count <= kMeshletMaxTriangles);
-	assert(vertex_count <= kMeshletMaxVertices);
+	meshopt_Instrument instrument("meshopt_optimizeMeshlet");
+
+	assert(triangle_count <= meshopt_kMeshletMaxTriangles);
+	assert(vertex_count <= meshopt_kMeshletMaxVertices);
 
 	unsigned char* indices = meshlet_triangles;
 	unsigned int* vertices = meshlet_vertices;
 
 	// cache tracks vertex timestamps (corresponding to triangle index! all 3 vertices are added at the same time and never removed)
-	unsigned char cache[kMeshletMaxVertices];
+	unsigned char cache[meshopt_kMeshletMaxVertices];
 	memset(cache, 0, vertex_count);
 
 	// note that we start from a value that means all vertices aren't in cache
@@ -951,9 +1480,9 @@ void meshopt_optimizeMeshlet(unsigned int* meshlet_vertices, unsigned char* mesh
 	}
 
 	// reorder meshlet vertices for access locality assuming index buffer is scanned sequentially
-	unsigned int order[kMeshletMaxVertices];
+	unsigned int order[meshopt_kMeshletMaxVertices];
 
-	unsigned char remap[kMeshletMaxVertices];
+	unsigned char remap[meshopt_kMeshletMaxVertices];
 	memset(remap, -1, vertex_count);
 
 	size_t vertex_offset = 0;
@@ -0,0 +1,528 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+// Cluster hierarchy is kept separate from the clusterizer since it depends on the simplifier; this keeps simplifier code out of clusterizer-only builds
+namespace meshopt
+{
+
+// Cluster hierarchy construction is based on:
+// Brian Karis. Nanite: A Deep Dive. 2021
+const size_t kHierarchyRegionSize = 65536;
+const size_t kHierarchyClustersPerTask = 256;
+const size_t kHierarchyGroupsPerTask = 16;
+const unsigned int kHierarchyShared = ~1u;
+
+static void runHierarchyTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), void* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
+static void expandMeshlet(unsigned int* result, const meshopt_Meshlet& meshlet, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* remap)
+{
+	meshopt_optimizeMeshlet(&meshlet_vertices[meshlet.vertex_offset], &meshlet_triangles[meshlet.triangle_offset], meshlet.triangle_count, meshlet.vertex_count);
+
+	for (size_t i = 0; i < meshlet.triangle_count * 3; ++i)
+	{
+		unsigned int v = meshlet_vertices[meshlet.vertex_offset + meshlet_triangles[meshlet.triangle_offset + i]];
+
+		result[i] = remap ? remap[v] : v;
+	}
+}
+
+static meshopt_LODBounds mergeLODBounds(const meshopt_LODCluster* clusters, const unsigned int* group, size_t group_size)
+{
+	meshopt_LODBounds result = {};
+
+	// merged center is a weighted average of cluster centers; precise bounds of the merged or simplified mesh would violate monotonicity
+	float weight = 0.f;
+	for (size_t i = 0; i < group_size; ++i)
+	{
+		const meshopt_LODBounds& self = clusters[group[i]].self;
+
+		result.center[0] += self.center[0] * self.radius;
+		result.center[1] += self.center[1] * self.radius;
+		result.center[2] += self.center[2] * self.radius;
+		weight += self.radius;
+	}
+
+	if (weight > 0)
+	{
+		result.center[0] /= weight;
+		result.center[1] /= weight;
+		result.center[2] /= weight;
+	}
+
+	// merged bounds must contain all cluster bounds, and merged error must be conservative wrt cluster errors
+	for (size_t i = 0; i < group_size; ++i)
+	{
+		const meshopt_LODBounds& self = clusters[group[i]].self;
+
+		float dx = self.center[0] - result.center[0], dy = self.center[1] - result.center[1], dz = self.center[2] - result.center[2];
+		float radius = self.radius + sqrtf(dx * dx + dy * dy + dz * dz);
+
+		result.radius = result.radius < radius ? radius : result.radius;
+		result.error = result.error < self.error ? self.error : result.error;
+	}
+
+	return result;
+}
+
+struct ClusterInitTask
+{
+	const meshopt_Meshlet* meshlets;
+	unsigned int* meshlet_vertices;
+	unsigned char* meshlet_triangles;
+	size_t meshlet_count;
+
+	meshopt_LODCluster* clusters;
+	unsigned int* cluster_indices;
+
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_positions_stride;
+};
+
+static void initClusterTask(void* context, size_t chunk)
+{
+	const ClusterInitTask& t = *static_cast<ClusterInitTask*>(context);
+
+	size_t begin = chunk * kHierarchyClustersPerTask;
+	size_t end = begin + kHierarchyClustersPerTask < t.meshlet_count ? begin + kHierarchyClustersPerTask : t.meshlet_count;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		meshopt_LODCluster& cluster = t.clusters[i];
+		unsigned int* indices = &t.cluster_indices[cluster.index_offset];
+
+		expandMeshlet(indices, t.meshlets[i], t.meshlet_vertices, t.meshlet_triangles, NULL);
+
+		meshopt_Bounds bounds = meshopt_computeClusterBounds(indices, cluster.index_count, t.vertex_positions, t.vertex_count, t.vertex_positions_stride);
+
+		cluster.self.center[0] = bounds.center[0];
+		cluster.self.center[1] = bounds.center[1];
+		cluster.self.center[2] = bounds.center[2];
+		cluster.self.radius = bounds.radius;
+		cluster.self.error = 0.f;
+	}
+}
+
+struct ClusterGroupTask
+{
+	const meshopt_LODCluster* clusters;
+	const unsigned int* cluster_indices;
+	const unsigned int* pending;
+	const size_t* group_offsets;
+	size_t group_count;
+
+	const unsigned int* position_remap;
+	const unsigned int* position_groups;
+
+	const float* vertex_positions;
+	size_t vertex_positions_stride;
+	const float* vertex_attributes;
+	size_t vertex_attributes_stride;
+	const float* attribute_weights;
+	size_t attribute_count;
+
+	size_t max_vertices;
+	size_t max_triangles;
+
+	const size_t* index_offsets;
+	const size_t* cluster_offsets;
+
+	unsigned int* result_indices;
+	meshopt_LODCluster* result_clusters;
+	size_t* result_counts;
+	meshopt_LODBounds* result_bounds;
+};
+
+static void simplifyGroupTask(void* context, size_t chunk)
+{
+	const ClusterGroupTask& t = *static_cast<ClusterGroupTask*>(context);
+
+	size_t begin = chunk * kHierarchyGroupsPerTask;
+	size_t end = begin + kHierarchyGroupsPerTask < t.group_count ? begin + kHierarchyGroupsPerTask : t.group_count;
+
+	// all groups in the task share scratch memory sized for the largest group, including the simplifier context
+	size_t max_index_count = 0;
+	for (size_t g = begin; g < end; ++g)
+		max_index_count = max_index_count < t.index_offsets[g + 1] - t.index_offsets[g] ? t.index_offsets[g + 1] - t.index_offsets[g] : max_index_count;
+
+	size_t max_meshlets = meshopt_buildMeshletsBound(max_index_count, t.max_vertices, t.max_triangles);
+
+	meshopt_Allocator allocator;
+
+	unsigned int* indices = allocator.allocate<unsigned int>(max_index_count);
+	unsigned int* simplified = allocator.allocate<unsigned int>(max_index_count);
+	unsigned int* remap = allocator.allocate<unsigned int>(max_index_count);
+	float* positions = allocator.allocate<float>(max_index_count * 3);
+	float* attributes = allocator.allocate<float>(max_index_count * t.attribute_count);
+	unsigned char* locks = allocator.allocate<unsigned char>(max_index_count);
+
+	meshopt_Meshlet* meshlets = allocator.allocate<meshopt_Meshlet>(max_meshlets);
+	unsigned int* meshlet_vertices = allocator.allocate<unsigned int>(max_meshlets * t.max_vertices);
+	unsigned char* meshlet_triangles = allocator.allocate<unsigned char>(max_meshlets * t.max_triangles * 3);
+
+	meshopt_SimplifyContext simplify_context;
+	meshopt_simplifyContextInit(&simplify_context);
+
+	// meshlets are built after simplification, so the simplifier scratch memory can be reused for them
+	meshopt_simplifyContextReserve(&simplify_context, meshopt_buildMeshletsScratchSize(max_index_count, max_index_count));
+
+	size_t vertex_stride_float = t.vertex_positions_stride / sizeof(float);
+	size_t attribute_stride_float = t.vertex_attributes_stride / sizeof(float);
+
+	for (size_t g = begin; g < end; ++g)
+	{
+		const unsigned int* group = &t.pending[t.group_offsets[g]];
+		size_t group_size = t.group_offsets[g + 1] - t.group_offsets[g];
+
+		t.result_counts[g] = 0;
+
+		// single clusters can't be simplified as their entire border is locked
+		if (group_size < 2)
+			continue;
+
+		size_t index_count = 0;
+		for (size_t i = 0; i < group_size; ++i)
+		{
+			const meshopt_LODCluster& cluster = t.clusters[group[i]];
+
+			memcpy(&indices[index_count], &t.cluster_indices[cluster.index_offset], cluster.index_count * sizeof(unsigned int));
+			index_count += cluster.index_count;
+		}
+
+		assert(index_count == t.index_offsets[g + 1] - t.index_offsets[g]);
+
+		// each group is simplified as a separate mesh with a compact vertex buffer so that per-vertex state is proportional to group size
+		size_t vertex_count = meshopt_buildCompactRemap(remap, indices, index_count, allocator);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+		{
+			unsigned int v = remap[i];
+
+			memcpy(&positions[i * 3], &t.vertex_positions[v * vertex_stride_float], 3 * sizeof(float));
+
+			if (t.attribute_count)
+				memcpy(&attributes[i * t.attribute_count], &t.vertex_attributes[v * attribute_stride_float], t.attribute_count * sizeof(float));
+
+			// we need to consistently lock all vertices with the same position to avoid holes
+			locks[i] = t.position_groups[t.position_remap[v]] == kHierarchyShared;
+		}
+
+		size_t cluster_index_count = t.max_triangles * 3;
+		size_t target_index_count = (group_size + 1) / 2 * cluster_index_count;
+
+		if (target_index_count >= index_count)
+			continue;
+
+		float error = 0.f;
+		size_t simplified_count = meshopt_simplifyWithContext(&simplify_context, simplified, indices, index_count, positions, vertex_count, sizeof(float) * 3, t.attribute_count ? attributes : NULL, t.attribute_count * sizeof(float), t.attribute_weights, t.attribute_count, locks, target_index_count, FLT_MAX, meshopt_SimplifyErrorAbsolute, &error);
+
+		// simplification is stuck when it can't remove enough triangles or reduce the number of clusters; the merge is abandoned
+		if (simplified_count * 20 > index_count * 17 || simplified_count / cluster_index_count >= index_count / cluster_index_count)
+			continue;
+
+		meshopt_LODBounds bounds = mergeLODBounds(t.clusters, group, group_size);
+		bounds.error += error; // this may overestimate the error, but we are starting from the simplified mesh so this is a little more correct
+
+		size_t meshlet_count = meshopt_buildMeshletsWithScratch(meshlets, meshlet_vertices, meshlet_triangles, simplified, simplified_count, positions, vertex_count, sizeof(float) * 3, t.max_vertices, t.max_triangles, 0.f, simplify_context.scratch, simplify_context.scratch_size);
+		assert(meshlet_count <= t.cluster_offsets[g + 1] - t.cluster_offsets[g]);
+
+		unsigned int* result_indices = &t.result_indices[t.index_offsets[g]];
+		meshopt_LODCluster* result_clusters = &t.result_clusters[t.cluster_offsets[g]];
+		size_t result_offset = 0;
+
+		for (size_t i = 0; i < meshlet_count; ++i)
+		{
+			expandMeshlet(&result_indices[result_offset], meshlets[i], meshlet_vertices, meshlet_triangles, remap);
+
+			meshopt_LODCluster& cluster = result_clusters[i];
+			memset(&cluster, 0, sizeof(cluster));
+
+			cluster.index_offset = unsigned(result_offset);
+			cluster.index_count = meshlets[i].triangle_count * 3;
+			cluster.self = bounds;
+
+			result_offset += cluster.index_count;
+		}
+
+		t.result_counts[g] = meshlet_count;
+		t.result_bounds[g] = bounds;
+	}
+
+	meshopt_simplifyContextDestroy(&simplify_context);
+}
+
+} // namespace meshopt
+
+size_t meshopt_buildClusterHierarchyBound(size_t max_indices, size_t max_vertices, size_t max_triangles)
+{
+	using namespace meshopt;
+
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
+
+	// clusterizing k indices produces at most k / (max_vertices - 2) + k / (max_triangles * 3) + 1 clusters; there is one clusterization per region of the original mesh and one per group
+	// since every group merges at least two clusters, the number of groups is at most half the number of clusters
+	size_t regions = max_indices / 3 / kHierarchyRegionSize + 1;
+
+	return 2 * (max_indices / (max_vertices - 2) + max_indices / (max_triangles * 3) + regions + 2);
+}
+
+size_t meshopt_buildClusterHierarchy(meshopt_LODCluster* clusters, size_t max_clusters, meshopt_LODGroup* groups, unsigned int* cluster_indices, size_t max_indices, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t max_vertices, size_t max_triangles, size_t group_size, size_t* out_group_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_buildClusterHierarchy");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(vertex_attributes_stride % sizeof(float) == 0);
+	assert(attribute_count <= 32); // matches simplifier limit
+	assert(max_indices >= index_count);
+	assert(group_size >= 2);
+
+	assert(max_vertices >= 3 && max_vertices <= meshopt_kMeshletMaxVertices);
+	assert(max_triangles >= 1 && max_triangles <= meshopt_kMeshletMaxTriangles);
+	assert(max_triangles % 4 == 0); // ensures the caller will compute output space properly as index data is 4b aligned
+
+	if (out_group_count)
+		*out_group_count = 0;
+
+	if (index_count == 0)
+		return 0;
+
+	meshopt_Allocator allocator;
+
+	// for cluster connectivity, we need a position-only remap that maps vertices with the same position to the same index
+	unsigned int* position_remap = allocator.allocate<unsigned int>(vertex_count);
+	meshopt_Stream position = {vertex_positions, sizeof(float) * 3, vertex_positions_stride};
+	size_t position_count = meshopt_generateVertexRemapMulti(position_remap, indices, index_count, vertex_count, &position, 1);
+
+	unsigned int* position_groups = allocator.allocate<unsigned int>(position_count);
+
+	// initial clusterization splits the original mesh; large meshes are split into regions to build clusters in parallel
+	size_t max_meshlets = meshopt_buildMeshletsParallelBound(index_count, max_vertices, max_triangles, kHierarchyRegionSize);
+
+	meshopt_Meshlet* meshlets = allocator.allocate<meshopt_Meshlet>(max_meshlets);
+	unsigned int* meshlet_vertices = allocator.allocate<unsigned int>(max_meshlets * max_vertices);
+	unsigned char* meshlet_triangles = allocator.allocate<unsigned char>(max_meshlets * max_triangles * 3);
+
+	size_t meshlet_count = meshopt_buildMeshletsParallel(meshlets, meshlet_vertices, meshlet_triangles, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, 0.f, kHierarchyRegionSize, parallel_for, context);
+	assert(meshlet_count <= max_clusters);
+
+	size_t index_offset = 0;
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+	{
+		meshopt_LODCluster& cluster = clusters[i];
+		memset(&cluster, 0, sizeof(cluster));
+
+		cluster.index_offset = unsigned(index_offset);
+		cluster.index_count = meshlets[i].triangle_count * 3;
+		cluster.parent_group = ~0u;
+		cluster.parent.error = FLT_MAX;
+
+		index_offset += cluster.index_count;
+	}
+
+	assert(index_offset == index_count);
+
+	ClusterInitTask init_task = {meshlets, meshlet_vertices, meshlet_triangles, meshlet_count, clusters, cluster_indices, vertex_positions, vertex_count, vertex_positions_stride};
+	runHierarchyTasks(parallel_for, context, initClusterTask, &init_task, (meshlet_count + kHierarchyClustersPerTask - 1) / kHierarchyClustersPerTask);
+
+	allocator.deallocate(meshlet_triangles);
+	allocator.deallocate(meshlet_vertices);
+	allocator.deallocate(meshlets);
+
+	unsigned int* pending = allocator.allocate<unsigned int>(max_clusters);
+	unsigned int* retry = allocator.allocate<unsigned int>(max_clusters);
+
+	for (size_t i = 0; i < meshlet_count; ++i)
+		pending[i] = unsigned(i);
+
+	size_t pending_count = meshlet_count;
+	size_t cluster_count = meshlet_count;
+	size_t group_count = 0;
+	unsigned int depth = 0;
+
+	// merge and simplify clusters until we can't merge anymore
+	while (pending_count > 1)
+	{
+		// clusters are sorted spatially so that consecutive ranges of clusters form compact groups
+		float* centers = allocator.allocate<float>(pending_count * 3);
+		unsigned int* order = allocator.allocate<unsigned int>(pending_count);
+
+		for (size_t i = 0; i < pending_count; ++i)
+			memcpy(&centers[i * 3], clusters[pending[i]].self.center, 3 * sizeof(float));
+
+		meshopt_spatialSortRemap(order, centers, pending_count, sizeof(float) * 3);
+
+		for (size_t i = 0; i < pending_count; ++i)
+			retry[order[i]] = pending[i];
+
+		memcpy(pending, retry, pending_count * sizeof(unsigned int));
+
+		allocator.deallocate(order);
+		allocator.deallocate(centers);
+
+		size_t* group_offsets = allocator.allocate<size_t>(pending_count + 1);
+		size_t level_groups = 0;
+		size_t last_indices = 0;
+
+		for (size_t i = 0; i < pending_count; ++i)
+		{
+			size_t cluster_indices_count = clusters[pending[i]].index_count;
+
+			if (level_groups == 0 || last_indices + cluster_indices_count > group_size * max_triangles * 3)
+			{
+				group_offsets[level_groups++] = i;
+				last_indices = 0;
+			}
+
+			last_indices += cluster_indices_count;
+		}
+
+		group_offsets[level_groups] = pending_count;
+
+		// vertices that are shared between groups are locked during simplification so that groups stay connected
+		memset(position_groups, -1, position_count * sizeof(unsigned int));
+
+		for (size_t g = 0; g < level_groups; ++g)
+			for (size_t i = group_offsets[g]; i < group_offsets[g + 1]; ++i)
+			{
+				const meshopt_LODCluster& cluster = clusters[pending[i]];
+
+				for (size_t k = 0; k < cluster.index_count; ++k)
+				{
+					unsigned int& entry = position_groups[position_remap[cluster_indices[cluster.index_offset + k]]];
+
+					entry = (entry == ~0u || entry == g) ? unsigned(g) : kHierarchyShared;
+				}
+			}
+
+		// each group writes its results to a separate range that is sized for the worst case
+		size_t* index_offsets = allocator.allocate<size_t>(level_groups + 1);
+		size_t* cluster_offsets = allocator.allocate<size_t>(level_groups + 1);
+
+		index_offsets[0] = 0;
+		cluster_offsets[0] = 0;
+
+		for (size_t g = 0; g < level_groups; ++g)
+		{
+			size_t group_indices = 0;
+			for (size_t i = group_offsets[g]; i < group_offsets[g + 1]; ++i)
+				group_indices += clusters[pending[i]].index_count;
+
+			index_offsets[g + 1] = index_offsets[g] + group_indices;
+			cluster_offsets[g + 1] = cluster_offsets[g] + meshopt_buildMeshletsBound(group_indices, max_vertices, max_triangles);
+		}
+
+		unsigned int* result_indices = allocator.allocate<unsigned int>(index_offsets[level_groups]);
+		meshopt_LODCluster* result_clusters = allocator.allocate<meshopt_LODCluster>(cluster_offsets[level_groups]);
+		size_t* result_counts = allocator.allocate<size_t>(level_groups);
+		meshopt_LODBounds* result_bounds = allocator.allocate<meshopt_LODBounds>(level_groups);
+
+		ClusterGroupTask group_task = {clusters, cluster_indices, pending, group_offsets, level_groups, position_remap, position_groups, vertex_positions, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, max_vertices, max_triangles, index_offsets, cluster_offsets, result_indices, result_clusters, result_counts, result_bounds};
+		runHierarchyTasks(parallel_for, context, simplifyGroupTask, &group_task, (level_groups + kHierarchyGroupsPerTask - 1) / kHierarchyGroupsPerTask);
+
+		depth++;
+
+		// groups are simplified independently; append the results in group order
+		size_t level_begin = cluster_count;
+		size_t retry_count = 0;
+		size_t triangles = 0;
+		size_t stuck_triangles = 0;
+
+		for (size_t g = 0; g < level_groups; ++g)
+		{
+			const unsigned int* group = &pending[group_offsets[g]];
+			size_t group_clusters = group_offsets[g + 1] - group_offsets[g];
+
+			size_t count = result_counts[g];
+			const meshopt_LODCluster* result = &result_clusters[cluster_offsets[g]];
+			size_t result_index_count = count ? result[count - 1].index_offset + result[count - 1].index_count : 0;
+
+			// stuck groups, as well as groups that don't fit into the output, are retried on the next level
+			if (count == 0 || cluster_count + count > max_clusters || index_offset + result_index_count > max_indices)
+			{
+				for (size_t i = 0; i < group_clusters; ++i)
+				{
+					retry[retry_count++] = group[i];
+					stuck_triangles += clusters[group[i]].index_count / 3;
+				}
+
+				continue;
+			}
+
+			assert(group_count < max_clusters / 2);
+
+			meshopt_LODGroup& lod_group = groups[group_count];
+			lod_group.cluster_offset = unsigned(cluster_count);
+			lod_group.cluster_count = unsigned(count);
+			lod_group.bounds = result_bounds[g];
+
+			// all clusters in the group need to switch simultaneously so they have the same parent bounds
+			for (size_t i = 0; i < group_clusters; ++i)
+			{
+				assert(clusters[group[i]].parent_group == ~0u);
+
+				clusters[group[i]].parent_group = unsigned(group_count);
+				clusters[group[i]].parent = result_bounds[g];
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				meshopt_LODCluster& cluster = clusters[cluster_count++];
+
+				cluster = result[i];
+				cluster.index_offset += unsigned(index_offset);
+				cluster.depth = depth;
+				cluster.parent_group = ~0u;
+				cluster.parent.error = FLT_MAX;
+			}
+
+			memcpy(&cluster_indices[index_offset], &result_indices[index_offsets[g]], result_index_count * sizeof(unsigned int));
+			index_offset += result_index_count;
+			triangles += result_index_count / 3;
+
+			group_count++;
+		}
+
+		allocator.deallocate(result_bounds);
+		allocator.deallocate(result_counts);
+		allocator.deallocate(result_clusters);
+		allocator.deallocate(result_indices);
+		allocator.deallocate(cluster_offsets);
+		allocator.deallocate(index_offsets);
+		allocator.deallocate(group_offsets);
+
+		// when most of the level is stuck, further merging is unlikely to make progress
+		if (triangles < stuck_triangles / 3)
+			break;
+
+		pending_count = 0;
+
+		for (size_t i = level_begin; i < cluster_count; ++i)
+			pending[pending_count++] = unsigned(i);
+
+		for (size_t i = 0; i < retry_count; ++i)
+			pending[pending_count++] = retry[i];
+	}
+
+	if (out_group_count)
+		*out_group_count = group_count;
+
+	return cluster_count;
+}
@@ -12,6 +12,11 @@ namespace meshopt
 
 const unsigned char kIndexHeader = 0xe0;
 const unsigned char kSequenceHeader = 0xd0;
+const unsigned char kIndexChunkHeader = 0xc0;
+
+// chunked streams start with a header byte and a 32-bit chunk size, followed by 32-bit chunk end offset and base index for each chunk
+const size_t kIndexChunkTableOffset = 5;
+const size_t kIndexChunkTableStride = 8;
 
 static int gEncodeIndexVersion = 1;
 
@@ -143,36 +148,205 @@ static int getCodeAuxIndex(unsigned char v, const unsigned char* table)
 	return -1;
 }
 
-static void writeTriangle(void* destination, size_t offset, size_t index_size, unsigned int a, unsigned int b, unsigned int c)
+template <typename T>
+static void writeTriangle(T* destination, size_t offset, unsigned int a, unsigned int b, unsigned int c)
 {
-	if (index_size == 2)
-	{
-		static_cast<unsigned short*>(destination)[offset + 0] = (unsigned short)(a);
-		static_cast<unsigned short*>(destination)[offset + 1] = (unsigned short)(b);
-		static_cast<unsigned short*>(destination)[offset + 2] = (unsigned short)(c);
-	}
-	else
+	destination[offset + 0] = T(a);
+	destination[offset + 1] = T(b);
+	destination[offset + 2] = T(c);
+}
+
+template <typename T>
+static int decodeIndexBuffer(T* destination, size_t index_count, int version, const unsigned char* buffer, size_t buffer_size, unsigned int base)
+{
+	EdgeFifo edgefifo;
+	memset(edgefifo, -1, sizeof(edgefifo));
+
+	VertexFifo vertexfifo;
+	memset(vertexfifo, -1, sizeof(vertexfifo));
+
+	size_t edgefifooffset = 0;
+	size_t vertexfifooffset = 0;
+
+	unsigned int next = base;
+	unsigned int last = base;
+
+	int fecmax = version >= 1 ? 13 : 15;
+
+	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
+	const unsigned char* code = buffer + 1;
+	const unsigned char* data = code + index_count / 3;
+	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+
+	const unsigned char* codeaux_table = data_safe_end;
+
+	for (size_t i = 0; i < index_count; i += 3)
 	{
-		static_cast<unsigned int*>(destination)[offset + 0] = a;
-		static_cast<unsigned int*>(destination)[offset + 1] = b;
-		static_cast<unsigned int*>(destination)[offset + 2] = c;
+		// make sure we have enough data to read for a triangle
+		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
+		// after this we can be sure we can read without extra bounds checks
+		if (data > data_safe_end)
+			return -2;
+
+		unsigned char codetri = *code++;
+
+		if (codetri < 0xf0)
+		{
+			int fe = codetri >> 4;
+
+			// fifo reads are wrapped around 16 entry buffer
+			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
+			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+
+			int fec = codetri & 15;
+
+			// note: this is the most common path in the entire decoder
+			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
+			if (fec < fecmax)
+			{
+				// fifo reads are wrapped around 16 entry buffer
+				unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
+				unsigned int c = (fec == 0) ? next : cf;
+
+				int fec0 = fec == 0;
+				next += fec0;
+
+				// output triangle
+				writeTriangle(destination, i, a, b, c);
+
+				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+
+				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+			}
+			else
+			{
+				unsigned int c = 0;
+
+				// fec - (fec ^ 3) decodes 13, 14 into -1, 1
+				// note that we need to update the last index since free indices are delta-encoded
+				last = c = (fec != 15) ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+
+				// output triangle
+				writeTriangle(destination, i, a, b, c);
+
+				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+
+				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+			}
+		}
+		else
+		{
+			// fast path: read codeaux from the table
+			if (codetri < 0xfe)
+			{
+				unsigned char codeaux = codeaux_table[codetri & 15];
+
+				// note: table can't contain feb/fec=15
+				int feb = codeaux >> 4;
+				int fec = codeaux & 15;
+
+				// fifo reads are wrapped around 16 entry buffer
+				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
+				unsigned int a = next++;
+
+				unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
+				unsigned int b = (feb == 0) ? next : bf;
+
+				int feb0 = feb == 0;
+				next += feb0;
+
+				unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
+				unsigned int c = (fec == 0) ? next : cf;
+
+				int fec0 = fec == 0;
+				next += fec0;
+
+				// output triangle
+				writeTriangle(destination, i, a, b, c);
+
+				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+				pushVertexFifo(vertexfifo, a, vertexfifooffset);
+				pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0);
+				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+
+				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+			}
+			else
+			{
+				// slow path: read a full byte for codeaux instead of using a table lookup
+				unsigned char codeaux = *data++;
+
+				int fea = codetri == 0xfe ? 0 : 15;
+				int feb = codeaux >> 4;
+				int fec = codeaux & 15;
+
+				// reset: codeaux is 0 but encoded as not-a-table
+				if (codeaux == 0)
+					next = 0;
+
+				// fifo reads are wrapped around 16 entry buffer
+				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
+				unsigned int a = (fea == 0) ? next++ : 0;
+				unsigned int b = (feb == 0) ? next++ : vertexfifo[(vertexfifooffset - feb) & 15];
+				unsigned int c = (fec == 0) ? next++ : vertexfifo[(vertexfifooffset - fec) & 15];
+
+				// note that we need to update the last index since free indices are delta-encoded
+				if (fea == 15)
+					last = a = decodeIndex(data, last);
+
+				if (feb == 15)
+					last = b = decodeIndex(data, last);
+
+				if (fec == 15)
+					last = c = decodeIndex(data, last);
+
+				// output triangle
+				writeTriangle(destination, i, a, b, c);
+
+				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
+				pushVertexFifo(vertexfifo, a, vertexfifooffset);
+				pushVertexFifo(vertexfifo, b, vertexfifooffset, (feb == 0) | (feb == 15));
+				pushVertexFifo(vertexfifo, c, vertexfifooffset, (fec == 0) | (fec == 15));
+
+				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
+				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
+				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
+			}
+		}
 	}
-}
 
-} // namespace meshopt
+	// we should've read all data bytes and stopped at the boundary between data and codeaux table
+	if (data != data_safe_end)
+		return -3;
 
-size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+	return 0;
+}
+
+static void writeChunkU32(unsigned char* data, size_t v)
 {
-	using namespace meshopt;
+	data[0] = (unsigned char)(v & 0xff);
+	data[1] = (unsigned char)((v >> 8) & 0xff);
+	data[2] = (unsigned char)((v >> 16) & 0xff);
+	data[3] = (unsigned char)((v >> 24) & 0xff);
+}
 
-	assert(index_count % 3 == 0);
+static size_t readChunkU32(const unsigned char* data)
+{
+	return size_t(data[0]) | (size_t(data[1]) << 8) | (size_t(data[2]) << 16) | (size_t(data[3]) << 24);
+}
 
+static size_t encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, int version, unsigned int base)
+{
 	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
 	if (buffer_size < 1 + index_count / 3 + 16)
 		return 0;
 
-	int version = gEncodeIndexVersion;
-
 	buffer[0] = (unsigned char)(kIndexHeader | version);
 
 	EdgeFifo edgefifo;
@@ -184,8 +358,9 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	size_t edgefifooffset = 0;
 	size_t vertexfifooffset = 0;
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+	// base is the first index that can be encoded as next; this is 0 for regular streams, but chunks start where the previous chunk left off
+	unsigned int next = base;
+	unsigned int last = base;
 
 	unsigned char* code = buffer + 1;
 	unsigned char* data = code + index_count / 3;
@@ -336,269 +511,298 @@ size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, cons
 	return data - buffer;
 }
 
-size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+struct IndexChunkTask
 {
-	assert(index_count % 3 == 0);
+	unsigned char* data;
+	size_t slot_size;
+	size_t* sizes;
 
-	// compute number of bits required for each index
-	unsigned int vertex_bits = 1;
+	const unsigned int* indices;
+	size_t index_count;
+	size_t chunk_size;
 
-	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
-		vertex_bits++;
+	const unsigned char* table;
+	int version;
+};
 
-	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
-	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
+static unsigned int computeChunkBases(unsigned char* table, const unsigned int* indices, size_t index_count, size_t chunk_size)
+{
+	// each chunk starts encoding new vertices after the largest index referenced by previous chunks
+	// for meshes optimized with meshopt_optimizeVertexFetch this matches the state of a serial encoder
+	unsigned int max_index = 0;
 
-	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+	for (size_t i = 0; i < index_count; i += chunk_size)
+	{
+		size_t end = (i + chunk_size < index_count) ? i + chunk_size : index_count;
+
+		writeChunkU32(table + (i / chunk_size) * kIndexChunkTableStride + 4, i == 0 ? 0 : max_index + 1);
+
+		for (size_t j = i; j < end; ++j)
+			max_index = indices[j] > max_index ? indices[j] : max_index;
+	}
+
+	return max_index;
 }
 
-void meshopt_encodeIndexVersion(int version)
+static void encodeIndexChunk(void* context, size_t i)
 {
-	assert(unsigned(version) <= 1);
+	const IndexChunkTask& task = *static_cast<IndexChunkTask*>(context);
 
-	meshopt::gEncodeIndexVersion = version;
+	size_t chunk_offset = i * task.chunk_size;
+	size_t chunk_indices = (chunk_offset + task.chunk_size < task.index_count) ? task.chunk_size : task.index_count - chunk_offset;
+
+	unsigned int base = unsigned(readChunkU32(task.table + i * kIndexChunkTableStride + 4));
+
+	task.sizes[i] = encodeIndexBuffer(task.data + i * task.slot_size, task.slot_size, task.indices + chunk_offset, chunk_indices, task.version, base);
 }
 
-int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+static size_t encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, int version)
 {
-	using namespace meshopt;
+	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
+	if (buffer_size < 1 + index_count + 4)
+		return 0;
 
-	assert(index_count % 3 == 0);
-	assert(index_size == 2 || index_size == 4);
+	buffer[0] = (unsigned char)(kSequenceHeader | version);
 
-	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
-	if (buffer_size < 1 + index_count / 3 + 16)
-		return -2;
+	unsigned int last[2] = {};
+	unsigned int current = 0;
 
-	if ((buffer[0] & 0xf0) != kIndexHeader)
-		return -1;
+	unsigned char* data = buffer + 1;
+	unsigned char* data_safe_end = buffer + buffer_size - 4;
 
-	int version = buffer[0] & 0x0f;
-	if (version > 1)
-		return -1;
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		// make sure we have enough data to write
+		// each index writes at most 5 bytes of data; there's a 4 byte tail after data_safe_end
+		// after this we can be sure we can write without extra bounds checks
+		if (data >= data_safe_end)
+			return 0;
 
-	EdgeFifo edgefifo;
-	memset(edgefifo, -1, sizeof(edgefifo));
+		unsigned int index = indices[i];
 
-	VertexFifo vertexfifo;
-	memset(vertexfifo, -1, sizeof(vertexfifo));
+		// this is a heuristic that switches between baselines when the delta grows too large
+		// we want the encoded delta to fit into one byte (7 bits), but 2 bits are used for sign and baseline index
+		// for now we immediately switch the baseline when delta grows too large - this can be adjusted arbitrarily
+		int cd = int(index - last[current]);
+		current ^= ((cd < 0 ? -cd : cd) >= 30);
 
-	size_t edgefifooffset = 0;
-	size_t vertexfifooffset = 0;
+		// encode delta from the last index
+		unsigned int d = index - last[current];
+		unsigned int v = (d << 1) ^ (int(d) >> 31);
 
-	unsigned int next = 0;
-	unsigned int last = 0;
+		// note: low bit encodes the index of the last baseline which will be used for reconstruction
+		encodeVByte(data, (v << 1) | current);
 
-	int fecmax = version >= 1 ? 13 : 15;
+		// update last for the next iteration that uses it
+		last[current] = index;
+	}
 
-	// since we store 16-byte codeaux table at the end, triangle data has to begin before data_safe_end
-	const unsigned char* code = buffer + 1;
-	const unsigned char* data = code + index_count / 3;
-	const unsigned char* data_safe_end = buffer + buffer_size - 16;
+	// make sure we have enough space to write tail
+	if (data > data_safe_end)
+		return 0;
 
-	const unsigned char* codeaux_table = data_safe_end;
+	for (int k = 0; k < 4; ++k)
+		*data++ = 0;
 
-	for (size_t i = 0; i < index_count; i += 3)
+	return data - buffer;
+}
+
+static unsigned char* getIndexEncodeBuffer(meshopt_EncodeContext* context, size_t size)
+{
+	if (context->buffer_capacity < size)
 	{
-		// make sure we have enough data to read for a triangle
-		// each triangle reads at most 16 bytes of data: 1b for codeaux and 5b for each free index
-		// after this we can be sure we can read without extra bounds checks
-		if (data > data_safe_end)
-			return -2;
+		if (context->buffer)
+			meshopt_Allocator::Storage::deallocate(context->buffer);
 
-		unsigned char codetri = *code++;
+		context->buffer = static_cast<unsigned char*>(meshopt_Allocator::Storage::allocate(size));
+		context->buffer_capacity = size;
+	}
 
-		if (codetri < 0xf0)
-		{
-			int fe = codetri >> 4;
+	return context->buffer;
+}
 
-			// fifo reads are wrapped around 16 entry buffer
-			unsigned int a = edgefifo[(edgefifooffset - 1 - fe) & 15][0];
-			unsigned int b = edgefifo[(edgefifooffset - 1 - fe) & 15][1];
+static const unsigned int* getEncodeIndices(meshopt_EncodeContext* context, const void* indices, size_t index_count, size_t index_size, unsigned int& max_index)
+{
+	assert(index_size == 2 || index_size == 4);
 
-			int fec = codetri & 15;
+	max_index = 0;
 
-			// note: this is the most common path in the entire decoder
-			// inside this if we try to stay branchless (by using cmov/etc.) since these aren't predictable
-			if (fec < fecmax)
-			{
-				// fifo reads are wrapped around 16 entry buffer
-				unsigned int cf = vertexfifo[(vertexfifooffset - 1 - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
+	if (index_size == 4)
+	{
+		const unsigned int* data = static_cast<const unsigned int*>(indices);
 
-				int fec0 = fec == 0;
-				next += fec0;
+		for (size_t i = 0; i < index_count; ++i)
+			max_index = data[i] > max_index ? data[i] : max_index;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+		return data;
+	}
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+	if (context->indices_capacity < index_count)
+	{
+		if (context->indices)
+			meshopt_Allocator::Storage::deallocate(context->indices);
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				unsigned int c = 0;
+		context->indices = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate(index_count * sizeof(unsigned int)));
+		context->indices_capacity = index_count;
+	}
 
-				// fec - (fec ^ 3) decodes 13, 14 into -1, 1
-				// note that we need to update the last index since free indices are delta-encoded
-				last = c = (fec != 15) ? last + (fec - (fec ^ 3)) : decodeIndex(data, last);
+	const unsigned short* data = static_cast<const unsigned short*>(indices);
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		context->indices[i] = data[i];
+		max_index = data[i] > max_index ? data[i] : max_index;
+	}
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, c, vertexfifooffset);
+	return context->indices;
+}
 
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-		}
-		else
-		{
-			// fast path: read codeaux from the table
-			if (codetri < 0xfe)
-			{
-				unsigned char codeaux = codeaux_table[codetri & 15];
+static size_t encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, size_t chunk_size, int version, meshopt_ParallelFor parallel_for, void* context)
+{
+	assert(index_count % 3 == 0);
+	assert(chunk_size > 0 && chunk_size % 3 == 0);
 
-				// note: table can't contain feb/fec=15
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
+	size_t chunk_count = (index_count + chunk_size - 1) / chunk_size;
 
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = next++;
+	// header byte, chunk size and chunk table
+	size_t table_size = kIndexChunkTableOffset + chunk_count * kIndexChunkTableStride;
 
-				unsigned int bf = vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int b = (feb == 0) ? next : bf;
+	if (buffer_size < table_size || unsigned(chunk_size) != chunk_size)
+		return 0;
 
-				int feb0 = feb == 0;
-				next += feb0;
+	buffer[0] = (unsigned char)(kIndexChunkHeader | version);
+	writeChunkU32(buffer + 1, chunk_size);
 
-				unsigned int cf = vertexfifo[(vertexfifooffset - fec) & 15];
-				unsigned int c = (fec == 0) ? next : cf;
+	unsigned char* table = buffer + kIndexChunkTableOffset;
+	unsigned int max_index = computeChunkBases(table, indices, index_count, chunk_size);
 
-				int fec0 = fec == 0;
-				next += fec0;
+	unsigned char* data = buffer + table_size;
+	unsigned char* data_end = buffer + buffer_size;
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	// to encode chunks in parallel, each chunk is encoded into a worst-case slot in the output buffer and compacted afterwards
+	size_t slot_size = meshopt_encodeIndexBufferBound(chunk_size, size_t(max_index) + 1);
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, feb0);
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, fec0);
+	if (parallel_for && chunk_count > 1 && buffer_size >= meshopt_encodeIndexBufferChunkedBound(index_count, size_t(max_index) + 1, chunk_size))
+	{
+		meshopt_Allocator allocator;
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-			else
-			{
-				// slow path: read a full byte for codeaux instead of using a table lookup
-				unsigned char codeaux = *data++;
+		size_t* sizes = allocator.allocate<size_t>(chunk_count);
 
-				int fea = codetri == 0xfe ? 0 : 15;
-				int feb = codeaux >> 4;
-				int fec = codeaux & 15;
+		IndexChunkTask task = {data, slot_size, sizes, indices, index_count, chunk_size, table, version};
+		parallel_for(context, encodeIndexChunk, &task, chunk_count);
 
-				// reset: codeaux is 0 but encoded as not-a-table
-				if (codeaux == 0)
-					next = 0;
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			// this can't fail since slots are sized for the worst case
+			assert(sizes[i] > 0);
 
-				// fifo reads are wrapped around 16 entry buffer
-				// also note that we increment next for all three vertices before decoding indices - this matches encoder behavior
-				unsigned int a = (fea == 0) ? next++ : 0;
-				unsigned int b = (feb == 0) ? next++ : vertexfifo[(vertexfifooffset - feb) & 15];
-				unsigned int c = (fec == 0) ? next++ : vertexfifo[(vertexfifooffset - fec) & 15];
+			// chunks only move towards the beginning of the buffer so there's no risk of overwriting a chunk before it's moved
+			memmove(data, buffer + table_size + i * slot_size, sizes[i]);
+			data += sizes[i];
 
-				// note that we need to update the last index since free indices are delta-encoded
-				if (fea == 15)
-					last = a = decodeIndex(data, last);
+			size_t chunk_end = data - (buffer + table_size);
+			if (unsigned(chunk_end) != chunk_end)
+				return 0;
 
-				if (feb == 15)
-					last = b = decodeIndex(data, last);
+			writeChunkU32(table + i * kIndexChunkTableStride, chunk_end);
+		}
 
-				if (fec == 15)
-					last = c = decodeIndex(data, last);
+		return data - buffer;
+	}
 
-				// output triangle
-				writeTriangle(destination, i, index_size, a, b, c);
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_offset = i * chunk_size;
+		size_t chunk_indices = (chunk_offset + chunk_size < index_count) ? chunk_size : index_count - chunk_offset;
 
-				// push vertex/edge fifo must match the encoding step *exactly* otherwise the data will not be decoded correctly
-				pushVertexFifo(vertexfifo, a, vertexfifooffset);
-				pushVertexFifo(vertexfifo, b, vertexfifooffset, (feb == 0) | (feb == 15));
-				pushVertexFifo(vertexfifo, c, vertexfifooffset, (fec == 0) | (fec == 15));
+		unsigned int base = unsigned(readChunkU32(table + i * kIndexChunkTableStride + 4));
 
-				pushEdgeFifo(edgefifo, b, a, edgefifooffset);
-				pushEdgeFifo(edgefifo, c, b, edgefifooffset);
-				pushEdgeFifo(edgefifo, a, c, edgefifooffset);
-			}
-		}
-	}
+		// each chunk is a complete index stream so its edge/vertex FIFO state starts from scratch
+		size_t chunk_encoded = encodeIndexBuffer(data, data_end - data, indices + chunk_offset, chunk_indices, version, base);
+		if (!chunk_encoded)
+			return 0;
 
-	// we should've read all data bytes and stopped at the boundary between data and codeaux table
-	if (data != data_safe_end)
-		return -3;
+		data += chunk_encoded;
 
-	return 0;
+		size_t chunk_end = data - (buffer + table_size);
+		if (unsigned(chunk_end) != chunk_end)
+			return 0;
+
+		writeChunkU32(table + i * kIndexChunkTableStride, chunk_end);
+	}
+
+	return data - buffer;
 }
 
-size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+} // namespace meshopt
+
+size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
 {
 	using namespace meshopt;
 
-	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
-	if (buffer_size < 1 + index_count + 4)
-		return 0;
+	meshopt_Instrument instrument("meshopt_encodeIndexBuffer");
 
-	int version = gEncodeIndexVersion;
+	assert(index_count % 3 == 0);
 
-	buffer[0] = (unsigned char)(kSequenceHeader | version);
+	return encodeIndexBuffer(buffer, buffer_size, indices, index_count, gEncodeIndexVersion, 0);
+}
 
-	unsigned int last[2] = {};
-	unsigned int current = 0;
+size_t meshopt_encodeIndexBufferBound(size_t index_count, size_t vertex_count)
+{
+	assert(index_count % 3 == 0);
 
-	unsigned char* data = buffer + 1;
-	unsigned char* data_safe_end = buffer + buffer_size - 4;
+	// compute number of bits required for each index
+	unsigned int vertex_bits = 1;
 
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		// make sure we have enough data to write
-		// each index writes at most 5 bytes of data; there's a 4 byte tail after data_safe_end
-		// after this we can be sure we can write without extra bounds checks
-		if (data >= data_safe_end)
-			return 0;
+	while (vertex_bits < 32 && vertex_count > size_t(1) << vertex_bits)
+		vertex_bits++;
 
-		unsigned int index = indices[i];
+	// worst-case encoding is 2 header bytes + 3 varint-7 encoded index deltas
+	unsigned int vertex_groups = (vertex_bits + 1 + 6) / 7;
 
-		// this is a heuristic that switches between baselines when the delta grows too large
-		// we want the encoded delta to fit into one byte (7 bits), but 2 bits are used for sign and baseline index
-		// for now we immediately switch the baseline when delta grows too large - this can be adjusted arbitrarily
-		int cd = int(index - last[current]);
-		current ^= ((cd < 0 ? -cd : cd) >= 30);
+	return 1 + (index_count / 3) * (2 + 3 * vertex_groups) + 16;
+}
 
-		// encode delta from the last index
-		unsigned int d = index - last[current];
-		unsigned int v = (d << 1) ^ (int(d) >> 31);
+void meshopt_encodeIndexVersion(int version)
+{
+	assert(unsigned(version) <= 1);
 
-		// note: low bit encodes the index of the last baseline which will be used for reconstruction
-		encodeVByte(data, (v << 1) | current);
+	meshopt::gEncodeIndexVersion = version;
+}
 
-		// update last for the next iteration that uses it
-		last[current] = index;
-	}
+int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
 
-	// make sure we have enough space to write tail
-	if (data > data_safe_end)
-		return 0;
+	meshopt_Instrument instrument("meshopt_decodeIndexBuffer");
 
-	for (int k = 0; k < 4; ++k)
-		*data++ = 0;
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
 
-	return data - buffer;
+	// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+	if (buffer_size < 1 + index_count / 3 + 16)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 1)
+		return -1;
+
+	if (index_size == 2)
+		return decodeIndexBuffer(static_cast<unsigned short*>(destination), index_count, version, buffer, buffer_size, 0);
+	else
+		return decodeIndexBuffer(static_cast<unsigned int*>(destination), index_count, version, buffer, buffer_size, 0);
+}
+
+size_t meshopt_encodeIndexSequence(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeIndexSequence");
+
+	return encodeIndexSequence(buffer, buffer_size, indices, index_count, gEncodeIndexVersion);
 }
 
 size_t meshopt_encodeIndexSequenceBound(size_t index_count, size_t vertex_count)
@@ -615,10 +819,53 @@ size_t meshopt_encodeIndexSequenceBound(size_t index_count, size_t vertex_count)
 	return 1 + index_count * vertex_groups + 4;
 }
 
+size_t meshopt_encodeIndexBufferContext(meshopt_EncodeContext* context, const void* indices, size_t index_count, size_t index_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeIndexBufferContext");
+
+	assert(index_count % 3 == 0);
+	assert(unsigned(context->index_version) <= 1);
+
+	unsigned int max_index = 0;
+	const unsigned int* data = getEncodeIndices(context, indices, index_count, index_size, max_index);
+
+	size_t bound = meshopt_encodeIndexBufferBound(index_count, size_t(max_index) + 1);
+	unsigned char* buffer = getIndexEncodeBuffer(context, bound);
+
+	size_t result = encodeIndexBuffer(buffer, bound, data, index_count, context->index_version, 0);
+	assert(result > 0);
+
+	return result;
+}
+
+size_t meshopt_encodeIndexSequenceContext(meshopt_EncodeContext* context, const void* indices, size_t index_count, size_t index_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeIndexSequenceContext");
+
+	assert(unsigned(context->index_version) <= 1);
+
+	unsigned int max_index = 0;
+	const unsigned int* data = getEncodeIndices(context, indices, index_count, index_size, max_index);
+
+	size_t bound = meshopt_encodeIndexSequenceBound(index_count, size_t(max_index) + 1);
+	unsigned char* buffer = getIndexEncodeBuffer(context, bound);
+
+	size_t result = encodeIndexSequence(buffer, bound, data, index_count, context->index_version);
+	assert(result > 0);
+
+	return result;
+}
+
 int meshopt_decodeIndexSequence(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_decodeIndexSequence");
+
 	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
 	if (buffer_size < 1 + index_count + 4)
 		return -2;
@@ -672,3 +919,221 @@ int meshopt_decodeIndexSequence(void* destination, size_t index_count, size_t in
 
 	return 0;
 }
+
+void meshopt_decodeIndexStreamInit(meshopt_DecodeStream* stream, size_t index_count, size_t index_size, size_t buffer_size)
+{
+	assert(index_size == 2 || index_size == 4);
+
+	memset(stream, 0, sizeof(*stream));
+
+	stream->count = index_count;
+	stream->size = index_size;
+	stream->buffer_size = buffer_size;
+}
+
+int meshopt_decodeIndexStream(meshopt_DecodeStream* stream, void* destination, const unsigned char* buffer, size_t available)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeIndexStream");
+
+	assert(available <= stream->buffer_size);
+
+	size_t index_count = stream->count;
+	size_t index_size = stream->size;
+	size_t buffer_size = stream->buffer_size;
+
+	if (available == 0)
+		return buffer_size == 0 ? -2 : 1;
+
+	// index buffers store codeaux table at the end of the stream, so they can only be decoded once the entire stream is available
+	if ((buffer[0] & 0xf0) == kIndexHeader)
+	{
+		if (index_count % 3 != 0)
+			return -1;
+
+		if (available < buffer_size)
+			return 1;
+
+		// the stream has already been decoded by an earlier call
+		if (stream->offset == buffer_size)
+			return 0;
+
+		int rc = meshopt_decodeIndexBuffer(destination, index_count, index_size, buffer, buffer_size);
+		if (rc == 0)
+			stream->decoded = index_count, stream->offset = buffer_size;
+
+		return rc;
+	}
+
+	// the minimum valid encoding is header, 1 byte per index and a 4-byte tail
+	if (buffer_size < 1 + index_count + 4)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kSequenceHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 1)
+		return -1;
+
+	size_t offset = stream->offset ? stream->offset : 1;
+
+	// each index reads at most 5 bytes of data, so we can only decode indices that start 4 bytes before the end of available data
+	// once all data is available, this limit is the boundary between data and the 4 byte tail
+	size_t offset_limit = available > 4 ? available - 4 : 0;
+
+	const unsigned char* data = buffer + offset;
+	const unsigned char* data_limit = buffer + (offset < offset_limit ? offset_limit : offset);
+
+	unsigned int last[2] = {stream->last[0], stream->last[1]};
+
+	size_t i = stream->decoded;
+
+	for (; i < index_count && data < data_limit; ++i)
+	{
+		unsigned int v = decodeVByte(data);
+
+		// decode the index of the last baseline
+		unsigned int current = v & 1;
+		v >>= 1;
+
+		// reconstruct index as a delta
+		unsigned int d = (v >> 1) ^ -int(v & 1);
+		unsigned int index = last[current] + d;
+
+		// update last for the next iteration that uses it
+		last[current] = index;
+
+		if (index_size == 2)
+		{
+			static_cast<unsigned short*>(destination)[i] = (unsigned short)(index);
+		}
+		else
+		{
+			static_cast<unsigned int*>(destination)[i] = index;
+		}
+	}
+
+	stream->decoded = i;
+	stream->offset = data - buffer;
+	stream->last[0] = last[0];
+	stream->last[1] = last[1];
+
+	if (i < index_count)
+		return available == buffer_size ? -2 : 1;
+
+	// we should've read all data bytes and stopped at the boundary between data and tail
+	if (size_t(data - buffer) != buffer_size - 4)
+		return -3;
+
+	return 0;
+}
+
+size_t meshopt_encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeIndexBufferChunked");
+
+	return encodeIndexBufferChunked(buffer, buffer_size, indices, index_count, chunk_size, gEncodeIndexVersion, parallel_for, context);
+}
+
+size_t meshopt_encodeIndexBufferChunkedBound(size_t index_count, size_t vertex_count, size_t chunk_size)
+{
+	using namespace meshopt;
+
+	assert(index_count % 3 == 0);
+	assert(chunk_size > 0 && chunk_size % 3 == 0);
+
+	size_t chunk_count = (index_count + chunk_size - 1) / chunk_size;
+	size_t full_chunks = index_count / chunk_size;
+	size_t last_chunk = index_count - full_chunks * chunk_size;
+
+	size_t result = kIndexChunkTableOffset + chunk_count * kIndexChunkTableStride;
+
+	result += full_chunks * meshopt_encodeIndexBufferBound(chunk_size, vertex_count);
+	result += last_chunk ? meshopt_encodeIndexBufferBound(last_chunk, vertex_count) : 0;
+
+	return result;
+}
+
+size_t meshopt_decodeIndexBufferChunkCount(size_t index_count, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	if (buffer_size < kIndexChunkTableOffset || (buffer[0] & 0xf0) != kIndexChunkHeader)
+		return 0;
+
+	size_t chunk_size = readChunkU32(buffer + 1);
+
+	return chunk_size ? (index_count + chunk_size - 1) / chunk_size : 0;
+}
+
+int meshopt_decodeIndexBufferChunks(void* destination, size_t index_count, size_t index_size, size_t chunk_begin, size_t chunk_end, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeIndexBufferChunks");
+
+	assert(index_count % 3 == 0);
+	assert(index_size == 2 || index_size == 4);
+	assert(chunk_begin <= chunk_end);
+
+	if (buffer_size < kIndexChunkTableOffset)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kIndexChunkHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 1)
+		return -1;
+
+	size_t chunk_size = readChunkU32(buffer + 1);
+	if (chunk_size == 0 || chunk_size % 3 != 0)
+		return -1;
+
+	size_t chunk_count = (index_count + chunk_size - 1) / chunk_size;
+	if (chunk_end > chunk_count)
+		return -1;
+
+	size_t table_size = kIndexChunkTableOffset + chunk_count * kIndexChunkTableStride;
+	if (buffer_size < table_size)
+		return -2;
+
+	const unsigned char* table = buffer + kIndexChunkTableOffset;
+	const unsigned char* data = buffer + table_size;
+	size_t data_size = buffer_size - table_size;
+
+	// the last chunk must end exactly at the end of the buffer, which makes sure the table is consistent with buffer_size
+	if (chunk_count > 0 && readChunkU32(table + (chunk_count - 1) * kIndexChunkTableStride) != data_size)
+		return -3;
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		size_t begin = i == 0 ? 0 : readChunkU32(table + (i - 1) * kIndexChunkTableStride);
+		size_t end = readChunkU32(table + i * kIndexChunkTableStride);
+		unsigned int base = unsigned(readChunkU32(table + i * kIndexChunkTableStride + 4));
+
+		size_t chunk_offset = i * chunk_size;
+		size_t chunk_indices = (chunk_offset + chunk_size < index_count) ? chunk_size : index_count - chunk_offset;
+
+		// the minimum valid encoding is header, 1 byte per triangle and a 16-byte codeaux table
+		if (begin > end || end > data_size || end - begin < 1 + chunk_indices / 3 + 16)
+			return -2;
+
+		if (data[begin] != (kIndexHeader | version))
+			return -1;
+
+		void* chunk_destination = static_cast<unsigned char*>(destination) + chunk_offset * index_size;
+
+		int rc = (index_size == 2)
+		             ? decodeIndexBuffer(static_cast<unsigned short*>(chunk_destination), chunk_indices, version, data + begin, end - begin, base)
+		             : decodeIndexBuffer(static_cast<unsigned int*>(chunk_destination), chunk_indices, version, data + begin, end - begin, base);
+		if (rc != 0)
+			return rc;
+	}
+
+	return 0;
+}
@@ -4,6 +4,25 @@
 #include <assert.h>
 #include <string.h>
 
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // John McDonald, Mark Kilgard. Crack-Free Point-Normal Triangles using Adjacent Edge Normals. 2010
 // John Hable. Variable Rate Shading with Visibility Buffer Rendering. 2024
@@ -34,6 +53,94 @@ static unsigned int hashUpdate4(unsigned int h, const unsigned char* key, size_t
 	return h;
 }
 
+#ifdef SIMD_SSE
+static unsigned int hashBlocks16(const unsigned char* key, size_t len)
+{
+	assert(len >= 16);
+
+	const __m128i m0 = _mm_set1_epi32(0x5bd1e995);
+	const __m128i m1 = _mm_set1_epi32(0x27d4eb2f);
+
+	__m128i h = _mm_setzero_si128();
+
+	// each 16-byte block is mixed using 32x32->64 multiplies of even and odd lanes; the last block overlaps the previous one if len isn't a multiple of 16
+	for (size_t offset = 0; offset < len; offset += 16)
+	{
+		__m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + (offset + 16 <= len ? offset : len - 16)));
+
+		k = _mm_xor_si128(k, h);
+
+		__m128i even = _mm_mul_epu32(k, m0);
+		__m128i odd = _mm_mul_epu32(_mm_srli_epi64(k, 32), m1);
+
+		h = _mm_xor_si128(even, _mm_shuffle_epi32(odd, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+
+	h = _mm_xor_si128(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(1, 0, 3, 2)));
+	h = _mm_xor_si128(h, _mm_shuffle_epi32(h, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	unsigned int r = unsigned(_mm_cvtsi128_si32(h));
+
+	// MurmurHash3 finalizer
+	r ^= r >> 16;
+	r *= 0x85ebca6b;
+	r ^= r >> 13;
+	r *= 0xc2b2ae35;
+	r ^= r >> 16;
+
+	return r;
+}
+
+static bool equalBlocks16(const unsigned char* lhs, const unsigned char* rhs, size_t len)
+{
+	assert(len >= 16);
+
+	__m128i eq = _mm_set1_epi8(-1);
+
+	for (size_t offset = 0; offset < len; offset += 16)
+	{
+		size_t block = offset + 16 <= len ? offset : len - 16;
+
+		__m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + block));
+		__m128i r = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + block));
+
+		eq = _mm_and_si128(eq, _mm_cmpeq_epi8(l, r));
+	}
+
+	return _mm_movemask_epi8(eq) == 0xffff;
+}
+#endif
+
+template <size_t Size>
+static unsigned int hashVertex(const unsigned char* key, size_t size)
+{
+	size_t len = Size == 0 ? size : Size;
+	assert(len == size);
+
+#ifdef SIMD_SSE
+	if (len >= 16)
+		return hashBlocks16(key, len);
+#endif
+
+	return hashUpdate4(0, key, len);
+}
+
+template <size_t Size>
+static bool equalVertex(const unsigned char* lhs, const unsigned char* rhs, size_t size)
+{
+	size_t len = Size == 0 ? size : Size;
+	assert(len == size);
+
+#ifdef SIMD_SSE
+	if (len >= 16)
+		return equalBlocks16(lhs, rhs, len);
+#endif
+
+	return memcmp(lhs, rhs, len) == 0;
+}
+
+// Size can be used to specialize hashing and comparison for a fixed vertex size; 0 uses vertex_size at runtime
+template <size_t Size>
 struct VertexHasher
 {
 	const unsigned char* vertices;
@@ -42,12 +149,12 @@ struct VertexHasher
 
 	size_t hash(unsigned int index) const
 	{
-		return hashUpdate4(0, vertices + index * vertex_stride, vertex_size);
+		return hashVertex<Size>(vertices + index * vertex_stride, vertex_size);
 	}
 
 	bool equal(unsigned int lhs, unsigned int rhs) const
 	{
-		return memcmp(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size) == 0;
+		return equalVertex<Size>(vertices + lhs * vertex_stride, vertices + rhs * vertex_stride, vertex_size);
 	}
 };
 
@@ -78,7 +185,7 @@ struct VertexStreamHasher
 			const meshopt_Stream& s = streams[i];
 			const unsigned char* data = static_cast<const unsigned char*>(s.data);
 
-			if (memcmp(data + lhs * s.stride, data + rhs * s.stride, s.size) != 0)
+			if (!equalVertex<0>(data + lhs * s.stride, data + rhs * s.stride, s.size))
 				return false;
 		}
 
@@ -125,15 +232,6 @@ struct EdgeHasher
 	}
 };
 
-static size_t hashBuckets(size_t count)
-{
-	size_t buckets = 1;
-	while (buckets < count + count / 4)
-		buckets *= 2;
-
-	return buckets;
-}
-
 template <typename T, typename Hash>
 static T* hashLookup(T* table, size_t buckets, const Hash& hash, const T& key, const T& empty)
 {
@@ -163,9 +261,9 @@ static T* hashLookup(T* table, size_t buckets, const Hash& hash, const T& key, c
 
 static void buildPositionRemap(unsigned int* remap, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_Allocator& allocator)
 {
-	VertexHasher vertex_hasher = {reinterpret_cast<const unsigned char*>(vertex_positions), 3 * sizeof(float), vertex_positions_stride};
+	VertexHasher<12> vertex_hasher = {reinterpret_cast<const unsigned char*>(vertex_positions), 3 * sizeof(float), vertex_positions_stride};
 
-	size_t vertex_table_size = hashBuckets(vertex_count);
+	size_t vertex_table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* vertex_table = allocator.allocate<unsigned int>(vertex_table_size);
 	memset(vertex_table, -1, vertex_table_size * sizeof(unsigned int));
 
@@ -197,23 +295,212 @@ static void remapVertices(void* destination, const void* vertices, size_t vertex
 		}
 }
 
-} // namespace meshopt
+const size_t kRemapChunkSize = 65536;
 
-size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+const int kRemapShardBits = 8;
+const size_t kRemapShards = 1 << kRemapShardBits;
+
+template <typename Hash>
+struct PrecomputedHasher
 {
-	using namespace meshopt;
+	const Hash* hasher;
+	const unsigned int* hashes;
 
-	assert(indices || index_count == vertex_count);
-	assert(!indices || index_count % 3 == 0);
-	assert(vertex_size > 0 && vertex_size <= 256);
+	size_t hash(unsigned int index) const
+	{
+		return hashes[index];
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return hasher->equal(lhs, rhs);
+	}
+};
+
+template <typename Hash>
+struct RemapTask
+{
+	const Hash* hasher;
+	size_t vertex_count;
+
+	// leader is ~0u for vertices that are not referenced by the index buffer; after deduplication, it refers to the first vertex in the shard with the same contents
+	unsigned int* leader;
+	unsigned int* hashes;
+	unsigned int* hist;
+	unsigned int* shard_vertices;
+	size_t shard_offsets[kRemapShards + 1];
+};
+
+template <typename Hash>
+static void remapHashTask(void* context, size_t chunk)
+{
+	const RemapTask<Hash>& t = *static_cast<RemapTask<Hash>*>(context);
+
+	size_t begin = chunk * kRemapChunkSize;
+	size_t end = begin + kRemapChunkSize < t.vertex_count ? begin + kRemapChunkSize : t.vertex_count;
+
+	unsigned int* hist = &t.hist[chunk * kRemapShards];
+	memset(hist, 0, kRemapShards * sizeof(unsigned int));
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		if (t.leader[i] == ~0u)
+			continue;
+
+		// shards use high bits of the hash so that the table buckets within each shard remain well distributed
+		unsigned int h = unsigned(t.hasher->hash(unsigned(i)));
+
+		t.hashes[i] = h;
+		hist[h >> (32 - kRemapShardBits)]++;
+	}
+}
+
+template <typename Hash>
+static void remapScatterTask(void* context, size_t chunk)
+{
+	const RemapTask<Hash>& t = *static_cast<RemapTask<Hash>*>(context);
+
+	size_t begin = chunk * kRemapChunkSize;
+	size_t end = begin + kRemapChunkSize < t.vertex_count ? begin + kRemapChunkSize : t.vertex_count;
+
+	unsigned int* offsets = &t.hist[chunk * kRemapShards];
+
+	for (size_t i = begin; i < end; ++i)
+		if (t.leader[i] != ~0u)
+			t.shard_vertices[offsets[t.hashes[i] >> (32 - kRemapShardBits)]++] = unsigned(i);
+}
+
+template <typename Hash>
+static void remapShardTask(void* context, size_t shard)
+{
+	const RemapTask<Hash>& t = *static_cast<RemapTask<Hash>*>(context);
+
+	size_t begin = t.shard_offsets[shard], end = t.shard_offsets[shard + 1];
+
+	if (begin == end)
+		return;
 
 	meshopt_Allocator allocator;
 
+	PrecomputedHasher<Hash> hasher = {t.hasher, t.hashes};
+
+	size_t table_size = meshopt_hashBuckets(end - begin);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	// identical vertices always end up in the same shard, so each shard can be deduplicated independently
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int index = t.shard_vertices[i];
+		unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+
+		if (*entry == ~0u)
+			*entry = index;
+
+		t.leader[index] = *entry;
+	}
+}
+
+template <typename Hash>
+static void runRemapTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), RemapTask<Hash>* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
+template <typename Hash>
+static size_t generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_Allocator allocator;
+
+	size_t chunk_count = (vertex_count + kRemapChunkSize - 1) / kRemapChunkSize;
+
+	RemapTask<Hash> task = {};
+	task.hasher = &hasher;
+	task.vertex_count = vertex_count;
+	task.leader = allocator.allocate<unsigned int>(vertex_count);
+	task.hashes = allocator.allocate<unsigned int>(vertex_count);
+	task.hist = allocator.allocate<unsigned int>(chunk_count * kRemapShards);
+	task.shard_vertices = allocator.allocate<unsigned int>(vertex_count);
+
+	// only vertices referenced by the index buffer participate in deduplication
+	if (indices)
+	{
+		memset(task.leader, -1, vertex_count * sizeof(unsigned int));
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			assert(indices[i] < vertex_count);
+
+			task.leader[indices[i]] = 0;
+		}
+	}
+	else
+	{
+		memset(task.leader, 0, vertex_count * sizeof(unsigned int));
+	}
+
+	runRemapTasks(parallel_for, context, remapHashTask<Hash>, &task, chunk_count);
+
+	// convert per-chunk histograms to output offsets; shards are laid out in order, and chunks are laid out in order within each shard
+	unsigned int sum = 0;
+
+	for (size_t s = 0; s < kRemapShards; ++s)
+	{
+		task.shard_offsets[s] = sum;
+
+		for (size_t i = 0; i < chunk_count; ++i)
+		{
+			unsigned int h = task.hist[i * kRemapShards + s];
+			task.hist[i * kRemapShards + s] = sum;
+			sum += h;
+		}
+	}
+
+	task.shard_offsets[kRemapShards] = sum;
+
+	runRemapTasks(parallel_for, context, remapScatterTask<Hash>, &task, chunk_count);
+	runRemapTasks(parallel_for, context, remapShardTask<Hash>, &task, kRemapShards);
+
+	// assign new vertices in the order of first occurrence of each unique vertex, which matches the serial algorithm exactly
 	memset(destination, -1, vertex_count * sizeof(unsigned int));
 
-	VertexHasher hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_size};
+	unsigned int next_vertex = 0;
 
-	size_t table_size = hashBuckets(vertex_count);
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices ? indices[i] : unsigned(i);
+
+		if (destination[index] == ~0u)
+		{
+			unsigned int leader = task.leader[index];
+
+			if (destination[leader] == ~0u)
+				destination[leader] = next_vertex++;
+
+			destination[index] = destination[leader];
+		}
+	}
+
+	assert(next_vertex <= vertex_count);
+
+	return next_vertex;
+}
+
+template <typename Hash>
+static size_t generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const Hash& hasher, meshopt_ParallelFor parallel_for, void* context, void* scratch, size_t scratch_size)
+{
+	if (parallel_for && vertex_count > kRemapChunkSize)
+		return generateVertexRemapParallel(destination, indices, index_count, vertex_count, hasher, parallel_for, context);
+
+	meshopt_Allocator allocator(scratch, scratch_size);
+
+	memset(destination, -1, vertex_count * sizeof(unsigned int));
+
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 	memset(table, -1, table_size * sizeof(unsigned int));
 
@@ -248,10 +535,63 @@ size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int
 	return next_vertex;
 }
 
+template <size_t Size>
+static size_t generateVertexRemapFixed(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context, void* scratch, size_t scratch_size)
+{
+	VertexHasher<Size> hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_size};
+
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher, parallel_for, context, scratch, scratch_size);
+}
+
+static size_t generateVertexRemapDispatch(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context, void* scratch, size_t scratch_size)
+{
+	// specialize hashing and comparison for common vertex sizes so that they are compiled as fully unrolled loops
+	switch (vertex_size)
+	{
+	case 12:
+		return generateVertexRemapFixed<12>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	case 16:
+		return generateVertexRemapFixed<16>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	case 24:
+		return generateVertexRemapFixed<24>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	case 32:
+		return generateVertexRemapFixed<32>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	case 48:
+		return generateVertexRemapFixed<48>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	case 64:
+		return generateVertexRemapFixed<64>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+
+	default:
+		return generateVertexRemapFixed<0>(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, scratch, scratch_size);
+	}
+}
+
+} // namespace meshopt
+
+size_t meshopt_generateVertexRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_generateVertexRemap");
+
+	assert(indices || index_count == vertex_count);
+	assert(!indices || index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	return generateVertexRemapDispatch(destination, indices, index_count, vertices, vertex_count, vertex_size, NULL, NULL, NULL, 0);
+}
+
 size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_generateVertexRemapMulti");
+
 	assert(indices || index_count == vertex_count);
 	assert(index_count % 3 == 0);
 	assert(stream_count > 0 && stream_count <= 16);
@@ -262,51 +602,73 @@ size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigne
 		assert(streams[i].size <= streams[i].stride);
 	}
 
-	meshopt_Allocator allocator;
+	VertexStreamHasher hasher = {streams, stream_count};
 
-	memset(destination, -1, vertex_count * sizeof(unsigned int));
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher, NULL, NULL, NULL, 0);
+}
 
-	VertexStreamHasher hasher = {streams, stream_count};
+size_t meshopt_generateVertexRemapScratchSize(size_t vertex_count)
+{
+	using namespace meshopt;
 
-	size_t table_size = hashBuckets(vertex_count);
-	unsigned int* table = allocator.allocate<unsigned int>(table_size);
-	memset(table, -1, table_size * sizeof(unsigned int));
+	// hash table and alignment padding
+	return meshopt_hashBuckets(vertex_count) * sizeof(unsigned int) + 16;
+}
 
-	unsigned int next_vertex = 0;
+size_t meshopt_generateVertexRemapWithScratch(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, void* scratch, size_t scratch_size)
+{
+	using namespace meshopt;
 
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		unsigned int index = indices ? indices[i] : unsigned(i);
-		assert(index < vertex_count);
+	meshopt_Instrument instrument("meshopt_generateVertexRemapWithScratch");
 
-		if (destination[index] == ~0u)
-		{
-			unsigned int* entry = hashLookup(table, table_size, hasher, index, ~0u);
+	assert(indices || index_count == vertex_count);
+	assert(!indices || index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(size_t(scratch) % 16 == 0);
 
-			if (*entry == ~0u)
-			{
-				*entry = index;
+	return generateVertexRemapDispatch(destination, indices, index_count, vertices, vertex_count, vertex_size, NULL, NULL, scratch, scratch_size);
+}
 
-				destination[index] = next_vertex++;
-			}
-			else
-			{
-				assert(destination[*entry] != ~0u);
+size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
 
-				destination[index] = destination[*entry];
-			}
-		}
+	meshopt_Instrument instrument("meshopt_generateVertexRemapParallel");
+
+	assert(indices || index_count == vertex_count);
+	assert(!indices || index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	return generateVertexRemapDispatch(destination, indices, index_count, vertices, vertex_count, vertex_size, parallel_for, context, NULL, 0);
+}
+
+size_t meshopt_generateVertexRemapMultiParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_generateVertexRemapMultiParallel");
+
+	assert(indices || index_count == vertex_count);
+	assert(index_count % 3 == 0);
+	assert(stream_count > 0 && stream_count <= 16);
+
+	for (size_t i = 0; i < stream_count; ++i)
+	{
+		assert(streams[i].size > 0 && streams[i].size <= 256);
+		assert(streams[i].size <= streams[i].stride);
 	}
 
-	assert(next_vertex <= vertex_count);
+	VertexStreamHasher hasher = {streams, stream_count};
 
-	return next_vertex;
+	return generateVertexRemap(destination, indices, index_count, vertex_count, hasher, parallel_for, context, NULL, 0);
 }
 
 void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t vertex_count, size_t vertex_size, const unsigned int* remap)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_remapVertexBuffer");
+
 	assert(vertex_size > 0 && vertex_size <= 256);
 
 	meshopt_Allocator allocator;
@@ -341,6 +703,8 @@ void meshopt_remapVertexBuffer(void* destination, const void* vertices, size_t v
 
 void meshopt_remapIndexBuffer(unsigned int* destination, const unsigned int* indices, size_t index_count, const unsigned int* remap)
 {
+	meshopt_Instrument instrument("meshopt_remapIndexBuffer");
+
 	assert(index_count % 3 == 0);
 
 	for (size_t i = 0; i < index_count; ++i)
@@ -356,6 +720,8 @@ void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_generateShadowIndexBuffer");
+
 	assert(indices);
 	assert(index_count % 3 == 0);
 	assert(vertex_size > 0 && vertex_size <= 256);
@@ -366,9 +732,9 @@ void meshopt_generateShadowIndexBuffer(unsigned int* destination, const unsigned
 	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
 	memset(remap, -1, vertex_count * sizeof(unsigned int));
 
-	VertexHasher hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_stride};
+	VertexHasher<0> hasher = {static_cast<const unsigned char*>(vertices), vertex_size, vertex_stride};
 
-	size_t table_size = hashBuckets(vertex_count);
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 	memset(table, -1, table_size * sizeof(unsigned int));
 
@@ -395,6 +761,8 @@ void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const uns
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_generateShadowIndexBufferMulti");
+
 	assert(indices);
 	assert(index_count % 3 == 0);
 	assert(stream_count > 0 && stream_count <= 16);
@@ -412,7 +780,7 @@ void meshopt_generateShadowIndexBufferMulti(unsigned int* destination, const uns
 
 	VertexStreamHasher hasher = {streams, stream_count};
 
-	size_t table_size = hashBuckets(vertex_count);
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 	memset(table, -1, table_size * sizeof(unsigned int));
 
@@ -439,6 +807,8 @@ void meshopt_generateAdjacencyIndexBuffer(unsigned int* destination, const unsig
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_generateAdjacencyIndexBuffer");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
@@ -454,7 +824,7 @@ void meshopt_generateAdjacencyIndexBuffer(unsigned int* destination, const unsig
 	// build edge set; this stores all triangle edges but we can look these up by any other wedge
 	EdgeHasher edge_hasher = {remap};
 
-	size_t edge_table_size = hashBuckets(index_count);
+	size_t edge_table_size = meshopt_hashBuckets(index_count);
 	unsigned long long* edge_table = allocator.allocate<unsigned long long>(edge_table_size);
 	unsigned int* edge_vertex_table = allocator.allocate<unsigned int>(edge_table_size);
 
@@ -510,6 +880,8 @@ void meshopt_generateTessellationIndexBuffer(unsigned int* destination, const un
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_generateTessellationIndexBuffer");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
@@ -525,7 +897,7 @@ void meshopt_generateTessellationIndexBuffer(unsigned int* destination, const un
 	// build edge set; this stores all triangle edges but we can look these up by any other wedge
 	EdgeHasher edge_hasher = {remap};
 
-	size_t edge_table_size = hashBuckets(index_count);
+	size_t edge_table_size = meshopt_hashBuckets(index_count);
 	unsigned long long* edge_table = allocator.allocate<unsigned long long>(edge_table_size);
 	memset(edge_table, -1, edge_table_size * sizeof(unsigned long long));
 
@@ -580,6 +952,8 @@ void meshopt_generateTessellationIndexBuffer(unsigned int* destination, const un
 
 size_t meshopt_generateProvokingIndexBuffer(unsigned int* destination, unsigned int* reorder, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
+	meshopt_Instrument instrument("meshopt_generateProvokingIndexBuffer");
+
 	assert(index_count % 3 == 0);
 
 	meshopt_Allocator allocator;
@@ -673,3 +1047,5 @@ size_t meshopt_generateProvokingIndexBuffer(unsigned int* destination, unsigned
 	assert(reorder_offset <= vertex_count + index_count / 3);
 	return reorder_offset;
 }
+
+#undef SIMD_SSE
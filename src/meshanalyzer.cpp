@@ -0,0 +1,151 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace meshopt
+{
+
+// this mirrors the model in meshopt_analyzeVertexCache, with the loop over triangles hoisted out so that all profiles are updated together
+struct CacheState
+{
+	unsigned int timestamp;
+
+	unsigned int warp_offset;
+	unsigned int primgroup_offset;
+
+	unsigned int vertices_transformed;
+	unsigned int warps_executed;
+};
+
+// timestamps are interleaved so that all profiles share one cache line per vertex; profile P uses timestamps[index * meshopt_CacheProfile_Count + P]
+// profile parameters are template arguments, which allows the compiler to specialize the flush condition for each profile
+template <int Profile, unsigned int CacheSize, unsigned int WarpSize, unsigned int PrimgroupSize>
+static void updateCache(CacheState& state, unsigned int* timestamps, unsigned int a, unsigned int b, unsigned int c)
+{
+	unsigned int* ta = &timestamps[a * meshopt_CacheProfile_Count + Profile];
+	unsigned int* tb = &timestamps[b * meshopt_CacheProfile_Count + Profile];
+	unsigned int* tc = &timestamps[c * meshopt_CacheProfile_Count + Profile];
+
+	bool ac = (state.timestamp - *ta) > CacheSize;
+	bool bc = (state.timestamp - *tb) > CacheSize;
+	bool cc = (state.timestamp - *tc) > CacheSize;
+
+	// flush cache if triangle doesn't fit into warp or into the primitive buffer
+	if ((PrimgroupSize && state.primgroup_offset == PrimgroupSize) || (WarpSize && state.warp_offset + ac + bc + cc > WarpSize))
+	{
+		state.warps_executed += state.warp_offset > 0;
+
+		state.warp_offset = 0;
+		state.primgroup_offset = 0;
+
+		// reset cache
+		state.timestamp += CacheSize + 1;
+	}
+
+	// update cache and add vertices to warp
+	unsigned int* tri[3] = {ta, tb, tc};
+
+	for (int j = 0; j < 3; ++j)
+	{
+		if (state.timestamp - *tri[j] > CacheSize)
+		{
+			*tri[j] = state.timestamp++;
+			state.vertices_transformed++;
+			state.warp_offset++;
+		}
+	}
+
+	state.primgroup_offset++;
+}
+
+} // namespace meshopt
+
+meshopt_MeshStatistics meshopt_analyzeMesh(const unsigned int* indices, size_t index_count, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_analyzeMesh");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_size > 0 && vertex_size <= 256);
+
+	meshopt_Allocator allocator;
+
+	meshopt_MeshStatistics result = {};
+
+	unsigned int* timestamps = allocator.allocate<unsigned int>(vertex_count * meshopt_CacheProfile_Count);
+	memset(timestamps, 0, vertex_count * meshopt_CacheProfile_Count * sizeof(unsigned int));
+
+	// parameters match the hardware models used by demo and tools/vcachetuner; see meshopt_CacheProfile for details
+	const unsigned int kGenericCache = 16, kNVidiaCache = 32, kAMDCache = 14, kIntelCache = 128;
+
+	CacheState generic = {kGenericCache + 1, 0, 0, 0, 0};
+	CacheState nvidia = {kNVidiaCache + 1, 0, 0, 0, 0};
+	CacheState amd = {kAMDCache + 1, 0, 0, 0, 0};
+	CacheState intel = {kIntelCache + 1, 0, 0, 0, 0};
+
+	// this mirrors the model in meshopt_analyzeVertexFetch
+	const size_t kCacheLine = 64;
+	const size_t kCacheSize = 128 * 1024;
+
+	size_t fetch_cache[kCacheSize / kCacheLine] = {};
+	size_t fetch_cache_lines = sizeof(fetch_cache) / sizeof(fetch_cache[0]);
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int a = indices[i + 0], b = indices[i + 1], c = indices[i + 2];
+		assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+		updateCache<meshopt_CacheProfileGeneric, kGenericCache, 0, 0>(generic, timestamps, a, b, c);
+		updateCache<meshopt_CacheProfileNVidia, kNVidiaCache, 32, 32>(nvidia, timestamps, a, b, c);
+		updateCache<meshopt_CacheProfileAMD, kAMDCache, 64, 128>(amd, timestamps, a, b, c);
+		updateCache<meshopt_CacheProfileIntel, kIntelCache, 0, 0>(intel, timestamps, a, b, c);
+
+		for (int j = 0; j < 3; ++j)
+		{
+			size_t start_address = indices[i + j] * vertex_size;
+			size_t end_address = start_address + vertex_size;
+
+			size_t start_tag = start_address / kCacheLine;
+			size_t end_tag = (end_address + kCacheLine - 1) / kCacheLine;
+
+			for (size_t tag = start_tag; tag < end_tag; ++tag)
+			{
+				size_t line = tag % fetch_cache_lines;
+
+				// we store +1 since cache is filled with 0 by default
+				result.vertex_fetch.bytes_fetched += (fetch_cache[line] != tag + 1) * kCacheLine;
+				fetch_cache[line] = tag + 1;
+			}
+		}
+	}
+
+	// every referenced vertex gets a non-zero timestamp in every cache
+	size_t unique_vertex_count = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		unique_vertex_count += timestamps[i * meshopt_CacheProfile_Count] > 0;
+
+	const CacheState* states[meshopt_CacheProfile_Count] = {&generic, &nvidia, &amd, &intel};
+
+	for (int k = 0; k < meshopt_CacheProfile_Count; ++k)
+	{
+		meshopt_VertexCacheStatistics& stats = result.vertex_cache[k];
+
+		stats.vertices_transformed = states[k]->vertices_transformed;
+		stats.warps_executed = states[k]->warps_executed + (states[k]->warp_offset > 0);
+
+		stats.acmr = index_count == 0 ? 0 : float(stats.vertices_transformed) / float(index_count / 3);
+		stats.atvr = unique_vertex_count == 0 ? 0 : float(stats.vertices_transformed) / float(unique_vertex_count);
+	}
+
+	result.vertex_fetch.overfetch = unique_vertex_count == 0 ? 0 : float(result.vertex_fetch.bytes_fetched) / float(unique_vertex_count * vertex_size);
+
+	// overdraw requires rasterization, which can't be fused with the index buffer traversal
+	if (vertex_positions)
+		result.overdraw = meshopt_analyzeOverdraw(indices, index_count, vertex_positions, vertex_count, vertex_positions_stride);
+
+	return result;
+}
@@ -0,0 +1,431 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSSE3, which can be enabled unconditionally through compiler settings
+#if defined(__AVX__) || defined(__SSSE3__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSSE3 code regardless of compile options; we use a cpuid-based scalar fallback
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#define SIMD_FALLBACK
+#endif
+
+// GCC 4.9+ and clang 3.8+ support targeting SIMD ISA from individual functions; we use a cpuid-based scalar fallback
+#if !defined(SIMD_SSE) && ((defined(__clang__) && __clang_major__ * 100 + __clang_minor__ >= 308) || (defined(__GNUC__) && __GNUC__ * 100 + __GNUC_MINOR__ >= 409)) && (defined(__i386__) || defined(__x86_64__))
+#define SIMD_SSE
+#define SIMD_FALLBACK
+#define SIMD_TARGET __attribute__((target("ssse3")))
+#endif
+
+#ifndef SIMD_TARGET
+#define SIMD_TARGET
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <tmmintrin.h>
+#endif
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid
+#else
+#include <cpuid.h> // __cpuid
+#endif
+#endif
+
+// This work is based on:
+// Daniel Lemire, Nathan Kurz, Christoph Rupp. Stream VByte: Faster Byte-Oriented Integer Compression. 2017
+namespace meshopt
+{
+
+const unsigned char kMeshletHeader = 0x90;
+
+// triangle codes are 4 bits: 0 is the next new vertex, 1..14 refer to recently added vertices, and 15 is followed by a literal byte
+const unsigned int kMeshletCodeLiteral = 15;
+
+// vertex references are delta-coded and stored as 1-4 bytes; each control byte stores lengths of 4 consecutive references
+static unsigned char getVertexLength(unsigned int v)
+{
+	return v < (1 << 8) ? 1 : v < (1 << 16) ? 2 : v < (1 << 24) ? 3 : 4;
+}
+
+static unsigned int encodeZigZag(unsigned int v)
+{
+	return (v << 1) ^ (0 - (v >> 31));
+}
+
+static unsigned int decodeZigZag(unsigned int v)
+{
+	return (v >> 1) ^ (0 - (v & 1));
+}
+
+static const unsigned char* decodeMeshletVertices(unsigned int* vertices, size_t begin, size_t vertex_count, const unsigned char* control, const unsigned char* data, const unsigned char* data_end, unsigned int last)
+{
+	for (size_t i = begin; i < vertex_count; ++i)
+	{
+		size_t length = ((control[i / 4] >> ((i % 4) * 2)) & 3) + 1;
+
+		if (size_t(data_end - data) < length)
+			return NULL;
+
+		unsigned int v = 0;
+		for (size_t k = 0; k < length; ++k)
+			v |= unsigned(data[k]) << (k * 8);
+
+		data += length;
+
+		last += decodeZigZag(v);
+		vertices[i] = last;
+	}
+
+	return data;
+}
+
+static const unsigned char* decodeMeshletTriangles(unsigned char* triangles, size_t begin, size_t index_count, const unsigned char* codes, const unsigned char* data, const unsigned char* data_end, unsigned int next)
+{
+	for (size_t i = begin; i < index_count; ++i)
+	{
+		unsigned int code = (codes[i / 2] >> ((i & 1) * 4)) & 15;
+		unsigned int v = 0;
+
+		if (code == kMeshletCodeLiteral)
+		{
+			if (data == data_end)
+				return NULL;
+
+			v = *data++;
+		}
+		else
+		{
+			v = next - code;
+			next += code == 0;
+		}
+
+		triangles[i] = (unsigned char)v;
+	}
+
+	return data;
+}
+
+#if !defined(SIMD_SSE) || defined(SIMD_FALLBACK)
+static int decodeMeshlet(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size)
+{
+	const unsigned char* data = buffer + 1;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	size_t control_size = (vertex_count + 3) / 4;
+	size_t code_size = (triangle_count * 3 + 1) / 2;
+
+	if (size_t(data_end - data) < control_size)
+		return -2;
+
+	data = decodeMeshletVertices(vertices, 0, vertex_count, data, data + control_size, data_end, 0);
+	if (!data || size_t(data_end - data) < code_size)
+		return -2;
+
+	data = decodeMeshletTriangles(triangles, 0, triangle_count * 3, data, data + code_size, data_end, 0);
+	if (!data)
+		return -2;
+
+	// we should've read all data bytes
+	if (data != data_end)
+		return -3;
+
+	return 0;
+}
+#endif
+
+#ifdef SIMD_SSE
+static unsigned char kDecodeMeshletVertexShuffle[256][16];
+static unsigned char kDecodeMeshletVertexLength[256];
+
+static unsigned char kDecodeMeshletLiteralShuffle[256][8];
+static unsigned char kDecodeMeshletLiteralCount[256];
+
+static bool decodeMeshletBuildTables()
+{
+	for (int mask = 0; mask < 256; ++mask)
+	{
+		unsigned char offset = 0;
+
+		for (int k = 0; k < 4; ++k)
+		{
+			int length = ((mask >> (k * 2)) & 3) + 1;
+
+			for (int j = 0; j < 4; ++j)
+				kDecodeMeshletVertexShuffle[mask][k * 4 + j] = j < length ? (unsigned char)(offset + j) : 0x80;
+
+			offset += (unsigned char)length;
+		}
+
+		kDecodeMeshletVertexLength[mask] = offset;
+
+		unsigned char count = 0;
+
+		for (int i = 0; i < 8; ++i)
+		{
+			int maski = (mask >> i) & 1;
+			kDecodeMeshletLiteralShuffle[mask][i] = maski ? count : 0x80;
+			count += (unsigned char)(maski);
+		}
+
+		kDecodeMeshletLiteralCount[mask] = count;
+	}
+
+	return true;
+}
+
+static bool gDecodeMeshletInitialized = decodeMeshletBuildTables();
+
+SIMD_TARGET
+static int decodeMeshletSimd(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size)
+{
+	const unsigned char* data = buffer + 1;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	size_t control_size = (vertex_count + 3) / 4;
+	size_t code_size = (triangle_count * 3 + 1) / 2;
+
+	if (size_t(data_end - data) < control_size)
+		return -2;
+
+	const unsigned char* control = data;
+	data += control_size;
+
+	// each control byte decodes 4 references with one shuffle; loads read 16 bytes so the tail is decoded with scalar code
+	size_t i = 0;
+	__m128i last = _mm_setzero_si128();
+
+	for (; i + 4 <= vertex_count && size_t(data_end - data) >= 16; i += 4)
+	{
+		unsigned char mask = control[i / 4];
+
+		__m128i shuf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kDecodeMeshletVertexShuffle[mask]));
+		__m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), shuf);
+
+		data += kDecodeMeshletVertexLength[mask];
+
+		// zigzag decode followed by prefix sum
+		v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi32(1))));
+		v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+		v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+		v = _mm_add_epi32(v, last);
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&vertices[i]), v);
+
+		last = _mm_shuffle_epi32(v, 0xff);
+	}
+
+	data = decodeMeshletVertices(vertices, i, vertex_count, control, data, data_end, unsigned(_mm_cvtsi128_si32(last)));
+	if (!data || size_t(data_end - data) < code_size)
+		return -2;
+
+	const unsigned char* codes = data;
+	data += code_size;
+
+	// each group of 16 codes is decoded at once: new vertex indices are computed with a prefix sum, and literals are expanded with a shuffle
+	size_t index_count = triangle_count * 3;
+	unsigned int next = 0;
+
+	size_t j = 0;
+
+	for (; j + 16 <= index_count; j += 16)
+	{
+		__m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&codes[j / 2]));
+		__m128i nibble = _mm_set1_epi8(15);
+
+		__m128i code = _mm_unpacklo_epi8(_mm_and_si128(packed, nibble), _mm_and_si128(_mm_srli_epi16(packed, 4), nibble));
+
+		__m128i literal = _mm_cmpeq_epi8(code, nibble);
+		int literal_mask = _mm_movemask_epi8(literal);
+
+		if (literal_mask && size_t(data_end - data) < 16)
+			break;
+
+		// isnew is -1 for new vertices, so isnew - prefix(isnew) is the number of new vertices before each code
+		__m128i isnew = _mm_cmpeq_epi8(code, _mm_setzero_si128());
+
+		__m128i sum = _mm_add_epi8(isnew, _mm_slli_si128(isnew, 1));
+		sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 2));
+		sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 4));
+		sum = _mm_add_epi8(sum, _mm_slli_si128(sum, 8));
+
+		__m128i v = _mm_sub_epi8(_mm_add_epi8(_mm_set1_epi8((char)next), _mm_sub_epi8(isnew, sum)), code);
+
+		if (literal_mask)
+		{
+			unsigned char mask0 = (unsigned char)(literal_mask & 0xff);
+			unsigned char mask1 = (unsigned char)(literal_mask >> 8);
+
+			__m128i sm0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeMeshletLiteralShuffle[mask0]));
+			__m128i sm1 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&kDecodeMeshletLiteralShuffle[mask1]));
+			__m128i sm1r = _mm_add_epi8(sm1, _mm_set1_epi8(kDecodeMeshletLiteralCount[mask0]));
+
+			__m128i lit = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_unpacklo_epi64(sm0, sm1r));
+
+			v = _mm_or_si128(_mm_and_si128(literal, lit), _mm_andnot_si128(literal, v));
+
+			data += kDecodeMeshletLiteralCount[mask0] + kDecodeMeshletLiteralCount[mask1];
+		}
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&triangles[j]), v);
+
+		int new_mask = _mm_movemask_epi8(isnew);
+		next += kDecodeMeshletLiteralCount[new_mask & 0xff] + kDecodeMeshletLiteralCount[new_mask >> 8];
+	}
+
+	data = decodeMeshletTriangles(triangles, j, index_count, codes, data, data_end, next);
+	if (!data)
+		return -2;
+
+	// we should've read all data bytes
+	if (data != data_end)
+		return -3;
+
+	return 0;
+}
+#endif
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+static unsigned int getCpuFeatures2()
+{
+	int cpuinfo[4] = {};
+#ifdef _MSC_VER
+	__cpuid(cpuinfo, 1);
+#else
+	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+	return cpuinfo[2];
+}
+
+static unsigned int cpuid2 = getCpuFeatures2();
+#endif
+
+} // namespace meshopt
+
+size_t meshopt_encodeMeshlet(unsigned char* buffer, size_t buffer_size, const unsigned int* vertices, size_t vertex_count, const unsigned char* triangles, size_t triangle_count)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeMeshlet");
+
+	assert(vertex_count <= 256);
+
+	size_t control_size = (vertex_count + 3) / 4;
+	size_t code_size = (triangle_count * 3 + 1) / 2;
+
+	// header, control bytes and triangle codes have fixed size; the rest depends on the data
+	if (buffer_size < 1 + control_size + code_size)
+		return 0;
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	*data++ = (unsigned char)(kMeshletHeader | 0);
+
+	unsigned char* control = data;
+	memset(control, 0, control_size);
+	data += control_size;
+
+	unsigned int last = 0;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int v = encodeZigZag(vertices[i] - last);
+		unsigned char length = getVertexLength(v);
+
+		// reserve space for triangle codes
+		if (size_t(data_end - data) < length + code_size)
+			return 0;
+
+		for (size_t k = 0; k < length; ++k)
+			*data++ = (unsigned char)(v >> (k * 8));
+
+		control[i / 4] |= (unsigned char)((length - 1) << ((i % 4) * 2));
+		last = vertices[i];
+	}
+
+	unsigned char* codes = data;
+	memset(codes, 0, code_size);
+	data += code_size;
+
+	// new vertices are expected to follow the order of first use, which is the case for meshopt_buildMeshlets and meshopt_optimizeMeshlet output
+	unsigned int next = 0;
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+	{
+		unsigned int v = triangles[i];
+		assert(v < vertex_count);
+
+		unsigned int code = kMeshletCodeLiteral;
+
+		if (v == next)
+			code = 0, next++;
+		else if (v < next && next - v < kMeshletCodeLiteral)
+			code = next - v;
+
+		if (code == kMeshletCodeLiteral)
+		{
+			if (data == data_end)
+				return 0;
+
+			*data++ = (unsigned char)v;
+		}
+
+		codes[i / 2] |= (unsigned char)(code << ((i & 1) * 4));
+	}
+
+	return data - buffer;
+}
+
+size_t meshopt_encodeMeshletBound(size_t max_vertices, size_t max_triangles)
+{
+	// header, control bytes and 4 bytes per vertex reference, and a code with a literal byte per index
+	return 1 + (max_vertices + 3) / 4 + max_vertices * 4 + (max_triangles * 3 + 1) / 2 + max_triangles * 3;
+}
+
+int meshopt_decodeMeshlet(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeMeshlet");
+
+	assert(vertex_count <= 256);
+
+	if (buffer_size < 1)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kMeshletHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 0)
+		return -1;
+
+#ifdef SIMD_SSE
+	assert(gDecodeMeshletInitialized);
+	(void)gDecodeMeshletInitialized;
+#endif
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	return (cpuid2 & (1 << 9)) ? decodeMeshletSimd(vertices, vertex_count, triangles, triangle_count, buffer, buffer_size) : decodeMeshlet(vertices, vertex_count, triangles, triangle_count, buffer, buffer_size);
+#elif defined(SIMD_SSE)
+	return decodeMeshletSimd(vertices, vertex_count, triangles, triangle_count, buffer, buffer_size);
+#else
+	return decodeMeshlet(vertices, vertex_count, triangles, triangle_count, buffer, buffer_size);
+#endif
+}
+
+#undef SIMD_SSE
+#undef SIMD_FALLBACK
+#undef SIMD_TARGET
@@ -28,6 +28,20 @@
 #endif
 #endif
 
+/* Set the storage specifier for per-thread allocation callbacks */
+#ifndef MESHOPTIMIZER_THREAD_LOCAL
+#ifdef _MSC_VER
+#define MESHOPTIMIZER_THREAD_LOCAL __declspec(thread)
+#else
+#define MESHOPTIMIZER_THREAD_LOCAL __thread
+#endif
+#endif
+
+/* Build the library with MESHOPTIMIZER_INSTRUMENTATION=1 to report events to the callback set via meshopt_setEventCallback */
+#ifndef MESHOPTIMIZER_INSTRUMENTATION
+#define MESHOPTIMIZER_INSTRUMENTATION 0
+#endif
+
 /* Experimental APIs have unstable interface and might have implementation that's not fully tested or optimized */
 #ifndef MESHOPTIMIZER_EXPERIMENTAL
 #define MESHOPTIMIZER_EXPERIMENTAL MESHOPTIMIZER_API
@@ -50,6 +64,13 @@ struct meshopt_Stream
 	size_t stride;
 };
 
+/**
+ * Experimental: Task scheduler callback
+ * Functions that accept a scheduler call it to run task(task_context, i) for every i in [0..count); the scheduler may run tasks concurrently (e.g. using a job system) and must return after all tasks are complete.
+ * context is the user pointer that was passed to the function along with the scheduler.
+ */
+typedef void (*meshopt_ParallelFor)(void* context, void (*task)(void* task_context, size_t index), void* task_context, size_t count);
+
 /**
  * Generates a vertex remap table from the vertex buffer and an optional index buffer and returns number of unique vertices
  * As a result, all vertices that are binary equivalent map to the same (new) location, with no gaps in the resulting sequence.
@@ -74,6 +95,23 @@ MESHOPTIMIZER_API size_t meshopt_generateVertexRemap(unsigned int* destination,
  */
 MESHOPTIMIZER_API size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count);
 
+/**
+ * Experimental: Parallel vertex remap generator
+ * Equivalent to meshopt_generateVertexRemap/meshopt_generateVertexRemapMulti and produces identical results, but partitions vertices into shards by hash that are deduplicated independently using parallel_for.
+ * Requires temporary memory for 3 additional integers per vertex; large meshes are processed in chunks of 64K vertices to distribute work.
+ * parallel_for can be NULL, in which case all work is done on the calling thread using the serial algorithm; the result doesn't depend on task scheduling.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapMultiParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Experimental: Vertex remap generator with caller-provided scratch memory
+ * Equivalent to meshopt_generateVertexRemap, but serves all temporary allocations from scratch memory owned by the caller, which must be 16-byte aligned.
+ * When scratch_size is at least meshopt_generateVertexRemapScratchSize, the function doesn't allocate memory; otherwise allocations that don't fit fall back to the allocator set via meshopt_setAllocator.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapScratchSize(size_t vertex_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateVertexRemapWithScratch(unsigned int* destination, const unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, void* scratch, size_t scratch_size);
+
 /**
  * Generates vertex buffer from the source vertex buffer and remap table generated by meshopt_generateVertexRemap
  *
@@ -153,6 +191,31 @@ MESHOPTIMIZER_API void meshopt_generateTessellationIndexBuffer(unsigned int* des
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateProvokingIndexBuffer(unsigned int* destination, unsigned int* reorder, const unsigned int* indices, size_t index_count, size_t vertex_count);
 
+/**
+ * Experimental: Triangle adjacency
+ * Holds per-vertex lists of adjacent triangles for an index buffer; it can be built once and passed to meshopt_optimizeVertexCacheWithAdjacency and meshopt_buildMeshletsWithAdjacency for the same index buffer to avoid rebuilding it in every call.
+ * Triangles adjacent to vertex v are data[offsets[v]..offsets[v+1]) in increasing order; degenerate triangles are listed once for every corner.
+ * The structure is read-only for all functions that use it, so it can be shared between threads.
+ */
+struct meshopt_TriangleAdjacency
+{
+	/* vertex_count + 1 offsets into data, and index_count triangle indices */
+	unsigned int* offsets;
+	unsigned int* data;
+
+	/* dimensions of the index buffer the adjacency was built for */
+	size_t index_count;
+	size_t vertex_count;
+};
+
+/**
+ * Experimental: Triangle adjacency builder
+ * Builds adjacency for the index buffer; triangles are grouped by vertex using counting sort, or using a radix sort with per-chunk histograms when parallel_for is specified. The memory must be released using meshopt_destroyTriangleAdjacency.
+ * parallel_for can be NULL, in which case all work is done on the calling thread; the result doesn't depend on task scheduling.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_buildTriangleAdjacency(struct meshopt_TriangleAdjacency* adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_destroyTriangleAdjacency(struct meshopt_TriangleAdjacency* adjacency);
+
 /**
  * Vertex transform cache optimizer
  * Reorders indices to reduce the number of GPU vertex shader invocations
@@ -162,6 +225,43 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_generateProvokingIndexBuffer(unsigned
  */
 MESHOPTIMIZER_API void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count);
 
+/**
+ * Experimental: Parallel vertex transform cache optimizer
+ * Equivalent to meshopt_optimizeVertexCache, but splits the mesh into chunks of chunk_size triangles that are optimized independently using parallel_for; the results are concatenated in chunk order.
+ * When vertex_positions is not NULL, triangles are partitioned into spatially compact chunks if that substantially reduces the number of vertices shared between chunks compared to input order; per-chunk state is proportional to chunk size instead of vertex count.
+ * Chunk boundaries slightly increase ACMR; with chunks of 64K triangles or more the difference is usually within 1%, which can be verified with meshopt_analyzeVertexCache.
+ * parallel_for can be NULL, in which case all work is done on the calling thread; the result doesn't depend on task scheduling.
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex, and can be NULL to always split the mesh into chunks in input order
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const float* vertex_positions, size_t vertex_positions_stride, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Experimental: Vertex transform cache optimizer with precomputed adjacency
+ * Equivalent to meshopt_optimizeVertexCache, but uses adjacency built with meshopt_buildTriangleAdjacency for the same index buffer instead of building it.
+ * adjacency can be NULL, in which case it is built internally.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheWithAdjacency(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_TriangleAdjacency* adjacency);
+
+/**
+ * Experimental: Vertex transform cache optimizer with caller-provided scratch memory
+ * Equivalent to meshopt_optimizeVertexCache, but serves all temporary allocations from scratch memory owned by the caller, which must be 16-byte aligned.
+ * When scratch_size is at least meshopt_optimizeVertexCacheScratchSize, the function doesn't allocate memory; otherwise allocations that don't fit fall back to the allocator set via meshopt_setAllocator.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_optimizeVertexCacheScratchSize(size_t index_count, size_t vertex_count);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheWithScratch(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, void* scratch, size_t scratch_size);
+
+/**
+ * Experimental: Vertex transform cache optimizer with custom vertex scores
+ * Equivalent to meshopt_optimizeVertexCache, but uses the provided vertex score tables instead of the built-in tables; this can be used to target specific hardware with tables produced by tools/vcachetuner.
+ * The score of a vertex is the sum of its cache score and its live score; the optimizer greedily emits the triangle with the highest sum of vertex scores.
+ *
+ * cache_scores must contain 16 scores; cache_scores[i] is the score of a vertex at position i in the simulated cache
+ * live_scores must contain 8 scores; live_scores[i] is the score of a vertex with i+1 remaining triangles (vertices with more than 8 remaining triangles use live_scores[7])
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeVertexCacheWithScores(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const float* cache_scores, const float* live_scores);
+
 /**
  * Vertex transform cache optimizer for strip-like caches
  * Produces inferior results to meshopt_optimizeVertexCache from the GPU vertex cache perspective
@@ -194,6 +294,13 @@ MESHOPTIMIZER_API void meshopt_optimizeVertexCacheFifo(unsigned int* destination
  */
 MESHOPTIMIZER_API void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold);
 
+/**
+ * Experimental: Parallel overdraw optimizer
+ * Equivalent to meshopt_optimizeOverdraw and produces identical results, but splits cluster generation and sorting into tasks that are executed using parallel_for.
+ * parallel_for can be NULL, in which case all work is done on the calling thread; the result doesn't depend on task scheduling.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeOverdrawParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Vertex fetch cache optimizer
  * Reorders vertices and changes indices to reduce the amount of GPU memory fetches during vertex processing
@@ -215,6 +322,33 @@ MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetch(void* destination, unsigned
  */
 MESHOPTIMIZER_API size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count);
 
+/**
+ * Mesh optimization options
+ */
+enum
+{
+	/* Do not merge vertices that are binary equivalent across all streams; useful when the mesh has been indexed already. */
+	meshopt_OptimizeMeshSkipRemap = 1 << 0,
+	/* Use meshopt_optimizeVertexCacheStrip order instead of meshopt_optimizeVertexCache order, which improves compression and stripification at the cost of vertex cache efficiency. */
+	meshopt_OptimizeMeshStrip = 1 << 1,
+	/* Reorder triangles to reduce overdraw using meshopt_optimizeOverdraw with overdraw_threshold; requires float3 positions in the first 12 bytes of the first stream. */
+	meshopt_OptimizeMeshOverdraw = 1 << 2,
+};
+
+/**
+ * Experimental: Mesh optimization pipeline
+ * Merges binary equivalent vertices, optimizes the index buffer for vertex cache (and optionally overdraw) and reorders vertices for vertex fetch, producing the same result as the equivalent sequence of calls to meshopt_generateVertexRemapMulti, meshopt_remapIndexBuffer/meshopt_remapVertexBuffer, meshopt_optimizeVertexCache, meshopt_optimizeOverdraw and meshopt_optimizeVertexFetch.
+ * Vertex data is written to the final location in a single pass for each stream, and parallel_for (which can be NULL) is used to run remap generation, adjacency construction, overdraw optimization and vertex data movement as parallel tasks.
+ * Returns the number of unique vertices in the resulting vertex buffers
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements)
+ * vertex_destinations must contain stream_count pointers, each with enough space for vertex_count elements of streams[i].size bytes; the output streams are tightly packed
+ * vertex_destinations[i] can be equal to streams[i].data for in-place optimization
+ * stream_count must be <= 16 unless meshopt_OptimizeMeshSkipRemap is used
+ * options must be a bitmask composed of meshopt_OptimizeMeshX options; 0 is a safe default
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_optimizeMesh(unsigned int* destination, void* const* vertex_destinations, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, unsigned int options, float overdraw_threshold, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Index buffer encoder
  * Encodes index data into an array of bytes that is generally much smaller (<1.5 bytes/triangle) and compresses better (<1 bytes/triangle) compared to original.
@@ -238,11 +372,40 @@ MESHOPTIMIZER_API void meshopt_encodeIndexVersion(int version);
  * Decodes index data from an array of bytes generated by meshopt_encodeIndexBuffer
  * Returns 0 if decoding was successful, and an error code otherwise
  * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ * Destination memory is written sequentially and is never read from, so 16-bit or 32-bit indices can be decoded directly into write-combined memory (e.g. a persistently mapped GPU buffer).
  *
  * destination must contain enough space for the resulting index buffer (index_count elements)
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexBuffer(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Chunked index buffer encoder
+ * Encodes index data into a sequence of chunks with chunk_size indices each, prefixed by a chunk table; each chunk is encoded as a separate index buffer stream, which resets edge/vertex FIFO state at chunk boundaries.
+ * New vertices in each chunk are expected to continue after the largest index of the previous chunks, so for best compression the mesh should be optimized with meshopt_optimizeVertexFetch.
+ * Since each chunk is independent, chunks can be encoded in parallel by passing a scheduler, and decoded in parallel using meshopt_decodeIndexBufferChunks; this comes at a small compression cost per chunk.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * The encoded data is *not* compatible with meshopt_decodeIndexBuffer.
+ *
+ * buffer must contain enough space for the encoded index buffer (use meshopt_encodeIndexBufferChunkedBound to compute worst case size)
+ * chunk_size must be divisible by 3 and should be large enough to amortize the chunk overhead (e.g. 65536 indices)
+ * parallel_for can be NULL to encode all chunks on the calling thread; chunks are also encoded serially if buffer_size is smaller than the worst case size
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferChunked(unsigned char* buffer, size_t buffer_size, const unsigned int* indices, size_t index_count, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferChunkedBound(size_t index_count, size_t vertex_count, size_t chunk_size);
+
+/**
+ * Experimental: Chunked index buffer decoder
+ * Decodes index data for chunks [chunk_begin..chunk_end) from an array of bytes generated by meshopt_encodeIndexBufferChunked
+ * Different chunk ranges can be decoded concurrently from multiple threads into the same destination buffer.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ *
+ * destination must contain enough space for the entire index buffer (index_count elements), even if only a subset of chunks is decoded
+ * meshopt_decodeIndexBufferChunkCount returns the total number of chunks in the buffer, or 0 if the buffer is malformed
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexBufferChunks(void* destination, size_t index_count, size_t index_size, size_t chunk_begin, size_t chunk_end, const unsigned char* buffer, size_t buffer_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_decodeIndexBufferChunkCount(size_t index_count, const unsigned char* buffer, size_t buffer_size);
+
 /**
  * Index sequence encoder
  * Encodes index sequence into an array of bytes that is generally smaller and compresses better compared to original.
@@ -259,11 +422,43 @@ MESHOPTIMIZER_API size_t meshopt_encodeIndexSequenceBound(size_t index_count, si
  * Decodes index data from an array of bytes generated by meshopt_encodeIndexSequence
  * Returns 0 if decoding was successful, and an error code otherwise
  * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ * Destination memory is written sequentially and is never read from, so 16-bit or 32-bit indices can be decoded directly into write-combined memory (e.g. a persistently mapped GPU buffer).
  *
  * destination must contain enough space for the resulting index sequence (index_count elements)
  */
 MESHOPTIMIZER_API int meshopt_decodeIndexSequence(void* destination, size_t index_count, size_t index_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Streaming decoder state
+ * Tracks the progress of incremental decoding with meshopt_decodeVertexStream/meshopt_decodeIndexStream; initialize with meshopt_decodeVertexStreamInit/meshopt_decodeIndexStreamInit.
+ */
+struct meshopt_DecodeStream
+{
+	/* number of elements (vertices or indices) decoded so far; elements [0..decoded) of destination contain final data */
+	size_t decoded;
+
+	/* internal state; must not be modified by the caller */
+	size_t count;
+	size_t size;
+	size_t buffer_size;
+	size_t offset;
+	unsigned int last[2];
+};
+
+/**
+ * Experimental: Streaming index decoder
+ * Decodes index data incrementally as the encoded data arrives; each call receives the prefix of the encoded buffer that is available so far (available bytes out of buffer_size).
+ * Streams produced by meshopt_encodeIndexSequence are decoded index by index as soon as the data for each index is available.
+ * Streams produced by meshopt_encodeIndexBuffer are not decoded progressively: the codec tables needed to decode any triangle are stored at the end of the stream, so stream->decoded stays 0 until the entire buffer is available; use meshopt_encodeIndexSequence when progressive decoding matters.
+ * Returns 0 if decoding is complete, 1 if more data is needed, and an error code otherwise; stream->decoded can be used to find out how many indices are ready.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ *
+ * destination must contain enough space for the resulting index buffer (index_count elements) and must be the same for all calls
+ * buffer must point to the same memory for all calls, with available increasing monotonically up to buffer_size
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeIndexStreamInit(struct meshopt_DecodeStream* stream, size_t index_count, size_t index_size, size_t buffer_size);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeIndexStream(struct meshopt_DecodeStream* stream, void* destination, const unsigned char* buffer, size_t available);
+
 /**
  * Vertex buffer encoder
  * Encodes vertex data into an array of bytes that is generally smaller and compresses better compared to original.
@@ -283,6 +478,44 @@ MESHOPTIMIZER_API size_t meshopt_encodeVertexBufferBound(size_t vertex_count, si
  */
 MESHOPTIMIZER_API void meshopt_encodeVertexVersion(int version);
 
+/**
+ * Experimental: Encoder context
+ * Holds encoding settings and scratch memory that is reused between calls; unlike meshopt_encodeVertexVersion/meshopt_encodeIndexVersion, settings only affect calls that use the context.
+ * Contexts are not thread-safe, but different threads can use separate contexts concurrently; initialize with meshopt_encodeContextInit and release memory with meshopt_encodeContextDestroy.
+ */
+struct meshopt_EncodeContext
+{
+	/* data format versions; see meshopt_encodeVertexVersion/meshopt_encodeIndexVersion for valid values */
+	int vertex_version;
+	int index_version;
+
+	/* encoded data produced by the last encoding call; remains valid until the next call that uses the context */
+	unsigned char* buffer;
+
+	/* internal state; must not be modified by the caller */
+	size_t buffer_capacity;
+	unsigned int* indices;
+	size_t indices_capacity;
+};
+
+/**
+ * Experimental: Encoder context initialization
+ * Sets vertex_version and index_version to the most recent versions (0 and 1 respectively).
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeContextInit(struct meshopt_EncodeContext* context);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_encodeContextDestroy(struct meshopt_EncodeContext* context);
+
+/**
+ * Experimental: Encoders with context
+ * Equivalent to meshopt_encodeVertexBuffer/meshopt_encodeIndexBuffer/meshopt_encodeIndexSequence, but use the versions specified in the context and store the output in context->buffer, which grows as necessary.
+ * Returns encoded data size.
+ *
+ * index_size must be 2 or 4; 16-bit indices are widened using context memory
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferContext(struct meshopt_EncodeContext* context, const void* vertices, size_t vertex_count, size_t vertex_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexBufferContext(struct meshopt_EncodeContext* context, const void* indices, size_t index_count, size_t index_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeIndexSequenceContext(struct meshopt_EncodeContext* context, const void* indices, size_t index_count, size_t index_size);
+
 /**
  * Vertex buffer decoder
  * Decodes vertex data from an array of bytes generated by meshopt_encodeVertexBuffer
@@ -293,6 +526,46 @@ MESHOPTIMIZER_API void meshopt_encodeVertexVersion(int version);
  */
 MESHOPTIMIZER_API int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size);
 
+/**
+ * Experimental: Chunked vertex buffer encoder
+ * Encodes vertex data into a sequence of chunks with chunk_size vertices each, prefixed by a chunk table; each chunk is encoded as a separate vertex stream.
+ * Since each chunk is decodable independently, chunks can be decoded in parallel using meshopt_decodeVertexBufferChunks; this comes at a small compression cost per chunk.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * The encoded data is *not* compatible with meshopt_decodeVertexBuffer.
+ *
+ * buffer must contain enough space for the encoded vertex buffer (use meshopt_encodeVertexBufferChunkedBound to compute worst case size)
+ * chunk_size should be large enough to amortize the chunk overhead (e.g. 16384 vertices)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferChunked(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, size_t chunk_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeVertexBufferChunkedBound(size_t vertex_count, size_t vertex_size, size_t chunk_size);
+
+/**
+ * Experimental: Chunked vertex buffer decoder
+ * Decodes vertex data for chunks [chunk_begin..chunk_end) from an array of bytes generated by meshopt_encodeVertexBufferChunked
+ * Different chunk ranges can be decoded concurrently from multiple threads into the same destination buffer.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * The decoder is safe to use for untrusted input, but it may produce garbage data.
+ *
+ * destination must contain enough space for the entire vertex buffer (vertex_count * vertex_size bytes), even if only a subset of chunks is decoded
+ * meshopt_decodeVertexBufferChunkCount returns the total number of chunks in the buffer, or 0 if the buffer is malformed
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferChunks(void* destination, size_t vertex_count, size_t vertex_size, size_t chunk_begin, size_t chunk_end, const unsigned char* buffer, size_t buffer_size);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_decodeVertexBufferChunkCount(size_t vertex_count, const unsigned char* buffer, size_t buffer_size);
+
+/**
+ * Experimental: Streaming vertex buffer decoder
+ * Decodes vertex data incrementally as the encoded data arrives; each call receives the prefix of the encoded buffer that is available so far (available bytes out of buffer_size).
+ * Streams produced by meshopt_encodeVertexBufferChunked are decoded one chunk at a time as soon as each chunk is fully available.
+ * Streams produced by meshopt_encodeVertexBuffer are not decoded progressively: the base vertex and channel data needed to decode the first block are stored at the end of the stream, so stream->decoded stays 0 until the entire buffer is available; use meshopt_encodeVertexBufferChunked when progressive decoding matters.
+ * Returns 0 if decoding is complete, 1 if more data is needed, and an error code otherwise; stream->decoded can be used to find out how many vertices are ready.
+ * The decoder is safe to use for untrusted input, but it may produce garbage data.
+ *
+ * destination must contain enough space for the resulting vertex buffer (vertex_count * vertex_size bytes) and must be the same for all calls
+ * buffer must point to the same memory for all calls, with available increasing monotonically up to buffer_size
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_decodeVertexStreamInit(struct meshopt_DecodeStream* stream, size_t vertex_count, size_t vertex_size, size_t buffer_size);
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexStream(struct meshopt_DecodeStream* stream, void* destination, const unsigned char* buffer, size_t available);
+
 /**
  * Vertex buffer filters
  * These functions can be used to filter output of meshopt_decodeVertexBuffer in-place.
@@ -310,6 +583,78 @@ MESHOPTIMIZER_API void meshopt_decodeFilterOct(void* buffer, size_t count, size_
 MESHOPTIMIZER_API void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride);
 MESHOPTIMIZER_API void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride);
 
+/**
+ * Experimental: Vertex buffer decoder with filter
+ * Decodes vertex data like meshopt_decodeVertexBuffer and applies the specified filter to each decoded block while it's still in cache.
+ * This is equivalent to calling meshopt_decodeVertexBuffer followed by the respective meshopt_decodeFilter function, but requires a single pass over destination memory.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * vertex_size must be valid for the selected filter (see meshopt_decodeFilter functions)
+ */
+enum meshopt_DecodeFilter
+{
+	/* No filter; equivalent to meshopt_decodeVertexBuffer */
+	meshopt_DecodeFilterNone,
+	/* Octahedral filter; see meshopt_decodeFilterOct */
+	meshopt_DecodeFilterOct,
+	/* Quaternion filter; see meshopt_decodeFilterQuat */
+	meshopt_DecodeFilterQuat,
+	/* Exponential filter; see meshopt_decodeFilterExp */
+	meshopt_DecodeFilterExp,
+};
+
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, enum meshopt_DecodeFilter filter);
+
+/**
+ * Experimental: Strided vertex buffer decoder
+ * Decodes vertex data like meshopt_decodeVertexBufferFiltered, but writes each vertex to destination + i * vertex_stride; this can be used to decode a single attribute directly into an interleaved vertex buffer.
+ * Destination memory is written sequentially and is never read from, so it can point to write-combined memory (e.g. a persistently mapped GPU buffer).
+ * Returns 0 if decoding was successful, and an error code otherwise
+ *
+ * destination must point to the first vertex (e.g. the attribute offset within an interleaved buffer) and contain enough space for vertex_count vertices with the given stride
+ * vertex_stride must be greater than or equal to vertex_size; only vertex_size bytes of each vertex are written
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeVertexBufferStrided(void* destination, size_t vertex_count, size_t vertex_size, size_t vertex_stride, const unsigned char* buffer, size_t buffer_size, enum meshopt_DecodeFilter filter);
+
+/**
+ * Experimental: Batched decoder
+ * Decodes a set of independent buffers, such as glTF buffer views that use EXT_meshopt_compression, with a single call.
+ * When parallel_for is specified, buffers are decoded as separate tasks, with largest buffers scheduled first to balance the load.
+ * Returns 0 if all buffers were decoded successfully, and the error code of the first failing item otherwise; each item's result is stored in its result field
+ * The decoder is safe to use for untrusted input, but it may produce garbage data.
+ *
+ * parallel_for can be NULL to decode all buffers on the calling thread
+ */
+enum meshopt_DecodeMode
+{
+	/* Vertex data; see meshopt_decodeVertexBuffer */
+	meshopt_DecodeModeAttributes,
+	/* Triangle list index data; see meshopt_decodeIndexBuffer */
+	meshopt_DecodeModeTriangles,
+	/* Index sequence data; see meshopt_decodeIndexSequence */
+	meshopt_DecodeModeIndices,
+};
+
+struct meshopt_DecodeItem
+{
+	/* destination must contain enough space for count elements of the given size */
+	void* destination;
+	size_t count;
+	size_t size;
+
+	const unsigned char* buffer;
+	size_t buffer_size;
+
+	enum meshopt_DecodeMode mode;
+	/* filter must be meshopt_DecodeFilterNone for index data */
+	enum meshopt_DecodeFilter filter;
+
+	/* output: 0 if decoding was successful, and an error code otherwise */
+	int result;
+};
+
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeBatch(struct meshopt_DecodeItem* items, size_t item_count, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Vertex buffer filter encoders
  * These functions can be used to encode data in a format that meshopt_decodeFilter can decode
@@ -355,6 +700,8 @@ enum
 	meshopt_SimplifyErrorAbsolute = 1 << 2,
 	/* Experimental: remove disconnected parts of the mesh during simplification incrementally, regardless of the topological restrictions inside components. */
 	meshopt_SimplifyPrune = 1 << 3,
+	/* Experimental: perform collapses in the order of increasing error using a priority queue that is updated incrementally, instead of re-evaluating all collapses after each batch. Often produces lower error for aggressive targets. */
+	meshopt_SimplifyPriorityQueue = 1 << 4,
 };
 
 /**
@@ -386,6 +733,119 @@ MESHOPTIMIZER_API size_t meshopt_simplify(unsigned int* destination, const unsig
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error);
 
+/**
+ * Experimental: Mesh simplifier with parallel execution
+ * Produces the same result as meshopt_simplifyWithAttributes, but runs quadric setup and collapse ranking as parallel tasks; collapses are still performed serially.
+ * The result is deterministic and doesn't depend on the number of threads or the order in which tasks are executed.
+ * Parallel execution requires up to ~24 extra bytes of memory per index.
+ *
+ * vertex_attributes can be NULL when attribute_count is 0
+ * parallel_for can be NULL, in which case all work is performed on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Experimental: Mesh simplifier for LOD chains
+ * Generates lod_count levels of detail in a single progressive simplification run; each level continues from the previous one, so the cost is similar to one meshopt_simplifyWithAttributes call for the coarsest level.
+ * Returns the total number of indices written; levels are stored in destination one after another, with lod_index_counts[i] indices and lod_errors[i] error for level i.
+ * Errors are non-decreasing and index counts are non-increasing across levels; like meshopt_simplify, a level may stop short of its target index count when it reaches the target error.
+ *
+ * destination must contain enough space for the worst case output, which is index_count * lod_count indices
+ * lod_index_counts and lod_errors should have lod_count elements; lod_errors can be NULL
+ * target_index_counts and target_errors should have lod_count elements with per-level targets, typically with decreasing index counts and increasing errors
+ * vertex_attributes, attribute_weights and vertex_lock are interpreted as in meshopt_simplifyWithAttributes; vertex_attributes can be NULL when attribute_count is 0
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyLods(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options);
+
+/**
+ * Experimental: Simplifier context
+ * Holds scratch memory that is reused between simplification calls; scratch memory grows as necessary, and can be reserved upfront to avoid any allocations during simplification.
+ * Contexts are not thread-safe, but different threads can use separate contexts concurrently; initialize with meshopt_simplifyContextInit and release memory with meshopt_simplifyContextDestroy.
+ */
+struct meshopt_SimplifyContext
+{
+	/* internal state; must not be modified by the caller */
+	void* scratch;
+	size_t scratch_size;
+};
+
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyContextInit(struct meshopt_SimplifyContext* context);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyContextDestroy(struct meshopt_SimplifyContext* context);
+
+/**
+ * Experimental: Simplifier context scratch memory
+ * meshopt_simplifyScratchSize returns the worst case scratch size required by meshopt_simplifyWithContext for a mesh with the given parameters.
+ * meshopt_simplifyContextReserve grows context scratch memory to at least scratch_size bytes; to simplify many meshes without allocations, reserve the maximum scratch size upfront.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyScratchSize(size_t index_count, size_t vertex_count, size_t attribute_count, unsigned int options);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyContextReserve(struct meshopt_SimplifyContext* context, size_t scratch_size);
+
+/**
+ * Experimental: Mesh simplifier with context
+ * Equivalent to meshopt_simplifyWithAttributes, but uses context scratch memory for all temporary allocations; attribute_count can be 0, in which case vertex_attributes and attribute_weights can be NULL.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithContext(struct meshopt_SimplifyContext* context, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error);
+
+/**
+ * Experimental: Mesh simplifier with caller-provided scratch memory
+ * Equivalent to meshopt_simplifyWithContext, but serves all temporary allocations from scratch memory owned by the caller, which must be 16-byte aligned.
+ * When scratch_size is at least meshopt_simplifyScratchSize for the same parameters, the function doesn't allocate memory; otherwise allocations that don't fit fall back to the allocator set via meshopt_setAllocator.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithScratch(void* scratch, size_t scratch_size, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error);
+
+/**
+ * Experimental: Simplifier statistics
+ * Describes the work performed by the simplifier, to help understand why simplification is slow or stops short of the target.
+ * Counters are accumulated over all passes; a candidate collapse that is picked again in a later pass is counted again.
+ * timer is set by the caller and can be NULL; when it's not NULL, it should return the current time in any units (e.g. seconds), and phase times are reported in the same units.
+ */
+struct meshopt_SimplifyStats
+{
+	double (*timer)(void);
+
+	/* number of simplification passes; with meshopt_SimplifyPriorityQueue, each pass rebuilds the queue */
+	size_t passes;
+
+	/* number of candidate collapses picked at the start of each pass, and number of those above the error limit */
+	size_t candidates;
+	size_t candidates_over_error;
+
+	/* number of collapses performed; number of candidates rejected because they would flip a triangle, and because they involve a vertex that was already moved by an earlier collapse */
+	size_t collapses;
+	size_t rejected_flip;
+	size_t rejected_moved;
+
+	/* number of components pruned by meshopt_SimplifyPrune, and number of triangles they had left at the time of pruning */
+	size_t pruned_components;
+	size_t pruned_triangles;
+
+	/* time spent building adjacency and classifying vertices, computing quadrics, picking and ranking candidates, sorting candidates and performing collapses */
+	double time_adjacency;
+	double time_quadrics;
+	double time_rank;
+	double time_sort;
+	double time_collapse;
+};
+
+/**
+ * Experimental: Mesh simplifier with statistics
+ * Equivalent to meshopt_simplifyWithAttributes, but fills stats with information about the simplification process; all fields except timer are overwritten.
+ * attribute_count can be 0, in which case vertex_attributes and attribute_weights can be NULL.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyWithStats(struct meshopt_SimplifyStats* stats, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error);
+
+/**
+ * Experimental: Tiled mesh simplifier for very large meshes
+ * Splits the mesh into spatially coherent tiles of tile_size triangles and simplifies each tile separately with borders between tiles locked; a second sweep uses a different tiling to simplify the regions around the first sweep borders.
+ * Since simplification state is only needed for one tile at a time, peak memory is bounded by tile size, except for ~10 bytes per vertex of global state and temporary memory used by meshopt_spatialSortTriangles.
+ * Returns the number of indices after simplification; the resulting triangles are ordered spatially. The result is usually a little worse than meshopt_simplifyWithAttributes and may exceed the target index count.
+ *
+ * tile_size should be large enough to amortize the cost of locked borders (e.g. 256K triangles)
+ * parallel_for can be NULL, in which case tiles are simplified on the calling thread; otherwise each task simplifies one tile and the result doesn't depend on the order of task execution
+ * other parameters are interpreted as in meshopt_simplifyWithAttributes; destination should not be equal to indices to avoid an extra copy of the index buffer
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyTiled(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, size_t tile_size, float* result_error, meshopt_ParallelFor parallel_for, void* context);
+
 /**
  * Experimental: Mesh simplifier (sloppy)
  * Reduces the number of triangles in the mesh, sacrificing mesh appearance for simplification performance
@@ -415,6 +875,44 @@ MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifySloppy(unsigned int* destinati
  */
 MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_colors, size_t vertex_colors_stride, float color_weight, size_t target_vertex_count);
 
+/**
+ * Experimental: Streaming point cloud simplifier
+ * Reduces the number of points in a cloud that is too large to process at once; points are added in batches, and only a bounded number of grid cells is kept between batches.
+ * Memory usage is bounded by ~600 bytes per target point and doesn't depend on the number of points added; the result is usually a little worse than meshopt_simplifyPoints.
+ * To process points in parallel, use a separate stream for each thread and merge them with meshopt_simplifyPointsStreamMerge before calling meshopt_simplifyPointsStreamFinish.
+ * Streams are not thread-safe; initialize with meshopt_simplifyPointsStreamInit and release memory with meshopt_simplifyPointsStreamDestroy.
+ *
+ * bounds_min and bounds_max should contain float3 bounds of all points that will be added; points outside of the bounds are clamped
+ * color_weight and target_vertex_count are interpreted as in meshopt_simplifyPoints
+ */
+struct meshopt_PointStream
+{
+	/* internal state; must not be modified by the caller */
+	void* state;
+};
+
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyPointsStreamInit(struct meshopt_PointStream* stream, const float* bounds_min, const float* bounds_max, float color_weight, size_t target_vertex_count);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyPointsStreamDestroy(struct meshopt_PointStream* stream);
+
+/**
+ * Experimental: Streaming point cloud simplifier input
+ * meshopt_simplifyPointsStreamAdd adds vertex_count points to the stream; the resulting indices for these points start from base_index.
+ * meshopt_simplifyPointsStreamMerge adds all points from other stream to the stream; both streams must be initialized with the same parameters, and other stream is not modified.
+ *
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex
+ * vertex_colors can be NULL; when it's not NULL, it should have float3 color in the first 12 bytes of each vertex
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyPointsStreamAdd(struct meshopt_PointStream* stream, unsigned int base_index, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_colors, size_t vertex_colors_stride);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_simplifyPointsStreamMerge(struct meshopt_PointStream* stream, const struct meshopt_PointStream* other);
+
+/**
+ * Experimental: Streaming point cloud simplifier output
+ * Returns the number of points after simplification, with destination containing indices of the selected points; the stream can be used again after this call.
+ *
+ * destination must contain enough space for the target index buffer (target_vertex_count elements)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_simplifyPointsStreamFinish(struct meshopt_PointStream* stream, unsigned int* destination);
+
 /**
  * Returns the error scaling factor used by the simplifier to convert between absolute and relative extents
  *
@@ -477,6 +975,17 @@ struct meshopt_OverdrawStatistics
  */
 MESHOPTIMIZER_API struct meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
+/**
+ * Experimental: Overdraw analyzer with configurable resolution and views
+ * Equivalent to meshopt_analyzeOverdraw, which uses resolution 256 and 3 views; higher resolution improves accuracy for dense meshes, and more views improve coverage of view directions.
+ * The first 3 views are axis-aligned; remaining views are distributed uniformly over the sphere. Each band of viewport rows is rasterized by a separate task executed using parallel_for.
+ * parallel_for can be NULL, in which case all work is done on the calling thread; the result doesn't depend on task scheduling.
+ *
+ * resolution must be between 1 and 1024
+ * view_count must be >= 1
+ */
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t resolution, size_t view_count, meshopt_ParallelFor parallel_for, void* context);
+
 struct meshopt_VertexFetchStatistics
 {
 	unsigned int bytes_fetched;
@@ -490,6 +999,41 @@ struct meshopt_VertexFetchStatistics
  */
 MESHOPTIMIZER_API struct meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const unsigned int* indices, size_t index_count, size_t vertex_count, size_t vertex_size);
 
+/**
+ * Experimental: Hardware profiles for vertex cache analysis
+ * Each profile corresponds to meshopt_analyzeVertexCache parameters (cache_size, warp_size, primgroup_size) that approximate the behavior of the respective hardware.
+ */
+enum meshopt_CacheProfile
+{
+	/* Generic FIFO cache with 16 entries and no warp or primitive group limits: 16, 0, 0 */
+	meshopt_CacheProfileGeneric,
+	/* NVidia Pascal: 32, 32, 32 */
+	meshopt_CacheProfileNVidia,
+	/* AMD GCN: 14, 64, 128 */
+	meshopt_CacheProfileAMD,
+	/* Intel: 128, 0, 0 */
+	meshopt_CacheProfileIntel,
+
+	meshopt_CacheProfile_Count,
+};
+
+struct meshopt_MeshStatistics
+{
+	struct meshopt_VertexCacheStatistics vertex_cache[meshopt_CacheProfile_Count]; /* indexed by meshopt_CacheProfile */
+	struct meshopt_VertexFetchStatistics vertex_fetch;
+	struct meshopt_OverdrawStatistics overdraw; /* zero when vertex_positions is NULL */
+};
+
+/**
+ * Experimental: Combined mesh analyzer
+ * Returns vertex cache statistics for all hardware profiles and vertex fetch statistics, computed in a single pass over the index buffer; the results are identical to meshopt_analyzeVertexCache and meshopt_analyzeVertexFetch.
+ * When vertex_positions is not NULL, overdraw statistics are computed using meshopt_analyzeOverdraw as well, which is significantly more expensive.
+ * Results may not match actual GPU performance
+ *
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex, or be NULL
+ */
+MESHOPTIMIZER_EXPERIMENTAL struct meshopt_MeshStatistics meshopt_analyzeMesh(const unsigned int* indices, size_t index_count, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride);
+
 /**
  * Meshlet is a small mesh cluster (subset) that consists of:
  * - triangles, an 8-bit micro triangle (index) buffer, that for each triangle specifies three local vertices to use;
@@ -527,6 +1071,90 @@ MESHOPTIMIZER_API size_t meshopt_buildMeshlets(struct meshopt_Meshlet* meshlets,
 MESHOPTIMIZER_API size_t meshopt_buildMeshletsScan(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 MESHOPTIMIZER_API size_t meshopt_buildMeshletsBound(size_t index_count, size_t max_vertices, size_t max_triangles);
 
+/**
+ * Experimental: Meshlet builder with precomputed adjacency
+ * Equivalent to meshopt_buildMeshlets, but uses adjacency built with meshopt_buildTriangleAdjacency for the same index buffer instead of building it.
+ * adjacency can be NULL, in which case it is built internally.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsWithAdjacency(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, const struct meshopt_TriangleAdjacency* adjacency);
+
+/**
+ * Experimental: Meshlet builder with caller-provided scratch memory
+ * Equivalent to meshopt_buildMeshlets, but serves all temporary allocations from scratch memory owned by the caller, which must be 16-byte aligned.
+ * When scratch_size is at least meshopt_buildMeshletsScratchSize, the function doesn't allocate memory; otherwise allocations that don't fit fall back to the allocator set via meshopt_setAllocator.
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsScratchSize(size_t index_count, size_t vertex_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsWithScratch(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, void* scratch, size_t scratch_size);
+
+/**
+ * Experimental: Parallel meshlet builder
+ * Splits the mesh into spatially coherent regions of region_size triangles and builds meshlets for each region separately; the results are concatenated in region order.
+ * Per-vertex state is only allocated for one region at a time; meshlets never cross region borders, so the result usually has slightly more meshlets than meshopt_buildMeshlets.
+ * When the mesh has at most region_size triangles, the result is the same as meshopt_buildMeshlets.
+ *
+ * meshlets must contain enough space for all meshlets, worst case size can be computed with meshopt_buildMeshletsParallelBound; meshlet_vertices and meshlet_triangles are sized from that bound as in meshopt_buildMeshlets
+ * region_size should be large enough to amortize the cost of region borders (e.g. 64K triangles)
+ * parallel_for can be NULL, in which case regions are processed on the calling thread; otherwise each task processes one region and the result doesn't depend on the order of task execution
+ * other parameters are interpreted as in meshopt_buildMeshlets
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsParallel(struct meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, size_t region_size, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletsParallelBound(size_t index_count, size_t max_vertices, size_t max_triangles, size_t region_size);
+
+/**
+ * Experimental: Cluster hierarchy
+ * A cluster hierarchy (DAG) for continuous level of detail: original clusters are merged into groups of neighboring clusters, every group is simplified with its border locked and split into new clusters, and so on.
+ * LODBounds are bounding spheres with an absolute error; a cluster should be rendered when the error of self bounds projected to the screen is acceptable but the error of parent bounds is not.
+ * Errors are monotonic: a cluster's parent error is never smaller than its own error, and bounds of every group contain bounds of all clusters merged into it.
+ */
+struct meshopt_LODBounds
+{
+	float center[3];
+	float radius;
+	float error;
+};
+
+struct meshopt_LODCluster
+{
+	/* cluster triangles are stored in consecutive range of cluster_indices defined by offset and count */
+	unsigned int index_offset;
+	unsigned int index_count;
+
+	/* 0 for clusters of the original mesh, otherwise the hierarchy level that produced the cluster */
+	unsigned int depth;
+
+	/* group that the cluster was merged into; ~0u if the cluster wasn't simplified further, in which case parent.error is FLT_MAX */
+	unsigned int parent_group;
+
+	struct meshopt_LODBounds self;
+	struct meshopt_LODBounds parent;
+};
+
+struct meshopt_LODGroup
+{
+	/* clusters produced by simplifying the group are stored in consecutive range of clusters defined by offset and count */
+	unsigned int cluster_offset;
+	unsigned int cluster_count;
+
+	/* shared bounds of the group; equal to parent bounds of the merged clusters and to self bounds of the produced clusters */
+	struct meshopt_LODBounds bounds;
+};
+
+/**
+ * Experimental: Cluster hierarchy builder
+ * Splits the mesh into clusters and builds a cluster DAG by repeatedly merging spatially coherent groups of group_size clusters and simplifying them to ~half the triangle count.
+ * Returns the number of clusters; group_count receives the number of groups. Clusters of one level are stored before the clusters produced from them.
+ * Groups of each level are simplified and clusterized in parallel; the result doesn't depend on the order of task execution.
+ *
+ * clusters and cluster_indices receive the output and must have space for max_clusters and max_indices elements; groups must have space for max_clusters / 2 groups
+ * max_indices must be at least index_count; when it's 20/3 * index_count the hierarchy is always complete, typical hierarchies need ~2x index_count, and once the space runs out clusters that don't fit are left without a parent
+ * max_clusters must be at least meshopt_buildClusterHierarchyBound(max_indices, max_vertices, max_triangles)
+ * max_vertices and max_triangles limit the size of each cluster and are interpreted as in meshopt_buildMeshlets; group_size should be 4..16 (e.g. 8)
+ * vertex_attributes and attribute_weights are interpreted as in meshopt_simplifyWithAttributes; attribute_count can be 0, in which case they can be NULL
+ * parallel_for can be NULL, in which case all work is done on the calling thread
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterHierarchy(struct meshopt_LODCluster* clusters, size_t max_clusters, struct meshopt_LODGroup* groups, unsigned int* cluster_indices, size_t max_indices, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t max_vertices, size_t max_triangles, size_t group_size, size_t* group_count, meshopt_ParallelFor parallel_for, void* context);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildClusterHierarchyBound(size_t max_indices, size_t max_vertices, size_t max_triangles);
+
 /**
  * Experimental: Meshlet optimizer
  * Reorders meshlet vertices and triangles to maximize locality to improve rasterizer throughput
@@ -537,6 +1165,29 @@ MESHOPTIMIZER_API size_t meshopt_buildMeshletsBound(size_t index_count, size_t m
  */
 MESHOPTIMIZER_EXPERIMENTAL void meshopt_optimizeMeshlet(unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, size_t triangle_count, size_t vertex_count);
 
+/**
+ * Experimental: Meshlet encoder
+ * Encodes vertex references and triangle data of a single meshlet into an array of bytes that is generally much smaller than the original (~1.5-2 bytes per vertex reference and ~1.8 bytes per triangle).
+ * Vertex references are delta-coded, and triangle indices are coded relative to the order of first use; for maximum efficiency the meshlet should be produced by meshopt_buildMeshlets and optimized with meshopt_optimizeMeshlet, and the vertex buffer should be optimized for vertex fetch.
+ * Returns encoded data size on success, 0 on error; the only error condition is if buffer doesn't have enough space
+ * The encoded data doesn't include vertex and triangle counts; they need to be stored separately (e.g. in meshopt_Meshlet).
+ *
+ * buffer must contain enough space for the encoded meshlet (use meshopt_encodeMeshletBound to compute worst case size)
+ * vertex_count must not exceed 256; triangles must refer to vertices in [0..vertex_count)
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshlet(unsigned char* buffer, size_t buffer_size, const unsigned int* vertices, size_t vertex_count, const unsigned char* triangles, size_t triangle_count);
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_encodeMeshletBound(size_t max_vertices, size_t max_triangles);
+
+/**
+ * Experimental: Meshlet decoder
+ * Decodes meshlet data from an array of bytes generated by meshopt_encodeMeshlet; vertex_count and triangle_count must match the values used for encoding.
+ * Returns 0 if decoding was successful, and an error code otherwise
+ * The decoder is safe to use for untrusted input, but it may produce garbage data (e.g. out of range indices).
+ *
+ * vertices must contain enough space for vertex_count references; triangles must contain enough space for triangle_count * 3 indices and isn't padded
+ */
+MESHOPTIMIZER_EXPERIMENTAL int meshopt_decodeMeshlet(unsigned int* vertices, size_t vertex_count, unsigned char* triangles, size_t triangle_count, const unsigned char* buffer, size_t buffer_size);
+
 struct meshopt_Bounds
 {
 	/* bounding sphere, useful for frustum and occlusion culling */
@@ -580,17 +1231,72 @@ MESHOPTIMIZER_API struct meshopt_Bounds meshopt_computeClusterBounds(const unsig
 MESHOPTIMIZER_API struct meshopt_Bounds meshopt_computeMeshletBounds(const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, size_t triangle_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 
 /**
- * Spatial sorter
- * Generates a remap table that can be used to reorder points for spatial locality.
- * Resulting remap table maps old vertices to new vertices and can be used in meshopt_remapVertexBuffer.
+ * Experimental: Batched meshlet bounds generator
+ * Computes bounds for all meshlets in one call and writes them in a compact structure-of-arrays layout that can be uploaded as a culling buffer; results match meshopt_computeMeshletBounds.
+ * Meshlet triangle data is indexed using vertex_offset/triangle_offset of each meshlet, as produced by meshopt_buildMeshlets.
  *
- * destination must contain enough space for the resulting remap table (vertex_count elements)
- * vertex_positions should have float3 position in the first 12 bytes of each vertex
+ * spheres must contain enough space for 4 floats per meshlet (center xyz, radius)
+ * cones must contain enough space for 4 bytes per meshlet (cone_axis_s8 xyz, cone_cutoff_s8)
+ * apexes must contain enough space for 3 floats per meshlet (cone_apex xyz)
+ * any of the outputs can be NULL; cone fitting is skipped when both cones and apexes are NULL
+ * parallel_for can be NULL, in which case all work is done on the calling thread; otherwise each task processes a contiguous range of meshlets
  */
-MESHOPTIMIZER_API void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_computeMeshletBoundsBatch(float* spheres, signed char* cones, float* apexes, const struct meshopt_Meshlet* meshlets, size_t meshlet_count, const unsigned int* meshlet_vertices, const unsigned char* meshlet_triangles, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_ParallelFor parallel_for, void* context);
 
 /**
- * Experimental: Spatial sorter
+ * Experimental: Meshlet bounding volume hierarchy node
+ * Interior nodes have child_count children stored in nodes [offset, offset+child_count); leaf nodes reference meshlet_count meshlets [offset, offset+meshlet_count) after reordering.
+ * Exactly one of child_count and meshlet_count is non-zero; each node stores both a bounding sphere and a bounding box that contain all meshlets in the subtree.
+ */
+struct meshopt_MeshletBVHNode
+{
+	float center[3];
+	float radius;
+
+	float aabb_min[3];
+	float aabb_max[3];
+
+	unsigned int offset;
+	unsigned short child_count;
+	unsigned short meshlet_count;
+};
+
+/**
+ * Experimental: Meshlet bounding volume hierarchy builder
+ * Builds a wide bounds hierarchy over meshlet bounding spheres for frustum and occlusion culling, and returns the number of nodes; node 0 is the root.
+ * Each node has at most 'branching' children, which are either nodes or meshlets; children of every node are stored contiguously, and nodes are stored in breadth-first order.
+ * Resulting remap table maps old meshlets to new meshlets; meshlets (and any per-meshlet data such as bounds) need to be reordered using meshopt_remapVertexBuffer for leaf node offsets to be valid.
+ * After reordering, meshlets of each subtree are stored contiguously, so culling traverses memory linearly.
+ *
+ * nodes must contain enough space for the resulting hierarchy (meshlet_count * 2 nodes)
+ * meshlet_remap must contain enough space for the resulting remap table (meshlet_count elements)
+ * meshlet_spheres should have 4 floats per meshlet (center xyz, radius), which matches the output of meshopt_computeMeshletBoundsBatch
+ * branching must be between 2 and 64; 4 or 8 are recommended
+ */
+MESHOPTIMIZER_EXPERIMENTAL size_t meshopt_buildMeshletBVH(struct meshopt_MeshletBVHNode* nodes, unsigned int* meshlet_remap, const float* meshlet_spheres, size_t meshlet_count, size_t branching);
+
+/**
+ * Spatial sorter
+ * Generates a remap table that can be used to reorder points for spatial locality.
+ * Resulting remap table maps old vertices to new vertices and can be used in meshopt_remapVertexBuffer.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex
+ */
+MESHOPTIMIZER_API void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+
+/**
+ * Experimental: Spatial sorter with high precision keys
+ * Equivalent to meshopt_spatialSortRemap, but uses 63-bit Morton codes (21 bits per axis) instead of 30-bit codes, which keeps points ordered for very large point sets where many points would share the same key otherwise.
+ * Key generation and radix sort are split into tasks that are executed using parallel_for; parallel_for can be NULL, in which case all work is done on the calling thread. The result doesn't depend on task scheduling.
+ *
+ * destination must contain enough space for the resulting remap table (vertex_count elements)
+ * vertex_positions should have float3 position in the first 12 bytes of each vertex
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_spatialSortRemapParallel(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_ParallelFor parallel_for, void* context);
+
+/**
+ * Experimental: Spatial sorter
  * Reorders triangles for spatial locality, and generates a new index buffer. The resulting index buffer can be used with other functions like optimizeVertexCache.
  *
  * destination must contain enough space for the resulting index buffer (index_count elements)
@@ -606,6 +1312,76 @@ MESHOPTIMIZER_EXPERIMENTAL void meshopt_spatialSortTriangles(unsigned int* desti
  */
 MESHOPTIMIZER_API void meshopt_setAllocator(void* (MESHOPTIMIZER_ALLOC_CALLCONV* allocate)(size_t), void (MESHOPTIMIZER_ALLOC_CALLCONV* deallocate)(void*));
 
+/**
+ * Experimental: Set allocation callbacks for the calling thread
+ * These callbacks take precedence over callbacks set via meshopt_setAllocator for all allocations made on the calling thread, which allows each thread to use its own allocator without contention.
+ * Passing NULL for both callbacks restores the use of callbacks set via meshopt_setAllocator.
+ * Note that when parallel_for is used, allocations made by tasks use the callbacks of the thread that runs the task.
+ * Objects that persist across calls (meshopt_TriangleAdjacency, meshopt_SimplifyContext, encoder/decoder contexts) must be released on a thread with the same callbacks active.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_setThreadAllocator(void* (MESHOPTIMIZER_ALLOC_CALLCONV* allocate)(size_t), void (MESHOPTIMIZER_ALLOC_CALLCONV* deallocate)(void*));
+
+/**
+ * Experimental: Instrumentation events
+ * Every algorithm reports a Begin event on entry and an End event on exit, which can be used to measure timings; algorithms that call other algorithms report nested pairs.
+ * In between, Counter events report algorithm-specific statistics (encoded bytes and bit width histograms per vertex byte, vertex classification and collapse counts, etc.), and Allocate events report the size of every temporary allocation.
+ * The same counter can be reported multiple times during one call (for example, once per simplification pass); values of repeated counters should be added together.
+ * Events are only reported when the library is compiled with MESHOPTIMIZER_INSTRUMENTATION=1; otherwise instrumentation compiles to nothing.
+ */
+enum meshopt_EventType
+{
+	meshopt_EventBegin,
+	meshopt_EventEnd,
+	meshopt_EventCounter,
+	meshopt_EventAllocate,
+};
+
+struct meshopt_Event
+{
+	enum meshopt_EventType type;
+
+	/* name of the innermost algorithm running on the reporting thread, e.g. "meshopt_simplify"; NULL for allocations made by parallel tasks outside of any algorithm */
+	const char* function;
+
+	/* counter name and index within the counter (vertex byte, histogram bucket, pass), or -1 when the counter has no index; NULL and -1 for other events */
+	const char* name;
+	int index;
+
+	/* counter value, or allocation size in bytes */
+	double value;
+};
+
+typedef void (*meshopt_EventCallback)(void* context, const struct meshopt_Event* event);
+
+/**
+ * Experimental: Set instrumentation callback
+ * The callback is shared by all threads and is called on the thread that reports the event, so it must be thread-safe when the library is used from multiple threads.
+ * Events of one call are reported in order on the calling thread, except for allocations made by parallel tasks which are reported on the thread that runs the task.
+ * Passing NULL disables event reporting.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_setEventCallback(meshopt_EventCallback callback, void* context);
+
+/**
+ * Experimental: Quantize an array of float vectors
+ * Equivalent to calling meshopt_quantizeUnorm/Snorm/Half/Float for every component, with bit-exact results; uses SIMD instructions where available.
+ * data contains count vectors of components floats, with stride bytes between consecutive vectors; destination receives count * components values tightly packed.
+ * N must fit into the destination type: 1..8 (unorm) or 2..8 (snorm) bits for 8-bit outputs, and 1..16 or 2..16 bits for 16-bit outputs.
+ * C++ code can also use meshopt_quantizeUnormArray/meshopt_quantizeSnormArray overloads that select the version based on destination type.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeUnormArray8(unsigned char* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeUnormArray16(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeSnormArray8(signed char* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeSnormArray16(short* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeHalfArray(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride);
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_quantizeFloatArray(float* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+
+/**
+ * Experimental: Reverse quantization of an array of half-precision vectors
+ * Equivalent to calling meshopt_dequantizeHalf for every component, with bit-exact results; uses SIMD instructions where available.
+ * data contains count vectors of components halfs, with stride bytes between consecutive vectors; destination receives count * components floats tightly packed.
+ */
+MESHOPTIMIZER_EXPERIMENTAL void meshopt_dequantizeHalfArray(float* destination, const unsigned short* data, size_t count, size_t components, size_t stride);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -662,6 +1438,12 @@ inline size_t meshopt_generateVertexRemap(unsigned int* destination, const T* in
 template <typename T>
 inline size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count);
 template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
+inline size_t meshopt_generateVertexRemapMultiParallel(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
+inline size_t meshopt_generateVertexRemapWithScratch(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, void* scratch, size_t scratch_size);
+template <typename T>
 inline void meshopt_remapIndexBuffer(T* destination, const T* indices, size_t index_count, const unsigned int* remap);
 template <typename T>
 inline void meshopt_generateShadowIndexBuffer(T* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, size_t vertex_stride);
@@ -674,18 +1456,32 @@ inline void meshopt_generateTessellationIndexBuffer(T* destination, const T* ind
 template <typename T>
 inline size_t meshopt_generateProvokingIndexBuffer(T* destination, unsigned int* reorder, const T* indices, size_t index_count, size_t vertex_count);
 template <typename T>
+inline void meshopt_buildTriangleAdjacency(meshopt_TriangleAdjacency* adjacency, const T* indices, size_t index_count, size_t vertex_count, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t index_count, size_t vertex_count);
 template <typename T>
+inline void meshopt_optimizeVertexCacheParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, const float* vertex_positions, size_t vertex_positions_stride, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithAdjacency(T* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_TriangleAdjacency* adjacency);
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithScratch(T* destination, const T* indices, size_t index_count, size_t vertex_count, void* scratch, size_t scratch_size);
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithScores(T* destination, const T* indices, size_t index_count, size_t vertex_count, const float* cache_scores, const float* live_scores);
+template <typename T>
 inline void meshopt_optimizeVertexCacheStrip(T* destination, const T* indices, size_t index_count, size_t vertex_count);
 template <typename T>
 inline void meshopt_optimizeVertexCacheFifo(T* destination, const T* indices, size_t index_count, size_t vertex_count, unsigned int cache_size);
 template <typename T>
 inline void meshopt_optimizeOverdraw(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold);
 template <typename T>
+inline void meshopt_optimizeOverdrawParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count);
 template <typename T>
 inline size_t meshopt_optimizeVertexFetch(void* destination, T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size);
 template <typename T>
+inline size_t meshopt_optimizeMesh(T* destination, void* const* vertex_destinations, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, unsigned int options, float overdraw_threshold, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count);
 template <typename T>
 inline int meshopt_decodeIndexBuffer(T* destination, size_t index_count, const unsigned char* buffer, size_t buffer_size);
@@ -698,6 +1494,18 @@ inline size_t meshopt_simplify(T* destination, const T* indices, size_t index_co
 template <typename T>
 inline size_t meshopt_simplifyWithAttributes(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options = 0, float* result_error = NULL);
 template <typename T>
+inline size_t meshopt_simplifyParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
+inline size_t meshopt_simplifyLods(T* destination, size_t* lod_index_counts, float* lod_errors, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options = 0);
+template <typename T>
+inline size_t meshopt_simplifyWithContext(meshopt_SimplifyContext* context, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options = 0, float* result_error = NULL);
+template <typename T>
+inline size_t meshopt_simplifyWithScratch(void* scratch, size_t scratch_size, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options = 0, float* result_error = NULL);
+template <typename T>
+inline size_t meshopt_simplifyWithStats(meshopt_SimplifyStats* stats, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options = 0, float* result_error = NULL);
+template <typename T>
+inline size_t meshopt_simplifyTiled(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, size_t tile_size, float* result_error, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error = NULL);
 template <typename T>
 inline size_t meshopt_stripify(T* destination, const T* indices, size_t index_count, size_t vertex_count, T restart_index);
@@ -708,15 +1516,31 @@ inline meshopt_VertexCacheStatistics meshopt_analyzeVertexCache(const T* indices
 template <typename T>
 inline meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 template <typename T>
+inline meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t resolution, size_t view_count, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const T* indices, size_t index_count, size_t vertex_count, size_t vertex_size);
 template <typename T>
+inline meshopt_MeshStatistics meshopt_analyzeMesh(const T* indices, size_t index_count, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride);
+template <typename T>
 inline size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight);
 template <typename T>
 inline size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, size_t vertex_count, size_t max_vertices, size_t max_triangles);
 template <typename T>
+inline size_t meshopt_buildMeshletsWithAdjacency(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, const meshopt_TriangleAdjacency* adjacency);
+template <typename T>
+inline size_t meshopt_buildMeshletsWithScratch(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, void* scratch, size_t scratch_size);
+template <typename T>
+inline size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, size_t region_size, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
+inline size_t meshopt_buildClusterHierarchy(meshopt_LODCluster* clusters, size_t max_clusters, meshopt_LODGroup* groups, unsigned int* cluster_indices, size_t max_indices, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t max_vertices, size_t max_triangles, size_t group_size, size_t* group_count, meshopt_ParallelFor parallel_for, void* context);
+template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
 template <typename T>
 inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride);
+inline void meshopt_quantizeUnormArray(unsigned char* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+inline void meshopt_quantizeUnormArray(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+inline void meshopt_quantizeSnormArray(signed char* destination, const float* data, size_t count, size_t components, size_t stride, int N);
+inline void meshopt_quantizeSnormArray(short* destination, const float* data, size_t count, size_t components, size_t stride, int N);
 #endif
 
 /* Inline implementation */
@@ -746,14 +1570,110 @@ inline int meshopt_quantizeSnorm(float v, int N)
 
 /* Internal implementation helpers */
 #ifdef __cplusplus
+class meshopt_Instrument
+{
+public:
+	template <typename T>
+	struct StorageT
+	{
+		static meshopt_EventCallback callback;
+		static void* context;
+
+		// innermost instrumented algorithm on the calling thread; counters and allocations are attributed to it
+		static MESHOPTIMIZER_THREAD_LOCAL const char* current;
+	};
+
+	typedef StorageT<void> Storage;
+
+	// class layout does not depend on MESHOPTIMIZER_INSTRUMENTATION so that translation units compiled with different settings agree on it
+	meshopt_Instrument(const char* function_)
+	    : function(function_)
+	    , parent(Storage::current)
+	{
+#if MESHOPTIMIZER_INSTRUMENTATION
+		Storage::current = function;
+		report(meshopt_EventBegin, function, NULL, -1, 0);
+#endif
+	}
+
+	~meshopt_Instrument()
+	{
+#if MESHOPTIMIZER_INSTRUMENTATION
+		report(meshopt_EventEnd, function, NULL, -1, 0);
+		Storage::current = parent;
+#endif
+	}
+
+	static bool enabled()
+	{
+#if MESHOPTIMIZER_INSTRUMENTATION
+		return Storage::callback != NULL;
+#else
+		return false;
+#endif
+	}
+
+	static void counter(const char* name, double value, int index = -1)
+	{
+#if MESHOPTIMIZER_INSTRUMENTATION
+		report(meshopt_EventCounter, Storage::current, name, index, value);
+#else
+		(void)name;
+		(void)value;
+		(void)index;
+#endif
+	}
+
+	static void allocation(size_t size)
+	{
+#if MESHOPTIMIZER_INSTRUMENTATION
+		report(meshopt_EventAllocate, Storage::current, NULL, -1, double(size));
+#else
+		(void)size;
+#endif
+	}
+
+private:
+	const char* function;
+	const char* parent;
+
+	static void report(meshopt_EventType type, const char* function, const char* name, int index, double value)
+	{
+		if (Storage::callback)
+		{
+			meshopt_Event event = {type, function, name, index, value};
+			Storage::callback(Storage::context, &event);
+		}
+	}
+};
+
 class meshopt_Allocator
 {
 public:
 	template <typename T>
 	struct StorageT
 	{
-		static void* (MESHOPTIMIZER_ALLOC_CALLCONV* allocate)(size_t);
-		static void (MESHOPTIMIZER_ALLOC_CALLCONV* deallocate)(void*);
+		static void* (MESHOPTIMIZER_ALLOC_CALLCONV* global_allocate)(size_t);
+		static void (MESHOPTIMIZER_ALLOC_CALLCONV* global_deallocate)(void*);
+
+		static MESHOPTIMIZER_THREAD_LOCAL void* (MESHOPTIMIZER_ALLOC_CALLCONV* thread_allocate)(size_t);
+		static MESHOPTIMIZER_THREAD_LOCAL void (MESHOPTIMIZER_ALLOC_CALLCONV* thread_deallocate)(void*);
+
+		// per-thread callbacks take precedence over global callbacks when set
+		static void* allocate(size_t size)
+		{
+			meshopt_Instrument::allocation(size);
+
+			return thread_allocate ? thread_allocate(size) : global_allocate(size);
+		}
+
+		static void deallocate(void* ptr)
+		{
+			if (thread_deallocate)
+				thread_deallocate(ptr);
+			else
+				global_deallocate(ptr);
+		}
 	};
 
 	typedef StorageT<void> Storage;
@@ -761,41 +1681,144 @@ public:
 	meshopt_Allocator()
 	    : blocks()
 	    , count(0)
+	    , arena(NULL)
+	    , arena_size(0)
+	    , arena_offset(0)
+	    , arena_blocks(0)
+	{
+	}
+
+	// allocations are served from arena while it has space left and from Storage otherwise; arena must be 16-byte aligned
+	meshopt_Allocator(void* arena_, size_t arena_size_)
+	    : blocks()
+	    , count(0)
+	    , arena(static_cast<unsigned char*>(arena_))
+	    , arena_size(arena_size_)
+	    , arena_offset(0)
+	    , arena_blocks(0)
 	{
 	}
 
 	~meshopt_Allocator()
 	{
 		for (size_t i = count; i > 0; --i)
-			Storage::deallocate(blocks[i - 1]);
+			if ((arena_blocks & (1u << (i - 1))) == 0)
+				Storage::deallocate(blocks[i - 1]);
 	}
 
 	template <typename T>
 	T* allocate(size_t size)
 	{
 		assert(count < sizeof(blocks) / sizeof(blocks[0]));
-		T* result = static_cast<T*>(Storage::allocate(size > size_t(-1) / sizeof(T) ? size_t(-1) : size * sizeof(T)));
+		size_t bytes = size > size_t(-1) / sizeof(T) ? size_t(-1) : size * sizeof(T);
+
+		size_t offset = (arena_offset + 15) & ~size_t(15);
+		void* result = NULL;
+
+		if (offset <= arena_size && bytes <= arena_size - offset)
+		{
+			result = arena + offset;
+			arena_offset = offset + bytes;
+			arena_blocks |= 1u << count;
+		}
+		else
+			result = Storage::allocate(bytes);
+
 		blocks[count++] = result;
-		return result;
+		return static_cast<T*>(result);
 	}
 
 	void deallocate(void* ptr)
 	{
 		assert(count > 0 && blocks[count - 1] == ptr);
-		Storage::deallocate(ptr);
 		count--;
+
+		if (arena_blocks & (1u << count))
+		{
+			arena_offset = static_cast<unsigned char*>(ptr) - arena;
+			arena_blocks &= ~(1u << count);
+		}
+		else
+			Storage::deallocate(ptr);
 	}
 
 private:
 	void* blocks[24];
 	size_t count;
+
+	unsigned char* arena;
+	size_t arena_size;
+	size_t arena_offset;
+	unsigned int arena_blocks;
 };
 
 // This makes sure that allocate/deallocate are lazily generated in translation units that need them and are deduplicated by the linker
 template <typename T>
-void* (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::allocate)(size_t) = operator new;
+void* (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::global_allocate)(size_t) = operator new;
+template <typename T>
+void (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::global_deallocate)(void*) = operator delete;
+template <typename T>
+MESHOPTIMIZER_THREAD_LOCAL void* (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::thread_allocate)(size_t) = NULL;
 template <typename T>
-void (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::deallocate)(void*) = operator delete;
+MESHOPTIMIZER_THREAD_LOCAL void (MESHOPTIMIZER_ALLOC_CALLCONV* meshopt_Allocator::StorageT<T>::thread_deallocate)(void*) = NULL;
+
+template <typename T>
+meshopt_EventCallback meshopt_Instrument::StorageT<T>::callback = NULL;
+template <typename T>
+void* meshopt_Instrument::StorageT<T>::context = NULL;
+template <typename T>
+MESHOPTIMIZER_THREAD_LOCAL const char* meshopt_Instrument::StorageT<T>::current = NULL;
+
+// Hash tables use open addressing with power of two sizes; this returns the table size that keeps the load factor under 80%
+inline size_t meshopt_hashBuckets(size_t count)
+{
+	size_t buckets = 1;
+	while (buckets < count + count / 4)
+		buckets *= 2;
+
+	return buckets;
+}
+
+// Remaps indices of a subset of the mesh to a compact [0..unique) range and fills the local => global vertex remap; index count is a good enough upper bound for remap size
+inline size_t meshopt_buildCompactRemap(unsigned int* remap, unsigned int* indices, size_t index_count, meshopt_Allocator& allocator)
+{
+	size_t offset = 0;
+
+	size_t table_size = meshopt_hashBuckets(index_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+
+	for (size_t i = 0; i < table_size; ++i)
+		table[i] = ~0u;
+
+	size_t hashmod = table_size - 1;
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		size_t bucket = (index * 0x5bd1e995) & hashmod;
+
+		// quadratic probing; the table is never full since it has more buckets than indices
+		for (size_t probe = 0; table[bucket] != ~0u && remap[table[bucket]] != index; ++probe)
+			bucket = (bucket + probe + 1) & hashmod;
+
+		if (table[bucket] == ~0u)
+		{
+			remap[offset] = index;
+			table[bucket] = unsigned(offset++);
+		}
+
+		indices[i] = table[bucket];
+	}
+
+	allocator.deallocate(table);
+
+	return offset;
+}
+
+// Meshlet limits shared by the clusterizer and the cluster hierarchy builder
+// Vertex limit must be <= 255 since index 0xff is used internally to indicate a vertex that doesn't belong to a meshlet; a reasonable triangle limit is around 2*max_vertices or less
+const size_t meshopt_kMeshletMaxVertices = 255;
+const size_t meshopt_kMeshletMaxTriangles = 512;
 #endif
 
 /* Inline implementation for C++ templated wrappers */
@@ -865,6 +1888,30 @@ inline size_t meshopt_generateVertexRemapMulti(unsigned int* destination, const
 	return meshopt_generateVertexRemapMulti(destination, indices ? in.data : NULL, index_count, vertex_count, streams, stream_count);
 }
 
+template <typename T>
+inline size_t meshopt_generateVertexRemapParallel(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapParallel(destination, indices ? in.data : NULL, index_count, vertices, vertex_count, vertex_size, parallel_for, context);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapMultiParallel(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapMultiParallel(destination, indices ? in.data : NULL, index_count, vertex_count, streams, stream_count, parallel_for, context);
+}
+
+template <typename T>
+inline size_t meshopt_generateVertexRemapWithScratch(unsigned int* destination, const T* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size, void* scratch, size_t scratch_size)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, indices ? index_count : 0);
+
+	return meshopt_generateVertexRemapWithScratch(destination, indices ? in.data : NULL, index_count, vertices, vertex_count, vertex_size, scratch, scratch_size);
+}
+
 template <typename T>
 inline void meshopt_remapIndexBuffer(T* destination, const T* indices, size_t index_count, const unsigned int* remap)
 {
@@ -923,6 +1970,14 @@ inline size_t meshopt_generateProvokingIndexBuffer(T* destination, unsigned int*
 	return meshopt_generateProvokingIndexBuffer(out.data, reorder, in.data, index_count, vertex_count);
 }
 
+template <typename T>
+inline void meshopt_buildTriangleAdjacency(meshopt_TriangleAdjacency* adjacency, const T* indices, size_t index_count, size_t vertex_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	meshopt_buildTriangleAdjacency(adjacency, in.data, index_count, vertex_count, parallel_for, context);
+}
+
 template <typename T>
 inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -932,6 +1987,42 @@ inline void meshopt_optimizeVertexCache(T* destination, const T* indices, size_t
 	meshopt_optimizeVertexCache(out.data, in.data, index_count, vertex_count);
 }
 
+template <typename T>
+inline void meshopt_optimizeVertexCacheParallel(T* destination, const T* indices, size_t index_count, size_t vertex_count, const float* vertex_positions, size_t vertex_positions_stride, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	meshopt_optimizeVertexCacheParallel(out.data, in.data, index_count, vertex_count, vertex_positions, vertex_positions_stride, chunk_size, parallel_for, context);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithAdjacency(T* destination, const T* indices, size_t index_count, size_t vertex_count, const meshopt_TriangleAdjacency* adjacency)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	meshopt_optimizeVertexCacheWithAdjacency(out.data, in.data, index_count, vertex_count, adjacency);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithScratch(T* destination, const T* indices, size_t index_count, size_t vertex_count, void* scratch, size_t scratch_size)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	meshopt_optimizeVertexCacheWithScratch(out.data, in.data, index_count, vertex_count, scratch, scratch_size);
+}
+
+template <typename T>
+inline void meshopt_optimizeVertexCacheWithScores(T* destination, const T* indices, size_t index_count, size_t vertex_count, const float* cache_scores, const float* live_scores)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	meshopt_optimizeVertexCacheWithScores(out.data, in.data, index_count, vertex_count, cache_scores, live_scores);
+}
+
 template <typename T>
 inline void meshopt_optimizeVertexCacheStrip(T* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -959,6 +2050,15 @@ inline void meshopt_optimizeOverdraw(T* destination, const T* indices, size_t in
 	meshopt_optimizeOverdraw(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold);
 }
 
+template <typename T>
+inline void meshopt_optimizeOverdrawParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	meshopt_optimizeOverdrawParallel(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold, parallel_for, context);
+}
+
 template <typename T>
 inline size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const T* indices, size_t index_count, size_t vertex_count)
 {
@@ -975,6 +2075,15 @@ inline size_t meshopt_optimizeVertexFetch(void* destination, T* indices, size_t
 	return meshopt_optimizeVertexFetch(destination, inout.data, index_count, vertices, vertex_count, vertex_size);
 }
 
+template <typename T>
+inline size_t meshopt_optimizeMesh(T* destination, void* const* vertex_destinations, const T* indices, size_t index_count, size_t vertex_count, const meshopt_Stream* streams, size_t stream_count, unsigned int options, float overdraw_threshold, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_optimizeMesh(out.data, vertex_destinations, in.data, index_count, vertex_count, streams, stream_count, options, overdraw_threshold, parallel_for, context);
+}
+
 template <typename T>
 inline size_t meshopt_encodeIndexBuffer(unsigned char* buffer, size_t buffer_size, const T* indices, size_t index_count)
 {
@@ -1027,6 +2136,60 @@ inline size_t meshopt_simplifyWithAttributes(T* destination, const T* indices, s
 	return meshopt_simplifyWithAttributes(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, result_error);
 }
 
+template <typename T>
+inline size_t meshopt_simplifyParallel(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_simplifyParallel(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, result_error, parallel_for, context);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyLods(T* destination, size_t* lod_index_counts, float* lod_errors, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count * lod_count);
+
+	return meshopt_simplifyLods(out.data, lod_index_counts, lod_errors, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_counts, target_errors, lod_count, options);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyWithContext(meshopt_SimplifyContext* context, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_simplifyWithContext(context, out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, result_error);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyWithScratch(void* scratch, size_t scratch_size, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_simplifyWithScratch(scratch, scratch_size, out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, result_error);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyWithStats(meshopt_SimplifyStats* stats, T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* result_error)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_simplifyWithStats(stats, out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, result_error);
+}
+
+template <typename T>
+inline size_t meshopt_simplifyTiled(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, size_t tile_size, float* result_error, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+	meshopt_IndexAdapter<T> out(destination, NULL, index_count);
+
+	return meshopt_simplifyTiled(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, tile_size, result_error, parallel_for, context);
+}
+
 template <typename T>
 inline size_t meshopt_simplifySloppy(T* destination, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* result_error)
 {
@@ -1070,6 +2233,14 @@ inline meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const T* indices, size
 	return meshopt_analyzeOverdraw(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 }
 
+template <typename T>
+inline meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t resolution, size_t view_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_analyzeOverdrawParallel(in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, resolution, view_count, parallel_for, context);
+}
+
 template <typename T>
 inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const T* indices, size_t index_count, size_t vertex_count, size_t vertex_size)
 {
@@ -1078,6 +2249,14 @@ inline meshopt_VertexFetchStatistics meshopt_analyzeVertexFetch(const T* indices
 	return meshopt_analyzeVertexFetch(in.data, index_count, vertex_count, vertex_size);
 }
 
+template <typename T>
+inline meshopt_MeshStatistics meshopt_analyzeMesh(const T* indices, size_t index_count, size_t vertex_count, size_t vertex_size, const float* vertex_positions, size_t vertex_positions_stride)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_analyzeMesh(in.data, index_count, vertex_count, vertex_size, vertex_positions, vertex_positions_stride);
+}
+
 template <typename T>
 inline size_t meshopt_buildMeshlets(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight)
 {
@@ -1094,6 +2273,38 @@ inline size_t meshopt_buildMeshletsScan(meshopt_Meshlet* meshlets, unsigned int*
 	return meshopt_buildMeshletsScan(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_count, max_vertices, max_triangles);
 }
 
+template <typename T>
+inline size_t meshopt_buildMeshletsWithAdjacency(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, const meshopt_TriangleAdjacency* adjacency)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_buildMeshletsWithAdjacency(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, adjacency);
+}
+
+template <typename T>
+inline size_t meshopt_buildMeshletsWithScratch(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, void* scratch, size_t scratch_size)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_buildMeshletsWithScratch(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, scratch, scratch_size);
+}
+
+template <typename T>
+inline size_t meshopt_buildMeshletsParallel(meshopt_Meshlet* meshlets, unsigned int* meshlet_vertices, unsigned char* meshlet_triangles, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t max_vertices, size_t max_triangles, float cone_weight, size_t region_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_buildMeshletsParallel(meshlets, meshlet_vertices, meshlet_triangles, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, max_vertices, max_triangles, cone_weight, region_size, parallel_for, context);
+}
+
+template <typename T>
+inline size_t meshopt_buildClusterHierarchy(meshopt_LODCluster* clusters, size_t max_clusters, meshopt_LODGroup* groups, unsigned int* cluster_indices, size_t max_indices, const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t max_vertices, size_t max_triangles, size_t group_size, size_t* group_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_IndexAdapter<T> in(NULL, indices, index_count);
+
+	return meshopt_buildClusterHierarchy(clusters, max_clusters, groups, cluster_indices, max_indices, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride, vertex_attributes, vertex_attributes_stride, attribute_weights, attribute_count, max_vertices, max_triangles, group_size, group_count, parallel_for, context);
+}
+
 template <typename T>
 inline meshopt_Bounds meshopt_computeClusterBounds(const T* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
@@ -1110,6 +2321,26 @@ inline void meshopt_spatialSortTriangles(T* destination, const T* indices, size_
 
 	meshopt_spatialSortTriangles(out.data, in.data, index_count, vertex_positions, vertex_count, vertex_positions_stride);
 }
+
+inline void meshopt_quantizeUnormArray(unsigned char* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	meshopt_quantizeUnormArray8(destination, data, count, components, stride, N);
+}
+
+inline void meshopt_quantizeUnormArray(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	meshopt_quantizeUnormArray16(destination, data, count, components, stride, N);
+}
+
+inline void meshopt_quantizeSnormArray(signed char* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	meshopt_quantizeSnormArray8(destination, data, count, components, stride, N);
+}
+
+inline void meshopt_quantizeSnormArray(short* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	meshopt_quantizeSnormArray16(destination, data, count, components, stride, N);
+}
 #endif
 
 /**
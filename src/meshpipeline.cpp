@@ -0,0 +1,167 @@
+// This file is part of meshoptimizer library; see meshoptimizer.h for version/license details
+#include "meshoptimizer.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace meshopt
+{
+
+const size_t kFetchChunkSize = 16384;
+
+struct FetchTask
+{
+	const unsigned int* remap;
+	const unsigned int* sources;
+	size_t vertex_count;
+
+	meshopt_Stream stream;
+	void* destination;
+};
+
+static void fetchTask(void* context, size_t chunk)
+{
+	const FetchTask& t = *static_cast<FetchTask*>(context);
+
+	size_t begin = chunk * kFetchChunkSize;
+	size_t end = begin + kFetchChunkSize < t.vertex_count ? begin + kFetchChunkSize : t.vertex_count;
+
+	const unsigned char* data = static_cast<const unsigned char*>(t.stream.data);
+	unsigned char* destination = static_cast<unsigned char*>(t.destination);
+
+	// every output vertex has exactly one source vertex, so chunks write disjoint output ranges
+	for (size_t i = begin; i < end; ++i)
+		if (t.remap[i] != ~0u)
+		{
+			size_t source = t.sources ? t.sources[i] : i;
+
+			memcpy(destination + t.remap[i] * t.stream.size, data + source * t.stream.stride, t.stream.size);
+		}
+}
+
+} // namespace meshopt
+
+size_t meshopt_optimizeMesh(unsigned int* destination, void* const* vertex_destinations, const unsigned int* indices, size_t index_count, size_t vertex_count, const struct meshopt_Stream* streams, size_t stream_count, unsigned int options, float overdraw_threshold, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_optimizeMesh");
+
+	assert(index_count % 3 == 0);
+	assert((options & meshopt_OptimizeMeshSkipRemap) != 0 || stream_count <= 16);
+	assert((options & meshopt_OptimizeMeshOverdraw) == 0 || (stream_count > 0 && streams[0].size >= 12 && streams[0].stride % sizeof(float) == 0));
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		assert(streams[k].size > 0 && streams[k].size <= 256);
+		assert(streams[k].size <= streams[k].stride);
+	}
+
+	meshopt_Allocator allocator;
+
+	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
+
+	// after merging, all stages work on the compact set of unique vertices; sources maps each unique vertex back to a source vertex
+	unsigned int* sources = NULL;
+	size_t unique_vertices = vertex_count;
+
+	if ((options & meshopt_OptimizeMeshSkipRemap) == 0 && stream_count > 0)
+	{
+		unique_vertices = meshopt_generateVertexRemapMultiParallel(remap, indices, index_count, vertex_count, streams, stream_count, parallel_for, context);
+
+		sources = allocator.allocate<unsigned int>(unique_vertices);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			if (remap[i] != ~0u)
+				sources[remap[i]] = unsigned(i);
+
+		meshopt_remapIndexBuffer(destination, indices, index_count, remap);
+	}
+	else if (destination != indices)
+	{
+		memcpy(destination, indices, index_count * sizeof(unsigned int));
+	}
+
+	if (options & meshopt_OptimizeMeshStrip)
+	{
+		meshopt_optimizeVertexCacheStrip(destination, destination, index_count, unique_vertices);
+	}
+	else
+	{
+		// adjacency is the largest intermediate structure of vertex cache optimization; building it separately allows building it in parallel
+		meshopt_TriangleAdjacency adjacency;
+		meshopt_buildTriangleAdjacency(&adjacency, destination, index_count, unique_vertices, parallel_for, context);
+		meshopt_optimizeVertexCacheWithAdjacency(destination, destination, index_count, unique_vertices, &adjacency);
+		meshopt_destroyTriangleAdjacency(&adjacency);
+	}
+
+	if (options & meshopt_OptimizeMeshOverdraw)
+	{
+		const float* positions = static_cast<const float*>(streams[0].data);
+		size_t positions_stride = streams[0].stride;
+
+		// overdraw optimizer only needs positions of unique vertices, which are much smaller than the full vertex data
+		if (sources)
+		{
+			float* compact = allocator.allocate<float>(unique_vertices * 3);
+
+			for (size_t i = 0; i < unique_vertices; ++i)
+				memcpy(&compact[i * 3], reinterpret_cast<const unsigned char*>(positions) + sources[i] * positions_stride, sizeof(float) * 3);
+
+			positions = compact;
+			positions_stride = sizeof(float) * 3;
+		}
+
+		meshopt_optimizeOverdrawParallel(destination, destination, index_count, positions, unique_vertices, positions_stride, overdraw_threshold, parallel_for, context);
+
+		if (sources)
+			allocator.deallocate(const_cast<float*>(positions));
+	}
+
+	size_t result = meshopt_optimizeVertexFetchRemap(remap, destination, index_count, unique_vertices);
+
+	meshopt_remapIndexBuffer(destination, destination, index_count, remap);
+
+	// in-place streams are compacted into a copy one at a time to keep peak memory bounded by the largest stream
+	size_t copy_size = 0;
+
+	for (size_t k = 0; k < stream_count; ++k)
+		if (vertex_destinations[k] == streams[k].data && copy_size < unique_vertices * streams[k].size)
+			copy_size = unique_vertices * streams[k].size;
+
+	unsigned char* copy = allocator.allocate<unsigned char>(copy_size);
+
+	size_t chunk_count = (unique_vertices + kFetchChunkSize - 1) / kFetchChunkSize;
+
+	for (size_t k = 0; k < stream_count; ++k)
+	{
+		meshopt_Stream source = streams[k];
+		const unsigned int* source_remap = sources;
+
+		if (vertex_destinations[k] == streams[k].data)
+		{
+			for (size_t i = 0; i < unique_vertices; ++i)
+				memcpy(copy + i * source.size, static_cast<const unsigned char*>(source.data) + (sources ? sources[i] : i) * source.stride, source.size);
+
+			source.data = copy;
+			source.stride = source.size;
+			source_remap = NULL;
+		}
+
+		// vertex data is moved directly from source to the final location, merging and reordering vertices in one pass
+		FetchTask task = {};
+		task.remap = remap;
+		task.sources = source_remap;
+		task.vertex_count = unique_vertices;
+		task.stream = source;
+		task.destination = vertex_destinations[k];
+
+		if (parallel_for && chunk_count > 1)
+			parallel_for(context, fetchTask, &task, chunk_count);
+		else
+			for (size_t i = 0; i < chunk_count; ++i)
+				fetchTask(&task, i);
+	}
+
+	return result;
+}
@@ -3,19 +3,49 @@
 
 #include <assert.h>
 #include <float.h>
+#include <math.h>
 #include <string.h>
 
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // Nicolas Capens. Advanced Rasterization. 2004
+// Alvaro Gonzalez. Measurement of Areas on a Sphere Using Fibonacci and Latitude-Longitude Lattices. 2009
 namespace meshopt
 {
 
 const int kViewport = 256;
+const int kViewportMax = 1024; // 28.4 fixed point edge equations overflow with larger viewports
+
+// each task rasterizes one band of rows for all triangles that overlap it
+const int kBandHeight = 16;
+const size_t kTransformChunkSize = 16384;
 
 struct OverdrawBuffer
 {
-	float z[kViewport][kViewport][2];
-	unsigned int overdraw[kViewport][kViewport][2];
+	// z and overdraw planes for front and back faces; rows are padded to a multiple of 4 pixels
+	float* z[2];
+	unsigned int* overdraw[2];
+
+	int viewport;
+	int stride;
 };
 
 #ifndef min
@@ -42,8 +72,18 @@ static float computeDepthGradients(float& dzdx, float& dzdy, float x1, float y1,
 	return det;
 }
 
-// half-space fixed point triangle rasterizer
-static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, float v2x, float v2y, float v2z, float v3x, float v3y, float v3z)
+#ifdef SIMD_SSE
+// edge equation values for 4 consecutive pixels
+static __m128i edgeLanes(int c, int step)
+{
+	unsigned int uc = unsigned(c), us = unsigned(step);
+
+	return _mm_setr_epi32(int(uc), int(uc + us), int(uc + us * 2), int(uc + us * 3));
+}
+#endif
+
+// half-space fixed point triangle rasterizer; only rows in [bandy0, bandy1) are rasterized
+static void rasterize(OverdrawBuffer* buffer, int bandy0, int bandy1, float v1x, float v1y, float v1z, float v2x, float v2y, float v2z, float v3x, float v3y, float v3z)
 {
 	// compute depth gradients
 	float DZx, DZy;
@@ -59,7 +99,7 @@ static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, f
 		t = v2y, v2y = v3y, v3y = t;
 
 		// flip depth since we rasterize backfacing triangles to second buffer with reverse Z; only v1z is used below
-		v1z = kViewport - v1z;
+		v1z = float(buffer->viewport) - v1z;
 		DZx = -DZx;
 		DZy = -DZy;
 	}
@@ -73,14 +113,18 @@ static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, f
 	int Y2 = int(16.0f * v2y + 0.5f);
 	int Y3 = int(16.0f * v3y + 0.5f);
 
-	// bounding rectangle, clipped against viewport
+	// bounding rectangle, clipped against viewport and band
 	// since we rasterize pixels with covered centers, min >0.5 should round up
 	// as for max, due to top-left filling convention we will never rasterize right/bottom edges
 	// so max >= 0.5 should round down
 	int minx = max((min(X1, min(X2, X3)) + 7) >> 4, 0);
-	int maxx = min((max(X1, max(X2, X3)) + 7) >> 4, kViewport);
-	int miny = max((min(Y1, min(Y2, Y3)) + 7) >> 4, 0);
-	int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, kViewport);
+	int maxx = min((max(X1, max(X2, X3)) + 7) >> 4, buffer->viewport);
+	int trimy = max((min(Y1, min(Y2, Y3)) + 7) >> 4, 0);
+	int miny = max(trimy, bandy0);
+	int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, bandy1);
+
+	if (minx >= maxx || miny >= maxy)
+		return;
 
 	// deltas, 28.4 fixed point
 	int DX12 = X1 - X2;
@@ -97,57 +141,261 @@ static void rasterize(OverdrawBuffer* buffer, float v1x, float v1y, float v1z, f
 	int TL3 = DY31 < 0 || (DY31 == 0 && DX31 > 0);
 
 	// half edge equations, 24.8 fixed point
-	// note that we offset minx/miny by half pixel since we want to rasterize pixels with covered centers
+	// note that we offset minx/trimy by half pixel since we want to rasterize pixels with covered centers
+	// equations are set up at the top of the triangle rather than the top of the band, so that the results don't depend on band boundaries
 	int FX = (minx << 4) + 8;
-	int FY = (miny << 4) + 8;
+	int FY = (trimy << 4) + 8;
 	int CY1 = DX12 * (FY - Y1) - DY12 * (FX - X1) + TL1 - 1;
 	int CY2 = DX23 * (FY - Y2) - DY23 * (FX - X2) + TL2 - 1;
 	int CY3 = DX31 * (FY - Y3) - DY31 * (FX - X3) + TL3 - 1;
-	float ZY = v1z + (DZx * float(FX - X1) + DZy * float(FY - Y1)) * (1 / 16.f);
+
+	// depth is evaluated from the plane equation for every pixel so that the result doesn't depend on SIMD width
+	float Z0 = v1z + (DZx * float(FX - X1) + DZy * float(FY - Y1)) * (1 / 16.f);
+
+	// signed left shift is UB for negative numbers so use unsigned-signed casts
+	int SX1 = -int(unsigned(DY12) << 4), SX2 = -int(unsigned(DY23) << 4), SX3 = -int(unsigned(DY31) << 4);
+	int SY1 = int(unsigned(DX12) << 4), SY2 = int(unsigned(DX23) << 4), SY3 = int(unsigned(DX31) << 4);
+
+	// step edge equations to the first row of the band; this is exact since the equations are integer
+	CY1 = int(unsigned(CY1) + unsigned(SY1) * unsigned(miny - trimy));
+	CY2 = int(unsigned(CY2) + unsigned(SY2) * unsigned(miny - trimy));
+	CY3 = int(unsigned(CY3) + unsigned(SY3) * unsigned(miny - trimy));
 
 	for (int y = miny; y < maxy; y++)
 	{
+		float* zrow = buffer->z[sign] + size_t(y) * buffer->stride;
+		unsigned int* orow = buffer->overdraw[sign] + size_t(y) * buffer->stride;
+
+		float ZY = Z0 + DZy * float(y - trimy);
+
+#if defined(SIMD_SSE)
+		__m128i cx1 = edgeLanes(CY1, SX1);
+		__m128i cx2 = edgeLanes(CY2, SX2);
+		__m128i cx3 = edgeLanes(CY3, SX3);
+		__m128i step1 = _mm_set1_epi32(int(unsigned(SX1) << 2)), step2 = _mm_set1_epi32(int(unsigned(SX2) << 2)), step3 = _mm_set1_epi32(int(unsigned(SX3) << 2));
+
+		__m128i xoff = _mm_setr_epi32(0, 1, 2, 3);
+		__m128i xend = _mm_set1_epi32(maxx - minx);
+		__m128 zy = _mm_set1_ps(ZY), dzx = _mm_set1_ps(DZx);
+
+		for (int x = minx; x < maxx; x += 4)
+		{
+			// pixel is covered when all edge equations are non-negative; lanes past the end of the span are masked out
+			__m128i inside = _mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(cx1, cx2), cx3), _mm_set1_epi32(-1));
+			inside = _mm_and_si128(inside, _mm_cmplt_epi32(xoff, xend));
+
+			__m128 zx = _mm_add_ps(zy, _mm_mul_ps(dzx, _mm_cvtepi32_ps(xoff)));
+			__m128 zb = _mm_loadu_ps(zrow + x);
+
+			__m128i pass = _mm_and_si128(inside, _mm_castps_si128(_mm_cmpge_ps(zx, zb)));
+
+			_mm_storeu_ps(zrow + x, _mm_or_ps(_mm_and_ps(_mm_castsi128_ps(pass), zx), _mm_andnot_ps(_mm_castsi128_ps(pass), zb)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(orow + x), _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<__m128i*>(orow + x)), pass));
+
+			cx1 = _mm_add_epi32(cx1, step1);
+			cx2 = _mm_add_epi32(cx2, step2);
+			cx3 = _mm_add_epi32(cx3, step3);
+			xoff = _mm_add_epi32(xoff, _mm_set1_epi32(4));
+		}
+#else
 		int CX1 = CY1;
 		int CX2 = CY2;
 		int CX3 = CY3;
-		float ZX = ZY;
 
 		for (int x = minx; x < maxx; x++)
 		{
 			// check if all CXn are non-negative
 			if ((CX1 | CX2 | CX3) >= 0)
 			{
-				if (ZX >= buffer->z[y][x][sign])
+				float ZX = ZY + DZx * float(x - minx);
+
+				if (ZX >= zrow[x])
 				{
-					buffer->z[y][x][sign] = ZX;
-					buffer->overdraw[y][x][sign]++;
+					zrow[x] = ZX;
+					orow[x]++;
 				}
 			}
 
-			// signed left shift is UB for negative numbers so use unsigned-signed casts
-			CX1 -= int(unsigned(DY12) << 4);
-			CX2 -= int(unsigned(DY23) << 4);
-			CX3 -= int(unsigned(DY31) << 4);
-			ZX += DZx;
+			CX1 += SX1;
+			CX2 += SX2;
+			CX3 += SX3;
 		}
+#endif
 
-		// signed left shift is UB for negative numbers so use unsigned-signed casts
-		CY1 += int(unsigned(DX12) << 4);
-		CY2 += int(unsigned(DX23) << 4);
-		CY3 += int(unsigned(DX31) << 4);
-		ZY += DZy;
+		CY1 += SY1;
+		CY2 += SY2;
+		CY3 += SY3;
 	}
 }
 
-} // namespace meshopt
+struct OverdrawTask
+{
+	const unsigned int* indices;
+	size_t index_count;
+
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_stride_float;
+
+	// view transform: screen[k] = dot(position - origin, axes[k]) * scale + offset
+	float origin[3];
+	float axes[3][3];
+	float scale;
+	float offset;
+
+	// triangle coordinates are stored once for all axis-aligned views, so each view reads them through a swizzle
+	float* triangles;
+	int swizzle[3];
+
+	OverdrawBuffer buffer;
+	int band_height;
+	const unsigned int* band_offsets;
+	unsigned int* band_triangles;
+
+	size_t* band_covered;
+	size_t* band_shaded;
+};
 
-meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+static void transformOverdrawTask(void* context, size_t chunk)
 {
-	using namespace meshopt;
+	OverdrawTask& t = *static_cast<OverdrawTask*>(context);
+
+	size_t begin = chunk * kTransformChunkSize;
+	size_t end = begin + kTransformChunkSize < t.index_count ? begin + kTransformChunkSize : t.index_count;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int index = t.indices[i];
+		assert(index < t.vertex_count);
+
+		const float* v = t.vertex_positions + index * t.vertex_stride_float;
+
+		float d[3] = {v[0] - t.origin[0], v[1] - t.origin[1], v[2] - t.origin[2]};
+
+		for (int k = 0; k < 3; ++k)
+			t.triangles[i * 3 + k] = (d[0] * t.axes[k][0] + d[1] * t.axes[k][1] + d[2] * t.axes[k][2]) * t.scale + t.offset;
+	}
+}
+
+static void rasterizeOverdrawTask(void* context, size_t band)
+{
+	OverdrawTask& t = *static_cast<OverdrawTask*>(context);
+
+	OverdrawBuffer* buffer = &t.buffer;
+
+	int bandy0 = int(band) * t.band_height;
+	int bandy1 = min(bandy0 + t.band_height, buffer->viewport);
+
+	size_t band_offset = size_t(bandy0) * buffer->stride;
+	size_t band_size = size_t(bandy1 - bandy0) * buffer->stride;
+
+	for (int s = 0; s < 2; ++s)
+	{
+		memset(buffer->z[s] + band_offset, 0, band_size * sizeof(float));
+		memset(buffer->overdraw[s] + band_offset, 0, band_size * sizeof(unsigned int));
+	}
+
+	size_t band_begin = t.band_triangles ? t.band_offsets[band] : 0;
+	size_t band_end = t.band_triangles ? t.band_offsets[band + 1] : t.index_count / 3;
+
+	// when the viewport is rasterized as a single band, binning is skipped and all triangles are processed in order
+	for (size_t i = band_begin; i < band_end; ++i)
+	{
+		const float* vn = &t.triangles[(t.band_triangles ? t.band_triangles[i] : i) * 9];
+		const int* sw = t.swizzle;
+
+		rasterize(buffer, bandy0, bandy1, vn[sw[0]], vn[sw[1]], vn[sw[2]], vn[3 + sw[0]], vn[3 + sw[1]], vn[3 + sw[2]], vn[6 + sw[0]], vn[6 + sw[1]], vn[6 + sw[2]]);
+	}
+
+	size_t covered = 0, shaded = 0;
+
+	for (int s = 0; s < 2; ++s)
+		for (size_t i = 0; i < band_size; ++i)
+		{
+			unsigned int overdraw = buffer->overdraw[s][band_offset + i];
+
+			covered += overdraw > 0;
+			shaded += overdraw;
+		}
+
+	t.band_covered[band] += covered;
+	t.band_shaded[band] += shaded;
+}
+
+static void getOverdrawView(OverdrawTask& t, size_t view, size_t view_count, const float* minv, const float* maxv, int viewport)
+{
+	memset(t.axes, 0, sizeof(t.axes));
+
+	if (view < 3)
+	{
+		// axis-aligned views map the bounding box corner to the viewport origin, and rasterize it from three sides
+		static const int kAxes[3][3] = {{2, 1, 0}, {0, 2, 1}, {1, 0, 2}};
+
+		float extent = max(maxv[0] - minv[0], max(maxv[1] - minv[1], maxv[2] - minv[2]));
+
+		for (int k = 0; k < 3; ++k)
+		{
+			t.axes[k][k] = 1.f;
+			t.swizzle[k] = kAxes[view][k];
+		}
+
+		memcpy(t.origin, minv, 3 * sizeof(float));
+		t.scale = extent == 0 ? 0.f : float(viewport) / extent;
+		t.offset = 0.f;
+	}
+	else
+	{
+		// remaining views are distributed over the hemisphere using a Fibonacci lattice; opposite directions are covered by back faces
+		float z = (float(view - 3) + 0.5f) / float(view_count - 3);
+		float r = sqrtf(1 - z * z);
+		float phi = float(view - 3) * 2.39996323f;
+
+		float dir[3] = {r * cosf(phi), r * sinf(phi), z};
+		float up[3] = {fabsf(z) < 0.9f ? 0.f : 1.f, 0.f, fabsf(z) < 0.9f ? 1.f : 0.f};
+
+		// u = normalize(cross(dir, up)), v = cross(dir, u)
+		float u[3] = {dir[1] * up[2] - dir[2] * up[1], dir[2] * up[0] - dir[0] * up[2], dir[0] * up[1] - dir[1] * up[0]};
+		float ul = sqrtf(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+
+		u[0] /= ul, u[1] /= ul, u[2] /= ul;
+
+		float v[3] = {dir[1] * u[2] - dir[2] * u[1], dir[2] * u[0] - dir[0] * u[2], dir[0] * u[1] - dir[1] * u[0]};
+
+		memcpy(t.axes[0], u, sizeof(u));
+		memcpy(t.axes[1], v, sizeof(v));
+		memcpy(t.axes[2], dir, sizeof(dir));
+
+		for (int k = 0; k < 3; ++k)
+			t.swizzle[k] = k;
+
+		// the bounding sphere of the bounding box fits into the viewport from every direction
+		float dx = maxv[0] - minv[0], dy = maxv[1] - minv[1], dz = maxv[2] - minv[2];
+		float radius = sqrtf(dx * dx + dy * dy + dz * dz) * 0.5f;
 
+		t.origin[0] = (minv[0] + maxv[0]) * 0.5f;
+		t.origin[1] = (minv[1] + maxv[1]) * 0.5f;
+		t.origin[2] = (minv[2] + maxv[2]) * 0.5f;
+		t.scale = radius == 0 ? 0.f : float(viewport) / (2 * radius);
+		t.offset = float(viewport) * 0.5f;
+	}
+}
+
+static void runOverdrawTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), OverdrawTask* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
+static meshopt_OverdrawStatistics analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t resolution, size_t view_count, meshopt_ParallelFor parallel_for, void* context)
+{
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(resolution >= 1 && resolution <= size_t(kViewportMax));
+	assert(view_count >= 1);
 
 	meshopt_Allocator allocator;
 
@@ -169,61 +417,139 @@ meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices,
 		}
 	}
 
-	float extent = max(maxv[0] - minv[0], max(maxv[1] - minv[1], maxv[2] - minv[2]));
-	float scale = kViewport / extent;
+	int viewport = int(resolution);
+	// SIMD spans start at arbitrary x and may touch up to 3 pixels past the end of the span; padding keeps them within the row
+	int stride = ((viewport + 3) & ~3) + 4;
+	// without parallel_for, bands don't improve performance
+	int band_height = parallel_for ? kBandHeight : viewport;
+	size_t band_count = (viewport + band_height - 1) / band_height;
+	size_t face_count = index_count / 3;
 
-	float* triangles = allocator.allocate<float>(index_count * 3);
+	OverdrawTask task = {};
+	task.indices = indices;
+	task.index_count = index_count;
+	task.vertex_positions = vertex_positions;
+	task.vertex_count = vertex_count;
+	task.vertex_stride_float = vertex_stride_float;
 
-	for (size_t i = 0; i < index_count; ++i)
-	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
+	task.triangles = allocator.allocate<float>(index_count * 3);
 
-		const float* v = vertex_positions + index * vertex_stride_float;
+	task.buffer.viewport = viewport;
+	task.buffer.stride = stride;
+	task.band_height = band_height;
 
-		triangles[i * 3 + 0] = (v[0] - minv[0]) * scale;
-		triangles[i * 3 + 1] = (v[1] - minv[1]) * scale;
-		triangles[i * 3 + 2] = (v[2] - minv[2]) * scale;
+	for (int s = 0; s < 2; ++s)
+	{
+		task.buffer.z[s] = allocator.allocate<float>(size_t(stride) * viewport);
+		task.buffer.overdraw[s] = allocator.allocate<unsigned int>(size_t(stride) * viewport);
 	}
 
-	OverdrawBuffer* buffer = allocator.allocate<OverdrawBuffer>(1);
+	unsigned int* band_offsets = allocator.allocate<unsigned int>(band_count + 1);
+	task.band_offsets = band_offsets;
+
+	task.band_covered = allocator.allocate<size_t>(band_count);
+	task.band_shaded = allocator.allocate<size_t>(band_count);
 
-	for (int axis = 0; axis < 3; ++axis)
+	memset(task.band_covered, 0, band_count * sizeof(size_t));
+	memset(task.band_shaded, 0, band_count * sizeof(size_t));
+
+	for (size_t view = 0; view < view_count; ++view)
 	{
-		memset(buffer, 0, sizeof(OverdrawBuffer));
+		getOverdrawView(task, view, view_count, minv, maxv, viewport);
+
+		// axis-aligned views share the transformed coordinates
+		if (view == 0 || view >= 3)
+			runOverdrawTasks(parallel_for, context, transformOverdrawTask, &task, (index_count + kTransformChunkSize - 1) / kTransformChunkSize);
 
-		for (size_t i = 0; i < index_count; i += 3)
+		if (band_count > 1)
 		{
-			const float* vn0 = &triangles[3 * (i + 0)];
-			const float* vn1 = &triangles[3 * (i + 1)];
-			const float* vn2 = &triangles[3 * (i + 2)];
+			// bin triangles into bands based on the rows they cover; this uses the same rounding as the rasterizer
+			memset(band_offsets, 0, (band_count + 1) * sizeof(unsigned int));
 
-			switch (axis)
+			for (int pass = 0; pass < 2; ++pass)
 			{
-			case 0:
-				rasterize(buffer, vn0[2], vn0[1], vn0[0], vn1[2], vn1[1], vn1[0], vn2[2], vn2[1], vn2[0]);
-				break;
-			case 1:
-				rasterize(buffer, vn0[0], vn0[2], vn0[1], vn1[0], vn1[2], vn1[1], vn2[0], vn2[2], vn2[1]);
-				break;
-			case 2:
-				rasterize(buffer, vn0[1], vn0[0], vn0[2], vn1[1], vn1[0], vn1[2], vn2[1], vn2[0], vn2[2]);
-				break;
-			}
-		}
+				for (size_t i = 0; i < face_count; ++i)
+				{
+					const float* vn = &task.triangles[i * 9];
+
+					int Y1 = int(16.0f * vn[task.swizzle[1]] + 0.5f);
+					int Y2 = int(16.0f * vn[3 + task.swizzle[1]] + 0.5f);
+					int Y3 = int(16.0f * vn[6 + task.swizzle[1]] + 0.5f);
 
-		for (int y = 0; y < kViewport; ++y)
-			for (int x = 0; x < kViewport; ++x)
-				for (int s = 0; s < 2; ++s)
+					int miny = max((min(Y1, min(Y2, Y3)) + 7) >> 4, 0);
+					int maxy = min((max(Y1, max(Y2, Y3)) + 7) >> 4, viewport);
+
+					if (miny >= maxy)
+						continue;
+
+					for (int band = miny / band_height; band <= (maxy - 1) / band_height; ++band)
+					{
+						if (pass == 0)
+							band_offsets[band + 1]++;
+						else
+							task.band_triangles[band_offsets[band]++] = unsigned(i);
+					}
+				}
+
+				if (pass == 0)
 				{
-					unsigned int overdraw = buffer->overdraw[y][x][s];
+					for (size_t band = 0; band < band_count; ++band)
+						band_offsets[band + 1] += band_offsets[band];
 
-					result.pixels_covered += overdraw > 0;
-					result.pixels_shaded += overdraw;
+					task.band_triangles = allocator.allocate<unsigned int>(band_offsets[band_count]);
 				}
+				else
+				{
+					// fill pass advanced each offset to the end of its band, which is the start of the next band
+					for (size_t band = band_count; band > 0; --band)
+						band_offsets[band] = band_offsets[band - 1];
+
+					band_offsets[0] = 0;
+				}
+			}
+		}
+
+		runOverdrawTasks(parallel_for, context, rasterizeOverdrawTask, &task, band_count);
+
+		if (task.band_triangles)
+			allocator.deallocate(task.band_triangles);
+
+		task.band_triangles = NULL;
+	}
+
+	size_t pixels_covered = 0, pixels_shaded = 0;
+
+	for (size_t band = 0; band < band_count; ++band)
+	{
+		pixels_covered += task.band_covered[band];
+		pixels_shaded += task.band_shaded[band];
 	}
 
+	result.pixels_covered = unsigned(pixels_covered);
+	result.pixels_shaded = unsigned(pixels_shaded);
 	result.overdraw = result.pixels_covered ? float(result.pixels_shaded) / float(result.pixels_covered) : 0.f;
 
 	return result;
 }
+
+} // namespace meshopt
+
+meshopt_OverdrawStatistics meshopt_analyzeOverdraw(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_analyzeOverdraw");
+
+	return analyzeOverdraw(indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, kViewport, 3, NULL, NULL);
+}
+
+meshopt_OverdrawStatistics meshopt_analyzeOverdrawParallel(const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, size_t resolution, size_t view_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_analyzeOverdrawParallel");
+
+	return analyzeOverdraw(indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, resolution, view_count, parallel_for, context);
+}
+
+#undef SIMD_SSE
@@ -5,16 +5,74 @@
 #include <math.h>
 #include <string.h>
 
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
 // This work is based on:
 // Pedro Sander, Diego Nehab and Joshua Barczak. Fast Triangle Reordering for Vertex Locality and Reduced Overdraw. 2007
 namespace meshopt
 {
 
-static void calculateSortData(float* sort_data, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride, const unsigned int* clusters, size_t cluster_count)
+// soft boundaries are generated by tasks that process hard clusters with at least this many triangles
+const size_t kBoundaryBatchSize = 65536;
+
+// sort data is computed by tasks that process this many clusters
+const size_t kSortDataChunkSize = 4096;
+
+#if defined(SIMD_SSE)
+static __m128 loadPosition(const float* p)
+{
+	// avoid reading past the end of the last vertex
+	return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p)), _mm_load_ss(p + 2));
+}
+
+static __m128 dot3(__m128 a, __m128 b)
+{
+	__m128 m = _mm_mul_ps(a, b);
+
+	// sum components in x, y, z order to match scalar evaluation exactly
+	return _mm_add_ss(_mm_add_ss(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 1, 1, 1))), _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 2, 2, 2)));
+}
+#endif
+
+static void calculateMeshCentroid(float* mesh_centroid, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_positions_stride)
 {
 	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
 
-	float mesh_centroid[3] = {};
+#if defined(SIMD_SSE)
+	__m128 sum = _mm_setzero_ps();
+
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		const float* p = vertex_positions + vertex_stride_float * indices[i];
+
+		sum = _mm_add_ps(sum, loadPosition(p));
+	}
+
+	float result[4];
+	_mm_storeu_ps(result, _mm_div_ps(sum, _mm_set1_ps(float(index_count))));
+
+	mesh_centroid[0] = result[0];
+	mesh_centroid[1] = result[1];
+	mesh_centroid[2] = result[2];
+#else
+	mesh_centroid[0] = mesh_centroid[1] = mesh_centroid[2] = 0.f;
 
 	for (size_t i = 0; i < index_count; ++i)
 	{
@@ -28,59 +86,102 @@ static void calculateSortData(float* sort_data, const unsigned int* indices, siz
 	mesh_centroid[0] /= index_count;
 	mesh_centroid[1] /= index_count;
 	mesh_centroid[2] /= index_count;
+#endif
+}
 
-	for (size_t cluster = 0; cluster < cluster_count; ++cluster)
+#if defined(SIMD_SSE)
+static float calculateClusterSortData(const unsigned int* indices, size_t cluster_begin, size_t cluster_end, const float* vertex_positions, size_t vertex_stride_float, const float* mesh_centroid)
+{
+	float cluster_area = 0;
+	__m128 cluster_centroid = _mm_setzero_ps();
+	__m128 cluster_normal = _mm_setzero_ps();
+
+	// all math is done per component in the same order as the scalar version, so the results are bit-identical
+	for (size_t i = cluster_begin; i < cluster_end; i += 3)
 	{
-		size_t cluster_begin = clusters[cluster] * 3;
-		size_t cluster_end = (cluster + 1 < cluster_count) ? clusters[cluster + 1] * 3 : index_count;
-		assert(cluster_begin < cluster_end);
+		__m128 p0 = loadPosition(vertex_positions + vertex_stride_float * indices[i + 0]);
+		__m128 p1 = loadPosition(vertex_positions + vertex_stride_float * indices[i + 1]);
+		__m128 p2 = loadPosition(vertex_positions + vertex_stride_float * indices[i + 2]);
 
-		float cluster_area = 0;
-		float cluster_centroid[3] = {};
-		float cluster_normal[3] = {};
+		__m128 p10 = _mm_sub_ps(p1, p0);
+		__m128 p20 = _mm_sub_ps(p2, p0);
 
-		for (size_t i = cluster_begin; i < cluster_end; i += 3)
-		{
-			const float* p0 = vertex_positions + vertex_stride_float * indices[i + 0];
-			const float* p1 = vertex_positions + vertex_stride_float * indices[i + 1];
-			const float* p2 = vertex_positions + vertex_stride_float * indices[i + 2];
-
-			float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
-			float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
-
-			float normalx = p10[1] * p20[2] - p10[2] * p20[1];
-			float normaly = p10[2] * p20[0] - p10[0] * p20[2];
-			float normalz = p10[0] * p20[1] - p10[1] * p20[0];
-
-			float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
-
-			cluster_centroid[0] += (p0[0] + p1[0] + p2[0]) * (area / 3);
-			cluster_centroid[1] += (p0[1] + p1[1] + p2[1]) * (area / 3);
-			cluster_centroid[2] += (p0[2] + p1[2] + p2[2]) * (area / 3);
-			cluster_normal[0] += normalx;
-			cluster_normal[1] += normaly;
-			cluster_normal[2] += normalz;
-			cluster_area += area;
-		}
+		__m128 p10_yzx = _mm_shuffle_ps(p10, p10, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 p10_zxy = _mm_shuffle_ps(p10, p10, _MM_SHUFFLE(3, 1, 0, 2));
+		__m128 p20_yzx = _mm_shuffle_ps(p20, p20, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 p20_zxy = _mm_shuffle_ps(p20, p20, _MM_SHUFFLE(3, 1, 0, 2));
 
-		float inv_cluster_area = cluster_area == 0 ? 0 : 1 / cluster_area;
+		__m128 normal = _mm_sub_ps(_mm_mul_ps(p10_yzx, p20_zxy), _mm_mul_ps(p10_zxy, p20_yzx));
 
-		cluster_centroid[0] *= inv_cluster_area;
-		cluster_centroid[1] *= inv_cluster_area;
-		cluster_centroid[2] *= inv_cluster_area;
+		float area = _mm_cvtss_f32(_mm_sqrt_ss(dot3(normal, normal)));
 
-		float cluster_normal_length = sqrtf(cluster_normal[0] * cluster_normal[0] + cluster_normal[1] * cluster_normal[1] + cluster_normal[2] * cluster_normal[2]);
-		float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
+		cluster_centroid = _mm_add_ps(cluster_centroid, _mm_mul_ps(_mm_add_ps(_mm_add_ps(p0, p1), p2), _mm_set1_ps(area / 3)));
+		cluster_normal = _mm_add_ps(cluster_normal, normal);
+		cluster_area += area;
+	}
+
+	float inv_cluster_area = cluster_area == 0 ? 0 : 1 / cluster_area;
+
+	cluster_centroid = _mm_mul_ps(cluster_centroid, _mm_set1_ps(inv_cluster_area));
+
+	float cluster_normal_length = _mm_cvtss_f32(_mm_sqrt_ss(dot3(cluster_normal, cluster_normal)));
+	float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
 
-		cluster_normal[0] *= inv_cluster_normal_length;
-		cluster_normal[1] *= inv_cluster_normal_length;
-		cluster_normal[2] *= inv_cluster_normal_length;
+	cluster_normal = _mm_mul_ps(cluster_normal, _mm_set1_ps(inv_cluster_normal_length));
 
-		float centroid_vector[3] = {cluster_centroid[0] - mesh_centroid[0], cluster_centroid[1] - mesh_centroid[1], cluster_centroid[2] - mesh_centroid[2]};
+	__m128 centroid_vector = _mm_sub_ps(cluster_centroid, loadPosition(mesh_centroid));
 
-		sort_data[cluster] = centroid_vector[0] * cluster_normal[0] + centroid_vector[1] * cluster_normal[1] + centroid_vector[2] * cluster_normal[2];
+	return _mm_cvtss_f32(dot3(centroid_vector, cluster_normal));
+}
+#else
+static float calculateClusterSortData(const unsigned int* indices, size_t cluster_begin, size_t cluster_end, const float* vertex_positions, size_t vertex_stride_float, const float* mesh_centroid)
+{
+	float cluster_area = 0;
+	float cluster_centroid[3] = {};
+	float cluster_normal[3] = {};
+
+	for (size_t i = cluster_begin; i < cluster_end; i += 3)
+	{
+		const float* p0 = vertex_positions + vertex_stride_float * indices[i + 0];
+		const float* p1 = vertex_positions + vertex_stride_float * indices[i + 1];
+		const float* p2 = vertex_positions + vertex_stride_float * indices[i + 2];
+
+		float p10[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+		float p20[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+
+		float normalx = p10[1] * p20[2] - p10[2] * p20[1];
+		float normaly = p10[2] * p20[0] - p10[0] * p20[2];
+		float normalz = p10[0] * p20[1] - p10[1] * p20[0];
+
+		float area = sqrtf(normalx * normalx + normaly * normaly + normalz * normalz);
+
+		cluster_centroid[0] += (p0[0] + p1[0] + p2[0]) * (area / 3);
+		cluster_centroid[1] += (p0[1] + p1[1] + p2[1]) * (area / 3);
+		cluster_centroid[2] += (p0[2] + p1[2] + p2[2]) * (area / 3);
+		cluster_normal[0] += normalx;
+		cluster_normal[1] += normaly;
+		cluster_normal[2] += normalz;
+		cluster_area += area;
 	}
+
+	float inv_cluster_area = cluster_area == 0 ? 0 : 1 / cluster_area;
+
+	cluster_centroid[0] *= inv_cluster_area;
+	cluster_centroid[1] *= inv_cluster_area;
+	cluster_centroid[2] *= inv_cluster_area;
+
+	float cluster_normal_length = sqrtf(cluster_normal[0] * cluster_normal[0] + cluster_normal[1] * cluster_normal[1] + cluster_normal[2] * cluster_normal[2]);
+	float inv_cluster_normal_length = cluster_normal_length == 0 ? 0 : 1 / cluster_normal_length;
+
+	cluster_normal[0] *= inv_cluster_normal_length;
+	cluster_normal[1] *= inv_cluster_normal_length;
+	cluster_normal[2] *= inv_cluster_normal_length;
+
+	float centroid_vector[3] = {cluster_centroid[0] - mesh_centroid[0], cluster_centroid[1] - mesh_centroid[1], cluster_centroid[2] - mesh_centroid[2]};
+
+	return centroid_vector[0] * cluster_normal[0] + centroid_vector[1] * cluster_normal[1] + centroid_vector[2] * cluster_normal[2];
 }
+#endif
 
 static void calculateSortOrderRadix(unsigned int* sort_order, const float* sort_data, unsigned short* sort_keys, size_t cluster_count)
 {
@@ -265,12 +366,132 @@ static size_t generateSoftBoundaries(unsigned int* destination, const unsigned i
 	return result;
 }
 
-} // namespace meshopt
+struct BatchRemapHasher
+{
+	const unsigned int* remap;
 
-void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
+	size_t hash(unsigned int id) const
+	{
+		return id * 0x5bd1e995;
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return remap[lhs] == rhs;
+	}
+};
+
+struct OptimizeOverdrawTask
 {
-	using namespace meshopt;
+	const unsigned int* indices;
+	size_t index_count;
+	size_t vertex_count;
+	const float* vertex_positions;
+	size_t vertex_stride_float;
+	unsigned int cache_size;
+	float threshold;
+
+	// each batch of hard clusters writes soft boundaries at the position of its first triangle, offset by batch index
+	const unsigned int* hard_clusters;
+	size_t hard_cluster_count;
+	const size_t* batches;
+	unsigned int* soft_clusters;
+	size_t* soft_counts;
+
+	const unsigned int* clusters;
+	size_t cluster_count;
+	float mesh_centroid[4];
+	float* sort_data;
+};
+
+static void softBoundariesTask(void* context, size_t batch)
+{
+	const OptimizeOverdrawTask& t = *static_cast<OptimizeOverdrawTask*>(context);
+
+	size_t first = t.batches[batch], last = t.batches[batch + 1];
+	size_t face_begin = t.hard_clusters[first];
+	size_t face_end = last < t.hard_cluster_count ? t.hard_clusters[last] : t.index_count / 3;
+	size_t batch_indices = (face_end - face_begin) * 3;
+
+	meshopt_Allocator allocator;
+
+	// remap batch vertices to a compact range so that cache timestamps are proportional to batch size, not mesh size
+	unsigned int* remap = allocator.allocate<unsigned int>(batch_indices);
+	unsigned int* local = allocator.allocate<unsigned int>(batch_indices);
 
+	size_t table_size = meshopt_hashBuckets(batch_indices);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	BatchRemapHasher hasher = {remap};
+	size_t hashmod = table_size - 1;
+	size_t local_count = 0;
+
+	for (size_t i = 0; i < batch_indices; ++i)
+	{
+		unsigned int index = t.indices[face_begin * 3 + i];
+		assert(index < t.vertex_count);
+
+		size_t bucket = hasher.hash(index) & hashmod;
+
+		// quadratic probing; the table is never full since it has more buckets than indices
+		for (size_t probe = 0; table[bucket] != ~0u && !hasher.equal(table[bucket], index); ++probe)
+			bucket = (bucket + probe + 1) & hashmod;
+
+		if (table[bucket] == ~0u)
+		{
+			remap[local_count] = index;
+			table[bucket] = unsigned(local_count++);
+		}
+
+		local[i] = table[bucket];
+	}
+
+	// hard cluster boundaries and resulting soft boundaries are relative to the first triangle in the batch
+	unsigned int* local_clusters = allocator.allocate<unsigned int>(last - first);
+
+	for (size_t i = first; i < last; ++i)
+		local_clusters[i - first] = unsigned(t.hard_clusters[i] - face_begin);
+
+	unsigned int* cache_timestamps = allocator.allocate<unsigned int>(local_count);
+
+	unsigned int* destination = t.soft_clusters + face_begin + batch;
+	size_t result = generateSoftBoundaries(destination, local, batch_indices, local_count, local_clusters, last - first, t.cache_size, t.threshold, cache_timestamps);
+
+	for (size_t i = 0; i < result; ++i)
+		destination[i] += unsigned(face_begin);
+
+	t.soft_counts[batch] = result;
+}
+
+static void sortDataTask(void* context, size_t chunk)
+{
+	const OptimizeOverdrawTask& t = *static_cast<OptimizeOverdrawTask*>(context);
+
+	size_t begin = chunk * kSortDataChunkSize;
+	size_t end = begin + kSortDataChunkSize < t.cluster_count ? begin + kSortDataChunkSize : t.cluster_count;
+
+	for (size_t cluster = begin; cluster < end; ++cluster)
+	{
+		size_t cluster_begin = t.clusters[cluster] * 3;
+		size_t cluster_end = (cluster + 1 < t.cluster_count) ? t.clusters[cluster + 1] * 3 : t.index_count;
+		assert(cluster_begin < cluster_end);
+
+		t.sort_data[cluster] = calculateClusterSortData(t.indices, cluster_begin, cluster_end, t.vertex_positions, t.vertex_stride_float, t.mesh_centroid);
+	}
+}
+
+static void runOptimizeOverdrawTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), OptimizeOverdrawTask* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
+static void optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_ParallelFor parallel_for, void* context)
+{
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
@@ -291,22 +512,74 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 
 	unsigned int cache_size = 16;
 
+	size_t face_count = index_count / 3;
+
 	unsigned int* cache_timestamps = allocator.allocate<unsigned int>(vertex_count);
 
-	// generate hard boundaries from full-triangle cache misses
-	unsigned int* hard_clusters = allocator.allocate<unsigned int>(index_count / 3);
+	// generate hard boundaries from full-triangle cache misses; this depends on the cache state from all previous triangles so it's sequential
+	unsigned int* hard_clusters = allocator.allocate<unsigned int>(face_count);
 	size_t hard_cluster_count = generateHardBoundaries(hard_clusters, indices, index_count, vertex_count, cache_size, cache_timestamps);
 
-	// generate soft boundaries
-	unsigned int* soft_clusters = allocator.allocate<unsigned int>(index_count / 3 + 1);
-	size_t soft_cluster_count = generateSoftBoundaries(soft_clusters, indices, index_count, vertex_count, hard_clusters, hard_cluster_count, cache_size, threshold, cache_timestamps);
+	// soft boundaries never cross hard boundaries, so groups of hard clusters can be processed in parallel
+	size_t* batches = allocator.allocate<size_t>(hard_cluster_count + 1);
+	size_t batch_count = 0;
+
+	for (size_t i = 0; i < hard_cluster_count; ++i)
+		if (i == 0 || (parallel_for && hard_clusters[i] - hard_clusters[batches[batch_count - 1]] >= kBoundaryBatchSize))
+			batches[batch_count++] = i;
+
+	batches[batch_count] = hard_cluster_count;
+
+	// generate soft boundaries; each batch needs an extra element since the last boundary can be written before being removed
+	unsigned int* soft_clusters = allocator.allocate<unsigned int>(face_count + batch_count);
+	size_t* soft_counts = allocator.allocate<size_t>(batch_count);
+
+	OptimizeOverdrawTask task = {};
+	task.indices = indices;
+	task.index_count = index_count;
+	task.vertex_count = vertex_count;
+	task.vertex_positions = vertex_positions;
+	task.vertex_stride_float = vertex_positions_stride / sizeof(float);
+	task.cache_size = cache_size;
+	task.threshold = threshold;
+	task.hard_clusters = hard_clusters;
+	task.hard_cluster_count = hard_cluster_count;
+	task.batches = batches;
+	task.soft_clusters = soft_clusters;
+	task.soft_counts = soft_counts;
+
+	size_t soft_cluster_count = 0;
+
+	if (batch_count == 1)
+	{
+		// a single batch can reuse the cache timestamps instead of remapping the vertices
+		soft_cluster_count = generateSoftBoundaries(soft_clusters, indices, index_count, vertex_count, hard_clusters, hard_cluster_count, cache_size, threshold, cache_timestamps);
+	}
+	else
+	{
+		runOptimizeOverdrawTasks(parallel_for, context, softBoundariesTask, &task, batch_count);
+
+		// compact soft boundaries from all batches in order
+		for (size_t i = 0; i < batch_count; ++i)
+		{
+			memmove(soft_clusters + soft_cluster_count, soft_clusters + hard_clusters[batches[i]] + i, soft_counts[i] * sizeof(unsigned int));
+			soft_cluster_count += soft_counts[i];
+		}
+	}
 
 	const unsigned int* clusters = soft_clusters;
 	size_t cluster_count = soft_cluster_count;
 
 	// fill sort data
 	float* sort_data = allocator.allocate<float>(cluster_count);
-	calculateSortData(sort_data, indices, index_count, vertex_positions, vertex_positions_stride, clusters, cluster_count);
+
+	calculateMeshCentroid(task.mesh_centroid, indices, index_count, vertex_positions, vertex_positions_stride);
+
+	task.clusters = clusters;
+	task.cluster_count = cluster_count;
+	task.sort_data = sort_data;
+
+	runOptimizeOverdrawTasks(parallel_for, context, sortDataTask, &task, (cluster_count + kSortDataChunkSize - 1) / kSortDataChunkSize);
 
 	// sort clusters using sort data
 	unsigned short* sort_keys = allocator.allocate<unsigned short>(cluster_count);
@@ -331,3 +604,25 @@ void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* ind
 
 	assert(offset == index_count);
 }
+
+} // namespace meshopt
+
+void meshopt_optimizeOverdraw(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_optimizeOverdraw");
+
+	optimizeOverdraw(destination, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold, NULL, NULL);
+}
+
+void meshopt_optimizeOverdrawParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, float threshold, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_optimizeOverdrawParallel");
+
+	optimizeOverdraw(destination, indices, index_count, vertex_positions, vertex_count, vertex_positions_stride, threshold, parallel_for, context);
+}
+
+#undef SIMD_SSE
@@ -2,6 +2,26 @@
 #include "meshoptimizer.h"
 
 #include <assert.h>
+#include <string.h>
+
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
 
 union FloatBits
 {
@@ -74,3 +94,357 @@ float meshopt_dequantizeHalf(unsigned short h)
 	u.ui = s | r;
 	return u.f;
 }
+
+namespace meshopt
+{
+
+// strided input is gathered into a small buffer so that kernels only need to handle contiguous values
+const size_t kQuantizeBlock = 256;
+
+template <typename T, int Components>
+static void gatherFixed(T* buffer, const char* source, size_t vector_count, size_t stride)
+{
+	for (size_t i = 0; i < vector_count; ++i)
+	{
+		memcpy(buffer, source, Components * sizeof(T));
+
+		buffer += Components;
+		source += stride;
+	}
+}
+
+template <typename T>
+static const T* gatherValues(T* buffer, const T* data, size_t vector_offset, size_t vector_count, size_t components, size_t stride)
+{
+	const char* source = reinterpret_cast<const char*>(data) + vector_offset * stride;
+
+	// packed input doesn't need to be copied
+	if (stride == components * sizeof(T))
+		return reinterpret_cast<const T*>(source);
+
+	T* write = buffer;
+
+	// common vector sizes use fixed size copies which compile to plain loads and stores
+	switch (components)
+	{
+	case 2:
+		gatherFixed<T, 2>(write, source, vector_count, stride);
+		break;
+	case 3:
+		gatherFixed<T, 3>(write, source, vector_count, stride);
+		break;
+	case 4:
+		gatherFixed<T, 4>(write, source, vector_count, stride);
+		break;
+	default:
+		for (size_t i = 0; i < vector_count; ++i)
+		{
+			memcpy(write, source, components * sizeof(T));
+
+			write += components;
+			source += stride;
+		}
+	}
+
+	return buffer;
+}
+
+// the kernels process values in groups of 4 with SIMD and fall back to scalar functions for the remainder; both paths produce identical results
+struct QuantizeUnorm
+{
+	int N;
+
+	template <typename T>
+	void operator()(T* destination, const float* data, size_t size) const
+	{
+		size_t i = 0;
+
+#ifdef SIMD_SSE
+		__m128 scale = _mm_set1_ps(float((1 << N) - 1));
+
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(data + i);
+
+			// max returns the second argument for NaN, which matches the scalar clamp
+			v = _mm_max_ps(v, _mm_setzero_ps());
+			v = _mm_min_ps(v, _mm_set1_ps(1.f));
+
+			__m128i q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), _mm_set1_ps(0.5f)));
+
+			store(destination + i, q);
+		}
+#endif
+
+		for (; i < size; ++i)
+			destination[i] = T(meshopt_quantizeUnorm(data[i], N));
+	}
+
+#ifdef SIMD_SSE
+	static void store(unsigned char* destination, __m128i q)
+	{
+		__m128i r = _mm_packus_epi16(_mm_packs_epi32(q, q), _mm_setzero_si128());
+		int v = _mm_cvtsi128_si32(r);
+		memcpy(destination, &v, 4);
+	}
+
+	static void store(unsigned short* destination, __m128i q)
+	{
+		// sign extension allows using signed saturation for values up to 65535
+		__m128i r = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(q, 16), 16), _mm_setzero_si128());
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), r);
+	}
+#endif
+};
+
+struct QuantizeSnorm
+{
+	int N;
+
+	template <typename T>
+	void operator()(T* destination, const float* data, size_t size) const
+	{
+		size_t i = 0;
+
+#ifdef SIMD_SSE
+		__m128 scale = _mm_set1_ps(float((1 << (N - 1)) - 1));
+
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128 v = _mm_loadu_ps(data + i);
+
+			// round is selected before clamping, and NaN is clamped to -1 with -0.5 rounding, which matches the scalar code
+			__m128 sign = _mm_cmpge_ps(v, _mm_setzero_ps());
+			__m128 round = _mm_or_ps(_mm_and_ps(sign, _mm_set1_ps(0.5f)), _mm_andnot_ps(sign, _mm_set1_ps(-0.5f)));
+
+			v = _mm_max_ps(v, _mm_set1_ps(-1.f));
+			v = _mm_min_ps(v, _mm_set1_ps(1.f));
+
+			__m128i q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), round));
+
+			store(destination + i, q);
+		}
+#endif
+
+		for (; i < size; ++i)
+			destination[i] = T(meshopt_quantizeSnorm(data[i], N));
+	}
+
+#ifdef SIMD_SSE
+	static void store(signed char* destination, __m128i q)
+	{
+		__m128i r = _mm_packs_epi16(_mm_packs_epi32(q, q), _mm_setzero_si128());
+		int v = _mm_cvtsi128_si32(r);
+		memcpy(destination, &v, 4);
+	}
+
+	static void store(short* destination, __m128i q)
+	{
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(destination), _mm_packs_epi32(q, q));
+	}
+#endif
+};
+
+struct QuantizeHalf
+{
+	void operator()(unsigned short* destination, const float* data, size_t size) const
+	{
+		size_t i = 0;
+
+#ifdef SIMD_SSE
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128i ui = _mm_castps_si128(_mm_loadu_ps(data + i));
+
+			__m128i s = _mm_and_si128(_mm_srli_epi32(ui, 16), _mm_set1_epi32(0x8000));
+			__m128i em = _mm_and_si128(ui, _mm_set1_epi32(0x7fffffff));
+
+			// this mirrors meshopt_quantizeHalf step by step
+			__m128i h = _mm_srai_epi32(_mm_add_epi32(em, _mm_set1_epi32((1 << 12) - (112 << 23))), 13);
+
+			__m128i un = _mm_cmplt_epi32(em, _mm_set1_epi32(113 << 23));
+			h = _mm_andnot_si128(un, h);
+
+			__m128i of = _mm_cmpgt_epi32(em, _mm_set1_epi32((143 << 23) - 1));
+			h = _mm_or_si128(_mm_andnot_si128(of, h), _mm_and_si128(of, _mm_set1_epi32(0x7c00)));
+
+			__m128i nan = _mm_cmpgt_epi32(em, _mm_set1_epi32(255 << 23));
+			h = _mm_or_si128(_mm_andnot_si128(nan, h), _mm_and_si128(nan, _mm_set1_epi32(0x7e00)));
+
+			h = _mm_or_si128(s, h);
+
+			// sign extension allows using signed saturation for values up to 65535
+			__m128i r = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(h, 16), 16), _mm_setzero_si128());
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(destination + i), r);
+		}
+#endif
+
+		for (; i < size; ++i)
+			destination[i] = meshopt_quantizeHalf(data[i]);
+	}
+};
+
+struct QuantizeFloat
+{
+	int N;
+
+	void operator()(float* destination, const float* data, size_t size) const
+	{
+		size_t i = 0;
+
+#ifdef SIMD_SSE
+		__m128i mask = _mm_set1_epi32((1 << (23 - N)) - 1);
+		__m128i round = _mm_set1_epi32((1 << (23 - N)) >> 1);
+		__m128i expmask = _mm_set1_epi32(0x7f800000);
+
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128i ui = _mm_castps_si128(_mm_loadu_ps(data + i));
+
+			__m128i e = _mm_and_si128(ui, expmask);
+			__m128i rui = _mm_andnot_si128(mask, _mm_add_epi32(ui, round));
+
+			// round all numbers except inf/nan, and flush denormals to zero
+			__m128i special = _mm_cmpeq_epi32(e, expmask);
+			ui = _mm_or_si128(_mm_and_si128(special, ui), _mm_andnot_si128(special, rui));
+			ui = _mm_andnot_si128(_mm_cmpeq_epi32(e, _mm_setzero_si128()), ui);
+
+			_mm_storeu_ps(destination + i, _mm_castsi128_ps(ui));
+		}
+#endif
+
+		for (; i < size; ++i)
+			destination[i] = meshopt_quantizeFloat(data[i], N);
+	}
+};
+
+struct DequantizeHalf
+{
+	void operator()(float* destination, const unsigned short* data, size_t size) const
+	{
+		size_t i = 0;
+
+#ifdef SIMD_SSE
+		for (; i + 4 <= size; i += 4)
+		{
+			__m128i h = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i)), _mm_setzero_si128());
+
+			__m128i s = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+			__m128i em = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+
+			// this mirrors meshopt_dequantizeHalf step by step
+			__m128i r = _mm_slli_epi32(_mm_add_epi32(em, _mm_set1_epi32(112 << 10)), 13);
+
+			r = _mm_andnot_si128(_mm_cmplt_epi32(em, _mm_set1_epi32(1 << 10)), r);
+			r = _mm_add_epi32(r, _mm_and_si128(_mm_cmpgt_epi32(em, _mm_set1_epi32((31 << 10) - 1)), _mm_set1_epi32(112 << 23)));
+
+			_mm_storeu_ps(destination + i, _mm_castsi128_ps(_mm_or_si128(s, r)));
+		}
+#endif
+
+		for (; i < size; ++i)
+			destination[i] = meshopt_dequantizeHalf(data[i]);
+	}
+};
+
+template <typename T, typename S, typename Kernel>
+static void quantizeArray(T* destination, const S* data, size_t count, size_t components, size_t stride, const Kernel& kernel)
+{
+	assert(components > 0 && components <= kQuantizeBlock);
+	assert(stride >= components * sizeof(S) && stride % sizeof(S) == 0);
+
+	S buffer[kQuantizeBlock];
+
+	size_t block_vectors = kQuantizeBlock / components;
+
+	for (size_t i = 0; i < count; i += block_vectors)
+	{
+		size_t vectors = count - i < block_vectors ? count - i : block_vectors;
+
+		kernel(destination + i * components, gatherValues(buffer, data, i, vectors, components, stride), vectors * components);
+	}
+}
+
+} // namespace meshopt
+
+void meshopt_quantizeUnormArray8(unsigned char* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	using namespace meshopt;
+
+	assert(N >= 1 && N <= 8);
+
+	meshopt_Instrument instrument("meshopt_quantizeUnormArray8");
+
+	QuantizeUnorm kernel = {N};
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_quantizeUnormArray16(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	using namespace meshopt;
+
+	assert(N >= 1 && N <= 16);
+
+	meshopt_Instrument instrument("meshopt_quantizeUnormArray16");
+
+	QuantizeUnorm kernel = {N};
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_quantizeSnormArray8(signed char* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	using namespace meshopt;
+
+	assert(N >= 2 && N <= 8);
+
+	meshopt_Instrument instrument("meshopt_quantizeSnormArray8");
+
+	QuantizeSnorm kernel = {N};
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_quantizeSnormArray16(short* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	using namespace meshopt;
+
+	assert(N >= 2 && N <= 16);
+
+	meshopt_Instrument instrument("meshopt_quantizeSnormArray16");
+
+	QuantizeSnorm kernel = {N};
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_quantizeHalfArray(unsigned short* destination, const float* data, size_t count, size_t components, size_t stride)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_quantizeHalfArray");
+
+	QuantizeHalf kernel;
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_quantizeFloatArray(float* destination, const float* data, size_t count, size_t components, size_t stride, int N)
+{
+	using namespace meshopt;
+
+	assert(N >= 0 && N <= 23);
+
+	meshopt_Instrument instrument("meshopt_quantizeFloatArray");
+
+	QuantizeFloat kernel = {N};
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+void meshopt_dequantizeHalfArray(float* destination, const unsigned short* data, size_t count, size_t components, size_t stride)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_dequantizeHalfArray");
+
+	DequantizeHalf kernel;
+	quantizeArray(destination, data, count, components, stride, kernel);
+}
+
+#undef SIMD_SSE
@@ -14,10 +14,61 @@
 #include <stdio.h>
 #endif
 
-#if TRACE
-#define TRACESTATS(i) stats[i]++;
+// TRACE >= 2 prints detailed collapse logs for debugging; statistics are reported through instrumentation events
+#if MESHOPTIMIZER_INSTRUMENTATION
+#define INSTRUMENTSTATS(i) stats[i]++;
+#else
+#define INSTRUMENTSTATS(i) (void)0
+#endif
+
+// The block below auto-detects SIMD ISA that can be used on the target platform
+#ifndef MESHOPTIMIZER_NO_SIMD
+
+// The SIMD implementation requires SSE2, which can be enabled unconditionally through compiler settings
+#if defined(__SSE2__)
+#define SIMD_SSE
+#endif
+
+// MSVC supports compiling SSE2 code regardless of compile options; we assume all 32-bit CPUs support SSE2
+#if !defined(SIMD_SSE) && defined(_MSC_VER) && !defined(__clang__) && (defined(_M_IX86) || defined(_M_X64))
+#define SIMD_SSE
+#endif
+
+// GCC/clang define these when NEON support is available
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SIMD_NEON
+#endif
+
+// On MSVC, we assume that ARM builds always target NEON-capable devices
+#if !defined(SIMD_NEON) && defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+#define SIMD_NEON
+#endif
+
+// When targeting Wasm SIMD we can't use runtime cpuid checks so we unconditionally enable SIMD
+#if defined(__wasm_simd128__)
+#define SIMD_WASM
+// Prevent compiling other variant when wasm simd compilation is active
+#undef SIMD_NEON
+#undef SIMD_SSE
+#endif
+
+#endif // !MESHOPTIMIZER_NO_SIMD
+
+#ifdef SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#ifdef SIMD_NEON
+#if defined(_MSC_VER) && defined(_M_ARM64)
+#include <arm64_neon.h>
 #else
-#define TRACESTATS(i) (void)0
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifdef SIMD_WASM
+#undef __DEPRECATED
+#include <wasm_simd128.h>
 #endif
 
 // This work is based on:
@@ -30,29 +81,32 @@
 namespace meshopt
 {
 
+template <typename V>
 struct EdgeAdjacency
 {
 	struct Edge
 	{
-		unsigned int next;
-		unsigned int prev;
+		V next;
+		V prev;
 	};
 
 	unsigned int* offsets;
 	Edge* data;
 };
 
-static void prepareEdgeAdjacency(EdgeAdjacency& adjacency, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+template <typename V>
+static void prepareEdgeAdjacency(EdgeAdjacency<V>& adjacency, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
 {
 	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count + 1);
-	adjacency.data = allocator.allocate<EdgeAdjacency::Edge>(index_count);
+	adjacency.data = allocator.allocate<typename EdgeAdjacency<V>::Edge>(index_count);
 }
 
-static void updateEdgeAdjacency(EdgeAdjacency& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, const unsigned int* remap)
+template <typename V>
+static void updateEdgeAdjacency(EdgeAdjacency<V>& adjacency, const unsigned int* indices, size_t index_count, size_t vertex_count, const V* remap)
 {
 	size_t face_count = index_count / 3;
 	unsigned int* offsets = adjacency.offsets + 1;
-	EdgeAdjacency::Edge* data = adjacency.data;
+	typename EdgeAdjacency<V>::Edge* data = adjacency.data;
 
 	// fill edge counts
 	memset(offsets, 0, vertex_count * sizeof(unsigned int));
@@ -151,15 +205,6 @@ struct RemapHasher
 	}
 };
 
-static size_t hashBuckets2(size_t count)
-{
-	size_t buckets = 1;
-	while (buckets < count + count / 4)
-		buckets *= 2;
-
-	return buckets;
-}
-
 template <typename T, typename Hash>
 static T* hashLookup2(T* table, size_t buckets, const Hash& hash, const T& key, const T& empty)
 {
@@ -187,11 +232,12 @@ static T* hashLookup2(T* table, size_t buckets, const Hash& hash, const T& key,
 	return NULL;
 }
 
-static void buildPositionRemap(unsigned int* remap, unsigned int* wedge, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const unsigned int* sparse_remap, meshopt_Allocator& allocator)
+template <typename V>
+static void buildPositionRemap(V* remap, V* wedge, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const unsigned int* sparse_remap, meshopt_Allocator& allocator)
 {
 	PositionHasher hasher = {vertex_positions_data, vertex_positions_stride / sizeof(float), sparse_remap};
 
-	size_t table_size = hashBuckets2(vertex_count);
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 	memset(table, -1, table_size * sizeof(unsigned int));
 
@@ -227,25 +273,34 @@ static void buildPositionRemap(unsigned int* remap, unsigned int* wedge, const f
 
 static unsigned int* buildSparseRemap(unsigned int* indices, size_t index_count, size_t vertex_count, size_t* out_vertex_count, meshopt_Allocator& allocator)
 {
-	// use a bit set to compute the precise number of unique vertices
-	unsigned char* filter = allocator.allocate<unsigned char>((vertex_count + 7) / 8);
-	memset(filter, 0, (vertex_count + 7) / 8);
-
 	size_t unique = 0;
-	for (size_t i = 0; i < index_count; ++i)
+
+	if (index_count < vertex_count / 32)
 	{
-		unsigned int index = indices[i];
-		assert(index < vertex_count);
+		// when the subset is much smaller than the vertex buffer, clearing a bit set dominates the cost; index count is a good enough upper bound
+		unique = index_count;
+	}
+	else
+	{
+		// use a bit set to compute the precise number of unique vertices
+		unsigned char* filter = allocator.allocate<unsigned char>((vertex_count + 7) / 8);
+		memset(filter, 0, (vertex_count + 7) / 8);
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			unsigned int index = indices[i];
+			assert(index < vertex_count);
 
-		unique += (filter[index / 8] & (1 << (index % 8))) == 0;
-		filter[index / 8] |= 1 << (index % 8);
+			unique += (filter[index / 8] & (1 << (index % 8))) == 0;
+			filter[index / 8] |= 1 << (index % 8);
+		}
 	}
 
 	unsigned int* remap = allocator.allocate<unsigned int>(unique);
 	size_t offset = 0;
 
 	// temporary map dense => sparse; we allocate it last so that we can deallocate it
-	size_t revremap_size = hashBuckets2(unique);
+	size_t revremap_size = meshopt_hashBuckets(unique);
 	unsigned int* revremap = allocator.allocate<unsigned int>(revremap_size);
 	memset(revremap, -1, revremap_size * sizeof(unsigned int));
 
@@ -255,6 +310,7 @@ static unsigned int* buildSparseRemap(unsigned int* indices, size_t index_count,
 	for (size_t i = 0; i < index_count; ++i)
 	{
 		unsigned int index = indices[i];
+		assert(index < vertex_count);
 
 		unsigned int* entry = hashLookup2(revremap, revremap_size, hasher, index, ~0u);
 
@@ -270,8 +326,8 @@ static unsigned int* buildSparseRemap(unsigned int* indices, size_t index_count,
 
 	allocator.deallocate(revremap);
 
-	assert(offset == unique);
-	*out_vertex_count = unique;
+	assert(offset <= unique);
+	*out_vertex_count = offset;
 
 	return remap;
 }
@@ -311,10 +367,11 @@ const unsigned char kHasOpposite[Kind_Count][Kind_Count] = {
     {1, 0, 1, 0, 0},
 };
 
-static bool hasEdge(const EdgeAdjacency& adjacency, unsigned int a, unsigned int b)
+template <typename V>
+static bool hasEdge(const EdgeAdjacency<V>& adjacency, unsigned int a, unsigned int b)
 {
 	unsigned int count = adjacency.offsets[a + 1] - adjacency.offsets[a];
-	const EdgeAdjacency::Edge* edges = adjacency.data + adjacency.offsets[a];
+	const typename EdgeAdjacency<V>::Edge* edges = adjacency.data + adjacency.offsets[a];
 
 	for (size_t i = 0; i < count; ++i)
 		if (edges[i].next == b)
@@ -323,23 +380,24 @@ static bool hasEdge(const EdgeAdjacency& adjacency, unsigned int a, unsigned int
 	return false;
 }
 
-static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned int* loopback, size_t vertex_count, const EdgeAdjacency& adjacency, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_lock, const unsigned int* sparse_remap, unsigned int options)
+template <typename V>
+static void classifyVertices(unsigned char* result, V* loop, V* loopback, size_t vertex_count, const EdgeAdjacency<V>& adjacency, const V* remap, const V* wedge, const unsigned char* vertex_lock, const unsigned int* sparse_remap, unsigned int options)
 {
-	memset(loop, -1, vertex_count * sizeof(unsigned int));
-	memset(loopback, -1, vertex_count * sizeof(unsigned int));
+	memset(loop, -1, vertex_count * sizeof(V));
+	memset(loopback, -1, vertex_count * sizeof(V));
 
 	// incoming & outgoing open edges: ~0u if no open edges, i if there are more than 1
 	// note that this is the same data as required in loop[] arrays; loop[] data is only valid for border/seam
 	// but here it's okay to fill the data out for other types of vertices as well
-	unsigned int* openinc = loopback;
-	unsigned int* openout = loop;
+	V* openinc = loopback;
+	V* openout = loop;
 
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
 		unsigned int vertex = unsigned(i);
 
 		unsigned int count = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
-		const EdgeAdjacency::Edge* edges = adjacency.data + adjacency.offsets[vertex];
+		const typename EdgeAdjacency<V>::Edge* edges = adjacency.data + adjacency.offsets[vertex];
 
 		for (size_t j = 0; j < count; ++j)
 		{
@@ -355,13 +413,13 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 			}
 			else if (!hasEdge(adjacency, target, vertex))
 			{
-				openinc[target] = (openinc[target] == ~0u) ? vertex : target;
-				openout[vertex] = (openout[vertex] == ~0u) ? target : vertex;
+				openinc[target] = (openinc[target] == V(~0u)) ? vertex : target;
+				openout[vertex] = (openout[vertex] == V(~0u)) ? target : vertex;
 			}
 		}
 	}
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 	size_t stats[4] = {};
 #endif
 
@@ -377,7 +435,7 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 				// note: we classify any vertices with no open edges as manifold
 				// this is technically incorrect - if 4 triangles share an edge, we'll classify vertices as manifold
 				// it's unclear if this is a problem in practice
-				if (openi == ~0u && openo == ~0u)
+				if (openi == V(~0u) && openo == V(~0u))
 				{
 					result[i] = Kind_Manifold;
 				}
@@ -388,7 +446,7 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 				else
 				{
 					result[i] = Kind_Locked;
-					TRACESTATS(0);
+					INSTRUMENTSTATS(0);
 				}
 			}
 			else if (wedge[wedge[i]] == i)
@@ -399,8 +457,8 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 				unsigned int openiw = openinc[w], openow = openout[w];
 
 				// seam should have one open half-edge for each vertex, and the edges need to "connect" - point to the same vertex post-remap
-				if (openiv != ~0u && openiv != i && openov != ~0u && openov != i &&
-				    openiw != ~0u && openiw != w && openow != ~0u && openow != w)
+				if (openiv != V(~0u) && openiv != i && openov != V(~0u) && openov != i &&
+				    openiw != V(~0u) && openiw != w && openow != V(~0u) && openow != w)
 				{
 					if (remap[openiv] == remap[openow] && remap[openov] == remap[openiw] && remap[openiv] != remap[openov])
 					{
@@ -409,20 +467,20 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 					else
 					{
 						result[i] = Kind_Locked;
-						TRACESTATS(1);
+						INSTRUMENTSTATS(1);
 					}
 				}
 				else
 				{
 					result[i] = Kind_Locked;
-					TRACESTATS(2);
+					INSTRUMENTSTATS(2);
 				}
 			}
 			else
 			{
 				// more than one vertex maps to this one; we don't have classification available
 				result[i] = Kind_Locked;
-				TRACESTATS(3);
+				INSTRUMENTSTATS(3);
 			}
 		}
 		else
@@ -450,9 +508,11 @@ static void classifyVertices(unsigned char* result, unsigned int* loop, unsigned
 			if (result[i] == Kind_Border)
 				result[i] = Kind_Locked;
 
-#if TRACE
-	printf("locked: many open edges %d, disconnected seam %d, many seam edges %d, many wedges %d\n",
-	    int(stats[0]), int(stats[1]), int(stats[2]), int(stats[3]));
+#if MESHOPTIMIZER_INSTRUMENTATION
+	meshopt_Instrument::counter("locked_open_edges", double(stats[0]));
+	meshopt_Instrument::counter("locked_disconnected_seam", double(stats[1]));
+	meshopt_Instrument::counter("locked_seam_edges", double(stats[2]));
+	meshopt_Instrument::counter("locked_wedges", double(stats[3]));
 #endif
 }
 
@@ -510,7 +570,7 @@ static float rescalePositions(Vector3* result, const float* vertex_positions_dat
 	return extent;
 }
 
-static void rescaleAttributes(float* result, const float* vertex_attributes_data, size_t vertex_count, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned int* attribute_remap, const unsigned int* sparse_remap)
+static void rescaleAttributes(float* result, const float* vertex_attributes_data, size_t vertex_count, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, size_t result_stride, const unsigned int* attribute_remap, const unsigned int* sparse_remap)
 {
 	size_t vertex_attributes_stride_float = vertex_attributes_stride / sizeof(float);
 
@@ -523,11 +583,96 @@ static void rescaleAttributes(float* result, const float* vertex_attributes_data
 			unsigned int rk = attribute_remap[k];
 			float a = vertex_attributes_data[ri * vertex_attributes_stride_float + rk];
 
-			result[i * attribute_count + k] = a * attribute_weights[rk];
+			result[i * result_stride + k] = a * attribute_weights[rk];
 		}
+
+		for (size_t k = attribute_count; k < result_stride; ++k)
+			result[i * result_stride + k] = 0.f;
 	}
 }
 
+// 4-wide float vector used for attribute quadrics; all implementations perform the same operations in the same order, so results are identical across platforms
+#if defined(SIMD_SSE)
+typedef __m128 Float4;
+
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 splat4(float v) { return _mm_set1_ps(v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+#elif defined(SIMD_NEON)
+typedef float32x4_t Float4;
+
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 splat4(float v) { return vdupq_n_f32(v); }
+inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+#elif defined(SIMD_WASM)
+typedef v128_t Float4;
+
+inline Float4 load4(const float* p) { return wasm_v128_load(p); }
+inline void store4(float* p, Float4 v) { wasm_v128_store(p, v); }
+inline Float4 splat4(float v) { return wasm_f32x4_splat(v); }
+inline Float4 add4(Float4 a, Float4 b) { return wasm_f32x4_add(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return wasm_f32x4_sub(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return wasm_f32x4_mul(a, b); }
+#else
+struct Float4
+{
+	float v[4];
+};
+
+inline Float4 load4(const float* p)
+{
+	Float4 r = {{p[0], p[1], p[2], p[3]}};
+	return r;
+}
+
+inline void store4(float* p, Float4 v)
+{
+	p[0] = v.v[0], p[1] = v.v[1], p[2] = v.v[2], p[3] = v.v[3];
+}
+
+inline Float4 splat4(float v)
+{
+	Float4 r = {{v, v, v, v}};
+	return r;
+}
+
+inline Float4 add4(Float4 a, Float4 b)
+{
+	Float4 r = {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+	return r;
+}
+
+inline Float4 sub4(Float4 a, Float4 b)
+{
+	Float4 r = {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+	return r;
+}
+
+inline Float4 mul4(Float4 a, Float4 b)
+{
+	Float4 r = {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};
+	return r;
+}
+#endif
+
+// adds lanes to r one by one; this matches the summation order of a scalar loop over attributes, so results don't depend on the block layout
+inline void accumulate4(float& r, Float4 v)
+{
+	float t[4];
+	store4(t, v);
+
+	r += t[0];
+	r += t[1];
+	r += t[2];
+	r += t[3];
+}
+
 static const size_t kMaxAttributes = 32;
 
 struct Quadric
@@ -539,10 +684,16 @@ struct Quadric
 	float w;
 };
 
+// attributes are processed in blocks of 4 to simplify SIMD evaluation; attribute data is padded with zeros to a multiple of the block size
+static const size_t kAttributeBlock = 4;
+
 struct QuadricGrad
 {
-	// gx*x + gy*y + gz*z + gw
-	float gx, gy, gz, gw;
+	// gx*x + gy*y + gz*z + gw, for each of the 4 attributes in a block
+	float gx[kAttributeBlock];
+	float gy[kAttributeBlock];
+	float gz[kAttributeBlock];
+	float gw[kAttributeBlock];
 };
 
 struct Reservoir
@@ -552,10 +703,11 @@ struct Reservoir
 	float w;
 };
 
+template <typename V>
 struct Collapse
 {
-	unsigned int v0;
-	unsigned int v1;
+	V v0;
+	V v1;
 
 	union
 	{
@@ -596,12 +748,14 @@ static void quadricAdd(Quadric& Q, const Quadric& R)
 
 static void quadricAdd(QuadricGrad* G, const QuadricGrad* R, size_t attribute_count)
 {
-	for (size_t k = 0; k < attribute_count; ++k)
+	assert(attribute_count % kAttributeBlock == 0);
+
+	for (size_t k = 0; k < attribute_count / kAttributeBlock; ++k)
 	{
-		G[k].gx += R[k].gx;
-		G[k].gy += R[k].gy;
-		G[k].gz += R[k].gz;
-		G[k].gw += R[k].gw;
+		store4(G[k].gx, add4(load4(G[k].gx), load4(R[k].gx)));
+		store4(G[k].gy, add4(load4(G[k].gy), load4(R[k].gy)));
+		store4(G[k].gz, add4(load4(G[k].gz), load4(R[k].gz)));
+		store4(G[k].gw, add4(load4(G[k].gw), load4(R[k].gw)));
 	}
 }
 
@@ -641,15 +795,20 @@ static float quadricError(const Quadric& Q, const Vector3& v)
 
 static float quadricError(const Quadric& Q, const QuadricGrad* G, size_t attribute_count, const Vector3& v, const float* va)
 {
+	assert(attribute_count % kAttributeBlock == 0);
+
 	float r = quadricEval(Q, v);
 
+	Float4 vx = splat4(v.x), vy = splat4(v.y), vz = splat4(v.z), w = splat4(Q.w);
+
 	// see quadricFromAttributes for general derivation; here we need to add the parts of (eval(pos) - attr)^2 that depend on attr
-	for (size_t k = 0; k < attribute_count; ++k)
+	for (size_t k = 0; k < attribute_count / kAttributeBlock; ++k)
 	{
-		float a = va[k];
-		float g = v.x * G[k].gx + v.y * G[k].gy + v.z * G[k].gz + G[k].gw;
+		Float4 a = load4(&va[k * kAttributeBlock]);
+		Float4 g = add4(add4(add4(mul4(vx, load4(G[k].gx)), mul4(vy, load4(G[k].gy))), mul4(vz, load4(G[k].gz))), load4(G[k].gw));
 
-		r += a * (a * Q.w - 2 * g);
+		// a * (a * w - 2 * g); padded attributes are zero and don't contribute to the error
+		accumulate4(r, mul4(a, sub4(mul4(a, w), add4(g, g))));
 	}
 
 	// note: unlike position error, we do not normalize by Q.w to retain edge scaling as described in quadricFromAttributes
@@ -756,47 +915,54 @@ static void quadricFromAttributes(Quadric& Q, QuadricGrad* G, const Vector3& p0,
 	float gz1 = (d11 * v0.z - d01 * v1.z) * denomr;
 	float gz2 = (d00 * v1.z - d01 * v0.z) * denomr;
 
+	assert(attribute_count % kAttributeBlock == 0);
+
+	Float4 pw = splat4(w);
+	Float4 px = splat4(p0.x), py = splat4(p0.y), pz = splat4(p0.z);
+
 	memset(&Q, 0, sizeof(Quadric));
 
 	Q.w = w;
 
-	for (size_t k = 0; k < attribute_count; ++k)
+	for (size_t k = 0; k < attribute_count / kAttributeBlock; ++k)
 	{
-		float a0 = va0[k], a1 = va1[k], a2 = va2[k];
+		Float4 a0 = load4(&va0[k * kAttributeBlock]), a1 = load4(&va1[k * kAttributeBlock]), a2 = load4(&va2[k * kAttributeBlock]);
+		Float4 d10 = sub4(a1, a0), d20 = sub4(a2, a0);
 
 		// compute gradient of eval(pos) for x/y/z/w
 		// the formulas below are obtained by directly computing derivative of eval(pos) = a0 * u + a1 * v + a2 * w
-		float gx = gx1 * (a1 - a0) + gx2 * (a2 - a0);
-		float gy = gy1 * (a1 - a0) + gy2 * (a2 - a0);
-		float gz = gz1 * (a1 - a0) + gz2 * (a2 - a0);
-		float gw = a0 - p0.x * gx - p0.y * gy - p0.z * gz;
+		Float4 gx = add4(mul4(splat4(gx1), d10), mul4(splat4(gx2), d20));
+		Float4 gy = add4(mul4(splat4(gy1), d10), mul4(splat4(gy2), d20));
+		Float4 gz = add4(mul4(splat4(gz1), d10), mul4(splat4(gz2), d20));
+		Float4 gw = sub4(sub4(sub4(a0, mul4(px, gx)), mul4(py, gy)), mul4(pz, gz));
 
 		// quadric encodes (eval(pos)-attr)^2; this means that the resulting expansion needs to compute, for example, pos.x * pos.y * K
 		// since quadrics already encode factors for pos.x * pos.y, we can accumulate almost everything in basic quadric fields
 		// note: for simplicity we scale all factors by weight here instead of outside the loop
-		Q.a00 += w * (gx * gx);
-		Q.a11 += w * (gy * gy);
-		Q.a22 += w * (gz * gz);
+		accumulate4(Q.a00, mul4(pw, mul4(gx, gx)));
+		accumulate4(Q.a11, mul4(pw, mul4(gy, gy)));
+		accumulate4(Q.a22, mul4(pw, mul4(gz, gz)));
 
-		Q.a10 += w * (gy * gx);
-		Q.a20 += w * (gz * gx);
-		Q.a21 += w * (gz * gy);
+		accumulate4(Q.a10, mul4(pw, mul4(gy, gx)));
+		accumulate4(Q.a20, mul4(pw, mul4(gz, gx)));
+		accumulate4(Q.a21, mul4(pw, mul4(gz, gy)));
 
-		Q.b0 += w * (gx * gw);
-		Q.b1 += w * (gy * gw);
-		Q.b2 += w * (gz * gw);
+		accumulate4(Q.b0, mul4(pw, mul4(gx, gw)));
+		accumulate4(Q.b1, mul4(pw, mul4(gy, gw)));
+		accumulate4(Q.b2, mul4(pw, mul4(gz, gw)));
 
-		Q.c += w * (gw * gw);
+		accumulate4(Q.c, mul4(pw, mul4(gw, gw)));
 
 		// the only remaining sum components are ones that depend on attr; these will be addded during error evaluation, see quadricError
-		G[k].gx = w * gx;
-		G[k].gy = w * gy;
-		G[k].gz = w * gz;
-		G[k].gw = w * gw;
+		store4(G[k].gx, mul4(pw, gx));
+		store4(G[k].gy, mul4(pw, gy));
+		store4(G[k].gz, mul4(pw, gz));
+		store4(G[k].gw, mul4(pw, gw));
 	}
 }
 
-static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap)
+template <typename V>
+static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const V* remap)
 {
 	for (size_t i = 0; i < index_count; i += 3)
 	{
@@ -813,50 +979,61 @@ static void fillFaceQuadrics(Quadric* vertex_quadrics, const unsigned int* indic
 	}
 }
 
-static void fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const unsigned int* remap, const unsigned char* vertex_kind, const unsigned int* loop, const unsigned int* loopback)
+template <typename V>
+static bool getEdgeQuadric(Quadric& Q, const unsigned int* indices, size_t i, int e, const Vector3* vertex_positions, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback)
 {
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		static const int next[4] = {1, 2, 0, 1};
+	static const int next[4] = {1, 2, 0, 1};
 
-		for (int e = 0; e < 3; ++e)
-		{
-			unsigned int i0 = indices[i + e];
-			unsigned int i1 = indices[i + next[e]];
+	unsigned int i0 = indices[i + e];
+	unsigned int i1 = indices[i + next[e]];
 
-			unsigned char k0 = vertex_kind[i0];
-			unsigned char k1 = vertex_kind[i1];
+	unsigned char k0 = vertex_kind[i0];
+	unsigned char k1 = vertex_kind[i1];
 
-			// check that either i0 or i1 are border/seam and are on the same edge loop
-			// note that we need to add the error even for edged that connect e.g. border & locked
-			// if we don't do that, the adjacent border->border edge won't have correct errors for corners
-			if (k0 != Kind_Border && k0 != Kind_Seam && k1 != Kind_Border && k1 != Kind_Seam)
-				continue;
+	// check that either i0 or i1 are border/seam and are on the same edge loop
+	// note that we need to add the error even for edged that connect e.g. border & locked
+	// if we don't do that, the adjacent border->border edge won't have correct errors for corners
+	if (k0 != Kind_Border && k0 != Kind_Seam && k1 != Kind_Border && k1 != Kind_Seam)
+		return false;
 
-			if ((k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
-				continue;
+	if ((k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
+		return false;
 
-			if ((k1 == Kind_Border || k1 == Kind_Seam) && loopback[i1] != i0)
-				continue;
+	if ((k1 == Kind_Border || k1 == Kind_Seam) && loopback[i1] != i0)
+		return false;
 
-			// seam edges should occur twice (i0->i1 and i1->i0) - skip redundant edges
-			if (kHasOpposite[k0][k1] && remap[i1] > remap[i0])
-				continue;
+	// seam edges should occur twice (i0->i1 and i1->i0) - skip redundant edges
+	if (kHasOpposite[k0][k1] && remap[i1] > remap[i0])
+		return false;
+
+	unsigned int i2 = indices[i + next[e + 1]];
 
-			unsigned int i2 = indices[i + next[e + 1]];
+	// we try hard to maintain border edge geometry; seam edges can move more freely
+	// due to topological restrictions on collapses, seam quadrics slightly improves collapse structure but aren't critical
+	const float kEdgeWeightSeam = 1.f;
+	const float kEdgeWeightBorder = 10.f;
 
-			// we try hard to maintain border edge geometry; seam edges can move more freely
-			// due to topological restrictions on collapses, seam quadrics slightly improves collapse structure but aren't critical
-			const float kEdgeWeightSeam = 1.f;
-			const float kEdgeWeightBorder = 10.f;
+	float edgeWeight = (k0 == Kind_Border || k1 == Kind_Border) ? kEdgeWeightBorder : kEdgeWeightSeam;
+
+	quadricFromTriangleEdge(Q, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], edgeWeight);
+	return true;
+}
 
-			float edgeWeight = (k0 == Kind_Border || k1 == Kind_Border) ? kEdgeWeightBorder : kEdgeWeightSeam;
+template <typename V>
+static void fillEdgeQuadrics(Quadric* vertex_quadrics, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback)
+{
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		static const int next[3] = {1, 2, 0};
 
+		for (int e = 0; e < 3; ++e)
+		{
 			Quadric Q;
-			quadricFromTriangleEdge(Q, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], edgeWeight);
+			if (!getEdgeQuadric(Q, indices, i, e, vertex_positions, remap, vertex_kind, loop, loopback))
+				continue;
 
-			quadricAdd(vertex_quadrics[remap[i0]], Q);
-			quadricAdd(vertex_quadrics[remap[i1]], Q);
+			quadricAdd(vertex_quadrics[remap[indices[i + e]]], Q);
+			quadricAdd(vertex_quadrics[remap[indices[i + next[e]]]], Q);
 		}
 	}
 }
@@ -870,17 +1047,239 @@ static void fillAttributeQuadrics(Quadric* attribute_quadrics, QuadricGrad* attr
 		unsigned int i2 = indices[i + 2];
 
 		Quadric QA;
-		QuadricGrad G[kMaxAttributes];
+		QuadricGrad G[kMaxAttributes / kAttributeBlock];
 		quadricFromAttributes(QA, G, vertex_positions[i0], vertex_positions[i1], vertex_positions[i2], &vertex_attributes[i0 * attribute_count], &vertex_attributes[i1 * attribute_count], &vertex_attributes[i2 * attribute_count], attribute_count);
 
 		quadricAdd(attribute_quadrics[i0], QA);
 		quadricAdd(attribute_quadrics[i1], QA);
 		quadricAdd(attribute_quadrics[i2], QA);
 
-		quadricAdd(&attribute_gradients[i0 * attribute_count], G, attribute_count);
-		quadricAdd(&attribute_gradients[i1 * attribute_count], G, attribute_count);
-		quadricAdd(&attribute_gradients[i2 * attribute_count], G, attribute_count);
+		quadricAdd(&attribute_gradients[i0 * (attribute_count / kAttributeBlock)], G, attribute_count);
+		quadricAdd(&attribute_gradients[i1 * (attribute_count / kAttributeBlock)], G, attribute_count);
+		quadricAdd(&attribute_gradients[i2 * (attribute_count / kAttributeBlock)], G, attribute_count);
+	}
+}
+
+struct SimplifyScheduler
+{
+	meshopt_ParallelFor parallel_for;
+	void* context;
+};
+
+// parallel work is split into fixed-size ranges so that the results don't depend on the number of threads
+const size_t kParallelTaskSize = 4096;
+
+static void parallelFor(const SimplifyScheduler& scheduler, void (*task)(void*, size_t), void* task_context, size_t count)
+{
+	size_t task_count = (count + kParallelTaskSize - 1) / kParallelTaskSize;
+
+	if (scheduler.parallel_for && task_count > 1)
+		scheduler.parallel_for(scheduler.context, task, task_context, task_count);
+	else
+		for (size_t i = 0; i < task_count; ++i)
+			task(task_context, i);
+}
+
+static double getSimplifyTime(const meshopt_SimplifyStats& stats)
+{
+	return stats.timer ? stats.timer() : 0.0;
+}
+
+static void addSimplifyTime(meshopt_SimplifyStats& stats, double& phase, double& last)
+{
+	// each phase is measured from the end of the previous phase, so the phase times add up to the total time
+	if (stats.timer)
+	{
+		double now = stats.timer();
+		phase += now - last;
+		last = now;
+	}
+}
+
+template <typename V>
+static size_t countCollapsesOverError(const Collapse<V>* collapses, size_t collapse_count, float error_limit)
+{
+	size_t result = 0;
+
+	for (size_t i = 0; i < collapse_count; ++i)
+		result += collapses[i].error > error_limit;
+
+	return result;
+}
+
+template <typename V>
+static void buildCornerLists(unsigned int* offsets, unsigned int* corners, const unsigned int* indices, size_t index_count, size_t vertex_count, const V* remap)
+{
+	// corners are sorted by vertex and then by index offset, which matches the order in which fill*Quadrics accumulate quadrics for each vertex
+	memset(offsets, 0, (vertex_count + 1) * sizeof(unsigned int));
+
+	for (size_t i = 0; i < index_count; ++i)
+		offsets[(remap ? remap[indices[i]] : indices[i]) + 1]++;
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		offsets[i + 1] += offsets[i];
+
+	assert(offsets[vertex_count] == index_count);
+
+	for (size_t i = 0; i < index_count; ++i)
+		corners[offsets[remap ? remap[indices[i]] : indices[i]]++] = unsigned(i);
+
+	// offsets were shifted by one vertex during the fill
+	for (size_t i = vertex_count; i > 0; --i)
+		offsets[i] = offsets[i - 1];
+
+	offsets[0] = 0;
+}
+
+template <typename V>
+struct QuadricTask
+{
+	Quadric* vertex_quadrics;
+	Quadric* attribute_quadrics;
+	QuadricGrad* attribute_gradients;
+
+	const unsigned int* indices;
+	size_t vertex_count;
+	const Vector3* vertex_positions;
+	const float* vertex_attributes;
+	size_t attribute_count;
+	const V* remap;
+	const unsigned char* vertex_kind;
+	const V* loop;
+	const V* loopback;
+
+	const unsigned int* corner_offsets;
+	const unsigned int* corners;
+	const unsigned int* attribute_corner_offsets;
+	const unsigned int* attribute_corners;
+};
+
+template <typename V>
+static void fillQuadricsTask(void* context, size_t task)
+{
+	// this computes the same quadrics as fillFaceQuadrics/fillEdgeQuadrics/fillAttributeQuadrics, but accumulates them per vertex instead of per triangle
+	// each vertex sums contributions in the same order as the serial code, at the cost of evaluating each triangle quadric once per corner
+	const QuadricTask<V>& t = *static_cast<QuadricTask<V>*>(context);
+	const unsigned int* indices = t.indices;
+
+	size_t begin = task * kParallelTaskSize;
+	size_t end = begin + kParallelTaskSize < t.vertex_count ? begin + kParallelTaskSize : t.vertex_count;
+
+	for (size_t v = begin; v < end; ++v)
+	{
+		const unsigned int* corners = &t.corners[t.corner_offsets[v]];
+		size_t corner_count = t.corner_offsets[v + 1] - t.corner_offsets[v];
+
+		if (corner_count == 0)
+			continue;
+
+		Quadric& vq = t.vertex_quadrics[v];
+
+		// a triangle may reference the same position in multiple corners; corners are sorted so we can process each triangle once
+		for (size_t j = 0; j < corner_count; ++j)
+		{
+			size_t i = corners[j] - corners[j] % 3;
+
+			if (j > 0 && corners[j - 1] >= i)
+				continue;
+
+			Quadric Q;
+			quadricFromTriangle(Q, t.vertex_positions[indices[i + 0]], t.vertex_positions[indices[i + 1]], t.vertex_positions[indices[i + 2]], 1.f);
+
+			for (int k = 0; k < 3; ++k)
+				if (t.remap[indices[i + k]] == v)
+					quadricAdd(vq, Q);
+		}
+
+		for (size_t j = 0; j < corner_count; ++j)
+		{
+			size_t i = corners[j] - corners[j] % 3;
+
+			if (j > 0 && corners[j - 1] >= i)
+				continue;
+
+			static const int next[3] = {1, 2, 0};
+
+			for (int e = 0; e < 3; ++e)
+			{
+				unsigned int r0 = t.remap[indices[i + e]], r1 = t.remap[indices[i + next[e]]];
+
+				Quadric Q;
+				if ((r0 == v || r1 == v) && getEdgeQuadric(Q, indices, i, e, t.vertex_positions, t.remap, t.vertex_kind, t.loop, t.loopback))
+				{
+					if (r0 == v)
+						quadricAdd(vq, Q);
+					if (r1 == v)
+						quadricAdd(vq, Q);
+				}
+			}
+		}
+	}
+
+	if (!t.attribute_count)
+		return;
+
+	size_t attribute_count = t.attribute_count;
+
+	for (size_t v = begin; v < end; ++v)
+	{
+		const unsigned int* corners = &t.attribute_corners[t.attribute_corner_offsets[v]];
+		size_t corner_count = t.attribute_corner_offsets[v + 1] - t.attribute_corner_offsets[v];
+
+		for (size_t j = 0; j < corner_count; ++j)
+		{
+			size_t i = corners[j] - corners[j] % 3;
+
+			if (j > 0 && corners[j - 1] >= i)
+				continue;
+
+			unsigned int i0 = indices[i + 0];
+			unsigned int i1 = indices[i + 1];
+			unsigned int i2 = indices[i + 2];
+
+			Quadric QA;
+			QuadricGrad G[kMaxAttributes / kAttributeBlock];
+			quadricFromAttributes(QA, G, t.vertex_positions[i0], t.vertex_positions[i1], t.vertex_positions[i2], &t.vertex_attributes[i0 * attribute_count], &t.vertex_attributes[i1 * attribute_count], &t.vertex_attributes[i2 * attribute_count], attribute_count);
+
+			for (int k = 0; k < 3; ++k)
+				if (indices[i + k] == v)
+				{
+					quadricAdd(t.attribute_quadrics[v], QA);
+					quadricAdd(&t.attribute_gradients[v * (attribute_count / kAttributeBlock)], G, attribute_count);
+				}
+		}
+	}
+}
+
+template <typename V>
+static void fillQuadricsParallel(const SimplifyScheduler& scheduler, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, const unsigned int* indices, size_t index_count, const Vector3* vertex_positions, const float* vertex_attributes, size_t attribute_count, size_t vertex_count, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback, meshopt_Allocator& allocator)
+{
+	unsigned int* corner_offsets = allocator.allocate<unsigned int>(vertex_count + 1);
+	unsigned int* corners = allocator.allocate<unsigned int>(index_count);
+	buildCornerLists(corner_offsets, corners, indices, index_count, vertex_count, remap);
+
+	// attribute quadrics are accumulated per vertex, not per position
+	unsigned int* attribute_corner_offsets = NULL;
+	unsigned int* attribute_corners = NULL;
+
+	if (attribute_count)
+	{
+		attribute_corner_offsets = allocator.allocate<unsigned int>(vertex_count + 1);
+		attribute_corners = allocator.allocate<unsigned int>(index_count);
+		buildCornerLists(attribute_corner_offsets, attribute_corners, indices, index_count, vertex_count, static_cast<const V*>(NULL));
+	}
+
+	QuadricTask<V> task = {vertex_quadrics, attribute_quadrics, attribute_gradients, indices, vertex_count, vertex_positions, vertex_attributes, attribute_count, remap, vertex_kind, loop, loopback, corner_offsets, corners, attribute_corner_offsets, attribute_corners};
+	parallelFor(scheduler, fillQuadricsTask<V>, &task, vertex_count);
+
+	if (attribute_count)
+	{
+		allocator.deallocate(attribute_corners);
+		allocator.deallocate(attribute_corner_offsets);
 	}
+
+	allocator.deallocate(corners);
+	allocator.deallocate(corner_offsets);
 }
 
 // does triangle ABC flip when C is replaced with D?
@@ -902,7 +1301,8 @@ static bool hasTriangleFlip(const Vector3& a, const Vector3& b, const Vector3& c
 	return ndp <= 0.25f * sqrtf(abc * abd);
 }
 
-static bool hasTriangleFlips(const EdgeAdjacency& adjacency, const Vector3* vertex_positions, const unsigned int* collapse_remap, unsigned int i0, unsigned int i1)
+template <typename V>
+static bool hasTriangleFlips(const EdgeAdjacency<V>& adjacency, const Vector3* vertex_positions, const V* collapse_remap, unsigned int i0, unsigned int i1)
 {
 	assert(collapse_remap[i0] == i0);
 	assert(collapse_remap[i1] == i1);
@@ -910,7 +1310,7 @@ static bool hasTriangleFlips(const EdgeAdjacency& adjacency, const Vector3* vert
 	const Vector3& v0 = vertex_positions[i0];
 	const Vector3& v1 = vertex_positions[i1];
 
-	const EdgeAdjacency::Edge* edges = &adjacency.data[adjacency.offsets[i0]];
+	const typename EdgeAdjacency<V>::Edge* edges = &adjacency.data[adjacency.offsets[i0]];
 	size_t count = adjacency.offsets[i0 + 1] - adjacency.offsets[i0];
 
 	for (size_t i = 0; i < count; ++i)
@@ -936,7 +1336,8 @@ static bool hasTriangleFlips(const EdgeAdjacency& adjacency, const Vector3* vert
 	return false;
 }
 
-static size_t boundEdgeCollapses(const EdgeAdjacency& adjacency, size_t vertex_count, size_t index_count, unsigned char* vertex_kind)
+template <typename V>
+static size_t boundEdgeCollapses(const EdgeAdjacency<V>& adjacency, size_t vertex_count, size_t index_count, unsigned char* vertex_kind)
 {
 	size_t dual_count = 0;
 
@@ -954,7 +1355,64 @@ static size_t boundEdgeCollapses(const EdgeAdjacency& adjacency, size_t vertex_c
 	return (index_count - dual_count / 2) + 3;
 }
 
-static size_t pickEdgeCollapses(Collapse* collapses, size_t collapse_capacity, const unsigned int* indices, size_t index_count, const unsigned int* remap, const unsigned char* vertex_kind, const unsigned int* loop, const unsigned int* loopback)
+template <typename V>
+static bool pickEdgeCollapse(Collapse<V>& result, unsigned int i0, unsigned int i1, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback)
+{
+	// this can happen either when input has a zero-length edge, or when we perform collapses for complex
+	// topology w/seams and collapse a manifold vertex that connects to both wedges onto one of them
+	// we leave edges like this alone since they may be important for preserving mesh integrity
+	if (remap[i0] == remap[i1])
+		return false;
+
+	unsigned char k0 = vertex_kind[i0];
+	unsigned char k1 = vertex_kind[i1];
+
+	// the edge has to be collapsible in at least one direction
+	if (!(kCanCollapse[k0][k1] | kCanCollapse[k1][k0]))
+		return false;
+
+	// manifold and seam edges should occur twice (i0->i1 and i1->i0) - skip redundant edges
+	if (kHasOpposite[k0][k1] && remap[i1] > remap[i0])
+		return false;
+
+	// two vertices are on a border or a seam, but there's no direct edge between them
+	// this indicates that they belong to two different edge loops and we should not collapse this edge
+	// loop[] tracks half edges so we only need to check i0->i1
+	if (k0 == k1 && (k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
+		return false;
+
+	if (k0 == Kind_Locked || k1 == Kind_Locked)
+	{
+		// the same check as above, but for border/seam -> locked collapses
+		// loop[] and loopback[] track half edges so we only need to check one of them
+		if ((k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
+			return false;
+		if ((k1 == Kind_Border || k1 == Kind_Seam) && loopback[i1] != i0)
+			return false;
+	}
+
+	// edge can be collapsed in either direction - we will pick the one with minimum error
+	// note: we evaluate error later during collapse ranking, here we just tag the edge as bidirectional
+	if (kCanCollapse[k0][k1] & kCanCollapse[k1][k0])
+	{
+		Collapse<V> c = {V(i0), V(i1), {/* bidi= */ 1}};
+		result = c;
+	}
+	else
+	{
+		// edge can only be collapsed in one direction
+		unsigned int e0 = kCanCollapse[k0][k1] ? i0 : i1;
+		unsigned int e1 = kCanCollapse[k0][k1] ? i1 : i0;
+
+		Collapse<V> c = {V(e0), V(e1), {/* bidi= */ 0}};
+		result = c;
+	}
+
+	return true;
+}
+
+template <typename V>
+static size_t pickEdgeCollapses(Collapse<V>* collapses, size_t collapse_capacity, const unsigned int* indices, size_t index_count, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback)
 {
 	size_t collapse_count = 0;
 
@@ -971,66 +1429,19 @@ static size_t pickEdgeCollapses(Collapse* collapses, size_t collapse_capacity, c
 			unsigned int i0 = indices[i + e];
 			unsigned int i1 = indices[i + next[e]];
 
-			// this can happen either when input has a zero-length edge, or when we perform collapses for complex
-			// topology w/seams and collapse a manifold vertex that connects to both wedges onto one of them
-			// we leave edges like this alone since they may be important for preserving mesh integrity
-			if (remap[i0] == remap[i1])
-				continue;
-
-			unsigned char k0 = vertex_kind[i0];
-			unsigned char k1 = vertex_kind[i1];
-
-			// the edge has to be collapsible in at least one direction
-			if (!(kCanCollapse[k0][k1] | kCanCollapse[k1][k0]))
-				continue;
-
-			// manifold and seam edges should occur twice (i0->i1 and i1->i0) - skip redundant edges
-			if (kHasOpposite[k0][k1] && remap[i1] > remap[i0])
-				continue;
-
-			// two vertices are on a border or a seam, but there's no direct edge between them
-			// this indicates that they belong to two different edge loops and we should not collapse this edge
-			// loop[] tracks half edges so we only need to check i0->i1
-			if (k0 == k1 && (k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
-				continue;
-
-			if (k0 == Kind_Locked || k1 == Kind_Locked)
-			{
-				// the same check as above, but for border/seam -> locked collapses
-				// loop[] and loopback[] track half edges so we only need to check one of them
-				if ((k0 == Kind_Border || k0 == Kind_Seam) && loop[i0] != i1)
-					continue;
-				if ((k1 == Kind_Border || k1 == Kind_Seam) && loopback[i1] != i0)
-					continue;
-			}
-
-			// edge can be collapsed in either direction - we will pick the one with minimum error
-			// note: we evaluate error later during collapse ranking, here we just tag the edge as bidirectional
-			if (kCanCollapse[k0][k1] & kCanCollapse[k1][k0])
-			{
-				Collapse c = {i0, i1, {/* bidi= */ 1}};
-				collapses[collapse_count++] = c;
-			}
-			else
-			{
-				// edge can only be collapsed in one direction
-				unsigned int e0 = kCanCollapse[k0][k1] ? i0 : i1;
-				unsigned int e1 = kCanCollapse[k0][k1] ? i1 : i0;
-
-				Collapse c = {e0, e1, {/* bidi= */ 0}};
-				collapses[collapse_count++] = c;
-			}
+			collapse_count += pickEdgeCollapse(collapses[collapse_count], i0, i1, remap, vertex_kind, loop, loopback);
 		}
 	}
 
 	return collapse_count;
 }
 
-static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, const unsigned int* loop, const unsigned int* loopback)
+template <typename V>
+static void rankEdgeCollapses(Collapse<V>* collapses, size_t collapse_count, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const V* remap, const V* wedge, const unsigned char* vertex_kind, const V* loop, const V* loopback)
 {
 	for (size_t i = 0; i < collapse_count; ++i)
 	{
-		Collapse& c = collapses[i];
+		Collapse<V>& c = collapses[i];
 
 		unsigned int i0 = c.v0;
 		unsigned int i1 = c.v1;
@@ -1049,8 +1460,8 @@ static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const
 
 		if (attribute_count)
 		{
-			ei += quadricError(attribute_quadrics[i0], &attribute_gradients[i0 * attribute_count], attribute_count, vertex_positions[i1], &vertex_attributes[i1 * attribute_count]);
-			ej += c.bidi ? quadricError(attribute_quadrics[j0], &attribute_gradients[j0 * attribute_count], attribute_count, vertex_positions[j1], &vertex_attributes[j1 * attribute_count]) : 0;
+			ei += quadricError(attribute_quadrics[i0], &attribute_gradients[i0 * (attribute_count / kAttributeBlock)], attribute_count, vertex_positions[i1], &vertex_attributes[i1 * attribute_count]);
+			ej += c.bidi ? quadricError(attribute_quadrics[j0], &attribute_gradients[j0 * (attribute_count / kAttributeBlock)], attribute_count, vertex_positions[j1], &vertex_attributes[j1 * attribute_count]) : 0;
 
 			// note: seam edges need to aggregate attribute errors between primary and secondary edges, as attribute quadrics are separate
 			if (vertex_kind[i0] == Kind_Seam)
@@ -1060,13 +1471,13 @@ static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const
 				unsigned int s1 = loop[i0] == i1 ? loopback[s0] : loop[s0];
 
 				assert(s0 != i0 && wedge[s0] == i0);
-				assert(s1 != ~0u && remap[s1] == remap[i1]);
+				assert(s1 != V(~0u) && remap[s1] == remap[i1]);
 
 				// note: this should never happen due to the assertion above, but when disabled if we ever hit this case we'll get a memory safety issue; for now play it safe
-				s1 = (s1 != ~0u) ? s1 : wedge[i1];
+				s1 = (s1 != V(~0u)) ? s1 : wedge[i1];
 
-				ei += quadricError(attribute_quadrics[s0], &attribute_gradients[s0 * attribute_count], attribute_count, vertex_positions[s1], &vertex_attributes[s1 * attribute_count]);
-				ej += c.bidi ? quadricError(attribute_quadrics[s1], &attribute_gradients[s1 * attribute_count], attribute_count, vertex_positions[s0], &vertex_attributes[s0 * attribute_count]) : 0;
+				ei += quadricError(attribute_quadrics[s0], &attribute_gradients[s0 * (attribute_count / kAttributeBlock)], attribute_count, vertex_positions[s1], &vertex_attributes[s1 * attribute_count]);
+				ej += c.bidi ? quadricError(attribute_quadrics[s1], &attribute_gradients[s1 * (attribute_count / kAttributeBlock)], attribute_count, vertex_positions[s0], &vertex_attributes[s0 * attribute_count]) : 0;
 			}
 		}
 
@@ -1087,36 +1498,121 @@ static void rankEdgeCollapses(Collapse* collapses, size_t collapse_count, const
 	}
 }
 
-static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapses, size_t collapse_count)
+template <typename V>
+struct CollapseTask
 {
-	// we use counting sort to order collapses by error; since the exact sort order is not as critical,
-	// only top 12 bits of exponent+mantissa (8 bits of exponent and 4 bits of mantissa) are used.
-	// to avoid excessive stack usage, we clamp the exponent range as collapses with errors much higher than 1 are not useful.
-	const unsigned int sort_bits = 12;
-	const unsigned int sort_bins = 2048 + 512; // exponent range [-127, 32)
+	Collapse<V>* collapses;
+	size_t collapse_count;
+	size_t* collapse_counts;
 
-	// fill histogram for counting sort
-	unsigned int histogram[sort_bins];
-	memset(histogram, 0, sizeof(histogram));
+	const unsigned int* indices;
+	size_t index_count;
+	const Vector3* vertex_positions;
+	const float* vertex_attributes;
+	const Quadric* vertex_quadrics;
+	const Quadric* attribute_quadrics;
+	const QuadricGrad* attribute_gradients;
+	size_t attribute_count;
+	const V* remap;
+	const V* wedge;
+	const unsigned char* vertex_kind;
+	const V* loop;
+	const V* loopback;
+};
 
-	for (size_t i = 0; i < collapse_count; ++i)
-	{
-		// skip sign bit since error is non-negative
-		unsigned int error = collapses[i].errorui;
-		unsigned int key = (error << 1) >> (32 - sort_bits);
-		key = key < sort_bins ? key : sort_bins - 1;
+template <typename V>
+static void pickEdgeCollapsesTask(void* context, size_t task)
+{
+	const CollapseTask<V>& t = *static_cast<CollapseTask<V>*>(context);
 
-		histogram[key]++;
-	}
+	size_t begin = task * kParallelTaskSize * 3;
+	size_t end = begin + kParallelTaskSize * 3 < t.index_count ? begin + kParallelTaskSize * 3 : t.index_count;
 
-	// compute offsets based on histogram data
-	size_t histogram_sum = 0;
+	// each task writes up to 3 collapses per triangle into its own region
+	t.collapse_counts[task] = pickEdgeCollapses(&t.collapses[begin], end - begin, &t.indices[begin], end - begin, t.remap, t.vertex_kind, t.loop, t.loopback);
+}
 
-	for (size_t i = 0; i < sort_bins; ++i)
-	{
-		size_t count = histogram[i];
-		histogram[i] = unsigned(histogram_sum);
-		histogram_sum += count;
+template <typename V>
+static size_t pickEdgeCollapsesParallel(const SimplifyScheduler& scheduler, Collapse<V>* collapses, size_t collapse_capacity, Collapse<V>* scratch, const unsigned int* indices, size_t index_count, const V* remap, const unsigned char* vertex_kind, const V* loop, const V* loopback, meshopt_Allocator& allocator)
+{
+	size_t task_count = (index_count / 3 + kParallelTaskSize - 1) / kParallelTaskSize;
+
+	size_t* collapse_counts = allocator.allocate<size_t>(task_count);
+
+	CollapseTask<V> task = {scratch, 0, collapse_counts, indices, index_count, NULL, NULL, NULL, NULL, NULL, 0, remap, NULL, vertex_kind, loop, loopback};
+	parallelFor(scheduler, pickEdgeCollapsesTask<V>, &task, index_count / 3);
+
+	size_t collapse_count = 0;
+	for (size_t i = 0; i < task_count; ++i)
+		collapse_count += collapse_counts[i];
+
+	// concatenating per-task results in order produces the same sequence as the serial pick, unless the capacity would be exceeded
+	if (collapse_count + 3 > collapse_capacity)
+	{
+		allocator.deallocate(collapse_counts);
+		return pickEdgeCollapses(collapses, collapse_capacity, indices, index_count, remap, vertex_kind, loop, loopback);
+	}
+
+	size_t offset = 0;
+	for (size_t i = 0; i < task_count; ++i)
+	{
+		memcpy(&collapses[offset], &scratch[i * kParallelTaskSize * 3], collapse_counts[i] * sizeof(Collapse<V>));
+		offset += collapse_counts[i];
+	}
+
+	allocator.deallocate(collapse_counts);
+	return collapse_count;
+}
+
+template <typename V>
+static void rankEdgeCollapsesTask(void* context, size_t task)
+{
+	const CollapseTask<V>& t = *static_cast<CollapseTask<V>*>(context);
+
+	size_t begin = task * kParallelTaskSize;
+	size_t end = begin + kParallelTaskSize < t.collapse_count ? begin + kParallelTaskSize : t.collapse_count;
+
+	rankEdgeCollapses(&t.collapses[begin], end - begin, t.vertex_positions, t.vertex_attributes, t.vertex_quadrics, t.attribute_quadrics, t.attribute_gradients, t.attribute_count, t.remap, t.wedge, t.vertex_kind, t.loop, t.loopback);
+}
+
+template <typename V>
+static void rankEdgeCollapsesParallel(const SimplifyScheduler& scheduler, Collapse<V>* collapses, size_t collapse_count, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const V* remap, const V* wedge, const unsigned char* vertex_kind, const V* loop, const V* loopback)
+{
+	CollapseTask<V> task = {collapses, collapse_count, NULL, NULL, 0, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback};
+	parallelFor(scheduler, rankEdgeCollapsesTask<V>, &task, collapse_count);
+}
+
+template <typename V>
+static void sortEdgeCollapses(unsigned int* sort_order, const Collapse<V>* collapses, size_t collapse_count)
+{
+	// we use counting sort to order collapses by error; since the exact sort order is not as critical,
+	// only top 12 bits of exponent+mantissa (8 bits of exponent and 4 bits of mantissa) are used.
+	// to avoid excessive stack usage, we clamp the exponent range as collapses with errors much higher than 1 are not useful.
+	const unsigned int sort_bits = 12;
+	const unsigned int sort_bins = 2048 + 512; // exponent range [-127, 32)
+
+	// fill histogram for counting sort
+	unsigned int histogram[sort_bins];
+	memset(histogram, 0, sizeof(histogram));
+
+	for (size_t i = 0; i < collapse_count; ++i)
+	{
+		// skip sign bit since error is non-negative
+		unsigned int error = collapses[i].errorui;
+		unsigned int key = (error << 1) >> (32 - sort_bits);
+		key = key < sort_bins ? key : sort_bins - 1;
+
+		histogram[key]++;
+	}
+
+	// compute offsets based on histogram data
+	size_t histogram_sum = 0;
+
+	for (size_t i = 0; i < sort_bins; ++i)
+	{
+		size_t count = histogram[i];
+		histogram[i] = unsigned(histogram_sum);
+		histogram_sum += count;
 	}
 
 	assert(histogram_sum == collapse_count);
@@ -1133,7 +1629,8 @@ static void sortEdgeCollapses(unsigned int* sort_order, const Collapse* collapse
 	}
 }
 
-static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char* collapse_locked, const Collapse* collapses, size_t collapse_count, const unsigned int* collapse_order, const unsigned int* remap, const unsigned int* wedge, const unsigned char* vertex_kind, const unsigned int* loop, const unsigned int* loopback, const Vector3* vertex_positions, const EdgeAdjacency& adjacency, size_t triangle_collapse_goal, float error_limit, float& result_error)
+template <typename V>
+static size_t performEdgeCollapses(V* collapse_remap, unsigned char* collapse_locked, const Collapse<V>* collapses, size_t collapse_count, const unsigned int* collapse_order, const V* remap, const V* wedge, const unsigned char* vertex_kind, const V* loop, const V* loopback, const Vector3* vertex_positions, const EdgeAdjacency<V>& adjacency, size_t triangle_collapse_goal, float error_limit, float& result_error, meshopt_SimplifyStats& simplify_stats)
 {
 	size_t edge_collapses = 0;
 	size_t triangle_collapses = 0;
@@ -1142,25 +1639,25 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 	// note that edge_collapse_goal is an estimate; triangle_collapse_goal will be used to actually limit collapses
 	size_t edge_collapse_goal = triangle_collapse_goal / 2;
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 	size_t stats[7] = {};
 #endif
 
 	for (size_t i = 0; i < collapse_count; ++i)
 	{
-		const Collapse& c = collapses[collapse_order[i]];
+		const Collapse<V>& c = collapses[collapse_order[i]];
 
-		TRACESTATS(0);
+		INSTRUMENTSTATS(0);
 
 		if (c.error > error_limit)
 		{
-			TRACESTATS(4);
+			INSTRUMENTSTATS(4);
 			break;
 		}
 
 		if (triangle_collapses >= triangle_collapse_goal)
 		{
-			TRACESTATS(5);
+			INSTRUMENTSTATS(5);
 			break;
 		}
 
@@ -1172,7 +1669,7 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 		// topology, we only abort if we got over 1/6 collapses accordingly.
 		if (c.error > error_goal && c.error > result_error && triangle_collapses > triangle_collapse_goal / 6)
 		{
-			TRACESTATS(6);
+			INSTRUMENTSTATS(6);
 			break;
 		}
 
@@ -1189,7 +1686,8 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 		// it's important to not move other vertices towards a moved vertex to preserve error since we don't re-rank collapses mid-pass
 		if (collapse_locked[r0] | collapse_locked[r1])
 		{
-			TRACESTATS(1);
+			simplify_stats.rejected_moved++;
+			INSTRUMENTSTATS(1);
 			continue;
 		}
 
@@ -1198,7 +1696,8 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 			// adjust collapse goal since this collapse is invalid and shouldn't factor into error goal
 			edge_collapse_goal++;
 
-			TRACESTATS(2);
+			simplify_stats.rejected_flip++;
+			INSTRUMENTSTATS(2);
 			continue;
 		}
 
@@ -1226,7 +1725,7 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 			unsigned int s0 = wedge[i0];
 			unsigned int s1 = loop[i0] == i1 ? loopback[s0] : loop[s0];
 			assert(s0 != i0 && wedge[s0] == i0);
-			assert(s1 != ~0u && remap[s1] == r1);
+			assert(s1 != V(~0u) && remap[s1] == r1);
 
 			// additional asserts to verify that the seam pair is consistent
 			assert(kind != vertex_kind[i1] || s1 == wedge[i1]);
@@ -1234,7 +1733,7 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 			assert(loop[s0] == s1 || loopback[s0] == s1);
 
 			// note: this should never happen due to the assertion above, but when disabled if we ever hit this case we'll get a memory safety issue; for now play it safe
-			s1 = (s1 != ~0u) ? s1 : wedge[i1];
+			s1 = (s1 != V(~0u)) ? s1 : wedge[i1];
 
 			collapse_remap[i0] = i1;
 			collapse_remap[s0] = s1;
@@ -1254,24 +1753,27 @@ static size_t performEdgeCollapses(unsigned int* collapse_remap, unsigned char*
 		// border edges collapse 1 triangle, other edges collapse 2 or more
 		triangle_collapses += (kind == Kind_Border) ? 1 : 2;
 		edge_collapses++;
+		simplify_stats.collapses++;
 
 		result_error = result_error < c.error ? c.error : result_error;
 	}
 
-#if TRACE
-	float error_goal_last = edge_collapse_goal < collapse_count ? 1.5f * collapses[collapse_order[edge_collapse_goal]].error : FLT_MAX;
-	float error_goal_limit = error_goal_last < error_limit ? error_goal_last : error_limit;
-
-	printf("removed %d triangles, error %e (goal %e); evaluated %d/%d collapses (done %d, skipped %d, invalid %d); %s\n",
-	    int(triangle_collapses), sqrtf(result_error), sqrtf(error_goal_limit),
-	    int(stats[0]), int(collapse_count), int(edge_collapses), int(stats[1]), int(stats[2]),
-	    stats[4] ? "error limit" : (stats[5] ? "count limit" : (stats[6] ? "error goal" : "out of collapses")));
+#if MESHOPTIMIZER_INSTRUMENTATION
+	meshopt_Instrument::counter("triangle_collapses", double(triangle_collapses));
+	meshopt_Instrument::counter("collapses_evaluated", double(stats[0]));
+	meshopt_Instrument::counter("collapses_done", double(edge_collapses));
+	meshopt_Instrument::counter("collapses_skipped", double(stats[1]));
+	meshopt_Instrument::counter("collapses_invalid", double(stats[2]));
+	meshopt_Instrument::counter("pass_error_limit", double(stats[4]));
+	meshopt_Instrument::counter("pass_count_limit", double(stats[5]));
+	meshopt_Instrument::counter("pass_error_goal", double(stats[6]));
 #endif
 
 	return edge_collapses;
 }
 
-static void updateQuadrics(const unsigned int* collapse_remap, size_t vertex_count, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, size_t attribute_count, const Vector3* vertex_positions, const unsigned int* remap, float& vertex_error)
+template <typename V>
+static void updateQuadrics(const V* collapse_remap, size_t vertex_count, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, size_t attribute_count, const Vector3* vertex_positions, const V* remap, float& vertex_error)
 {
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
@@ -1291,7 +1793,7 @@ static void updateQuadrics(const unsigned int* collapse_remap, size_t vertex_cou
 		if (attribute_count)
 		{
 			quadricAdd(attribute_quadrics[i1], attribute_quadrics[i0]);
-			quadricAdd(&attribute_gradients[i1 * attribute_count], &attribute_gradients[i0 * attribute_count], attribute_count);
+			quadricAdd(&attribute_gradients[i1 * (attribute_count / kAttributeBlock)], &attribute_gradients[i0 * (attribute_count / kAttributeBlock)], attribute_count);
 
 			if (i0 == r0)
 			{
@@ -1303,7 +1805,8 @@ static void updateQuadrics(const unsigned int* collapse_remap, size_t vertex_cou
 	}
 }
 
-static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const unsigned int* collapse_remap)
+template <typename V>
+static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const V* collapse_remap)
 {
 	size_t write = 0;
 
@@ -1330,250 +1833,791 @@ static size_t remapIndexBuffer(unsigned int* indices, size_t index_count, const
 	return write;
 }
 
-static void remapEdgeLoops(unsigned int* loop, size_t vertex_count, const unsigned int* collapse_remap)
+template <typename V>
+static void remapEdgeLoops(V* loop, size_t vertex_count, const V* collapse_remap)
 {
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
 		// note: this is a no-op for vertices that were remapped
 		// ideally we would clear the loop entries for those for consistency, even though they aren't going to be used
 		// however, the remapping process needs loop information for remapped vertices, so this would require a separate pass
-		if (loop[i] != ~0u)
+		if (loop[i] != V(~0u))
 		{
 			unsigned int l = loop[i];
 			unsigned int r = collapse_remap[l];
 
 			// i == r is a special case when the seam edge is collapsed in a direction opposite to where loop goes
 			if (i == r)
-				loop[i] = (loop[l] != ~0u) ? collapse_remap[loop[l]] : ~0u;
+				loop[i] = (loop[l] != V(~0u)) ? collapse_remap[loop[l]] : ~0u;
 			else
 				loop[i] = r;
 		}
 	}
 }
 
-static unsigned int follow(unsigned int* parents, unsigned int index)
+// we use a bucket queue keyed by top 12 bits of the error, similarly to sortEdgeCollapses; collapses within a bucket are processed in the order they were added
+const size_t kCollapseQueueBins = 2048 + 512;
+const size_t kCollapseQueueGroup = 32;
+
+struct CollapseQueue
 {
-	while (index != parents[index])
+	struct Entry
 	{
-		unsigned int parent = parents[index];
-		parents[index] = parents[parent];
-		index = parent;
-	}
+		float error;
+		unsigned int v0;
+		unsigned int v1;
+		unsigned int version0;
+		unsigned int version1;
+		unsigned int next;
+	};
 
-	return index;
-}
+	Entry* entries;
+	size_t entry_count;
+	size_t capacity;
+	unsigned int free_list;
 
-static size_t buildComponents(unsigned int* components, size_t vertex_count, const unsigned int* indices, size_t index_count, const unsigned int* remap)
-{
-	for (size_t i = 0; i < vertex_count; ++i)
-		components[i] = unsigned(i);
+	unsigned int* bins;
+	unsigned int* bin_tails;
+	size_t min_bin;
 
-	// compute a unique (but not sequential!) index for each component via union-find
-	for (size_t i = 0; i < index_count; i += 3)
-	{
-		static const int next[4] = {1, 2, 0, 1};
+	// number of entries in each group of bins; this accelerates the search for the next non-empty bin
+	unsigned int groups[kCollapseQueueBins / kCollapseQueueGroup];
 
-		for (int e = 0; e < 3; ++e)
-		{
-			unsigned int i0 = indices[i + e];
-			unsigned int i1 = indices[i + next[e]];
+	// each vertex has a version that changes whenever collapses involving it need to be re-evaluated; moved vertices have version ~0
+	unsigned int* versions;
 
-			unsigned int r0 = remap[i0];
-			unsigned int r1 = remap[i1];
+	// singly linked lists of triangle corners for each position; corners of collapsed triangles are removed lazily
+	unsigned int* corners;
+	unsigned int* corner_next;
+};
 
-			r0 = follow(components, r0);
-			r1 = follow(components, r1);
+static void prepareCollapseQueue(CollapseQueue& queue, size_t index_count, size_t vertex_count, size_t collapse_capacity, meshopt_Allocator& allocator)
+{
+	// the queue can contain at most one valid entry per candidate edge; the rest of the capacity amortizes the cost of removing outdated entries
+	queue.capacity = collapse_capacity * 2;
 
-			// merge components with larger indices into components with smaller indices
-			// this guarantees that the root of the component is always the one with the smallest index
-			if (r0 != r1)
-				components[r0 < r1 ? r1 : r0] = r0 < r1 ? r0 : r1;
-		}
-	}
+	// all queue arrays share one allocation; the simplifier is close to the allocator block limit when sparse remapping and pruning are active
+	const size_t entry_words = sizeof(CollapseQueue::Entry) / sizeof(unsigned int);
+	unsigned int* data = allocator.allocate<unsigned int>(queue.capacity * entry_words + kCollapseQueueBins * 2 + vertex_count * 2 + index_count);
 
-	// make sure each element points to the component root *before* we renumber the components
-	for (size_t i = 0; i < vertex_count; ++i)
-		if (remap[i] == i)
-			components[i] = follow(components, unsigned(i));
+	queue.entries = reinterpret_cast<CollapseQueue::Entry*>(data);
+	data += queue.capacity * entry_words;
 
-	unsigned int next_component = 0;
+	queue.bins = data;
+	data += kCollapseQueueBins;
+	queue.bin_tails = data;
+	data += kCollapseQueueBins;
 
-	// renumber components using sequential indices
-	// a sequential pass is sufficient because component root always has the smallest index
-	// note: it is unsafe to use follow() in this pass because we're replacing component links with sequential indices inplace
-	for (size_t i = 0; i < vertex_count; ++i)
-	{
-		if (remap[i] == i)
-		{
-			unsigned int root = components[i];
-			assert(root <= i); // make sure we already computed the component for non-roots
-			components[i] = (root == i) ? next_component++ : components[root];
-		}
-		else
-		{
-			assert(remap[i] < i); // make sure we already computed the component
-			components[i] = components[remap[i]];
-		}
-	}
+	queue.versions = data;
+	memset(queue.versions, 0, vertex_count * sizeof(unsigned int));
+	data += vertex_count;
 
-	return next_component;
+	queue.corners = data;
+	data += vertex_count;
+	queue.corner_next = data;
 }
 
-static void measureComponents(float* component_errors, size_t component_count, const unsigned int* components, const Vector3* vertex_positions, size_t vertex_count)
+static bool isQueueEntryValid(const CollapseQueue& queue, const CollapseQueue::Entry& e)
 {
-	memset(component_errors, 0, component_count * 4 * sizeof(float));
+	return queue.versions[e.v0] == e.version0 && queue.versions[e.v1] == e.version1;
+}
 
-	// compute approximate sphere center for each component as an average
-	for (size_t i = 0; i < vertex_count; ++i)
+static size_t getQueueBin(float error)
+{
+	union
 	{
-		unsigned int c = components[i];
-		assert(components[i] < component_count);
+		float f;
+		unsigned int ui;
+	} u;
 
-		Vector3 v = vertex_positions[i]; // copy avoids aliasing issues
+	u.f = error;
 
-		component_errors[c * 4 + 0] += v.x;
-		component_errors[c * 4 + 1] += v.y;
-		component_errors[c * 4 + 2] += v.z;
-		component_errors[c * 4 + 3] += 1; // weight
-	}
+	// skip sign bit since error is non-negative
+	unsigned int key = (u.ui << 1) >> (32 - 12);
+	return key < kCollapseQueueBins ? key : kCollapseQueueBins - 1;
+}
 
-	// complete the center computation, and reinitialize [3] as a radius
-	for (size_t i = 0; i < component_count; ++i)
-	{
-		float w = component_errors[i * 4 + 3];
-		float iw = w == 0.f ? 0.f : 1.f / w;
+static void resetCollapseQueue(CollapseQueue& queue)
+{
+	queue.entry_count = 0;
+	queue.free_list = ~0u;
 
-		component_errors[i * 4 + 0] *= iw;
-		component_errors[i * 4 + 1] *= iw;
-		component_errors[i * 4 + 2] *= iw;
-		component_errors[i * 4 + 3] = 0; // radius
-	}
+	memset(queue.bins, -1, kCollapseQueueBins * sizeof(unsigned int));
+	memset(queue.groups, 0, sizeof(queue.groups));
+	queue.min_bin = kCollapseQueueBins;
+}
 
-	// compute squared radius for each component
-	for (size_t i = 0; i < vertex_count; ++i)
-	{
-		unsigned int c = components[i];
+static void appendCollapseQueue(CollapseQueue& queue, unsigned int index)
+{
+	CollapseQueue::Entry& e = queue.entries[index];
+	size_t bin = getQueueBin(e.error);
 
-		float dx = vertex_positions[i].x - component_errors[c * 4 + 0];
-		float dy = vertex_positions[i].y - component_errors[c * 4 + 1];
-		float dz = vertex_positions[i].z - component_errors[c * 4 + 2];
-		float r = dx * dx + dy * dy + dz * dz;
+	e.next = ~0u;
 
-		component_errors[c * 4 + 3] = component_errors[c * 4 + 3] < r ? r : component_errors[c * 4 + 3];
-	}
+	if (queue.bins[bin] == ~0u)
+		queue.bins[bin] = index;
+	else
+		queue.entries[queue.bin_tails[bin]].next = index;
 
-	// we've used the output buffer as scratch space, so we need to move the results to proper indices
-	for (size_t i = 0; i < component_count; ++i)
-	{
-#if TRACE >= 2
-		printf("component %d: center %f %f %f, error %e\n", int(i),
-		    component_errors[i * 4 + 0], component_errors[i * 4 + 1], component_errors[i * 4 + 2], sqrtf(component_errors[i * 4 + 3]));
-#endif
-		// note: we keep the squared error to make it match quadric error metric
-		component_errors[i] = component_errors[i * 4 + 3];
-	}
+	queue.bin_tails[bin] = index;
+	queue.groups[bin / kCollapseQueueGroup]++;
+	queue.min_bin = queue.min_bin < bin ? queue.min_bin : bin;
 }
 
-static size_t pruneComponents(unsigned int* indices, size_t index_count, const unsigned int* components, const float* component_errors, size_t component_count, float error_cutoff, float& nexterror)
+static void compactCollapseQueue(CollapseQueue& queue)
 {
-	size_t write = 0;
-
-	for (size_t i = 0; i < index_count; i += 3)
+	for (size_t bin = queue.min_bin; bin < kCollapseQueueBins; ++bin)
 	{
-		unsigned int c = components[indices[i]];
-		assert(c == components[indices[i + 1]] && c == components[indices[i + 2]]);
+		unsigned int* link = &queue.bins[bin];
+		unsigned int tail = ~0u;
 
-		if (component_errors[c] > error_cutoff)
+		while (*link != ~0u)
 		{
-			indices[write + 0] = indices[i + 0];
-			indices[write + 1] = indices[i + 1];
-			indices[write + 2] = indices[i + 2];
-			write += 3;
-		}
-	}
-
-#if TRACE
-	size_t pruned_components = 0;
-	for (size_t i = 0; i < component_count; ++i)
-		pruned_components += (component_errors[i] >= nexterror && component_errors[i] <= error_cutoff);
+			unsigned int index = *link;
 
-	printf("pruned %d triangles in %d components (goal %e)\n", int((index_count - write) / 3), int(pruned_components), sqrtf(error_cutoff));
-#endif
+			if (isQueueEntryValid(queue, queue.entries[index]))
+			{
+				tail = index;
+				link = &queue.entries[index].next;
+			}
+			else
+			{
+				*link = queue.entries[index].next;
+				queue.groups[bin / kCollapseQueueGroup]--;
 
-	// update next error with the smallest error of the remaining components for future pruning
-	nexterror = FLT_MAX;
-	for (size_t i = 0; i < component_count; ++i)
-		if (component_errors[i] > error_cutoff)
-			nexterror = nexterror > component_errors[i] ? component_errors[i] : nexterror;
+				queue.entries[index].next = queue.free_list;
+				queue.free_list = index;
+			}
+		}
 
-	return write;
+		queue.bin_tails[bin] = tail;
+	}
 }
 
-struct CellHasher
+template <typename V>
+static void pushCollapseQueue(CollapseQueue& queue, const Collapse<V>& c)
 {
-	const unsigned int* vertex_ids;
+	if (queue.free_list == ~0u && queue.entry_count == queue.capacity)
+		compactCollapseQueue(queue);
 
-	size_t hash(unsigned int i) const
-	{
-		unsigned int h = vertex_ids[i];
+	unsigned int index;
 
-		// MurmurHash2 finalizer
-		h ^= h >> 13;
-		h *= 0x5bd1e995;
-		h ^= h >> 15;
-		return h;
+	if (queue.free_list != ~0u)
+	{
+		index = queue.free_list;
+		queue.free_list = queue.entries[index].next;
 	}
-
-	bool equal(unsigned int lhs, unsigned int rhs) const
+	else if (queue.entry_count < queue.capacity)
 	{
-		return vertex_ids[lhs] == vertex_ids[rhs];
+		index = unsigned(queue.entry_count++);
 	}
-};
-
-struct IdHasher
-{
-	size_t hash(unsigned int id) const
+	else
 	{
-		unsigned int h = id;
-
-		// MurmurHash2 finalizer
-		h ^= h >> 13;
-		h *= 0x5bd1e995;
-		h ^= h >> 15;
-		return h;
+		// this should never happen since the number of valid entries is bounded by the number of edges, but if it does we can just drop the collapse
+		return;
 	}
 
-	bool equal(unsigned int lhs, unsigned int rhs) const
+	CollapseQueue::Entry e = {c.error, c.v0, c.v1, queue.versions[c.v0], queue.versions[c.v1], ~0u};
+	queue.entries[index] = e;
+
+	appendCollapseQueue(queue, index);
+}
+
+static bool popCollapseQueue(CollapseQueue& queue, CollapseQueue::Entry& result)
+{
+	while (queue.min_bin < kCollapseQueueBins && queue.bins[queue.min_bin] == ~0u)
 	{
-		return lhs == rhs;
+		// skip empty groups entirely
+		if (queue.groups[queue.min_bin / kCollapseQueueGroup] == 0)
+			queue.min_bin = (queue.min_bin / kCollapseQueueGroup + 1) * kCollapseQueueGroup;
+		else
+			queue.min_bin++;
 	}
-};
 
-struct TriangleHasher
+	if (queue.min_bin == kCollapseQueueBins)
+		return false;
+
+	unsigned int index = queue.bins[queue.min_bin];
+
+	result = queue.entries[index];
+	queue.bins[queue.min_bin] = result.next;
+	queue.groups[queue.min_bin / kCollapseQueueGroup]--;
+
+	queue.entries[index].next = queue.free_list;
+	queue.free_list = index;
+
+	return true;
+}
+
+static bool isTriangleCollapsed(const unsigned int* indices, size_t corner)
 {
-	const unsigned int* indices;
+	const unsigned int* tri = &indices[corner - corner % 3];
 
-	size_t hash(unsigned int i) const
-	{
-		const unsigned int* tri = indices + i * 3;
+	return tri[0] == tri[1] || tri[0] == tri[2] || tri[1] == tri[2];
+}
 
-		// Optimized Spatial Hashing for Collision Detection of Deformable Objects
-		return (tri[0] * 73856093) ^ (tri[1] * 19349663) ^ (tri[2] * 83492791);
-	}
+template <typename V>
+static void fillCollapseQueue(CollapseQueue& queue, Collapse<V>* collapses, size_t collapse_count, const unsigned int* indices, size_t index_count, size_t vertex_count, const V* remap)
+{
+	// corner lists are built in reverse order so that iteration order matches index order
+	memset(queue.corners, -1, vertex_count * sizeof(unsigned int));
 
-	bool equal(unsigned int lhs, unsigned int rhs) const
+	for (size_t i = index_count; i > 0; --i)
 	{
-		const unsigned int* lt = indices + lhs * 3;
-		const unsigned int* rt = indices + rhs * 3;
+		unsigned int r = remap[indices[i - 1]];
 
-		return lt[0] == rt[0] && lt[1] == rt[1] && lt[2] == rt[2];
+		queue.corner_next[i - 1] = queue.corners[r];
+		queue.corners[r] = unsigned(i - 1);
 	}
-};
 
-static void computeVertexIds(unsigned int* vertex_ids, const Vector3* vertex_positions, size_t vertex_count, int grid_size)
+	resetCollapseQueue(queue);
+
+	for (size_t i = 0; i < collapse_count; ++i)
+		pushCollapseQueue(queue, collapses[i]);
+}
+
+template <typename V>
+static bool hasTriangleFlips(CollapseQueue& queue, const unsigned int* indices, const Vector3* vertex_positions, const V* remap, unsigned int i0, unsigned int i1)
 {
-	assert(grid_size >= 1 && grid_size <= 1024);
-	float cell_scale = float(grid_size - 1);
+	static const int next[3] = {1, 2, 0};
+	static const int prev[3] = {2, 0, 1};
+
+	const Vector3& v0 = vertex_positions[i0];
+	const Vector3& v1 = vertex_positions[i1];
+
+	// this also removes corners of collapsed triangles from the list
+	for (unsigned int* link = &queue.corners[i0]; *link != ~0u;)
+	{
+		unsigned int c = *link;
+
+		if (isTriangleCollapsed(indices, c))
+		{
+			*link = queue.corner_next[c];
+			continue;
+		}
+
+		link = &queue.corner_next[c];
+
+		const unsigned int* tri = &indices[c - c % 3];
+
+		unsigned int a = remap[tri[next[c % 3]]];
+		unsigned int b = remap[tri[prev[c % 3]]];
+
+		// skip triangles that will get collapsed by i0->i1 collapse
+		if (a == i1 || b == i1 || a == b)
+			continue;
+
+		// early-out when at least one triangle flips due to a collapse
+		if (hasTriangleFlip(vertex_positions[a], vertex_positions[b], v0, v1))
+			return true;
+	}
+
+	return false;
+}
+
+template <typename V>
+static void remapEdgeLoop(V* loop, unsigned int v, const V* collapse_remap)
+{
+	unsigned int l = loop[v];
+
+	if (l != V(~0u) && collapse_remap[l] != l)
+	{
+		unsigned int r = collapse_remap[l];
+
+		// see remapEdgeLoops; v == r is a special case when the seam edge is collapsed in a direction opposite to where loop goes
+		if (v == r)
+			loop[v] = (loop[l] != V(~0u)) ? collapse_remap[loop[l]] : ~0u;
+		else
+			loop[v] = r;
+	}
+}
+
+template <typename V>
+static void updateCollapseQueue(CollapseQueue& queue, unsigned int r1, size_t corner_count, const unsigned int* indices, const Vector3* vertex_positions, const float* vertex_attributes, const Quadric* vertex_quadrics, const Quadric* attribute_quadrics, const QuadricGrad* attribute_gradients, size_t attribute_count, const V* remap, const V* wedge, const unsigned char* vertex_kind, const V* loop, const V* loopback)
+{
+	static const int next[3] = {1, 2, 0};
+	static const int prev[3] = {2, 0, 1};
+
+	const size_t kBatchSize = 64;
+	Collapse<V> batch[kBatchSize];
+	size_t batch_size = 0;
+
+	// add edges from the first corner_count corners of the collapse target; these are the corners that were moved from the collapse source
+	unsigned int c = queue.corners[r1];
+
+	for (size_t i = 0; i < corner_count; ++i)
+	{
+		assert(c != ~0u && !isTriangleCollapsed(indices, c));
+		const unsigned int* tri = &indices[c - c % 3];
+
+		batch_size += pickEdgeCollapse(batch[batch_size], tri[c % 3], tri[next[c % 3]], remap, vertex_kind, loop, loopback);
+		batch_size += pickEdgeCollapse(batch[batch_size], tri[prev[c % 3]], tri[c % 3], remap, vertex_kind, loop, loopback);
+
+		if (batch_size + 2 > kBatchSize || i + 1 == corner_count)
+		{
+			rankEdgeCollapses(batch, batch_size, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+
+			for (size_t j = 0; j < batch_size; ++j)
+				pushCollapseQueue(queue, batch[j]);
+
+			batch_size = 0;
+		}
+
+		c = queue.corner_next[c];
+	}
+}
+
+template <typename V>
+static size_t performQueueCollapses(CollapseQueue& queue, unsigned int* indices, size_t index_count, V* collapse_remap, Quadric* vertex_quadrics, Quadric* attribute_quadrics, QuadricGrad* attribute_gradients, const float* vertex_attributes, size_t attribute_count, const V* remap, const V* wedge, const unsigned char* vertex_kind, V* loop, V* loopback, const Vector3* vertex_positions, size_t target_index_count, float error_limit, float vertex_error_limit, float& result_error, float& vertex_error, meshopt_SimplifyStats& simplify_stats)
+{
+	size_t triangle_count = 0;
+	for (size_t i = 0; i < index_count; i += 3)
+		triangle_count += !isTriangleCollapsed(indices, i);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	size_t stats[5] = {};
+#endif
+
+	CollapseQueue::Entry c;
+
+	while (triangle_count * 3 > target_index_count && vertex_error < vertex_error_limit && popCollapseQueue(queue, c))
+	{
+		INSTRUMENTSTATS(0);
+
+		// collapses that involve moved vertices are replaced by collapses of edges that moved to the collapse target
+		if (queue.versions[c.v0] == ~0u || queue.versions[c.v1] == ~0u)
+		{
+			simplify_stats.rejected_moved++;
+			INSTRUMENTSTATS(1);
+			continue;
+		}
+
+		// collapses that involve a collapse target need to be re-evaluated as its quadric changed
+		// the error can only increase, so we can defer re-evaluation until the collapse is at the front of the queue
+		if (!isQueueEntryValid(queue, c))
+		{
+			unsigned char k0 = vertex_kind[c.v0];
+			unsigned char k1 = vertex_kind[c.v1];
+
+			Collapse<V> r = {V(c.v0), V(c.v1), {unsigned(kCanCollapse[k0][k1] & kCanCollapse[k1][k0])}};
+			rankEdgeCollapses(&r, 1, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+
+			if (getQueueBin(r.error) > queue.min_bin)
+			{
+				pushCollapseQueue(queue, r);
+
+				INSTRUMENTSTATS(2);
+				continue;
+			}
+
+			c.v0 = r.v0;
+			c.v1 = r.v1;
+			c.error = r.error;
+		}
+
+		if (c.error > error_limit)
+			break;
+
+		unsigned int i0 = c.v0;
+		unsigned int i1 = c.v1;
+
+		unsigned int r0 = remap[i0];
+		unsigned int r1 = remap[i1];
+
+		unsigned char kind = vertex_kind[i0];
+
+		assert(collapse_remap[r0] == r0 && collapse_remap[r1] == r1);
+
+		// the collapse stays invalid until the neighborhood of either vertex changes
+		if (hasTriangleFlips(queue, indices, vertex_positions, remap, r0, r1))
+		{
+			simplify_stats.rejected_flip++;
+			INSTRUMENTSTATS(3);
+			continue;
+		}
+
+#if TRACE >= 2
+		printf("edge commit %d -> %d: kind %d->%d, error %f\n", i0, i1, vertex_kind[i0], vertex_kind[i1], sqrtf(c.error));
+#endif
+
+		// see performEdgeCollapses for the remapping rules
+		if (kind == Kind_Complex)
+		{
+			unsigned int v = i0;
+
+			do
+			{
+				collapse_remap[v] = i1;
+				v = wedge[v];
+			} while (v != i0);
+		}
+		else if (kind == Kind_Seam)
+		{
+			unsigned int s0 = wedge[i0];
+			unsigned int s1 = loop[i0] == i1 ? loopback[s0] : loop[s0];
+			assert(s0 != i0 && wedge[s0] == i0);
+			assert(s1 != V(~0u) && remap[s1] == r1);
+
+			// note: this should never happen due to the assertion above, but when disabled if we ever hit this case we'll get a memory safety issue; for now play it safe
+			s1 = (s1 != V(~0u)) ? s1 : wedge[i1];
+
+			collapse_remap[i0] = i1;
+			collapse_remap[s0] = s1;
+		}
+		else
+		{
+			assert(wedge[i0] == i0);
+
+			collapse_remap[i0] = i1;
+		}
+
+		// merge quadrics of all moved wedges; see updateQuadrics
+		unsigned int v = r0;
+
+		do
+		{
+			if (collapse_remap[v] != v)
+			{
+				unsigned int t = collapse_remap[v];
+
+				if (v == r0)
+					quadricAdd(vertex_quadrics[r1], vertex_quadrics[r0]);
+
+				if (attribute_count)
+				{
+					quadricAdd(attribute_quadrics[t], attribute_quadrics[v]);
+					quadricAdd(&attribute_gradients[t * (attribute_count / kAttributeBlock)], &attribute_gradients[v * (attribute_count / kAttributeBlock)], attribute_count);
+				}
+			}
+
+			v = wedge[v];
+		} while (v != r0);
+
+		// when attributes are used, distance error needs to be recomputed as collapses don't track it
+		if (attribute_count)
+		{
+			float derr = quadricError(vertex_quadrics[r0], vertex_positions[r1]);
+			vertex_error = vertex_error < derr ? derr : vertex_error;
+		}
+
+		// move triangles from r0 to r1, fixing up edge loops that pointed to moved vertices
+		unsigned int corner = queue.corners[r0];
+		queue.corners[r0] = ~0u;
+
+		size_t corner_count = 0;
+
+		while (corner != ~0u)
+		{
+			unsigned int next_corner = queue.corner_next[corner];
+
+			if (!isTriangleCollapsed(indices, corner))
+			{
+				unsigned int* tri = &indices[corner - corner % 3];
+
+				tri[0] = collapse_remap[tri[0]];
+				tri[1] = collapse_remap[tri[1]];
+				tri[2] = collapse_remap[tri[2]];
+
+				// any edge loop that points to a moved vertex belongs to a triangle that contains it
+				for (int k = 0; k < 3; ++k)
+				{
+					remapEdgeLoop(loop, tri[k], collapse_remap);
+					remapEdgeLoop(loopback, tri[k], collapse_remap);
+				}
+
+				if (isTriangleCollapsed(indices, corner))
+				{
+					triangle_count--;
+				}
+				else
+				{
+					queue.corner_next[corner] = queue.corners[r1];
+					queue.corners[r1] = corner;
+					corner_count++;
+				}
+			}
+
+			corner = next_corner;
+		}
+
+		// all wedges of the collapse target need to be re-evaluated as quadrics are shared between wedges
+		v = r1;
+
+		do
+		{
+			queue.versions[v]++;
+			v = wedge[v];
+		} while (v != r1);
+
+		v = r0;
+
+		do
+		{
+			queue.versions[v] = ~0u;
+			v = wedge[v];
+		} while (v != r0);
+
+		updateCollapseQueue(queue, r1, corner_count, indices, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+
+		simplify_stats.collapses++;
+		INSTRUMENTSTATS(4);
+
+		result_error = result_error < c.error ? c.error : result_error;
+		vertex_error = attribute_count == 0 ? result_error : vertex_error;
+	}
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	meshopt_Instrument::counter("collapses_evaluated", double(stats[0]));
+	meshopt_Instrument::counter("collapses_done", double(stats[4]));
+	meshopt_Instrument::counter("collapses_outdated", double(stats[1]));
+	meshopt_Instrument::counter("collapses_deferred", double(stats[2]));
+	meshopt_Instrument::counter("collapses_invalid", double(stats[3]));
+#endif
+
+	// compact the index buffer; collapsed triangles are degenerate after remapping
+	size_t write = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+		if (!isTriangleCollapsed(indices, i))
+		{
+			indices[write + 0] = indices[i + 0];
+			indices[write + 1] = indices[i + 1];
+			indices[write + 2] = indices[i + 2];
+			write += 3;
+		}
+
+	assert(write == triangle_count * 3);
+	return write;
+}
+
+static unsigned int follow(unsigned int* parents, unsigned int index)
+{
+	while (index != parents[index])
+	{
+		unsigned int parent = parents[index];
+		parents[index] = parents[parent];
+		index = parent;
+	}
+
+	return index;
+}
+
+template <typename V>
+static size_t buildComponents(unsigned int* components, size_t vertex_count, const unsigned int* indices, size_t index_count, const V* remap)
+{
+	for (size_t i = 0; i < vertex_count; ++i)
+		components[i] = unsigned(i);
+
+	// compute a unique (but not sequential!) index for each component via union-find
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		static const int next[4] = {1, 2, 0, 1};
+
+		for (int e = 0; e < 3; ++e)
+		{
+			unsigned int i0 = indices[i + e];
+			unsigned int i1 = indices[i + next[e]];
+
+			unsigned int r0 = remap[i0];
+			unsigned int r1 = remap[i1];
+
+			r0 = follow(components, r0);
+			r1 = follow(components, r1);
+
+			// merge components with larger indices into components with smaller indices
+			// this guarantees that the root of the component is always the one with the smallest index
+			if (r0 != r1)
+				components[r0 < r1 ? r1 : r0] = r0 < r1 ? r0 : r1;
+		}
+	}
+
+	// make sure each element points to the component root *before* we renumber the components
+	for (size_t i = 0; i < vertex_count; ++i)
+		if (remap[i] == i)
+			components[i] = follow(components, unsigned(i));
+
+	unsigned int next_component = 0;
+
+	// renumber components using sequential indices
+	// a sequential pass is sufficient because component root always has the smallest index
+	// note: it is unsafe to use follow() in this pass because we're replacing component links with sequential indices inplace
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		if (remap[i] == i)
+		{
+			unsigned int root = components[i];
+			assert(root <= i); // make sure we already computed the component for non-roots
+			components[i] = (root == i) ? next_component++ : components[root];
+		}
+		else
+		{
+			assert(remap[i] < i); // make sure we already computed the component
+			components[i] = components[remap[i]];
+		}
+	}
+
+	return next_component;
+}
+
+static void measureComponents(float* component_errors, size_t component_count, const unsigned int* components, const Vector3* vertex_positions, size_t vertex_count)
+{
+	memset(component_errors, 0, component_count * 4 * sizeof(float));
+
+	// compute approximate sphere center for each component as an average
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int c = components[i];
+		assert(components[i] < component_count);
+
+		Vector3 v = vertex_positions[i]; // copy avoids aliasing issues
+
+		component_errors[c * 4 + 0] += v.x;
+		component_errors[c * 4 + 1] += v.y;
+		component_errors[c * 4 + 2] += v.z;
+		component_errors[c * 4 + 3] += 1; // weight
+	}
+
+	// complete the center computation, and reinitialize [3] as a radius
+	for (size_t i = 0; i < component_count; ++i)
+	{
+		float w = component_errors[i * 4 + 3];
+		float iw = w == 0.f ? 0.f : 1.f / w;
+
+		component_errors[i * 4 + 0] *= iw;
+		component_errors[i * 4 + 1] *= iw;
+		component_errors[i * 4 + 2] *= iw;
+		component_errors[i * 4 + 3] = 0; // radius
+	}
+
+	// compute squared radius for each component
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		unsigned int c = components[i];
+
+		float dx = vertex_positions[i].x - component_errors[c * 4 + 0];
+		float dy = vertex_positions[i].y - component_errors[c * 4 + 1];
+		float dz = vertex_positions[i].z - component_errors[c * 4 + 2];
+		float r = dx * dx + dy * dy + dz * dz;
+
+		component_errors[c * 4 + 3] = component_errors[c * 4 + 3] < r ? r : component_errors[c * 4 + 3];
+	}
+
+	// we've used the output buffer as scratch space, so we need to move the results to proper indices
+	for (size_t i = 0; i < component_count; ++i)
+	{
+#if TRACE >= 2
+		printf("component %d: center %f %f %f, error %e\n", int(i),
+		    component_errors[i * 4 + 0], component_errors[i * 4 + 1], component_errors[i * 4 + 2], sqrtf(component_errors[i * 4 + 3]));
+#endif
+		// note: we keep the squared error to make it match quadric error metric
+		component_errors[i] = component_errors[i * 4 + 3];
+	}
+}
+
+static size_t pruneComponents(unsigned int* indices, size_t index_count, const unsigned int* components, const float* component_errors, size_t component_count, float error_cutoff, float& nexterror, meshopt_SimplifyStats& simplify_stats)
+{
+	size_t write = 0;
+
+	for (size_t i = 0; i < index_count; i += 3)
+	{
+		unsigned int c = components[indices[i]];
+		assert(c == components[indices[i + 1]] && c == components[indices[i + 2]]);
+
+		if (component_errors[c] > error_cutoff)
+		{
+			indices[write + 0] = indices[i + 0];
+			indices[write + 1] = indices[i + 1];
+			indices[write + 2] = indices[i + 2];
+			write += 3;
+		}
+	}
+
+	size_t pruned_components = 0;
+	for (size_t i = 0; i < component_count; ++i)
+		pruned_components += (component_errors[i] >= nexterror && component_errors[i] <= error_cutoff);
+
+	simplify_stats.pruned_components += pruned_components;
+	simplify_stats.pruned_triangles += (index_count - write) / 3;
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	meshopt_Instrument::counter("pruned_triangles", double((index_count - write) / 3));
+	meshopt_Instrument::counter("pruned_components", double(pruned_components));
+#endif
+
+	// update next error with the smallest error of the remaining components for future pruning
+	nexterror = FLT_MAX;
+	for (size_t i = 0; i < component_count; ++i)
+		if (component_errors[i] > error_cutoff)
+			nexterror = nexterror > component_errors[i] ? component_errors[i] : nexterror;
+
+	return write;
+}
+
+struct CellHasher
+{
+	const unsigned int* vertex_ids;
+
+	size_t hash(unsigned int i) const
+	{
+		unsigned int h = vertex_ids[i];
+
+		// MurmurHash2 finalizer
+		h ^= h >> 13;
+		h *= 0x5bd1e995;
+		h ^= h >> 15;
+		return h;
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return vertex_ids[lhs] == vertex_ids[rhs];
+	}
+};
+
+struct IdHasher
+{
+	size_t hash(unsigned int id) const
+	{
+		unsigned int h = id;
+
+		// MurmurHash2 finalizer
+		h ^= h >> 13;
+		h *= 0x5bd1e995;
+		h ^= h >> 15;
+		return h;
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return lhs == rhs;
+	}
+};
+
+struct TriangleHasher
+{
+	const unsigned int* indices;
+
+	size_t hash(unsigned int i) const
+	{
+		const unsigned int* tri = indices + i * 3;
+
+		// Optimized Spatial Hashing for Collision Detection of Deformable Objects
+		return (tri[0] * 73856093) ^ (tri[1] * 19349663) ^ (tri[2] * 83492791);
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		const unsigned int* lt = indices + lhs * 3;
+		const unsigned int* rt = indices + rhs * 3;
+
+		return lt[0] == rt[0] && lt[1] == rt[1] && lt[2] == rt[2];
+	}
+};
+
+static void computeVertexIds(unsigned int* vertex_ids, const Vector3* vertex_positions, size_t vertex_count, int grid_size)
+{
+	assert(grid_size >= 1 && grid_size <= 1024);
+	float cell_scale = float(grid_size - 1);
 
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
@@ -1587,20 +2631,50 @@ static void computeVertexIds(unsigned int* vertex_ids, const Vector3* vertex_pos
 	}
 }
 
-static size_t countTriangles(const unsigned int* vertex_ids, const unsigned int* indices, size_t index_count)
+// number of grid sizes evaluated by a single pair of passes over vertices and triangles during sloppy grid search
+const size_t kSloppyProbes = 4;
+
+static void computeVertexIdsProbes(unsigned int* vertex_ids, const Vector3* vertex_positions, size_t vertex_count, const int* grid_sizes)
 {
-	size_t result = 0;
+	float cell_scales[kSloppyProbes];
+
+	for (size_t k = 0; k < kSloppyProbes; ++k)
+	{
+		assert(grid_sizes[k] >= 1 && grid_sizes[k] <= 1024);
+		cell_scales[k] = float(grid_sizes[k] - 1);
+	}
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const Vector3& v = vertex_positions[i];
+
+		for (size_t k = 0; k < kSloppyProbes; ++k)
+		{
+			int xi = int(v.x * cell_scales[k] + 0.5f);
+			int yi = int(v.y * cell_scales[k] + 0.5f);
+			int zi = int(v.z * cell_scales[k] + 0.5f);
+
+			vertex_ids[i * kSloppyProbes + k] = (xi << 20) | (yi << 10) | zi;
+		}
+	}
+}
+
+static void countTrianglesProbes(size_t* results, const unsigned int* vertex_ids, const unsigned int* indices, size_t index_count)
+{
+	size_t counts[kSloppyProbes] = {};
 
 	for (size_t i = 0; i < index_count; i += 3)
 	{
-		unsigned int id0 = vertex_ids[indices[i + 0]];
-		unsigned int id1 = vertex_ids[indices[i + 1]];
-		unsigned int id2 = vertex_ids[indices[i + 2]];
+		const unsigned int* id0 = &vertex_ids[indices[i + 0] * kSloppyProbes];
+		const unsigned int* id1 = &vertex_ids[indices[i + 1] * kSloppyProbes];
+		const unsigned int* id2 = &vertex_ids[indices[i + 2] * kSloppyProbes];
 
-		result += (id0 != id1) & (id0 != id2) & (id1 != id2);
+		for (size_t k = 0; k < kSloppyProbes; ++k)
+			counts[k] += (id0[k] != id1[k]) & (id0[k] != id2[k]) & (id1[k] != id2[k]);
 	}
 
-	return result;
+	for (size_t k = 0; k < kSloppyProbes; ++k)
+		results[k] = counts[k];
 }
 
 static size_t fillVertexCells(unsigned int* table, size_t table_size, unsigned int* vertex_cells, const unsigned int* vertex_ids, size_t vertex_count)
@@ -1679,7 +2753,7 @@ static void fillCellQuadrics(Quadric* cell_quadrics, const unsigned int* indices
 	}
 }
 
-static void fillCellReservoirs(Reservoir* cell_reservoirs, size_t cell_count, const Vector3* vertex_positions, const float* vertex_colors, size_t vertex_colors_stride, size_t vertex_count, const unsigned int* vertex_cells)
+static void fillCellReservoirs(Reservoir* cell_reservoirs, size_t cell_count, const Vector3* vertex_positions, const float* vertex_colors, size_t vertex_colors_stride, size_t vertex_count, const unsigned int* vertex_cells, const float* vertex_weights = NULL)
 {
 	static const float dummy_color[] = {0.f, 0.f, 0.f};
 
@@ -1692,14 +2766,15 @@ static void fillCellReservoirs(Reservoir* cell_reservoirs, size_t cell_count, co
 		Reservoir& r = cell_reservoirs[cell];
 
 		const float* color = vertex_colors ? &vertex_colors[i * vertex_colors_stride_float] : dummy_color;
-
-		r.x += v.x;
-		r.y += v.y;
-		r.z += v.z;
-		r.r += color[0];
-		r.g += color[1];
-		r.b += color[2];
-		r.w += 1.f;
+		float w = vertex_weights ? vertex_weights[i] : 1.f;
+
+		r.x += v.x * w;
+		r.y += v.y * w;
+		r.z += v.z * w;
+		r.r += color[0] * w;
+		r.g += color[1] * w;
+		r.b += color[2] * w;
+		r.w += w;
 	}
 
 	for (size_t i = 0; i < cell_count; ++i)
@@ -1793,26 +2868,226 @@ static size_t filterTriangles(unsigned int* destination, unsigned int* tritable,
 				c = b, b = a, a = t;
 			}
 
-			destination[result * 3 + 0] = a;
-			destination[result * 3 + 1] = b;
-			destination[result * 3 + 2] = c;
+			destination[result * 3 + 0] = a;
+			destination[result * 3 + 1] = b;
+			destination[result * 3 + 2] = c;
+
+			unsigned int* entry = hashLookup2(tritable, tritable_size, hasher, unsigned(result), ~0u);
+
+			if (*entry == ~0u)
+				*entry = unsigned(result++);
+		}
+	}
+
+	return result * 3;
+}
+
+static float interpolate(float y, float x0, float y0, float x1, float y1, float x2, float y2)
+{
+	// three point interpolation from "revenge of interpolation search" paper
+	float num = (y1 - y) * (x1 - x2) * (x1 - x0) * (y2 - y0);
+	float den = (y2 - y) * (x1 - x2) * (y0 - y1) + (y0 - y) * (x1 - x0) * (y1 - y2);
+	return x1 + num / den;
+}
+
+static int findPointsGrid(size_t& out_cell_count, unsigned int* vertex_ids, unsigned int* table, size_t table_size, const Vector3* vertex_positions, size_t vertex_count, size_t target_vertex_count)
+{
+	const int kInterpolationPasses = 5;
+
+	// invariant: # of vertices in min_grid <= target_count
+	int min_grid = 0;
+	int max_grid = 1025;
+	size_t min_vertices = 0;
+	size_t max_vertices = vertex_count;
+
+	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
+	int next_grid_size = int(sqrtf(float(target_vertex_count)) + 0.5f);
+
+	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
+	{
+		assert(min_vertices < target_vertex_count);
+		assert(max_grid - min_grid > 1);
+
+		// we clamp the prediction of the grid size to make sure that the search converges
+		int grid_size = next_grid_size;
+		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid ? max_grid - 1 : grid_size);
+
+		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
+		size_t vertices = countVertexCells(table, table_size, vertex_ids, vertex_count);
+
+		meshopt_Instrument::counter("grid_size", double(grid_size), pass);
+		meshopt_Instrument::counter("grid_vertices", double(vertices), pass);
+
+		float tip = interpolate(float(target_vertex_count), float(min_grid), float(min_vertices), float(grid_size), float(vertices), float(max_grid), float(max_vertices));
+
+		if (vertices <= target_vertex_count)
+		{
+			min_grid = grid_size;
+			min_vertices = vertices;
+		}
+		else
+		{
+			max_grid = grid_size;
+			max_vertices = vertices;
+		}
+
+		if (vertices == target_vertex_count || max_grid - min_grid <= 1)
+			break;
+
+		// we start by using interpolation search - it usually converges faster
+		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
+		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
+	}
+
+	out_cell_count = min_vertices;
+	return min_grid;
+}
+
+struct PointCell
+{
+	// weighted sums of all points in the cell
+	double x, y, z;
+	double r, g, b;
+	double w;
+
+	// candidate point that is closest to the cell average
+	unsigned int index;
+	float px, py, pz;
+	float pr, pg, pb;
+};
+
+struct PointStream
+{
+	float origin[3];
+	float scale;
+
+	float color_weight;
+	size_t target_count;
+
+	// cells are keyed by quantized position on a 1024^3 grid shifted right by level
+	int level;
+
+	unsigned int* keys;
+	PointCell* cells;
+	size_t cell_count;
+	size_t cell_budget;
+
+	unsigned int* table;
+	size_t table_size;
+};
+
+const int kPointStreamGridBits = 10;
+
+static float getPointCellError(const PointCell& cell, float x, float y, float z, float r, float g, float b, float color_weight)
+{
+	double iw = cell.w == 0 ? 0.0 : 1.0 / cell.w;
+
+	float dx = x - float(cell.x * iw), dy = y - float(cell.y * iw), dz = z - float(cell.z * iw);
+	float dr = r - float(cell.r * iw), dg = g - float(cell.g * iw), db = b - float(cell.b * iw);
+
+	return dx * dx + dy * dy + dz * dz + color_weight * (dr * dr + dg * dg + db * db);
+}
+
+static float getPointStreamColorWeight(const PointStream& stream)
+{
+	// we scale the color weight to bring it to the same scale as position, matching meshopt_simplifyPoints
+	int grid_size = 1 << (kPointStreamGridBits - stream.level);
+	float color_weight_scaled = stream.color_weight * (grid_size == 1 ? 1.f : 1.f / (grid_size - 1));
+
+	return color_weight_scaled * color_weight_scaled;
+}
+
+static void mergePointCell(PointCell& target, const PointCell& source, float color_weight)
+{
+	target.x += source.x;
+	target.y += source.y;
+	target.z += source.z;
+	target.r += source.r;
+	target.g += source.g;
+	target.b += source.b;
+	target.w += source.w;
+
+	// keep the candidate that is closest to the updated average; this approximates fillCellRemap without a second pass over all points
+	float terror = getPointCellError(target, target.px, target.py, target.pz, target.pr, target.pg, target.pb, color_weight);
+	float serror = getPointCellError(target, source.px, source.py, source.pz, source.pr, source.pg, source.pb, color_weight);
+
+	if (serror < terror)
+	{
+		target.index = source.index;
+		target.px = source.px;
+		target.py = source.py;
+		target.pz = source.pz;
+		target.pr = source.pr;
+		target.pg = source.pg;
+		target.pb = source.pb;
+	}
+}
+
+static unsigned int coarsenPointKey(unsigned int key, int shift)
+{
+	unsigned int x = (key >> 20) & 1023, y = (key >> 10) & 1023, z = key & 1023;
+
+	return ((x >> shift) << 20) | ((y >> shift) << 10) | (z >> shift);
+}
+
+static void insertPointCell(PointStream& stream, unsigned int key, const PointCell& cell, float color_weight)
+{
+	assert(stream.cell_count < stream.cell_budget);
+
+	// the new key is placed past the end of the cell list temporarily so that the hasher can reference it
+	stream.keys[stream.cell_count] = key;
+
+	CellHasher hasher = {stream.keys};
+	unsigned int* entry = hashLookup2(stream.table, stream.table_size, hasher, unsigned(stream.cell_count), ~0u);
+
+	if (*entry == ~0u)
+	{
+		*entry = unsigned(stream.cell_count);
+		stream.cells[stream.cell_count++] = cell;
+	}
+	else
+	{
+		mergePointCell(stream.cells[*entry], cell, color_weight);
+	}
+}
+
+static void coarsenPointStream(PointStream& stream, int level)
+{
+	assert(level > stream.level && level <= kPointStreamGridBits);
 
-			unsigned int* entry = hashLookup2(tritable, tritable_size, hasher, unsigned(result), ~0u);
+	int shift = level - stream.level;
+	size_t cell_count = stream.cell_count;
 
-			if (*entry == ~0u)
-				*entry = unsigned(result++);
-		}
-	}
+	stream.level = level;
+	stream.cell_count = 0;
+	memset(stream.table, -1, stream.table_size * sizeof(unsigned int));
 
-	return result * 3;
+	float color_weight = getPointStreamColorWeight(stream);
+
+	// cells are merged in place: the output position never exceeds the input position, and each input cell is copied before it can be overwritten
+	for (size_t i = 0; i < cell_count; ++i)
+	{
+		unsigned int key = coarsenPointKey(stream.keys[i], shift);
+		PointCell cell = stream.cells[i];
+
+		insertPointCell(stream, key, cell, color_weight);
+	}
 }
 
-static float interpolate(float y, float x0, float y0, float x1, float y1, float x2, float y2)
+static void addPointCell(PointStream& stream, unsigned int key, int level, const PointCell& cell)
 {
-	// three point interpolation from "revenge of interpolation search" paper
-	float num = (y1 - y) * (x1 - x2) * (x1 - x0) * (y2 - y0);
-	float den = (y2 - y) * (x1 - x2) * (y0 - y1) + (y0 - y) * (x1 - x0) * (y1 - y2);
-	return x1 + num / den;
+	// coarsen the grid when running out of cells; each step halves the resolution, and we keep at least half of the budget free to amortize the cost
+	if (stream.cell_count + 1 >= stream.cell_budget)
+	{
+		do
+			coarsenPointStream(stream, stream.level + 1);
+		while (stream.cell_count > stream.cell_budget / 2 && stream.level < kPointStreamGridBits);
+	}
+
+	if (level > stream.level)
+		coarsenPointStream(stream, level);
+
+	insertPointCell(stream, coarsenPointKey(key, stream.level - level), cell, getPointStreamColorWeight(stream));
 }
 
 } // namespace meshopt
@@ -1823,65 +3098,50 @@ enum
 	meshopt_SimplifyInternalDebug = 1 << 30
 };
 
-size_t meshopt_simplifyEdge(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+template <typename V>
+static size_t simplifyEdge(unsigned int* destination, unsigned int* result, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options, size_t* out_lod_index_counts, float* out_lod_errors, meshopt_ParallelFor parallel_for, void* context, const unsigned int* sparse_remap, meshopt_Allocator& allocator, meshopt_SimplifyStats& simplify_stats)
 {
 	using namespace meshopt;
 
-	assert(index_count % 3 == 0);
-	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
-	assert(vertex_positions_stride % sizeof(float) == 0);
-	assert(target_index_count <= index_count);
-	assert(target_error >= 0);
-	assert((options & ~(meshopt_SimplifyLockBorder | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute | meshopt_SimplifyPrune | meshopt_SimplifyInternalDebug)) == 0);
-	assert(vertex_attributes_stride >= attribute_count * sizeof(float) && vertex_attributes_stride <= 256);
-	assert(vertex_attributes_stride % sizeof(float) == 0);
-	assert(attribute_count <= kMaxAttributes);
-	for (size_t i = 0; i < attribute_count; ++i)
-		assert(attribute_weights[i] >= 0);
-
-	meshopt_Allocator allocator;
-
-	unsigned int* result = destination;
-	if (result != indices)
-		memcpy(result, indices, index_count * sizeof(unsigned int));
-
-	// build an index remap and update indices/vertex_count to minimize the subsequent work
-	// note: as a consequence, errors will be computed relative to the subset extent
-	unsigned int* sparse_remap = NULL;
-	if (options & meshopt_SimplifySparse)
-		sparse_remap = buildSparseRemap(result, index_count, vertex_count, &vertex_count, allocator);
+	double time_last = getSimplifyTime(simplify_stats);
 
 	// build adjacency information
-	EdgeAdjacency adjacency = {};
+	EdgeAdjacency<V> adjacency = {};
 	prepareEdgeAdjacency(adjacency, index_count, vertex_count, allocator);
-	updateEdgeAdjacency(adjacency, result, index_count, vertex_count, NULL);
+	updateEdgeAdjacency(adjacency, result, index_count, vertex_count, static_cast<const V*>(NULL));
 
 	// build position remap that maps each vertex to the one with identical position
-	unsigned int* remap = allocator.allocate<unsigned int>(vertex_count);
-	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
+	V* remap = allocator.allocate<V>(vertex_count);
+	V* wedge = allocator.allocate<V>(vertex_count);
 	buildPositionRemap(remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, sparse_remap, allocator);
 
 	// classify vertices; vertex kind determines collapse rules, see kCanCollapse
 	unsigned char* vertex_kind = allocator.allocate<unsigned char>(vertex_count);
-	unsigned int* loop = allocator.allocate<unsigned int>(vertex_count);
-	unsigned int* loopback = allocator.allocate<unsigned int>(vertex_count);
+	V* loop = allocator.allocate<V>(vertex_count);
+	V* loopback = allocator.allocate<V>(vertex_count);
 	classifyVertices(vertex_kind, loop, loopback, vertex_count, adjacency, remap, wedge, vertex_lock, sparse_remap, options);
 
-#if TRACE
-	size_t unique_positions = 0;
-	for (size_t i = 0; i < vertex_count; ++i)
-		unique_positions += remap[i] == i;
+#if MESHOPTIMIZER_INSTRUMENTATION
+	if (meshopt_Instrument::enabled())
+	{
+		size_t unique_positions = 0;
+		for (size_t i = 0; i < vertex_count; ++i)
+			unique_positions += remap[i] == i;
 
-	printf("position remap: %d vertices => %d positions\n", int(vertex_count), int(unique_positions));
+		meshopt_Instrument::counter("unique_positions", double(unique_positions));
 
-	size_t kinds[Kind_Count] = {};
-	for (size_t i = 0; i < vertex_count; ++i)
-		kinds[vertex_kind[i]] += remap[i] == i;
+		// vertex_kinds is indexed by vertex kind: manifold, border, seam, complex, locked
+		size_t kinds[Kind_Count] = {};
+		for (size_t i = 0; i < vertex_count; ++i)
+			kinds[vertex_kind[i]] += remap[i] == i;
 
-	printf("kinds: manifold %d, border %d, seam %d, complex %d, locked %d\n",
-	    int(kinds[Kind_Manifold]), int(kinds[Kind_Border]), int(kinds[Kind_Seam]), int(kinds[Kind_Complex]), int(kinds[Kind_Locked]));
+		for (int k = 0; k < Kind_Count; ++k)
+			meshopt_Instrument::counter("vertex_kinds", double(kinds[k]), k);
+	}
 #endif
 
+	addSimplifyTime(simplify_stats, simplify_stats.time_adjacency, time_last);
+
 	Vector3* vertex_positions = allocator.allocate<Vector3>(vertex_count);
 	float vertex_scale = rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride, sparse_remap);
 
@@ -1897,9 +3157,10 @@ size_t meshopt_simplifyEdge(unsigned int* destination, const unsigned int* indic
 			if (attribute_weights[i] > 0)
 				attribute_remap[attributes_used++] = unsigned(i);
 
-		attribute_count = attributes_used;
+		// attribute data is padded to a multiple of the block size; padded attributes are zero and contribute nothing to quadrics
+		attribute_count = (attributes_used + kAttributeBlock - 1) / kAttributeBlock * kAttributeBlock;
 		vertex_attributes = allocator.allocate<float>(vertex_count * attribute_count);
-		rescaleAttributes(vertex_attributes, vertex_attributes_data, vertex_count, vertex_attributes_stride, attribute_weights, attribute_count, attribute_remap, sparse_remap);
+		rescaleAttributes(vertex_attributes, vertex_attributes_data, vertex_count, vertex_attributes_stride, attribute_weights, attributes_used, attribute_count, attribute_remap, sparse_remap);
 	}
 
 	Quadric* vertex_quadrics = allocator.allocate<Quadric>(vertex_count);
@@ -1913,15 +3174,26 @@ size_t meshopt_simplifyEdge(unsigned int* destination, const unsigned int* indic
 		attribute_quadrics = allocator.allocate<Quadric>(vertex_count);
 		memset(attribute_quadrics, 0, vertex_count * sizeof(Quadric));
 
-		attribute_gradients = allocator.allocate<QuadricGrad>(vertex_count * attribute_count);
-		memset(attribute_gradients, 0, vertex_count * attribute_count * sizeof(QuadricGrad));
+		attribute_gradients = allocator.allocate<QuadricGrad>(vertex_count * (attribute_count / kAttributeBlock));
+		memset(attribute_gradients, 0, vertex_count * (attribute_count / kAttributeBlock) * sizeof(QuadricGrad));
 	}
 
-	fillFaceQuadrics(vertex_quadrics, result, index_count, vertex_positions, remap);
-	fillEdgeQuadrics(vertex_quadrics, result, index_count, vertex_positions, remap, vertex_kind, loop, loopback);
+	SimplifyScheduler scheduler = {parallel_for, context};
 
-	if (attribute_count)
-		fillAttributeQuadrics(attribute_quadrics, attribute_gradients, result, index_count, vertex_positions, vertex_attributes, attribute_count);
+	if (parallel_for)
+	{
+		fillQuadricsParallel(scheduler, vertex_quadrics, attribute_quadrics, attribute_gradients, result, index_count, vertex_positions, vertex_attributes, attribute_count, vertex_count, remap, vertex_kind, loop, loopback, allocator);
+	}
+	else
+	{
+		fillFaceQuadrics(vertex_quadrics, result, index_count, vertex_positions, remap);
+		fillEdgeQuadrics(vertex_quadrics, result, index_count, vertex_positions, remap, vertex_kind, loop, loopback);
+
+		if (attribute_count)
+			fillAttributeQuadrics(attribute_quadrics, attribute_gradients, result, index_count, vertex_positions, vertex_attributes, attribute_count);
+	}
+
+	addSimplifyTime(simplify_stats, simplify_stats.time_quadrics, time_last);
 
 	unsigned int* components = NULL;
 	float* component_errors = NULL;
@@ -1940,149 +3212,576 @@ size_t meshopt_simplifyEdge(unsigned int* destination, const unsigned int* indic
 		for (size_t i = 0; i < component_count; ++i)
 			component_nexterror = component_nexterror > component_errors[i] ? component_errors[i] : component_nexterror;
 
-#if TRACE
-		printf("components: %d (min error %e)\n", int(component_count), sqrtf(component_nexterror));
-#endif
+		meshopt_Instrument::counter("components", double(component_count));
+
+		addSimplifyTime(simplify_stats, simplify_stats.time_adjacency, time_last);
 	}
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 	size_t pass_count = 0;
 #endif
 
 	size_t collapse_capacity = boundEdgeCollapses(adjacency, vertex_count, index_count, vertex_kind);
 
-	Collapse* edge_collapses = allocator.allocate<Collapse>(collapse_capacity);
-	unsigned int* collapse_order = allocator.allocate<unsigned int>(collapse_capacity);
-	unsigned int* collapse_remap = allocator.allocate<unsigned int>(vertex_count);
-	unsigned char* collapse_locked = allocator.allocate<unsigned char>(vertex_count);
+	Collapse<V>* edge_collapses = allocator.allocate<Collapse<V> >(collapse_capacity);
+	V* collapse_remap = allocator.allocate<V>(vertex_count);
+
+	// collapse ordering and locking is only needed for batched collapses; the priority queue tracks these through vertex versions instead
+	unsigned int* collapse_order = (options & meshopt_SimplifyPriorityQueue) ? NULL : allocator.allocate<unsigned int>(collapse_capacity);
+	unsigned char* collapse_locked = (options & meshopt_SimplifyPriorityQueue) ? NULL : allocator.allocate<unsigned char>(vertex_count);
+
+	// parallel collapse picking needs space for 3 collapses per triangle
+	Collapse<V>* collapse_scratch = parallel_for ? allocator.allocate<Collapse<V> >(index_count) : NULL;
 
 	size_t result_count = index_count;
 	float result_error = 0;
 	float vertex_error = 0;
 
-	// target_error input is linear; we need to adjust it to match quadricError units
-	float error_scale = (options & meshopt_SimplifyErrorAbsolute) ? vertex_scale : 1.f;
-	float error_limit = (target_error * target_error) / (error_scale * error_scale);
+	// target_error input is linear; we need to adjust it to match quadricError units
+	float error_scale = (options & meshopt_SimplifyErrorAbsolute) ? vertex_scale : 1.f;
+
+	// priority queue state is rebuilt for each level, but collapse_remap accumulates all collapses performed so far
+	CollapseQueue queue = {};
+
+	if (options & meshopt_SimplifyPriorityQueue)
+	{
+		prepareCollapseQueue(queue, index_count, vertex_count, collapse_capacity, allocator);
+
+		for (size_t i = 0; i < vertex_count; ++i)
+			collapse_remap[i] = V(i);
+	}
+
+	size_t output_count = 0;
+
+	// each level continues simplification from the state (quadrics, edge loops, collapsed indices) of the previous level
+	for (size_t lod = 0; lod < lod_count; ++lod)
+	{
+		size_t target_index_count = target_index_counts[lod];
+		float error_limit = (target_errors[lod] * target_errors[lod]) / (error_scale * error_scale);
+
+		while ((options & meshopt_SimplifyPriorityQueue) && result_count > target_index_count)
+		{
+			size_t edge_collapse_count = parallel_for
+			    ? pickEdgeCollapsesParallel(scheduler, edge_collapses, collapse_capacity, collapse_scratch, result, result_count, remap, vertex_kind, loop, loopback, allocator)
+			    : pickEdgeCollapses(edge_collapses, collapse_capacity, result, result_count, remap, vertex_kind, loop, loopback);
+			assert(edge_collapse_count <= collapse_capacity);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+			pass_count++;
+#endif
+
+			if (parallel_for)
+				rankEdgeCollapsesParallel(scheduler, edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+			else
+				rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+
+			simplify_stats.passes++;
+			simplify_stats.candidates += edge_collapse_count;
+			simplify_stats.candidates_over_error += countCollapsesOverError(edge_collapses, edge_collapse_count, error_limit);
+			addSimplifyTime(simplify_stats, simplify_stats.time_rank, time_last);
+
+			fillCollapseQueue(queue, edge_collapses, edge_collapse_count, result, result_count, vertex_count, remap);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_sort, time_last);
+
+			// collapses continue until we run out of them or hit a limit; pruning needs to interrupt the process when vertex error exceeds the next component error
+			float vertex_error_limit = (options & meshopt_SimplifyPrune) ? component_nexterror : FLT_MAX;
+
+			size_t new_count = performQueueCollapses(queue, result, result_count, collapse_remap, vertex_quadrics, attribute_quadrics, attribute_gradients, vertex_attributes, attribute_count, remap, wedge, vertex_kind, loop, loopback, vertex_positions, target_index_count, error_limit, vertex_error_limit, result_error, vertex_error, simplify_stats);
+			assert(new_count <= result_count);
+
+			bool progress = new_count < result_count;
+			result_count = new_count;
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_collapse, time_last);
+
+			if ((options & meshopt_SimplifyPrune) && result_count > target_index_count && component_nexterror <= vertex_error)
+				result_count = pruneComponents(result, result_count, components, component_errors, component_count, vertex_error, component_nexterror, simplify_stats);
+			else if (!progress)
+				break;
+		}
+
+		while (!(options & meshopt_SimplifyPriorityQueue) && result_count > target_index_count)
+		{
+			// note: throughout the simplification process adjacency structure reflects welded topology for result-in-progress
+			updateEdgeAdjacency(adjacency, result, result_count, vertex_count, remap);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_adjacency, time_last);
+
+			size_t edge_collapse_count = parallel_for
+			    ? pickEdgeCollapsesParallel(scheduler, edge_collapses, collapse_capacity, collapse_scratch, result, result_count, remap, vertex_kind, loop, loopback, allocator)
+			    : pickEdgeCollapses(edge_collapses, collapse_capacity, result, result_count, remap, vertex_kind, loop, loopback);
+			assert(edge_collapse_count <= collapse_capacity);
+
+			// no edges can be collapsed any more due to topology restrictions
+			if (edge_collapse_count == 0)
+			{
+				addSimplifyTime(simplify_stats, simplify_stats.time_rank, time_last);
+				break;
+			}
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+			pass_count++;
+#endif
+
+			if (parallel_for)
+				rankEdgeCollapsesParallel(scheduler, edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+			else
+				rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+
+			simplify_stats.passes++;
+			simplify_stats.candidates += edge_collapse_count;
+			simplify_stats.candidates_over_error += countCollapsesOverError(edge_collapses, edge_collapse_count, error_limit);
+			addSimplifyTime(simplify_stats, simplify_stats.time_rank, time_last);
+
+			sortEdgeCollapses(collapse_order, edge_collapses, edge_collapse_count);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_sort, time_last);
+
+			size_t triangle_collapse_goal = (result_count - target_index_count) / 3;
+
+			for (size_t i = 0; i < vertex_count; ++i)
+				collapse_remap[i] = V(i);
+
+			memset(collapse_locked, 0, vertex_count);
+
+			size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, loop, loopback, vertex_positions, adjacency, triangle_collapse_goal, error_limit, result_error, simplify_stats);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_collapse, time_last);
+
+			// no edges can be collapsed any more due to hitting the error limit or triangle collapse limit
+			if (collapses == 0)
+				break;
+
+			updateQuadrics(collapse_remap, vertex_count, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, vertex_positions, remap, vertex_error);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_quadrics, time_last);
+
+			// updateQuadrics will update vertex error if we use attributes, but if we don't then result_error and vertex_error are equivalent
+			vertex_error = attribute_count == 0 ? result_error : vertex_error;
+
+			remapEdgeLoops(loop, vertex_count, collapse_remap);
+			remapEdgeLoops(loopback, vertex_count, collapse_remap);
+
+			size_t new_count = remapIndexBuffer(result, result_count, collapse_remap);
+			assert(new_count < result_count);
+
+			result_count = new_count;
+
+			if ((options & meshopt_SimplifyPrune) && result_count > target_index_count && component_nexterror <= vertex_error)
+				result_count = pruneComponents(result, result_count, components, component_errors, component_count, vertex_error, component_nexterror, simplify_stats);
+
+			addSimplifyTime(simplify_stats, simplify_stats.time_collapse, time_last);
+		}
+
+		// we're done with the regular simplification but we're still short of the target; try pruning more aggressively towards error_limit
+		while ((options & meshopt_SimplifyPrune) && result_count > target_index_count && component_nexterror <= error_limit)
+		{
+#if MESHOPTIMIZER_INSTRUMENTATION
+			pass_count++;
+#endif
+
+			float component_cutoff = component_nexterror * 1.5f < error_limit ? component_nexterror * 1.5f : error_limit;
+
+			// track maximum error in eligible components as we are increasing resulting error
+			float component_maxerror = 0;
+			for (size_t i = 0; i < component_count; ++i)
+				if (component_errors[i] > component_maxerror && component_errors[i] <= component_cutoff)
+					component_maxerror = component_errors[i];
+
+			size_t new_count = pruneComponents(result, result_count, components, component_errors, component_count, component_cutoff, component_nexterror, simplify_stats);
+			if (new_count == result_count)
+				break;
+
+			result_count = new_count;
+			result_error = result_error < component_maxerror ? component_maxerror : result_error;
+			vertex_error = vertex_error < component_maxerror ? component_maxerror : vertex_error;
+		}
+
+		addSimplifyTime(simplify_stats, simplify_stats.time_collapse, time_last);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+		// passes are reported for each level separately
+		meshopt_Instrument::counter("passes", double(pass_count));
+		pass_count = 0;
+#endif
+
+		// each level is output separately; post-processing is applied to the copy to keep the working buffer intact
+		unsigned int* output = destination + output_count;
+		if (output != result)
+			memcpy(output, result, result_count * sizeof(unsigned int));
+
+		// if debug visualization data is requested, fill it instead of index data; for simplicity, this doesn't work with sparsity
+		if ((options & meshopt_SimplifyInternalDebug) && !sparse_remap)
+		{
+			assert(Kind_Count <= 8 && vertex_count < (1 << 28)); // 3 bit kind, 1 bit loop
+
+			for (size_t i = 0; i < result_count; i += 3)
+			{
+				unsigned int a = output[i + 0], b = output[i + 1], c = output[i + 2];
+
+				output[i + 0] |= (vertex_kind[a] << 28) | (unsigned(loop[a] == b || loopback[b] == a) << 31);
+				output[i + 1] |= (vertex_kind[b] << 28) | (unsigned(loop[b] == c || loopback[c] == b) << 31);
+				output[i + 2] |= (vertex_kind[c] << 28) | (unsigned(loop[c] == a || loopback[a] == c) << 31);
+			}
+		}
+
+		// convert resulting indices back into the dense space of the larger mesh
+		if (sparse_remap)
+			for (size_t i = 0; i < result_count; ++i)
+				output[i] = sparse_remap[output[i]];
+
+		if (out_lod_index_counts)
+			out_lod_index_counts[lod] = result_count;
+
+		// result_error is quadratic; we need to remap it back to linear
+		if (out_lod_errors)
+			out_lod_errors[lod] = sqrtf(result_error) * error_scale;
+
+		output_count += result_count;
+	}
+
+	return output_count;
+}
+
+size_t meshopt_simplifyEdge(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options, size_t* out_lod_index_counts, float* out_lod_errors, meshopt_ParallelFor parallel_for, void* context, meshopt_SimplifyContext* simplify_context, meshopt_SimplifyStats* out_stats)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_simplifyEdge");
+
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(lod_count > 0);
+	for (size_t i = 0; i < lod_count; ++i)
+		assert(target_index_counts[i] <= index_count && target_errors[i] >= 0);
+	assert((options & ~(meshopt_SimplifyLockBorder | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute | meshopt_SimplifyPrune | meshopt_SimplifyPriorityQueue | meshopt_SimplifyInternalDebug)) == 0);
+	assert(vertex_attributes_stride >= attribute_count * sizeof(float) && vertex_attributes_stride <= 256);
+	assert(vertex_attributes_stride % sizeof(float) == 0);
+	assert(attribute_count <= kMaxAttributes);
+	for (size_t i = 0; i < attribute_count; ++i)
+		assert(attribute_weights[i] >= 0);
+
+	// when a context is used, all temporary allocations are served from its scratch memory while it has space left
+	meshopt_Allocator allocator(simplify_context ? simplify_context->scratch : NULL, simplify_context ? simplify_context->scratch_size : 0);
+
+	// when multiple levels are requested, simplification progresses in a separate buffer and each level is copied to destination
+	unsigned int* result = lod_count == 1 ? destination : allocator.allocate<unsigned int>(index_count);
+	if (result != indices)
+		memcpy(result, indices, index_count * sizeof(unsigned int));
+
+	// counters are always collected to keep the code simple; they are only reported when requested
+	meshopt_SimplifyStats simplify_stats = {};
+	simplify_stats.timer = out_stats ? out_stats->timer : NULL;
+
+	double time_last = getSimplifyTime(simplify_stats);
+
+	// build an index remap and update indices/vertex_count to minimize the subsequent work
+	// note: as a consequence, errors will be computed relative to the subset extent
+	unsigned int* sparse_remap = NULL;
+	if (options & meshopt_SimplifySparse)
+		sparse_remap = buildSparseRemap(result, index_count, vertex_count, &vertex_count, allocator);
+
+	addSimplifyTime(simplify_stats, simplify_stats.time_adjacency, time_last);
+
+	// small meshes (after sparse remap) use 16-bit vertex indices for internal structures to reduce the working set; ~0 is reserved for "no vertex"
+	size_t output_count = vertex_count < 65536
+	    ? simplifyEdge<unsigned short>(destination, result, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_counts, target_errors, lod_count, options, out_lod_index_counts, out_lod_errors, parallel_for, context, sparse_remap, allocator, simplify_stats)
+	    : simplifyEdge<unsigned int>(destination, result, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_counts, target_errors, lod_count, options, out_lod_index_counts, out_lod_errors, parallel_for, context, sparse_remap, allocator, simplify_stats);
+
+	if (out_stats)
+		*out_stats = simplify_stats;
+
+	return output_count;
+}
+
+size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+{
+	meshopt_Instrument instrument("meshopt_simplify");
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, NULL, &target_index_count, &target_error, 1, options, NULL, out_result_error, NULL, NULL, NULL, NULL);
+}
+
+size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+{
+	meshopt_Instrument instrument("meshopt_simplifyWithAttributes");
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, options, NULL, out_result_error, NULL, NULL, NULL, NULL);
+}
+
+size_t meshopt_simplifyParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error, meshopt_ParallelFor parallel_for, void* context)
+{
+	meshopt_Instrument instrument("meshopt_simplifyParallel");
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, options, NULL, out_result_error, parallel_for, context, NULL, NULL);
+}
+
+size_t meshopt_simplifyWithStats(meshopt_SimplifyStats* stats, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+{
+	meshopt_Instrument instrument("meshopt_simplifyWithStats");
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, options, NULL, out_result_error, NULL, NULL, NULL, stats);
+}
+
+size_t meshopt_simplifyLods(unsigned int* destination, size_t* lod_index_counts, float* lod_errors, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, const size_t* target_index_counts, const float* target_errors, size_t lod_count, unsigned int options)
+{
+	meshopt_Instrument instrument("meshopt_simplifyLods");
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_counts, target_errors, lod_count, options, lod_index_counts, lod_errors, NULL, NULL, NULL, NULL);
+}
+
+void meshopt_simplifyContextInit(meshopt_SimplifyContext* context)
+{
+	context->scratch = NULL;
+	context->scratch_size = 0;
+}
+
+void meshopt_simplifyContextDestroy(meshopt_SimplifyContext* context)
+{
+	if (context->scratch)
+		meshopt_Allocator::Storage::deallocate(context->scratch);
+
+	meshopt_simplifyContextInit(context);
+}
+
+void meshopt_simplifyContextReserve(meshopt_SimplifyContext* context, size_t scratch_size)
+{
+	meshopt_Instrument instrument("meshopt_simplifyContextReserve");
+
+	if (context->scratch_size >= scratch_size)
+		return;
+
+	if (context->scratch)
+		meshopt_Allocator::Storage::deallocate(context->scratch);
+
+	context->scratch = meshopt_Allocator::Storage::allocate(scratch_size);
+	context->scratch_size = scratch_size;
+}
+
+size_t meshopt_simplifyScratchSize(size_t index_count, size_t vertex_count, size_t attribute_count, unsigned int options)
+{
+	using namespace meshopt;
+
+	// this mirrors allocations in meshopt_simplifyEdge for a single level without parallel execution; each allocation may need up to 15 bytes of alignment padding
+	// sizes assume 32-bit internal indices, which is the worst case; meshes with fewer than 65536 vertices use 16-bit indices and need less memory
+	size_t result = 24 * 16;
+
+	if (options & meshopt_SimplifySparse)
+	{
+		size_t unique = vertex_count < index_count ? vertex_count : index_count;
+
+		result += (vertex_count + 7) / 8 + unique * sizeof(unsigned int) + meshopt_hashBuckets(unique) * sizeof(unsigned int);
+		vertex_count = unique;
+	}
+
+	// adjacency
+	result += (vertex_count + 1) * sizeof(unsigned int) + index_count * sizeof(EdgeAdjacency<unsigned int>::Edge);
+
+	// remap, wedge, position hash table, classification
+	result += vertex_count * sizeof(unsigned int) * 2 + meshopt_hashBuckets(vertex_count) * sizeof(unsigned int);
+	result += vertex_count * (1 + sizeof(unsigned int) * 2);
+
+	// positions, attributes and quadrics
+	result += vertex_count * (sizeof(Vector3) + sizeof(Quadric));
+
+	// attributes are padded to a multiple of the block size
+	size_t attribute_padded = (attribute_count + kAttributeBlock - 1) / kAttributeBlock * kAttributeBlock;
+
+	if (attribute_count)
+		result += vertex_count * (attribute_padded * sizeof(float) + sizeof(Quadric) + (attribute_padded / kAttributeBlock) * sizeof(QuadricGrad));
+
+	// components
+	if (options & meshopt_SimplifyPrune)
+		result += vertex_count * sizeof(unsigned int) + vertex_count * 4 * sizeof(float);
+
+	// collapses; see boundEdgeCollapses for capacity
+	result += (index_count + 3) * (sizeof(Collapse<unsigned int>) + sizeof(unsigned int));
+	result += vertex_count * (sizeof(unsigned int) + 1);
+
+	// priority queue
+	if (options & meshopt_SimplifyPriorityQueue)
+		result += (index_count + 3) * 2 * sizeof(CollapseQueue::Entry) + kCollapseQueueBins * sizeof(unsigned int) * 2 + vertex_count * sizeof(unsigned int) * 2 + index_count * sizeof(unsigned int);
+
+	return result;
+}
+
+size_t meshopt_simplifyWithContext(meshopt_SimplifyContext* context, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+{
+	meshopt_Instrument instrument("meshopt_simplifyWithContext");
+
+	assert(context);
+
+	// scratch memory is grown to the worst case size upfront
+	meshopt_simplifyContextReserve(context, meshopt_simplifyScratchSize(index_count, vertex_count, attribute_count, options));
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, options, NULL, out_result_error, NULL, NULL, context, NULL);
+}
+
+size_t meshopt_simplifyWithScratch(void* scratch, size_t scratch_size, unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
+{
+	meshopt_Instrument instrument("meshopt_simplifyWithScratch");
+
+	assert(size_t(scratch) % 16 == 0);
+
+	// the caller owns scratch memory, so unlike meshopt_simplifyWithContext it never grows
+	meshopt_SimplifyContext context = {scratch, scratch_size};
+
+	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, &target_index_count, &target_error, 1, options, NULL, out_result_error, NULL, NULL, &context, NULL);
+}
+
+struct SimplifyTileTask
+{
+	unsigned int* indices;
+	size_t triangle_count;
+	size_t tile_size;
+	size_t tile_offset;
+
+	const float* vertex_positions;
+	size_t vertex_count;
+	size_t vertex_positions_stride;
+	const float* vertex_attributes;
+	size_t vertex_attributes_stride;
+	const float* attribute_weights;
+	size_t attribute_count;
+	const unsigned char* vertex_lock;
+
+	double target_ratio;
+	float target_error;
+	unsigned int options;
+
+	size_t* tile_counts;
+	float* tile_errors;
+};
+
+static size_t getTileBegin(size_t tile, size_t triangle_count, size_t tile_size, size_t tile_offset)
+{
+	size_t begin = tile == 0 ? 0 : tile * tile_size - tile_offset;
+	return begin < triangle_count ? begin : triangle_count;
+}
+
+static void simplifyTileTask(void* context, size_t tile)
+{
+	const SimplifyTileTask& t = *static_cast<SimplifyTileTask*>(context);
 
-	while (result_count > target_index_count)
-	{
-		// note: throughout the simplification process adjacency structure reflects welded topology for result-in-progress
-		updateEdgeAdjacency(adjacency, result, result_count, vertex_count, remap);
+	size_t begin = getTileBegin(tile, t.triangle_count, t.tile_size, t.tile_offset);
+	size_t end = getTileBegin(tile + 1, t.triangle_count, t.tile_size, t.tile_offset);
 
-		size_t edge_collapse_count = pickEdgeCollapses(edge_collapses, collapse_capacity, result, result_count, remap, vertex_kind, loop, loopback);
-		assert(edge_collapse_count <= collapse_capacity);
+	unsigned int* indices = t.indices + begin * 3;
+	size_t index_count = (end - begin) * 3;
 
-		// no edges can be collapsed any more due to topology restrictions
-		if (edge_collapse_count == 0)
-			break;
+	size_t target_index_count = size_t(double(index_count) * t.target_ratio) / 3 * 3;
+	target_index_count = target_index_count < index_count ? target_index_count : index_count;
 
-#if TRACE
-		printf("pass %d:%c", int(pass_count++), TRACE >= 2 ? '\n' : ' ');
-#endif
+	t.tile_counts[tile] = meshopt_simplifyEdge(indices, indices, index_count, t.vertex_positions, t.vertex_count, t.vertex_positions_stride, t.vertex_attributes, t.vertex_attributes_stride, t.attribute_weights, t.attribute_count, t.vertex_lock, &target_index_count, &t.target_error, 1, t.options, NULL, &t.tile_errors[tile], NULL, NULL, NULL, NULL);
+}
 
-		rankEdgeCollapses(edge_collapses, edge_collapse_count, vertex_positions, vertex_attributes, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, remap, wedge, vertex_kind, loop, loopback);
+static void lockTileBorders(unsigned char* locks, unsigned int* tiles, const unsigned int* indices, size_t triangle_count, size_t tile_size, size_t tile_offset, const unsigned int* position_remap, const unsigned char* vertex_lock, size_t vertex_count)
+{
+	const unsigned int kShared = ~1u;
 
-		sortEdgeCollapses(collapse_order, edge_collapses, edge_collapse_count);
+	memset(tiles, -1, vertex_count * sizeof(unsigned int));
 
-		size_t triangle_collapse_goal = (result_count - target_index_count) / 3;
+	// tiles[] tracks the tile that references each position; positions referenced by more than one tile are shared
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+	{
+		unsigned int tile = unsigned((i / 3 + tile_offset) / tile_size);
+		unsigned int& entry = tiles[position_remap[indices[i]]];
 
-		for (size_t i = 0; i < vertex_count; ++i)
-			collapse_remap[i] = unsigned(i);
+		entry = (entry == ~0u || entry == tile) ? tile : kShared;
+	}
+
+	// all wedges of shared positions must be locked to keep tile borders intact
+	for (size_t i = 0; i < vertex_count; ++i)
+		locks[i] = (vertex_lock && vertex_lock[i]) || tiles[position_remap[i]] == kShared;
+}
 
-		memset(collapse_locked, 0, vertex_count);
+size_t meshopt_simplifyTiled(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, size_t tile_size, float* out_result_error, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
 
-		size_t collapses = performEdgeCollapses(collapse_remap, collapse_locked, edge_collapses, edge_collapse_count, collapse_order, remap, wedge, vertex_kind, loop, loopback, vertex_positions, adjacency, triangle_collapse_goal, error_limit, result_error);
+	meshopt_Instrument instrument("meshopt_simplifyTiled");
 
-		// no edges can be collapsed any more due to hitting the error limit or triangle collapse limit
-		if (collapses == 0)
-			break;
+	assert(index_count % 3 == 0);
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(target_index_count <= index_count);
+	assert(tile_size > 0);
 
-		updateQuadrics(collapse_remap, vertex_count, vertex_quadrics, attribute_quadrics, attribute_gradients, attribute_count, vertex_positions, remap, vertex_error);
+	meshopt_Allocator allocator;
 
-		// updateQuadrics will update vertex error if we use attributes, but if we don't then result_error and vertex_error are equivalent
-		vertex_error = attribute_count == 0 ? result_error : vertex_error;
+	// global state is limited to a few bytes per vertex; all other simplification state is allocated per tile
+	unsigned int* position_remap = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* wedge = allocator.allocate<unsigned int>(vertex_count);
+	buildPositionRemap(position_remap, wedge, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, allocator);
+	allocator.deallocate(wedge);
 
-		remapEdgeLoops(loop, vertex_count, collapse_remap);
-		remapEdgeLoops(loopback, vertex_count, collapse_remap);
+	unsigned int* tiles = allocator.allocate<unsigned int>(vertex_count);
+	unsigned char* locks = allocator.allocate<unsigned char>(vertex_count);
 
-		size_t new_count = remapIndexBuffer(result, result_count, collapse_remap);
-		assert(new_count < result_count);
+	// by default errors are relative to the mesh extent, but tiles are simplified in sparse mode which uses tile extent; we convert errors to absolute to keep them consistent
+	float error_scale = (options & meshopt_SimplifyErrorAbsolute) ? 1.f : meshopt_simplifyScale(vertex_positions_data, vertex_count, vertex_positions_stride);
 
-		result_count = new_count;
+	// spatial sort makes each consecutive range of triangles spatially coherent so that tiles have short borders
+	meshopt_spatialSortTriangles(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride);
 
-		if ((options & meshopt_SimplifyPrune) && result_count > target_index_count && component_nexterror <= vertex_error)
-			result_count = pruneComponents(result, result_count, components, component_errors, component_count, vertex_error, component_nexterror);
-	}
+	size_t result_count = index_count;
+	float result_error = 0;
 
-	// we're done with the regular simplification but we're still short of the target; try pruning more aggressively towards error_limit
-	while ((options & meshopt_SimplifyPrune) && result_count > target_index_count && component_nexterror <= error_limit)
+	// first sweep simplifies tiles with shared borders locked; the second sweep re-sorts the remaining triangles and uses a different tiling so that first sweep borders end up inside tiles
+	for (int sweep = 0; sweep < 2 && result_count > target_index_count; ++sweep)
 	{
-#if TRACE
-		printf("pass %d: cleanup; ", int(pass_count++));
-#endif
+		if (sweep > 0)
+			meshopt_spatialSortTriangles(destination, destination, result_count, vertex_positions_data, vertex_count, vertex_positions_stride);
 
-		float component_cutoff = component_nexterror * 1.5f < error_limit ? component_nexterror * 1.5f : error_limit;
+		size_t triangle_count = result_count / 3;
+		size_t tile_offset = sweep == 0 ? 0 : tile_size / 2;
+		size_t tile_count = (triangle_count + tile_offset + tile_size - 1) / tile_size;
 
-		// track maximum error in eligible components as we are increasing resulting error
-		float component_maxerror = 0;
-		for (size_t i = 0; i < component_count; ++i)
-			if (component_errors[i] > component_maxerror && component_errors[i] <= component_cutoff)
-				component_maxerror = component_errors[i];
+		lockTileBorders(locks, tiles, destination, triangle_count, tile_size, tile_offset, position_remap, vertex_lock, vertex_count);
 
-		size_t new_count = pruneComponents(result, result_count, components, component_errors, component_count, component_cutoff, component_nexterror);
-		if (new_count == result_count)
-			break;
+		size_t* tile_counts = allocator.allocate<size_t>(tile_count);
+		float* tile_errors = allocator.allocate<float>(tile_count);
 
-		result_count = new_count;
-		result_error = result_error < component_maxerror ? component_maxerror : result_error;
-		vertex_error = vertex_error < component_maxerror ? component_maxerror : vertex_error;
-	}
+		SimplifyTileTask task = {destination, triangle_count, tile_size, tile_offset, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, locks, double(target_index_count) / double(result_count), target_error * error_scale, options | meshopt_SimplifySparse | meshopt_SimplifyErrorAbsolute, tile_counts, tile_errors};
 
-#if TRACE
-	printf("result: %d triangles, error: %e; total %d passes\n", int(result_count / 3), sqrtf(result_error), int(pass_count));
-#endif
+		if (parallel_for && tile_count > 1)
+			parallel_for(context, simplifyTileTask, &task, tile_count);
+		else
+			for (size_t i = 0; i < tile_count; ++i)
+				simplifyTileTask(&task, i);
 
-	// if debug visualization data is requested, fill it instead of index data; for simplicity, this doesn't work with sparsity
-	if ((options & meshopt_SimplifyInternalDebug) && !sparse_remap)
-	{
-		assert(Kind_Count <= 8 && vertex_count < (1 << 28)); // 3 bit kind, 1 bit loop
+		// tiles are simplified in place; compact the results in tile order
+		size_t write = 0;
 
-		for (size_t i = 0; i < result_count; i += 3)
+		for (size_t i = 0; i < tile_count; ++i)
 		{
-			unsigned int a = result[i + 0], b = result[i + 1], c = result[i + 2];
+			size_t begin = getTileBegin(i, triangle_count, tile_size, tile_offset);
 
-			result[i + 0] |= (vertex_kind[a] << 28) | (unsigned(loop[a] == b || loopback[b] == a) << 31);
-			result[i + 1] |= (vertex_kind[b] << 28) | (unsigned(loop[b] == c || loopback[c] == b) << 31);
-			result[i + 2] |= (vertex_kind[c] << 28) | (unsigned(loop[c] == a || loopback[a] == c) << 31);
+			memmove(destination + write, destination + begin * 3, tile_counts[i] * sizeof(unsigned int));
+			write += tile_counts[i];
+
+			result_error = result_error < tile_errors[i] ? tile_errors[i] : result_error;
 		}
-	}
 
-	// convert resulting indices back into the dense space of the larger mesh
-	if (sparse_remap)
-		for (size_t i = 0; i < result_count; ++i)
-			result[i] = sparse_remap[result[i]];
+		result_count = write;
+
+		allocator.deallocate(tile_errors);
+		allocator.deallocate(tile_counts);
+	}
 
-	// result_error is quadratic; we need to remap it back to linear
 	if (out_result_error)
-		*out_result_error = sqrtf(result_error) * error_scale;
+		*out_result_error = result_error / error_scale;
 
 	return result_count;
 }
 
-size_t meshopt_simplify(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
-{
-	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, NULL, 0, NULL, 0, NULL, target_index_count, target_error, options, out_result_error);
-}
-
-size_t meshopt_simplifyWithAttributes(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_attributes_data, size_t vertex_attributes_stride, const float* attribute_weights, size_t attribute_count, const unsigned char* vertex_lock, size_t target_index_count, float target_error, unsigned int options, float* out_result_error)
-{
-	return meshopt_simplifyEdge(destination, indices, index_count, vertex_positions_data, vertex_count, vertex_positions_stride, vertex_attributes_data, vertex_attributes_stride, attribute_weights, attribute_count, vertex_lock, target_index_count, target_error, options, out_result_error);
-}
-
 size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride, size_t target_index_count, float target_error, float* out_result_error)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_simplifySloppy");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
@@ -2097,66 +3796,94 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
 
 	// find the optimal grid size using guided binary search
-#if TRACE
-	printf("source: %d vertices, %d triangles\n", int(vertex_count), int(index_count / 3));
-	printf("target: %d cells, %d triangles\n", int(target_cell_count), int(target_index_count / 3));
-#endif
+	meshopt_Instrument::counter("target_cells", double(target_cell_count));
 
-	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
+	// each search pass evaluates several grid sizes at once; this is almost as cheap as evaluating one since the cost is dominated by memory access
+	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count * kSloppyProbes);
 
-	const int kInterpolationPasses = 5;
+	const int kSearchPasses = 8;
 
 	// invariant: # of triangles in min_grid <= target_count
 	int min_grid = int(1.f / (target_error < 1e-3f ? 1e-3f : target_error));
 	int max_grid = 1025;
 	size_t min_triangles = 0;
 	size_t max_triangles = index_count / 3;
-
-	// when we're error-limited, we compute the triangle count for the min. size; this accelerates convergence and provides the correct answer when we can't use a larger grid
-	if (min_grid > 1)
-	{
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, min_grid);
-		min_triangles = countTriangles(vertex_ids, indices, index_count);
-	}
+	size_t target_triangles = target_index_count / 3;
 
 	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
-	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
+	int guess = int(sqrtf(float(target_cell_count)) + 0.5f);
 
-	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
+	for (int pass = 0; pass < kSearchPasses; ++pass)
 	{
-		if (min_triangles >= target_index_count / 3 || max_grid - min_grid <= 1)
-			break;
-
-		// we clamp the prediction of the grid size to make sure that the search converges
-		int grid_size = next_grid_size;
-		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid ? max_grid - 1 : grid_size);
+		// when we're error-limited, we compute the triangle count for the min. size in the first pass; this provides the correct answer when we can't use a larger grid
+		bool probe_min = pass == 0 && min_grid > 1;
 
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
-		size_t triangles = countTriangles(vertex_ids, indices, index_count);
+		if (!probe_min && (min_triangles >= target_triangles || max_grid - min_grid <= 1))
+			break;
 
-#if TRACE
-		printf("pass %d (%s): grid size %d, triangles %d, %s\n",
-		    pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses ? "lerp" : "binary"),
-		    grid_size, int(triangles),
-		    (triangles <= target_index_count / 3) ? "under" : "over");
-#endif
+		// we probe around the predicted grid size, and additionally split the larger remaining part of the range to make sure that the search converges
+		int tip = (guess <= min_grid) ? min_grid + 1 : (guess >= max_grid ? max_grid - 1 : guess);
+		int delta = (max_grid - min_grid) / 16 + 1;
 
-		float tip = interpolate(float(size_t(target_index_count / 3)), float(min_grid), float(min_triangles), float(grid_size), float(triangles), float(max_grid), float(max_triangles));
+		int candidates[kSloppyProbes] = {probe_min ? min_grid : tip - delta, tip, tip + delta, (tip - min_grid > max_grid - tip) ? (min_grid + tip) / 2 : (tip + max_grid) / 2};
+		int grid_sizes[kSloppyProbes];
 
-		if (triangles <= target_index_count / 3)
+		for (size_t k = 0; k < kSloppyProbes; ++k)
 		{
-			min_grid = grid_size;
-			min_triangles = triangles;
+			int grid_size = candidates[k];
+			grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid ? max_grid - 1 : grid_size);
+
+			// keep probes sorted so that narrowing the range below is a single scan
+			size_t j = k;
+			for (; j > 0 && grid_sizes[j - 1] > grid_size; --j)
+				grid_sizes[j] = grid_sizes[j - 1];
+			grid_sizes[j] = grid_size;
 		}
-		else
+
+		if (probe_min)
+			grid_sizes[0] = min_grid;
+
+		// when the range is too narrow, some probes may be duplicated; this is harmless
+		size_t triangles[kSloppyProbes];
+
+		computeVertexIdsProbes(vertex_ids, vertex_positions, vertex_count, grid_sizes);
+		countTrianglesProbes(triangles, vertex_ids, indices, index_count);
+
+		for (size_t k = 0; k < kSloppyProbes; ++k)
 		{
-			max_grid = grid_size;
-			max_triangles = triangles;
+			meshopt_Instrument::counter("grid_size", double(grid_sizes[k]), int(pass * kSloppyProbes + k));
+			meshopt_Instrument::counter("grid_triangles", double(triangles[k]), int(pass * kSloppyProbes + k));
+
+			if (probe_min && k == 0)
+			{
+				min_triangles = triangles[k];
+
+				// error-limited: we can't use a larger grid, so there is no point in looking at other probes
+				if (min_triangles >= target_triangles)
+					break;
+
+				continue;
+			}
+
+			// the triangle count isn't strictly monotonic in grid size; we narrow the range up to the first probe over the target
+			if (triangles[k] <= target_triangles)
+			{
+				min_grid = grid_sizes[k];
+				min_triangles = triangles[k];
+			}
+			else
+			{
+				max_grid = grid_sizes[k];
+				max_triangles = triangles[k];
+				break;
+			}
 		}
 
-		// we start by using interpolation search - it usually converges faster
-		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
-		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
+		// predict the next grid size assuming the triangle count grows as a square of grid size within the range
+		float min_root = sqrtf(float(min_triangles)), max_root = sqrtf(float(max_triangles));
+		float target_root = sqrtf(float(target_triangles));
+
+		guess = (max_root > min_root) ? min_grid + int(float(max_grid - min_grid) * (target_root - min_root) / (max_root - min_root) + 0.5f) : (min_grid + max_grid) / 2;
 	}
 
 	if (min_triangles == 0)
@@ -2168,7 +3895,7 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 	}
 
 	// build vertex->cell association by mapping all vertices with the same quantized position to the same cell
-	size_t table_size = hashBuckets2(vertex_count);
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 
 	unsigned int* vertex_cells = allocator.allocate<unsigned int>(vertex_count);
@@ -2196,14 +3923,13 @@ size_t meshopt_simplifySloppy(unsigned int* destination, const unsigned int* ind
 
 	// collapse triangles!
 	// note that we need to filter out triangles that we've already output because we very frequently generate redundant triangles between cells :(
-	size_t tritable_size = hashBuckets2(min_triangles);
+	size_t tritable_size = meshopt_hashBuckets(min_triangles);
 	unsigned int* tritable = allocator.allocate<unsigned int>(tritable_size);
 
 	size_t write = filterTriangles(destination, tritable, tritable_size, indices, index_count, vertex_cells, cell_remap);
 
-#if TRACE
-	printf("result: %d cells, %d triangles (%d unfiltered), error %e\n", int(cell_count), int(write / 3), int(min_triangles), sqrtf(result_error));
-#endif
+	meshopt_Instrument::counter("cells", double(cell_count));
+	meshopt_Instrument::counter("unfiltered_triangles", double(min_triangles));
 
 	if (out_result_error)
 		*out_result_error = sqrtf(result_error);
@@ -2215,6 +3941,8 @@ size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_pos
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_simplifyPoints");
+
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 	assert(vertex_colors_stride == 0 || (vertex_colors_stride >= 12 && vertex_colors_stride <= 256));
@@ -2233,66 +3961,15 @@ size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_pos
 	rescalePositions(vertex_positions, vertex_positions_data, vertex_count, vertex_positions_stride);
 
 	// find the optimal grid size using guided binary search
-#if TRACE
-	printf("source: %d vertices\n", int(vertex_count));
-	printf("target: %d cells\n", int(target_cell_count));
-#endif
+	meshopt_Instrument::counter("target_cells", double(target_cell_count));
 
 	unsigned int* vertex_ids = allocator.allocate<unsigned int>(vertex_count);
 
-	size_t table_size = hashBuckets2(vertex_count);
+	size_t table_size = meshopt_hashBuckets(vertex_count);
 	unsigned int* table = allocator.allocate<unsigned int>(table_size);
 
-	const int kInterpolationPasses = 5;
-
-	// invariant: # of vertices in min_grid <= target_count
-	int min_grid = 0;
-	int max_grid = 1025;
 	size_t min_vertices = 0;
-	size_t max_vertices = vertex_count;
-
-	// instead of starting in the middle, let's guess as to what the answer might be! triangle count usually grows as a square of grid size...
-	int next_grid_size = int(sqrtf(float(target_cell_count)) + 0.5f);
-
-	for (int pass = 0; pass < 10 + kInterpolationPasses; ++pass)
-	{
-		assert(min_vertices < target_vertex_count);
-		assert(max_grid - min_grid > 1);
-
-		// we clamp the prediction of the grid size to make sure that the search converges
-		int grid_size = next_grid_size;
-		grid_size = (grid_size <= min_grid) ? min_grid + 1 : (grid_size >= max_grid ? max_grid - 1 : grid_size);
-
-		computeVertexIds(vertex_ids, vertex_positions, vertex_count, grid_size);
-		size_t vertices = countVertexCells(table, table_size, vertex_ids, vertex_count);
-
-#if TRACE
-		printf("pass %d (%s): grid size %d, vertices %d, %s\n",
-		    pass, (pass == 0) ? "guess" : (pass <= kInterpolationPasses ? "lerp" : "binary"),
-		    grid_size, int(vertices),
-		    (vertices <= target_vertex_count) ? "under" : "over");
-#endif
-
-		float tip = interpolate(float(target_vertex_count), float(min_grid), float(min_vertices), float(grid_size), float(vertices), float(max_grid), float(max_vertices));
-
-		if (vertices <= target_vertex_count)
-		{
-			min_grid = grid_size;
-			min_vertices = vertices;
-		}
-		else
-		{
-			max_grid = grid_size;
-			max_vertices = vertices;
-		}
-
-		if (vertices == target_vertex_count || max_grid - min_grid <= 1)
-			break;
-
-		// we start by using interpolation search - it usually converges faster
-		// however, interpolation search has a worst case of O(N) so we switch to binary search after a few iterations which converges in O(logN)
-		next_grid_size = (pass < kInterpolationPasses) ? int(tip + 0.5f) : (min_grid + max_grid) / 2;
-	}
+	int min_grid = findPointsGrid(min_vertices, vertex_ids, table, table_size, vertex_positions, vertex_count, target_vertex_count);
 
 	if (min_vertices == 0)
 		return 0;
@@ -2322,15 +3999,213 @@ size_t meshopt_simplifyPoints(unsigned int* destination, const float* vertex_pos
 	assert(cell_count <= target_vertex_count);
 	memcpy(destination, cell_remap, sizeof(unsigned int) * cell_count);
 
-#if TRACE
-	// compute error
-	float result_error = 0.f;
+	meshopt_Instrument::counter("cells", double(cell_count));
 
-	for (size_t i = 0; i < cell_count; ++i)
-		result_error = result_error < cell_errors[i] ? cell_errors[i] : result_error;
+	return cell_count;
+}
 
-	printf("result: %d cells, %e error\n", int(cell_count), sqrtf(result_error));
-#endif
+void meshopt_simplifyPointsStreamInit(meshopt_PointStream* stream, const float* bounds_min, const float* bounds_max, float color_weight, size_t target_vertex_count)
+{
+	using namespace meshopt;
+
+	PointStream* state = static_cast<PointStream*>(meshopt_Allocator::Storage::allocate(sizeof(PointStream)));
+
+	float extent = 0.f;
+
+	for (int k = 0; k < 3; ++k)
+	{
+		assert(bounds_min[k] <= bounds_max[k]);
+
+		state->origin[k] = bounds_min[k];
+		extent = (bounds_max[k] - bounds_min[k]) < extent ? extent : (bounds_max[k] - bounds_min[k]);
+	}
+
+	state->scale = extent == 0 ? 0.f : 1.f / extent;
+	state->color_weight = color_weight;
+	state->target_count = target_vertex_count;
+	state->level = 0;
+
+	// we keep a few cells per target point so that the final grid search has enough resolution to work with
+	state->cell_count = 0;
+	state->cell_budget = target_vertex_count * 4 < 256 ? 256 : target_vertex_count * 4;
+
+	state->keys = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate(state->cell_budget * sizeof(unsigned int)));
+	state->cells = static_cast<PointCell*>(meshopt_Allocator::Storage::allocate(state->cell_budget * sizeof(PointCell)));
+
+	state->table_size = meshopt_hashBuckets(state->cell_budget);
+	state->table = static_cast<unsigned int*>(meshopt_Allocator::Storage::allocate(state->table_size * sizeof(unsigned int)));
+	memset(state->table, -1, state->table_size * sizeof(unsigned int));
+
+	stream->state = state;
+}
+
+void meshopt_simplifyPointsStreamDestroy(meshopt_PointStream* stream)
+{
+	using namespace meshopt;
+
+	PointStream* state = static_cast<PointStream*>(stream->state);
+
+	if (state)
+	{
+		meshopt_Allocator::Storage::deallocate(state->table);
+		meshopt_Allocator::Storage::deallocate(state->cells);
+		meshopt_Allocator::Storage::deallocate(state->keys);
+		meshopt_Allocator::Storage::deallocate(state);
+	}
+
+	stream->state = NULL;
+}
+
+void meshopt_simplifyPointsStreamAdd(meshopt_PointStream* stream, unsigned int base_index, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, const float* vertex_colors, size_t vertex_colors_stride)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_simplifyPointsStreamAdd");
+
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+	assert(vertex_colors_stride == 0 || (vertex_colors_stride >= 12 && vertex_colors_stride <= 256));
+	assert(vertex_colors_stride % sizeof(float) == 0);
+	assert(vertex_colors == NULL || vertex_colors_stride != 0);
+
+	PointStream& state = *static_cast<PointStream*>(stream->state);
+
+	static const float dummy_color[] = {0.f, 0.f, 0.f};
+
+	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+	size_t vertex_colors_stride_float = vertex_colors_stride / sizeof(float);
+
+	const float cell_scale = float((1 << kPointStreamGridBits) - 1);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* v = vertex_positions + i * vertex_stride_float;
+		const float* color = vertex_colors ? &vertex_colors[i * vertex_colors_stride_float] : dummy_color;
+
+		float p[3];
+		unsigned int q[3];
+
+		for (int k = 0; k < 3; ++k)
+		{
+			float pk = (v[k] - state.origin[k]) * state.scale;
+			pk = pk < 0.f ? 0.f : (pk > 1.f ? 1.f : pk);
+
+			p[k] = pk;
+			q[k] = unsigned(int(pk * cell_scale + 0.5f));
+		}
+
+		PointCell cell = {p[0], p[1], p[2], color[0], color[1], color[2], 1.0, base_index + unsigned(i), p[0], p[1], p[2], color[0], color[1], color[2]};
+
+		addPointCell(state, (q[0] << 20) | (q[1] << 10) | q[2], 0, cell);
+	}
+}
+
+void meshopt_simplifyPointsStreamMerge(meshopt_PointStream* stream, const meshopt_PointStream* other)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_simplifyPointsStreamMerge");
+
+	PointStream& state = *static_cast<PointStream*>(stream->state);
+	const PointStream& ostate = *static_cast<const PointStream*>(other->state);
+
+	assert(&state != &ostate);
+	assert(state.scale == ostate.scale && state.target_count == ostate.target_count && state.color_weight == ostate.color_weight);
+	assert(memcmp(state.origin, ostate.origin, sizeof(state.origin)) == 0);
+
+	for (size_t i = 0; i < ostate.cell_count; ++i)
+		addPointCell(state, ostate.keys[i], ostate.level, ostate.cells[i]);
+}
+
+size_t meshopt_simplifyPointsStreamFinish(meshopt_PointStream* stream, unsigned int* destination)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_simplifyPointsStreamFinish");
+
+	PointStream& state = *static_cast<PointStream*>(stream->state);
+
+	size_t point_count = state.cell_count;
+	size_t target_vertex_count = state.target_count;
+
+	if (target_vertex_count == 0)
+		return 0;
+
+	// when the stream has few enough cells, each cell contributes its candidate point
+	if (point_count <= target_vertex_count)
+	{
+		for (size_t i = 0; i < point_count; ++i)
+			destination[i] = state.cells[i].index;
+
+		return point_count;
+	}
+
+	meshopt_Allocator allocator;
+
+	// each stream cell is treated as a weighted point located at the cell average; the search below mirrors meshopt_simplifyPoints
+	Vector3* point_positions = allocator.allocate<Vector3>(point_count);
+	Vector3* point_colors = allocator.allocate<Vector3>(point_count);
+	float* point_weights = allocator.allocate<float>(point_count);
+
+	for (size_t i = 0; i < point_count; ++i)
+	{
+		const PointCell& cell = state.cells[i];
+		double iw = 1.0 / cell.w;
+
+		point_positions[i].x = float(cell.x * iw);
+		point_positions[i].y = float(cell.y * iw);
+		point_positions[i].z = float(cell.z * iw);
+		point_colors[i].x = float(cell.r * iw);
+		point_colors[i].y = float(cell.g * iw);
+		point_colors[i].z = float(cell.b * iw);
+		point_weights[i] = float(cell.w);
+	}
+
+	unsigned int* vertex_ids = allocator.allocate<unsigned int>(point_count);
+
+	size_t table_size = meshopt_hashBuckets(point_count);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+
+	size_t min_vertices = 0;
+	int min_grid = findPointsGrid(min_vertices, vertex_ids, table, table_size, point_positions, point_count, target_vertex_count);
+
+	if (min_vertices == 0)
+		return 0;
+
+	unsigned int* vertex_cells = allocator.allocate<unsigned int>(point_count);
+
+	computeVertexIds(vertex_ids, point_positions, point_count, min_grid);
+	size_t cell_count = fillVertexCells(table, table_size, vertex_cells, vertex_ids, point_count);
+
+	Reservoir* cell_reservoirs = allocator.allocate<Reservoir>(cell_count);
+	memset(cell_reservoirs, 0, cell_count * sizeof(Reservoir));
+
+	fillCellReservoirs(cell_reservoirs, cell_count, point_positions, &point_colors[0].x, sizeof(Vector3), point_count, vertex_cells, point_weights);
+
+	// select the stream candidate closest to the reservoir average; candidates replace cell averages as positions to make sure errors refer to actual points
+	for (size_t i = 0; i < point_count; ++i)
+	{
+		const PointCell& cell = state.cells[i];
+
+		point_positions[i].x = cell.px;
+		point_positions[i].y = cell.py;
+		point_positions[i].z = cell.pz;
+		point_colors[i].x = cell.pr;
+		point_colors[i].y = cell.pg;
+		point_colors[i].z = cell.pb;
+	}
+
+	unsigned int* cell_remap = allocator.allocate<unsigned int>(cell_count);
+	float* cell_errors = allocator.allocate<float>(cell_count);
+
+	float color_weight_scaled = state.color_weight * (min_grid == 1 ? 1.f : 1.f / (min_grid - 1));
+
+	fillCellRemap(cell_remap, cell_errors, cell_count, vertex_cells, cell_reservoirs, point_positions, &point_colors[0].x, sizeof(Vector3), color_weight_scaled * color_weight_scaled, point_count);
+
+	assert(cell_count <= target_vertex_count);
+
+	for (size_t i = 0; i < cell_count; ++i)
+		destination[i] = state.cells[cell_remap[i]].index;
 
 	return cell_count;
 }
@@ -2339,6 +4214,8 @@ float meshopt_simplifyScale(const float* vertex_positions, size_t vertex_count,
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_simplifyScale");
+
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 
@@ -2346,3 +4223,7 @@ float meshopt_simplifyScale(const float* vertex_positions, size_t vertex_count,
 
 	return extent;
 }
+
+#undef SIMD_SSE
+#undef SIMD_NEON
+#undef SIMD_WASM
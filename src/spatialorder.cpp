@@ -7,6 +7,7 @@
 
 // This work is based on:
 // Fabian Giesen. Decoding Morton codes. 2009
+// Pierre Terdiman. Radix Sort Revisited. 2000
 namespace meshopt
 {
 
@@ -21,6 +22,18 @@ inline unsigned int part1By2(unsigned int x)
 	return x;
 }
 
+// "Insert" two 0 bits after each of the 21 low bits of x
+inline unsigned long long part1By2_64(unsigned long long x)
+{
+	x &= 0x1fffffull;
+	x = (x ^ (x << 32)) & 0x1f00000000ffffull;
+	x = (x ^ (x << 16)) & 0x1f0000ff0000ffull;
+	x = (x ^ (x << 8)) & 0x100f00f00f00f00full;
+	x = (x ^ (x << 4)) & 0x10c30c30c30c30c3ull;
+	x = (x ^ (x << 2)) & 0x1249249249249249ull;
+	return x;
+}
+
 static void computeOrder(unsigned int* result, const float* vertex_positions_data, size_t vertex_count, size_t vertex_positions_stride)
 {
 	size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
@@ -107,12 +120,154 @@ static void radixPass(unsigned int* destination, const unsigned int* source, con
 	}
 }
 
+// 63-bit keys are sorted using 6 11-bit passes; each task processes a chunk of points, and histograms are collected per chunk
+const int kSortBits = 11;
+const int kSortPasses = 6;
+const size_t kSortBuckets = 1 << kSortBits;
+const size_t kSortChunkSize = 65536;
+
+struct SortTask
+{
+	const float* vertex_positions;
+	size_t vertex_stride_float;
+	size_t vertex_count;
+
+	float* chunk_bounds;
+	float minv[3];
+	float scale;
+
+	unsigned long long* keys[2];
+	unsigned int* ids[2];
+	unsigned int* hist;
+	int pass;
+
+	unsigned int* destination;
+};
+
+static void sortBoundsTask(void* context, size_t chunk)
+{
+	SortTask& t = *static_cast<SortTask*>(context);
+
+	size_t begin = chunk * kSortChunkSize;
+	size_t end = begin + kSortChunkSize < t.vertex_count ? begin + kSortChunkSize : t.vertex_count;
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v = t.vertex_positions + i * t.vertex_stride_float;
+
+		for (int j = 0; j < 3; ++j)
+		{
+			float vj = v[j];
+
+			minv[j] = minv[j] > vj ? vj : minv[j];
+			maxv[j] = maxv[j] < vj ? vj : maxv[j];
+		}
+	}
+
+	memcpy(&t.chunk_bounds[chunk * 6 + 0], minv, 3 * sizeof(float));
+	memcpy(&t.chunk_bounds[chunk * 6 + 3], maxv, 3 * sizeof(float));
+}
+
+static void sortKeysTask(void* context, size_t chunk)
+{
+	SortTask& t = *static_cast<SortTask*>(context);
+
+	size_t begin = chunk * kSortChunkSize;
+	size_t end = begin + kSortChunkSize < t.vertex_count ? begin + kSortChunkSize : t.vertex_count;
+
+	const int limit = (1 << 21) - 1;
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const float* v = t.vertex_positions + i * t.vertex_stride_float;
+
+		int x = int((v[0] - t.minv[0]) * t.scale * float(limit) + 0.5f);
+		int y = int((v[1] - t.minv[1]) * t.scale * float(limit) + 0.5f);
+		int z = int((v[2] - t.minv[2]) * t.scale * float(limit) + 0.5f);
+
+		// rounding can push the values slightly out of range
+		x = x > limit ? limit : x;
+		y = y > limit ? limit : y;
+		z = z > limit ? limit : z;
+
+		t.keys[0][i] = part1By2_64(x) | (part1By2_64(y) << 1) | (part1By2_64(z) << 2);
+		t.ids[0][i] = unsigned(i);
+	}
+}
+
+static void sortHistogramTask(void* context, size_t chunk)
+{
+	SortTask& t = *static_cast<SortTask*>(context);
+
+	size_t begin = chunk * kSortChunkSize;
+	size_t end = begin + kSortChunkSize < t.vertex_count ? begin + kSortChunkSize : t.vertex_count;
+
+	const unsigned long long* keys = t.keys[t.pass & 1];
+	unsigned int* hist = &t.hist[chunk * kSortBuckets];
+	int bitoff = t.pass * kSortBits;
+
+	memset(hist, 0, kSortBuckets * sizeof(unsigned int));
+
+	for (size_t i = begin; i < end; ++i)
+		hist[(keys[i] >> bitoff) & (kSortBuckets - 1)]++;
+}
+
+static void sortScatterTask(void* context, size_t chunk)
+{
+	SortTask& t = *static_cast<SortTask*>(context);
+
+	size_t begin = chunk * kSortChunkSize;
+	size_t end = begin + kSortChunkSize < t.vertex_count ? begin + kSortChunkSize : t.vertex_count;
+
+	const unsigned long long* keys = t.keys[t.pass & 1];
+	const unsigned int* ids = t.ids[t.pass & 1];
+	unsigned long long* keys_out = t.keys[(t.pass & 1) ^ 1];
+	unsigned int* ids_out = t.ids[(t.pass & 1) ^ 1];
+	unsigned int* offsets = &t.hist[chunk * kSortBuckets];
+	int bitoff = t.pass * kSortBits;
+
+	// scattering each chunk in order into a disjoint output range keeps the sort stable regardless of task scheduling
+	for (size_t i = begin; i < end; ++i)
+	{
+		unsigned int offset = offsets[(keys[i] >> bitoff) & (kSortBuckets - 1)]++;
+
+		keys_out[offset] = keys[i];
+		ids_out[offset] = ids[i];
+	}
+}
+
+static void sortRemapTask(void* context, size_t chunk)
+{
+	SortTask& t = *static_cast<SortTask*>(context);
+
+	size_t begin = chunk * kSortChunkSize;
+	size_t end = begin + kSortChunkSize < t.vertex_count ? begin + kSortChunkSize : t.vertex_count;
+
+	// since our remap table is mapping old=>new, we need to reverse the sorted order
+	for (size_t i = begin; i < end; ++i)
+		t.destination[t.ids[0][i]] = unsigned(i);
+}
+
+static void runSortTasks(meshopt_ParallelFor parallel_for, void* context, void (*task)(void*, size_t), SortTask* task_context, size_t count)
+{
+	if (parallel_for && count > 1)
+		parallel_for(context, task, task_context, count);
+	else
+		for (size_t i = 0; i < count; ++i)
+			task(task_context, i);
+}
+
 } // namespace meshopt
 
 void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_spatialSortRemap");
+
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
 
@@ -139,10 +294,89 @@ void meshopt_spatialSortRemap(unsigned int* destination, const float* vertex_pos
 		destination[scratch[i]] = unsigned(i);
 }
 
+void meshopt_spatialSortRemapParallel(unsigned int* destination, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_spatialSortRemapParallel");
+
+	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+	assert(vertex_positions_stride % sizeof(float) == 0);
+
+	if (vertex_count == 0)
+		return;
+
+	meshopt_Allocator allocator;
+
+	size_t chunk_count = (vertex_count + kSortChunkSize - 1) / kSortChunkSize;
+
+	SortTask task = {};
+	task.vertex_positions = vertex_positions;
+	task.vertex_stride_float = vertex_positions_stride / sizeof(float);
+	task.vertex_count = vertex_count;
+
+	task.chunk_bounds = allocator.allocate<float>(chunk_count * 6);
+	runSortTasks(parallel_for, context, sortBoundsTask, &task, chunk_count);
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < chunk_count; ++i)
+		for (int j = 0; j < 3; ++j)
+		{
+			minv[j] = minv[j] > task.chunk_bounds[i * 6 + j] ? task.chunk_bounds[i * 6 + j] : minv[j];
+			maxv[j] = maxv[j] < task.chunk_bounds[i * 6 + 3 + j] ? task.chunk_bounds[i * 6 + 3 + j] : maxv[j];
+		}
+
+	float extent = 0.f;
+
+	extent = (maxv[0] - minv[0]) < extent ? extent : (maxv[0] - minv[0]);
+	extent = (maxv[1] - minv[1]) < extent ? extent : (maxv[1] - minv[1]);
+	extent = (maxv[2] - minv[2]) < extent ? extent : (maxv[2] - minv[2]);
+
+	memcpy(task.minv, minv, sizeof(minv));
+	task.scale = extent == 0 ? 0.f : 1.f / extent;
+
+	// destination doubles as a scratch buffer for sorted ids; after an even number of passes, the sorted order is back in ids[0]
+	task.keys[0] = allocator.allocate<unsigned long long>(vertex_count);
+	task.keys[1] = allocator.allocate<unsigned long long>(vertex_count);
+	task.ids[0] = allocator.allocate<unsigned int>(vertex_count);
+	task.ids[1] = destination;
+	task.hist = allocator.allocate<unsigned int>(chunk_count * kSortBuckets);
+	task.destination = destination;
+
+	runSortTasks(parallel_for, context, sortKeysTask, &task, chunk_count);
+
+	for (int pass = 0; pass < kSortPasses; ++pass)
+	{
+		task.pass = pass;
+		runSortTasks(parallel_for, context, sortHistogramTask, &task, chunk_count);
+
+		// convert per-chunk histograms to output offsets; buckets are laid out in key order, and chunks are laid out in order within each bucket
+		unsigned int sum = 0;
+
+		for (size_t b = 0; b < kSortBuckets; ++b)
+			for (size_t i = 0; i < chunk_count; ++i)
+			{
+				unsigned int h = task.hist[i * kSortBuckets + b];
+				task.hist[i * kSortBuckets + b] = sum;
+				sum += h;
+			}
+
+		assert(sum == vertex_count);
+
+		runSortTasks(parallel_for, context, sortScatterTask, &task, chunk_count);
+	}
+
+	runSortTasks(parallel_for, context, sortRemapTask, &task, chunk_count);
+}
+
 void meshopt_spatialSortTriangles(unsigned int* destination, const unsigned int* indices, size_t index_count, const float* vertex_positions, size_t vertex_count, size_t vertex_positions_stride)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_spatialSortTriangles");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
 	assert(vertex_positions_stride % sizeof(float) == 0);
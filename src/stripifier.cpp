@@ -51,6 +51,8 @@ static int findStripNext(const unsigned int buffer[][3], unsigned int buffer_siz
 
 size_t meshopt_stripify(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int restart_index)
 {
+	meshopt_Instrument instrument("meshopt_stripify");
+
 	assert(destination != indices);
 	assert(index_count % 3 == 0);
 
@@ -252,6 +254,8 @@ size_t meshopt_stripifyBound(size_t index_count)
 
 size_t meshopt_unstripify(unsigned int* destination, const unsigned int* indices, size_t index_count, unsigned int restart_index)
 {
+	meshopt_Instrument instrument("meshopt_unstripify");
+
 	assert(destination != indices);
 
 	size_t offset = 0;
@@ -6,6 +6,8 @@
 
 meshopt_VertexCacheStatistics meshopt_analyzeVertexCache(const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size, unsigned int warp_size, unsigned int primgroup_size)
 {
+	meshopt_Instrument instrument("meshopt_analyzeVertexCache");
+
 	assert(index_count % 3 == 0);
 	assert(cache_size >= 3);
 	assert(warp_size == 0 || warp_size >= 3);
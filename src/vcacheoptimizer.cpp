@@ -2,6 +2,7 @@
 #include "meshoptimizer.h"
 
 #include <assert.h>
+#include <float.h>
 #include <string.h>
 
 // This work is based on:
@@ -34,7 +35,7 @@ static const VertexScoreTable kVertexScoreTableStrip = {
 struct TriangleAdjacency
 {
 	unsigned int* counts;
-	unsigned int* offsets;
+	const unsigned int* offsets;
 	unsigned int* data;
 };
 
@@ -44,7 +45,8 @@ static void buildTriangleAdjacency(TriangleAdjacency& adjacency, const unsigned
 
 	// allocate arrays
 	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
-	adjacency.offsets = allocator.allocate<unsigned int>(vertex_count);
+	unsigned int* offsets = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = offsets;
 	adjacency.data = allocator.allocate<unsigned int>(index_count);
 
 	// fill triangle counts
@@ -62,7 +64,7 @@ static void buildTriangleAdjacency(TriangleAdjacency& adjacency, const unsigned
 
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		adjacency.offsets[i] = offset;
+		offsets[i] = offset;
 		offset += adjacency.counts[i];
 	}
 
@@ -73,20 +75,35 @@ static void buildTriangleAdjacency(TriangleAdjacency& adjacency, const unsigned
 	{
 		unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
 
-		adjacency.data[adjacency.offsets[a]++] = unsigned(i);
-		adjacency.data[adjacency.offsets[b]++] = unsigned(i);
-		adjacency.data[adjacency.offsets[c]++] = unsigned(i);
+		adjacency.data[offsets[a]++] = unsigned(i);
+		adjacency.data[offsets[b]++] = unsigned(i);
+		adjacency.data[offsets[c]++] = unsigned(i);
 	}
 
 	// fix offsets that have been disturbed by the previous pass
 	for (size_t i = 0; i < vertex_count; ++i)
 	{
-		assert(adjacency.offsets[i] >= adjacency.counts[i]);
+		assert(offsets[i] >= adjacency.counts[i]);
 
-		adjacency.offsets[i] -= adjacency.counts[i];
+		offsets[i] -= adjacency.counts[i];
 	}
 }
 
+static void copyTriangleAdjacency(TriangleAdjacency& adjacency, const meshopt_TriangleAdjacency& source, size_t index_count, size_t vertex_count, meshopt_Allocator& allocator)
+{
+	assert(source.index_count == index_count && source.vertex_count == vertex_count);
+
+	// offsets are shared with the source; counts and data are modified by the caller as triangles are emitted
+	adjacency.counts = allocator.allocate<unsigned int>(vertex_count);
+	adjacency.offsets = source.offsets;
+	adjacency.data = allocator.allocate<unsigned int>(index_count);
+
+	for (size_t i = 0; i < vertex_count; ++i)
+		adjacency.counts[i] = source.offsets[i + 1] - source.offsets[i];
+
+	memcpy(adjacency.data, source.data, index_count * sizeof(unsigned int));
+}
+
 static unsigned int getNextVertexDeadEnd(const unsigned int* dead_end, unsigned int& dead_end_top, unsigned int& input_cursor, const unsigned int* live_triangles, size_t vertex_count)
 {
 	// check dead-end stack
@@ -164,28 +181,8 @@ static unsigned int getNextTriangleDeadEnd(unsigned int& input_cursor, const uns
 	return ~0u;
 }
 
-} // namespace meshopt
-
-void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt::VertexScoreTable* table)
+static void optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const VertexScoreTable* table, const meshopt_TriangleAdjacency* shared_adjacency, meshopt_Allocator& allocator)
 {
-	using namespace meshopt;
-
-	assert(index_count % 3 == 0);
-
-	meshopt_Allocator allocator;
-
-	// guard for empty meshes
-	if (index_count == 0 || vertex_count == 0)
-		return;
-
-	// support in-place optimization
-	if (destination == indices)
-	{
-		unsigned int* indices_copy = allocator.allocate<unsigned int>(index_count);
-		memcpy(indices_copy, indices, index_count * sizeof(unsigned int));
-		indices = indices_copy;
-	}
-
 	unsigned int cache_size = 16;
 	assert(cache_size <= kCacheSizeMax);
 
@@ -193,7 +190,10 @@ void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned
 
 	// build adjacency information
 	TriangleAdjacency adjacency = {};
-	buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
+	if (shared_adjacency)
+		copyTriangleAdjacency(adjacency, *shared_adjacency, index_count, vertex_count, allocator);
+	else
+		buildTriangleAdjacency(adjacency, indices, index_count, vertex_count, allocator);
 
 	// live triangle counts; note, we alias adjacency.counts as we remove triangles after emitting them so the counts always match
 	unsigned int* live_triangles = adjacency.counts;
@@ -342,20 +342,350 @@ void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned
 	assert(output_triangle == face_count);
 }
 
+struct ChunkRemapHasher
+{
+	const unsigned int* remap;
+
+	size_t hash(unsigned int id) const
+	{
+		return id * 0x5bd1e995;
+	}
+
+	bool equal(unsigned int lhs, unsigned int rhs) const
+	{
+		return remap[lhs] == rhs;
+	}
+};
+
+static void selectTriangles(unsigned int* faces, size_t count, size_t nth, const float* centroids, int axis)
+{
+	size_t left = 0, right = count;
+
+	// quickselect with three-way partitioning to handle duplicate keys gracefully
+	while (right - left > 1)
+	{
+		float pivot = centroids[faces[left + (right - left) / 2] * 3 + axis];
+
+		size_t lt = left, gt = right;
+		for (size_t i = left; i < gt;)
+		{
+			float v = centroids[faces[i] * 3 + axis];
+
+			if (v < pivot)
+			{
+				unsigned int t = faces[lt];
+				faces[lt++] = faces[i];
+				faces[i++] = t;
+			}
+			else if (v > pivot)
+			{
+				unsigned int t = faces[--gt];
+				faces[gt] = faces[i];
+				faces[i] = t;
+			}
+			else
+				i++;
+		}
+
+		if (nth < lt)
+			right = lt;
+		else if (nth >= gt)
+			left = gt;
+		else
+			break;
+	}
+}
+
+static void partitionTriangles(unsigned int* chunks, unsigned int* faces, size_t count, const float* centroids, size_t chunk_size, unsigned int chunk_offset)
+{
+	if (count <= chunk_size)
+	{
+		for (size_t i = 0; i < count; ++i)
+			chunks[faces[i]] = chunk_offset;
+
+		return;
+	}
+
+	float minv[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+	float maxv[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+	for (size_t i = 0; i < count; ++i)
+		for (int k = 0; k < 3; ++k)
+		{
+			float v = centroids[faces[i] * 3 + k];
+			minv[k] = minv[k] < v ? minv[k] : v;
+			maxv[k] = maxv[k] > v ? maxv[k] : v;
+		}
+
+	int axis = 0;
+	for (int k = 1; k < 3; ++k)
+		if (maxv[k] - minv[k] > maxv[axis] - minv[axis])
+			axis = k;
+
+	// split along the largest axis so that the left side gets a whole number of chunks
+	size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+	size_t split = (chunk_count / 2) * chunk_size;
+
+	selectTriangles(faces, count, split, centroids, axis);
+
+	partitionTriangles(chunks, faces, split, centroids, chunk_size, chunk_offset);
+	partitionTriangles(chunks, faces + split, count - split, centroids, chunk_size, chunk_offset + unsigned(chunk_count / 2));
+}
+
+static size_t countSharedVertices(const unsigned int* indices, size_t index_count, size_t chunk_size, unsigned int* marks, size_t vertex_count)
+{
+	memset(marks, -1, vertex_count * sizeof(unsigned int));
+
+	size_t result = 0;
+
+	// since chunks are processed in order, a vertex with a mark from a different chunk is shared with an earlier chunk
+	for (size_t i = 0; i < index_count; ++i)
+	{
+		unsigned int index = indices[i];
+		unsigned int chunk = unsigned(i / (chunk_size * 3));
+
+		result += marks[index] != chunk && marks[index] != ~0u;
+		marks[index] = chunk;
+	}
+
+	return result;
+}
+
+struct VertexCacheChunkTask
+{
+	unsigned int* destination;
+	const unsigned int* indices;
+	size_t index_count;
+	size_t vertex_count;
+	size_t chunk_size;
+	const VertexScoreTable* table;
+};
+
+static void optimizeVertexCacheChunkTask(void* context, size_t chunk)
+{
+	const VertexCacheChunkTask& t = *static_cast<VertexCacheChunkTask*>(context);
+
+	size_t begin = chunk * t.chunk_size * 3;
+	size_t end = begin + t.chunk_size * 3 < t.index_count ? begin + t.chunk_size * 3 : t.index_count;
+	size_t chunk_indices = end - begin;
+
+	meshopt_Allocator allocator;
+
+	// remap chunk vertices to a compact range so that per-vertex state is proportional to chunk size, not mesh size
+	unsigned int* remap = allocator.allocate<unsigned int>(chunk_indices);
+	unsigned int* local = allocator.allocate<unsigned int>(chunk_indices);
+
+	size_t table_size = meshopt_hashBuckets(chunk_indices);
+	unsigned int* table = allocator.allocate<unsigned int>(table_size);
+	memset(table, -1, table_size * sizeof(unsigned int));
+
+	ChunkRemapHasher hasher = {remap};
+	size_t hashmod = table_size - 1;
+	size_t local_count = 0;
+
+	for (size_t i = 0; i < chunk_indices; ++i)
+	{
+		unsigned int index = t.indices[begin + i];
+		assert(index < t.vertex_count);
+
+		size_t bucket = hasher.hash(index) & hashmod;
+
+		// quadratic probing; the table is never full since it has more buckets than indices
+		for (size_t probe = 0; table[bucket] != ~0u && !hasher.equal(table[bucket], index); ++probe)
+			bucket = (bucket + probe + 1) & hashmod;
+
+		if (table[bucket] == ~0u)
+		{
+			remap[local_count] = index;
+			table[bucket] = unsigned(local_count++);
+		}
+
+		local[i] = table[bucket];
+	}
+
+	allocator.deallocate(table);
+
+	unsigned int* result = allocator.allocate<unsigned int>(chunk_indices);
+	optimizeVertexCacheTable(result, local, chunk_indices, local_count, t.table, NULL, allocator);
+
+	for (size_t i = 0; i < chunk_indices; ++i)
+		t.destination[begin + i] = remap[result[i]];
+}
+
+static void optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const VertexScoreTable* table, const meshopt_TriangleAdjacency* adjacency, void* scratch, size_t scratch_size)
+{
+	assert(index_count % 3 == 0);
+
+	meshopt_Allocator allocator(scratch, scratch_size);
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return;
+
+	// support in-place optimization
+	if (destination == indices)
+	{
+		unsigned int* indices_copy = allocator.allocate<unsigned int>(index_count);
+		memcpy(indices_copy, indices, index_count * sizeof(unsigned int));
+		indices = indices_copy;
+	}
+
+	optimizeVertexCacheTable(destination, indices, index_count, vertex_count, table, adjacency, allocator);
+}
+
+} // namespace meshopt
+
 void meshopt_optimizeVertexCache(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
-	meshopt_optimizeVertexCacheTable(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTable);
+	meshopt_Instrument instrument("meshopt_optimizeVertexCache");
+
+	meshopt::optimizeVertexCache(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTable, NULL, NULL, 0);
+}
+
+void meshopt_optimizeVertexCacheWithScores(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const float* cache_scores, const float* live_scores)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheWithScores");
+
+	// scores for vertices that are not in cache and don't have live triangles are always 0
+	VertexScoreTable table = {};
+	memcpy(table.cache + 1, cache_scores, kCacheSizeMax * sizeof(float));
+	memcpy(table.live + 1, live_scores, kValenceMax * sizeof(float));
+
+	optimizeVertexCache(destination, indices, index_count, vertex_count, &table, NULL, NULL, 0);
+}
+
+void meshopt_optimizeVertexCacheParallel(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const float* vertex_positions, size_t vertex_positions_stride, size_t chunk_size, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheParallel");
+
+	assert(index_count % 3 == 0);
+	assert(chunk_size > 0);
+
+	meshopt_Allocator allocator;
+
+	// guard for empty meshes
+	if (index_count == 0 || vertex_count == 0)
+		return;
+
+	size_t face_count = index_count / 3;
+	size_t chunk_count = (face_count + chunk_size - 1) / chunk_size;
+
+	// copy indices to support in-place optimization
+	unsigned int* sorted = allocator.allocate<unsigned int>(index_count);
+
+	if (vertex_positions && chunk_count > 1)
+	{
+		assert(vertex_positions_stride >= 12 && vertex_positions_stride <= 256);
+		assert(vertex_positions_stride % sizeof(float) == 0);
+
+		size_t vertex_stride_float = vertex_positions_stride / sizeof(float);
+
+		float* centroids = allocator.allocate<float>(face_count * 3);
+
+		for (size_t i = 0; i < face_count; ++i)
+		{
+			unsigned int a = indices[i * 3 + 0], b = indices[i * 3 + 1], c = indices[i * 3 + 2];
+			assert(a < vertex_count && b < vertex_count && c < vertex_count);
+
+			const float* va = vertex_positions + a * vertex_stride_float;
+			const float* vb = vertex_positions + b * vertex_stride_float;
+			const float* vc = vertex_positions + c * vertex_stride_float;
+
+			centroids[i * 3 + 0] = (va[0] + vb[0] + vc[0]) / 3.f;
+			centroids[i * 3 + 1] = (va[1] + vb[1] + vc[1]) / 3.f;
+			centroids[i * 3 + 2] = (va[2] + vb[2] + vc[2]) / 3.f;
+		}
+
+		unsigned int* faces = allocator.allocate<unsigned int>(face_count);
+		for (size_t i = 0; i < face_count; ++i)
+			faces[i] = unsigned(i);
+
+		// median splits produce box-shaped chunks with short boundaries; within a chunk triangles keep their input order, which the optimizer relies on to pick a new triangle at dead ends
+		unsigned int* chunks = allocator.allocate<unsigned int>(face_count);
+		partitionTriangles(chunks, faces, face_count, centroids, chunk_size, 0);
+
+		size_t* offsets = allocator.allocate<size_t>(chunk_count);
+		for (size_t i = 0; i < chunk_count; ++i)
+			offsets[i] = i * chunk_size;
+
+		for (size_t i = 0; i < face_count; ++i)
+		{
+			size_t target = offsets[chunks[i]]++;
+
+			sorted[target * 3 + 0] = indices[i * 3 + 0];
+			sorted[target * 3 + 1] = indices[i * 3 + 1];
+			sorted[target * 3 + 2] = indices[i * 3 + 2];
+		}
+
+		// ragged boundaries of spatial chunks cost the optimizer roughly as much as three extra shared vertices each, so coherent input order is kept unless spatial chunks share substantially fewer vertices
+		unsigned int* marks = allocator.allocate<unsigned int>(vertex_count);
+
+		size_t spatial_shared = countSharedVertices(sorted, index_count, chunk_size, marks, vertex_count);
+		size_t input_shared = countSharedVertices(indices, index_count, chunk_size, marks, vertex_count);
+
+		if (input_shared <= spatial_shared * 4)
+			memcpy(sorted, indices, index_count * sizeof(unsigned int));
+	}
+	else
+		memcpy(sorted, indices, index_count * sizeof(unsigned int));
+
+	VertexCacheChunkTask task = {destination, sorted, index_count, vertex_count, chunk_size, &kVertexScoreTable};
+
+	if (parallel_for && chunk_count > 1)
+		parallel_for(context, optimizeVertexCacheChunkTask, &task, chunk_count);
+	else
+		for (size_t i = 0; i < chunk_count; ++i)
+			optimizeVertexCacheChunkTask(&task, i);
+}
+
+void meshopt_optimizeVertexCacheWithAdjacency(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt_TriangleAdjacency* adjacency)
+{
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheWithAdjacency");
+
+	meshopt::optimizeVertexCache(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTable, adjacency, NULL, 0);
+}
+
+size_t meshopt_optimizeVertexCacheScratchSize(size_t index_count, size_t vertex_count)
+{
+	// this mirrors allocations in optimizeVertexCache for in-place optimization; each allocation may need up to 15 bytes of alignment padding
+	size_t face_count = index_count / 3;
+	size_t result = 7 * 16;
+
+	// indices copy and adjacency
+	result += index_count * sizeof(unsigned int) * 2 + vertex_count * sizeof(unsigned int) * 2;
+
+	// emitted flags, vertex and triangle scores
+	result += face_count + vertex_count * sizeof(float) + face_count * sizeof(float);
+
+	return result;
+}
+
+void meshopt_optimizeVertexCacheWithScratch(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, void* scratch, size_t scratch_size)
+{
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheWithScratch");
+
+	assert(size_t(scratch) % 16 == 0);
+
+	meshopt::optimizeVertexCache(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTable, NULL, scratch, scratch_size);
 }
 
 void meshopt_optimizeVertexCacheStrip(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
-	meshopt_optimizeVertexCacheTable(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTableStrip);
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheStrip");
+
+	meshopt::optimizeVertexCache(destination, indices, index_count, vertex_count, &meshopt::kVertexScoreTableStrip, NULL, NULL, 0);
 }
 
 void meshopt_optimizeVertexCacheFifo(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, unsigned int cache_size)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_optimizeVertexCacheFifo");
+
 	assert(index_count % 3 == 0);
 	assert(cache_size >= 3);
 
@@ -90,14 +90,6 @@
 #include <wasm_simd128.h>
 #endif
 
-#ifndef TRACE
-#define TRACE 0
-#endif
-
-#if TRACE
-#include <stdio.h>
-#endif
-
 #ifdef SIMD_WASM
 #define wasmx_splat_v32x4(v, i) wasm_i32x4_shuffle(v, v, i, i, i, i)
 #define wasmx_unpacklo_v8x16(a, b) wasm_i8x16_shuffle(a, b, 0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23)
@@ -112,6 +104,7 @@ namespace meshopt
 {
 
 const unsigned char kVertexHeader = 0xa0;
+const unsigned char kVertexChunkHeader = 0xb0;
 
 static int gEncodeVertexVersion = 0;
 
@@ -120,6 +113,7 @@ const size_t kVertexBlockMaxSize = 256;
 const size_t kByteGroupSize = 16;
 const size_t kByteGroupDecodeLimit = 24;
 const size_t kTailMaxSize = 32;
+const size_t kChunkTableOffset = 5;
 
 static size_t getVertexBlockSize(size_t vertex_size)
 {
@@ -143,7 +137,7 @@ inline unsigned char unzigzag8(unsigned char v)
 	return -(v & 1) ^ (v >> 1);
 }
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 struct Stats
 {
 	size_t size;
@@ -152,10 +146,26 @@ struct Stats
 	size_t bitc[8]; // bit consistency: how many bits are shared between all bytes in a group
 };
 
-static Stats* bytestats = NULL;
-static Stats vertexstats[256];
+// statistics are collected per call on the calling thread, and only while an event callback is set
+static MESHOPTIMIZER_THREAD_LOCAL Stats* bytestats = NULL;
+static MESHOPTIMIZER_THREAD_LOCAL Stats* vertexstats = NULL;
+
+struct StatsScope
+{
+	StatsScope(Stats* stats)
+	{
+		vertexstats = stats;
+	}
+
+	~StatsScope()
+	{
+		vertexstats = NULL;
+	}
+};
 #endif
 
+// the scalar encoder is only used when SIMD is unavailable and to collect instrumentation statistics
+#if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_AVX) && !defined(SIMD_WASM)) || MESHOPTIMIZER_INSTRUMENTATION
 static bool encodeBytesGroupZero(const unsigned char* buffer)
 {
 	for (size_t i = 0; i < kByteGroupSize; ++i)
@@ -278,13 +288,15 @@ static unsigned char* encodeBytes(unsigned char* data, unsigned char* data_end,
 		assert(data + best_size == next);
 		data = next;
 
-#if TRACE
-		bytestats->bitg[bitslog2] += best_size;
+#if MESHOPTIMIZER_INSTRUMENTATION
+		if (bytestats)
+			bytestats->bitg[bitslog2] += best_size;
 #endif
 	}
 
-#if TRACE
-	bytestats->header += header_size;
+#if MESHOPTIMIZER_INSTRUMENTATION
+	if (bytestats)
+		bytestats->header += header_size;
 #endif
 
 	return data;
@@ -315,11 +327,11 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 			vertex_offset += vertex_size;
 		}
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 		const unsigned char* olddata = data;
-		bytestats = &vertexstats[k];
+		bytestats = vertexstats ? &vertexstats[k] : NULL;
 
-		for (size_t ig = 0; ig < vertex_count; ig += kByteGroupSize)
+		for (size_t ig = 0; ig < vertex_count && bytestats; ig += kByteGroupSize)
 		{
 			unsigned char last = (ig == 0) ? last_vertex[k] : vertex_data[vertex_size * (ig - 1) + k];
 			unsigned char delta = 0xff;
@@ -333,19 +345,23 @@ static unsigned char* encodeVertexBlock(unsigned char* data, unsigned char* data
 #endif
 
 		data = encodeBytes(data, data_end, buffer, (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1));
-		if (!data)
-			return NULL;
 
-#if TRACE
+#if MESHOPTIMIZER_INSTRUMENTATION
 		bytestats = NULL;
-		vertexstats[k].size += data - olddata;
+
+		if (vertexstats && data)
+			vertexstats[k].size += data - olddata;
 #endif
+
+		if (!data)
+			return NULL;
 	}
 
 	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
 
 	return data;
 }
+#endif
 
 #if defined(SIMD_FALLBACK) || (!defined(SIMD_SSE) && !defined(SIMD_NEON) && !defined(SIMD_AVX) && !defined(SIMD_WASM))
 static const unsigned char* decodeBytesGroup(const unsigned char* data, unsigned char* buffer, int bitslog2)
@@ -926,6 +942,15 @@ static __m128i unzigzag8(__m128i v)
 
 	return _mm_xor_si128(xl, xr);
 }
+
+SIMD_TARGET
+static __m128i zigzag8(__m128i v)
+{
+	__m128i xl = _mm_cmplt_epi8(v, _mm_setzero_si128());
+	__m128i xr = _mm_add_epi8(v, v);
+
+	return _mm_xor_si128(xl, xr);
+}
 #endif
 
 #ifdef SIMD_NEON
@@ -950,6 +975,14 @@ static uint8x16_t unzigzag8(uint8x16_t v)
 
 	return veorq_u8(xl, xr);
 }
+
+static uint8x16_t zigzag8(uint8x16_t v)
+{
+	uint8x16_t xl = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(v), 7));
+	uint8x16_t xr = vshlq_n_u8(v, 1);
+
+	return veorq_u8(xl, xr);
+}
 #endif
 
 #ifdef SIMD_WASM
@@ -975,6 +1008,15 @@ static v128_t unzigzag8(v128_t v)
 
 	return wasm_v128_xor(xl, xr);
 }
+
+SIMD_TARGET
+static v128_t zigzag8(v128_t v)
+{
+	v128_t xl = wasm_i8x16_shr(v, 7);
+	v128_t xr = wasm_i8x16_shl(v, 1);
+
+	return wasm_v128_xor(xl, xr);
+}
 #endif
 
 #if defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
@@ -1123,199 +1165,1078 @@ static const unsigned char* decodeVertexBlockSimd(const unsigned char* data, con
 }
 #endif
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-static unsigned int getCpuFeatures()
+#if defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
+inline unsigned int loadVertex4(const unsigned char* data)
 {
-	int cpuinfo[4] = {};
-#ifdef _MSC_VER
-	__cpuid(cpuinfo, 1);
-#else
-	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
-#endif
-	return cpuinfo[2];
+	unsigned int result;
+	memcpy(&result, data, 4);
+	return result;
 }
 
-static unsigned int cpuid = getCpuFeatures();
-#endif
+static unsigned char* encodeBytesGroupSentinels(unsigned char* data, const unsigned char* buffer, unsigned char sentinel)
+{
+	// variable portion: full byte for each out-of-range value; this stores all 16 bytes but only advances for out-of-range ones
+	for (size_t i = 0; i < kByteGroupSize; ++i)
+	{
+		*data = buffer[i];
+		data += buffer[i] >= sentinel;
+	}
 
-} // namespace meshopt
+	return data;
+}
+#endif
 
-size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+#if defined(SIMD_SSE) || defined(SIMD_AVX)
+SIMD_TARGET
+static void encodeBytesGroupMeasureSimd(const unsigned char* buffer, size_t sizes[4])
 {
-	using namespace meshopt;
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
+	__m128i zero = _mm_setzero_si128();
+	__m128i one = _mm_set1_epi8(1);
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	// v >= sentinel is computed as max(v, sentinel) == v; the resulting 0/1 bytes are summed with sad
+	__m128i m2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(3)), v), one);
+	__m128i m4 = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(15)), v), one);
 
-#if TRACE
-	memset(vertexstats, 0, sizeof(vertexstats));
-#endif
+	__m128i s2 = _mm_sad_epu8(m2, zero);
+	__m128i s4 = _mm_sad_epu8(m4, zero);
 
-	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+	sizes[0] = _mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) == 0xffff ? 0 : size_t(-1);
+	sizes[1] = 4 + _mm_cvtsi128_si32(s2) + _mm_extract_epi16(s2, 4);
+	sizes[2] = 8 + _mm_cvtsi128_si32(s4) + _mm_extract_epi16(s4, 4);
+	sizes[3] = kByteGroupSize;
+}
 
-	unsigned char* data = buffer;
-	unsigned char* data_end = buffer + buffer_size;
+SIMD_TARGET
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int bitslog2)
+{
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer));
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return 0;
+	switch (bitslog2)
+	{
+	case 0:
+		return data;
 
-	int version = gEncodeVertexVersion;
+	case 1:
+	{
+		// pack pairs of 2-bit values within 16-bit lanes, and then pairs of 4-bit values within 32-bit lanes
+		__m128i e = _mm_min_epu8(v, _mm_set1_epi8(3));
+		__m128i t = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(e, 2), _mm_srli_epi16(e, 8)), _mm_set1_epi16(0xff));
+		__m128i u = _mm_and_si128(_mm_or_si128(_mm_slli_epi32(t, 4), _mm_srli_epi32(t, 16)), _mm_set1_epi32(0xff));
+		__m128i r = _mm_packus_epi16(_mm_packs_epi32(u, u), u);
 
-	*data++ = (unsigned char)(kVertexHeader | version);
+		int result = _mm_cvtsi128_si32(r);
+		memcpy(data, &result, 4);
 
-	unsigned char first_vertex[256] = {};
-	if (vertex_count > 0)
-		memcpy(first_vertex, vertex_data, vertex_size);
+		return encodeBytesGroupSentinels(data + 4, buffer, 3);
+	}
 
-	unsigned char last_vertex[256] = {};
-	memcpy(last_vertex, first_vertex, vertex_size);
+	case 2:
+	{
+		// pack pairs of 4-bit values within 16-bit lanes
+		__m128i e = _mm_min_epu8(v, _mm_set1_epi8(15));
+		__m128i t = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(e, 4), _mm_srli_epi16(e, 8)), _mm_set1_epi16(0xff));
+		__m128i r = _mm_packus_epi16(t, t);
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(data), r);
 
-	size_t vertex_offset = 0;
+		return encodeBytesGroupSentinels(data + 8, buffer, 15);
+	}
 
-	while (vertex_offset < vertex_count)
-	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+	case 3:
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data), v);
 
-		data = encodeVertexBlock(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return 0;
+		return data + 16;
 
-		vertex_offset += block_size;
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
 	}
+}
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+SIMD_TARGET
+static void encodeDeltas4Simd(unsigned char* buffer, size_t buffer_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char last_vertex[4])
+{
+	assert(vertex_count % 16 == 0);
 
-	if (size_t(data_end - data) < tail_size)
-		return 0;
+	__m128i pi = _mm_slli_si128(_mm_cvtsi32_si128(loadVertex4(last_vertex)), 12);
 
-	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
-	if (vertex_size < kTailMaxSize)
+	for (size_t j = 0; j < vertex_count; j += 16)
 	{
-		memset(data, 0, kTailMaxSize - vertex_size);
-		data += kTailMaxSize - vertex_size;
+		__m128i r[4];
+
+		for (int i = 0; i < 4; ++i)
+		{
+			const unsigned char* p = vertex_data + (j + i * 4) * vertex_size;
+
+			__m128i v = _mm_setr_epi32(loadVertex4(p), loadVertex4(p + vertex_size), loadVertex4(p + vertex_size * 2), loadVertex4(p + vertex_size * 3));
+			__m128i pv = _mm_or_si128(_mm_slli_si128(v, 4), _mm_srli_si128(pi, 12));
+
+			r[i] = zigzag8(_mm_sub_epi8(v, pv));
+			pi = v;
+		}
+
+		// transposing twice converts 4 registers with 4 vertices each into 4 registers with 16 bytes of each channel
+		transpose8(r[0], r[1], r[2], r[3]);
+		transpose8(r[0], r[1], r[2], r[3]);
+
+		for (int i = 0; i < 4; ++i)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + j + i * buffer_stride), r[i]);
 	}
+}
+#endif
 
-	memcpy(data, first_vertex, vertex_size);
-	data += vertex_size;
+#ifdef SIMD_NEON
+static size_t encodeBytesGroupCount(uint8x16_t m)
+{
+	// pairwise additions are used instead of vaddvq_u8 to stay compatible with ARMv7
+	uint64x2_t s = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(m)));
 
-	assert(data >= buffer + tail_size);
-	assert(data <= buffer + buffer_size);
+	return size_t(vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1));
+}
+
+static void encodeBytesGroupMeasureSimd(const unsigned char* buffer, size_t sizes[4])
+{
+	uint8x16_t v = vld1q_u8(buffer);
+	uint8x16_t one = vdupq_n_u8(1);
 
-#if TRACE
-	size_t total_size = data - buffer;
+	uint8x16_t mz = vandq_u8(vtstq_u8(v, v), one);
+	uint8x16_t m2 = vandq_u8(vcgeq_u8(v, vdupq_n_u8(3)), one);
+	uint8x16_t m4 = vandq_u8(vcgeq_u8(v, vdupq_n_u8(15)), one);
 
-	for (size_t k = 0; k < vertex_size; ++k)
+	sizes[0] = encodeBytesGroupCount(mz) == 0 ? 0 : size_t(-1);
+	sizes[1] = 4 + encodeBytesGroupCount(m2);
+	sizes[2] = 8 + encodeBytesGroupCount(m4);
+	sizes[3] = kByteGroupSize;
+}
+
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int bitslog2)
+{
+	uint8x16_t v = vld1q_u8(buffer);
+
+	switch (bitslog2)
 	{
-		const Stats& vsk = vertexstats[k];
+	case 0:
+		return data;
+
+	case 1:
+	{
+		// pack pairs of 2-bit values within 16-bit lanes, and then pairs of 4-bit values within 32-bit lanes
+		uint16x8_t e = vreinterpretq_u16_u8(vminq_u8(v, vdupq_n_u8(3)));
+		uint16x8_t t = vandq_u16(vorrq_u16(vshlq_n_u16(e, 2), vshrq_n_u16(e, 8)), vdupq_n_u16(0xff));
+		uint32x4_t x = vreinterpretq_u32_u16(t);
+		uint16x4_t u = vmovn_u32(vorrq_u32(vshlq_n_u32(x, 4), vshrq_n_u32(x, 16)));
+		uint8x8_t r = vmovn_u16(vcombine_u16(u, u));
+
+		vst1_lane_u32(reinterpret_cast<uint32_t*>(data), vreinterpret_u32_u8(r), 0);
 
-		printf("%2d: %7d bytes [%4.1f%%] %.1f bpv", int(k), int(vsk.size), double(vsk.size) / double(total_size) * 100, double(vsk.size) / double(vertex_count) * 8);
+		return encodeBytesGroupSentinels(data + 4, buffer, 3);
+	}
 
-		size_t total_k = vsk.header + vsk.bitg[0] + vsk.bitg[1] + vsk.bitg[2] + vsk.bitg[3];
+	case 2:
+	{
+		// pack pairs of 4-bit values within 16-bit lanes
+		uint16x8_t e = vreinterpretq_u16_u8(vminq_u8(v, vdupq_n_u8(15)));
+		uint8x8_t r = vmovn_u16(vorrq_u16(vshlq_n_u16(e, 4), vshrq_n_u16(e, 8)));
 
-		printf(" |\thdr [%5.1f%%] bitg 1-3 [%4.1f%% %4.1f%% %4.1f%%]",
-		    double(vsk.header) / double(total_k) * 100, double(vsk.bitg[1]) / double(total_k) * 100,
-		    double(vsk.bitg[2]) / double(total_k) * 100, double(vsk.bitg[3]) / double(total_k) * 100);
+		vst1_u8(data, r);
 
-		printf(" |\tbitc [%3.0f%% %3.0f%% %3.0f%% %3.0f%% %3.0f%% %3.0f%% %3.0f%% %3.0f%%]",
-		    double(vsk.bitc[0]) / double(vertex_count) * 100, double(vsk.bitc[1]) / double(vertex_count) * 100,
-		    double(vsk.bitc[2]) / double(vertex_count) * 100, double(vsk.bitc[3]) / double(vertex_count) * 100,
-		    double(vsk.bitc[4]) / double(vertex_count) * 100, double(vsk.bitc[5]) / double(vertex_count) * 100,
-		    double(vsk.bitc[6]) / double(vertex_count) * 100, double(vsk.bitc[7]) / double(vertex_count) * 100);
-		printf("\n");
+		return encodeBytesGroupSentinels(data + 8, buffer, 15);
 	}
-#endif
 
-	return data - buffer;
+	case 3:
+		vst1q_u8(data, v);
+
+		return data + 16;
+
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
+	}
 }
 
-size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+static void encodeDeltas4Simd(unsigned char* buffer, size_t buffer_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char last_vertex[4])
 {
-	using namespace meshopt;
+	assert(vertex_count % 16 == 0);
 
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	uint8x16_t pi = vreinterpretq_u8_u32(vsetq_lane_u32(loadVertex4(last_vertex), vdupq_n_u32(0), 3));
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
-	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+	for (size_t j = 0; j < vertex_count; j += 16)
+	{
+		uint8x16_t r[4];
 
-	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
-	size_t vertex_block_data_size = vertex_block_size;
+		for (int i = 0; i < 4; ++i)
+		{
+			const unsigned char* p = vertex_data + (j + i * 4) * vertex_size;
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+			uint32x4_t vi = vdupq_n_u32(0);
+			vi = vsetq_lane_u32(loadVertex4(p), vi, 0);
+			vi = vsetq_lane_u32(loadVertex4(p + vertex_size), vi, 1);
+			vi = vsetq_lane_u32(loadVertex4(p + vertex_size * 2), vi, 2);
+			vi = vsetq_lane_u32(loadVertex4(p + vertex_size * 3), vi, 3);
 
-	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+			uint8x16_t v = vreinterpretq_u8_u32(vi);
+			uint8x16_t pv = vextq_u8(pi, v, 12);
+
+			r[i] = zigzag8(vsubq_u8(v, pv));
+			pi = v;
+		}
+
+		// transposing twice converts 4 registers with 4 vertices each into 4 registers with 16 bytes of each channel
+		transpose8(r[0], r[1], r[2], r[3]);
+		transpose8(r[0], r[1], r[2], r[3]);
+
+		for (int i = 0; i < 4; ++i)
+			vst1q_u8(buffer + j + i * buffer_stride, r[i]);
+	}
 }
+#endif
 
-void meshopt_encodeVertexVersion(int version)
+#ifdef SIMD_WASM
+SIMD_TARGET
+static void encodeBytesGroupMeasureSimd(const unsigned char* buffer, size_t sizes[4])
 {
-	assert(unsigned(version) <= 0);
+	v128_t v = wasm_v128_load(buffer);
 
-	meshopt::gEncodeVertexVersion = version;
+	sizes[0] = wasm_v128_any_true(v) ? size_t(-1) : 0;
+	sizes[1] = 4 + __builtin_popcount(wasm_i8x16_bitmask(wasm_u8x16_ge(v, wasm_i8x16_splat(3))));
+	sizes[2] = 8 + __builtin_popcount(wasm_i8x16_bitmask(wasm_u8x16_ge(v, wasm_i8x16_splat(15))));
+	sizes[3] = kByteGroupSize;
 }
 
-int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+SIMD_TARGET
+static unsigned char* encodeBytesGroupSimd(unsigned char* data, const unsigned char* buffer, int bitslog2)
 {
-	using namespace meshopt;
-
-	assert(vertex_size > 0 && vertex_size <= 256);
-	assert(vertex_size % 4 == 0);
+	v128_t v = wasm_v128_load(buffer);
 
-	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = NULL;
+	switch (bitslog2)
+	{
+	case 0:
+		return data;
 
-#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
-	decode = (cpuid & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
-#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	decode = decodeVertexBlockSimd;
-#else
-	decode = decodeVertexBlock;
-#endif
+	case 1:
+	{
+		// pack pairs of 2-bit values within 16-bit lanes, and then pairs of 4-bit values within 32-bit lanes
+		v128_t e = wasm_u8x16_min(v, wasm_i8x16_splat(3));
+		v128_t t = wasm_v128_and(wasm_v128_or(wasm_i16x8_shl(e, 2), wasm_u16x8_shr(e, 8)), wasm_i16x8_splat(0xff));
+		v128_t u = wasm_v128_and(wasm_v128_or(wasm_i32x4_shl(t, 4), wasm_u32x4_shr(t, 16)), wasm_i32x4_splat(0xff));
+		v128_t n = wasm_u16x8_narrow_i32x4(u, u);
+		v128_t r = wasm_u8x16_narrow_i16x8(n, n);
 
-#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
-	assert(gDecodeBytesGroupInitialized);
-	(void)gDecodeBytesGroupInitialized;
-#endif
+		int result = wasm_i32x4_extract_lane(r, 0);
+		memcpy(data, &result, 4);
 
-	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+		return encodeBytesGroupSentinels(data + 4, buffer, 3);
+	}
 
-	const unsigned char* data = buffer;
-	const unsigned char* data_end = buffer + buffer_size;
+	case 2:
+	{
+		// pack pairs of 4-bit values within 16-bit lanes
+		v128_t e = wasm_u8x16_min(v, wasm_i8x16_splat(15));
+		v128_t t = wasm_v128_and(wasm_v128_or(wasm_i16x8_shl(e, 4), wasm_u16x8_shr(e, 8)), wasm_i16x8_splat(0xff));
+		v128_t r = wasm_u8x16_narrow_i16x8(t, t);
 
-	if (size_t(data_end - data) < 1 + vertex_size)
-		return -2;
+		long long result = wasm_i64x2_extract_lane(r, 0);
+		memcpy(data, &result, 8);
 
-	unsigned char data_header = *data++;
+		return encodeBytesGroupSentinels(data + 8, buffer, 15);
+	}
 
-	if ((data_header & 0xf0) != kVertexHeader)
-		return -1;
+	case 3:
+		wasm_v128_store(data, v);
 
-	int version = data_header & 0x0f;
-	if (version > 0)
-		return -1;
+		return data + 16;
 
-	unsigned char last_vertex[256];
-	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+	default:
+		assert(!"Unexpected bit length"); // unreachable since bitslog2 is a 2-bit value
+		return data;
+	}
+}
 
-	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+SIMD_TARGET
+static void encodeDeltas4Simd(unsigned char* buffer, size_t buffer_stride, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, const unsigned char last_vertex[4])
+{
+	assert(vertex_count % 16 == 0);
 
-	size_t vertex_offset = 0;
+	v128_t pi = wasm_i32x4_make(0, 0, 0, loadVertex4(last_vertex));
 
-	while (vertex_offset < vertex_count)
+	for (size_t j = 0; j < vertex_count; j += 16)
 	{
-		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+		v128_t r[4];
 
-		data = decode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
-		if (!data)
-			return -2;
+		for (int i = 0; i < 4; ++i)
+		{
+			const unsigned char* p = vertex_data + (j + i * 4) * vertex_size;
 
-		vertex_offset += block_size;
+			v128_t v = wasm_i32x4_make(loadVertex4(p), loadVertex4(p + vertex_size), loadVertex4(p + vertex_size * 2), loadVertex4(p + vertex_size * 3));
+			v128_t pv = wasm_i32x4_shuffle(pi, v, 3, 4, 5, 6);
+
+			r[i] = zigzag8(wasm_i8x16_sub(v, pv));
+			pi = v;
+		}
+
+		// transposing twice converts 4 registers with 4 vertices each into 4 registers with 16 bytes of each channel
+		transpose8(r[0], r[1], r[2], r[3]);
+		transpose8(r[0], r[1], r[2], r[3]);
+
+		for (int i = 0; i < 4; ++i)
+			wasm_v128_store(buffer + j + i * buffer_stride, r[i]);
 	}
+}
+#endif
 
-	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+#if defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
+SIMD_TARGET
+static unsigned char* encodeBytesSimd(unsigned char* data, unsigned char* data_end, const unsigned char* buffer, size_t buffer_size)
+{
+	assert(buffer_size % kByteGroupSize == 0);
+	assert(kByteGroupSize == 16);
 
-	if (size_t(data_end - data) != tail_size)
-		return -3;
+	unsigned char* header = data;
+
+	// round number of groups to 4 to get number of header bytes
+	size_t header_size = (buffer_size / kByteGroupSize + 3) / 4;
+
+	if (size_t(data_end - data) < header_size)
+		return NULL;
+
+	data += header_size;
+
+	memset(header, 0, header_size);
+
+	for (size_t i = 0; i < buffer_size; i += kByteGroupSize)
+	{
+		if (size_t(data_end - data) < kByteGroupDecodeLimit)
+			return NULL;
+
+		size_t sizes[4];
+		encodeBytesGroupMeasureSimd(buffer + i, sizes);
+
+		// note: this must pick the same encoding as encodeBytes for the output to be identical
+		int bitslog2 = 3;
+
+		for (int k = 0; k < 3; ++k)
+			if (sizes[k] < sizes[bitslog2])
+				bitslog2 = k;
+
+		size_t header_offset = i / kByteGroupSize;
+
+		header[header_offset / 4] |= bitslog2 << ((header_offset % 4) * 2);
+
+		unsigned char* next = encodeBytesGroupSimd(data, buffer + i, bitslog2);
+
+		assert(data + sizes[bitslog2] == next);
+		data = next;
+	}
+
+	return data;
+}
+
+SIMD_TARGET
+static unsigned char* encodeVertexBlockSimd(unsigned char* data, unsigned char* data_end, const unsigned char* vertex_data, size_t vertex_count, size_t vertex_size, unsigned char last_vertex[256])
+{
+	assert(vertex_count > 0 && vertex_count <= kVertexBlockMaxSize);
+
+	unsigned char buffer[kVertexBlockMaxSize * 4];
+
+	size_t vertex_count_aligned = (vertex_count + kByteGroupSize - 1) & ~(kByteGroupSize - 1);
+	size_t vertex_count_simd = vertex_count & ~(kByteGroupSize - 1);
+
+	// we sometimes encode elements we didn't fill when rounding to kByteGroupSize
+	memset(buffer, 0, sizeof(buffer));
+
+	for (size_t k = 0; k < vertex_size; k += 4)
+	{
+		encodeDeltas4Simd(buffer, vertex_count_aligned, vertex_data + k, vertex_count_simd, vertex_size, last_vertex + k);
+
+		// the last partial group is encoded using scalar code to avoid reading past the end of vertex data
+		for (size_t i = vertex_count_simd; i < vertex_count; ++i)
+			for (size_t j = 0; j < 4; ++j)
+			{
+				unsigned char p = (i == 0) ? last_vertex[k + j] : vertex_data[(i - 1) * vertex_size + k + j];
+
+				buffer[i + j * vertex_count_aligned] = zigzag8((unsigned char)(vertex_data[i * vertex_size + k + j] - p));
+			}
+
+		for (size_t j = 0; j < 4; ++j)
+		{
+			data = encodeBytesSimd(data, data_end, buffer + j * vertex_count_aligned, vertex_count_aligned);
+			if (!data)
+				return NULL;
+		}
+	}
+
+	memcpy(last_vertex, &vertex_data[vertex_size * (vertex_count - 1)], vertex_size);
+
+	return data;
+}
+#endif
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+static unsigned int getCpuFeatures()
+{
+	int cpuinfo[4] = {};
+#ifdef _MSC_VER
+	__cpuid(cpuinfo, 1);
+#else
+	__cpuid(1, cpuinfo[0], cpuinfo[1], cpuinfo[2], cpuinfo[3]);
+#endif
+	return cpuinfo[2];
+}
+
+static unsigned int cpuid = getCpuFeatures();
+#endif
+
+static void writeU32(unsigned char* data, size_t v)
+{
+	data[0] = (unsigned char)(v & 0xff);
+	data[1] = (unsigned char)((v >> 8) & 0xff);
+	data[2] = (unsigned char)((v >> 16) & 0xff);
+	data[3] = (unsigned char)((v >> 24) & 0xff);
+}
+
+static size_t readU32(const unsigned char* data)
+{
+	return size_t(data[0]) | (size_t(data[1]) << 8) | (size_t(data[2]) << 16) | (size_t(data[3]) << 24);
+}
+
+struct DecodeBatchTask
+{
+	meshopt_DecodeItem* items;
+	const unsigned int* order;
+};
+
+static int decodeItem(const meshopt_DecodeItem& item)
+{
+	switch (item.mode)
+	{
+	case meshopt_DecodeModeAttributes:
+		return meshopt_decodeVertexBufferFiltered(item.destination, item.count, item.size, item.buffer, item.buffer_size, item.filter);
+
+	case meshopt_DecodeModeTriangles:
+		assert(item.filter == meshopt_DecodeFilterNone);
+		return meshopt_decodeIndexBuffer(item.destination, item.count, item.size, item.buffer, item.buffer_size);
+
+	case meshopt_DecodeModeIndices:
+		assert(item.filter == meshopt_DecodeFilterNone);
+		return meshopt_decodeIndexSequence(item.destination, item.count, item.size, item.buffer, item.buffer_size);
+
+	default:
+		assert(!"Unknown mode");
+		return -1;
+	}
+}
+
+static void decodeBatchItem(void* context, size_t i)
+{
+	const DecodeBatchTask& task = *static_cast<DecodeBatchTask*>(context);
+	meshopt_DecodeItem& item = task.items[task.order[i]];
+
+	item.result = decodeItem(item);
+}
+
+static void sortBatchItems(unsigned int* order, const meshopt_DecodeItem* items, size_t item_count)
+{
+	// decode time is roughly proportional to encoded size; we sort by log2 of the size in decreasing order which is enough to start large items first
+	unsigned int buckets[33] = {};
+
+	for (size_t i = 0; i < item_count; ++i)
+	{
+		unsigned int bucket = 0;
+		while (bucket < 32 && (items[i].buffer_size >> bucket) > 0)
+			bucket++;
+
+		buckets[32 - bucket]++;
+	}
+
+	unsigned int offset = 0;
+
+	for (size_t i = 0; i < 33; ++i)
+	{
+		unsigned int count = buckets[i];
+		buckets[i] = offset;
+		offset += count;
+	}
+
+	for (size_t i = 0; i < item_count; ++i)
+	{
+		unsigned int bucket = 0;
+		while (bucket < 32 && (items[i].buffer_size >> bucket) > 0)
+			bucket++;
+
+		order[buckets[32 - bucket]++] = unsigned(i);
+	}
+}
+
+static size_t encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, int version)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	meshopt_Allocator allocator;
+
+	Stats* stats = meshopt_Instrument::enabled() ? allocator.allocate<Stats>(256) : NULL;
+	StatsScope stats_scope(stats);
+
+	if (stats)
+		memset(stats, 0, sizeof(Stats) * 256);
+#endif
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	unsigned char* data = buffer;
+	unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return 0;
+
+	*data++ = (unsigned char)(kVertexHeader | version);
+
+	unsigned char first_vertex[256] = {};
+	if (vertex_count > 0)
+		memcpy(first_vertex, vertex_data, vertex_size);
+
+	unsigned char last_vertex[256] = {};
+	memcpy(last_vertex, first_vertex, vertex_size);
+
+	unsigned char* (*encode)(unsigned char*, unsigned char*, const unsigned char*, size_t, size_t, unsigned char[256]) = NULL;
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	encode = (cpuid & (1 << 9)) ? encodeVertexBlockSimd : encodeVertexBlock;
+#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	encode = encodeVertexBlockSimd;
+#else
+	encode = encodeVertexBlock;
+#endif
+
+	// the SIMD encoder produces the same output as the scalar one, but only the scalar one collects statistics
+#if MESHOPTIMIZER_INSTRUMENTATION
+	if (vertexstats)
+		encode = encodeVertexBlock;
+#endif
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		data = encode(data, data_end, vertex_data + vertex_offset * vertex_size, block_size, vertex_size, last_vertex);
+		if (!data)
+			return 0;
+
+		vertex_offset += block_size;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) < tail_size)
+		return 0;
+
+	// write first vertex to the end of the stream and pad it to 32 bytes; this is important to simplify bounds checks in decoder
+	if (vertex_size < kTailMaxSize)
+	{
+		memset(data, 0, kTailMaxSize - vertex_size);
+		data += kTailMaxSize - vertex_size;
+	}
+
+	memcpy(data, first_vertex, vertex_size);
+	data += vertex_size;
+
+	assert(data >= buffer + tail_size);
+	assert(data <= buffer + buffer_size);
+
+#if MESHOPTIMIZER_INSTRUMENTATION
+	// bitgroup_bytes is a histogram of bytes spent on groups encoded with 0/2/4/8 bits, indexed by vertex byte * 4 + bucket
+	// consistent_bits counts values in byte groups where bit j is the same for all values and the value before the group, indexed by vertex byte * 8 + j
+	for (size_t k = 0; k < vertex_size && vertexstats; ++k)
+	{
+		const Stats& vsk = vertexstats[k];
+
+		meshopt_Instrument::counter("bytes", double(vsk.size), int(k));
+		meshopt_Instrument::counter("header_bytes", double(vsk.header), int(k));
+
+		for (int j = 0; j < 4; ++j)
+			meshopt_Instrument::counter("bitgroup_bytes", double(vsk.bitg[j]), int(k * 4 + j));
+
+		for (int j = 0; j < 8; ++j)
+			meshopt_Instrument::counter("consistent_bits", double(vsk.bitc[j]), int(k * 8 + j));
+	}
+#endif
+
+	return data - buffer;
+}
+
+static unsigned char* getEncodeBuffer(meshopt_EncodeContext* context, size_t size)
+{
+	if (context->buffer_capacity < size)
+	{
+		if (context->buffer)
+			meshopt_Allocator::Storage::deallocate(context->buffer);
+
+		context->buffer = static_cast<unsigned char*>(meshopt_Allocator::Storage::allocate(size));
+		context->buffer_capacity = size;
+	}
+
+	return context->buffer;
+}
+
+static size_t encodeVertexBufferChunked(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, size_t chunk_size, int version)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(chunk_size > 0);
+
+	const unsigned char* vertex_data = static_cast<const unsigned char*>(vertices);
+
+	size_t chunk_count = (vertex_count + chunk_size - 1) / chunk_size;
+
+	// header byte, chunk size and chunk end offsets
+	size_t table_size = kChunkTableOffset + chunk_count * 4;
+
+	if (buffer_size < table_size || unsigned(chunk_size) != chunk_size)
+		return 0;
+
+	buffer[0] = (unsigned char)(kVertexChunkHeader | version);
+	writeU32(buffer + 1, chunk_size);
+
+	unsigned char* data = buffer + table_size;
+	unsigned char* data_end = buffer + buffer_size;
+
+	for (size_t i = 0; i < chunk_count; ++i)
+	{
+		size_t chunk_offset = i * chunk_size;
+		size_t chunk_vertices = (chunk_offset + chunk_size < vertex_count) ? chunk_size : vertex_count - chunk_offset;
+
+		// each chunk is a complete vertex stream so it starts from its own first vertex instead of the previous chunk's last vertex
+		size_t chunk_encoded = encodeVertexBuffer(data, data_end - data, vertex_data + chunk_offset * vertex_size, chunk_vertices, vertex_size, version);
+		if (!chunk_encoded)
+			return 0;
+
+		data += chunk_encoded;
+
+		size_t chunk_end = data - (buffer + table_size);
+		if (unsigned(chunk_end) != chunk_end)
+			return 0;
+
+		writeU32(buffer + kChunkTableOffset + i * 4, chunk_end);
+	}
+
+	return data - buffer;
+}
+
+} // namespace meshopt
+
+size_t meshopt_encodeVertexBuffer(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeVertexBuffer");
+
+	return encodeVertexBuffer(buffer, buffer_size, vertices, vertex_count, vertex_size, gEncodeVertexVersion);
+}
+
+size_t meshopt_encodeVertexBufferBound(size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+	size_t vertex_block_count = (vertex_count + vertex_block_size - 1) / vertex_block_size;
+
+	size_t vertex_block_header_size = (vertex_block_size / kByteGroupSize + 3) / 4;
+	size_t vertex_block_data_size = vertex_block_size;
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	return 1 + vertex_block_count * vertex_size * (vertex_block_header_size + vertex_block_data_size) + tail_size;
+}
+
+void meshopt_encodeVertexVersion(int version)
+{
+	assert(unsigned(version) <= 0);
+
+	meshopt::gEncodeVertexVersion = version;
+}
+
+void meshopt_encodeContextInit(meshopt_EncodeContext* context)
+{
+	context->vertex_version = 0;
+	context->index_version = 1;
+
+	context->buffer = NULL;
+	context->buffer_capacity = 0;
+	context->indices = NULL;
+	context->indices_capacity = 0;
+}
+
+void meshopt_encodeContextDestroy(meshopt_EncodeContext* context)
+{
+	if (context->buffer)
+		meshopt_Allocator::Storage::deallocate(context->buffer);
+
+	if (context->indices)
+		meshopt_Allocator::Storage::deallocate(context->indices);
+
+	meshopt_encodeContextInit(context);
+}
+
+size_t meshopt_encodeVertexBufferContext(meshopt_EncodeContext* context, const void* vertices, size_t vertex_count, size_t vertex_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeVertexBufferContext");
+
+	assert(unsigned(context->vertex_version) <= 0);
+
+	size_t bound = meshopt_encodeVertexBufferBound(vertex_count, vertex_size);
+	unsigned char* buffer = getEncodeBuffer(context, bound);
+
+	size_t result = encodeVertexBuffer(buffer, bound, vertices, vertex_count, vertex_size, context->vertex_version);
+	assert(result > 0);
+
+	return result;
+}
+
+int meshopt_decodeVertexBuffer(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size)
+{
+	meshopt_Instrument instrument("meshopt_decodeVertexBuffer");
+
+	return meshopt_decodeVertexBufferFiltered(destination, vertex_count, vertex_size, buffer, buffer_size, meshopt_DecodeFilterNone);
+}
+
+int meshopt_decodeVertexBufferFiltered(void* destination, size_t vertex_count, size_t vertex_size, const unsigned char* buffer, size_t buffer_size, enum meshopt_DecodeFilter filter)
+{
+	meshopt_Instrument instrument("meshopt_decodeVertexBufferFiltered");
+
+	return meshopt_decodeVertexBufferStrided(destination, vertex_count, vertex_size, vertex_size, buffer, buffer_size, filter);
+}
+
+int meshopt_decodeVertexBufferStrided(void* destination, size_t vertex_count, size_t vertex_size, size_t vertex_stride, const unsigned char* buffer, size_t buffer_size, enum meshopt_DecodeFilter filter)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeVertexBufferStrided");
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(vertex_stride >= vertex_size);
+
+	void (*filter_block)(void*, size_t, size_t) = NULL;
+
+	switch (filter)
+	{
+	case meshopt_DecodeFilterNone:
+		break;
+
+	case meshopt_DecodeFilterOct:
+		assert(vertex_size == 4 || vertex_size == 8);
+		filter_block = meshopt_decodeFilterOct;
+		break;
+
+	case meshopt_DecodeFilterQuat:
+		assert(vertex_size == 8);
+		filter_block = meshopt_decodeFilterQuat;
+		break;
+
+	case meshopt_DecodeFilterExp:
+		filter_block = meshopt_decodeFilterExp;
+		break;
+
+	default:
+		assert(!"Unknown filter");
+	}
+
+	const unsigned char* (*decode)(const unsigned char*, const unsigned char*, unsigned char*, size_t, size_t, unsigned char[256]) = NULL;
+
+#if defined(SIMD_SSE) && defined(SIMD_FALLBACK)
+	decode = (cpuid & (1 << 9)) ? decodeVertexBlockSimd : decodeVertexBlock;
+#elif defined(SIMD_SSE) || defined(SIMD_AVX) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	decode = decodeVertexBlockSimd;
+#else
+	decode = decodeVertexBlock;
+#endif
+
+#if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
+	assert(gDecodeBytesGroupInitialized);
+	(void)gDecodeBytesGroupInitialized;
+#endif
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	const unsigned char* data = buffer;
+	const unsigned char* data_end = buffer + buffer_size;
+
+	if (size_t(data_end - data) < 1 + vertex_size)
+		return -2;
+
+	unsigned char data_header = *data++;
+
+	if ((data_header & 0xf0) != kVertexHeader)
+		return -1;
+
+	int version = data_header & 0x0f;
+	if (version > 0)
+		return -1;
+
+	unsigned char last_vertex[256];
+	memcpy(last_vertex, data_end - vertex_size, vertex_size);
+
+	size_t vertex_block_size = getVertexBlockSize(vertex_size);
+
+	// strided or filtered output is decoded and filtered in a scratch block which is then copied to the destination, since filters work in place; this never reads destination memory
+	unsigned char scratch[kVertexBlockSizeBytes];
+	bool copy = vertex_stride != vertex_size || filter_block;
+
+	size_t vertex_offset = 0;
+
+	while (vertex_offset < vertex_count)
+	{
+		size_t block_size = (vertex_offset + vertex_block_size < vertex_count) ? vertex_block_size : vertex_count - vertex_offset;
+
+		unsigned char* block = copy ? scratch : vertex_data + vertex_offset * vertex_size;
+
+		data = decode(data, data_end, block, block_size, vertex_size, last_vertex);
+		if (!data)
+			return -2;
+
+		// filter the block while it's still in cache instead of doing a separate pass over the entire buffer
+		if (filter_block)
+			filter_block(block, block_size, vertex_size);
+
+		if (vertex_stride == vertex_size && copy)
+			memcpy(vertex_data + vertex_offset * vertex_size, scratch, block_size * vertex_size);
+		else if (copy)
+			for (size_t i = 0; i < block_size; ++i)
+				memcpy(vertex_data + (vertex_offset + i) * vertex_stride, scratch + i * vertex_size, vertex_size);
+
+		vertex_offset += block_size;
+	}
+
+	size_t tail_size = vertex_size < kTailMaxSize ? kTailMaxSize : vertex_size;
+
+	if (size_t(data_end - data) != tail_size)
+		return -3;
+
+	return 0;
+}
+
+size_t meshopt_encodeVertexBufferChunked(unsigned char* buffer, size_t buffer_size, const void* vertices, size_t vertex_count, size_t vertex_size, size_t chunk_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_encodeVertexBufferChunked");
+
+	return encodeVertexBufferChunked(buffer, buffer_size, vertices, vertex_count, vertex_size, chunk_size, gEncodeVertexVersion);
+}
+
+size_t meshopt_encodeVertexBufferChunkedBound(size_t vertex_count, size_t vertex_size, size_t chunk_size)
+{
+	using namespace meshopt;
+
+	assert(chunk_size > 0);
+
+	size_t chunk_count = (vertex_count + chunk_size - 1) / chunk_size;
+	size_t full_chunks = vertex_count / chunk_size;
+	size_t last_chunk = vertex_count - full_chunks * chunk_size;
+
+	size_t result = kChunkTableOffset + chunk_count * 4;
+
+	result += full_chunks * meshopt_encodeVertexBufferBound(chunk_size, vertex_size);
+	result += last_chunk ? meshopt_encodeVertexBufferBound(last_chunk, vertex_size) : 0;
+
+	return result;
+}
+
+size_t meshopt_decodeVertexBufferChunkCount(size_t vertex_count, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	if (buffer_size < kChunkTableOffset || (buffer[0] & 0xf0) != kVertexChunkHeader)
+		return 0;
+
+	size_t chunk_size = readU32(buffer + 1);
+
+	return chunk_size ? (vertex_count + chunk_size - 1) / chunk_size : 0;
+}
+
+int meshopt_decodeVertexBufferChunks(void* destination, size_t vertex_count, size_t vertex_size, size_t chunk_begin, size_t chunk_end, const unsigned char* buffer, size_t buffer_size)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeVertexBufferChunks");
+
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+	assert(chunk_begin <= chunk_end);
+
+	if (buffer_size < kChunkTableOffset)
+		return -2;
+
+	if ((buffer[0] & 0xf0) != kVertexChunkHeader)
+		return -1;
+
+	int version = buffer[0] & 0x0f;
+	if (version > 0)
+		return -1;
+
+	size_t chunk_size = readU32(buffer + 1);
+	if (chunk_size == 0)
+		return -1;
+
+	size_t chunk_count = (vertex_count + chunk_size - 1) / chunk_size;
+	if (chunk_end > chunk_count)
+		return -1;
+
+	size_t table_size = kChunkTableOffset + chunk_count * 4;
+	if (buffer_size < table_size)
+		return -2;
+
+	const unsigned char* data = buffer + table_size;
+	size_t data_size = buffer_size - table_size;
+
+	// the last chunk must end exactly at the end of the buffer, which makes sure the table is consistent with buffer_size
+	if (chunk_count > 0 && readU32(buffer + kChunkTableOffset + (chunk_count - 1) * 4) != data_size)
+		return -3;
+
+	unsigned char* vertex_data = static_cast<unsigned char*>(destination);
+
+	for (size_t i = chunk_begin; i < chunk_end; ++i)
+	{
+		size_t begin = i == 0 ? 0 : readU32(buffer + kChunkTableOffset + (i - 1) * 4);
+		size_t end = readU32(buffer + kChunkTableOffset + i * 4);
+
+		if (begin > end || end > data_size)
+			return -2;
+
+		size_t chunk_offset = i * chunk_size;
+		size_t chunk_vertices = (chunk_offset + chunk_size < vertex_count) ? chunk_size : vertex_count - chunk_offset;
+
+		int rc = meshopt_decodeVertexBuffer(vertex_data + chunk_offset * vertex_size, chunk_vertices, vertex_size, data + begin, end - begin);
+		if (rc != 0)
+			return rc;
+	}
+
+	return 0;
+}
+
+void meshopt_decodeVertexStreamInit(meshopt_DecodeStream* stream, size_t vertex_count, size_t vertex_size, size_t buffer_size)
+{
+	assert(vertex_size > 0 && vertex_size <= 256);
+	assert(vertex_size % 4 == 0);
+
+	memset(stream, 0, sizeof(*stream));
+
+	stream->count = vertex_count;
+	stream->size = vertex_size;
+	stream->buffer_size = buffer_size;
+}
+
+int meshopt_decodeVertexStream(meshopt_DecodeStream* stream, void* destination, const unsigned char* buffer, size_t available)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeVertexStream");
+
+	assert(available <= stream->buffer_size);
+
+	size_t vertex_count = stream->count;
+	size_t vertex_size = stream->size;
+	size_t buffer_size = stream->buffer_size;
+
+	if (available == 0)
+		return buffer_size == 0 ? -2 : 1;
+
+	// regular vertex streams store the first vertex at the end of the stream, so they can only be decoded once the entire stream is available
+	if ((buffer[0] & 0xf0) == kVertexHeader)
+	{
+		if (available < buffer_size)
+			return 1;
+
+		// the stream has already been decoded by an earlier call
+		if (stream->offset == buffer_size)
+			return 0;
+
+		int rc = meshopt_decodeVertexBuffer(destination, vertex_count, vertex_size, buffer, buffer_size);
+		if (rc == 0)
+			stream->decoded = vertex_count, stream->offset = buffer_size;
+
+		return rc;
+	}
+
+	if ((buffer[0] & 0xf0) != kVertexChunkHeader)
+		return -1;
+
+	if (available < kChunkTableOffset)
+		return available == buffer_size ? -2 : 1;
+
+	size_t chunk_size = readU32(buffer + 1);
+	if (chunk_size == 0)
+		return -1;
+
+	size_t chunk_count = (vertex_count + chunk_size - 1) / chunk_size;
+	size_t table_size = kChunkTableOffset + chunk_count * 4;
+
+	if (buffer_size < table_size)
+		return -2;
+
+	if (available < table_size)
+		return 1;
+
+	// find the range of chunks that are fully available; chunk ends are validated by meshopt_decodeVertexBufferChunks
+	size_t chunk_begin = stream->offset;
+	size_t chunk_end = chunk_begin;
+
+	while (chunk_end < chunk_count && readU32(buffer + kChunkTableOffset + chunk_end * 4) <= available - table_size)
+		chunk_end++;
+
+	if (chunk_end > chunk_begin)
+	{
+		int rc = meshopt_decodeVertexBufferChunks(destination, vertex_count, vertex_size, chunk_begin, chunk_end, buffer, buffer_size);
+		if (rc != 0)
+			return rc;
+
+		stream->offset = chunk_end;
+		stream->decoded = (chunk_end * chunk_size < vertex_count) ? chunk_end * chunk_size : vertex_count;
+	}
+
+	if (chunk_end < chunk_count)
+		return available == buffer_size ? -2 : 1;
+
+	// zero vertex streams don't have chunks, but still need a valid table
+	return meshopt_decodeVertexBufferChunks(destination, vertex_count, vertex_size, 0, 0, buffer, buffer_size);
+}
+
+int meshopt_decodeBatch(struct meshopt_DecodeItem* items, size_t item_count, meshopt_ParallelFor parallel_for, void* context)
+{
+	using namespace meshopt;
+
+	meshopt_Instrument instrument("meshopt_decodeBatch");
+
+	if (parallel_for && item_count > 1)
+	{
+		meshopt_Allocator allocator;
+
+		unsigned int* order = allocator.allocate<unsigned int>(item_count);
+		sortBatchItems(order, items, item_count);
+
+		DecodeBatchTask task = {items, order};
+		parallel_for(context, decodeBatchItem, &task, item_count);
+	}
+	else
+	{
+		for (size_t i = 0; i < item_count; ++i)
+			items[i].result = decodeItem(items[i]);
+	}
+
+	for (size_t i = 0; i < item_count; ++i)
+		if (items[i].result != 0)
+			return items[i].result;
 
 	return 0;
 }
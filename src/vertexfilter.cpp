@@ -829,6 +829,8 @@ void meshopt_decodeFilterOct(void* buffer, size_t count, size_t stride)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_decodeFilterOct");
+
 	assert(stride == 4 || stride == 8);
 
 #if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
@@ -848,6 +850,8 @@ void meshopt_decodeFilterQuat(void* buffer, size_t count, size_t stride)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_decodeFilterQuat");
+
 	assert(stride == 8);
 	(void)stride;
 
@@ -862,6 +866,8 @@ void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride)
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_decodeFilterExp");
+
 	assert(stride > 0 && stride % 4 == 0);
 
 #if defined(SIMD_SSE) || defined(SIMD_NEON) || defined(SIMD_WASM)
@@ -873,6 +879,8 @@ void meshopt_decodeFilterExp(void* buffer, size_t count, size_t stride)
 
 void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int bits, const float* data)
 {
+	meshopt_Instrument instrument("meshopt_encodeFilterOct");
+
 	assert(stride == 4 || stride == 8);
 	assert(bits >= 1 && bits <= 16);
 
@@ -920,6 +928,8 @@ void meshopt_encodeFilterOct(void* destination, size_t count, size_t stride, int
 
 void meshopt_encodeFilterQuat(void* destination_, size_t count, size_t stride, int bits, const float* data)
 {
+	meshopt_Instrument instrument("meshopt_encodeFilterQuat");
+
 	assert(stride == 8);
 	assert(bits >= 4 && bits <= 16);
 	(void)stride;
@@ -954,6 +964,8 @@ void meshopt_encodeFilterExp(void* destination_, size_t count, size_t stride, in
 {
 	using namespace meshopt;
 
+	meshopt_Instrument instrument("meshopt_encodeFilterExp");
+
 	assert(stride > 0 && stride % 4 == 0 && stride <= 256);
 	assert(bits >= 1 && bits <= 24);
 
@@ -6,6 +6,8 @@
 
 size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count)
 {
+	meshopt_Instrument instrument("meshopt_optimizeVertexFetchRemap");
+
 	assert(index_count % 3 == 0);
 
 	memset(destination, -1, vertex_count * sizeof(unsigned int));
@@ -30,6 +32,8 @@ size_t meshopt_optimizeVertexFetchRemap(unsigned int* destination, const unsigne
 
 size_t meshopt_optimizeVertexFetch(void* destination, unsigned int* indices, size_t index_count, const void* vertices, size_t vertex_count, size_t vertex_size)
 {
+	meshopt_Instrument instrument("meshopt_optimizeVertexFetch");
+
 	assert(index_count % 3 == 0);
 	assert(vertex_size > 0 && vertex_size <= 256);
 
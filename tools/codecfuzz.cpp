@@ -38,6 +38,40 @@ void fuzzRoundtrip(const uint8_t* data, size_t size, size_t stride)
 	free(encoded);
 }
 
+void fuzzMeshlet(const uint8_t* data, size_t size)
+{
+	// decodeMeshlet with fixed counts; should be >=16 to cover SIMD paths
+	unsigned int vertices[64];
+	unsigned char triangles[124 * 3];
+
+	int rc = meshopt_decodeMeshlet(vertices, 64, triangles, 124, reinterpret_cast<const unsigned char*>(data), size);
+	(void)rc;
+
+	// encodeMeshlet/decodeMeshlet should roundtrip for any triangle data as long as indices are in range
+	size_t triangle_count = size / 3 > 124 ? 124 : size / 3;
+
+	for (size_t i = 0; i < 64; ++i)
+		vertices[i] = unsigned(i * i * 2654435761u);
+
+	for (size_t i = 0; i < triangle_count * 3; ++i)
+		triangles[i] = data[i] & 63;
+
+	unsigned char encoded[1024];
+	assert(meshopt_encodeMeshletBound(64, 124) <= sizeof(encoded));
+
+	size_t res = meshopt_encodeMeshlet(encoded, sizeof(encoded), vertices, 64, triangles, triangle_count);
+	assert(res > 0);
+
+	unsigned int decoded_vertices[64];
+	unsigned char decoded_triangles[124 * 3];
+
+	rc = meshopt_decodeMeshlet(decoded_vertices, 64, decoded_triangles, triangle_count, encoded, res);
+	assert(rc == 0);
+
+	assert(memcmp(vertices, decoded_vertices, sizeof(vertices)) == 0);
+	assert(memcmp(triangles, decoded_triangles, triangle_count * 3) == 0);
+}
+
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 {
 	// decodeIndexBuffer supports 2 and 4-byte indices
@@ -61,5 +95,8 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
 	fuzzRoundtrip(data, size, 24);
 	fuzzRoundtrip(data, size, 32);
 
+	// decodeMeshlet should handle arbitrary input; encodeMeshlet/decodeMeshlet should roundtrip
+	fuzzMeshlet(data, size);
+
 	return 0;
 }
@@ -4,12 +4,43 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef _WIN32
 #include <fcntl.h>
 #include <io.h>
 #endif
 
+static int testIndexChunks(size_t chunk_size)
+{
+	// input is a 32-bit triangle list; we report the cost of chunking compared to the regular encoding
+	std::vector<unsigned int> indices;
+	unsigned int buffer[1024];
+	size_t indices_read;
+
+	while ((indices_read = fread(buffer, sizeof(unsigned int), sizeof(buffer) / sizeof(buffer[0]), stdin)) > 0)
+		indices.insert(indices.end(), buffer, buffer + indices_read);
+
+	indices.resize(indices.size() / 3 * 3);
+
+	unsigned int vertex_count = 0;
+	for (size_t i = 0; i < indices.size(); ++i)
+		vertex_count = indices[i] >= vertex_count ? indices[i] + 1 : vertex_count;
+
+	std::vector<unsigned char> output(meshopt_encodeIndexBufferBound(indices.size(), vertex_count));
+	size_t output_size = meshopt_encodeIndexBuffer(output.data(), output.size(), indices.data(), indices.size());
+
+	std::vector<unsigned char> chunked(meshopt_encodeIndexBufferChunkedBound(indices.size(), vertex_count, chunk_size));
+	size_t chunked_size = meshopt_encodeIndexBufferChunked(chunked.data(), chunked.size(), indices.data(), indices.size(), chunk_size, NULL, NULL);
+
+	fprintf(stderr, "regular: %d bytes, chunked: %d bytes (%d chunks, %+.2f%%)\n",
+	    int(output_size), int(chunked_size), int(meshopt_decodeIndexBufferChunkCount(indices.size(), chunked.data(), chunked_size)),
+	    output_size ? (double(chunked_size) / double(output_size) - 1) * 100 : 0.0);
+
+	fwrite(chunked.data(), 1, chunked_size, stdout);
+	return 0;
+}
+
 int main(int argc, char** argv)
 {
 #ifdef _WIN32
@@ -17,9 +48,13 @@ int main(int argc, char** argv)
 	_setmode(_fileno(stdout), _O_BINARY);
 #endif
 
+	if (argc == 3 && strcmp(argv[1], "-i") == 0 && atoi(argv[2]) > 0 && atoi(argv[2]) % 3 == 0)
+		return testIndexChunks(atoi(argv[2]));
+
 	if (argc < 2 || argc > 3 || atoi(argv[1]) <= 0)
 	{
 		fprintf(stderr, "Usage: %s <stride> [<count>]\n", argv[0]);
+		fprintf(stderr, "       %s -i <chunk_size>\n", argv[0]);
 		return 1;
 	}
 
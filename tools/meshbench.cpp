@@ -0,0 +1,884 @@
+// Benchmark for all mesh processing algorithms; reports timings, peak scratch memory and quality metrics, and compares two runs
+#include "../src/meshoptimizer.h"
+#include "../extern/fast_obj.h"
+
+#ifndef _CRT_SECURE_NO_WARNINGS
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#define CGLTF_IMPLEMENTATION
+#include "../extern/cgltf.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(_WIN32)
+struct LARGE_INTEGER
+{
+	__int64 QuadPart;
+};
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceCounter(LARGE_INTEGER* lpPerformanceCount);
+extern "C" __declspec(dllimport) int __stdcall QueryPerformanceFrequency(LARGE_INTEGER* lpFrequency);
+
+double timestamp()
+{
+	LARGE_INTEGER freq, counter;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&counter);
+	return double(counter.QuadPart) / double(freq.QuadPart);
+}
+#else
+double timestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+}
+#endif
+
+struct Vertex
+{
+	float px, py, pz;
+	float nx, ny, nz;
+	float tx, ty;
+};
+
+struct Mesh
+{
+	std::string name;
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+};
+
+// all library allocations go through meshopt_setAllocator; the size is stored in front of each block to track peak usage
+static size_t gMemoryCurrent = 0;
+static size_t gMemoryPeak = 0;
+
+static void* countAllocate(size_t size)
+{
+	size_t* block = static_cast<size_t*>(malloc(size + 16));
+	if (!block)
+		return NULL;
+
+	block[0] = size;
+
+	gMemoryCurrent += size;
+	gMemoryPeak = std::max(gMemoryPeak, gMemoryCurrent);
+
+	return reinterpret_cast<char*>(block) + 16;
+}
+
+static void countDeallocate(void* ptr)
+{
+	size_t* block = reinterpret_cast<size_t*>(static_cast<char*>(ptr) - 16);
+
+	gMemoryCurrent -= block[0];
+
+	free(block);
+}
+
+static void finishMesh(Mesh& result, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices)
+{
+	std::vector<unsigned int> remap(vertices.size());
+	size_t vertex_count = indices.empty() ? 0 : meshopt_generateVertexRemap(&remap[0], &indices[0], indices.size(), &vertices[0], vertices.size(), sizeof(Vertex));
+
+	result.vertices.resize(vertex_count);
+	result.indices.resize(indices.size());
+
+	if (vertex_count)
+	{
+		meshopt_remapVertexBuffer(&result.vertices[0], &vertices[0], vertices.size(), sizeof(Vertex), &remap[0]);
+		meshopt_remapIndexBuffer(&result.indices[0], &indices[0], indices.size(), &remap[0]);
+	}
+}
+
+static bool loadObj(Mesh& result, const char* path)
+{
+	fastObjMesh* obj = fast_obj_read(path);
+	if (!obj)
+		return false;
+
+	size_t total_indices = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+		total_indices += 3 * (obj->face_vertices[i] - 2);
+
+	std::vector<Vertex> vertices(total_indices);
+
+	size_t vertex_offset = 0;
+	size_t index_offset = 0;
+
+	for (unsigned int i = 0; i < obj->face_count; ++i)
+	{
+		for (unsigned int j = 0; j < obj->face_vertices[i]; ++j)
+		{
+			fastObjIndex gi = obj->indices[index_offset + j];
+
+			Vertex v =
+			    {
+			        obj->positions[gi.p * 3 + 0],
+			        obj->positions[gi.p * 3 + 1],
+			        obj->positions[gi.p * 3 + 2],
+			        obj->normals[gi.n * 3 + 0],
+			        obj->normals[gi.n * 3 + 1],
+			        obj->normals[gi.n * 3 + 2],
+			        obj->texcoords[gi.t * 2 + 0],
+			        obj->texcoords[gi.t * 2 + 1],
+			    };
+
+			// triangulate polygon on the fly; offset-3 is always the first polygon vertex
+			if (j >= 3)
+			{
+				vertices[vertex_offset + 0] = vertices[vertex_offset - 3];
+				vertices[vertex_offset + 1] = vertices[vertex_offset - 1];
+				vertex_offset += 2;
+			}
+
+			vertices[vertex_offset] = v;
+			vertex_offset++;
+		}
+
+		index_offset += obj->face_vertices[i];
+	}
+
+	fast_obj_destroy(obj);
+
+	std::vector<unsigned int> indices(total_indices);
+
+	for (size_t i = 0; i < total_indices; ++i)
+		indices[i] = unsigned(i);
+
+	finishMesh(result, vertices, indices);
+	return true;
+}
+
+static bool loadGltf(Mesh& result, const char* path)
+{
+	cgltf_options options = {};
+	cgltf_data* data = NULL;
+
+	if (cgltf_parse_file(&options, path, &data) != cgltf_result_success)
+		return false;
+
+	if (cgltf_load_buffers(&options, data, path) != cgltf_result_success)
+	{
+		cgltf_free(data);
+		return false;
+	}
+
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+
+	// all triangle primitives are merged into one mesh; node transforms are ignored since they don't affect the algorithms
+	for (size_t mi = 0; mi < data->meshes_count; ++mi)
+	{
+		const cgltf_mesh& mesh = data->meshes[mi];
+
+		for (size_t pi = 0; pi < mesh.primitives_count; ++pi)
+		{
+			const cgltf_primitive& prim = mesh.primitives[pi];
+
+			if (prim.type != cgltf_primitive_type_triangles)
+				continue;
+
+			const cgltf_accessor* position = NULL;
+			const cgltf_accessor* normal = NULL;
+			const cgltf_accessor* texcoord = NULL;
+
+			for (size_t ai = 0; ai < prim.attributes_count; ++ai)
+			{
+				const cgltf_attribute& attr = prim.attributes[ai];
+
+				if (attr.type == cgltf_attribute_type_position)
+					position = attr.data;
+				else if (attr.type == cgltf_attribute_type_normal)
+					normal = attr.data;
+				else if (attr.type == cgltf_attribute_type_texcoord && attr.index == 0)
+					texcoord = attr.data;
+			}
+
+			if (!position)
+				continue;
+
+			size_t base = vertices.size();
+			vertices.resize(base + position->count);
+
+			for (size_t i = 0; i < position->count; ++i)
+			{
+				Vertex& v = vertices[base + i];
+				memset(&v, 0, sizeof(v));
+
+				cgltf_accessor_read_float(position, i, &v.px, 3);
+
+				if (normal)
+					cgltf_accessor_read_float(normal, i, &v.nx, 3);
+
+				if (texcoord)
+					cgltf_accessor_read_float(texcoord, i, &v.tx, 2);
+			}
+
+			size_t index_count = prim.indices ? prim.indices->count : position->count;
+
+			for (size_t i = 0; i + 2 < index_count; i += 3)
+				for (int k = 0; k < 3; ++k)
+				{
+					size_t index = prim.indices ? cgltf_accessor_read_index(prim.indices, i + k) : i + k;
+
+					indices.push_back(unsigned(base + (index < position->count ? index : 0)));
+				}
+		}
+	}
+
+	cgltf_free(data);
+
+	finishMesh(result, vertices, indices);
+	return true;
+}
+
+static Mesh gridMesh(unsigned int N)
+{
+	Mesh result;
+	result.name = "grid";
+
+	result.vertices.resize((N + 1) * (N + 1));
+
+	for (unsigned int y = 0; y <= N; ++y)
+		for (unsigned int x = 0; x <= N; ++x)
+		{
+			Vertex& v = result.vertices[y * (N + 1) + x];
+
+			// small height variation makes the grid non-planar so that simplification has to do real work
+			v.px = float(x);
+			v.py = float((x * 7 + y * 13) % 5) * 0.1f;
+			v.pz = float(y);
+			v.nx = 0;
+			v.ny = 1;
+			v.nz = 0;
+			v.tx = float(x) / float(N);
+			v.ty = float(y) / float(N);
+		}
+
+	result.indices.reserve(N * N * 6);
+
+	for (unsigned int y = 0; y < N; ++y)
+		for (unsigned int x = 0; x < N; ++x)
+		{
+			result.indices.push_back((y + 0) * (N + 1) + (x + 0));
+			result.indices.push_back((y + 0) * (N + 1) + (x + 1));
+			result.indices.push_back((y + 1) * (N + 1) + (x + 0));
+
+			result.indices.push_back((y + 1) * (N + 1) + (x + 0));
+			result.indices.push_back((y + 0) * (N + 1) + (x + 1));
+			result.indices.push_back((y + 1) * (N + 1) + (x + 1));
+		}
+
+	return result;
+}
+
+// state shared by all algorithms for one mesh; inputs are prepared once, outputs are preallocated so that timed runs only include library work
+struct Bench
+{
+	const Mesh* mesh;
+
+	// vertex cache + vertex fetch optimized mesh, used as input for algorithms that expect an optimized mesh
+	std::vector<Vertex> opt_vertices;
+	std::vector<unsigned int> opt_indices;
+
+	std::vector<unsigned int> remap;
+	std::vector<unsigned int> indices;
+	std::vector<Vertex> vertices;
+
+	std::vector<meshopt_Meshlet> meshlets;
+	std::vector<unsigned int> meshlet_vertices;
+	std::vector<unsigned char> meshlet_triangles;
+
+	std::vector<unsigned char> encoded;
+
+	size_t result;
+	float error;
+};
+
+struct Metric
+{
+	const char* name;
+	double value;
+};
+
+struct Algorithm
+{
+	const char* name;
+
+	void (*run)(Bench& b);
+
+	// computes quality metrics from the outputs of the last run; returns the number of metrics written
+	int (*quality)(Bench& b, Metric* metrics);
+
+	// number of bytes read by the algorithm for GB/s computation
+	size_t (*bytes)(const Bench& b);
+};
+
+static size_t indexBytes(const Bench& b)
+{
+	return b.mesh->indices.size() * sizeof(unsigned int);
+}
+
+static size_t meshBytes(const Bench& b)
+{
+	return b.mesh->indices.size() * sizeof(unsigned int) + b.mesh->vertices.size() * sizeof(Vertex);
+}
+
+static size_t positionBytes(const Bench& b)
+{
+	return b.mesh->vertices.size() * sizeof(Vertex);
+}
+
+static int cacheQuality(const Bench& b, const std::vector<unsigned int>& indices, size_t index_count, Metric* metrics)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_VertexCacheStatistics vcs = meshopt_analyzeVertexCache(&indices[0], index_count, mesh.vertices.size(), 16, 0, 0);
+
+	metrics[0].name = "acmr";
+	metrics[0].value = vcs.acmr;
+	metrics[1].name = "atvr";
+	metrics[1].value = vcs.atvr;
+
+	return 2;
+}
+
+static void runRemap(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	b.result = meshopt_generateVertexRemap(&b.remap[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+}
+
+static int qualityRemap(Bench& b, Metric* metrics)
+{
+	metrics[0].name = "unique_vertices";
+	metrics[0].value = double(b.result);
+
+	return 1;
+}
+
+static void runVertexCache(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_optimizeVertexCache(&b.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+}
+
+static void runVertexCacheStrip(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_optimizeVertexCacheStrip(&b.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+}
+
+static void runVertexCacheFifo(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_optimizeVertexCacheFifo(&b.indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size(), 16);
+}
+
+static int qualityVertexCache(Bench& b, Metric* metrics)
+{
+	return cacheQuality(b, b.indices, b.indices.size(), metrics);
+}
+
+static void runOverdraw(Bench& b)
+{
+	meshopt_optimizeOverdraw(&b.indices[0], &b.opt_indices[0], b.opt_indices.size(), &b.opt_vertices[0].px, b.opt_vertices.size(), sizeof(Vertex), 1.05f);
+}
+
+static int qualityOverdraw(Bench& b, Metric* metrics)
+{
+	int count = cacheQuality(b, b.indices, b.indices.size(), metrics);
+
+	meshopt_OverdrawStatistics os = meshopt_analyzeOverdraw(&b.indices[0], b.indices.size(), &b.opt_vertices[0].px, b.opt_vertices.size(), sizeof(Vertex));
+
+	metrics[count].name = "overdraw";
+	metrics[count].value = os.overdraw;
+
+	return count + 1;
+}
+
+static void runVertexFetch(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	// vertex fetch optimization updates the index buffer in place, so it needs a fresh copy for every run
+	b.indices = b.opt_indices;
+	b.result = meshopt_optimizeVertexFetch(&b.vertices[0], &b.indices[0], b.indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex));
+}
+
+static int qualityVertexFetch(Bench& b, Metric* metrics)
+{
+	meshopt_VertexFetchStatistics vfs = meshopt_analyzeVertexFetch(&b.indices[0], b.indices.size(), b.result, sizeof(Vertex));
+
+	metrics[0].name = "overfetch";
+	metrics[0].value = vfs.overfetch;
+
+	return 1;
+}
+
+static void runSimplify(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	size_t target_index_count = size_t(mesh.indices.size() * 0.25f) / 3 * 3;
+
+	b.result = meshopt_simplify(&b.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, 1e-2f, 0, &b.error);
+}
+
+static void runSimplifySloppy(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	size_t target_index_count = size_t(mesh.indices.size() * 0.25f) / 3 * 3;
+
+	b.result = meshopt_simplifySloppy(&b.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex), target_index_count, 1e-2f, &b.error);
+}
+
+static int qualitySimplify(Bench& b, Metric* metrics)
+{
+	metrics[0].name = "ratio";
+	metrics[0].value = double(b.result) / double(b.mesh->indices.size());
+	metrics[1].name = "error";
+	metrics[1].value = b.error;
+
+	return 2;
+}
+
+static void runMeshlets(Bench& b, size_t max_vertices, size_t max_triangles)
+{
+	b.result = meshopt_buildMeshlets(&b.meshlets[0], &b.meshlet_vertices[0], &b.meshlet_triangles[0], &b.opt_indices[0], b.opt_indices.size(), &b.opt_vertices[0].px, b.opt_vertices.size(), sizeof(Vertex), max_vertices, max_triangles, 0.f);
+}
+
+static void runMeshlets64(Bench& b)
+{
+	runMeshlets(b, 64, 64);
+}
+
+static void runMeshlets124(Bench& b)
+{
+	runMeshlets(b, 64, 124);
+}
+
+static int qualityMeshlets(Bench& b, Metric* metrics)
+{
+	size_t vertices = 0;
+
+	for (size_t i = 0; i < b.result; ++i)
+		vertices += b.meshlets[i].vertex_count;
+
+	metrics[0].name = "meshlets";
+	metrics[0].value = double(b.result);
+	metrics[1].name = "triangles_per_meshlet";
+	metrics[1].value = b.result ? double(b.opt_indices.size() / 3) / double(b.result) : 0;
+	metrics[2].name = "vertices_per_meshlet";
+	metrics[2].value = b.result ? double(vertices) / double(b.result) : 0;
+
+	return 3;
+}
+
+static void runSpatialSort(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_spatialSortRemap(&b.remap[0], &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void runSpatialSortTriangles(Bench& b)
+{
+	const Mesh& mesh = *b.mesh;
+
+	meshopt_spatialSortTriangles(&b.indices[0], &mesh.indices[0], mesh.indices.size(), &mesh.vertices[0].px, mesh.vertices.size(), sizeof(Vertex));
+}
+
+static void runEncodeVertex(Bench& b)
+{
+	b.encoded.resize(meshopt_encodeVertexBufferBound(b.opt_vertices.size(), sizeof(Vertex)));
+	b.result = meshopt_encodeVertexBuffer(&b.encoded[0], b.encoded.size(), &b.opt_vertices[0], b.opt_vertices.size(), sizeof(Vertex));
+}
+
+static void runDecodeVertex(Bench& b)
+{
+	int rc = meshopt_decodeVertexBuffer(&b.vertices[0], b.opt_vertices.size(), sizeof(Vertex), &b.encoded[0], b.result);
+	assert(rc == 0);
+	(void)rc;
+}
+
+static int qualityVertexCodec(Bench& b, Metric* metrics)
+{
+	metrics[0].name = "bytes_per_vertex";
+	metrics[0].value = double(b.result) / double(b.opt_vertices.size());
+
+	return 1;
+}
+
+static void runEncodeIndex(Bench& b)
+{
+	b.encoded.resize(meshopt_encodeIndexBufferBound(b.opt_indices.size(), b.opt_vertices.size()));
+	b.result = meshopt_encodeIndexBuffer(&b.encoded[0], b.encoded.size(), &b.opt_indices[0], b.opt_indices.size());
+}
+
+static void runDecodeIndex(Bench& b)
+{
+	int rc = meshopt_decodeIndexBuffer(&b.indices[0], b.opt_indices.size(), sizeof(unsigned int), &b.encoded[0], b.result);
+	assert(rc == 0);
+	(void)rc;
+}
+
+static int qualityIndexCodec(Bench& b, Metric* metrics)
+{
+	metrics[0].name = "bytes_per_triangle";
+	metrics[0].value = double(b.result) / double(b.opt_indices.size() / 3);
+
+	return 1;
+}
+
+static int qualityNone(Bench&, Metric*)
+{
+	return 0;
+}
+
+// decoders reuse the output of the preceding encoder, so the order of this table matters
+static const Algorithm kAlgorithms[] = {
+    {"generateVertexRemap", runRemap, qualityRemap, meshBytes},
+    {"optimizeVertexCache", runVertexCache, qualityVertexCache, indexBytes},
+    {"optimizeVertexCacheStrip", runVertexCacheStrip, qualityVertexCache, indexBytes},
+    {"optimizeVertexCacheFifo", runVertexCacheFifo, qualityVertexCache, indexBytes},
+    {"optimizeOverdraw", runOverdraw, qualityOverdraw, meshBytes},
+    {"optimizeVertexFetch", runVertexFetch, qualityVertexFetch, meshBytes},
+    {"simplify", runSimplify, qualitySimplify, meshBytes},
+    {"simplifySloppy", runSimplifySloppy, qualitySimplify, meshBytes},
+    {"buildMeshlets/64x64", runMeshlets64, qualityMeshlets, meshBytes},
+    {"buildMeshlets/64x124", runMeshlets124, qualityMeshlets, meshBytes},
+    {"spatialSortRemap", runSpatialSort, qualityNone, positionBytes},
+    {"spatialSortTriangles", runSpatialSortTriangles, qualityNone, meshBytes},
+    {"encodeVertexBuffer", runEncodeVertex, qualityVertexCodec, positionBytes},
+    {"decodeVertexBuffer", runDecodeVertex, qualityVertexCodec, positionBytes},
+    {"encodeIndexBuffer", runEncodeIndex, qualityIndexCodec, indexBytes},
+    {"decodeIndexBuffer", runDecodeIndex, qualityIndexCodec, indexBytes},
+};
+
+static void prepareBench(Bench& b, const Mesh& mesh)
+{
+	b.mesh = &mesh;
+
+	b.opt_indices.resize(mesh.indices.size());
+	meshopt_optimizeVertexCache(&b.opt_indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertices.size());
+
+	b.opt_vertices.resize(mesh.vertices.size());
+	b.opt_vertices.resize(meshopt_optimizeVertexFetch(&b.opt_vertices[0], &b.opt_indices[0], b.opt_indices.size(), &mesh.vertices[0], mesh.vertices.size(), sizeof(Vertex)));
+
+	b.remap.resize(mesh.vertices.size());
+	b.indices.resize(mesh.indices.size());
+	b.vertices.resize(mesh.vertices.size());
+
+	size_t max_meshlets64 = meshopt_buildMeshletsBound(mesh.indices.size(), 64, 64);
+	size_t max_meshlets124 = meshopt_buildMeshletsBound(mesh.indices.size(), 64, 124);
+
+	b.meshlets.resize(std::max(max_meshlets64, max_meshlets124));
+	b.meshlet_vertices.resize(b.meshlets.size() * 64);
+	b.meshlet_triangles.resize(std::max(max_meshlets64 * 64, max_meshlets124 * 124) * 3);
+
+	b.result = 0;
+	b.error = 0;
+}
+
+static void writeString(FILE* file, const char* str)
+{
+	fputc('"', file);
+
+	for (const char* ptr = str; *ptr; ++ptr)
+	{
+		if (*ptr == '"' || *ptr == '\\')
+			fputc('\\', file);
+
+		fputc(*ptr, file);
+	}
+
+	fputc('"', file);
+}
+
+static void writeRecord(FILE* file, const Bench& b, const Algorithm& algorithm, double time_min, double time_median, size_t peak_memory, const Metric* metrics, int metric_count)
+{
+	const Mesh& mesh = *b.mesh;
+
+	double GB = 1024 * 1024 * 1024;
+
+	fprintf(file, "{\"mesh\":");
+	writeString(file, mesh.name.c_str());
+	fprintf(file, ",\"algorithm\":\"%s\",\"triangles\":%d,\"vertices\":%d", algorithm.name, int(mesh.indices.size() / 3), int(mesh.vertices.size()));
+	fprintf(file, ",\"time_min\":%.9f,\"time_median\":%.9f", time_min, time_median);
+	fprintf(file, ",\"triangles_per_sec\":%.0f,\"gb_per_sec\":%.4f", double(mesh.indices.size() / 3) / time_min, double(algorithm.bytes(b)) / GB / time_min);
+	fprintf(file, ",\"peak_memory\":%lld", (long long)peak_memory);
+
+	for (int i = 0; i < metric_count; ++i)
+		fprintf(file, ",\"%s\":%g", metrics[i].name, metrics[i].value);
+
+	fprintf(file, "}\n");
+}
+
+static void benchMesh(const Mesh& mesh, int warmup, int repeat, FILE* json, FILE* log)
+{
+	Bench b;
+	prepareBench(b, mesh);
+
+	fprintf(log, "%s: %d triangles, %d vertices\n", mesh.name.c_str(), int(mesh.indices.size() / 3), int(mesh.vertices.size()));
+
+	for (size_t i = 0; i < sizeof(kAlgorithms) / sizeof(kAlgorithms[0]); ++i)
+	{
+		const Algorithm& algorithm = kAlgorithms[i];
+
+		for (int k = 0; k < warmup; ++k)
+			algorithm.run(b);
+
+		std::vector<double> times(repeat);
+		size_t peak_memory = 0;
+
+		for (int k = 0; k < repeat; ++k)
+		{
+			size_t memory_base = gMemoryCurrent;
+			gMemoryPeak = gMemoryCurrent;
+
+			double t0 = timestamp();
+			algorithm.run(b);
+			double t1 = timestamp();
+
+			times[k] = t1 - t0;
+			peak_memory = std::max(peak_memory, gMemoryPeak - memory_base);
+		}
+
+		std::sort(times.begin(), times.end());
+
+		double time_min = times[0];
+		double time_median = (times[(repeat - 1) / 2] + times[repeat / 2]) / 2;
+
+		Metric metrics[8];
+		int metric_count = algorithm.quality(b, metrics);
+		assert(metric_count <= int(sizeof(metrics) / sizeof(metrics[0])));
+
+		double GB = 1024 * 1024 * 1024;
+
+		fprintf(log, "  %-26s %8.3f ms (median %8.3f ms), %7.2f Mtri/s, %6.2f GB/s, %8.1f KB peak",
+		       algorithm.name, time_min * 1000, time_median * 1000,
+		       double(mesh.indices.size() / 3) / 1e6 / time_min, double(algorithm.bytes(b)) / GB / time_min,
+		       double(peak_memory) / 1024);
+
+		for (int m = 0; m < metric_count; ++m)
+			fprintf(log, ", %s %.3f", metrics[m].name, metrics[m].value);
+
+		fprintf(log, "\n");
+
+		if (json)
+			writeRecord(json, b, algorithm, time_min, time_median, peak_memory, metrics, metric_count);
+	}
+}
+
+struct Record
+{
+	std::string mesh;
+	std::string algorithm;
+
+	double time_min;
+};
+
+static bool readString(const char* line, const char* key, std::string& result)
+{
+	const char* ptr = strstr(line, key);
+	if (!ptr || ptr[strlen(key)] != '"')
+		return false;
+
+	result.clear();
+
+	for (ptr += strlen(key) + 1; *ptr && *ptr != '"'; ++ptr)
+	{
+		if (*ptr == '\\' && ptr[1])
+			ptr++;
+
+		result += *ptr;
+	}
+
+	return *ptr == '"';
+}
+
+static bool readNumber(const char* line, const char* key, double& result)
+{
+	const char* ptr = strstr(line, key);
+
+	return ptr && sscanf(ptr + strlen(key), "%lf", &result) == 1;
+}
+
+static bool readRecords(const char* path, std::vector<Record>& records)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	// records are written one per line, so there's no need for a full JSON parser
+	char line[4096];
+
+	while (fgets(line, sizeof(line), file))
+	{
+		Record r;
+
+		if (readString(line, "\"mesh\":", r.mesh) && readString(line, "\"algorithm\":", r.algorithm) && readNumber(line, "\"time_min\":", r.time_min))
+			records.push_back(r);
+	}
+
+	fclose(file);
+	return true;
+}
+
+static int compareRuns(const char* base_path, const char* test_path, double threshold)
+{
+	std::vector<Record> base, test;
+
+	if (!readRecords(base_path, base))
+	{
+		fprintf(stderr, "Error loading %s\n", base_path);
+		return 2;
+	}
+
+	if (!readRecords(test_path, test))
+	{
+		fprintf(stderr, "Error loading %s\n", test_path);
+		return 2;
+	}
+
+	int regressions = 0;
+
+	for (size_t i = 0; i < test.size(); ++i)
+	{
+		const Record& t = test[i];
+		const Record* b = NULL;
+
+		for (size_t j = 0; j < base.size() && !b; ++j)
+			if (base[j].mesh == t.mesh && base[j].algorithm == t.algorithm)
+				b = &base[j];
+
+		if (!b)
+		{
+			printf("%s %s: missing in %s\n", t.mesh.c_str(), t.algorithm.c_str(), base_path);
+			continue;
+		}
+
+		double ratio = t.time_min / b->time_min;
+		bool regression = ratio > 1 + threshold / 100;
+
+		printf("%s %-26s %8.3f ms -> %8.3f ms (%+.1f%%)%s\n", t.mesh.c_str(), t.algorithm.c_str(), b->time_min * 1000, t.time_min * 1000, (ratio - 1) * 100, regression ? " REGRESSION" : "");
+
+		regressions += regression;
+	}
+
+	if (regressions)
+		printf("%d regressions over %.1f%% threshold\n", regressions, threshold);
+
+	return regressions ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+	int warmup = 1;
+	int repeat = 5;
+	double threshold = 5;
+	const char* json_path = NULL;
+	const char* compare_paths[2] = {};
+
+	std::vector<const char*> paths;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+			warmup = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+			repeat = std::max(atoi(argv[++i]), 1);
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			threshold = atof(argv[++i]);
+		else if (strcmp(argv[i], "-json") == 0 && i + 1 < argc)
+			json_path = argv[++i];
+		else if (strcmp(argv[i], "-compare") == 0 && i + 2 < argc)
+		{
+			compare_paths[0] = argv[++i];
+			compare_paths[1] = argv[++i];
+		}
+		else if (argv[i][0] == '-')
+		{
+			fprintf(stderr, "Usage: %s [-w warmup] [-r repeat] [-json output.json] [mesh.obj|mesh.gltf|mesh.glb...]\n", argv[0]);
+			fprintf(stderr, "       %s -compare base.json test.json [-t threshold%%]\n", argv[0]);
+			return 2;
+		}
+		else
+			paths.push_back(argv[i]);
+	}
+
+	if (compare_paths[0])
+		return compareRuns(compare_paths[0], compare_paths[1], threshold);
+
+	meshopt_encodeIndexVersion(1);
+	meshopt_setAllocator(countAllocate, countDeallocate);
+
+	FILE* json = NULL;
+
+	if (json_path)
+	{
+		json = strcmp(json_path, "-") == 0 ? stdout : fopen(json_path, "w");
+
+		if (!json)
+		{
+			fprintf(stderr, "Error opening %s for writing\n", json_path);
+			return 2;
+		}
+	}
+
+	// when JSON is written to stdout, human-readable output goes to stderr to keep the JSON stream clean
+	FILE* log = json == stdout ? stderr : stdout;
+
+	if (paths.empty())
+	{
+		Mesh mesh = gridMesh(500);
+		benchMesh(mesh, warmup, repeat, json, log);
+	}
+
+	for (size_t i = 0; i < paths.size(); ++i)
+	{
+		const char* path = paths[i];
+		const char* ext = strrchr(path, '.');
+
+		Mesh mesh;
+		mesh.name = path;
+
+		bool gltf = ext && (strcmp(ext, ".gltf") == 0 || strcmp(ext, ".glb") == 0);
+
+		if (!(gltf ? loadGltf(mesh, path) : loadObj(mesh, path)))
+		{
+			fprintf(stderr, "Error loading %s\n", path);
+			continue;
+		}
+
+		if (mesh.indices.empty())
+		{
+			fprintf(stderr, "Error loading %s: no triangles\n", path);
+			continue;
+		}
+
+		benchMesh(mesh, warmup, repeat, json, log);
+	}
+
+	if (json && json != stdout)
+		fclose(json);
+
+	return 0;
+}
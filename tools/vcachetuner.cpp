@@ -6,45 +6,42 @@
 
 #include <algorithm>
 #include <functional>
+#include <string>
 #include <vector>
 
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
+// these must match the table sizes expected by meshopt_optimizeVertexCacheWithScores
 const int kCacheSizeMax = 16;
 const int kValenceMax = 8;
 
-namespace meshopt
-{
-	struct VertexScoreTable
-	{
-		float cache[1 + kCacheSizeMax];
-		float live[1 + kValenceMax];
-	};
-} // namespace meshopt
-
-void meshopt_optimizeVertexCacheTable(unsigned int* destination, const unsigned int* indices, size_t index_count, size_t vertex_count, const meshopt::VertexScoreTable* table);
-
 struct Profile
 {
+	const char* name;
 	float weight;
 	int cache, warp, triangle; // vcache tuning parameters
 	int compression;
 };
 
-Profile profiles[] =
+const Profile kProfiles[] =
 {
-	{1.f, 0, 0, 0, 0},  // Compression
-	{1.f, 0, 0, 0, 1},  // Compression w/deflate
-	// {1.f, 14, 64, 128}, // AMD GCN
-	// {1.f, 32, 32, 32},  // NVidia Pascal
-	// {1.f, 16, 32, 32}, // NVidia Kepler, Maxwell
-	// {1.f, 128, 0, 0}, // Intel
+	{"compression", 1.f, 0, 0, 0, 0},
+	{"deflate", 1.f, 0, 0, 0, 1}, // compression w/deflate
+	{"amd", 1.f, 14, 64, 128, 0}, // AMD GCN
+	{"nvidia", 1.f, 32, 32, 32, 0}, // NVidia Pascal
+	{"nvidia-maxwell", 1.f, 16, 32, 32, 0}, // NVidia Kepler, Maxwell
+	{"intel", 1.f, 128, 0, 0, 0},
 };
 
-const int Profile_Count = sizeof(profiles) / sizeof(profiles[0]);
+const int kProfileCount = sizeof(kProfiles) / sizeof(kProfiles[0]);
+
+// profiles selected on the command line; compression profiles are used by default
+std::vector<Profile> profiles;
+unsigned int profile_mask = 0;
 
 struct pcg32_random_t
 {
@@ -91,7 +88,7 @@ struct Mesh
 	size_t vertex_count;
 	std::vector<unsigned int> indices;
 
-	float metric_base[Profile_Count];
+	std::vector<float> metric_base;
 };
 
 Mesh gridmesh(unsigned int N)
@@ -203,16 +200,13 @@ size_t compress(const std::vector<T>& data, int level = SDEFL_LVL_DEF)
 	return sdeflate(&s, &cbuf[0], reinterpret_cast<const unsigned char*>(&data[0]), int(data.size() * sizeof(T)), level);
 }
 
-void compute_metric(const State* state, const Mesh& mesh, float result[Profile_Count])
+void compute_metric(const State* state, const Mesh& mesh, float* result)
 {
 	std::vector<unsigned int> indices(mesh.indices.size());
 
 	if (state)
 	{
-		meshopt::VertexScoreTable table = {};
-		memcpy(table.cache + 1, state->cache, kCacheSizeMax * sizeof(float));
-		memcpy(table.live + 1, state->live, kValenceMax * sizeof(float));
-		meshopt_optimizeVertexCacheTable(&indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertex_count, &table);
+		meshopt_optimizeVertexCacheWithScores(&indices[0], &mesh.indices[0], mesh.indices.size(), mesh.vertex_count, state->cache, state->live);
 	}
 	else
 	{
@@ -223,7 +217,7 @@ void compute_metric(const State* state, const Mesh& mesh, float result[Profile_C
 
 	std::vector<unsigned char> ibuf;
 
-	for (int profile = 0; profile < Profile_Count; ++profile)
+	for (size_t profile = 0; profile < profiles.size(); ++profile)
 	{
 		if (profiles[profile].cache == 0)
 		{
@@ -232,7 +226,7 @@ void compute_metric(const State* state, const Mesh& mesh, float result[Profile_C
 		}
 	}
 
-	for (int profile = 0; profile < Profile_Count; ++profile)
+	for (size_t profile = 0; profile < profiles.size(); ++profile)
 	{
 		if (profiles[profile].cache)
 		{
@@ -254,12 +248,13 @@ float fitness_score(const State& state, const std::vector<Mesh>& meshes)
 	float result = 0;
 	float count = 0;
 
+	std::vector<float> metric(profiles.size());
+
 	for (auto& mesh : meshes)
 	{
-		float metric[Profile_Count];
-		compute_metric(&state, mesh, metric);
+		compute_metric(&state, mesh, &metric[0]);
 
-		for (int profile = 0; profile < Profile_Count; ++profile)
+		for (size_t profile = 0; profile < profiles.size(); ++profile)
 		{
 			result += mesh.metric_base[profile] / metric[profile] * profiles[profile].weight;
 			count += profiles[profile].weight;
@@ -283,11 +278,16 @@ std::vector<State> gen0(size_t count, const std::vector<Mesh>& meshes)
 		for (int j = 0; j < kValenceMax; ++j)
 			state.live[j] = rand01();
 
-		state.fitness = fitness_score(state, meshes);
-
 		result.push_back(state);
 	}
 
+	// random states are generated serially so that the search only depends on the seed, and evaluated in parallel
+	#pragma omp parallel for schedule(dynamic)
+	for (size_t i = 0; i < count; ++i)
+	{
+		result[i].fitness = fitness_score(result[i], meshes);
+	}
+
 	return result;
 }
 
@@ -335,7 +335,8 @@ std::pair<State, float> genN(std::vector<State>& seed, const std::vector<Mesh>&
 		}
 	}
 
-	#pragma omp parallel for
+	// candidates take different amounts of time to evaluate, so they are scheduled dynamically
+	#pragma omp parallel for schedule(dynamic)
 	for (size_t i = 0; i < seed.size(); ++i)
 	{
 		result[i].fitness = fitness_score(result[i], meshes);
@@ -359,11 +360,40 @@ std::pair<State, float> genN(std::vector<State>& seed, const std::vector<Mesh>&
 	return std::make_pair(best, bestfit);
 }
 
-bool load_state(const char* path, std::vector<State>& result)
+// checkpoint contains the generation and the random generator state along with the population, so a resumed search continues exactly where it stopped
+struct Checkpoint
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int profile_mask;
+	unsigned int generation;
+	pcg32_random_t rng;
+};
+
+const unsigned int kCheckpointVersion = 1;
+
+// returns 1 if the checkpoint was loaded, 0 if it doesn't exist and -1 if it can't be used
+int load_state(const char* path, std::vector<State>& result, size_t& generation)
 {
 	FILE* file = fopen(path, "rb");
 	if (!file)
-		return false;
+		return 0;
+
+	Checkpoint header = {};
+
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, "VCTS", 4) != 0 || header.version != kCheckpointVersion)
+	{
+		printf("ERROR: %s is not a valid checkpoint\n", path);
+		fclose(file);
+		return -1;
+	}
+
+	if (header.profile_mask != profile_mask)
+	{
+		printf("ERROR: %s was created with different profiles\n", path);
+		fclose(file);
+		return -1;
+	}
 
 	State state;
 
@@ -374,15 +404,32 @@ bool load_state(const char* path, std::vector<State>& result)
 
 	fclose(file);
 
-	return true;
+	if (result.empty())
+	{
+		printf("ERROR: %s doesn't contain any state vectors\n", path);
+		return -1;
+	}
+
+	generation = header.generation;
+	rngstate = header.rng;
+
+	return 1;
 }
 
-bool save_state(const char* path, const std::vector<State>& result)
+bool save_state(const char* path, const std::vector<State>& result, size_t generation)
 {
 	FILE* file = fopen(path, "wb");
 	if (!file)
 		return false;
 
+	Checkpoint header = {{'V', 'C', 'T', 'S'}, kCheckpointVersion, profile_mask, unsigned(generation), rngstate};
+
+	if (fwrite(&header, sizeof(header), 1, file) != 1)
+	{
+		fclose(file);
+		return false;
+	}
+
 	for (auto& state : result)
 	{
 		if (fwrite(&state, sizeof(State), 1, file) != 1)
@@ -395,6 +442,31 @@ bool save_state(const char* path, const std::vector<State>& result)
 	return fclose(file) == 0;
 }
 
+// writes tables that can be passed to meshopt_optimizeVertexCacheWithScores
+bool save_table(const char* path, const State& state, size_t generation)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "// Generated by vcachetuner after %d generations, fitness %f, profiles:", int(generation), state.fitness);
+	for (size_t profile = 0; profile < profiles.size(); ++profile)
+		fprintf(file, " %s", profiles[profile].name);
+	fprintf(file, "\n");
+
+	fprintf(file, "static const float kVertexCacheScores[%d] = {", kCacheSizeMax);
+	for (int i = 0; i < kCacheSizeMax; ++i)
+		fprintf(file, "%s%.3ff", i == 0 ? "" : ", ", state.cache[i]);
+	fprintf(file, "};\n");
+
+	fprintf(file, "static const float kVertexLiveScores[%d] = {", kValenceMax);
+	for (int i = 0; i < kValenceMax; ++i)
+		fprintf(file, "%s%.3ff", i == 0 ? "" : ", ", state.live[i]);
+	fprintf(file, "};\n");
+
+	return fclose(file) == 0;
+}
+
 void dump_state(const State& state)
 {
 	printf("cache:");
@@ -414,23 +486,29 @@ void dump_state(const State& state)
 
 void dump_stats(const State& state, const std::vector<Mesh>& meshes)
 {
-	float improvement[Profile_Count] = {};
+	std::vector<float> improvement(profiles.size());
+	std::vector<float> metrics(meshes.size() * profiles.size());
 
+	#pragma omp parallel for schedule(dynamic)
 	for (size_t i = 0; i < meshes.size(); ++i)
 	{
-		float metric[Profile_Count];
-		compute_metric(&state, meshes[i], metric);
+		compute_metric(&state, meshes[i], &metrics[i * profiles.size()]);
+	}
+
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		const float* metric = &metrics[i * profiles.size()];
 
 		printf(" %s", meshes[i].name);
-		for (int profile = 0; profile < Profile_Count; ++profile)
+		for (size_t profile = 0; profile < profiles.size(); ++profile)
 			printf(" %f", metric[profile]);
 
-		for (int profile = 0; profile < Profile_Count; ++profile)
+		for (size_t profile = 0; profile < profiles.size(); ++profile)
 			improvement[profile] += meshes[i].metric_base[profile] / metric[profile];
 	}
 
 	printf("; improvement");
-	for (int profile = 0; profile < Profile_Count; ++profile)
+	for (size_t profile = 0; profile < profiles.size(); ++profile)
 		printf(" %f", improvement[profile] / float(meshes.size()));
 
 	printf("\n");
@@ -440,28 +518,83 @@ int main(int argc, char** argv)
 {
 	meshopt_encodeIndexVersion(1);
 
+	const char* state_path = "mutator.state";
+	const char* table_path = "mutator.table";
+	size_t max_generations = 0;
+
 	std::vector<Mesh> meshes;
 
 	meshes.push_back(gridmesh(50));
 
 	for (int i = 1; i < argc; ++i)
-		meshes.push_back(objmesh(argv[i]));
+	{
+		if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+		{
+			const char* name = argv[++i];
+			int profile = 0;
+
+			while (profile < kProfileCount && strcmp(kProfiles[profile].name, name) != 0)
+				profile++;
+
+			if (profile == kProfileCount)
+			{
+				printf("Unknown profile %s; available profiles:", name);
+				for (int j = 0; j < kProfileCount; ++j)
+					printf(" %s", kProfiles[j].name);
+				printf("\n");
+				return 1;
+			}
+
+			if ((profile_mask & (1u << profile)) == 0)
+				profiles.push_back(kProfiles[profile]);
+
+			profile_mask |= 1u << profile;
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			state_path = argv[++i];
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+			table_path = argv[++i];
+		else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+			max_generations = atoi(argv[++i]);
+		else if (argv[i][0] == '-')
+		{
+			printf("Usage: %s [-p profile]... [-s checkpoint] [-o table] [-g generations] [file.obj]...\n", argv[0]);
+			return 1;
+		}
+		else
+			meshes.push_back(objmesh(argv[i]));
+	}
+
+	if (profiles.empty())
+	{
+		profiles.push_back(kProfiles[0]);
+		profiles.push_back(kProfiles[1]);
+		profile_mask = 3;
+	}
 
 	size_t total_triangles = 0;
 
-	for (auto& mesh : meshes)
+	#pragma omp parallel for schedule(dynamic)
+	for (size_t i = 0; i < meshes.size(); ++i)
 	{
-		compute_metric(nullptr, mesh, mesh.metric_base);
+		meshes[i].metric_base.resize(profiles.size());
+		compute_metric(nullptr, meshes[i], &meshes[i].metric_base[0]);
+	}
 
+	for (auto& mesh : meshes)
 		total_triangles += mesh.indices.size() / 3;
-	}
 
 	std::vector<State> pop;
 	size_t gen = 0;
 
-	if (load_state("mutator.state", pop))
+	int loaded = load_state(state_path, pop, gen);
+
+	if (loaded < 0)
+		return 1;
+
+	if (loaded)
 	{
-		printf("Loaded %d state vectors\n", int(pop.size()));
+		printf("Loaded %d state vectors from %s, resuming at generation %d\n", int(pop.size()), state_path, int(gen));
 	}
 	else
 	{
@@ -470,7 +603,10 @@ int main(int argc, char** argv)
 
 	printf("%d meshes, %.1fM triangles\n", int(meshes.size()), double(total_triangles) / 1e6);
 
-	for (;;)
+	std::string state_temp = std::string(state_path) + "-temp";
+	std::string table_temp = std::string(table_path) + "-temp";
+
+	while (max_generations == 0 || gen < max_generations)
 	{
 		auto best = genN(pop, meshes);
 		gen++;
@@ -487,12 +623,21 @@ int main(int argc, char** argv)
 
 		dump_state(best.first);
 
-		if (save_state("mutator.state-temp", pop) && rename("mutator.state-temp", "mutator.state") == 0)
+		// files are replaced atomically so that an interrupted run can always be resumed
+		if (save_state(state_temp.c_str(), pop, gen) && rename(state_temp.c_str(), state_path) == 0)
 		{
 		}
 		else
 		{
 			printf("ERROR: Can't save state\n");
 		}
+
+		if (save_table(table_temp.c_str(), best.first, gen) && rename(table_temp.c_str(), table_path) == 0)
+		{
+		}
+		else
+		{
+			printf("ERROR: Can't save table\n");
+		}
 	}
 }